@@ -0,0 +1,57 @@
+#include "BufferedSerialization.h"
+
+#include "skse64/PluginAPI.h"
+
+namespace
+{
+	// The SKSE interface is a table of plain function pointers, so the proxy
+	// reaches the active buffers through thread-local state.
+	thread_local BufferedWriter * s_writer = nullptr;
+	thread_local BufferedReader * s_reader = nullptr;
+
+	bool Buffered_WriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length)
+	{
+		return s_writer && s_writer->OpenRecord(type, version) && s_writer->WriteRecordData(buf, length);
+	}
+
+	bool Buffered_OpenRecord(UInt32 type, UInt32 version)
+	{
+		return s_writer && s_writer->OpenRecord(type, version);
+	}
+
+	bool Buffered_WriteRecordData(const void * buf, UInt32 length)
+	{
+		return s_writer && s_writer->WriteRecordData(buf, length);
+	}
+
+	bool Buffered_GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length)
+	{
+		return s_reader && s_reader->GetNextRecordInfo(type, version, length);
+	}
+
+	UInt32 Buffered_ReadRecordData(void * buf, UInt32 length)
+	{
+		return s_reader ? s_reader->ReadRecordData(buf, length) : 0;
+	}
+}
+
+BufferedSerializationScope::BufferedSerializationScope(const SKSESerializationInterface * intfc, BufferedWriter * writer, BufferedReader * reader)
+	: m_proxy(new SKSESerializationInterface(*intfc))
+	, m_prevWriter(s_writer)
+	, m_prevReader(s_reader)
+{
+	s_writer = writer;
+	s_reader = reader;
+
+	m_proxy->WriteRecord = Buffered_WriteRecord;
+	m_proxy->OpenRecord = Buffered_OpenRecord;
+	m_proxy->WriteRecordData = Buffered_WriteRecordData;
+	m_proxy->GetNextRecordInfo = Buffered_GetNextRecordInfo;
+	m_proxy->ReadRecordData = Buffered_ReadRecordData;
+}
+
+BufferedSerializationScope::~BufferedSerializationScope()
+{
+	s_writer = m_prevWriter;
+	s_reader = m_prevReader;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "skse64_common/skse_types.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+struct SKSESerializationInterface;
+
+// Whole-record staging for co-save data.
+//
+// SKSE passes every WriteRecordData/ReadRecordData call straight through to
+// the co-save file, so a registration tree saved field by field costs one
+// I/O call per key, type, index and value. BufferedWriter collects a record
+// in memory and hands it to the interface with one OpenRecord and one
+// WriteRecordData; BufferedReader pulls a record in with one ReadRecordData
+// and serves the field reads from memory.
+//
+// Both classes expose the same calls as SKSESerializationInterface, so the
+// templated loaders can run against them directly, and
+// BufferedSerializationScope adapts them for code that takes the SKSE
+// interface. Records opened inside a buffer are stored as blocks:
+//
+//   UInt32 type | UInt32 version | UInt32 length | <length bytes>
+//
+// which is the header SKSE uses for its own records. Blocks follow each other
+// the same way SKSE records do, and a reader steps over a block it does not
+// recognise by its length alone.
+
+class BufferedWriter
+{
+public:
+	enum
+	{
+		kBlockHeaderSize = 12
+	};
+
+	BufferedWriter() : m_blockStart(kNoBlock) { }
+
+	void Reserve(size_t bytes) { m_data.reserve(bytes); }
+
+	// Closes the current block and starts a new one. Data written before the
+	// first OpenRecord is stored without a block header.
+	bool OpenRecord(UInt32 type, UInt32 version)
+	{
+		CloseBlock();
+		m_blockStart = m_data.size();
+		Append(&type, sizeof(type));
+		Append(&version, sizeof(version));
+		UInt32 length = 0;
+		Append(&length, sizeof(length));
+		return true;
+	}
+
+	bool WriteRecordData(const void * buf, UInt32 length)
+	{
+		Append(buf, length);
+		return true;
+	}
+
+	// Fills in the length of the open block. Flush does this itself.
+	void Finish() { CloseBlock(); }
+
+	// Appends blocks staged and finished by another writer, after closing the
+	// open block. Equal to writing the same records here directly.
+	bool WriteBlocks(const UInt8 * data, size_t length)
+	{
+		CloseBlock();
+		Append(data, length);
+		return true;
+	}
+
+	// Writes everything staged so far as a single record
+	template <class Intfc>
+	bool Flush(Intfc * intfc, UInt32 type, UInt32 version)
+	{
+		CloseBlock();
+		if (m_data.size() > 0xFFFFFFFF)
+			return false;
+		if (!intfc->OpenRecord(type, version))
+			return false;
+		return m_data.empty() || intfc->WriteRecordData(m_data.data(), static_cast<UInt32>(m_data.size()));
+	}
+
+	const UInt8 * Data() const { return m_data.data(); }
+	size_t Size() const { return m_data.size(); }
+
+	void Clear()
+	{
+		m_data.clear();
+		m_blockStart = kNoBlock;
+	}
+
+private:
+	enum : size_t
+	{
+		kNoBlock = static_cast<size_t>(-1)
+	};
+
+	void Append(const void * buf, size_t length)
+	{
+		const UInt8 * bytes = static_cast<const UInt8 *>(buf);
+		m_data.insert(m_data.end(), bytes, bytes + length);
+	}
+
+	void CloseBlock()
+	{
+		if (m_blockStart == kNoBlock)
+			return;
+
+		UInt32 length = static_cast<UInt32>(m_data.size() - m_blockStart - kBlockHeaderSize);
+		std::memcpy(m_data.data() + m_blockStart + 8, &length, sizeof(length));
+		m_blockStart = kNoBlock;
+	}
+
+	std::vector<UInt8>	m_data;
+	size_t				m_blockStart;
+};
+
+class BufferedReader
+{
+public:
+	BufferedReader() : m_pos(0), m_limit(0), m_inBlock(false) { }
+
+	// Reads the rest of the current record in a single call
+	template <class Intfc>
+	bool Fill(Intfc * intfc, UInt32 length)
+	{
+		m_data.resize(length);
+		Rewind();
+		if (length > 0 && intfc->ReadRecordData(m_data.data(), length) != length)
+		{
+			m_data.clear();
+			Rewind();
+			return false;
+		}
+		return true;
+	}
+
+	void Assign(const void * buf, size_t length)
+	{
+		const UInt8 * bytes = static_cast<const UInt8 *>(buf);
+		m_data.assign(bytes, bytes + length);
+		Rewind();
+	}
+
+	// Moves to the next block, skipping whatever is left of the current one.
+	// A header whose length runs past the buffer ends the stream.
+	bool GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length)
+	{
+		if (m_inBlock)
+			m_pos = m_limit;
+
+		m_inBlock = false;
+		m_limit = m_data.size();
+		if (m_limit - m_pos < BufferedWriter::kBlockHeaderSize)
+		{
+			m_pos = m_limit;
+			return false;
+		}
+
+		UInt32 header[3];
+		std::memcpy(header, m_data.data() + m_pos, sizeof(header));
+		m_pos += sizeof(header);
+		if (header[2] > m_limit - m_pos)
+		{
+			m_pos = m_limit;
+			return false;
+		}
+
+		m_limit = m_pos + header[2];
+		m_inBlock = true;
+
+		*type = header[0];
+		*version = header[1];
+		*length = header[2];
+		return true;
+	}
+
+	// Unlike SKSE, a read that does not fit in the current block reads
+	// nothing, so a corrupt count or length fails at the first short read.
+	UInt32 ReadRecordData(void * buf, UInt32 length)
+	{
+		if (length > m_limit - m_pos)
+			return 0;
+
+		std::memcpy(buf, m_data.data() + m_pos, length);
+		m_pos += length;
+		return length;
+	}
+
+	// Bytes left in the current block, or in the buffer before the first block
+	size_t Remaining() const { return m_limit - m_pos; }
+
+private:
+	void Rewind()
+	{
+		m_pos = 0;
+		m_limit = m_data.size();
+		m_inBlock = false;
+	}
+
+	std::vector<UInt8>	m_data;
+	size_t				m_pos;
+	size_t				m_limit;
+	bool				m_inBlock;
+};
+
+// Presents a BufferedWriter and/or BufferedReader as an
+// SKSESerializationInterface for the duration of the scope. Handle and form
+// resolution still go to the real interface. Scopes may nest.
+class BufferedSerializationScope
+{
+public:
+	BufferedSerializationScope(const SKSESerializationInterface * intfc, BufferedWriter * writer, BufferedReader * reader);
+	~BufferedSerializationScope();
+
+	BufferedSerializationScope(const BufferedSerializationScope &) = delete;
+	BufferedSerializationScope & operator=(const BufferedSerializationScope &) = delete;
+
+	SKSESerializationInterface * Get() const { return m_proxy.get(); }
+
+private:
+	std::unique_ptr<SKSESerializationInterface>	m_proxy;
+	BufferedWriter	* m_prevWriter;
+	BufferedReader	* m_prevReader;
+};
@@ -0,0 +1,27 @@
+#include "FlatOverrideStorage.h"
+
+std::pair<FlatHandleSet::iterator, bool> FlatHandleSet::insert(UInt32 id)
+{
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+	if (it != m_ids.end() && *it == id)
+		return std::make_pair(iterator(it), false);
+
+	it = m_ids.insert(it, id);
+	return std::make_pair(iterator(it), true);
+}
+
+size_t FlatHandleSet::erase(UInt32 id)
+{
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+	if (it == m_ids.end() || *it != id)
+		return 0;
+
+	m_ids.erase(it);
+	return 1;
+}
+
+FlatHandleSet::iterator FlatHandleSet::find(UInt32 id) const
+{
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+	return (it != m_ids.end() && *it == id) ? it : m_ids.end();
+}
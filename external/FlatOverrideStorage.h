@@ -0,0 +1,393 @@
+#pragma once
+
+#include "InternedStringTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Flat storage for override registrations.
+//
+// The registration containers nest an unordered_map per owner, per node and
+// a std::set per node, so applying an actor's overrides walks several heap
+// nodes per value. Here every override of one actor lives in a single block:
+// a sorted array of keys followed by the values, searched by binary search
+// and walked in order. An override is addressed by
+//
+//   (handle, node string id, key, index)
+//
+// where the handle identifies the owner (armor and addon, weapon, or skin
+// slot) and any gender or person bits the caller folds in. Within a node the
+// order is the OverrideSet order, key then index, and setting an existing
+// (key, index) replaces it like OverrideSet's erase + insert.
+//
+// Values must be trivially copyable, so clearing a table is O(1) and
+// releasing an actor frees one block.
+
+struct FlatOverrideKey
+{
+	UInt64	handle;
+	UInt64	slot;	// node << 24 | key << 8 | index
+
+	static FlatOverrideKey Make(UInt64 handle, StringID node, UInt16 key, UInt8 index)
+	{
+		FlatOverrideKey result;
+		result.handle = handle;
+		result.slot = (static_cast<UInt64>(node) << 24) | (static_cast<UInt64>(key) << 8) | index;
+		return result;
+	}
+
+	StringID GetNode() const { return static_cast<StringID>(slot >> 24); }
+	UInt16 GetKey() const { return static_cast<UInt16>(slot >> 8); }
+	UInt8 GetIndex() const { return static_cast<UInt8>(slot); }
+
+	bool operator<(const FlatOverrideKey & rhs) const
+	{
+		return handle < rhs.handle || (handle == rhs.handle && slot < rhs.slot);
+	}
+
+	bool operator==(const FlatOverrideKey & rhs) const
+	{
+		return handle == rhs.handle && slot == rhs.slot;
+	}
+};
+
+// Override value with string data held as an interned id
+struct FlatOverrideValue
+{
+	enum
+	{
+		kType_None = 0,
+		kType_Identifier = 1,
+		kType_String = 2,
+		kType_Int = 3,
+		kType_Float = 4,
+		kType_Bool = 5
+	};
+
+	UInt8	type;
+	union
+	{
+		SInt32		i;
+		UInt32		u;
+		float		f;
+		bool		b;
+		StringID	str;
+		void		* p;
+	} data;
+};
+
+// All overrides of one actor
+template <class V>
+class FlatOverrideTable
+{
+	static_assert(std::is_trivially_copyable<V>::value, "override values are copied as raw memory");
+	static_assert(alignof(V) <= alignof(FlatOverrideKey), "values share the key block");
+
+public:
+	FlatOverrideTable() : m_count(0), m_capacity(0) { }
+
+	FlatOverrideTable(FlatOverrideTable && rhs) noexcept
+		: m_block(std::move(rhs.m_block))
+		, m_count(rhs.m_count)
+		, m_capacity(rhs.m_capacity)
+	{
+		rhs.m_count = rhs.m_capacity = 0;
+	}
+
+	FlatOverrideTable & operator=(FlatOverrideTable && rhs) noexcept
+	{
+		m_block = std::move(rhs.m_block);
+		m_count = rhs.m_count;
+		m_capacity = rhs.m_capacity;
+		rhs.m_count = rhs.m_capacity = 0;
+		return *this;
+	}
+
+	V * Find(UInt64 handle, StringID node, UInt16 key, UInt8 index)
+	{
+		FlatOverrideKey k = FlatOverrideKey::Make(handle, node, key, index);
+		size_t i = LowerBound(k);
+		return (i < m_count && Keys()[i] == k) ? &Values()[i] : nullptr;
+	}
+
+	const V * Find(UInt64 handle, StringID node, UInt16 key, UInt8 index) const
+	{
+		return const_cast<FlatOverrideTable *>(this)->Find(handle, node, key, index);
+	}
+
+	// Inserts or replaces the value for (key, index)
+	void Set(UInt64 handle, StringID node, UInt16 key, UInt8 index, const V & value)
+	{
+		FlatOverrideKey k = FlatOverrideKey::Make(handle, node, key, index);
+
+		// Loading and most edits append in order
+		size_t i = (m_count == 0 || Keys()[m_count - 1] < k) ? m_count : LowerBound(k);
+		if (i < m_count && Keys()[i] == k)
+		{
+			Values()[i] = value;
+			return;
+		}
+
+		if (m_count == m_capacity)
+			Grow(m_capacity ? m_capacity * 2 : 16);
+
+		FlatOverrideKey * keys = Keys();
+		V * values = Values();
+		std::memmove(keys + i + 1, keys + i, (m_count - i) * sizeof(FlatOverrideKey));
+		std::memmove(values + i + 1, values + i, (m_count - i) * sizeof(V));
+		keys[i] = k;
+		values[i] = value;
+		m_count++;
+	}
+
+	bool Erase(UInt64 handle, StringID node, UInt16 key, UInt8 index)
+	{
+		FlatOverrideKey k = FlatOverrideKey::Make(handle, node, key, index);
+		size_t i = LowerBound(k);
+		if (i == m_count || !(Keys()[i] == k))
+			return false;
+
+		RemoveRange(i, i + 1);
+		return true;
+	}
+
+	// Removes every override of a node
+	size_t EraseNode(UInt64 handle, StringID node)
+	{
+		size_t first, last;
+		NodeRange(handle, node, first, last);
+		RemoveRange(first, last);
+		return last - first;
+	}
+
+	// Removes every override of a handle
+	size_t EraseHandle(UInt64 handle)
+	{
+		size_t first, last;
+		HandleRange(handle, first, last);
+		RemoveRange(first, last);
+		return last - first;
+	}
+
+	// Removes every override whose handle matches under the mask, e.g. all
+	// addons of an armor
+	size_t EraseMatching(UInt64 handle, UInt64 mask)
+	{
+		FlatOverrideKey * keys = Keys();
+		V * values = Values();
+		size_t out = 0;
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			if ((keys[i].handle & mask) == handle)
+				continue;
+			keys[out] = keys[i];
+			values[out] = values[i];
+			out++;
+		}
+
+		size_t removed = m_count - out;
+		m_count = out;
+		return removed;
+	}
+
+	// functor(const FlatOverrideKey &, V &), in key then index order
+	template <class F>
+	void VisitNode(UInt64 handle, StringID node, F && functor)
+	{
+		size_t first, last;
+		NodeRange(handle, node, first, last);
+		VisitRange(first, last, functor);
+	}
+
+	// functor(const FlatOverrideKey &, V &), grouped by node
+	template <class F>
+	void VisitHandle(UInt64 handle, F && functor)
+	{
+		size_t first, last;
+		HandleRange(handle, first, last);
+		VisitRange(first, last, functor);
+	}
+
+	template <class F>
+	void Visit(F && functor)
+	{
+		VisitRange(0, m_count, functor);
+	}
+
+	bool HasHandle(UInt64 handle) const
+	{
+		size_t i = LowerBound(FlatOverrideKey::Make(handle, 0, 0, 0));
+		return i < m_count && Keys()[i].handle == handle;
+	}
+
+	// Keeps the block for reuse
+	void Clear() { m_count = 0; }
+
+	size_t Size() const { return m_count; }
+	bool Empty() const { return m_count == 0; }
+	size_t Capacity() const { return m_capacity; }
+
+private:
+	FlatOverrideKey * Keys() const { return reinterpret_cast<FlatOverrideKey *>(m_block.get()); }
+	V * Values() const { return reinterpret_cast<V *>(Keys() + m_capacity); }
+
+	size_t LowerBound(const FlatOverrideKey & k) const
+	{
+		return std::lower_bound(Keys(), Keys() + m_count, k) - Keys();
+	}
+
+	void HandleRange(UInt64 handle, size_t & first, size_t & last) const
+	{
+		FlatOverrideKey * keys = Keys();
+		first = LowerBound(FlatOverrideKey::Make(handle, 0, 0, 0));
+		last = first;
+		while (last < m_count && keys[last].handle == handle)
+			last++;
+	}
+
+	void NodeRange(UInt64 handle, StringID node, size_t & first, size_t & last) const
+	{
+		FlatOverrideKey * keys = Keys();
+		first = LowerBound(FlatOverrideKey::Make(handle, node, 0, 0));
+		last = first;
+		while (last < m_count && keys[last].handle == handle && keys[last].GetNode() == node)
+			last++;
+	}
+
+	template <class F>
+	void VisitRange(size_t first, size_t last, F & functor)
+	{
+		FlatOverrideKey * keys = Keys();
+		V * values = Values();
+		for (size_t i = first; i < last; ++i)
+			functor(static_cast<const FlatOverrideKey &>(keys[i]), values[i]);
+	}
+
+	void RemoveRange(size_t first, size_t last)
+	{
+		if (first == last)
+			return;
+
+		FlatOverrideKey * keys = Keys();
+		V * values = Values();
+		std::memmove(keys + first, keys + last, (m_count - last) * sizeof(FlatOverrideKey));
+		std::memmove(values + first, values + last, (m_count - last) * sizeof(V));
+		m_count -= last - first;
+	}
+
+	void Grow(size_t capacity)
+	{
+		// One block: keys[capacity] then values[capacity]
+		size_t bytes = capacity * (sizeof(FlatOverrideKey) + sizeof(V));
+		std::unique_ptr<UInt64[]> block(new UInt64[(bytes + sizeof(UInt64) - 1) / sizeof(UInt64)]);
+
+		FlatOverrideKey * keys = reinterpret_cast<FlatOverrideKey *>(block.get());
+		V * values = reinterpret_cast<V *>(keys + capacity);
+		if (m_count > 0)
+		{
+			std::memcpy(keys, Keys(), m_count * sizeof(FlatOverrideKey));
+			std::memcpy(values, Values(), m_count * sizeof(V));
+		}
+
+		m_block = std::move(block);
+		m_capacity = capacity;
+	}
+
+	std::unique_ptr<UInt64[]>	m_block;
+	size_t						m_count;
+	size_t						m_capacity;
+};
+
+// Per-actor tables, stored densely so releasing an actor is a swap and pop
+template <class V>
+class FlatOverrideRegistry
+{
+public:
+	FlatOverrideTable<V> * Find(UInt32 actor)
+	{
+		auto it = m_index.find(actor);
+		return it != m_index.end() ? &m_tables[it->second] : nullptr;
+	}
+
+	FlatOverrideTable<V> & Get(UInt32 actor)
+	{
+		auto it = m_index.find(actor);
+		if (it != m_index.end())
+			return m_tables[it->second];
+
+		m_index.emplace(actor, static_cast<UInt32>(m_tables.size()));
+		m_actors.push_back(actor);
+		m_tables.emplace_back();
+		return m_tables.back();
+	}
+
+	// Drops every override of an unloaded or deleted actor
+	bool Release(UInt32 actor)
+	{
+		auto it = m_index.find(actor);
+		if (it == m_index.end())
+			return false;
+
+		UInt32 slot = it->second;
+		UInt32 last = static_cast<UInt32>(m_tables.size() - 1);
+		if (slot != last)
+		{
+			m_tables[slot] = std::move(m_tables[last]);
+			m_actors[slot] = m_actors[last];
+			m_index[m_actors[slot]] = slot;
+		}
+
+		m_tables.pop_back();
+		m_actors.pop_back();
+		m_index.erase(it);
+		return true;
+	}
+
+	// functor(UInt32 actor, FlatOverrideTable<V> &)
+	template <class F>
+	void Visit(F && functor)
+	{
+		for (size_t i = 0; i < m_tables.size(); ++i)
+			functor(m_actors[i], m_tables[i]);
+	}
+
+	void Clear()
+	{
+		m_tables.clear();
+		m_actors.clear();
+		m_index.clear();
+	}
+
+	size_t Size() const { return m_tables.size(); }
+
+private:
+	std::vector<FlatOverrideTable<V>>		m_tables;
+	std::vector<UInt32>						m_actors;
+	std::unordered_map<UInt32, UInt32>		m_index;	// actor -> slot
+};
+
+// Sorted set of form ids, a drop-in for the unordered_set<UInt32> holders
+class FlatHandleSet
+{
+public:
+	typedef std::vector<UInt32>::const_iterator iterator;
+	typedef std::vector<UInt32>::const_iterator const_iterator;
+
+	std::pair<iterator, bool> insert(UInt32 id);
+	size_t erase(UInt32 id);
+	iterator find(UInt32 id) const;
+	size_t count(UInt32 id) const { return find(id) != end() ? 1 : 0; }
+
+	iterator begin() const { return m_ids.begin(); }
+	iterator end() const { return m_ids.end(); }
+	size_t size() const { return m_ids.size(); }
+	bool empty() const { return m_ids.empty(); }
+	void clear() { m_ids.clear(); }
+
+private:
+	std::vector<UInt32>	m_ids;
+};
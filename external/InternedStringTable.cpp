@@ -0,0 +1,176 @@
+#include "InternedStringTable.h"
+
+#include <mutex>
+
+namespace
+{
+	inline unsigned char FoldLower(unsigned char c)
+	{
+		return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+	}
+}
+
+InternedStringTable::InternedStringTable()
+	: m_chunkUsed(kChunkSize)
+	, m_arenaBytes(0)
+{
+	m_slots.assign(1024, kInvalidID);
+}
+
+// Same FNV-1a fold as SKEEFixedString::hash_lower, without the locale lookup
+UInt64 InternedStringTable::HashLower(const char * str, size_t length)
+{
+	UInt64 val = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; ++i)
+	{
+		val ^= FoldLower(static_cast<unsigned char>(str[i]));
+		val *= 1099511628211ULL;
+	}
+	return val;
+}
+
+bool InternedStringTable::EqualsLower(const char * a, const char * b, size_t length)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		if (FoldLower(static_cast<unsigned char>(a[i])) != FoldLower(static_cast<unsigned char>(b[i])))
+			return false;
+	}
+	return true;
+}
+
+const char * InternedStringTable::CopyToArena(const char * str, size_t length)
+{
+	// length <= SHRT_MAX, so a string always fits in a fresh chunk
+	const size_t needed = length + 1;
+	if (m_chunkUsed + needed > kChunkSize)
+	{
+		m_chunks.emplace_back(new char[kChunkSize]);
+		m_chunkUsed = 0;
+	}
+
+	char * dest = m_chunks.back().get() + m_chunkUsed;
+	m_chunkUsed += needed;
+
+	std::memcpy(dest, str, length);
+	dest[length] = 0;
+	m_arenaBytes += needed;
+	return dest;
+}
+
+StringID InternedStringTable::FindLocked(const char * str, size_t length, UInt64 hash, UInt32 & slot) const
+{
+	const UInt32 mask = static_cast<UInt32>(m_slots.size() - 1);
+	slot = static_cast<UInt32>(hash) & mask;
+	for (;;)
+	{
+		StringID id = m_slots[slot];
+		if (id == kInvalidID)
+			return kInvalidID;
+
+		const Entry & entry = m_entries[id];
+		if (entry.hash == hash && entry.length == length && EqualsLower(entry.str, str, length))
+			return id;
+
+		slot = (slot + 1) & mask;
+	}
+}
+
+void InternedStringTable::GrowSlots()
+{
+	std::vector<StringID> slots(m_slots.size() * 2, kInvalidID);
+	const UInt32 mask = static_cast<UInt32>(slots.size() - 1);
+	for (StringID id = 0; id < m_entries.size(); ++id)
+	{
+		UInt32 slot = static_cast<UInt32>(m_entries[id].hash) & mask;
+		while (slots[slot] != kInvalidID)
+			slot = (slot + 1) & mask;
+		slots[slot] = id;
+	}
+	m_slots.swap(slots);
+}
+
+StringID InternedStringTable::Intern(const char * str, size_t length)
+{
+	if (length > SHRT_MAX)
+		return kInvalidID;
+
+	const UInt64 hash = HashLower(str, length);
+	UInt32 slot = 0;
+	{
+		std::shared_lock<std::shared_mutex> locker(m_lock);
+		StringID id = FindLocked(str, length, hash, slot);
+		if (id != kInvalidID)
+			return id;
+	}
+
+	std::unique_lock<std::shared_mutex> locker(m_lock);
+
+	// Another writer may have inserted it between the locks
+	StringID id = FindLocked(str, length, hash, slot);
+	if (id != kInvalidID)
+		return id;
+
+	// Keep load factor under 1/2 so probe chains stay short
+	if ((m_entries.size() + 1) * 2 > m_slots.size())
+	{
+		GrowSlots();
+		FindLocked(str, length, hash, slot);
+	}
+
+	id = static_cast<StringID>(m_entries.size());
+	m_entries.push_back({ hash, CopyToArena(str, length), static_cast<UInt16>(length) });
+	m_slots[slot] = id;
+	return id;
+}
+
+StringID InternedStringTable::Find(const char * str, size_t length) const
+{
+	if (length > SHRT_MAX)
+		return kInvalidID;
+
+	const UInt64 hash = HashLower(str, length);
+	UInt32 slot = 0;
+	std::shared_lock<std::shared_mutex> locker(m_lock);
+	return FindLocked(str, length, hash, slot);
+}
+
+const char * InternedStringTable::GetString(StringID id) const
+{
+	std::shared_lock<std::shared_mutex> locker(m_lock);
+	return id < m_entries.size() ? m_entries[id].str : nullptr;
+}
+
+UInt16 InternedStringTable::GetLength(StringID id) const
+{
+	std::shared_lock<std::shared_mutex> locker(m_lock);
+	return id < m_entries.size() ? m_entries[id].length : 0;
+}
+
+UInt64 InternedStringTable::GetHash(StringID id) const
+{
+	std::shared_lock<std::shared_mutex> locker(m_lock);
+	return id < m_entries.size() ? m_entries[id].hash : 0;
+}
+
+size_t InternedStringTable::Size() const
+{
+	std::shared_lock<std::shared_mutex> locker(m_lock);
+	return m_entries.size();
+}
+
+size_t InternedStringTable::ArenaBytes() const
+{
+	std::shared_lock<std::shared_mutex> locker(m_lock);
+	return m_arenaBytes;
+}
+
+void InternedStringTable::Revert()
+{
+	std::unique_lock<std::shared_mutex> locker(m_lock);
+	m_entries.clear();
+	m_slots.assign(1024, kInvalidID);
+	m_chunks.clear();
+	m_chunkUsed = kChunkSize;
+	m_arenaBytes = 0;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "skse64_common/skse_types.h"
+#include "BufferedSerialization.h"
+
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+// Case-insensitive interned strings referenced by dense 32-bit ids.
+//
+// Strings are copied once into a chunked arena and never move, so c_str()
+// pointers stay valid until Revert(). Each entry stores the case-folded hash
+// and length inline, lookups compare hash and length before touching the
+// characters, and two ids are equal exactly when the strings are equal
+// ignoring ASCII case. There is no per-string refcount: strings live until
+// the table is reverted, which matches the co-save lifetime.
+//
+// Save/Load use the same 'STTB' record layout as StringTable (count followed
+// by UInt16 length-prefixed strings), so either table can read the other's
+// co-save data. Ids written by WriteString are the table's own ids, which are
+// also the record indices. Save stages the record and writes it in one call;
+// LoadBuffered does the same for reads when the record length is known.
+
+typedef UInt32 StringID;
+
+class InternedStringTable
+{
+public:
+	enum
+	{
+		kSerializationVersion1 = 1,
+		kSerializationVersion2 = 2,
+		kSerializationVersion3 = 3,
+		kSerializationVersion = kSerializationVersion3
+	};
+
+	enum : StringID
+	{
+		kInvalidID = 0xFFFFFFFF
+	};
+
+	typedef std::vector<StringID> StringIdRemap;	// co-save id -> live id
+
+	InternedStringTable();
+
+	StringID Intern(const char * str, size_t length);
+	StringID Intern(const char * str) { return Intern(str, std::strlen(str)); }
+	StringID Find(const char * str, size_t length) const;
+	StringID Find(const char * str) const { return Find(str, std::strlen(str)); }
+
+	const char * GetString(StringID id) const;
+	UInt16 GetLength(StringID id) const;
+	UInt64 GetHash(StringID id) const;
+
+	size_t Size() const;
+	size_t ArenaBytes() const;
+	void Revert();
+
+	static UInt64 HashLower(const char * str, size_t length);
+	static bool EqualsLower(const char * a, const char * b, size_t length);
+
+	template <class Intfc>
+	void Save(Intfc * intfc, UInt32 kVersion) const;
+
+	// Returns true on error, like StringTable::Load
+	template <class Intfc>
+	bool Load(Intfc * intfc, UInt32 kVersion, StringIdRemap & remap);
+
+	// Reads the whole record with one call, then parses it from memory
+	template <class Intfc>
+	bool LoadBuffered(Intfc * intfc, UInt32 kVersion, UInt32 length, StringIdRemap & remap)
+	{
+		BufferedReader reader;
+		if (!reader.Fill(intfc, length))
+			return true;
+		return Load(&reader, kVersion, remap);
+	}
+
+	template <class Intfc>
+	static StringID ReadString(Intfc * intfc, const StringIdRemap & remap)
+	{
+		UInt32 stringId;
+		if (!intfc->ReadRecordData(&stringId, sizeof(stringId)))
+			return kInvalidID;
+		if (stringId >= remap.size())
+			return kInvalidID;
+		return remap[stringId];
+	}
+
+	template <class Intfc>
+	static bool WriteString(Intfc * intfc, StringID id)
+	{
+		return intfc->WriteRecordData(&id, sizeof(id));
+	}
+
+private:
+	struct Entry
+	{
+		UInt64			hash;
+		const char *	str;
+		UInt16			length;
+	};
+
+	enum
+	{
+		kChunkSize = 64 * 1024
+	};
+
+	const char * CopyToArena(const char * str, size_t length);
+	StringID FindLocked(const char * str, size_t length, UInt64 hash, UInt32 & slot) const;
+	void GrowSlots();
+
+	std::vector<Entry>						m_entries;
+	std::vector<StringID>					m_slots;		// open addressing, kInvalidID = empty
+	std::vector<std::unique_ptr<char[]>>	m_chunks;
+	size_t									m_chunkUsed;
+	size_t									m_arenaBytes;
+	mutable std::shared_mutex				m_lock;
+};
+
+template <class Intfc>
+void InternedStringTable::Save(Intfc * intfc, UInt32 kVersion) const
+{
+	BufferedWriter writer;
+	{
+		std::shared_lock<std::shared_mutex> locker(m_lock);
+		UInt32 totalStrings = static_cast<UInt32>(m_entries.size());
+		writer.Reserve(sizeof(totalStrings) + m_entries.size() * sizeof(UInt16) + m_arenaBytes);
+		writer.WriteRecordData(&totalStrings, sizeof(totalStrings));
+
+		for (auto & entry : m_entries)
+		{
+			writer.WriteRecordData(&entry.length, sizeof(entry.length));
+			if (entry.length > 0)
+				writer.WriteRecordData(entry.str, entry.length);
+		}
+	}
+
+	writer.Flush(intfc, 'STTB', kVersion);
+}
+
+template <class Intfc>
+bool InternedStringTable::Load(Intfc * intfc, UInt32 kVersion, StringIdRemap & remap)
+{
+	UInt32 totalStrings = 0;
+	if (kVersion < kSerializationVersion1 || !intfc->ReadRecordData(&totalStrings, sizeof(totalStrings)))
+		return true;
+
+	// Counts and ids come straight from the save, so nothing is sized from
+	// them until the strings they describe have actually been read
+	remap.clear();
+	std::vector<std::pair<UInt32, StringID>> explicitIds;
+
+	std::vector<char> buf;
+	for (UInt32 i = 0; i < totalStrings; i++)
+	{
+		UInt16 length = 0;
+		if (!intfc->ReadRecordData(&length, sizeof(length)))
+			return true;
+		if (length > SHRT_MAX)
+			return true;
+
+		buf.resize(length);
+		if (length > 0 && !intfc->ReadRecordData(buf.data(), length))
+			return true;
+
+		StringID id = Intern(buf.data(), length);
+
+		if (kVersion >= kSerializationVersion3)
+		{
+			remap.push_back(id);
+			continue;
+		}
+
+		// Versions 1 and 2 store an explicit id after each string
+		UInt32 stringId = 0;
+		if (!intfc->ReadRecordData(&stringId, sizeof(stringId)))
+			return true;
+		if (stringId >= totalStrings)
+			return true;
+		explicitIds.emplace_back(stringId, id);
+	}
+
+	if (!explicitIds.empty())
+	{
+		remap.assign(totalStrings, kInvalidID);
+		for (auto & entry : explicitIds)
+			remap[entry.first] = entry.second;
+	}
+
+	return false;
+}
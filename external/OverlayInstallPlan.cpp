@@ -0,0 +1,85 @@
+#include "OverlayInstallPlan.h"
+#include "InternedStringTable.h"
+
+#include <cstdio>
+#include <cstring>
+
+void OverlayInstallPlan::Build(const OverlaySlotGroup * groups, UInt32 numGroups)
+{
+	m_slots.clear();
+	m_groups.clear();
+	m_hashes.clear();
+	m_maxLength = 0;
+
+	char buff[260];
+	for (UInt32 g = 0; g < numGroups; ++g)
+	{
+		const OverlaySlotGroup & group = groups[g];
+		m_groups.push_back({ group.format, group.count });
+		for (UInt32 i = 0; i < group.count; ++i)
+		{
+			std::snprintf(buff, sizeof(buff), group.format, i);
+
+			OverlaySlot slot;
+			slot.part = group.part;
+			slot.mesh = group.mesh;
+			slot.name = buff;
+			m_hashes.push_back(InternedStringTable::HashLower(slot.name.c_str(), slot.name.size()));
+			if (slot.name.size() > m_maxLength)
+				m_maxLength = slot.name.size();
+			m_slots.push_back(std::move(slot));
+		}
+	}
+
+	// At most half full, so probes stay short
+	size_t capacity = 16;
+	while (capacity < m_slots.size() * 2)
+		capacity *= 2;
+	m_index.assign(capacity, kNoSlot);
+
+	for (UInt32 s = 0; s < Size(); ++s)
+	{
+		size_t i = m_hashes[s] & (capacity - 1);
+		while (m_index[i] != kNoSlot)
+			i = (i + 1) & (capacity - 1);
+		m_index[i] = s;
+	}
+}
+
+bool OverlayInstallPlan::Matches(const OverlaySlotGroup * groups, UInt32 numGroups) const
+{
+	if (m_groups.size() != numGroups)
+		return false;
+
+	for (UInt32 g = 0; g < numGroups; ++g)
+	{
+		if (m_groups[g].count != groups[g].count || std::strcmp(m_groups[g].format, groups[g].format) != 0)
+			return false;
+	}
+	return true;
+}
+
+UInt32 OverlayInstallPlan::Find(const char * name) const
+{
+	if (m_slots.empty())
+		return kNoSlot;
+
+	// Bone names are usually longer than any overlay name
+	size_t length = 0;
+	while (name[length])
+	{
+		if (++length > m_maxLength)
+			return kNoSlot;
+	}
+
+	UInt64 hash = InternedStringTable::HashLower(name, length);
+	size_t mask = m_index.size() - 1;
+	for (size_t i = hash & mask; m_index[i] != kNoSlot; i = (i + 1) & mask)
+	{
+		UInt32 slot = m_index[i];
+		const std::string & candidate = m_slots[slot].name;
+		if (m_hashes[slot] == hash && candidate.size() == length && InternedStringTable::EqualsLower(candidate.c_str(), name, length))
+			return slot;
+	}
+	return kNoSlot;
+}
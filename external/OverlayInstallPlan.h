@@ -0,0 +1,110 @@
+#pragma once
+
+#include "skse64_common/skse_types.h"
+
+#include <string>
+#include <vector>
+
+// Node names of every overlay slot, formatted once, and a single pass over a
+// skeleton that finds all of them.
+//
+// AddOverlays used to format a node name per slot and queue an uninstall and
+// an install task for each, and every task searched the actor's scene graph
+// for its one name. The plan is built once for the configured slot counts.
+// A batched install then walks each skeleton once, resolves every overlay
+// node found in it, and installs all slots together.
+//
+// Names are matched ASCII case-insensitively, like BSFixedString. Overlay
+// nodes are leaves, so the walk does not descend into them.
+
+// One kind of overlay slot, e.g. body overlays or spell body overlays
+struct OverlaySlotGroup
+{
+	UInt32			part;		// Caller's part id, e.g. the biped slot mask
+	const char		* format;	// Node name with one %d for the slot index
+	const char		* mesh;
+	UInt32			count;
+};
+
+struct OverlaySlot
+{
+	UInt32			part;
+	const char		* mesh;
+	std::string		name;
+};
+
+class OverlayInstallPlan
+{
+public:
+	enum : UInt32
+	{
+		kNoSlot = 0xFFFFFFFF
+	};
+
+	// Formats every slot name in group order
+	void Build(const OverlaySlotGroup * groups, UInt32 numGroups);
+
+	// True if built from the same groups and counts
+	bool Matches(const OverlaySlotGroup * groups, UInt32 numGroups) const;
+
+	UInt32 Size() const { return static_cast<UInt32>(m_slots.size()); }
+	const OverlaySlot & Slot(UInt32 slot) const { return m_slots[slot]; }
+
+	// Slot named name, or kNoSlot
+	UInt32 Find(const char * name) const;
+
+	// functor(UInt32 slot, const OverlaySlot &) for the slots of part, in order
+	template <class F>
+	void VisitPart(UInt32 part, F && functor) const
+	{
+		for (UInt32 i = 0; i < Size(); ++i)
+		{
+			if (m_slots[i].part == part)
+				functor(i, m_slots[i]);
+		}
+	}
+
+	// Walks the tree under root once, depth first, calling
+	// functor(Node * node, Node * parent, UInt32 slot) for every node, with
+	// kNoSlot for nodes that are not overlays. Access tells how to read a node:
+	//
+	//   static const char * Name(Node * node);
+	//   static UInt32 ChildCount(Node * node);	// 0 for leaves
+	//   static Node * Child(Node * node, UInt32 i);	// may be null
+	template <class Access, class Node, class F>
+	void Walk(Node * root, F && functor) const
+	{
+		if (root)
+			WalkNode<Access>(root, static_cast<Node *>(nullptr), functor);
+	}
+
+private:
+	template <class Access, class Node, class F>
+	void WalkNode(Node * node, Node * parent, F & functor) const
+	{
+		const char * name = Access::Name(node);
+		UInt32 slot = name ? Find(name) : kNoSlot;
+		functor(node, parent, slot);
+		if (slot != kNoSlot)
+			return;
+
+		UInt32 count = Access::ChildCount(node);
+		for (UInt32 i = 0; i < count; ++i)
+		{
+			if (Node * child = Access::Child(node, i))
+				WalkNode<Access>(child, node, functor);
+		}
+	}
+
+	struct GroupKey
+	{
+		const char	* format;
+		UInt32		count;
+	};
+
+	std::vector<OverlaySlot>	m_slots;
+	std::vector<GroupKey>		m_groups;
+	std::vector<UInt32>			m_index;	// Open addressed slot ids by folded name hash
+	std::vector<UInt64>			m_hashes;	// Per slot
+	size_t						m_maxLength = 0;
+};
@@ -55,6 +55,26 @@ extern bool		g_immediateArmor;
 
 extern std::unordered_set<void*> g_adjustedBlocks;
 
+namespace
+{
+	// Part of face overlay slots; body, hand and feet slots use their biped mask
+	const UInt32 kFaceOverlayPart = 0;
+
+	// Scene graph access for OverlayInstallPlan::Walk
+	struct NiNodeAccess
+	{
+		static const char * Name(NiAVObject * node) { return node->m_name; }
+
+		static UInt32 ChildCount(NiAVObject * node)
+		{
+			NiNode * niNode = node->GetAsNiNode();
+			return niNode ? niNode->m_children.m_emptyRunStart : 0;
+		}
+
+		static NiAVObject * Child(NiAVObject * node, UInt32 i) { return node->GetAsNiNode()->m_children.m_data[i]; }
+	};
+}
+
 UInt32 OverlayInterface::GetVersion()
 {
 	return kCurrentPluginVersion;
@@ -82,6 +102,12 @@ void OverlayInterface::UninstallOverlay(const char * nodeName, TESObjectREFR * r
 }
 
 void OverlayInterface::InstallOverlay(const char * nodeName, const char * path, TESObjectREFR * refr, BSGeometry * source, NiNode * destination, BGSTextureSet * textureSet)
+{
+	BSFixedString overlayName(nodeName);
+	AttachOverlay(overlayName, path, refr, source, destination, textureSet, destination->GetObjectByName(&overlayName.data));
+}
+
+void OverlayInterface::AttachOverlay(BSFixedString & overlayName, const char * path, TESObjectREFR * refr, BSGeometry * source, NiNode * destination, BGSTextureSet * textureSet, NiAVObject * installed)
 {
 	NiNode * rootNode = NULL;
 	NiAVObject * newShape = NULL;
@@ -93,10 +119,8 @@ void OverlayInterface::InstallOverlay(const char * nodeName, const char * path,
 	NiStream * niStream = (NiStream *)niStreamMemory;
 	CALL_MEMBER_FN(niStream, ctor)();
 
-	BSFixedString overlayName(nodeName);
-	NiAVObject * foundGeometry = destination->GetObjectByName(&overlayName.data);
-	if (foundGeometry)
-		newShape = foundGeometry->GetAsBSGeometry();
+	if (installed)
+		newShape = installed->GetAsBSGeometry();
 
 	bool attachNew = false;
 	if(!newShape)
@@ -662,6 +686,108 @@ void SKSETaskUninstallOverlay::Modify(TESObjectREFR * reference, NiAVObject * ta
 	g_overlayInterface.UninstallOverlay(targetNode->m_name, reference, parent);
 }
 
+SKSETaskInstallOverlays::SKSETaskInstallOverlays(TESObjectREFR * refr)
+{
+	m_formId = refr->formID;
+}
+
+void SKSETaskInstallOverlays::Run()
+{
+	TESForm * form = LookupFormByID(m_formId);
+	TESObjectREFR * reference = DYNAMIC_CAST(form, TESForm, TESObjectREFR);
+	if (reference && g_overlayInterface.HasOverlays(reference))
+		g_overlayInterface.InstallOverlays(reference);
+}
+
+void SKSETaskInstallOverlays::Dispose()
+{
+	delete this;
+}
+
+void OverlayInterface::InstallOverlays(TESObjectREFR * refr)
+{
+	Actor * actor = DYNAMIC_CAST(refr, TESObjectREFR, Actor);
+	if (!actor)
+		return;
+
+#ifdef _DEBUG
+	_DMESSAGE("%s - Installing %d overlays to actor: %08X", __FUNCTION__, installPlan.Size(), actor->formID);
+#endif
+
+	// One walk per skeleton removes every installed overlay and finds where
+	// face overlays go
+	BSFixedString rootName("NPC Root [Root]");
+	NiNode * thirdPersonRoot = actor->GetNiRootNode(0);
+	NiNode * faceDestination = NULL;
+	std::vector<std::pair<NiAVObject *, NiNode *>> installed;
+	VisitSkeletalRoots(actor, [&](NiNode * skeleton, bool isFirstPerson)
+	{
+		installed.clear();
+		installPlan.Walk<NiNodeAccess>(static_cast<NiAVObject *>(skeleton), [&](NiAVObject * node, NiAVObject * parent, UInt32 slot)
+		{
+			if (slot != OverlayInstallPlan::kNoSlot)
+			{
+				if (NiNode * parentNode = parent ? parent->GetAsNiNode() : NULL)
+					installed.emplace_back(node, parentNode);
+			}
+			else if (!faceDestination && skeleton == thirdPersonRoot && node->m_name == rootName.data)
+			{
+				faceDestination = node->GetAsNiNode();
+			}
+		});
+
+		for (auto & overlay : installed)
+		{
+			if (BSGeometry * geometry = overlay.first->GetAsBSGeometry())
+				geometry->m_spSkinInstance = nullptr;
+			overlay.second->RemoveChild(overlay.first);
+		}
+	});
+
+	// Skin slots resolve their armor and skin geometry once for all overlays
+	const UInt32 skinParts[] = { BGSBipedObjectForm::kPart_Body, BGSBipedObjectForm::kPart_Hands, BGSBipedObjectForm::kPart_Feet };
+	for (UInt32 part : skinParts)
+	{
+		TESForm * form = GetSkinForm(actor, part);
+		TESObjectARMO * armor = DYNAMIC_CAST(form, TESForm, TESObjectARMO);
+		TESObjectARMA * addon = armor ? GetArmorAddonByMask(actor->race, armor, part) : NULL;
+		if (!addon)
+			continue;
+
+		VisitArmorAddon(actor, armor, addon, [&](bool isFirstPerson, NiNode * rootNode, NiAVObject * armorNode)
+		{
+			BSGeometry * firstSkin = GetFirstShaderType(armorNode, BSShaderMaterial::kShaderType_FaceGenRGBTint);
+			if (!firstSkin)
+				return;
+
+			installPlan.VisitPart(part, [&](UInt32 slot, const OverlaySlot & overlay)
+			{
+				BSFixedString overlayName(overlay.name.c_str());
+				AttachOverlay(overlayName, overlay.mesh, actor, firstSkin, rootNode, NULL, NULL);
+			});
+		});
+	}
+
+	// Face slots install under the skeleton's root node, sourced from the face head part
+	BSFaceGenNiNode * faceNode = actor->GetFaceGenNiNode();
+	TESNPC * actorBase = DYNAMIC_CAST(actor->baseForm, TESForm, TESNPC);
+	BGSHeadPart * headPart = actorBase ? actorBase->GetCurrentHeadPartByType(BGSHeadPart::kTypeFace) : NULL;
+	if (faceDestination && faceNode && headPart)
+	{
+		NiAVObject * headNode = faceNode->GetObjectByName(&headPart->partName.data);
+		BSGeometry * firstFace = headNode ? GetFirstShaderType(headNode, BSShaderMaterial::kShaderType_FaceGen) : NULL;
+		if (firstFace)
+		{
+			BGSTextureSet * textureSet = actorBase->headData ? actorBase->headData->headTexture : NULL;
+			installPlan.VisitPart(kFaceOverlayPart, [&](UInt32 slot, const OverlaySlot & overlay)
+			{
+				BSFixedString overlayName(overlay.name.c_str());
+				AttachOverlay(overlayName, overlay.mesh, actor, firstFace, faceDestination, textureSet, NULL);
+			});
+		}
+	}
+}
+
 void OverlayInterface::SetupOverlay(UInt32 primaryCount, const char * primaryPath, const char * primaryNode, UInt32 secondaryCount, const char * secondaryPath, const char * secondaryNode, TESObjectREFR * refr, NiNode * boneTree, NiAVObject * resultNode)
 {
 	BSGeometry * skin = GetFirstShaderType(resultNode, BSShaderMaterial::kShaderType_FaceGenRGBTint);
@@ -956,70 +1082,24 @@ void OverlayInterface::AddOverlays(TESObjectREFR * reference)
 
 	if (g_enableOverlays)
 	{
-		char buff[MAX_PATH];
-		// Body
-		for (UInt32 i = 0; i < g_numBodyOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, BODY_NODE, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallOverlay(reference, buff, BODY_MESH, BGSBipedObjectForm::kPart_Body, BGSBipedObjectForm::kPart_Body));
-		}
-		for (UInt32 i = 0; i < g_numSpellBodyOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, BODY_NODE_SPELL, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallOverlay(reference, buff, BODY_MAGIC_MESH, BGSBipedObjectForm::kPart_Body, BGSBipedObjectForm::kPart_Body));
-		}
-
-		// Hand
-		for (UInt32 i = 0; i < g_numHandOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, HAND_NODE, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallOverlay(reference, buff, HAND_MESH, BGSBipedObjectForm::kPart_Hands, BGSBipedObjectForm::kPart_Hands));
-		}
-		for (UInt32 i = 0; i < g_numSpellHandOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, HAND_NODE_SPELL, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallOverlay(reference, buff, HAND_MAGIC_MESH, BGSBipedObjectForm::kPart_Hands, BGSBipedObjectForm::kPart_Hands));
-		}
-
-		// Feet
-		for (UInt32 i = 0; i < g_numFeetOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, FEET_NODE, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallOverlay(reference, buff, FEET_MESH, BGSBipedObjectForm::kPart_Feet, BGSBipedObjectForm::kPart_Feet));
-		}
-		for (UInt32 i = 0; i < g_numSpellFeetOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, FEET_NODE_SPELL, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallOverlay(reference, buff, FEET_MAGIC_MESH, BGSBipedObjectForm::kPart_Feet, BGSBipedObjectForm::kPart_Feet));
-		}
-
-		// Face
-		for (UInt32 i = 0; i < g_numFaceOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, FACE_NODE, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallFaceOverlay(reference, buff, FACE_MESH, BGSHeadPart::kTypeFace, BSShaderMaterial::kShaderType_FaceGen));
-		}
-		for (UInt32 i = 0; i < g_numSpellFaceOverlays; i++)
-		{
-			memset(buff, 0, MAX_PATH);
-			sprintf_s(buff, MAX_PATH, FACE_NODE_SPELL, i);
-			g_task->AddTask(new SKSETaskUninstallOverlay(reference, buff));
-			g_task->AddTask(new SKSETaskInstallFaceOverlay(reference, buff, FACE_MAGIC_MESH, BGSHeadPart::kTypeFace, BSShaderMaterial::kShaderType_FaceGen));
-		}
+		// Slot counts are fixed once the ini is loaded, so the plan is built once
+		const OverlaySlotGroup groups[] = {
+			{ BGSBipedObjectForm::kPart_Body, BODY_NODE, BODY_MESH, g_numBodyOverlays },
+			{ BGSBipedObjectForm::kPart_Body, BODY_NODE_SPELL, BODY_MAGIC_MESH, g_numSpellBodyOverlays },
+			{ BGSBipedObjectForm::kPart_Hands, HAND_NODE, HAND_MESH, g_numHandOverlays },
+			{ BGSBipedObjectForm::kPart_Hands, HAND_NODE_SPELL, HAND_MAGIC_MESH, g_numSpellHandOverlays },
+			{ BGSBipedObjectForm::kPart_Feet, FEET_NODE, FEET_MESH, g_numFeetOverlays },
+			{ BGSBipedObjectForm::kPart_Feet, FEET_NODE_SPELL, FEET_MAGIC_MESH, g_numSpellFeetOverlays },
+			{ kFaceOverlayPart, FACE_NODE, FACE_MESH, g_numFaceOverlays },
+			{ kFaceOverlayPart, FACE_NODE_SPELL, FACE_MAGIC_MESH, g_numSpellFaceOverlays },
+		};
+		const UInt32 numGroups = sizeof(groups) / sizeof(groups[0]);
+		if (!installPlan.Matches(groups, numGroups))
+			installPlan.Build(groups, numGroups);
+
+		// One task reinstalls every slot
+		if (installPlan.Size() > 0)
+			g_task->AddTask(new SKSETaskInstallOverlays(reference));
 	}
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "IPluginInterface.h"
+#include "FlatOverrideStorage.h"
+#include "OverlayInstallPlan.h"
 
 class TESObjectARMO;
 class TESObjectARMA;
@@ -17,8 +19,6 @@ class BSGeometry;
 #include "skse64/GameThreads.h"
 #include "skse64/GameTypes.h"
 
-#include <unordered_set>
-
 #define FACE_NODE "Face [Ovl%d]"
 #define FACE_NODE_SPELL "Face [SOvl%d]"
 #define FACE_MESH "meshes\\actors\\character\\character assets\\face_overlay.nif"
@@ -104,6 +104,18 @@ public:
 	UInt32			m_addonMask;
 };
 
+// Uninstalls and installs every overlay slot of one actor, see OverlayInstallPlan
+class SKSETaskInstallOverlays : public TaskDelegate
+{
+public:
+	virtual void Run();
+	virtual void Dispose();
+
+	SKSETaskInstallOverlays(TESObjectREFR * refr);
+
+	UInt32			m_formId;
+};
+
 class SKSETaskModifyOverlay : public TaskDelegate
 {
 public:
@@ -125,7 +137,7 @@ public:
 	SKSETaskUninstallOverlay(TESObjectREFR * refr, BSFixedString nodeName) : SKSETaskModifyOverlay(refr, nodeName){};
 };
 
-class OverlayHolder : public std::unordered_set<UInt32>
+class OverlayHolder : public FlatHandleSet
 {
 public:
 	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
@@ -181,6 +193,9 @@ public:
 	// Relinks default overlays
 	virtual void RebuildOverlays(UInt32 armorMask, UInt32 addonMask, TESObjectREFR * refr, NiNode * boneTree, NiAVObject * resultNode);
 
+	// Reinstalls every overlay slot with one walk per skeleton, game thread only
+	void InstallOverlays(TESObjectREFR * refr);
+
 #ifdef _DEBUG
 	void DumpMap();
 #endif
@@ -188,6 +203,10 @@ public:
 private:
 	std::string defaultTexture;
 	OverlayHolder overlays;
+	OverlayInstallPlan installPlan;
+
+	// InstallOverlay once the node named overlayName in destination, if any, is known
+	void AttachOverlay(BSFixedString & overlayName, const char * path, TESObjectREFR * refr, BSGeometry * source, NiNode * destination, BGSTextureSet * textureSet, NiAVObject * installed);
 
 	// Inherited via IAddonAttachmentInterface
 	virtual void OnAttach(TESObjectREFR * refr, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool isFirstPerson, NiNode * skeleton, NiNode * root) override;
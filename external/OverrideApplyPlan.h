@@ -0,0 +1,211 @@
+#pragma once
+
+#include "skse64_common/skse_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Recorded override application for one attached armor model.
+//
+// ApplyOverrides visits every geometry under the attached node, builds a
+// fixed string from each name ("" when the model has a single geometry) and
+// looks it up in the addon's registration, on every attach. A plan records,
+// for each geometry that has overrides, the child indices leading to it and
+// the override set it got. A later attach of the same model replays those
+// paths instead, without a full traversal or any name hashing.
+//
+// Node names are interned, so the replay checks each geometry against the
+// recorded name by pointer, and touches no node off the recorded paths. A
+// path only proves its own geometry is still there: what else the tree holds
+// is decided by the model file it was attached from, which is part of the
+// plan's key. If a recorded geometry is gone, Replay() applies nothing and
+// returns false, and the caller compiles again.
+//
+// Node access is a traits type, so the plan runs on a synthetic tree in tests:
+//
+//   static UInt32 ChildCount(Node * node);	// 0 for geometry and leaves
+//   static Node * Child(Node * node, UInt32 i);	// may be null
+//   static bool IsGeometry(Node * node);
+//   static const char * Name(Node * node);
+
+template <class Set>
+class OverrideApplyPlan
+{
+public:
+	struct Step
+	{
+		UInt32			pathBegin;
+		UInt32			pathLength;
+		const char		* name;
+		Set				* set;
+	};
+
+	// Walks the tree once. lookup(const char * name) returns the set of a
+	// geometry name, or null when it has no overrides.
+	template <class Access, class Node, class Lookup>
+	void Compile(Node * root, Lookup && lookup)
+	{
+		m_steps.clear();
+		m_paths.clear();
+		m_geometryCount = 0;
+
+		std::vector<UInt16> path;
+		if (root)
+			Collect<Access>(root, path);
+
+		// A lone geometry is registered under the empty name
+		UInt32 out = 0;
+		for (UInt32 i = 0; i < m_steps.size(); ++i)
+		{
+			Step step = m_steps[i];
+			step.set = lookup(m_geometryCount == 1 ? "" : step.name);
+			if (step.set)
+				m_steps[out++] = step;
+		}
+		m_steps.resize(out);
+	}
+
+	// apply(Node * geometry, Set * set) for every recorded geometry in tree
+	// order; false and nothing applied if the tree does not match the plan
+	template <class Access, class Node, class F>
+	bool Replay(Node * root, F && apply) const
+	{
+		for (const Step & step : m_steps)
+		{
+			if (!Resolve<Access>(root, step))
+				return false;
+		}
+
+		for (const Step & step : m_steps)
+			apply(Resolve<Access>(root, step), step.set);
+		return true;
+	}
+
+	UInt32 Size() const { return static_cast<UInt32>(m_steps.size()); }
+	const Step & GetStep(UInt32 i) const { return m_steps[i]; }
+	const UInt16 * Path(const Step & step) const { return m_paths.data() + step.pathBegin; }
+
+	// Geometries under the root when compiled
+	UInt32 GeometryCount() const { return m_geometryCount; }
+
+private:
+	template <class Access, class Node>
+	void Collect(Node * node, std::vector<UInt16> & path)
+	{
+		if (Access::IsGeometry(node))
+		{
+			Step step;
+			step.pathBegin = static_cast<UInt32>(m_paths.size());
+			step.pathLength = static_cast<UInt32>(path.size());
+			step.name = Access::Name(node);
+			step.set = nullptr;
+			m_paths.insert(m_paths.end(), path.begin(), path.end());
+			m_steps.push_back(step);
+			m_geometryCount++;
+			return;
+		}
+
+		UInt32 count = Access::ChildCount(node);
+		for (UInt32 i = 0; i < count; ++i)
+		{
+			if (Node * child = Access::Child(node, i))
+			{
+				path.push_back(static_cast<UInt16>(i));
+				Collect<Access>(child, path);
+				path.pop_back();
+			}
+		}
+	}
+
+	template <class Access, class Node>
+	Node * Resolve(Node * root, const Step & step) const
+	{
+		Node * node = root;
+		const UInt16 * path = Path(step);
+		for (UInt32 i = 0; node && i < step.pathLength; ++i)
+			node = path[i] < Access::ChildCount(node) ? Access::Child(node, path[i]) : nullptr;
+
+		return (node && Access::IsGeometry(node) && Access::Name(node) == step.name) ? node : nullptr;
+	}
+
+	std::vector<Step>	m_steps;
+	std::vector<UInt16>	m_paths;	// Child indices of every step, back to back
+	UInt32				m_geometryCount = 0;
+};
+
+// An attached model: whose overrides, and which node was attached
+struct OverrideApplyPlanKey
+{
+	UInt32			actor;
+	UInt32			armor;
+	UInt32			addon;
+	UInt32			gender;
+	const char		* model;		// Interned path of the model file the tree was attached from
+	const char		* rootName;		// Interned, differs per addon model
+	UInt32			rootChildren;
+	bool			firstPerson;	// Both views may attach the same model
+
+	bool operator==(const OverrideApplyPlanKey & rhs) const
+	{
+		return actor == rhs.actor && armor == rhs.armor && addon == rhs.addon && gender == rhs.gender &&
+			model == rhs.model && rootName == rhs.rootName && rootChildren == rhs.rootChildren && firstPerson == rhs.firstPerson;
+	}
+};
+
+struct OverrideApplyPlanKeyHash
+{
+	size_t operator()(const OverrideApplyPlanKey & key) const
+	{
+		UInt64 h = (static_cast<UInt64>(key.actor) << 32) ^ key.armor;
+		h = h * 0x9E3779B97F4A7C15ULL ^ ((static_cast<UInt64>(key.addon) << 32) | (key.gender << 17) | (key.firstPerson ? 0x10000 : 0) | (key.rootChildren & 0xFFFF));
+		h = h * 0x9E3779B97F4A7C15ULL ^ reinterpret_cast<uintptr_t>(key.model);
+		h = h * 0x9E3779B97F4A7C15ULL ^ reinterpret_cast<uintptr_t>(key.rootName);
+		return static_cast<size_t>(h ^ (h >> 29));
+	}
+};
+
+// Plans by attached model. Every plan belongs to one generation of the
+// registrations; a new generation drops them all.
+template <class Set>
+class OverrideApplyPlanCache
+{
+public:
+	enum
+	{
+		kMaxPlans = 4096
+	};
+
+	// Plan compiled for key in this generation, or null
+	const OverrideApplyPlan<Set> * Find(const OverrideApplyPlanKey & key, UInt32 generation)
+	{
+		if (generation != m_generation)
+		{
+			m_plans.clear();
+			m_generation = generation;
+			return nullptr;
+		}
+
+		auto it = m_plans.find(key);
+		return it != m_plans.end() ? &it->second : nullptr;
+	}
+
+	// Slot for the plan of key, to compile into
+	OverrideApplyPlan<Set> & Insert(const OverrideApplyPlanKey & key, UInt32 generation)
+	{
+		if (generation != m_generation || m_plans.size() >= kMaxPlans)
+		{
+			m_plans.clear();
+			m_generation = generation;
+		}
+		return m_plans[key];
+	}
+
+	void Clear() { m_plans.clear(); }
+	size_t Size() const { return m_plans.size(); }
+
+private:
+	std::unordered_map<OverrideApplyPlanKey, OverrideApplyPlan<Set>, OverrideApplyPlanKeyHash>	m_plans;
+	UInt32	m_generation = 0;
+};
@@ -5,6 +5,7 @@
 #include "ShaderUtilities.h"
 #include "OverrideVariant.h"
 #include "StringTable.h"
+#include "BufferedSerialization.h"
 #include "NifUtils.h"
 #include "Utilities.h"
 #include "ActorUpdateManager.h"
@@ -28,10 +29,10 @@ UInt32 OverrideInterface::GetVersion()
 
 void OverrideInterface::AddRawOverride(OverrideHandle handle, bool isFemale, OverrideHandle armorHandle, OverrideHandle addonHandle, BSFixedString nodeName, OverrideVariant & value)
 {
-	armorData.Lock();
-	armorData.m_data[handle][isFemale ? 1 : 0][armorHandle][addonHandle][g_stringTable.GetString(nodeName)].erase(value);
-	armorData.m_data[handle][isFemale ? 1 : 0][armorHandle][addonHandle][g_stringTable.GetString(nodeName)].insert(value);
-	armorData.Release();
+	auto writer = armorData.Write(handle);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][armorHandle][addonHandle][g_stringTable.GetString(nodeName)];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddOverride(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor, TESObjectARMA * addon, BSFixedString nodeName, OverrideVariant & value)
@@ -39,53 +40,53 @@ void OverrideInterface::AddOverride(TESObjectREFR * refr, bool isFemale, TESObje
 	OverrideHandle formId = refr->formID;
 	OverrideHandle armorFormId = armor->formID;
 	OverrideHandle addonFormId = addon->formID;
-	armorData.Lock();
-	armorData.m_data[formId][isFemale ? 1 : 0][armorFormId][addonFormId][g_stringTable.GetString(nodeName)].erase(value);
-	armorData.m_data[formId][isFemale ? 1 : 0][armorFormId][addonFormId][g_stringTable.GetString(nodeName)].insert(value);
-	armorData.Release();
+	auto writer = armorData.Write(formId);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][armorFormId][addonFormId][g_stringTable.GetString(nodeName)];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddRawNodeOverride(OverrideHandle handle, bool isFemale, BSFixedString nodeName, OverrideVariant & value)
 {
-	nodeData.Lock();
-	nodeData.m_data[handle][isFemale ? 1 : 0][g_stringTable.GetString(nodeName)].erase(value);
-	nodeData.m_data[handle][isFemale ? 1 : 0][g_stringTable.GetString(nodeName)].insert(value);
-	nodeData.Release();
+	auto writer = nodeData.Write(handle);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][g_stringTable.GetString(nodeName)];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddNodeOverride(TESObjectREFR * refr, bool isFemale, BSFixedString nodeName, OverrideVariant & value)
 {
 	OverrideHandle handle = refr->formID;
-	nodeData.Lock();
-	nodeData.m_data[handle][isFemale ? 1 : 0][g_stringTable.GetString(nodeName)].erase(value);
-	nodeData.m_data[handle][isFemale ? 1 : 0][g_stringTable.GetString(nodeName)].insert(value);
-	nodeData.Release();
+	auto writer = nodeData.Write(handle);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][g_stringTable.GetString(nodeName)];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddRawWeaponOverride(OverrideHandle handle, bool isFemale, bool firstPerson, OverrideHandle weaponHandle, BSFixedString nodeName, OverrideVariant & value)
 {
-	weaponData.Lock();
-	weaponData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][weaponHandle][g_stringTable.GetString(nodeName)].erase(value);
-	weaponData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][weaponHandle][g_stringTable.GetString(nodeName)].insert(value);
-	weaponData.Release();
+	auto writer = weaponData.Write(handle);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][firstPerson ? 1 : 0][weaponHandle][g_stringTable.GetString(nodeName)];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddWeaponOverride(TESObjectREFR * refr, bool isFemale, bool firstPerson, TESObjectWEAP * weapon, BSFixedString nodeName, OverrideVariant & value)
 {
 	OverrideHandle handle = refr->formID;
 	OverrideHandle weaponHandle = weapon->formID;
-	weaponData.Lock();
-	weaponData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][weaponHandle][g_stringTable.GetString(nodeName)].erase(value);
-	weaponData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][weaponHandle][g_stringTable.GetString(nodeName)].insert(value);
-	weaponData.Release();
+	auto writer = weaponData.Write(handle);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][firstPerson ? 1 : 0][weaponHandle][g_stringTable.GetString(nodeName)];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddRawSkinOverride(OverrideHandle handle, bool isFemale, bool firstPerson, UInt32 slotMask, OverrideVariant & value)
 {
-	skinData.Lock();
-	skinData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][slotMask].erase(value);
-	skinData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][slotMask].insert(value);
-	skinData.Release();
+	auto writer = skinData.Write(handle);
+	OverrideSet & set = writer.Get()[isFemale ? 1 : 0][firstPerson ? 1 : 0][slotMask];
+	set.erase(value);
+	set.insert(value);
 }
 
 void OverrideInterface::AddSkinOverride(TESObjectREFR * refr, bool isFemale, bool firstPerson, UInt32 slotMask, OverrideVariant & value)
@@ -96,9 +97,8 @@ void OverrideInterface::AddSkinOverride(TESObjectREFR * refr, bool isFemale, boo
 OverrideVariant * OverrideInterface::GetOverride(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor, TESObjectARMA * addon, BSFixedString nodeName, UInt16 key, UInt8 index)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(refr->formID);
-	if(it != armorData.m_data.end())
+	auto reader = armorData.Read(refr->formID);
+	if(auto it = reader.Find())
 	{
 		auto & ait = it->second[gender].find(armor->formID);
 		if(ait != it->second[gender].end())
@@ -128,9 +128,8 @@ OverrideVariant * OverrideInterface::GetOverride(TESObjectREFR * refr, bool isFe
 OverrideVariant * OverrideInterface::GetNodeOverride(TESObjectREFR * refr, bool isFemale, BSFixedString nodeName, UInt16 key, UInt8 index)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&nodeData.m_lock);
-	auto & it = nodeData.m_data.find(refr->formID);
-	if(it != nodeData.m_data.end())
+	auto reader = nodeData.Read(refr->formID);
+	if(auto it = reader.Find())
 	{
 		auto & oit = it->second[gender].find(g_stringTable.GetString(nodeName));
 		if(oit != it->second[gender].end())
@@ -152,9 +151,8 @@ OverrideVariant * OverrideInterface::GetNodeOverride(TESObjectREFR * refr, bool
 OverrideVariant * OverrideInterface::GetWeaponOverride(TESObjectREFR * refr, bool isFemale, bool firstPerson, TESObjectWEAP * weapon, BSFixedString nodeName, UInt16 key, UInt8 index)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&weaponData.m_lock);
-	auto & it = weaponData.m_data.find(refr->formID);
-	if (it != weaponData.m_data.end())
+	auto reader = weaponData.Read(refr->formID);
+	if (auto it = reader.Find())
 	{
 		auto & ait = it->second[gender][firstPerson].find(weapon->formID);
 		if (ait != it->second[gender][firstPerson].end())
@@ -180,9 +178,8 @@ OverrideVariant * OverrideInterface::GetWeaponOverride(TESObjectREFR * refr, boo
 OverrideVariant * OverrideInterface::GetSkinOverride(TESObjectREFR * refr, bool isFemale, bool firstPerson, UInt32 slotMask, UInt16 key, UInt8 index)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&skinData.m_lock);
-	auto & it = skinData.m_data.find(refr->formID);
-	if (it != skinData.m_data.end())
+	auto reader = skinData.Read(refr->formID);
+	if (auto it = reader.Find())
 	{
 		auto & slot = it->second[gender][firstPerson].find(slotMask);
 		if(slot != it->second[gender][firstPerson].end())
@@ -223,42 +220,34 @@ void OverrideInterface::RemoveAllReferenceSkinOverrides(TESObjectREFR * refr)
 
 void OverrideInterface::RemoveAllReferenceOverrides(OverrideHandle handle)
 {
-	armorData.Lock();
-	armorData.m_data.erase(handle);
-	armorData.Release();
+	armorData.Write(handle).Erase();
 }
 
 void OverrideInterface::RemoveAllReferenceNodeOverrides(OverrideHandle handle)
 {
-	nodeData.Lock();
-	nodeData.m_data.erase(handle);
-	nodeData.Release();
+	nodeData.Write(handle).Erase();
 }
 
 void OverrideInterface::RemoveAllReferenceWeaponOverrides(OverrideHandle handle)
 {
-	weaponData.Lock();
-	weaponData.m_data.erase(handle);
-	weaponData.Release();
+	weaponData.Write(handle).Erase();
 }
 
 void OverrideInterface::RemoveAllReferenceSkinOverrides(OverrideHandle handle)
 {
-	skinData.Lock();
-	skinData.m_data.erase(handle);
-	skinData.Release();
+	skinData.Write(handle).Erase();
 }
 
 void OverrideInterface::RemoveAllArmorOverrides(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(refr->formID);
-	if(it != armorData.m_data.end())
+	auto writer = armorData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		auto & nit = it->second[gender].find(armor->formID);
 		if(nit != it->second[gender].end()) {
 			nit->second.clear();
+			writer.Changed();
 		}
 	}
 }
@@ -266,9 +255,8 @@ void OverrideInterface::RemoveAllArmorOverrides(TESObjectREFR * refr, bool isFem
 void OverrideInterface::RemoveAllArmorAddonOverrides(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor, TESObjectARMA * addon)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(refr->formID);
-	if(it != armorData.m_data.end())
+	auto writer = armorData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		auto & ait = it->second[gender].find(armor->formID);
 		if(ait != it->second[gender].end())
@@ -277,6 +265,7 @@ void OverrideInterface::RemoveAllArmorAddonOverrides(TESObjectREFR * refr, bool
 			if(dit != ait->second.end())
 			{
 				ait->second.erase(dit);
+				writer.Changed();
 			}
 		}
 	}
@@ -285,9 +274,8 @@ void OverrideInterface::RemoveAllArmorAddonOverrides(TESObjectREFR * refr, bool
 void OverrideInterface::RemoveAllArmorAddonNodeOverrides(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor, TESObjectARMA * addon, BSFixedString nodeName)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(refr->formID);
-	if(it != armorData.m_data.end())
+	auto writer = armorData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		auto & ait = it->second[gender].find(armor->formID);
 		if(ait != it->second[gender].end())
@@ -299,6 +287,7 @@ void OverrideInterface::RemoveAllArmorAddonNodeOverrides(TESObjectREFR * refr, b
 				if(oit != dit->second.end())
 				{
 					dit->second.erase(oit);
+					writer.Changed();
 				}
 			}
 		}
@@ -308,9 +297,8 @@ void OverrideInterface::RemoveAllArmorAddonNodeOverrides(TESObjectREFR * refr, b
 void OverrideInterface::RemoveArmorAddonOverride(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor, TESObjectARMA * addon, BSFixedString nodeName, UInt16 key, UInt8 index)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(refr->formID);
-	if(it != armorData.m_data.end())
+	auto writer = armorData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		auto & ait = it->second[gender].find(armor->formID);
 		if(ait != it->second[gender].end())
@@ -328,6 +316,7 @@ void OverrideInterface::RemoveArmorAddonOverride(TESObjectREFR * refr, bool isFe
 					if(ost != oit->second.end())
 					{
 						oit->second.erase(ost);
+						writer.Changed();
 					}
 				}
 			}
@@ -338,14 +327,14 @@ void OverrideInterface::RemoveArmorAddonOverride(TESObjectREFR * refr, bool isFe
 void OverrideInterface::RemoveAllNodeNameOverrides(TESObjectREFR * refr, bool isFemale, BSFixedString nodeName)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&nodeData.m_lock);
-	auto & it = nodeData.m_data.find(refr->formID);
-	if(it != nodeData.m_data.end())
+	auto writer = nodeData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		auto & oit = it->second[gender].find(g_stringTable.GetString(nodeName));
 		if(oit != it->second[gender].end())
 		{
 			it->second[gender].erase(oit);
+			writer.Changed();
 		}
 	}
 }
@@ -353,9 +342,8 @@ void OverrideInterface::RemoveAllNodeNameOverrides(TESObjectREFR * refr, bool is
 void OverrideInterface::RemoveNodeOverride(TESObjectREFR * refr, bool isFemale, BSFixedString nodeName, UInt16 key, UInt8 index)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&nodeData.m_lock);
-	auto & it = nodeData.m_data.find(refr->formID);
-	if(it != nodeData.m_data.end())
+	auto writer = nodeData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		auto & oit = it->second[gender].find(g_stringTable.GetString(nodeName));
 		if(oit != it->second[gender].end())
@@ -367,6 +355,7 @@ void OverrideInterface::RemoveNodeOverride(TESObjectREFR * refr, bool isFemale,
 			if(ost != oit->second.end())
 			{
 				oit->second.erase(ost);
+				writer.Changed();
 			}
 		}
 	}
@@ -375,14 +364,14 @@ void OverrideInterface::RemoveNodeOverride(TESObjectREFR * refr, bool isFemale,
 void OverrideInterface::RemoveAllWeaponOverrides(TESObjectREFR * refr, bool isFemale, bool firstPerson, TESObjectWEAP * weapon)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&weaponData.m_lock);
-	auto & it = weaponData.m_data.find(refr->formID);
-	if(it != weaponData.m_data.end())
+	auto writer = weaponData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		WeaponRegistration::iterator ait = it->second[gender][firstPerson ? 1 : 0].find(weapon->formID);
 		if(ait != it->second[gender][firstPerson ? 1 : 0].end())
 		{
 			it->second[gender][firstPerson ? 1 : 0].erase(ait);
+			writer.Changed();
 		}
 	}
 }
@@ -392,9 +381,8 @@ void OverrideInterface::RemoveAllWeaponNodeOverrides(TESObjectREFR * refr, bool
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt8 fPerson = firstPerson ? 1 : 0;
 
-	SimpleLocker locker(&weaponData.m_lock);
-	auto & it = weaponData.m_data.find(refr->formID);
-	if(it != weaponData.m_data.end())
+	auto writer = weaponData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		WeaponRegistration::iterator ait = it->second[gender][fPerson].find(weapon->formID);
 		if(ait != it->second[gender][firstPerson].end())
@@ -403,6 +391,7 @@ void OverrideInterface::RemoveAllWeaponNodeOverrides(TESObjectREFR * refr, bool
 			if(oit != ait->second.end())
 			{
 				ait->second.erase(oit);
+				writer.Changed();
 			}
 		}
 	}
@@ -413,9 +402,8 @@ void OverrideInterface::RemoveWeaponOverride(TESObjectREFR * refr, bool isFemale
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt8 fPerson = firstPerson ? 1 : 0;
 
-	SimpleLocker locker(&weaponData.m_lock);
-	auto & it = weaponData.m_data.find(refr->formID);
-	if(it != weaponData.m_data.end())
+	auto writer = weaponData.Write(refr->formID);
+	if(auto it = writer.Find())
 	{
 		WeaponRegistration::iterator ait = it->second[gender][fPerson].find(weapon->formID);
 		if(ait != it->second[gender][firstPerson].end())
@@ -430,6 +418,7 @@ void OverrideInterface::RemoveWeaponOverride(TESObjectREFR * refr, bool isFemale
 				if(ost != oit->second.end())
 				{
 					oit->second.erase(ost);
+					writer.Changed();
 				}
 			}
 		}
@@ -439,14 +428,14 @@ void OverrideInterface::RemoveWeaponOverride(TESObjectREFR * refr, bool isFemale
 void OverrideInterface::RemoveAllSkinOverrides(TESObjectREFR * refr, bool isFemale, bool firstPerson, UInt32 slotMask)
 {
 	UInt8 gender = isFemale ? 1 : 0;
-	SimpleLocker locker(&skinData.m_lock);
-	auto & it = skinData.m_data.find(refr->formID);
-	if (it != skinData.m_data.end())
+	auto writer = skinData.Write(refr->formID);
+	if (auto it = writer.Find())
 	{
 		auto & slot = it->second[gender][firstPerson].find(slotMask);
 		if (slot != it->second[gender][firstPerson].end())
 		{
 			it->second[gender][firstPerson].erase(slot);
+			writer.Changed();
 		}
 	}
 }
@@ -456,9 +445,8 @@ void OverrideInterface::RemoveSkinOverride(TESObjectREFR * refr, bool isFemale,
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt8 fPerson = firstPerson ? 1 : 0;
 
-	SimpleLocker locker(&skinData.m_lock);
-	auto & it = skinData.m_data.find(refr->formID);
-	if (it != skinData.m_data.end())
+	auto writer = skinData.Write(refr->formID);
+	if (auto it = writer.Find())
 	{
 		auto & slot = it->second[gender][firstPerson].find(slotMask);
 		if (slot != it->second[gender][firstPerson].end())
@@ -470,6 +458,7 @@ void OverrideInterface::RemoveSkinOverride(TESObjectREFR * refr, bool isFemale,
 			if (ost != slot->second.end())
 			{
 				slot->second.erase(ost);
+				writer.Changed();
 			}
 		}
 	}
@@ -710,6 +699,26 @@ void OverrideInterface::GetSkinProperty(TESObjectREFR * refr, bool firstPerson,
 	}
 }
 
+namespace
+{
+	// Override sets found under a shard Reader, with the node each goes to.
+	// They are applied once the Reader is gone: SetShaderProperty calls into
+	// the game and back into SKEE, which may take the same shard for writing.
+	typedef std::vector<std::pair<NiAVObject *, OverrideSet>> PendingOverrides;
+
+	void ApplyPending(PendingOverrides & pending, bool immediate)
+	{
+		for(auto & entry : pending)
+		{
+			entry.second.Visit([&](OverrideVariant & value)
+			{
+				SetShaderProperty(entry.first, &value, immediate);
+				return false;
+			});
+		}
+	}
+}
+
 void OverrideInterface::SetProperties(OverrideHandle formId, bool immediate)
 {
 	TESForm* form = LookupFormByID(formId);
@@ -727,17 +736,20 @@ void OverrideInterface::SetProperties(OverrideHandle formId, bool immediate)
 	if(actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(formId); // Find ActorHandle
-	if(it != armorData.m_data.end())
+	PendingOverrides pending;
 	{
-		for(ArmorRegistration::iterator ait = it->second[gender].begin(); ait != it->second[gender].end(); ++ait) // Loop Armors
+		auto reader = armorData.Read(formId); // Find ActorHandle
+		auto it = reader.Find();
+		if(!it)
+			return;
+
+		for(auto ait = it->second[gender].begin(); ait != it->second[gender].end(); ++ait) // Loop Armors
 		{
 			TESObjectARMO * armor = static_cast<TESObjectARMO *>(LookupFormByID(ait->first));
 			if(!armor)
 				continue;
 
-			for(AddonRegistration::iterator dit = ait->second.begin(); dit != ait->second.end(); ++dit) // Loop Addons
+			for(auto dit = ait->second.begin(); dit != ait->second.end(); ++dit) // Loop Addons
 			{
 				TESObjectARMA * addon = static_cast<TESObjectARMA *>(LookupFormByID(dit->first));
 				if(!addon)
@@ -745,17 +757,12 @@ void OverrideInterface::SetProperties(OverrideHandle formId, bool immediate)
 
 				VisitArmorAddon(actor, armor, addon, [&](bool isFP, NiNode * rootNode, NiAVObject * armorNode)
 				{
-					dit->second.Visit([&](const StringTableItem & key, OverrideSet * set)
+					dit->second.Visit([&](const StringTableItem & key, const OverrideSet & set)
 					{
 						BSFixedString nodeName(key->c_str());
 						NiAVObject * foundNode = nodeName == BSFixedString("") ? armorNode : armorNode->GetObjectByName(&nodeName.data);
-						if (foundNode) {
-							set->Visit([&](OverrideVariant * value)
-							{
-								SetShaderProperty(foundNode, value, immediate);
-								return false;
-							});
-						}
+						if (foundNode)
+							pending.emplace_back(foundNode, set);
 
 						return false;
 					});
@@ -763,6 +770,8 @@ void OverrideInterface::SetProperties(OverrideHandle formId, bool immediate)
 			}
 		}
 	}
+
+	ApplyPending(pending, immediate);
 }
 
 void OverrideInterface::SetNodeProperty(TESObjectREFR * refr, BSFixedString nodeName, OverrideVariant * value, bool immediate)
@@ -813,10 +822,15 @@ void OverrideInterface::SetNodeProperties(OverrideHandle formId, bool immediate)
 	if(actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&nodeData.m_lock);
-	auto & nit = nodeData.m_data.find(formId); // Find ActorHandle
-	if(nit != nodeData.m_data.end())
+	// Roots are held until the pending sets are applied
+	NiPointer<NiNode> roots[2];
+	PendingOverrides pending;
 	{
+		auto reader = nodeData.Read(formId); // Find ActorHandle
+		auto nit = reader.Find();
+		if(!nit)
+			return;
+
 		NiNode * lastRoot = NULL;
 		for(UInt8 i = 0; i <= 1; i++)
 		{
@@ -826,27 +840,23 @@ void OverrideInterface::SetNodeProperties(OverrideHandle formId, bool immediate)
 
 			if(root)
 			{
-				root->IncRef();
-				nit->second[gender].Visit([&](const StringTableItem & key, OverrideSet * set)
+				roots[i] = root;
+				nit->second[gender].Visit([&](const StringTableItem & key, const OverrideSet & set)
 				{
 					BSFixedString nodeName(key->c_str());
 					NiAVObject * foundNode = nodeName == BSFixedString("") ? root : root->GetObjectByName(&nodeName.data);
-					if (foundNode) {
-						set->Visit([&](OverrideVariant * value)
-						{
-							SetShaderProperty(foundNode, value, immediate);
-							return false;
-						});
-					}
+					if (foundNode)
+						pending.emplace_back(foundNode, set);
 
 					return false;
 				});
-				root->DecRef();
 			}
 
 			lastRoot = root;
 		}
 	}
+
+	ApplyPending(pending, immediate);
 }
 
 void OverrideInterface::SetWeaponProperties(OverrideHandle formId, bool immediate)
@@ -865,13 +875,18 @@ void OverrideInterface::SetWeaponProperties(OverrideHandle formId, bool immediat
 	if (actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&weaponData.m_lock);
-	auto & it = weaponData.m_data.find(refr->formID); // Find ActorHandle
-	if (it != weaponData.m_data.end())
+	// Roots are held until the pending sets are applied
+	NiPointer<NiNode> roots[2];
+	PendingOverrides pending;
 	{
+		auto reader = weaponData.Read(refr->formID); // Find ActorHandle
+		auto it = reader.Find();
+		if (!it)
+			return;
+
 		for (UInt8 i = 0; i <= 1; i++)
 		{
-			for (WeaponRegistration::iterator ait = it->second[gender][i].begin(); ait != it->second[gender][i].end(); ++ait) // Loop Armors
+			for (auto ait = it->second[gender][i].begin(); ait != it->second[gender][i].end(); ++ait) // Loop Armors
 			{
 				TESObjectWEAP * weapon = static_cast<TESObjectWEAP *>(LookupFormByID(ait->first));
 				if (!weapon)
@@ -889,32 +904,28 @@ void OverrideInterface::SetWeaponProperties(OverrideHandle formId, bool immediat
 
 				if (root)
 				{
-					root->IncRef();
+					roots[i] = root;
 					// Find the Armor node
 					NiAVObject * weaponNode = root->GetObjectByName(&weaponName.data);
 					if (weaponNode) {
-						ait->second.Visit([&](const StringTableItem & key, OverrideSet * set)
+						ait->second.Visit([&](const StringTableItem & key, const OverrideSet & set)
 						{
 							BSFixedString nodeName(key->c_str());
 							NiAVObject * foundNode = nodeName == BSFixedString("") ? weaponNode : weaponNode->GetObjectByName(&nodeName.data);
-							if (foundNode) {
-								set->Visit([&](OverrideVariant * value)
-								{
-									SetShaderProperty(foundNode, value, immediate);
-									return false;
-								});
-							}
+							if (foundNode)
+								pending.emplace_back(foundNode, set);
 
 							return false;
 						});
 					}
-					root->DecRef();
 				}
 
 				lastNode = root;
 			}
 		}
 	}
+
+	ApplyPending(pending, immediate);
 }
 
 void OverrideInterface::SetSkinProperties(OverrideHandle formId, bool immediate)
@@ -935,13 +946,18 @@ void OverrideInterface::SetSkinProperties(OverrideHandle formId, bool immediate)
 	if (actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&skinData.m_lock);
-	auto & it = skinData.m_data.find(refr->formID); // Find ActorHandle
-	if (it != skinData.m_data.end())
+	// Roots are held until the pending sets are applied
+	NiPointer<NiNode> roots[2];
+	PendingOverrides pending;
 	{
+		auto reader = skinData.Read(refr->formID); // Find ActorHandle
+		auto it = reader.Find();
+		if (!it)
+			return;
+
 		for (UInt8 fp = 0; fp <= 1; fp++)
 		{
-			for (SkinRegistration::iterator ait = it->second[gender][fp].begin(); ait != it->second[gender][fp].end(); ++ait) // Loop Armors
+			for (auto ait = it->second[gender][fp].begin(); ait != it->second[gender][fp].end(); ++ait) // Loop Armors
 			{
 				NiNode * lastNode = NULL;
 				NiPointer<NiNode> root = refr->GetNiRootNode(fp);
@@ -950,6 +966,7 @@ void OverrideInterface::SetSkinProperties(OverrideHandle formId, bool immediate)
 
 				if (root)
 				{
+					roots[fp] = root;
 					TESForm * pForm = GetSkinForm(actor, ait->first);
 					TESObjectARMO * armor = DYNAMIC_CAST(pForm, TESForm, TESObjectARMO);
 					if (armor) {
@@ -970,13 +987,7 @@ void OverrideInterface::SetSkinProperties(OverrideHandle formId, bool immediate)
 												{
 													BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)shaderProperty->material;
 													if (material && material->GetShaderType() == BSLightingShaderMaterial::kShaderType_FaceGenRGBTint)
-													{
-														ait->second.Visit([&](OverrideVariant * value)
-														{
-															SetShaderProperty(object, value, immediate);
-															return false;
-														});
-													}
+														pending.emplace_back(object, ait->second);
 												}
 											}
 											return false;
@@ -991,47 +1002,8 @@ void OverrideInterface::SetSkinProperties(OverrideHandle formId, bool immediate)
 			}
 		}
 	}
-}
 
-void OverrideInterface::VisitNodes(TESObjectREFR * refr, std::function<void(SKEEFixedString, OverrideVariant&)> functor)
-{	
-	UInt8 gender = 0;
-	TESNPC * actorBase = DYNAMIC_CAST(refr->baseForm, TESForm, TESNPC);
-	if (actorBase)
-		gender = CALL_MEMBER_FN(actorBase, GetSex)();
-
-	SimpleLocker locker(&nodeData.m_lock);
-	auto & nit = nodeData.m_data.find(refr->formID); // Find ActorHandle
-	if (nit != nodeData.m_data.end())
-	{
-		for (auto & ovr : nit->second[gender]) // Loop Overrides
-		{
-			for (auto prop : ovr.second) {
-				functor(*ovr.first, prop);
-			}
-		}
-	}
-}
-
-void OverrideInterface::VisitSkin(TESObjectREFR * refr, bool isFemale, bool firstPerson, std::function<void(UInt32, OverrideVariant&)> functor)
-{
-	UInt8 fp = firstPerson ? 1 : 0;
-	UInt8 gender = 0;
-	TESNPC * actorBase = DYNAMIC_CAST(refr->baseForm, TESForm, TESNPC);
-	if (actorBase)
-		gender = CALL_MEMBER_FN(actorBase, GetSex)();
-
-	SimpleLocker locker(&skinData.m_lock);
-	auto & it = skinData.m_data.find(refr->formID);
-	if (it != skinData.m_data.end())
-	{
-		for (auto & ovr : it->second[gender][fp])
-		{
-			for (auto prop : ovr.second) {
-				functor(ovr.first, prop);
-			}
-		}
-	}
+	ApplyPending(pending, immediate);
 }
 
 /*
@@ -1107,66 +1079,69 @@ void OverrideInterface::SetHandleArmorAddonProperties(UInt64 handle, UInt64 armo
 class NodeOverrideApplicator : public GeometryVisitor
 {
 public:
-	NodeOverrideApplicator::NodeOverrideApplicator(OverrideRegistration<StringTableItem> * overrides, bool immediate) : m_overrides(overrides), m_immediate(immediate) {}
+	NodeOverrideApplicator::NodeOverrideApplicator(const OverrideRegistration<StringTableItem> * overrides, PendingOverrides * pending) : m_overrides(overrides), m_pending(pending) {}
 
 	virtual bool Accept(BSGeometry * geometry)
 	{
 		SKEEFixedString nodeName(geometry->m_name);
 		auto nit = m_overrides->find(g_stringTable.GetString(nodeName));
 		if(nit != m_overrides->end())
-		{
-			nit->second.Visit([&](OverrideVariant * value)
-			{
-				SetShaderProperty(geometry, value, m_immediate);
-				return false;
-			});
-		}
+			m_pending->emplace_back(geometry, nit->second);
 		return false;
 	}
 
-	OverrideRegistration<StringTableItem>	* m_overrides;
-	bool									m_immediate;
+	const OverrideRegistration<StringTableItem>	* m_overrides;
+	PendingOverrides						* m_pending;
 };
 
 class OverrideApplicator : public GeometryVisitor
 {
 public:
-	OverrideApplicator::OverrideApplicator(OverrideRegistration<StringTableItem> * overrides, bool immediate) : m_overrides(overrides), m_immediate(immediate) {}
-
 	virtual bool Accept(BSGeometry * geometry)
 	{
 		m_geometryList.push_back(geometry);
 		return false;
 	}
 
-	void Apply()
+	// Sets of the visited geometries, under the registration's Reader
+	void Collect(const OverrideRegistration<StringTableItem> & overrides, PendingOverrides & pending)
 	{
 		for(auto & geometry : m_geometryList)
 		{
 			SKEEFixedString objectName(m_geometryList.size() == 1 ? "" : geometry->m_name);
-			auto nit = m_overrides->find(g_stringTable.GetString(objectName));
-			if(nit != m_overrides->end())
-			{
-				nit->second.Visit([&](OverrideVariant* value)
-				{
-					SetShaderProperty(geometry, value, m_immediate);
-					return false;
-				});
-			}
+			auto nit = overrides.find(g_stringTable.GetString(objectName));
+			if(nit != overrides.end())
+				pending.emplace_back(geometry, nit->second);
 		}
 	}
 
 	std::vector<BSGeometry*>				m_geometryList;
-	OverrideRegistration<StringTableItem>	* m_overrides;
-	bool									m_immediate;
 };
 
 
+namespace
+{
+	// Scene graph access for OverrideApplyPlan
+	struct NiGeometryAccess
+	{
+		static UInt32 ChildCount(NiAVObject * node)
+		{
+			NiNode * niNode = node->GetAsNiNode();
+			return niNode && niNode->m_children.m_data ? niNode->m_children.m_emptyRunStart : 0;
+		}
+
+		static NiAVObject * Child(NiAVObject * node, UInt32 i) { return node->GetAsNiNode()->m_children.m_data[i]; }
+		static bool IsGeometry(NiAVObject * node) { return node->GetAsBSGeometry() != NULL; }
+		static const char * Name(NiAVObject * node) { return node->m_name; }
+	};
+}
+
 class SkinOverrideApplicator : public GeometryVisitor
 {
 public:
-	SkinOverrideApplicator::SkinOverrideApplicator(TESObjectARMO * armor, TESObjectARMA * addon, UInt32 slotMask, OverrideSet * overrides, bool immediate) : m_armor(armor), m_addon(addon), m_overrides(overrides), m_slotMask(slotMask), m_immediate(immediate) {}
+	SkinOverrideApplicator::SkinOverrideApplicator(TESObjectARMO * armor, TESObjectARMA * addon, UInt32 slotMask) : m_armor(armor), m_addon(addon), m_slotMask(slotMask) {}
 
+	// Skin geometry of the slot
 	virtual bool Accept(BSGeometry * geometry)
 	{
 		UInt32 armorMask = m_armor->bipedObject.GetSlotMask();
@@ -1174,40 +1149,34 @@ public:
 
 		if ((armorMask & m_slotMask) == m_slotMask && (addonMask & m_slotMask) == m_slotMask)
 		{
-			m_geometryList.push_back(geometry);
+			BSShaderProperty * shaderProperty = niptr_cast<BSShaderProperty>(geometry->m_spEffectState);
+			if (shaderProperty && ni_is_type(shaderProperty->GetRTTI(), BSLightingShaderProperty))
+			{
+				BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)shaderProperty->material;
+				if (material && material->GetShaderType() == BSLightingShaderMaterial::kShaderType_FaceGenRGBTint)
+					m_geometryList.push_back(geometry);
+			}
 		}
 
 		return false;
 	}
 
-	void Apply()
+	void Apply(OverrideSet & overrides, bool immediate)
 	{
 		for (auto & geometry : m_geometryList)
 		{
-			BSShaderProperty * shaderProperty = niptr_cast<BSShaderProperty>(geometry->m_spEffectState);
-			if (shaderProperty && ni_is_type(shaderProperty->GetRTTI(), BSLightingShaderProperty))
+			overrides.Visit([&](OverrideVariant & value)
 			{
-				BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)shaderProperty->material;
-				if (material && material->GetShaderType() == BSLightingShaderMaterial::kShaderType_FaceGenRGBTint)
-				{
-					if (m_overrides) {
-						m_overrides->Visit([&](OverrideVariant* value)
-						{
-							SetShaderProperty(geometry, value, m_immediate);
-							return false;
-						});
-					}
-				}
-			}
+				SetShaderProperty(geometry, &value, immediate);
+				return false;
+			});
 		}
 	}
 
 	std::vector<BSGeometry*>	m_geometryList;
 	TESObjectARMO * m_armor;
 	TESObjectARMA * m_addon;
-	OverrideSet	* m_overrides;
 	UInt32	m_slotMask;
-	bool	m_immediate;
 };
 /*
 void OverrideInterface::GetGeometryCount(NiAVObject * object, SInt32 * count)
@@ -1269,37 +1238,72 @@ void OverrideInterface::ApplyNodeOverrides(TESObjectREFR * refr, NiAVObject * ob
 	if(actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&nodeData.m_lock);
-	auto & nit = nodeData.m_data.find(refr->formID);
-	if(nit != nodeData.m_data.end()) {
-		NodeOverrideApplicator applicator(&nit->second[gender], immediate);
+	PendingOverrides pending;
+	{
+		auto reader = nodeData.Read(refr->formID);
+		auto nit = reader.Find();
+		if(!nit)
+			return;
+		NodeOverrideApplicator applicator(&nit->second[gender], &pending);
 		VisitGeometry(object, &applicator);
 	}
+
+	ApplyPending(pending, immediate);
 }
 
 void OverrideInterface::ApplyOverrides(TESObjectREFR * refr, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool immediate)
+{
+	// Callers that do not know the view share the third person plans
+	ApplyOverrides(refr, false, armor, addon, object, immediate);
+}
+
+void OverrideInterface::ApplyOverrides(TESObjectREFR * refr, bool firstPerson, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool immediate)
 {
 	UInt8 gender = 0;
 	TESNPC * actorBase = DYNAMIC_CAST(refr->baseForm, TESForm, TESNPC);
 	if(actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&armorData.m_lock);
-	auto & it = armorData.m_data.find(refr->formID); // Find ActorHandle
-	if(it != armorData.m_data.end())
+	// The plan is replayed under the locks, the sets it finds are applied after
+	PendingOverrides pending;
 	{
+		auto reader = armorData.Read(refr->formID); // Find ActorHandle
+		auto it = reader.Find();
+		if(!it)
+			return;
 		auto ait = it->second[gender].find(armor->formID); // Find ArmorHandle
-		if(ait != it->second[gender].end())
+		if(ait == it->second[gender].end())
+			return;
+		auto dit = ait->second.find(addon->formID); // Find AddonHandle
+		if(dit == ait->second.end())
+			return;
+
+		// Models are attached again on every equip and cell load, replay
+		// what the last attach of the same model file found
+		const char * model = addon->models[gender][firstPerson ? 1 : 0].GetModelName();
+		OverrideApplyPlanKey key = { refr->formID, armor->formID, addon->formID, gender, model, object->m_name, NiGeometryAccess::ChildCount(object), firstPerson };
+		auto collect = [&](NiAVObject * node, const OverrideSet * set)
 		{
-			auto dit = ait->second.find(addon->formID); // Find AddonHandle
-			if(dit != ait->second.end())
+			pending.emplace_back(node, *set);
+		};
+
+		ArmorPlanShard & plans = armorPlans[ActorRegistrationMapHolder::ShardIndex(refr->formID)];
+		std::lock_guard<std::mutex> planLocker(plans.m_lock);
+		const OverrideApplyPlan<const OverrideSet> * plan = plans.m_plans.Find(key, reader.Generation());
+		if(!plan || !plan->Replay<NiGeometryAccess>(object, collect))
+		{
+			const OverrideRegistration<StringTableItem> * overrides = &dit->second;
+			OverrideApplyPlan<const OverrideSet> & compiled = plans.m_plans.Insert(key, reader.Generation());
+			compiled.Compile<NiGeometryAccess>(object, [&](const char * name) -> const OverrideSet *
 			{
-				OverrideApplicator applicator(&dit->second, immediate);
-				VisitGeometry(object, &applicator);
-				applicator.Apply();
-			}
+				auto nit = overrides->find(g_stringTable.GetString(SKEEFixedString(name)));
+				return nit != overrides->end() ? &nit->second : NULL;
+			});
+			compiled.Replay<NiGeometryAccess>(object, collect);
 		}
 	}
+
+	ApplyPending(pending, immediate);
 }
 
 void OverrideInterface::ApplyWeaponOverrides(TESObjectREFR * refr, bool firstPerson, TESObjectWEAP * weapon, NiAVObject * object, bool immediate)
@@ -1309,18 +1313,22 @@ void OverrideInterface::ApplyWeaponOverrides(TESObjectREFR * refr, bool firstPer
 	if(actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&weaponData.m_lock);
-	auto it = weaponData.m_data.find(refr->formID); // Find ActorHandle
-	if(it != weaponData.m_data.end())
+	OverrideApplicator applicator;
+	VisitGeometry(object, &applicator);
+
+	PendingOverrides pending;
 	{
+		auto reader = weaponData.Read(refr->formID); // Find ActorHandle
+		auto it = reader.Find();
+		if(!it)
+			return;
 		auto ait = it->second[gender][firstPerson ? 1 : 0].find(weapon->formID); // Find WeaponHandle
-		if(ait != it->second[gender][firstPerson ? 1 : 0].end())
-		{
-			OverrideApplicator applicator(&ait->second, immediate);
-			VisitGeometry(object, &applicator);
-			applicator.Apply();
-		}
+		if(ait == it->second[gender][firstPerson ? 1 : 0].end())
+			return;
+		applicator.Collect(ait->second, pending);
 	}
+
+	ApplyPending(pending, immediate);
 }
 
 void OverrideInterface::ApplySkinOverrides(TESObjectREFR * refr, bool firstPerson, TESObjectARMO * armor, TESObjectARMA * addon, UInt32 slotMask, NiAVObject * object, bool immediate)
@@ -1330,78 +1338,54 @@ void OverrideInterface::ApplySkinOverrides(TESObjectREFR * refr, bool firstPerso
 	if (actorBase)
 		gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-	SimpleLocker locker(&skinData.m_lock);
-	auto it = skinData.m_data.find(refr->formID); // Find ActorHandle
-	if (it != skinData.m_data.end())
+	SkinOverrideApplicator applicator(armor, addon, slotMask);
+	VisitGeometry(object, &applicator);
+	if (applicator.m_geometryList.empty())
+		return;
+
+	// Copied so it can be applied after the Reader, see ApplyPending
+	OverrideSet overrides;
 	{
+		auto reader = skinData.Read(refr->formID); // Find ActorHandle
+		auto it = reader.Find();
+		if (!it)
+			return;
 		auto ait = it->second[gender][firstPerson ? 1 : 0].find(slotMask); // Find WeaponHandle
-		if (ait != it->second[gender][firstPerson ? 1 : 0].end())
-		{
-			SkinOverrideApplicator applicator(armor, addon, slotMask, &ait->second, immediate);
-			VisitGeometry(object, &applicator);
-			applicator.Apply();
-		}
-	}
-}
-
-void OverrideSet::Visit(std::function<bool(OverrideVariant*)> functor)
-{
-	for(auto it = begin(); it != end(); ++it) {
-		if(functor(const_cast<OverrideVariant*>(&(*it))))
-			break;
+		if (ait == it->second[gender][firstPerson ? 1 : 0].end())
+			return;
+		overrides = ait->second;
 	}
-}
 
-template<typename T>
-void OverrideRegistration<T>::Visit(std::function<bool(const T & key, OverrideSet * set)> functor)
-{
-	for(auto it = begin(); it != end(); ++it) {
-		if(functor(it->first, &it->second))
-			break;
-	}
+	applicator.Apply(overrides, immediate);
 }
 
 void OverrideInterface::Revert()
 {
-	armorData.Lock();
-	armorData.m_data.clear();
-	armorData.Release();
+	armorData.Clear();
 
-	nodeData.Lock();
-	nodeData.m_data.clear();
-	nodeData.Release();
+	nodeData.Clear();
 
-	weaponData.Lock();
-	weaponData.m_data.clear();
-	weaponData.Release();
+	weaponData.Clear();
 }
 
 void OverrideInterface::RemoveAllOverrides()
 {
-	armorData.Lock();
-	armorData.m_data.clear();
-	armorData.Release();
+	armorData.Clear();
 }
 
 void OverrideInterface::RemoveAllNodeOverrides()
 {
-	nodeData.Lock();
-	nodeData.m_data.clear();
-	nodeData.Release();
+	nodeData.Clear();
 }
 
 void OverrideInterface::RemoveAllWeaponBasedOverrides()
 {
-	weaponData.Lock();
-	weaponData.m_data.clear();
-	weaponData.Release();
+	weaponData.Clear();
 }
 
 void OverrideInterface::RemoveAllSkinBasedOverrides()
 {
-	skinData.Lock();
-	skinData.m_data.clear();
-	skinData.Release();
+	skinData.Clear();
 }
 
 // OverrideVariant
@@ -1571,72 +1555,74 @@ bool OverrideVariant::Load(SKSESerializationInterface * intfc, UInt32 kVersion,
 	return error;
 }
 
-void OverrideInterface::VisitStrings(std::function<void(SKEEFixedString)> functor)
+void OverrideInterface::VisitStrings(StringVisitor & visitor) const
 {
-	for (auto & i1 : armorData.m_data){
+	auto visitValues = [&](const OverrideSet & set) {
+		for (auto & value : set) {
+			if (value.type == OverrideVariant::kType_String) {
+				visitor.Visit(*value.str);
+			}
+		}
+	};
+
+	armorData.ForEach([&](OverrideHandle, const auto & reg) {
 		for (UInt8 gender = 0; gender <= 1; gender++) {
-			for (UInt8 fp = 0; fp <= 1; fp++) {
-				for (auto & i2 : i1.second[gender][fp]) {
-					for (auto & i3 : i2.second) {
-						functor(*i3.first);
-						for (auto & i4 : i3.second){
-							if (i4.type == OverrideVariant::kType_String) {
-								functor(*i4.str);
-							}
-						}
+			for (auto & armor : reg[gender]) {
+				for (auto & addon : armor.second) {
+					for (auto & node : addon.second) {
+						visitor.Visit(*node.first);
+						visitValues(node.second);
 					}
 				}
 			}
 		}
-	}
+	});
 
-	for (auto & i1 : weaponData.m_data) {
+	weaponData.ForEach([&](OverrideHandle, const auto & reg) {
 		for (UInt8 gender = 0; gender <= 1; gender++) {
 			for (UInt8 fp = 0; fp <= 1; fp++) {
-				for (auto & i2 : i1.second[gender][fp]) {
-					for (auto & i3 : i2.second) {
-						functor(*i3.first);
-						for (auto & i4 : i3.second) {
-							if (i4.type == OverrideVariant::kType_String) {
-								functor(*i4.str);
-							}
-						}
+				for (auto & weapon : reg[gender][fp]) {
+					for (auto & node : weapon.second) {
+						visitor.Visit(*node.first);
+						visitValues(node.second);
 					}
 				}
 			}
 		}
-	}
+	});
 
-	for (auto & i1 : nodeData.m_data) {
-		for (UInt8 fp = 0; fp <= 1; fp++) {
-			for (auto & i2 : i1.second[fp]) {
-				functor(*i2.first);
-				for (auto & i3 : i2.second) {
-					if (i3.type == OverrideVariant::kType_String) {
-						functor(*i3.str);
-					}
-				}
+	nodeData.ForEach([&](OverrideHandle, const auto & reg) {
+		for (UInt8 gender = 0; gender <= 1; gender++) {
+			for (auto & node : reg[gender]) {
+				visitor.Visit(*node.first);
+				visitValues(node.second);
 			}
 		}
-	}
+	});
 
-	for (auto & i1 : skinData.m_data) {
+	skinData.ForEach([&](OverrideHandle, const auto & reg) {
 		for (UInt8 gender = 0; gender <= 1; gender++) {
 			for (UInt8 fp = 0; fp <= 1; fp++) {
-				for (auto & i2 : i1.second[gender][fp]) {
-					for (auto & i3 : i2.second) {
-						if (i3.type == OverrideVariant::kType_String) {
-							functor(*i3.str);
-						}
-					}
+				for (auto & slot : reg[gender][fp]) {
+					visitValues(slot.second);
 				}
 			}
 		}
-	}
+	});
+}
+
+OverrideHandle OverrideInterface::GetActorHandle(TESObjectREFR * refr, UInt8 * gender)
+{
+	*gender = 0;
+	TESNPC * actorBase = DYNAMIC_CAST(refr->baseForm, TESForm, TESNPC);
+	if(actorBase)
+		*gender = CALL_MEMBER_FN(actorBase, GetSex)();
+
+	return refr->formID;
 }
 
 // ValueSet
-void OverrideSet::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+void OverrideSet::Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 {
 	intfc->OpenRecord('OVST', kVersion);
 
@@ -1748,7 +1734,7 @@ void WriteKey(SKSESerializationInterface * intfc, const UInt32 key, UInt32 kVers
 }
 
 template<typename T>
-void OverrideRegistration<T>::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+void OverrideRegistration<T>::Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 {
 	UInt32 numNodes = this->size();
 	intfc->WriteRecordData(&numNodes, sizeof(numNodes));
@@ -1828,7 +1814,7 @@ bool OverrideRegistration<T>::Load(SKSESerializationInterface * intfc, UInt32 kV
 
 
 // AddonRegistration
-void AddonRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+void AddonRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 {
 	UInt32 numRegs = this->size();
 	intfc->WriteRecordData(&numRegs, sizeof(numRegs));
@@ -1918,7 +1904,7 @@ bool AddonRegistration::Load(SKSESerializationInterface * intfc, UInt32 kVersion
 }
 
 // ArmorRegistration
-void ArmorRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+void ArmorRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 {
 	UInt32 numRegs = this->size();
 	intfc->WriteRecordData(&numRegs, sizeof(numRegs));
@@ -1997,7 +1983,7 @@ bool ArmorRegistration::Load(SKSESerializationInterface * intfc, UInt32 kVersion
 }
 
 // WeaponRegistration
-void WeaponRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+void WeaponRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 {
 	UInt32 numRegs = this->size();
 	intfc->WriteRecordData(&numRegs, sizeof(numRegs));
@@ -2087,7 +2073,7 @@ bool WeaponRegistration::Load(SKSESerializationInterface * intfc, UInt32 kVersio
 }
 
 // WeaponRegistration
-void SkinRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+void SkinRegistration::Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 {
 	UInt32 numRegs = this->size();
 	intfc->WriteRecordData(&numRegs, sizeof(numRegs));
@@ -2212,46 +2198,54 @@ bool NodeRegistrationMapHolder::Load(SKSESerializationInterface * intfc, UInt32
 
 	*outHandle = newFormId;
 
-	Lock();
-	m_data[newFormId] = reg;
-	Release();
+	Write(newFormId).Get() = reg;
 	return error;
 }
 
-void NodeRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
+void NodeRegistrationMapHolder::SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg)
 {
-	for(auto it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('NDEN', kVersion);
+	intfc->OpenRecord('NDEN', kVersion);
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+	// Key
+	UInt64 handle = formId;
+	intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %08X", __FUNCTION__, handle);
+	_MESSAGE("%s - Saving Handle %08X", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
-	}
+	// Value
+	reg.Save(intfc, kVersion);
 }
 
-void ActorRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
+void NodeRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion) const
 {
-	for(auto it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('ACEN', kVersion);
+	ForEach([&](OverrideHandle formId, const RegistrationType & reg) {
+		SaveEntry(intfc, kVersion, formId, reg);
+	});
+}
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+void ActorRegistrationMapHolder::SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg)
+{
+	intfc->OpenRecord('ACEN', kVersion);
+
+	// Key
+	UInt64 handle = formId;
+	intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
+	_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
-	}
+	// Value
+	reg.Save(intfc, kVersion);
+}
+
+void ActorRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion) const
+{
+	ForEach([&](OverrideHandle formId, const RegistrationType & reg) {
+		SaveEntry(intfc, kVersion, formId, reg);
+	});
 }
 
 bool ActorRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32 kVersion, OverrideHandle * outHandle, const StringIdMap & stringTable)
@@ -2299,9 +2293,7 @@ bool ActorRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32
 
 	*outHandle = newFormId;
 
-	Lock();
-	m_data[newFormId] = reg;
-	Release();
+	Write(newFormId).Get() = reg;
 
 #ifdef _DEBUG
 	_MESSAGE("%s - Loaded %08X", __FUNCTION__, newFormId);
@@ -2312,22 +2304,27 @@ bool ActorRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32
 }
 
 
-void WeaponRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
+void WeaponRegistrationMapHolder::SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg)
 {
-	for(auto it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('WPEN', kVersion);
+	intfc->OpenRecord('WPEN', kVersion);
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+	// Key
+	UInt64 handle = formId;
+	intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %08X", __FUNCTION__, handle);
+	_MESSAGE("%s - Saving Handle %08X", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
-	}
+	// Value
+	reg.Save(intfc, kVersion);
+}
+
+void WeaponRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion) const
+{
+	ForEach([&](OverrideHandle formId, const RegistrationType & reg) {
+		SaveEntry(intfc, kVersion, formId, reg);
+	});
 }
 
 bool WeaponRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32 kVersion, OverrideHandle * outHandle, const StringIdMap & stringTable)
@@ -2375,9 +2372,7 @@ bool WeaponRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32
 
 	*outHandle = newFormId;
 
-	Lock();
-	m_data[newFormId] = reg;
-	Release();
+	Write(newFormId).Get() = reg;
 
 #ifdef _DEBUG
 	_MESSAGE("%s - Loaded %08X", __FUNCTION__, newFormId);
@@ -2388,22 +2383,27 @@ bool WeaponRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32
 }
 
 
-void SkinRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
+void SkinRegistrationMapHolder::SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg)
 {
-	for (auto it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('SKNR', kVersion);
+	intfc->OpenRecord('SKNR', kVersion);
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+	// Key
+	UInt64 handle = formId;
+	intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
+	_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
-	}
+	// Value
+	reg.Save(intfc, kVersion);
+}
+
+void SkinRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion) const
+{
+	ForEach([&](OverrideHandle formId, const RegistrationType & reg) {
+		SaveEntry(intfc, kVersion, formId, reg);
+	});
 }
 
 bool SkinRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32 kVersion, OverrideHandle* outHandle, const StringIdMap & stringTable)
@@ -2451,9 +2451,7 @@ bool SkinRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32 k
 
 	*outHandle = newFormId;
 
-	Lock();
-	m_data[newFormId] = reg;
-	Release();
+	Write(newFormId).Get() = reg;
 
 #ifdef _DEBUG
 	_MESSAGE("%s - Loaded %08X", __FUNCTION__, newFormId);
@@ -2463,13 +2461,109 @@ bool SkinRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32 k
 	return error;
 }
 
+namespace
+{
+	// Appends the records of every actor in holder to writer, encoding only
+	// the actors changed since the last save
+	template <class Holder>
+	UInt32 SaveChanged(const Holder & holder, SKSESerializationInterface * intfc, UInt32 kVersion, UInt64 stamp, BufferedWriter & writer)
+	{
+		return holder.SaveCached(writer, stamp, [&](OverrideHandle formId, const typename Holder::RegistrationType & reg, BufferedWriter & blocks)
+		{
+			BufferedSerializationScope scope(intfc, &blocks, nullptr);
+			Holder::SaveEntry(scope.Get(), kVersion, formId, reg);
+		});
+	}
+}
+
 // ActorRegistration
 void OverrideInterface::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
 {
-	armorData.Save(intfc, kVersion);
-	nodeData.Save(intfc, kVersion);
-	weaponData.Save(intfc, kVersion);
-	skinData.Save(intfc, kVersion);
+	// Every registration record is staged as a block and the lot is written
+	// as one record, instead of one co-save write per field. Saved blocks
+	// hold string ids, which only hold within one string table.
+	const UInt64 stamp = (static_cast<UInt64>(g_stringTable.GetEpoch()) << 32) | kVersion;
+
+	BufferedWriter writer;
+	UInt32 encoded = 0;
+	encoded += SaveChanged(armorData, intfc, kVersion, stamp, writer);
+	encoded += SaveChanged(nodeData, intfc, kVersion, stamp, writer);
+	encoded += SaveChanged(weaponData, intfc, kVersion, stamp, writer);
+	encoded += SaveChanged(skinData, intfc, kVersion, stamp, writer);
+
+#ifdef _DEBUG
+	_MESSAGE("%s - Encoded %d changed registrations", __FUNCTION__, encoded);
+#endif
+
+	if (!writer.Flush(intfc, kBufferedRecordType, kBufferedVersion))
+		_ERROR("%s - Error writing overrides (%d bytes)", __FUNCTION__, writer.Size());
+}
+
+bool OverrideInterface::LoadBuffered(SKSESerializationInterface * intfc, UInt32 kVersion, UInt32 length, const StringIdMap & stringTable)
+{
+	BufferedReader reader;
+	if (kVersion > kBufferedVersion || !reader.Fill(intfc, length))
+	{
+		_ERROR("%s - Error reading overrides (version %d, %d bytes)", __FUNCTION__, kVersion, length);
+		return true;
+	}
+
+	BufferedSerializationScope scope(intfc, nullptr, &reader);
+	SKSESerializationInterface * buffered = scope.Get();
+
+	UInt32 type = 0, version = 0, blockLength = 0;
+	while (reader.GetNextRecordInfo(&type, &version, &blockLength))
+	{
+		switch (type)
+		{
+		case 'ACEN':
+			LoadOverrides(buffered, version, stringTable);
+			break;
+		case 'NDEN':
+			LoadNodeOverrides(buffered, version, stringTable);
+			break;
+		case 'WPEN':
+			LoadWeaponOverrides(buffered, version, stringTable);
+			break;
+		case 'SKNR':
+			LoadSkinOverrides(buffered, version, stringTable);
+			break;
+		default:
+			// Nested or unknown block, the next GetNextRecordInfo steps over it
+			break;
+		}
+	}
+
+	return false;
+}
+
+bool OverrideInterface::LoadRecord(SKSESerializationInterface * intfc, UInt32 type, UInt32 kVersion, UInt32 length, StringIdMap & stringTable)
+{
+	switch (type)
+	{
+	case 'STTB':
+		g_stringTable.Load(intfc, kVersion, length, stringTable);
+		break;
+	case kBufferedRecordType:
+		LoadBuffered(intfc, kVersion, length, stringTable);
+		break;
+	// Saves from before the buffered layout
+	case 'ACEN':
+		LoadOverrides(intfc, kVersion, stringTable);
+		break;
+	case 'NDEN':
+		LoadNodeOverrides(intfc, kVersion, stringTable);
+		break;
+	case 'WPEN':
+		LoadWeaponOverrides(intfc, kVersion, stringTable);
+		break;
+	case 'SKNR':
+		LoadSkinOverrides(intfc, kVersion, stringTable);
+		break;
+	default:
+		return false;
+	}
+	return true;
 }
 
 bool OverrideInterface::LoadWeaponOverrides(SKSESerializationInterface* intfc, UInt32 kVersion, const StringIdMap & stringTable)
@@ -2531,67 +2625,58 @@ bool OverrideInterface::LoadSkinOverrides(SKSESerializationInterface* intfc, UIn
 #ifdef _DEBUG
 void OverrideInterface::DumpMap()
 {
+	auto dumpSet = [](const OverrideSet & set)
+	{
+		for(auto & value : set)
+		{
+			switch(value.type)
+			{
+			case OverrideVariant::kType_String:
+				_MESSAGE("Override: Key %d Value %s", value.key, value.str->c_str());
+				break;
+			case OverrideVariant::kType_Float:
+				_MESSAGE("Override: Key %d Value %f", value.key, value.data.f);
+				break;
+			default:
+				_MESSAGE("Override: Key %d Value %X", value.key, value.data.u);
+				break;
+			}
+		}
+	};
+
 	_MESSAGE("Dumping Overrides");
-	for(ActorRegistrationMapHolder::RegMap::iterator it = armorData.m_data.begin(); it != armorData.m_data.end(); ++it)
+	armorData.ForEach([&](OverrideHandle handle, const auto & reg)
 	{
 		for(UInt8 gender = 0; gender < 2; gender++)
 		{
-			_MESSAGE("Actor Handle: %016llX children %d", it->first, it->second[gender].size());
-			for(ArmorRegistration::iterator ait = it->second[gender].begin(); ait != it->second[gender].end(); ++ait) // Loop Armors
+			_MESSAGE("Actor Handle: %016llX children %d", handle, reg[gender].size());
+			for(auto ait = reg[gender].begin(); ait != reg[gender].end(); ++ait) // Loop Armors
 			{
 				_MESSAGE("Armor Handle: %016llX children %d", ait->first, ait->second.size());
-				for(AddonRegistration::iterator dit = ait->second.begin(); dit != ait->second.end(); ++dit) // Loop Addons
+				for(auto dit = ait->second.begin(); dit != ait->second.end(); ++dit) // Loop Addons
 				{
 					_MESSAGE("Addon Handle: %016llX children %d", dit->first, dit->second.size());
 					for(auto nit = dit->second.begin(); nit != dit->second.end(); ++nit) // Loop Overrides
 					{
 						_MESSAGE("Override Node: %s children %d", nit->first->c_str(), nit->second.size());
-						for(OverrideSet::iterator iter = nit->second.begin(); iter != nit->second.end(); ++iter)
-						{
-							switch((*iter).type)
-							{
-							case OverrideVariant::kType_String:
-								_MESSAGE("Override: Key %d Value %s", (*iter).key, (*iter).str->c_str());
-								break;
-							case OverrideVariant::kType_Float:
-								_MESSAGE("Override: Key %d Value %f", (*iter).key, (*iter).data.f);
-								break;
-							default:
-								_MESSAGE("Override: Key %d Value %X", (*iter).key, (*iter).data.u);
-								break;
-							}
-						}
+						dumpSet(nit->second);
 					}
 				}
 			}
 		}
-	}
-	for(NodeRegistrationMapHolder::RegMap::iterator nit = nodeData.m_data.begin(); nit != nodeData.m_data.end(); ++nit)
+	});
+	nodeData.ForEach([&](OverrideHandle handle, const auto & reg)
 	{
 		for(UInt8 gender = 0; gender < 2; gender++)
 		{
-			_MESSAGE("Node Handle: %016llX children %d", nit->first, nit->second[gender].size());
-			for(auto oit = nit->second[gender].begin(); oit != nit->second[gender].end(); ++oit) // Loop Overrides
+			_MESSAGE("Node Handle: %016llX children %d", handle, reg[gender].size());
+			for(auto oit = reg[gender].begin(); oit != reg[gender].end(); ++oit) // Loop Overrides
 			{
 				_MESSAGE("Override Node: %s children %d", oit->first->c_str(), oit->second.size());
-				for(OverrideSet::iterator iter = oit->second.begin(); iter != oit->second.end(); ++iter)
-				{
-					switch((*iter).type)
-					{
-					case OverrideVariant::kType_String:
-						_MESSAGE("Override: Key %d Value %s", (*iter).key, (*iter).str->c_str());
-						break;
-					case OverrideVariant::kType_Float:
-						_MESSAGE("Override: Key %d Value %f", (*iter).key, (*iter).data.f);
-						break;
-					default:
-						_MESSAGE("Override: Key %d Value %X", (*iter).key, (*iter).data.u);
-						break;
-					}
-				}
+				dumpSet(oit->second);
 			}
 		}
-	}
+	});
 }
 #endif
 
@@ -2599,7 +2684,7 @@ extern bool	g_immediateArmor;
 
 void OverrideInterface::OnAttach(TESObjectREFR * refr, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool isFirstPerson, NiNode * skeleton, NiNode * root)
 {
-	ApplyOverrides(refr, armor, addon, object, g_immediateArmor);
+	ApplyOverrides(refr, isFirstPerson, armor, addon, object, g_immediateArmor);
 
 	UInt32 armorMask = armor->bipedObject.GetSlotMask();
 	UInt32 addonMask = addon->biped.GetSlotMask();
@@ -4,10 +4,13 @@
 #include "IHashType.h"
 
 #include "StringTable.h"
+#include "OverrideApplyPlan.h"
+#include "ShardedRegistrationMap.h"
 
 #include "skse64/GameTypes.h"
 #include "skse64/NiTypes.h"
 
+#include <mutex>
 #include <set>
 #include <vector>
 #include <unordered_map>
@@ -29,10 +32,19 @@ class OverrideSet : public std::set<OverrideVariant>
 {
 public:
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, const StringIdMap & stringTable);
 
-	virtual void Visit(std::function<bool(OverrideVariant*)> functor);
+	// functor(OverrideVariant &) for every value until it returns true.
+	// The set orders values by key and index, which the functor must keep.
+	template <class F>
+	void Visit(F && functor) const
+	{
+		for (auto it = begin(); it != end(); ++it) {
+			if (functor(const_cast<OverrideVariant&>(*it)))
+				break;
+		}
+	}
 };
 
 template<typename T>
@@ -46,17 +58,25 @@ class OverrideRegistration : public std::unordered_map<T, OverrideSet>
 {
 public:
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, const StringIdMap & stringTable);
 
-	virtual void Visit(std::function<bool(const T & key, OverrideSet *)> functor);
+	// functor(const T & key, const OverrideSet &) for every node until it returns true
+	template <class F>
+	void Visit(F && functor) const
+	{
+		for (auto it = this->begin(); it != this->end(); ++it) {
+			if (functor(it->first, it->second))
+				break;
+		}
+	}
 };
 
 class AddonRegistration : public std::unordered_map<OverrideHandle, OverrideRegistration<StringTableItem>>
 {
 public:
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, const StringIdMap & stringTable);
 };
 
@@ -64,7 +84,7 @@ class ArmorRegistration : public std::unordered_map<OverrideHandle, AddonRegistr
 {
 public:
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, const StringIdMap & stringTable);
 };
 
@@ -72,7 +92,7 @@ class WeaponRegistration : public std::unordered_map<OverrideHandle, OverrideReg
 {
 public:
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, const StringIdMap & stringTable);
 };
 
@@ -80,7 +100,7 @@ class SkinRegistration : public std::unordered_map<OverrideHandle, OverrideSet>
 {
 public:
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, const StringIdMap & stringTable);
 };
 
@@ -130,7 +150,7 @@ public:
 		return error;
 	}
 
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion)
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const
 	{
 		UInt8 size = 0;
 		for (UInt8 i = 0; i < N; i++)
@@ -162,7 +182,15 @@ public:
 		return table[index];
 	}
 
-	bool empty()
+	const T& operator[] (const int index) const
+	{
+		if(index > N-1)
+			return table[0];
+
+		return table[index];
+	}
+
+	bool empty() const
 	{
 		UInt8 emptyCount = 0;
 		for(UInt8 i = 0; i < N; i++)
@@ -176,51 +204,55 @@ public:
 	T table[N];
 };
 
-class ActorRegistrationMapHolder : public SafeDataHolder<std::unordered_map<OverrideHandle, MultiRegistration<ArmorRegistration, 2>>>
+class ActorRegistrationMapHolder : public ShardedRegistrationMap<MultiRegistration<ArmorRegistration, 2>>
 {
 public:
-	typedef std::unordered_map<OverrideHandle, MultiRegistration<ArmorRegistration, 2>>	RegMap;
-
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, UInt32 * outFormId, const StringIdMap & stringTable);
 
+	// Record of one actor
+	static void SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg);
+
 	friend class OverrideInterface;
 };
 
-class NodeRegistrationMapHolder : public SafeDataHolder<std::unordered_map<OverrideHandle, MultiRegistration<OverrideRegistration<StringTableItem>, 2>>>
+class NodeRegistrationMapHolder : public ShardedRegistrationMap<MultiRegistration<OverrideRegistration<StringTableItem>, 2>>
 {
 public:
-	typedef std::unordered_map<OverrideHandle, MultiRegistration<OverrideRegistration<StringTableItem>, 2>>	RegMap;
-
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle* outFormId, const StringIdMap & stringTable);
 
+	// Record of one actor
+	static void SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg);
+
 	friend class OverrideInterface;
 };
 
-class WeaponRegistrationMapHolder : public SafeDataHolder<std::unordered_map<OverrideHandle, MultiRegistration<MultiRegistration<WeaponRegistration, 2>, 2>>>
+class WeaponRegistrationMapHolder : public ShardedRegistrationMap<MultiRegistration<MultiRegistration<WeaponRegistration, 2>, 2>>
 {
 public:
-	typedef std::unordered_map<OverrideHandle, MultiRegistration<MultiRegistration<WeaponRegistration, 2>, 2>>	RegMap;
-
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle* outFormId, const StringIdMap & stringTable);
 
+	// Record of one actor
+	static void SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg);
+
 	friend class OverrideInterface;
 };
 
-class SkinRegistrationMapHolder : public SafeDataHolder<std::unordered_map<OverrideHandle, MultiRegistration<MultiRegistration<SkinRegistration, 2>, 2>>>
+class SkinRegistrationMapHolder : public ShardedRegistrationMap<MultiRegistration<MultiRegistration<SkinRegistration, 2>, 2>>
 {
 public:
-	typedef std::unordered_map<OverrideHandle, MultiRegistration<MultiRegistration<SkinRegistration, 2>, 2>>	RegMap;
-
 	// Serialization
-	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
+	void Save(SKSESerializationInterface * intfc, UInt32 kVersion) const;
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle* outFormId, const StringIdMap & stringTable);
 
+	// Record of one actor
+	static void SaveEntry(SKSESerializationInterface * intfc, UInt32 kVersion, OverrideHandle formId, const RegistrationType & reg);
+
 	friend class OverrideInterface;
 };
 
@@ -237,6 +269,12 @@ public:
 		kSerializationVersion3 = 2,
 		kSerializationVersion = kSerializationVersion3
 	};
+	enum
+	{
+		kBufferedRecordType = 'OVBF',
+		kBufferedVersion1 = 1,
+		kBufferedVersion = kBufferedVersion1
+	};
 	virtual UInt32 GetVersion();
 
 	virtual void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
@@ -247,6 +285,16 @@ public:
 	virtual bool LoadNodeOverrides(SKSESerializationInterface* intfc, UInt32 kVersion, const StringIdMap & stringTable);
 	virtual bool LoadWeaponOverrides(SKSESerializationInterface* intfc, UInt32 kVersion, const StringIdMap & stringTable);
 
+	// Loads the single 'OVBF' record written by Save. The record holds the
+	// 'ACEN'/'NDEN'/'WPEN'/'SKNR' records as blocks; unknown blocks are skipped.
+	bool LoadBuffered(SKSESerializationInterface* intfc, UInt32 kVersion, UInt32 length, const StringIdMap & stringTable);
+
+	// Co-save load callback entry: routes one record to its loader. 'STTB'
+	// fills stringTable for the records after it; 'OVBF' and the per-record
+	// layout of older saves both load. Returns false for a record type that
+	// belongs to another interface.
+	bool LoadRecord(SKSESerializationInterface* intfc, UInt32 type, UInt32 kVersion, UInt32 length, StringIdMap & stringTable);
+
 	// Specific overrides
 	virtual void AddRawOverride(OverrideHandle formId, bool isFemale, OverrideHandle armorHandle, OverrideHandle addonHandle, BSFixedString nodeName, OverrideVariant & value);
 	virtual void AddOverride(TESObjectREFR * refr, bool isFemale, TESObjectARMO * armor, TESObjectARMA * addon, BSFixedString nodeName, OverrideVariant & value);
@@ -280,6 +328,7 @@ public:
 
 	// Applies all armor overrides to a particular armor
 	virtual void ApplyOverrides(TESObjectREFR * refr, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool immediate);
+	void ApplyOverrides(TESObjectREFR * refr, bool firstPerson, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool immediate);
 
 	virtual void RemoveAllOverrides();
 	virtual void RemoveAllReferenceOverrides(TESObjectREFR * reference);
@@ -335,19 +384,70 @@ public:
 	virtual void GetSkinProperty(TESObjectREFR * refr, bool firstPerson, UInt32 slotMask, OverrideVariant * value);
 
 
-	virtual void VisitNodes(TESObjectREFR * refr, std::function<void(SKEEFixedString, OverrideVariant&)> functor);
-	virtual void VisitSkin(TESObjectREFR * refr, bool isFemale, bool firstPerson, std::function<void(UInt32, OverrideVariant&)> functor);
-	virtual void VisitStrings(std::function<void(SKEEFixedString)> functor);
+	// functor(const SKEEFixedString & node, const OverrideVariant &) for every
+	// node override of refr, under a shared lock: it must not change overrides
+	template <class F>
+	void VisitNodes(TESObjectREFR * refr, F && functor)
+	{
+		UInt8 gender = 0;
+		auto reader = nodeData.Read(GetActorHandle(refr, &gender));
+		if (auto nit = reader.Find())
+		{
+			for (auto & ovr : nit->second[gender]) // Loop Overrides
+			{
+				for (auto & prop : ovr.second)
+					functor(*ovr.first, prop);
+			}
+		}
+	}
+
+	// functor(UInt32 slotMask, const OverrideVariant &) for every skin override
+	// of refr, under a shared lock: it must not change overrides
+	template <class F>
+	void VisitSkin(TESObjectREFR * refr, bool isFemale, bool firstPerson, F && functor)
+	{
+		UInt8 fp = firstPerson ? 1 : 0;
+		UInt8 gender = 0;
+		auto reader = skinData.Read(GetActorHandle(refr, &gender));
+		if (auto it = reader.Find())
+		{
+			for (auto & ovr : it->second[gender][fp])
+			{
+				for (auto & prop : ovr.second)
+					functor(ovr.first, prop);
+			}
+		}
+	}
+
+	class StringVisitor
+	{
+	public:
+		virtual void Visit(const SKEEFixedString & str) = 0;
+	};
+
+	virtual void VisitStrings(StringVisitor & visitor) const;
 
 #ifdef _DEBUG
 	void DumpMap();
 #endif
 private:
+	// Form id of refr, and its base's sex in gender
+	static OverrideHandle GetActorHandle(TESObjectREFR * refr, UInt8 * gender);
+
 	ActorRegistrationMapHolder armorData;
 	NodeRegistrationMapHolder nodeData;
 	WeaponRegistrationMapHolder weaponData;
 	SkinRegistrationMapHolder skinData;
 
+	// Recorded applications of armorData per attached model, one cache per
+	// armorData shard. Entries are only valid for their shard's generation.
+	struct ArmorPlanShard
+	{
+		std::mutex								m_lock;
+		OverrideApplyPlanCache<const OverrideSet>	m_plans;
+	};
+	ArmorPlanShard armorPlans[ActorRegistrationMapHolder::kShards];
+
 	// Inherited via IAddonAttachmentInterface
 	virtual void OnAttach(TESObjectREFR * refr, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, bool isFirstPerson, NiNode * skeleton, NiNode * root) override;
 };
\ No newline at end of file
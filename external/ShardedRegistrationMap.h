@@ -0,0 +1,246 @@
+#pragma once
+
+#include "skse64_common/skse_types.h"
+#include "BufferedSerialization.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Registrations by actor handle, split over shards that each have a
+// reader-writer lock.
+//
+// The override maps each sat behind one SimpleLock, held across whole
+// SetProperties and ApplyOverrides passes, so 3D loads and script queries on
+// different actors waited on each other. A handle always maps to the same
+// shard. Queries take their shard shared and run concurrently; changes take
+// it exclusively and only stall the actors that hash to it. Operations on
+// every handle, like Clear() or ForEach(), take the shards one at a time.
+//
+// Each shard counts the writers that changed it, so a cache built from a
+// registration can tell that it went stale, and counts the lock acquisitions
+// that had to wait.
+//
+// SaveCached() keeps the blocks each handle was last saved as. A writer that
+// changed its handle drops its blocks, so a save only encodes the
+// registrations that changed since the last one and copies the rest.
+//
+// Unlike the SimpleLock it replaces, a shard lock is not recursive: a thread
+// that holds a Reader and takes the same shard again, shared or exclusive,
+// may deadlock. Hold a Reader only to look up or copy. Code that applies
+// overrides to the scene graph calls into the game and back into SKEE, so it
+// copies out the sets of the nodes it found and applies them after the Reader
+// is gone.
+
+template <class Registration>
+class ShardedRegistrationMap
+{
+	struct alignas(64) Shard
+	{
+		mutable std::shared_mutex				m_lock;
+		std::unordered_map<UInt32, Registration>	m_data;
+		UInt32									m_generation = 0;
+		mutable std::atomic<UInt32>				m_contended{ 0 };
+
+		// Saved blocks by handle. Savers hold the shard shared and m_savedLock,
+		// writers hold it exclusively.
+		mutable std::mutex									m_savedLock;
+		mutable std::unordered_map<UInt32, BufferedWriter>	m_saved;
+		mutable UInt64										m_savedStamp = 0;
+
+		void LockShared() const
+		{
+			if (!m_lock.try_lock_shared())
+			{
+				m_contended.fetch_add(1, std::memory_order_relaxed);
+				m_lock.lock_shared();
+			}
+		}
+
+		void LockExclusive() const
+		{
+			if (!m_lock.try_lock())
+			{
+				m_contended.fetch_add(1, std::memory_order_relaxed);
+				m_lock.lock();
+			}
+		}
+	};
+
+public:
+	enum
+	{
+		kShardBits = 4,
+		kShards = 1 << kShardBits
+	};
+
+	typedef Registration								RegistrationType;
+	typedef std::unordered_map<UInt32, Registration>	RegMap;
+	typedef typename RegMap::value_type					Entry;
+
+	// Form ids of one plugin share their top byte, so mix the low bits up
+	static UInt32 ShardIndex(UInt32 handle)
+	{
+		return (handle * 0x9E3779B1u) >> (32 - kShardBits);
+	}
+
+	// Shared access to one handle's registration, for as long as it lives
+	class Reader
+	{
+	public:
+		Reader(const ShardedRegistrationMap & map, UInt32 handle) : m_shard(map.m_shards[ShardIndex(handle)]), m_handle(handle) { m_shard.LockShared(); }
+		~Reader() { m_shard.m_lock.unlock_shared(); }
+
+		Reader(const Reader &) = delete;
+		Reader & operator=(const Reader &) = delete;
+
+		// The handle's registration, or null
+		const Entry * Find() const
+		{
+			auto it = m_shard.m_data.find(m_handle);
+			return it != m_shard.m_data.end() ? &*it : nullptr;
+		}
+
+		// Writers the shard has had
+		UInt32 Generation() const { return m_shard.m_generation; }
+
+	private:
+		const Shard	& m_shard;
+		UInt32		m_handle;
+	};
+
+	// Exclusive access to one handle's registration. Get() and an Erase()
+	// that removed something count as a change of the shard; a caller that
+	// changes what Find() returned calls Changed(). A writer that only looked
+	// keeps the shard's plans and saved blocks.
+	class Writer
+	{
+	public:
+		Writer(ShardedRegistrationMap & map, UInt32 handle) : m_shard(map.m_shards[ShardIndex(handle)]), m_handle(handle) { m_shard.LockExclusive(); }
+		~Writer()
+		{
+			if (m_changed)
+			{
+				m_shard.m_saved.erase(m_handle);
+				m_shard.m_generation++;
+			}
+			m_shard.m_lock.unlock();
+		}
+
+		Writer(const Writer &) = delete;
+		Writer & operator=(const Writer &) = delete;
+
+		// The handle's registration, or null
+		Entry * Find()
+		{
+			auto it = m_shard.m_data.find(m_handle);
+			return it != m_shard.m_data.end() ? &*it : nullptr;
+		}
+
+		// The handle's registration, added if it has none
+		Registration & Get()
+		{
+			m_changed = true;
+			return m_shard.m_data[m_handle];
+		}
+
+		void Erase()
+		{
+			if (m_shard.m_data.erase(m_handle))
+				m_changed = true;
+		}
+
+		void Changed() { m_changed = true; }
+
+	private:
+		Shard	& m_shard;
+		UInt32	m_handle;
+		bool	m_changed = false;
+	};
+
+	Reader Read(UInt32 handle) const { return Reader(*this, handle); }
+	Writer Write(UInt32 handle) { return Writer(*this, handle); }
+
+	void Clear()
+	{
+		for (Shard & shard : m_shards)
+		{
+			shard.LockExclusive();
+			std::unique_lock<std::shared_mutex> locker(shard.m_lock, std::adopt_lock);
+			shard.m_data.clear();
+			shard.m_saved.clear();
+			shard.m_generation++;
+		}
+	}
+
+	// functor(UInt32 handle, const Registration &) for every handle, holding
+	// one shard shared at a time
+	template <class F>
+	void ForEach(F && functor) const
+	{
+		for (const Shard & shard : m_shards)
+		{
+			shard.LockShared();
+			std::shared_lock<std::shared_mutex> locker(shard.m_lock, std::adopt_lock);
+			for (const Entry & entry : shard.m_data)
+				functor(entry.first, entry.second);
+		}
+	}
+
+	// Appends the saved blocks of every handle to out, in ForEach order.
+	// encode(UInt32 handle, const Registration &, BufferedWriter &) stages the
+	// blocks of a handle written since its last save, the others are copied
+	// from it. Blocks depend on more than the registration, string ids for
+	// one, so a save with a different stamp encodes everything again.
+	// Returns the handles encoded.
+	template <class F>
+	UInt32 SaveCached(BufferedWriter & out, UInt64 stamp, F && encode) const
+	{
+		UInt32 encoded = 0;
+		for (const Shard & shard : m_shards)
+		{
+			shard.LockShared();
+			std::shared_lock<std::shared_mutex> locker(shard.m_lock, std::adopt_lock);
+			std::lock_guard<std::mutex> savedLocker(shard.m_savedLock);
+			if (shard.m_savedStamp != stamp)
+			{
+				shard.m_saved.clear();
+				shard.m_savedStamp = stamp;
+			}
+
+			for (const Entry & entry : shard.m_data)
+			{
+				auto it = shard.m_saved.find(entry.first);
+				if (it == shard.m_saved.end())
+				{
+					it = shard.m_saved.emplace(entry.first, BufferedWriter()).first;
+					encode(entry.first, entry.second, it->second);
+					it->second.Finish();
+					encoded++;
+				}
+				out.WriteBlocks(it->second.Data(), it->second.Size());
+			}
+		}
+		return encoded;
+	}
+
+	size_t Size() const
+	{
+		size_t size = 0;
+		ForEach([&](UInt32, const Registration &) { size++; });
+		return size;
+	}
+
+	// Lock acquisitions that found their shard held
+	UInt64 Contentions() const
+	{
+		UInt64 contentions = 0;
+		for (const Shard & shard : m_shards)
+			contentions += shard.m_contended.load(std::memory_order_relaxed);
+		return contentions;
+	}
+
+private:
+	Shard	m_shards[kShards];
+};
@@ -1,4 +1,5 @@
 #include "StringTable.h"
+#include "BufferedSerialization.h"
 
 #include "skse64/PluginAPI.h"
 
@@ -17,69 +18,103 @@ StringTableItem StringTable::GetString(const SKEEFixedString & str)
 	IScopedCriticalSection locker(&m_lock);
 	auto it = m_table.find(str);
 	if (it != m_table.end()) {
-		return it->second.lock();
+		StringTableItem item = it->second.item.lock();
+		if (!item) {
+			// Released, but its RemoveString has yet to run; keep the id
+			item = std::shared_ptr<SKEEFixedString>(new SKEEFixedString(str), DeleteStringEntry);
+			it->second.item = item;
+			m_tableVector[it->second.id] = item;
+		}
+		return item;
 	}
 	else {
 		StringTableItem item = std::shared_ptr<SKEEFixedString>(new SKEEFixedString(str), DeleteStringEntry);
-		m_table.emplace(str, item);
-		m_tableVector.push_back(item);
+		UInt32 id;
+		if (!m_freeIds.empty()) {
+			id = m_freeIds.back();
+			m_freeIds.pop_back();
+			m_tableVector[id] = item;
+		}
+		else {
+			id = m_tableVector.size();
+			m_tableVector.push_back(item);
+		}
+		m_table.emplace(str, Entry{ item, id });
 		return item;
 	}
-
-	return nullptr;
 }
 
 void StringTable::RemoveString(const SKEEFixedString & str)
 {
 	IScopedCriticalSection locker(&m_lock);
 	auto it = m_table.find(str);
-	if (it != m_table.end())
+	if (it != m_table.end() && it->second.item.expired())
 	{
-		for (auto i = m_tableVector.begin(); i != m_tableVector.end(); ++i)
-		{
-			if (i->lock() == it->second.lock()) {
-				i = m_tableVector.erase(i);
-				break;
-			}
-		}
-
+		// Every other id stays put, so saved records that use them stay valid
+		m_tableVector[it->second.id].reset();
+		m_freeIds.push_back(it->second.id);
 		m_table.erase(it);
 	}
 }
 
 UInt32 StringTable::GetStringID(const StringTableItem & str)
 {
+	if (!str)
+		return -1;
+
 	IScopedCriticalSection locker(&m_lock);
-	UInt32 i = 0;
-	for (auto it = m_tableVector.begin(); it != m_tableVector.end(); ++it, ++i)
-	{
-		auto item = it->lock();
-		if (item == str)
-			return i;
-	}
+	auto it = m_table.find(*str);
+	if (it != m_table.end())
+		return it->second.id;
 
 	return -1;
 }
 
-void StringTable::Save(const SKSESerializationInterface * intfc, UInt32 kVersion)
+UInt32 StringTable::GetEpoch() const
 {
-	intfc->OpenRecord('STTB', kVersion);
-
 	IScopedCriticalSection locker(&m_lock);
-	UInt32 totalStrings = m_tableVector.size();
-	WriteData<UInt32>(intfc, &totalStrings);
+	return m_epoch;
+}
 
-	for (auto & str : m_tableVector)
+void StringTable::Save(const SKSESerializationInterface * intfc, UInt32 kVersion)
+{
+	// Stage the table and write it with a single call
+	BufferedWriter writer;
 	{
-		auto data = str.lock();
-		UInt16 length = 0;
-		if (!data) {
-			WriteData<UInt16>(intfc, &length);
-		}
-		else {
-			WriteData<SKEEFixedString>(intfc, data.get());
+		IScopedCriticalSection locker(&m_lock);
+		BufferedSerializationScope scope(intfc, &writer, nullptr);
+		const SKSESerializationInterface * buffered = scope.Get();
+
+		UInt32 totalStrings = m_tableVector.size();
+		WriteData<UInt32>(buffered, &totalStrings);
+
+		for (auto & str : m_tableVector)
+		{
+			auto data = str.lock();
+			UInt16 length = 0;
+			if (!data) {
+				WriteData<UInt16>(buffered, &length);
+			}
+			else {
+				WriteData<SKEEFixedString>(buffered, data.get());
+			}
 		}
 	}
+
+	writer.Flush(intfc, 'STTB', kVersion);
+}
+
+bool StringTable::Load(const SKSESerializationInterface * intfc, UInt32 kVersion, UInt32 length, StringIdMap & stringTable)
+{
+	BufferedReader reader;
+	if (!reader.Fill(intfc, length))
+	{
+		_ERROR("%s - Error reading string table record (%d bytes)", __FUNCTION__, length);
+		return true;
+	}
+
+	BufferedSerializationScope scope(intfc, nullptr, &reader);
+	return Load(scope.Get(), kVersion, stringTable);
 }
 
 bool StringTable::Load(const SKSESerializationInterface * intfc, UInt32 kVersion, StringIdMap & stringTable)
@@ -163,6 +198,8 @@ void StringTable::Revert()
 	IScopedCriticalSection locker(&m_lock);
 	m_table.clear();
 	m_tableVector.clear();
+	m_freeIds.clear();
+	m_epoch++;
 }
 
 template <typename T>
@@ -113,14 +113,22 @@ public:
 
 	void Save(const SKSESerializationInterface * intfc, UInt32 kVersion);
 	bool Load(const SKSESerializationInterface * intfc, UInt32 kVersion, StringIdMap & stringTable);
+	// Same as Load, but reads the whole 'STTB' record of the given length in one call
+	bool Load(const SKSESerializationInterface * intfc, UInt32 kVersion, UInt32 length, StringIdMap & stringTable);
 	void Revert();
 
 	StringTableItem GetString(const SKEEFixedString & str);
 
+	// Ids are slots in the saved table. A string keeps its id for as long as
+	// anything holds it, a dead string's id goes to the next new one.
 	UInt32 GetStringID(const StringTableItem & str);
 
+	// Called by the last holder of str
 	void RemoveString(const SKEEFixedString & str);
 
+	// Changes whenever Revert() starts handing out ids again
+	UInt32 GetEpoch() const;
+
 	static StringTableItem ReadString(const SKSESerializationInterface * intfc, const StringIdMap & stringTable)
 	{
 		UInt32 stringId;
@@ -147,7 +155,15 @@ public:
 	}
 
 private:
-	std::unordered_map<SKEEFixedString, WeakTableItem>	m_table;
-	std::vector<WeakTableItem>							m_tableVector;
-	mutable ICriticalSection							m_lock;
+	struct Entry
+	{
+		WeakTableItem	item;
+		UInt32			id;
+	};
+
+	std::unordered_map<SKEEFixedString, Entry>	m_table;
+	std::vector<WeakTableItem>					m_tableVector;	// By id
+	std::vector<UInt32>							m_freeIds;
+	UInt32										m_epoch = 0;
+	mutable ICriticalSection					m_lock;
 };
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "ActorIndex.h"
+
+#include <algorithm>
+
+namespace ActorIndex
+{
+    void BaseActorIndex::InsertLocked(ActorHandle handle, FormID baseID)
+    {
+        if (handle == kInvalidHandle || baseID == 0)
+            return;
+
+        auto it = m_baseOf.find(handle);
+        if (it != m_baseOf.end())
+        {
+            if (it->second == baseID)
+                return;  // Already tracked under this base
+            EraseLocked(handle);
+        }
+
+        m_baseOf.emplace(handle, baseID);
+        m_byBase[baseID].push_back(handle);
+    }
+
+    void BaseActorIndex::EraseLocked(ActorHandle handle)
+    {
+        auto it = m_baseOf.find(handle);
+        if (it == m_baseOf.end())
+            return;
+
+        auto bucketIt = m_byBase.find(it->second);
+        if (bucketIt != m_byBase.end())
+        {
+            auto& handles = bucketIt->second;
+            handles.erase(std::remove(handles.begin(), handles.end(), handle), handles.end());
+            if (handles.empty())
+                m_byBase.erase(bucketIt);
+        }
+        m_baseOf.erase(it);
+    }
+
+    void BaseActorIndex::Seed(const IGameQuery& query)
+    {
+        std::vector<ActorRecord> records;
+        query.CollectProcessActors(records);
+
+        // Merge rather than replace: attach events that arrived before the
+        // first lookup are not in the process lists yet
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (const auto& r : records)
+            InsertLocked(r.handle, r.baseID);
+        m_seeded = true;
+    }
+
+    void BaseActorIndex::OnActorAttached(ActorHandle handle, FormID baseID)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        InsertLocked(handle, baseID);
+    }
+
+    void BaseActorIndex::OnActorDetached(ActorHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        EraseLocked(handle);
+    }
+
+    ActorHandle BaseActorIndex::FindLoaded(FormID baseID, const IGameQuery& query)
+    {
+        if (!IsSeeded())
+            Seed(query);
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto bucketIt = m_byBase.find(baseID);
+        if (bucketIt == m_byBase.end())
+            return kInvalidHandle;
+
+        // Copy so stale entries can be erased while iterating
+        const std::vector<ActorHandle> candidates = bucketIt->second;
+        for (ActorHandle handle : candidates)
+        {
+            if (query.GetBaseID(handle) != baseID)
+            {
+                EraseLocked(handle);  // Deleted or reused handle
+                continue;
+            }
+            if (query.Is3DLoaded(handle))
+                return handle;
+        }
+        return kInvalidHandle;
+    }
+
+    void BaseActorIndex::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_byBase.clear();
+        m_baseOf.clear();
+        m_seeded = false;
+    }
+
+    std::size_t BaseActorIndex::Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_baseOf.size();
+    }
+
+    bool BaseActorIndex::IsSeeded() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_seeded;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @namespace ActorIndex
+ * @brief Base-NPC to loaded-actor lookup without scanning the global form map.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Core
+ *
+ * Maintains a mapping from a base `TESNPC` FormID to the reference handles of
+ * actors currently attached to the world that use it. The index is seeded from
+ * the process lists and kept current by cell attach/detach and object load
+ * events, so finding a loaded actor for a template NPC is a hash lookup
+ * instead of a walk over every form in the load order.
+ *
+ * ## :material-database-search-outline: Lookup Cost
+ *
+ * | Approach                       | Cost per lookup               |
+ * |--------------------------------|-------------------------------|
+ * | `TESForm::GetAllForms()` scan  | $O(F)$, $F$ = all loaded forms |
+ * | `BaseActorIndex::FindLoaded`   | $O(k)$, $k$ = actors of base   |
+ *
+ * ## :material-test-tube: Testing
+ *
+ * All game access goes through `IGameQuery`, so the index can be driven by a
+ * synthetic world in unit tests without CommonLibSSE.
+ *
+ * @see AppearanceTemplate::RegisterEventSinks
+ */
+namespace ActorIndex
+{
+    using FormID = std::uint32_t;       ///< Base form identifier (TESNPC)
+    using ActorHandle = std::uint32_t;  ///< Native reference handle value
+
+    constexpr ActorHandle kInvalidHandle = 0;  ///< Null handle, never stored in the index
+
+    /// An actor reference paired with the FormID of its base NPC.
+    struct ActorRecord
+    {
+        ActorHandle handle{kInvalidHandle};  ///< Reference handle of the actor
+        FormID baseID{0};                    ///< FormID of the actor's base NPC
+    };
+
+    /**
+     * Read-only view of the game world used by the index.
+     *
+     * The game implementation resolves handles through the reference handle
+     * manager; tests provide an in-memory world.
+     */
+    class IGameQuery
+    {
+    public:
+        virtual ~IGameQuery() = default;
+
+        /**
+         * Append every non-player actor in the high and middle-high process lists.
+         *
+         * @param[out] out Receives one record per processed actor.
+         */
+        virtual void CollectProcessActors(std::vector<ActorRecord>& out) const = 0;
+
+        /**
+         * Resolve the base NPC of an actor handle.
+         *
+         * @param handle Actor reference handle.
+         * @return FormID of the base NPC, or 0 if the handle is stale.
+         */
+        virtual FormID GetBaseID(ActorHandle handle) const = 0;
+
+        /**
+         * Check whether the actor's 3D is currently loaded.
+         *
+         * @param handle Actor reference handle.
+         * @return `true` if the handle is valid and its 3D is loaded.
+         */
+        virtual bool Is3DLoaded(ActorHandle handle) const = 0;
+    };
+
+    /**
+     * Index from base NPC FormID to attached actor handles.
+     *
+     * Thread-safe; event sinks and lookups may run on different threads.
+     * Entries are validated against `IGameQuery` on lookup, so a missed
+     * detach event only costs one stale check.
+     */
+    class BaseActorIndex
+    {
+    public:
+        /**
+         * Add every actor in the process lists to the index.
+         *
+         * Entries recorded by events are kept; stale ones are dropped on
+         * lookup like any other.
+         *
+         * @param query World to seed from.
+         */
+        void Seed(const IGameQuery& query);
+
+        /**
+         * Record an actor entering the world.
+         *
+         * @param handle Actor reference handle.
+         * @param baseID FormID of the actor's base NPC.
+         */
+        void OnActorAttached(ActorHandle handle, FormID baseID);
+
+        /**
+         * Record an actor leaving the world.
+         *
+         * @param handle Actor reference handle.
+         */
+        void OnActorDetached(ActorHandle handle);
+
+        /**
+         * Find a loaded actor that uses the given base NPC.
+         *
+         * Seeds the index on first use. Stale or re-based handles found
+         * along the way are dropped.
+         *
+         * @param baseID FormID of the base NPC.
+         * @param query World used to validate candidates.
+         * @return Handle of a loaded actor, or `kInvalidHandle` if none.
+         */
+        ActorHandle FindLoaded(FormID baseID, const IGameQuery& query);
+
+        /// Drop all entries and mark the index as unseeded.
+        void Clear();
+
+        /// Number of tracked actor handles.
+        std::size_t Size() const;
+
+        /// Whether `Seed()` has run since the last `Clear()`.
+        bool IsSeeded() const;
+
+    private:
+        void InsertLocked(ActorHandle handle, FormID baseID);
+        void EraseLocked(ActorHandle handle);
+
+        mutable std::mutex m_lock;
+        std::unordered_map<FormID, std::vector<ActorHandle>> m_byBase;
+        std::unordered_map<ActorHandle, FormID> m_baseOf;
+        bool m_seeded = false;
+    };
+}
@@ -1,11 +1,16 @@
 #include "AppearanceTemplate.h"
+#include "ActorIndex.h"
+#include "FaceGenIndex.h"
+#include "OutfitDiff.h"
 #include "Settings.h"
+#include "TemplatePipeline.h"
 
 #include <SKSE/SKSE.h>
 
+#include <chrono>
+#include <filesystem>
 #include <memory>
-#include <sstream>
-#include <iomanip>
+#include <unordered_set>
 #include <vector>
 
 namespace AppearanceTemplate
@@ -15,6 +20,9 @@ namespace AppearanceTemplate
             bool applied = false;
             std::string plugin;
             RE::FormID formID = 0;
+            RE::TESNPC* templateNPC = nullptr;
+            RE::ObjectRefHandle outfitSource;
+            bool outfitSourceSpawned = false;
         };
     }
 
@@ -38,7 +46,130 @@ namespace AppearanceTemplate
     }
 
     // Forward declarations
-    static bool CopyOutfitFromActor(RE::Actor* sourceActor, RE::Actor* player);
+    static OutfitDiff::OutfitCopyResult CopyOutfitFromActor(RE::Actor* sourceActor, RE::Actor* player);
+    static TemplatePipeline::Pipeline& GetPipeline();
+
+    namespace {
+        // Resolves index handles through the game's reference handle manager
+        class GameActorQuery final : public ActorIndex::IGameQuery
+        {
+        public:
+            void CollectProcessActors(std::vector<ActorIndex::ActorRecord>& out) const override
+            {
+                auto* pl = RE::ProcessLists::GetSingleton();
+                if (!pl) return;
+
+                auto collect = [&](const RE::BSTArray<RE::ActorHandle>& handles) {
+                    for (const auto& h : handles) {
+                        auto actor = h.get();
+                        if (!actor || actor->IsPlayerRef()) continue;
+                        auto* base = actor->GetActorBase();
+                        if (!base) continue;
+                        out.push_back({ h.native_handle(), base->GetFormID() });
+                    }
+                };
+                collect(pl->highActorHandles);
+                collect(pl->middleHighActorHandles);
+            }
+
+            ActorIndex::FormID GetBaseID(ActorIndex::ActorHandle handle) const override
+            {
+                auto* actor = Resolve(handle);
+                auto* base = actor ? actor->GetActorBase() : nullptr;
+                return base ? base->GetFormID() : 0;
+            }
+
+            bool Is3DLoaded(ActorIndex::ActorHandle handle) const override
+            {
+                auto* actor = Resolve(handle);
+                return actor && actor->Is3DLoaded();
+            }
+
+            static RE::Actor* Resolve(ActorIndex::ActorHandle handle)
+            {
+                auto ref = RE::TESObjectREFR::LookupByHandle(handle);
+                return ref ? ref->As<RE::Actor>() : nullptr;
+            }
+        };
+
+        // Keeps the actor index in sync and wakes the template pipeline on 3D loads
+        class LoadEventSink final
+            : public RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+            , public RE::BSTEventSink<RE::TESObjectLoadedEvent>
+        {
+        public:
+            static LoadEventSink* GetSingleton()
+            {
+                static LoadEventSink singleton;
+                return std::addressof(singleton);
+            }
+
+            RE::BSEventNotifyControl ProcessEvent(const RE::TESCellAttachDetachEvent* a_event,
+                                                  RE::BSTEventSource<RE::TESCellAttachDetachEvent>*) override
+            {
+                if (a_event && a_event->reference) {
+                    Update(a_event->reference->As<RE::Actor>(), a_event->attached);
+                }
+                return RE::BSEventNotifyControl::kContinue;
+            }
+
+            RE::BSEventNotifyControl ProcessEvent(const RE::TESObjectLoadedEvent* a_event,
+                                                  RE::BSTEventSource<RE::TESObjectLoadedEvent>*) override
+            {
+                if (a_event) {
+                    auto* form = RE::TESForm::LookupByID(a_event->formID);
+                    Update(form ? form->As<RE::Actor>() : nullptr, a_event->loaded);
+                    if (a_event->loaded) {
+                        GetPipeline().OnObjectLoaded(a_event->formID);
+                    }
+                }
+                return RE::BSEventNotifyControl::kContinue;
+            }
+
+        private:
+            static void Update(RE::Actor* actor, bool present);
+        };
+    }
+
+    static ActorIndex::BaseActorIndex& GetActorIndex()
+    {
+        static ActorIndex::BaseActorIndex index;
+        return index;
+    }
+
+    void LoadEventSink::Update(RE::Actor* actor, bool present)
+    {
+        if (!actor || actor->IsPlayerRef()) return;
+
+        const auto handle = actor->GetHandle().native_handle();
+        if (present) {
+            auto* base = actor->GetActorBase();
+            if (base) {
+                GetActorIndex().OnActorAttached(handle, base->GetFormID());
+            }
+        } else {
+            GetActorIndex().OnActorDetached(handle);
+        }
+    }
+
+    void RegisterEventSinks()
+    {
+        auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+        if (!holder) {
+            SKSE::log::warn("AppearanceTemplate: Event source holder not available, actor index will rely on seeding");
+            return;
+        }
+
+        holder->AddEventSink<RE::TESCellAttachDetachEvent>(LoadEventSink::GetSingleton());
+        holder->AddEventSink<RE::TESObjectLoadedEvent>(LoadEventSink::GetSingleton());
+        SKSE::log::info("AppearanceTemplate: Registered load event sinks");
+    }
+
+    void ResetActorIndex()
+    {
+        // Handles from the previous session are meaningless, reseed lazily on next lookup
+        GetActorIndex().Clear();
+    }
 
     /**
      * Find a loaded actor that uses the given NPC as its base.
@@ -48,51 +179,82 @@ namespace AppearanceTemplate
     {
         if (!npc) return nullptr;
 
-        auto player = RE::PlayerCharacter::GetSingleton();
+        const GameActorQuery query;
+        const auto handle = GetActorIndex().FindLoaded(npc->GetFormID(), query);
+        if (handle == ActorIndex::kInvalidHandle) {
+            return nullptr;
+        }
 
-        // Search through all loaded actors
-        const auto& [allForms, lock] = RE::TESForm::GetAllForms();
-        for (auto& [formID, form] : *allForms) {
-            if (!form) continue;
+        SKSE::log::debug("AppearanceTemplate: Found loaded actor for NPC {:08X}", npc->GetFormID());
+        return GameActorQuery::Resolve(handle);
+    }
+
+    std::string BuildFaceGenMeshPath(const std::string& pluginName, RE::FormID formID)
+    {
+        return FaceGenIndex::FormatMeshPath(pluginName, formID);
+    }
+
+    std::string BuildFaceGenTintPath(const std::string& pluginName, RE::FormID formID)
+    {
+        return FaceGenIndex::FormatTintPath(pluginName, formID);
+    }
 
-            auto actor = form->As<RE::Actor>();
-            if (!actor) continue;
+    static FaceGenIndex::Index& GetFaceGenIndex()
+    {
+        static FaceGenIndex::Index index;
+        return index;
+    }
 
-            // Skip the player
-            if (actor == player) continue;
+    void StartFaceGenIndex()
+    {
+        const std::filesystem::path dataRoot = "Data";
+
+        // Only archives the game mounts: its INI lists and those of active plugins
+        std::vector<std::string> activePlugins;
+        if (auto* dataHandler = RE::TESDataHandler::GetSingleton(); dataHandler) {
+            for (auto* file : dataHandler->compiledFileCollection.files) {
+                if (file) activePlugins.emplace_back(file->GetFilename());
+            }
+            for (auto* file : dataHandler->compiledFileCollection.smallFiles) {
+                if (file) activePlugins.emplace_back(file->GetFilename());
+            }
+        }
 
-            // Check if this actor uses our template NPC as its base
-            if (actor->GetActorBase() == npc) {
-                // Verify actor is loaded
-                if (actor->Is3DLoaded()) {
-                    SKSE::log::debug("AppearanceTemplate: Found loaded actor for NPC {:08X}", npc->GetFormID());
-                    return actor;
+        std::vector<std::string> archiveLists;
+        if (auto* ini = RE::INISettingCollection::GetSingleton(); ini) {
+            for (const char* name : {"sResourceArchiveList:Archive", "sResourceArchiveList2:Archive"}) {
+                if (auto* setting = ini->GetSetting(name); setting && setting->GetString()) {
+                    archiveLists.emplace_back(setting->GetString());
                 }
             }
         }
 
-        return nullptr;
-    }
+        std::vector<std::unique_ptr<FaceGenIndex::IAssetSource>> sources;
+        sources.push_back(std::make_unique<FaceGenIndex::LooseFileSource>(dataRoot));
+        for (auto& archive : FaceGenIndex::MountedArchives(dataRoot, activePlugins, archiveLists)) {
+            sources.push_back(std::make_unique<FaceGenIndex::BsaArchiveSource>(std::move(archive)));
+        }
 
-    std::string BuildFaceGenMeshPath(const std::string& pluginName, RE::FormID formID)
-    {
-        // FormID is stored as 8-digit lowercase hex
-        std::ostringstream ss;
-        ss << "meshes\\actors\\character\\facegendata\\facegeom\\"
-           << pluginName << "\\"
-           << std::setfill('0') << std::setw(8) << std::hex << std::uppercase << formID
-           << ".nif";
-        return ss.str();
+        SKSE::log::info("AppearanceTemplate: Building FaceGen index from {} sources in background", sources.size());
+        GetFaceGenIndex().BuildAsync(std::move(sources));
     }
 
-    std::string BuildFaceGenTintPath(const std::string& pluginName, RE::FormID formID)
+    // Probe FaceGen presence, using the index once built and resource streams until then
+    static std::uint8_t ProbeFaceGen(const char* pluginName, RE::FormID faceID)
     {
-        std::ostringstream ss;
-        ss << "textures\\actors\\character\\facegendata\\facetint\\"
-           << pluginName << "\\"
-           << std::setfill('0') << std::setw(8) << std::hex << std::uppercase << formID
-           << ".dds";
-        return ss.str();
+        auto& index = GetFaceGenIndex();
+        if (index.IsReady()) {
+            return index.Find(pluginName, faceID);
+        }
+
+        std::uint8_t flags = FaceGenIndex::kNone;
+        RE::BSResourceNiBinaryStream meshStream(BuildFaceGenMeshPath(pluginName, faceID).c_str());
+        if (meshStream.good()) {
+            flags |= FaceGenIndex::kMesh;
+            RE::BSResourceNiBinaryStream tintStream(BuildFaceGenTintPath(pluginName, faceID).c_str());
+            if (tintStream.good()) flags |= FaceGenIndex::kTint;
+        }
+        return flags;
     }
 
     // Compute the FaceGen file ID for a plugin
@@ -178,12 +340,9 @@ namespace AppearanceTemplate
 
         // Deduplicate while preserving order
         std::vector<const RE::TESFile*> unique;
+        std::unordered_set<const RE::TESFile*> seen;
         for (auto* f : candidates) {
-            bool exists = false;
-            for (auto* u : unique) {
-                if (u == f) { exists = true; break; }
-            }
-            if (!exists) unique.push_back(f);
+            if (seen.insert(f).second) unique.push_back(f);
         }
 
         RE::FormID resolvedFormID = templateNPC->GetFormID();
@@ -191,6 +350,7 @@ namespace AppearanceTemplate
         std::string triedSecondary;
         std::string meshPath, tintPath;
         bool meshFound = false;
+        bool tintExists = false;
 
         for (size_t i = 0; i < unique.size(); ++i) {
             const RE::TESFile* plugin = unique[i];
@@ -199,10 +359,11 @@ namespace AppearanceTemplate
             meshPath = BuildFaceGenMeshPath(plugin->fileName, faceID);
             tintPath = BuildFaceGenTintPath(plugin->fileName, faceID);
 
-            RE::BSResourceNiBinaryStream meshStream(meshPath.c_str());
+            const std::uint8_t presence = ProbeFaceGen(plugin->fileName, faceID);
             if (i == 0) triedPrimary = meshPath; else triedSecondary = meshPath;
 
-            if (meshStream.good()) {
+            if (presence & FaceGenIndex::kMesh) {
+                tintExists = (presence & FaceGenIndex::kTint) != 0;
                 SKSE::log::info("AppearanceTemplate: Found FaceGen mesh: {}", meshPath);
                 SKSE::log::info("AppearanceTemplate: FaceGen lookup - plugin: {}, FormID: {:08X}", plugin->fileName, faceID);
                 meshFound = true;
@@ -221,12 +382,7 @@ namespace AppearanceTemplate
             return false;
         }
 
-        // Check if tint exists, optional but good to know
-        bool tintExists = false;
-        {
-            RE::BSResourceNiBinaryStream tintStream(tintPath.c_str());
-            tintExists = tintStream.good();
-        }
+        // Tint is optional but good to know
         SKSE::log::info("AppearanceTemplate: FaceGen tint exists: {}", tintExists ? "yes" : "no");
 
         // Apply FaceGen by setting faceNPC to the template
@@ -586,32 +742,37 @@ namespace AppearanceTemplate
         SKSE::log::info("AppearanceTemplate: Called RegenerateHead for full FaceGen reload");
     }
 
-    void UpdatePlayerAppearance()
+    // Execute one player refresh step of the template pipeline
+    static void RunRefreshStep(TemplatePipeline::Stage stage)
     {
         auto player = RE::PlayerCharacter::GetSingleton();
         if (!player) return;
 
         auto playerBase = player->GetActorBase();
 
-        // Queue update for next frame
-        SKSE::GetTaskInterface()->AddTask([player, playerBase]() {
-            if (player) {
-                // Update hair color first
+        switch (stage) {
+            case TemplatePipeline::Stage::RefreshColors:
                 player->UpdateHairColor();
-
-                // Update skin color
                 player->UpdateSkinColor();
+                break;
 
+            case TemplatePipeline::Stage::RegenerateHead:
                 // RegenerateHead fully reloads baked FaceGen mesh
                 RegenerateHead(player);
+                break;
 
+            case TemplatePipeline::Stage::Reset3D:
                 // Force 3D model reset to apply remaining appearance changes
                 // This also handles NiNode updates internally
                 player->DoReset3D(true);
+                break;
 
+            case TemplatePipeline::Stage::Update3DModel:
                 // Additional 3D model update for armor/equipment refresh
                 player->Update3DModel();
+                break;
 
+            case TemplatePipeline::Stage::UpdateNeck:
                 // Update neck seam after head changes
                 if (playerBase) {
                     auto faceNode = player->GetFaceNodeSkinned();
@@ -620,59 +781,20 @@ namespace AppearanceTemplate
                         SKSE::log::debug("AppearanceTemplate: Updated neck seam");
                     }
                 }
-
                 SKSE::log::info("AppearanceTemplate: Player appearance update completed");
-            }
-        });
-    }
-
-    static void ProcessSpawnedActor(RE::ObjectRefHandle handle, int framesRemaining)
-    {
-        if (framesRemaining > 0) {
-            SKSE::GetTaskInterface()->AddTask([handle, framesRemaining]() {
-                ProcessSpawnedActor(handle, framesRemaining - 1);
-            });
-            return;
-        }
-
-        auto spawnedRef = handle.get();
-        if (!spawnedRef) {
-            SKSE::log::warn("AppearanceTemplate: Spawned actor no longer valid");
-            return;
-        }
-
-        auto* tempActor = spawnedRef->As<RE::Actor>();
-        auto* player = RE::PlayerCharacter::GetSingleton();
+                break;
 
-        if (tempActor && player && Settings::TemplateCopyOutfit) {
-            SKSE::log::info("AppearanceTemplate: Copying outfit from temporary actor...");
-            CopyOutfitFromActor(tempActor, player);
+            default:
+                break;
         }
-
-        spawnedRef->Disable();
-        SKSE::log::info("AppearanceTemplate: Temporary actor disabled");
     }
 
-    bool ApplyIfConfigured()
+    /**
+     * Copy record data and FaceGen from the configured template to the player.
+     * First stage of the template pipeline, runs once the player is ready.
+     */
+    static bool ApplyTemplateRecords()
     {
-        // Only apply once per session
-        if (GetState().applied) {
-            SKSE::log::debug("AppearanceTemplate: Already applied this session");
-            return true;
-        }
-
-        // Check if feature is enabled
-        if (!Settings::UseTemplateAppearance) {
-            SKSE::log::debug("AppearanceTemplate: Feature disabled in settings");
-            return false;
-        }
-
-        // Check if template is configured
-        if (Settings::TemplateFormID.empty() || Settings::TemplatePlugin.empty()) {
-            SKSE::log::warn("AppearanceTemplate: Enabled but no template configured");
-            return false;
-        }
-
         SKSE::log::info("AppearanceTemplate: Applying template {}|{}",
             Settings::TemplateFormID, Settings::TemplatePlugin);
 
@@ -731,95 +853,274 @@ namespace AppearanceTemplate
             SKSE::log::info("AppearanceTemplate: FaceGen copy disabled in settings");
         }
 
-        // Copy outfit if a loaded actor is available
+        GetState().templateNPC = templateNPC;
+        return true;
+    }
+
+    /**
+     * Find or spawn the actor to copy the outfit from.
+     * A spawned actor is copied once its 3D has loaded, then disabled.
+     */
+    static TemplatePipeline::OutfitSource PrepareOutfitSource(std::uint32_t& spawnRefID)
+    {
+        auto& state = GetState();
+        state.outfitSource = {};
+        state.outfitSourceSpawned = false;
+
         auto player = RE::PlayerCharacter::GetSingleton();
-        RE::Actor* templateActor = FindActorByBase(templateNPC);
+        auto templateNPC = state.templateNPC;
+        if (!Settings::TemplateCopyOutfit || !player || !templateNPC) {
+            return TemplatePipeline::OutfitSource::None;
+        }
 
-        if (templateActor && Settings::TemplateCopyOutfit && player) {
+        if (RE::Actor* templateActor = FindActorByBase(templateNPC)) {
             SKSE::log::info("AppearanceTemplate: Found loaded actor for template NPC, copying outfit");
-            CopyOutfitFromActor(templateActor, player);
-        } else if (Settings::TemplateCopyOutfit && player) {
-            // No actor loaded - spawn a temporary one to copy outfit from
-            SKSE::log::info("AppearanceTemplate: No loaded actor found, spawning temporary actor for outfit...");
+            state.outfitSource = templateActor->GetHandle();
+            return TemplatePipeline::OutfitSource::Ready;
+        }
 
-            auto spawned = player->PlaceObjectAtMe(templateNPC, false);
-            if (spawned) {
-                auto* spawnedActor = spawned->As<RE::Actor>();
-                if (spawnedActor) {
-                    SKSE::log::info("AppearanceTemplate: Spawned temporary actor {:08X}", spawnedActor->GetFormID());
+        // No actor loaded - spawn a temporary one to copy outfit from
+        SKSE::log::info("AppearanceTemplate: No loaded actor found, spawning temporary actor for outfit...");
 
-                    RE::ObjectRefHandle spawnedHandle = spawnedActor->GetHandle();
+        auto spawned = player->PlaceObjectAtMe(templateNPC, false);
+        if (!spawned) {
+            SKSE::log::warn("AppearanceTemplate: Failed to spawn temporary actor");
+            return TemplatePipeline::OutfitSource::None;
+        }
 
-                    // Wait 5 frames for actor to fully load, then copy outfit
-                    ProcessSpawnedActor(spawnedHandle, 5);
-                } else {
-                    SKSE::log::warn("AppearanceTemplate: Spawned reference is not an actor");
-                    spawned->Disable();
-                    spawned->SetDelete(true);
+        auto* spawnedActor = spawned->As<RE::Actor>();
+        if (!spawnedActor) {
+            SKSE::log::warn("AppearanceTemplate: Spawned reference is not an actor");
+            spawned->Disable();
+            spawned->SetDelete(true);
+            return TemplatePipeline::OutfitSource::None;
+        }
+
+        SKSE::log::info("AppearanceTemplate: Spawned temporary actor {:08X}", spawnedActor->GetFormID());
+        state.outfitSource = spawnedActor->GetHandle();
+        state.outfitSourceSpawned = true;
+        spawnRefID = spawnedActor->GetFormID();
+        return TemplatePipeline::OutfitSource::Spawned;
+    }
+
+    // Remove a temporary outfit source actor from the world
+    static void ReleaseSpawnedSource(RE::TESObjectREFR* sourceRef)
+    {
+        sourceRef->Disable();
+        sourceRef->SetDelete(true);
+        SKSE::log::info("AppearanceTemplate: Temporary actor released");
+    }
+
+    static void CopyOutfitFromSource()
+    {
+        auto& state = GetState();
+        auto sourceRef = state.outfitSource.get();
+        state.outfitSource = {};
+
+        if (!sourceRef) {
+            SKSE::log::warn("AppearanceTemplate: Outfit source actor no longer valid");
+            return;
+        }
+
+        auto* sourceActor = sourceRef->As<RE::Actor>();
+        auto* player = RE::PlayerCharacter::GetSingleton();
+        if (sourceActor && player) {
+            SKSE::log::info("AppearanceTemplate: Copying outfit from template actor...");
+            CopyOutfitFromActor(sourceActor, player);
+        }
+
+        if (state.outfitSourceSpawned) {
+            ReleaseSpawnedSource(sourceRef.get());
+            state.outfitSourceSpawned = false;
+        }
+    }
+
+    // The spawned source never loaded its 3D, give up on the outfit
+    static void ReleaseOutfitSource()
+    {
+        auto& state = GetState();
+        SKSE::log::warn("AppearanceTemplate: Outfit source did not load in time, template application aborted");
+        if (auto sourceRef = state.outfitSource.get(); sourceRef && state.outfitSourceSpawned) {
+            ReleaseSpawnedSource(sourceRef.get());
+        }
+        state.outfitSource = {};
+        state.outfitSourceSpawned = false;
+    }
+
+    namespace {
+        // Binds the template pipeline to the game
+        class GamePipelineHost final : public TemplatePipeline::IHost
+        {
+        public:
+            bool IsPlayerReady() const override
+            {
+                auto player = RE::PlayerCharacter::GetSingleton();
+                return player && player->GetActorBase() && player->Is3DLoaded();
+            }
+
+            bool ApplyRecords() override
+            {
+                if (ApplyTemplateRecords()) {
+                    return true;
                 }
-            } else {
-                SKSE::log::warn("AppearanceTemplate: Failed to spawn temporary actor");
+                // Allow a later ApplyIfConfigured to retry
+                GetState().applied = false;
+                return false;
+            }
+
+            TemplatePipeline::OutfitSource PrepareOutfit(std::uint32_t& spawnRefID) override
+            {
+                return PrepareOutfitSource(spawnRefID);
+            }
+
+            bool IsOutfitSourceReady(std::uint32_t) const override
+            {
+                auto ref = GetState().outfitSource.get();
+                return !ref || ref->Is3DLoaded();
+            }
+
+            void CopyOutfit() override { CopyOutfitFromSource(); }
+
+            void ReleaseOutfit() override { ReleaseOutfitSource(); }
+
+            const void* Player3DRoot() const override
+            {
+                auto player = RE::PlayerCharacter::GetSingleton();
+                return player ? player->Get3D() : nullptr;
+            }
+
+            void RunRefresh(TemplatePipeline::Stage stage) override { RunRefreshStep(stage); }
+
+            void ScheduleTick() override
+            {
+                SKSE::GetTaskInterface()->AddTask([]() { GetPipeline().Tick(); });
+            }
+
+            double NowMs() const override
+            {
+                using namespace std::chrono;
+                return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
             }
+        };
+    }
+
+    static TemplatePipeline::Pipeline& GetPipeline()
+    {
+        static GamePipelineHost host;
+        static TemplatePipeline::Pipeline pipeline(host);
+        return pipeline;
+    }
+
+    void PollTemplatePipeline()
+    {
+        GetPipeline().Poll();
+    }
+
+    void UpdatePlayerAppearance()
+    {
+        // A full run already ends with the refresh steps
+        if (GetPipeline().IsBusy()) return;
+        GetPipeline().StartRefresh();
+    }
+
+    bool ApplyIfConfigured()
+    {
+        // Only apply once per session
+        if (GetState().applied) {
+            SKSE::log::debug("AppearanceTemplate: Already applied this session");
+            return true;
+        }
+
+        // Check if feature is enabled
+        if (!Settings::UseTemplateAppearance) {
+            SKSE::log::debug("AppearanceTemplate: Feature disabled in settings");
+            return false;
         }
 
-        // Update the player's 3D
-        UpdatePlayerAppearance();
+        // Check if template is configured
+        if (Settings::TemplateFormID.empty() || Settings::TemplatePlugin.empty()) {
+            SKSE::log::warn("AppearanceTemplate: Enabled but no template configured");
+            return false;
+        }
 
+        // Stages run on the game thread as the player and outfit source become ready
         GetState().applied = true;
-        SKSE::log::info("AppearanceTemplate: Successfully applied template appearance");
+        GetPipeline().Start();
+        SKSE::log::info("AppearanceTemplate: Template pipeline started");
 
         return true;
     }
 
+    /**
+     * Snapshot an actor's armor into a diff-ready list.
+     * The parallel forms vector maps each entry back to its armor record.
+     */
+    static void SnapshotArmor(RE::Actor* actor, bool wornOnly,
+                              std::vector<OutfitDiff::InventoryEntry>& entries,
+                              std::vector<RE::TESObjectARMO*>& forms)
+    {
+        auto inv = actor->GetInventory();
+        entries.reserve(inv.size());
+        forms.reserve(inv.size());
+
+        for (const auto& [form, data] : inv) {
+            if (!form) continue;
+
+            auto armor = form->As<RE::TESObjectARMO>();
+            if (!armor) continue;
+
+            const bool worn = data.second && data.second->IsWorn();
+            if (wornOnly && !worn) continue;
+
+            entries.push_back({ armor->GetFormID(), static_cast<std::uint32_t>(armor->GetSlotMask()), worn });
+            forms.push_back(armor);
+        }
+    }
+
     /**
      * Copy equipped outfit from source actor to player.
      * Copies all equipped armor items (not weapons).
      */
-    static bool CopyOutfitFromActor(RE::Actor* sourceActor, RE::Actor* player)
+    static OutfitDiff::OutfitCopyResult CopyOutfitFromActor(RE::Actor* sourceActor, RE::Actor* player)
     {
+        OutfitDiff::OutfitCopyResult result;
         if (!sourceActor || !player) {
-            return false;
+            return result;
         }
 
-        auto sourceInv = sourceActor->GetInventory();
-        int copiedCount = 0;
-
         SKSE::log::info("whois: Copying outfit from source actor...");
 
-        // Iterate through source's inventory to find equipped armor
-        for (const auto& [form, data] : sourceInv) {
-            if (!form || data.second->IsWorn() == false) continue;
+        // Snapshot both inventories once, then diff them in a single pass
+        std::vector<OutfitDiff::InventoryEntry> sourceEntries, playerEntries;
+        std::vector<RE::TESObjectARMO*> sourceForms, playerForms;
+        SnapshotArmor(sourceActor, true, sourceEntries, sourceForms);
+        SnapshotArmor(player, false, playerEntries, playerForms);
 
-            auto armor = form->As<RE::TESObjectARMO>();
-            if (!armor) continue;
+        const auto plan = OutfitDiff::ComputePlan(sourceEntries, playerEntries);
 
-            // Check if player already has this item
-            auto playerInv = player->GetInventory();
-            bool hasItem = false;
-            for (const auto& [pForm, pData] : playerInv) {
-                if (pForm != form) continue;
-                hasItem = true;
-                if (!pData.second->IsWorn()) {
-                    RE::ActorEquipManager::GetSingleton()->EquipObject(player, armor);
-                }
-                break;
-            }
+        // Apply as one batch: all additions first, then queued equips without sounds
+        for (std::size_t idx : plan.add) {
+            player->AddObjectToContainer(sourceForms[idx], nullptr, 1, nullptr);
+            SKSE::log::debug("whois: Added {}", sourceForms[idx]->GetName());
+        }
+        result.added = static_cast<int>(plan.add.size());
 
-            if (!hasItem) {
-                // Add the item to player's inventory and equip it
-                player->AddObjectToContainer(armor, nullptr, 1, nullptr);
-                RE::ActorEquipManager::GetSingleton()->EquipObject(player, armor);
-                copiedCount++;
-                SKSE::log::debug("whois: Added and equipped {}", armor->GetName());
+        auto* equipManager = RE::ActorEquipManager::GetSingleton();
+        if (equipManager) {
+            for (std::size_t idx : plan.equip) {
+                equipManager->EquipObject(player, sourceForms[idx], nullptr, 1, nullptr, true, false, false, false);
             }
+            result.equipped = static_cast<int>(plan.equip.size());
         }
+        result.skipped = static_cast<int>(plan.skipped.size());
 
-        if (copiedCount > 0) {
-            SKSE::log::info("whois: Copied {} armor items from source", copiedCount);
-        } else {
-            SKSE::log::info("whois: No new armor items to copy (player already has them or source has none)");
+        for (std::size_t idx : plan.displaced) {
+            SKSE::log::debug("whois: {} replaced by copied outfit", playerForms[idx]->GetName());
         }
 
-        return copiedCount > 0;
+        SKSE::log::info("whois: Outfit copy finished - {} added, {} equipped, {} skipped",
+            result.added, result.equipped, result.skipped);
+
+        return result;
     }
 }
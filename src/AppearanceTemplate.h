@@ -67,7 +67,8 @@
  * @note For followers with custom races (Inigo, etc.), you MUST enable
  *       TemplateIncludeRace, otherwise the head parts won't work!
  *
- * Applied on game load when the player is initialized.
+ * Applied on game load once the player's 3D is loaded, driven by load events
+ * rather than per-frame polling (see TemplatePipeline).
  */
 namespace AppearanceTemplate
 {
@@ -95,6 +96,18 @@ namespace AppearanceTemplate
      */
     std::string BuildFaceGenTintPath(const std::string& pluginName, RE::FormID formID);
 
+    /**
+     * @brief Start building the FaceGen asset index in the background.
+     *
+     * Enumerates loose FaceGen files and every archive in the Data folder so
+     * ApplyFaceGen can resolve candidates with a hash lookup. Until the build
+     * finishes, ApplyFaceGen falls back to probing resource streams.
+     * Call once after data is loaded.
+     *
+     * @see FaceGenIndex::Index
+     */
+    void StartFaceGenIndex();
+
     /**
      * @brief Apply FaceGen data from template NPC to player.
      *
@@ -112,12 +125,15 @@ namespace AppearanceTemplate
      * @brief Apply template appearance to player if configured in settings.
      *
      * Checks if UseTemplateAppearance is enabled and a valid template is specified.
-     * If so, resolves the FormID and applies the appearance.
+     * If so, starts the template pipeline, which applies the appearance on the
+     * game thread once the player is ready.
      *
      * Safe to call multiple times; will only apply once per game session unless
      * ResetAppliedFlag() is called or settings are reloaded.
      *
-     * @return true if appearance was applied successfully, false otherwise
+     * @return true if application was started or already done, false otherwise
+     *
+     * @see TemplatePipeline::Pipeline
      */
     bool ApplyIfConfigured();
 
@@ -161,11 +177,23 @@ namespace AppearanceTemplate
     /**
      * @brief Force player appearance update after changes.
      *
-     * Marks the player's face as dirty and queues NiNode update.
+     * Runs the refresh stages of the template pipeline (colors, head
+     * regeneration, 3D reset, neck seam) spread across frames.
      * Call after modifying appearance data.
      */
     void UpdatePlayerAppearance();
 
+    /**
+     * @brief Re-check a bounded wait of the template pipeline.
+     *
+     * Call once per game frame on the game thread. Only does work while the
+     * pipeline waits for a spawned outfit source or the player's 3D reload,
+     * and fails it once the wait budget is spent.
+     *
+     * @see TemplatePipeline::Pipeline::Poll
+     */
+    void PollTemplatePipeline();
+
     /**
      * @brief Check if a template NPC is compatible with the player's race.
      *
@@ -192,4 +220,24 @@ namespace AppearanceTemplate
      */
     void TestOverlayOnPlayer();
 
+    /**
+     * @brief Register cell attach/detach and object load event sinks.
+     *
+     * Keeps the base-NPC to loaded-actor index current so template lookups
+     * avoid scanning every form, and wakes the template pipeline when the
+     * player or a spawned outfit source finishes loading its 3D.
+     * Call once after data is loaded.
+     *
+     * @see ActorIndex::BaseActorIndex, TemplatePipeline::Pipeline
+     */
+    void RegisterEventSinks();
+
+    /**
+     * @brief Drop the actor index so it reseeds on the next lookup.
+     *
+     * Call when a save is loaded or a new game starts, since reference
+     * handles from the previous session are no longer valid.
+     */
+    void ResetActorIndex();
+
 }
@@ -1,4 +1,5 @@
 #include "DebugOverlay.h"
+#include "FrameAllocations.h"
 #include "Settings.h"
 
 #include <imgui.h>
@@ -138,10 +139,28 @@ namespace DebugOverlay
 
             ImGui::Spacing();
 
+            // ImGui heap traffic of the overlay frame; steady frames should not allocate
+            const auto& meter = FrameAllocations::OverlayMeter();
+            ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.4f, 1.0f), "Allocations");
+            ImGui::Text("Last frame: %llu", static_cast<unsigned long long>(meter.LastFrame()));
+            if (meter.Warm())
+            {
+                ImGui::Text("Allocating: %u of %u frames", meter.AllocatingFrames(), meter.SteadyFrames());
+            }
+            else
+            {
+                // Grayed out while caches and buffers grow to their working size
+                ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Allocating: Warming up");
+            }
+
+            ImGui::Spacing();
+
             // Tracks how often actor data is refreshed
             ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.4f, 1.0f), "Updates");
             ImGui::Text("Updates/sec: %d", stats.updatesPerSecond);  // Data refreshes per second
             ImGui::Text("Cooldown:    %d", ctx.postLoadCooldown);    // Frames until full processing resumes
+            ImGui::Text("Source:      %s", ctx.updateSource);        // Main loop hook or SKSE task
+            ImGui::Text("Lag:         %.1f ms (+/- %.1f)", ctx.updateLagMs, ctx.updateJitterMs);
 
             ImGui::Spacing();
 
@@ -153,6 +172,7 @@ namespace DebugOverlay
             ImGui::Text("HidePlayer:%s", Settings::HidePlayer ? "On" : "Off");
             ImGui::Text("V.Offset:  %.1f", Settings::VerticalOffset);  // Nameplate height offset
             ImGui::Text("Tiers:     %zu", Settings::Tiers.size());     // Color tier definitions
+            ImGui::Text("Watch INI: %s", Settings::WatchSettingsFile ? "On" : "Off");  // Reload on save
             if (Settings::ReloadKey > 0)
             {
                 // Show virtual key code for hot reload (e.g., 0x74 = F5)
@@ -29,6 +29,7 @@
  * | Frame Timing | FPS, frame time, rolling average                     |
  * | Actors       | Total tracked, visible, occluded, player visible     |
  * | Cache        | Entry count, memory estimate                         |
+ * | Allocations  | ImGui allocations last frame, steady frames that did |
  * | Updates      | Actor data updates per second                        |
  * | State        | Post-load cooldown, last reload time, frame number   |
  *
@@ -93,6 +94,9 @@ namespace DebugOverlay
         float lastReloadTime = -10.0f;    ///< Time of last settings reload
         size_t actorCacheEntrySize = 0;   ///< sizeof(ActorCache) for memory estimate
         size_t actorDrawDataSize = 0;     ///< sizeof(ActorDrawData) for memory estimate
+        const char* updateSource = "";    ///< Where the actor scan runs, see SnapshotSchedule
+        float updateLagMs = 0.0f;         ///< Mean scan to draw delay
+        float updateJitterMs = 0.0f;      ///< Standard deviation of that delay
     };
 
     /**
@@ -0,0 +1,92 @@
+#include "EffectDecimation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EffectDecimation
+{
+    float LabelPhase(std::uint32_t labelKey)
+    {
+        // Integer hash (lowbias32), top 24 bits mapped to [0, 1)
+        std::uint32_t h = labelKey;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+    }
+
+    std::int64_t Bucket(double time, float rateHz, float phase)
+    {
+        return static_cast<std::int64_t>(std::floor(time * rateHz + phase));
+    }
+
+    std::uint64_t MakeKey(std::uint32_t labelKey, std::uint32_t slot, EffectClass cls)
+    {
+        return (static_cast<std::uint64_t>(labelKey) << 32) |
+               (static_cast<std::uint64_t>(slot & 0xFFFFFFu) << 8) |
+               static_cast<std::uint64_t>(cls);
+    }
+
+    bool Shape::Matches(const Shape& rhs) const
+    {
+        return count == rhs.count &&
+               std::abs(width - rhs.width) <= 0.5f &&
+               std::abs(height - rhs.height) <= 0.5f;
+    }
+
+    std::uint32_t RescaleAlpha(std::uint32_t color, std::uint8_t from, std::uint8_t to)
+    {
+        if (from == to || from == 0)
+            return color;
+        const std::uint32_t a = color >> 24;
+        const std::uint32_t scaled = std::min<std::uint32_t>((a * to + from / 2) / from, 255u);
+        return (color & 0x00FFFFFFu) | (scaled << 24);
+    }
+
+    const std::uint32_t* ColorCache::Find(std::uint64_t key, std::int64_t bucket, const Shape& shape, std::uint8_t& alpha)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end() || it->second.bucket != bucket || !it->second.shape.Matches(shape))
+            return nullptr;
+        if (it->second.alpha == 0 && alpha != 0)
+            return nullptr;
+
+        it->second.used = true;
+        alpha = it->second.alpha;
+        ++m_stats.reused;
+        return it->second.colors.data();
+    }
+
+    std::uint32_t* ColorCache::Store(std::uint64_t key, std::int64_t bucket, const Shape& shape, std::uint8_t alpha)
+    {
+        Entry& e = m_entries[key];
+        e.bucket = bucket;
+        e.shape = shape;
+        e.alpha = alpha;
+        e.used = true;
+        e.colors.resize(shape.count);
+        ++m_stats.evaluated;
+        return e.colors.data();
+    }
+
+    void ColorCache::EndFrame()
+    {
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (!it->second.used)
+            {
+                it = m_entries.erase(it);
+                continue;
+            }
+            it->second.used = false;
+            ++it;
+        }
+    }
+
+    void ColorCache::Clear()
+    {
+        m_entries.clear();
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @namespace EffectDecimation
+ * @brief Capped-rate evaluation of animated text color fields.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * Rainbow hues, aurora/plasma waves, shimmer bands and sparkle hashes are
+ * re-evaluated for every vertex of every label. At 144-240 Hz most of these
+ * signals move by less than one color step between frames. With decimation
+ * each effect class is evaluated at a capped rate per label and the colors of
+ * the last evaluation are reused in between. Text geometry is still rebuilt
+ * every frame; only the color pass is skipped.
+ *
+ * ## :material-timer-outline: Buckets
+ *
+ * Time is divided into buckets of `1 / rate` seconds. A label's colors are
+ * evaluated once per bucket and held until the next one:
+ *
+ * $$b = \lfloor t \cdot r + \phi_{label} \rfloor$$
+ *
+ * The phase $\phi_{label}$ is derived from the label key, so labels cross
+ * bucket boundaries on different frames instead of all re-evaluating on the
+ * same one.
+ *
+ * | Class     | Effects                                        |
+ * |-----------|------------------------------------------------|
+ * | `Rainbow` | Rainbow wave, conic rainbow                    |
+ * | `Shimmer` | Shimmer variants, pulse, scanline              |
+ * | `Noise`   | Aurora, plasma                                 |
+ * | `Sparkle` | Sparkle                                        |
+ *
+ * ## :material-check-decagram: Validity
+ *
+ * Cached colors are reused only if the bucket and the text's shape (vertex
+ * count and size) are unchanged, so a label that changes text, font or scale
+ * is re-evaluated immediately. For a color channel changing at most $R$ per
+ * second the error against full-rate evaluation is at most $R / r$.
+ *
+ * Label alpha (distance fade, appear/disappear) changes every frame while a
+ * label fades. Cached colors remember the alpha they were evaluated with and
+ * are rescaled to the current one, so fades stay smooth at full rate.
+ *
+ * @see TextEffects, Settings::EffectRateRainbow
+ */
+namespace EffectDecimation
+{
+    /// Effect classes with their own evaluation rate, see the table above.
+    enum class EffectClass : std::uint8_t
+    {
+        Rainbow,
+        Shimmer,
+        Noise,
+        Sparkle,
+        Count
+    };
+
+    /// Stagger phase in [0, 1) for a label.
+    float LabelPhase(std::uint32_t labelKey);
+
+    /// Bucket index of `time` at `rateHz` (must be > 0).
+    std::int64_t Bucket(double time, float rateHz, float phase);
+
+    /// Cache key for the `slot`-th effect call of a label.
+    std::uint64_t MakeKey(std::uint32_t labelKey, std::uint32_t slot, EffectClass cls);
+
+    /// What the cached colors were evaluated for.
+    struct Shape
+    {
+        std::uint32_t count{0};  ///< Vertices colored
+        float width{0.0f};       ///< Text bounds in pixels
+        float height{0.0f};
+
+        /// Same vertex count and size within half a pixel.
+        bool Matches(const Shape& rhs) const;
+    };
+
+    /// Scale the alpha byte of an `IM_COL32` color by `to / from`.
+    std::uint32_t RescaleAlpha(std::uint32_t color, std::uint8_t from, std::uint8_t to);
+
+    /// Counters for the debug overlay.
+    struct Stats
+    {
+        std::uint64_t reused{0};     ///< Color passes skipped
+        std::uint64_t evaluated{0};  ///< Color passes run
+    };
+
+    /**
+     * Per-vertex colors of the last evaluation of each effect call.
+     *
+     * Not synchronized; used only by the thread building labels. Entries keep
+     * their buffers, so a steady scene does not allocate.
+     */
+    class ColorCache
+    {
+    public:
+        /**
+         * Colors for `key` if they were evaluated in `bucket` for `shape`.
+         *
+         * @param alpha In: current label alpha. Out: alpha the colors were
+         *              evaluated with. Colors evaluated fully transparent are
+         *              not reused for a visible label.
+         * @return Cached colors, or null if the effect must be evaluated.
+         */
+        const std::uint32_t* Find(std::uint64_t key, std::int64_t bucket, const Shape& shape, std::uint8_t& alpha);
+
+        /// Buffer of `shape.count` colors to fill for `key` in `bucket` at label `alpha`.
+        std::uint32_t* Store(std::uint64_t key, std::int64_t bucket, const Shape& shape, std::uint8_t alpha);
+
+        /// Drop entries not used since the previous call.
+        void EndFrame();
+
+        void Clear();
+        std::size_t Size() const { return m_entries.size(); }
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        struct Entry
+        {
+            std::int64_t bucket{0};
+            Shape shape;
+            std::uint8_t alpha{0};
+            bool used{false};
+            std::vector<std::uint32_t> colors;
+        };
+
+        std::unordered_map<std::uint64_t, Entry> m_entries;
+        Stats m_stats;
+    };
+}
@@ -0,0 +1,790 @@
+#include "EffectProgram.h"
+#include "NoiseTables.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace EffectProgram
+{
+    namespace
+    {
+        // Scalar slots holding the inputs, in Uniforms order
+        enum Input : std::uint16_t
+        {
+            kTime = 0,
+            kPhase,
+            kTier,
+            kParam1,
+            kLeft = kParam1 + 5,
+            kRight = kLeft + 3,
+            kHighlight = kRight + 3,
+            kInputCount = kHighlight + 3
+        };
+
+        // Registers preloaded with the vertex positions
+        constexpr std::uint16_t kRegU = 0;
+        constexpr std::uint16_t kRegV = 1;
+
+        constexpr float kPi = 3.14159265359f;
+
+        inline float Fract(float x) { return x - std::floor(x); }
+        inline float Sat(float x) { return x > 0.0f ? (x < 1.0f ? x : 1.0f) : 0.0f; }  // NaN -> 0
+
+        // One channel of HSV to RGB, k = 1, 2/3, 1/3 for red, green, blue
+        inline float Hsv(float h, float s, float v, float k)
+        {
+            const float p = Sat(std::abs(Fract(h + k) * 6.0f - 3.0f) - 1.0f);
+            return v * (1.0f + (p - 1.0f) * s);
+        }
+
+        inline float SmoothStep(float e0, float e1, float x)
+        {
+            const float t = Sat((x - e0) / (e1 - e0));
+            return t * t * (3.0f - 2.0f * t);
+        }
+
+        // Shared by constant folding and the prologue; noise is analytic here
+        // and sampled from NoiseTables in the body loops
+        inline float Eval(Op op, float a, float b, float c)
+        {
+            switch (op)
+            {
+            case Op::Splat:      return a;
+            case Op::Neg:        return -a;
+            case Op::Sin:        return std::sin(a);
+            case Op::Cos:        return std::cos(a);
+            case Op::Abs:        return std::abs(a);
+            case Op::Floor:      return std::floor(a);
+            case Op::Fract:      return Fract(a);
+            case Op::Sqrt:       return std::sqrt(a);
+            case Op::Saturate:   return Sat(a);
+            case Op::Add:        return a + b;
+            case Op::Sub:        return a - b;
+            case Op::Mul:        return a * b;
+            case Op::Div:        return a / b;
+            case Op::Min:        return a < b ? a : b;
+            case Op::Max:        return a > b ? a : b;
+            case Op::Pow:        return std::pow(a, b);
+            case Op::Step:       return b < a ? 0.0f : 1.0f;
+            case Op::Noise:      return NoiseTables::ValueNoise(a, b);
+            case Op::Fbm:        return NoiseTables::Fbm(a, b);
+            case Op::Clamp:      return a < b ? b : (a > c ? c : a);
+            case Op::Mix:        return a + (b - a) * c;
+            case Op::SmoothStep: return SmoothStep(a, b, c);
+            case Op::HsvR:       return Hsv(a, b, c, 1.0f);
+            case Op::HsvG:       return Hsv(a, b, c, 2.0f / 3.0f);
+            case Op::HsvB:       return Hsv(a, b, c, 1.0f / 3.0f);
+            }
+            return 0.0f;
+        }
+
+        // ====================================================================
+        // Compiler
+        // ====================================================================
+
+        struct Operand
+        {
+            enum Kind : std::uint8_t
+            {
+                Const,
+                Uniform,
+                Varying
+            };
+
+            Kind kind{Const};
+            bool temp{false};  // varying register owned by this operand
+            std::uint16_t index{0};
+            float k{0.0f};
+
+            static Operand Constant(float k) { return {Const, false, 0, k}; }
+            static Operand Scalar(std::uint16_t slot) { return {Uniform, false, slot, 0.0f}; }
+            static Operand Register(std::uint16_t reg, bool temp) { return {Varying, temp, reg, 0.0f}; }
+        };
+
+        // A scalar (width 1) or a color (width 3)
+        struct Value
+        {
+            int width{1};
+            Operand ch[3];
+
+            const Operand& Channel(int c) const { return ch[width == 1 ? 0 : c]; }
+        };
+
+        struct CompileError
+        {
+            std::size_t column;
+            std::string message;
+        };
+
+        class Compiler
+        {
+        public:
+            Compiler(std::string_view source, Program& program)
+                : m_src(source), m_prog(program)
+            {
+                m_prog.scalars.assign(kInputCount, 0.0f);
+                m_splatReg.assign(kMaxScalars, 0xFFFF);
+                m_refs.assign(kMaxRegisters, 0);
+                m_nextReg = 2;  // u, v
+            }
+
+            void Run()
+            {
+                // Bindings "name = expr;" come first, then the result
+                while (ParseBinding())
+                    ;
+                Value result = ParseExpr();
+                SkipSpace();
+                if (m_pos < m_src.size())
+                    Fail("unexpected '" + std::string(1, m_src[m_pos]) + "'");
+
+                // A scalar picks a color along the tier gradient
+                if (result.width == 1)
+                {
+                    Value t = Apply(Op::Saturate, {result});
+                    result = Apply(Op::Mix, {Color(kLeft), Color(kRight), t});
+                }
+
+                for (int c = 0; c < 3; ++c)
+                    m_prog.output[c] = ToRegister(result.ch[c]);
+                m_prog.registers = m_nextReg;
+            }
+
+        private:
+            // ---- Code generation ---------------------------------------
+
+            static Value Color(std::uint16_t slot)
+            {
+                Value v;
+                v.width = 3;
+                for (int c = 0; c < 3; ++c)
+                    v.ch[c] = Operand::Scalar(static_cast<std::uint16_t>(slot + c));
+                return v;
+            }
+
+            std::uint16_t NewScalar(float init)
+            {
+                if (m_prog.scalars.size() >= kMaxScalars)
+                    Fail("expression has too many constants");
+                m_prog.scalars.push_back(init);
+                return static_cast<std::uint16_t>(m_prog.scalars.size() - 1);
+            }
+
+            std::uint16_t ConstSlot(float k)
+            {
+                for (const auto& [value, slot] : m_consts)
+                {
+                    if (std::memcmp(&value, &k, sizeof(float)) == 0)
+                        return slot;
+                }
+                const std::uint16_t slot = NewScalar(k);
+                m_consts.emplace_back(k, slot);
+                return slot;
+            }
+
+            std::uint16_t ToScalar(const Operand& o)
+            {
+                return o.kind == Operand::Const ? ConstSlot(o.k) : o.index;
+            }
+
+            std::uint16_t FreshRegister()
+            {
+                if (m_nextReg >= kMaxRegisters)
+                    Fail("expression needs more than " + std::to_string(kMaxRegisters) + " registers");
+                return m_nextReg++;
+            }
+
+            std::uint16_t AllocRegister()
+            {
+                std::uint16_t r;
+                if (!m_free.empty())
+                {
+                    r = m_free.back();
+                    m_free.pop_back();
+                }
+                else
+                {
+                    r = FreshRegister();
+                }
+                m_refs[r] = 1;
+                return r;
+            }
+
+            // Varying operands read registers. Uniforms read by the body are
+            // broadcast once per call into their own bank past the temporaries.
+            std::uint16_t ToRegister(const Operand& o)
+            {
+                if (o.kind == Operand::Varying)
+                    return o.index;
+
+                const std::uint16_t slot = ToScalar(o);
+                if (m_splatReg[slot] == 0xFFFF)
+                {
+                    if (m_prog.splats.size() >= kMaxUniformRegisters)
+                        Fail("expression uses more than " + std::to_string(kMaxUniformRegisters) + " distinct uniforms");
+                    const auto r = static_cast<std::uint16_t>(kMaxRegisters + m_prog.splats.size());
+                    m_prog.splats.push_back({Op::Splat, r, slot, 0, 0});
+                    m_splatReg[slot] = r;
+                }
+                return m_splatReg[slot];
+            }
+
+            Operand EmitChannel(Op op, const Operand* args, int n)
+            {
+                bool allConst = true;
+                bool anyVarying = false;
+                for (int i = 0; i < n; ++i)
+                {
+                    allConst = allConst && args[i].kind == Operand::Const;
+                    anyVarying = anyVarying || args[i].kind == Operand::Varying;
+                }
+
+                if (allConst)
+                {
+                    return Operand::Constant(Eval(op, args[0].k, n > 1 ? args[1].k : 0.0f,
+                                                  n > 2 ? args[2].k : 0.0f));
+                }
+
+                // x * 1, x / 1, x + 0 and x - 0 are x
+                if (n == 2)
+                {
+                    const bool unitOp = op == Op::Mul || op == Op::Div;
+                    const bool zeroOp = op == Op::Add || op == Op::Sub;
+                    const Operand& rhs = args[1];
+                    if (rhs.kind == Operand::Const && ((unitOp && rhs.k == 1.0f) || (zeroOp && rhs.k == 0.0f)))
+                        return Shared(args[0]);
+                    const Operand& lhs = args[0];
+                    if (lhs.kind == Operand::Const && ((op == Op::Mul && lhs.k == 1.0f) || (op == Op::Add && lhs.k == 0.0f)))
+                        return Shared(args[1]);
+                }
+
+                Instr in{op, 0, 0, 0, 0};
+                std::uint16_t* src[3] = {&in.a, &in.b, &in.c};
+                if (!anyVarying)
+                {
+                    for (int i = 0; i < n; ++i)
+                        *src[i] = ToScalar(args[i]);
+                    in.dst = NewScalar(0.0f);
+                    m_prog.prologue.push_back(in);
+                    return Operand::Scalar(in.dst);
+                }
+
+                for (int i = 0; i < n; ++i)
+                    *src[i] = ToRegister(args[i]);
+                in.dst = AllocRegister();
+                m_prog.body.push_back(in);
+                return Operand::Register(in.dst, true);
+            }
+
+            // An operand forwarded unchanged shares the source's register
+            Operand Shared(const Operand& o)
+            {
+                if (o.kind == Operand::Varying && o.temp)
+                    ++m_refs[o.index];
+                return o;
+            }
+
+            void Release(const Value& v)
+            {
+                for (int c = 0; c < v.width; ++c)
+                {
+                    const Operand& o = v.ch[c];
+                    if (o.kind == Operand::Varying && o.temp && --m_refs[o.index] == 0)
+                        m_free.push_back(o.index);
+                }
+            }
+
+            // Per-channel op with scalar broadcast
+            Value Apply(Op op, std::initializer_list<Value> args)
+            {
+                Value out;
+                out.width = 1;
+                for (const Value& a : args)
+                    out.width = std::max(out.width, a.width);
+
+                const int n = static_cast<int>(args.size());
+                for (int c = 0; c < out.width; ++c)
+                {
+                    Operand ops[3];
+                    int i = 0;
+                    for (const Value& a : args)
+                        ops[i++] = a.Channel(c);
+                    out.ch[c] = EmitChannel(op, ops, n);
+                }
+
+                // Registers are freed only after every channel has been written
+                for (const Value& a : args)
+                    Release(a);
+                return out;
+            }
+
+            // ---- Parsing ------------------------------------------------
+
+            [[noreturn]] void Fail(const std::string& message) const
+            {
+                throw CompileError{m_pos + 1, message};
+            }
+
+            void SkipSpace()
+            {
+                while (m_pos < m_src.size() && std::isspace(static_cast<unsigned char>(m_src[m_pos])))
+                    ++m_pos;
+            }
+
+            bool Accept(char c)
+            {
+                SkipSpace();
+                if (m_pos < m_src.size() && m_src[m_pos] == c)
+                {
+                    ++m_pos;
+                    return true;
+                }
+                return false;
+            }
+
+            void Expect(char c)
+            {
+                if (!Accept(c))
+                    Fail(std::string("expected '") + c + "'");
+            }
+
+            bool ParseBinding()
+            {
+                SkipSpace();
+                const std::size_t start = m_pos;
+                while (m_pos < m_src.size() &&
+                       (std::isalnum(static_cast<unsigned char>(m_src[m_pos])) || m_src[m_pos] == '_'))
+                    ++m_pos;
+                const std::string name(m_src.substr(start, m_pos - start));
+                if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])) || !Accept('='))
+                {
+                    m_pos = start;
+                    return false;
+                }
+                if (IsInput(name))
+                {
+                    m_pos = start;
+                    Fail("'" + name + "' is a built-in name");
+                }
+
+                Value v = ParseExpr();
+                Expect(';');
+
+                // Held until the end, every use shares its registers
+                for (auto& [local, value] : m_locals)
+                {
+                    if (local == name)
+                    {
+                        Release(value);
+                        value = v;
+                        return true;
+                    }
+                }
+                m_locals.emplace_back(name, v);
+                return true;
+            }
+
+            static bool IsInput(std::string_view name)
+            {
+                static constexpr const char* kNames[] = {"u", "v", "t", "phase", "tier", "p1", "p2", "p3",
+                                                         "p4", "p5", "left", "right", "highlight", "pi"};
+                for (const char* n : kNames)
+                {
+                    if (name == n)
+                        return true;
+                }
+                return false;
+            }
+
+            Value ParseExpr()
+            {
+                Value lhs = ParseTerm();
+                for (;;)
+                {
+                    if (Accept('+'))
+                        lhs = Apply(Op::Add, {lhs, ParseTerm()});
+                    else if (Accept('-'))
+                        lhs = Apply(Op::Sub, {lhs, ParseTerm()});
+                    else
+                        return lhs;
+                }
+            }
+
+            Value ParseTerm()
+            {
+                Value lhs = ParseUnary();
+                for (;;)
+                {
+                    if (Accept('*'))
+                        lhs = Apply(Op::Mul, {lhs, ParseUnary()});
+                    else if (Accept('/'))
+                        lhs = Apply(Op::Div, {lhs, ParseUnary()});
+                    else
+                        return lhs;
+                }
+            }
+
+            Value ParseUnary()
+            {
+                if (Accept('-'))
+                    return Apply(Op::Neg, {ParseUnary()});
+                if (Accept('+'))
+                    return ParseUnary();
+                return ParsePrimary();
+            }
+
+            Value ParsePrimary()
+            {
+                SkipSpace();
+                if (m_pos >= m_src.size())
+                    Fail("unexpected end of expression");
+
+                if (Accept('('))
+                {
+                    Value v = ParseExpr();
+                    Expect(')');
+                    return v;
+                }
+
+                const char c = m_src[m_pos];
+                if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+                    return ParseNumber();
+                if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+                    return ParseName();
+                Fail("unexpected '" + std::string(1, c) + "'");
+            }
+
+            Value ParseNumber()
+            {
+                const std::size_t start = m_pos;
+                while (m_pos < m_src.size() &&
+                       (std::isdigit(static_cast<unsigned char>(m_src[m_pos])) || m_src[m_pos] == '.'))
+                    ++m_pos;
+                if (m_pos < m_src.size() && (m_src[m_pos] == 'e' || m_src[m_pos] == 'E'))
+                {
+                    ++m_pos;
+                    if (m_pos < m_src.size() && (m_src[m_pos] == '+' || m_src[m_pos] == '-'))
+                        ++m_pos;
+                    while (m_pos < m_src.size() && std::isdigit(static_cast<unsigned char>(m_src[m_pos])))
+                        ++m_pos;
+                }
+
+                const std::string text(m_src.substr(start, m_pos - start));
+                char* end = nullptr;
+                const float k = std::strtof(text.c_str(), &end);
+                if (end != text.c_str() + text.size())
+                {
+                    m_pos = start;
+                    Fail("malformed number '" + text + "'");
+                }
+
+                Value v;
+                v.ch[0] = Operand::Constant(k);
+                return v;
+            }
+
+            Value ParseName()
+            {
+                const std::size_t start = m_pos;
+                while (m_pos < m_src.size() &&
+                       (std::isalnum(static_cast<unsigned char>(m_src[m_pos])) || m_src[m_pos] == '_'))
+                    ++m_pos;
+                const std::string_view name = m_src.substr(start, m_pos - start);
+
+                SkipSpace();
+                if (m_pos < m_src.size() && m_src[m_pos] == '(')
+                {
+                    ++m_pos;
+                    return ParseCall(name, start);
+                }
+
+                for (const auto& [local, value] : m_locals)
+                {
+                    if (local == name)
+                    {
+                        Value v = value;
+                        for (int c = 0; c < v.width; ++c)
+                            Shared(v.ch[c]);
+                        return v;
+                    }
+                }
+
+                Value v;
+                if (name == "u")
+                    v.ch[0] = Operand::Register(kRegU, false);
+                else if (name == "v")
+                    v.ch[0] = Operand::Register(kRegV, false);
+                else if (name == "t")
+                    v.ch[0] = Operand::Scalar(kTime);
+                else if (name == "phase")
+                    v.ch[0] = Operand::Scalar(kPhase);
+                else if (name == "tier")
+                    v.ch[0] = Operand::Scalar(kTier);
+                else if (name.size() == 2 && name[0] == 'p' && name[1] >= '1' && name[1] <= '5')
+                    v.ch[0] = Operand::Scalar(static_cast<std::uint16_t>(kParam1 + (name[1] - '1')));
+                else if (name == "left")
+                    v = Color(kLeft);
+                else if (name == "right")
+                    v = Color(kRight);
+                else if (name == "highlight")
+                    v = Color(kHighlight);
+                else if (name == "pi")
+                    v.ch[0] = Operand::Constant(kPi);
+                else
+                {
+                    m_pos = start;
+                    Fail("unknown name '" + std::string(name) + "'");
+                }
+                return v;
+            }
+
+            Value ParseCall(std::string_view name, std::size_t start)
+            {
+                std::vector<Value> args;
+                if (!Accept(')'))
+                {
+                    do
+                    {
+                        args.push_back(ParseExpr());
+                    } while (Accept(','));
+                    Expect(')');
+                }
+
+                auto arity = [&](std::size_t n) {
+                    if (args.size() != n)
+                    {
+                        m_pos = start;
+                        Fail(std::string(name) + " takes " + std::to_string(n) + " argument" + (n == 1 ? "" : "s"));
+                    }
+                };
+                auto scalars = [&]() {
+                    for (const Value& a : args)
+                    {
+                        if (a.width != 1)
+                        {
+                            m_pos = start;
+                            Fail(std::string(name) + " takes scalar arguments");
+                        }
+                    }
+                };
+
+                struct Function
+                {
+                    const char* name;
+                    Op op;
+                };
+                static constexpr Function kUnary[] = {{"sin", Op::Sin}, {"cos", Op::Cos}, {"abs", Op::Abs},
+                                                      {"floor", Op::Floor}, {"fract", Op::Fract}, {"sqrt", Op::Sqrt}};
+                static constexpr Function kBinary[] = {{"min", Op::Min}, {"max", Op::Max}, {"pow", Op::Pow},
+                                                       {"step", Op::Step}, {"noise", Op::Noise}, {"fbm", Op::Fbm}};
+
+                for (const auto& f : kUnary)
+                {
+                    if (name == f.name)
+                    {
+                        arity(1);
+                        return Apply(f.op, {args[0]});
+                    }
+                }
+                for (const auto& f : kBinary)
+                {
+                    if (name == f.name)
+                    {
+                        arity(2);
+                        return Apply(f.op, {args[0], args[1]});
+                    }
+                }
+
+                if (name == "clamp")
+                {
+                    if (args.size() == 1)
+                        return Apply(Op::Saturate, {args[0]});
+                    arity(3);
+                    return Apply(Op::Clamp, {args[0], args[1], args[2]});
+                }
+                if (name == "mix")
+                {
+                    arity(3);
+                    return Apply(Op::Mix, {args[0], args[1], args[2]});
+                }
+                if (name == "smoothstep")
+                {
+                    arity(3);
+                    return Apply(Op::SmoothStep, {args[0], args[1], args[2]});
+                }
+                if (name == "hsv")
+                {
+                    arity(3);
+                    scalars();
+                    Value out;
+                    out.width = 3;
+                    const Operand ops[3] = {args[0].ch[0], args[1].ch[0], args[2].ch[0]};
+                    out.ch[0] = EmitChannel(Op::HsvR, ops, 3);
+                    out.ch[1] = EmitChannel(Op::HsvG, ops, 3);
+                    out.ch[2] = EmitChannel(Op::HsvB, ops, 3);
+                    for (const Value& a : args)
+                        Release(a);
+                    return out;
+                }
+                if (name == "rgb")
+                {
+                    arity(3);
+                    scalars();
+                    Value out;
+                    out.width = 3;
+                    for (int c = 0; c < 3; ++c)
+                        out.ch[c] = args[c].ch[0];  // takes over the argument registers
+                    return out;
+                }
+
+                m_pos = start;
+                Fail("unknown function '" + std::string(name) + "'");
+            }
+
+            std::string_view m_src;
+            std::size_t m_pos{0};
+            Program& m_prog;
+            std::vector<std::pair<std::string, Value>> m_locals;    // bindings in scope
+            std::vector<std::pair<float, std::uint16_t>> m_consts;  // folded constants and their slots
+            std::vector<std::uint16_t> m_splatReg;  // per scalar slot, 0xFFFF = not broadcast
+            std::vector<std::uint16_t> m_free;      // recycled temporaries
+            std::vector<std::uint8_t> m_refs;       // values holding each temporary
+            std::uint16_t m_nextReg{0};
+        };
+
+        // ====================================================================
+        // Batch evaluation
+        // ====================================================================
+
+        using Lanes = float[kBatch];
+
+        template <class F>
+        inline void Map1(float* d, const float* a, std::size_t n, F f)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = f(a[i]);
+        }
+
+        template <class F>
+        inline void Map2(float* d, const float* a, const float* b, std::size_t n, F f)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = f(a[i], b[i]);
+        }
+
+        template <class F>
+        inline void Map3(float* d, const float* a, const float* b, const float* c, std::size_t n, F f)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                d[i] = f(a[i], b[i], c[i]);
+        }
+
+        void Execute(const Instr& in, Lanes* r, std::size_t n)
+        {
+            float* d = r[in.dst];
+            const float* a = r[in.a];
+            const float* b = r[in.b];
+            const float* c = r[in.c];
+            const auto& noise = NoiseTables::Active();
+
+            // One loop per op so each can be vectorized on its own
+            switch (in.op)
+            {
+            case Op::Splat:      break;
+            case Op::Neg:        Map1(d, a, n, [](float x) { return -x; }); break;
+            case Op::Sin:        Map1(d, a, n, [](float x) { return std::sin(x); }); break;
+            case Op::Cos:        Map1(d, a, n, [](float x) { return std::cos(x); }); break;
+            case Op::Abs:        Map1(d, a, n, [](float x) { return std::abs(x); }); break;
+            case Op::Floor:      Map1(d, a, n, [](float x) { return std::floor(x); }); break;
+            case Op::Fract:      Map1(d, a, n, [](float x) { return Fract(x); }); break;
+            case Op::Sqrt:       Map1(d, a, n, [](float x) { return std::sqrt(x); }); break;
+            case Op::Saturate:   Map1(d, a, n, [](float x) { return Sat(x); }); break;
+            case Op::Add:        Map2(d, a, b, n, [](float x, float y) { return x + y; }); break;
+            case Op::Sub:        Map2(d, a, b, n, [](float x, float y) { return x - y; }); break;
+            case Op::Mul:        Map2(d, a, b, n, [](float x, float y) { return x * y; }); break;
+            case Op::Div:        Map2(d, a, b, n, [](float x, float y) { return x / y; }); break;
+            case Op::Min:        Map2(d, a, b, n, [](float x, float y) { return x < y ? x : y; }); break;
+            case Op::Max:        Map2(d, a, b, n, [](float x, float y) { return x > y ? x : y; }); break;
+            case Op::Pow:        Map2(d, a, b, n, [](float x, float y) { return std::pow(x, y); }); break;
+            case Op::Step:       Map2(d, a, b, n, [](float e, float x) { return x < e ? 0.0f : 1.0f; }); break;
+            case Op::Noise:      Map2(d, a, b, n, [&noise](float x, float y) { return noise.Noise(x, y); }); break;
+            case Op::Fbm:        Map2(d, a, b, n, [&noise](float x, float y) { return noise.Fbm(x, y); }); break;
+            case Op::Clamp:      Map3(d, a, b, c, n, [](float x, float lo, float hi) { return x < lo ? lo : (x > hi ? hi : x); }); break;
+            case Op::Mix:        Map3(d, a, b, c, n, [](float x, float y, float t) { return x + (y - x) * t; }); break;
+            case Op::SmoothStep: Map3(d, a, b, c, n, [](float e0, float e1, float x) { return SmoothStep(e0, e1, x); }); break;
+            case Op::HsvR:       Map3(d, a, b, c, n, [](float h, float s, float v) { return Hsv(h, s, v, 1.0f); }); break;
+            case Op::HsvG:       Map3(d, a, b, c, n, [](float h, float s, float v) { return Hsv(h, s, v, 2.0f / 3.0f); }); break;
+            case Op::HsvB:       Map3(d, a, b, c, n, [](float h, float s, float v) { return Hsv(h, s, v, 1.0f / 3.0f); }); break;
+            }
+        }
+
+        inline std::uint32_t Channel8(float x)
+        {
+            return static_cast<std::uint32_t>(Sat(x) * 255.0f + 0.5f);
+        }
+    }
+
+    bool Compile(std::string_view source, Program& out, std::string* error)
+    {
+        out = Program{};
+        try
+        {
+            Compiler(source, out).Run();
+            return true;
+        }
+        catch (const CompileError& e)
+        {
+            if (error)
+                *error = "column " + std::to_string(e.column) + ": " + e.message;
+            out = Program{};
+            return false;
+        }
+    }
+
+    void Run(const Program& program, const Uniforms& uniforms, const float* u, const float* v,
+             std::size_t count, std::uint32_t* colors, std::uint8_t alpha)
+    {
+        if (!program.Valid() || count == 0)
+            return;
+
+        float s[kMaxScalars];
+        std::copy(program.scalars.begin(), program.scalars.end(), s);
+        s[kTime] = uniforms.time;
+        s[kPhase] = uniforms.phase;
+        s[kTier] = uniforms.tier;
+        std::copy(uniforms.params, uniforms.params + 5, s + kParam1);
+        std::copy(uniforms.left, uniforms.left + 3, s + kLeft);
+        std::copy(uniforms.right, uniforms.right + 3, s + kRight);
+        std::copy(uniforms.highlight, uniforms.highlight + 3, s + kHighlight);
+
+        for (const Instr& in : program.prologue)
+            s[in.dst] = Eval(in.op, s[in.a], s[in.b], s[in.c]);
+
+        alignas(32) Lanes r[kMaxRegisters + kMaxUniformRegisters];
+        for (const Instr& in : program.splats)
+            std::fill(r[in.dst], r[in.dst] + kBatch, s[in.a]);
+
+        const float* red = r[program.output[0]];
+        const float* green = r[program.output[1]];
+        const float* blue = r[program.output[2]];
+        const std::uint32_t a = static_cast<std::uint32_t>(alpha) << 24;
+
+        for (std::size_t base = 0; base < count; base += kBatch)
+        {
+            const std::size_t n = std::min(kBatch, count - base);
+            std::copy(u + base, u + base + n, r[kRegU]);
+            std::copy(v + base, v + base + n, r[kRegV]);
+
+            for (const Instr& in : program.body)
+                Execute(in, r, n);
+
+            std::uint32_t* out = colors + base;
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = Channel8(red[i]) | (Channel8(green[i]) << 8) | (Channel8(blue[i]) << 16) | a;
+        }
+    }
+}
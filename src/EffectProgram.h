@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace EffectProgram
+ * @brief INI-defined color effects compiled to batched register bytecode.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * Built-in effects are hand-written kernels with up to five positional
+ * parameters. A custom effect is a single expression in the `[CustomEffects]`
+ * section of `whois.ini`, compiled once at `Settings::Load` and run over whole
+ * vertex batches, so a new look needs no C++ kernel or outline twin.
+ *
+ * ```ini
+ * [CustomEffects]
+ * Embers = mix(left, highlight, clamp(noise(u * 6 - t * p1, v * 3) * 1.4 - 0.3))
+ *
+ * [Tier12]
+ * NameEffect = Embers 2.0
+ * ```
+ *
+ * ## :material-function-variant: Language
+ *
+ * | Name                          | Meaning                                        |
+ * |-------------------------------|------------------------------------------------|
+ * | `u`, `v`                      | Vertex position in the text box, [0, 1]        |
+ * | `t`                           | Animation time in seconds                      |
+ * | `phase`                       | Per-label shimmer phase, [0, 1)                |
+ * | `tier`                        | Tier position, 0 = lowest, 1 = highest         |
+ * | `p1` .. `p5`                  | Parameters after the effect name in the tier   |
+ * | `left`, `right`, `highlight`  | Tier colors                                    |
+ * | `pi`                          | 3.14159...                                     |
+ *
+ * Operators are `+ - * /` and unary minus. Functions are `sin`, `cos`, `abs`,
+ * `floor`, `fract`, `sqrt`, `min`, `max`, `pow`, `step`, `noise(x, y)`,
+ * `fbm(x, y)`, `clamp(x)` / `clamp(x, lo, hi)`, `mix(a, b, t)`,
+ * `smoothstep(e0, e1, x)`, `hsv(h, s, v)` and `rgb(r, g, b)`. Values are
+ * scalars or colors; colors combine per channel and scalars broadcast.
+ * Bindings `name = expr;` before the result are computed once and shared by
+ * every use. A scalar result is used as the gradient position between `left`
+ * and `right`.
+ *
+ * `noise` is value noise and `fbm` four octaves of it, both in [0, 1). Per
+ * vertex they are sampled from NoiseTables, so they tile every
+ * `NoiseTables::kPeriod` units.
+ *
+ * ## :material-memory: Bytecode
+ *
+ * The parser emits three-address code while it descends, so there is no tree
+ * to walk at run time. Every operand is a constant, a uniform (same for the
+ * whole label) or varying (per vertex):
+ *
+ * | Operands               | Result                                            |
+ * |------------------------|---------------------------------------------------|
+ * | all constant           | folded at compile time                            |
+ * | constant or uniform    | prologue op, evaluated once per call              |
+ * | any varying            | body op, evaluated over a batch of `kBatch` lanes |
+ *
+ * Body ops run as tight loops over structure-of-arrays registers, so the
+ * dispatch cost is one switch per instruction per batch rather than per
+ * vertex, and the compiler is free to vectorize each loop. Temporaries are
+ * recycled once their last reader has been emitted; uniforms the body reads
+ * are broadcast once per call into a separate bank.
+ *
+ * @see Settings::CustomEffects, TextEffects::AddTextProgram, NoiseTables
+ */
+namespace EffectProgram
+{
+    inline constexpr std::size_t kBatch = 64;                ///< Vertices per body pass
+    inline constexpr std::size_t kMaxRegisters = 32;         ///< Body temporaries, `u` and `v` included
+    inline constexpr std::size_t kMaxUniformRegisters = 64;  ///< Uniforms broadcast for the body
+    inline constexpr std::size_t kMaxScalars = 256;          ///< Inputs, constants and prologue temporaries
+
+    enum class Op : std::uint8_t
+    {
+        Splat,  // a scalar slot to every lane
+        Neg,
+        Sin,
+        Cos,
+        Abs,
+        Floor,
+        Fract,
+        Sqrt,
+        Saturate,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Min,
+        Max,
+        Pow,
+        Step,
+        Noise,
+        Fbm,
+        Clamp,
+        Mix,
+        SmoothStep,
+        HsvR,
+        HsvG,
+        HsvB
+    };
+
+    /// `dst = op(a, b, c)`; scalar slots in the prologue, registers in the body.
+    struct Instr
+    {
+        Op op;
+        std::uint16_t dst;
+        std::uint16_t a;
+        std::uint16_t b;
+        std::uint16_t c;
+    };
+
+    /// Per-call inputs of a program.
+    struct Uniforms
+    {
+        float time{0.0f};
+        float phase{0.0f};
+        float tier{0.0f};
+        float params[5]{};
+        float left[3]{1.0f, 1.0f, 1.0f};
+        float right[3]{1.0f, 1.0f, 1.0f};
+        float highlight[3]{1.0f, 1.0f, 1.0f};
+    };
+
+    struct Program
+    {
+        std::vector<float> scalars;   ///< Initial scalar slots: inputs, then constants and temporaries
+        std::vector<Instr> prologue;  ///< Uniform ops, once per call
+        std::vector<Instr> splats;    ///< Uniforms broadcast into registers, once per call
+        std::vector<Instr> body;      ///< Varying ops, once per batch
+        std::uint16_t output[3]{};    ///< Registers holding red, green, blue
+        std::uint16_t registers{0};   ///< Temporaries used, 0 if not compiled
+
+        bool Valid() const { return registers > 0; }
+    };
+
+    /**
+     * Compile an effect expression.
+     *
+     * @param error Receives a message with the column of the problem on failure.
+     * @return false if the expression is invalid; `out` is then left empty.
+     */
+    bool Compile(std::string_view source, Program& out, std::string* error = nullptr);
+
+    /**
+     * Evaluate a program for `count` vertices.
+     *
+     * @param u, v   Normalized vertex positions (structure of arrays).
+     * @param colors Receives packed colors in `IM_COL32` layout with `alpha`.
+     */
+    void Run(const Program& program, const Uniforms& uniforms, const float* u, const float* v,
+             std::size_t count, std::uint32_t* colors, std::uint8_t alpha);
+}
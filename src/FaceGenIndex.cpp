@@ -0,0 +1,471 @@
+#include "FaceGenIndex.h"
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <system_error>
+
+namespace FaceGenIndex
+{
+    namespace
+    {
+        constexpr std::string_view kMeshDir = "meshes\\actors\\character\\facegendata\\facegeom\\";
+        constexpr std::string_view kTintDir = "textures\\actors\\character\\facegendata\\facetint\\";
+
+        char FoldChar(char c)
+        {
+            if (c == '/')
+                return '\\';
+            if (c >= 'A' && c <= 'Z')
+                return static_cast<char>(c - 'A' + 'a');
+            return c;
+        }
+
+        bool StartsWithFolded(std::string_view path, std::string_view prefix)
+        {
+            if (path.size() < prefix.size())
+                return false;
+            for (std::size_t i = 0; i < prefix.size(); ++i)
+            {
+                if (FoldChar(path[i]) != prefix[i])
+                    return false;
+            }
+            return true;
+        }
+
+        bool EndsWithFolded(std::string_view path, std::string_view suffix)
+        {
+            return path.size() >= suffix.size() &&
+                   StartsWithFolded(path.substr(path.size() - suffix.size()), suffix);
+        }
+
+        bool ParseHex8(std::string_view s, std::uint32_t& out)
+        {
+            if (s.size() != 8)
+                return false;
+            std::uint32_t v = 0;
+            for (char c : s)
+            {
+                v <<= 4;
+                if (c >= '0' && c <= '9')
+                    v |= static_cast<std::uint32_t>(c - '0');
+                else if (c >= 'a' && c <= 'f')
+                    v |= static_cast<std::uint32_t>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F')
+                    v |= static_cast<std::uint32_t>(c - 'A' + 10);
+                else
+                    return false;
+            }
+            out = v;
+            return true;
+        }
+
+        std::string LowerPlugin(std::string_view plugin)
+        {
+            std::string out(plugin);
+            for (char& c : out)
+                c = FoldChar(c);
+            return out;
+        }
+
+        std::string FormatPath(std::string_view dir, std::string_view plugin, std::uint32_t faceID,
+                               std::string_view ext)
+        {
+            static constexpr char kHex[] = "0123456789ABCDEF";
+
+            std::string out;
+            out.reserve(dir.size() + plugin.size() + 1 + 8 + ext.size());
+            out.append(dir);
+            out.append(plugin);
+            out.push_back('\\');
+            for (int shift = 28; shift >= 0; shift -= 4)
+                out.push_back(kHex[(faceID >> shift) & 0xF]);
+            out.append(ext);
+            return out;
+        }
+
+        template <class T>
+        bool ReadValue(std::FILE* f, T& out)
+        {
+            return std::fread(&out, sizeof(T), 1, f) == 1;
+        }
+
+        struct FileCloser
+        {
+            void operator()(std::FILE* f) const { std::fclose(f); }
+        };
+        using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+        // Resolve a relative directory chain case-insensitively, for case-sensitive filesystems
+        bool ResolveDirFolded(const std::filesystem::path& root, std::initializer_list<std::string_view> parts,
+                              std::filesystem::path& out)
+        {
+            namespace fs = std::filesystem;
+
+            std::error_code ec;
+            fs::path dir = root;
+            for (std::string_view part : parts)
+            {
+                fs::path exact = dir / fs::path(std::string(part));
+                if (fs::is_directory(exact, ec))
+                {
+                    dir = std::move(exact);
+                    continue;
+                }
+
+                bool found = false;
+                for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    const std::string name = it->path().filename().string();
+                    if (name.size() == part.size() && StartsWithFolded(name, part) && it->is_directory(ec))
+                    {
+                        dir = it->path();
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found)
+                    return false;
+            }
+            out = std::move(dir);
+            return true;
+        }
+
+        FilePtr OpenRead(const std::filesystem::path& path)
+        {
+#ifdef _WIN32
+            return FilePtr(_wfopen(path.c_str(), L"rb"));
+#else
+            return FilePtr(std::fopen(path.c_str(), "rb"));
+#endif
+        }
+    }
+
+    std::vector<std::filesystem::path> MountedArchives(const std::filesystem::path& dataRoot,
+                                                       const std::vector<std::string>& activePlugins,
+                                                       const std::vector<std::string>& iniArchiveLists)
+    {
+        namespace fs = std::filesystem;
+
+        // Lowercase filename -> path of every archive present
+        std::unordered_map<std::string, fs::path> present;
+        std::error_code ec;
+        for (fs::directory_iterator it(dataRoot, ec), end; !ec && it != end; it.increment(ec))
+        {
+            const std::string name = it->path().filename().string();
+            if (EndsWithFolded(name, ".bsa") && it->is_regular_file(ec))
+                present.emplace(LowerPlugin(name), it->path());
+        }
+
+        std::vector<fs::path> mounted;
+        auto mount = [&](std::string_view name) {
+            auto it = present.find(LowerPlugin(name));
+            if (it == present.end())
+                return;
+            mounted.push_back(std::move(it->second));
+            present.erase(it);  // Each archive once
+        };
+
+        for (const std::string& list : iniArchiveLists)
+        {
+            std::size_t start = 0;
+            while (start <= list.size())
+            {
+                std::size_t end = list.find(',', start);
+                if (end == std::string::npos)
+                    end = list.size();
+                std::string_view name(list.data() + start, end - start);
+                while (!name.empty() && (name.front() == ' ' || name.front() == '\t'))
+                    name.remove_prefix(1);
+                while (!name.empty() && (name.back() == ' ' || name.back() == '\t'))
+                    name.remove_suffix(1);
+                if (!name.empty())
+                    mount(name);
+                start = end + 1;
+            }
+        }
+
+        for (const std::string& plugin : activePlugins)
+        {
+            const auto dot = plugin.find_last_of('.');
+            const std::string base = plugin.substr(0, dot);
+            if (base.empty())
+                continue;
+            mount(base + ".bsa");
+            mount(base + " - Textures.bsa");
+        }
+        return mounted;
+    }
+
+    std::string FormatMeshPath(std::string_view plugin, std::uint32_t faceID)
+    {
+        return FormatPath(kMeshDir, plugin, faceID, ".nif");
+    }
+
+    std::string FormatTintPath(std::string_view plugin, std::uint32_t faceID)
+    {
+        return FormatPath(kTintDir, plugin, faceID, ".dds");
+    }
+
+    // ------------------------------------------------------------------------
+    // LooseFileSource
+    // ------------------------------------------------------------------------
+
+    LooseFileSource::LooseFileSource(std::filesystem::path dataRoot)
+        : m_root(std::move(dataRoot))
+    {
+    }
+
+    bool LooseFileSource::Enumerate(const std::function<void(std::string_view)>& visit) const
+    {
+        namespace fs = std::filesystem;
+
+        std::error_code ec;
+        if (!fs::is_directory(m_root, ec))
+            return false;
+
+        fs::path subtrees[2];
+        const bool found[2] = {
+            ResolveDirFolded(m_root, {"meshes", "actors", "character", "facegendata", "facegeom"}, subtrees[0]),
+            ResolveDirFolded(m_root, {"textures", "actors", "character", "facegendata", "facetint"}, subtrees[1]),
+        };
+
+        std::string rel;
+        for (int i = 0; i < 2; ++i)
+        {
+            // Missing subtree is normal for installs without loose FaceGen
+            if (!found[i])
+                continue;
+
+            fs::recursive_directory_iterator it(subtrees[i], fs::directory_options::skip_permission_denied, ec);
+            if (ec)
+            {
+                ec.clear();
+                continue;
+            }
+
+            for (const fs::recursive_directory_iterator end; it != end; it.increment(ec))
+            {
+                if (ec)
+                    break;
+                if (!it->is_regular_file(ec))
+                    continue;
+
+                rel = fs::relative(it->path(), m_root, ec).generic_string();
+                if (!ec)
+                    visit(rel);
+            }
+            ec.clear();
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // BsaArchiveSource
+    // ------------------------------------------------------------------------
+
+    BsaArchiveSource::BsaArchiveSource(std::filesystem::path archivePath)
+        : m_path(std::move(archivePath))
+    {
+    }
+
+    bool BsaArchiveSource::Enumerate(const std::function<void(std::string_view)>& visit) const
+    {
+        // Header layout shared by Oblivion (103), Skyrim LE (104) and SE (105) archives
+        struct Header
+        {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t folderRecordOffset;
+            std::uint32_t archiveFlags;
+            std::uint32_t folderCount;
+            std::uint32_t fileCount;
+            std::uint32_t totalFolderNameLength;
+            std::uint32_t totalFileNameLength;
+            std::uint16_t fileFlags;
+            std::uint16_t padding;
+        };
+        static_assert(sizeof(Header) == 36);
+
+        constexpr std::uint32_t kIncludeDirectoryNames = 0x1;
+        constexpr std::uint32_t kIncludeFileNames = 0x2;
+        constexpr std::size_t kFileRecordSize = 16;
+
+        auto file = OpenRead(m_path);
+        if (!file)
+            return false;
+
+        Header header{};
+        if (!ReadValue(file.get(), header) || std::memcmp(header.magic, "BSA\0", 4) != 0)
+            return false;
+        if (header.version < 103 || header.version > 105)
+            return false;
+        if ((header.archiveFlags & kIncludeDirectoryNames) == 0 || (header.archiveFlags & kIncludeFileNames) == 0)
+            return false;
+
+        const std::size_t folderRecordSize = header.version == 105 ? 24 : 16;
+        std::vector<std::uint32_t> folderFileCounts(header.folderCount);
+        if (std::fseek(file.get(), static_cast<long>(header.folderRecordOffset), SEEK_SET) != 0)
+            return false;
+        {
+            std::vector<unsigned char> records(folderRecordSize * header.folderCount);
+            if (!records.empty() && std::fread(records.data(), records.size(), 1, file.get()) != 1)
+                return false;
+            for (std::uint32_t i = 0; i < header.folderCount; ++i)
+                std::memcpy(&folderFileCounts[i], records.data() + i * folderRecordSize + 8, sizeof(std::uint32_t));
+        }
+
+        // File record blocks: bstring folder name followed by the folder's file records
+        std::vector<std::string> folderNames(header.folderCount);
+        std::uint64_t declaredFiles = 0;
+        for (std::uint32_t i = 0; i < header.folderCount; ++i)
+        {
+            unsigned char len = 0;
+            if (!ReadValue(file.get(), len))
+                return false;
+            std::string& name = folderNames[i];
+            name.resize(len);
+            if (len > 0 && std::fread(name.data(), len, 1, file.get()) != 1)
+                return false;
+            while (!name.empty() && name.back() == '\0')
+                name.pop_back();
+
+            const std::uint64_t skip = static_cast<std::uint64_t>(folderFileCounts[i]) * kFileRecordSize;
+            if (std::fseek(file.get(), static_cast<long>(skip), SEEK_CUR) != 0)
+                return false;
+            declaredFiles += folderFileCounts[i];
+        }
+        if (declaredFiles != header.fileCount)
+            return false;
+
+        std::vector<char> names(header.totalFileNameLength);
+        if (!names.empty() && std::fread(names.data(), names.size(), 1, file.get()) != 1)
+            return false;
+
+        // File names are stored in folder order, null-terminated
+        std::string path;
+        std::size_t cursor = 0;
+        for (std::uint32_t i = 0; i < header.folderCount; ++i)
+        {
+            for (std::uint32_t f = 0; f < folderFileCounts[i]; ++f)
+            {
+                if (cursor >= names.size())
+                    return false;
+                const char* start = names.data() + cursor;
+                const std::size_t len = ::strnlen(start, names.size() - cursor);
+                cursor += len + 1;
+
+                path.assign(folderNames[i]);
+                path.push_back('\\');
+                path.append(start, len);
+                visit(path);
+            }
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Index
+    // ------------------------------------------------------------------------
+
+    bool Index::Table::Add(std::string_view path)
+    {
+        std::uint8_t flag = kNone;
+        std::string_view rest;
+        if (StartsWithFolded(path, kMeshDir) && EndsWithFolded(path, ".nif"))
+        {
+            flag = kMesh;
+            rest = path.substr(kMeshDir.size(), path.size() - kMeshDir.size() - 4);
+        }
+        else if (StartsWithFolded(path, kTintDir) && EndsWithFolded(path, ".dds"))
+        {
+            flag = kTint;
+            rest = path.substr(kTintDir.size(), path.size() - kTintDir.size() - 4);
+        }
+        else
+        {
+            return false;
+        }
+
+        // rest = "<plugin>\<8 hex digits>"
+        const auto sep = rest.find_last_of("\\/");
+        if (sep == std::string_view::npos || sep == 0)
+            return false;
+        const std::string_view plugin = rest.substr(0, sep);
+        if (plugin.find_first_of("\\/") != std::string_view::npos)
+            return false;
+
+        std::uint32_t faceID = 0;
+        if (!ParseHex8(rest.substr(sep + 1), faceID))
+            return false;
+
+        auto [it, inserted] = plugins.try_emplace(LowerPlugin(plugin), static_cast<std::uint32_t>(plugins.size()));
+        const std::uint64_t key = (static_cast<std::uint64_t>(it->second) << 32) | faceID;
+        entries[key] |= flag;
+        return true;
+    }
+
+    std::uint8_t Index::Table::Find(std::string_view plugin, std::uint32_t faceID) const
+    {
+        auto it = plugins.find(LowerPlugin(plugin));
+        if (it == plugins.end())
+            return kNone;
+        auto entry = entries.find((static_cast<std::uint64_t>(it->second) << 32) | faceID);
+        return entry != entries.end() ? entry->second : static_cast<std::uint8_t>(kNone);
+    }
+
+    Index::~Index()
+    {
+        if (m_worker.joinable())
+            m_worker.join();
+    }
+
+    std::size_t Index::Build(const std::vector<const IAssetSource*>& sources)
+    {
+        // Enumerate without holding the lock, then publish in one swap
+        Table table;
+        std::size_t assets = 0;
+        for (const auto* source : sources)
+        {
+            if (!source)
+                continue;
+            source->Enumerate([&](std::string_view path) {
+                if (table.Add(path))
+                    ++assets;
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_table = std::move(table);
+        }
+        m_ready.store(true, std::memory_order_release);
+        return assets;
+    }
+
+    void Index::BuildAsync(std::vector<std::unique_ptr<IAssetSource>> sources)
+    {
+        if (m_worker.joinable())
+            m_worker.join();
+
+        m_worker = std::thread([this, owned = std::move(sources)]() {
+            std::vector<const IAssetSource*> view;
+            view.reserve(owned.size());
+            for (const auto& s : owned)
+                view.push_back(s.get());
+            Build(view);
+        });
+    }
+
+    std::uint8_t Index::Find(std::string_view plugin, std::uint32_t faceID) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_table.Find(plugin, faceID);
+    }
+
+    std::size_t Index::Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_table.entries.size();
+    }
+}
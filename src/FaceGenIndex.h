@@ -0,0 +1,212 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @namespace FaceGenIndex
+ * @brief Background index of available FaceGen meshes and tints.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Core
+ *
+ * Enumerates loose files and BSA archive directories once after data load and
+ * records which `(plugin, FaceGen ID)` pairs have a baked head mesh and/or a
+ * face tint. Template application then answers "does this plugin ship FaceGen
+ * for this NPC?" with a hash lookup instead of opening a resource stream per
+ * candidate plugin.
+ *
+ * ## :material-folder-search-outline: Indexed Paths
+ *
+ * | Asset | Path                                                                     |
+ * |-------|--------------------------------------------------------------------------|
+ * | Mesh  | `meshes\actors\character\facegendata\facegeom\<plugin>\<ID>.nif`         |
+ * | Tint  | `textures\actors\character\facegendata\facetint\<plugin>\<ID>.dds`       |
+ *
+ * Paths are matched case-insensitively and accept either separator.
+ *
+ * ## :material-archive-outline: Archives
+ *
+ * Only archives the game mounts are indexed, see `MountedArchives()`. An
+ * index built from every `.bsa` in Data would report FaceGen from archives
+ * of disabled plugins, which the game cannot open.
+ *
+ * | Archive                          | Mounted when                                   |
+ * |----------------------------------|------------------------------------------------|
+ * | Named in `sResourceArchiveList*` | Always                                         |
+ * | `<plugin>.bsa`                   | `<plugin>.esp/.esm/.esl` is active             |
+ * | `<plugin> - Textures.bsa`        | `<plugin>.esp/.esm/.esl` is active             |
+ *
+ * ## :material-test-tube: Testing
+ *
+ * All file access goes through `IAssetSource`. `LooseFileSource` and
+ * `BsaArchiveSource` only use the C++ standard library, so the index can be
+ * built against a generated directory tree and synthetic archives on any
+ * platform.
+ *
+ * @see AppearanceTemplate::ApplyFaceGen
+ */
+namespace FaceGenIndex
+{
+    /// Presence flags for a `(plugin, FaceGen ID)` entry.
+    enum Presence : std::uint8_t
+    {
+        kNone = 0,       ///< No FaceGen assets found
+        kMesh = 1 << 0,  ///< `facegeom` NIF exists
+        kTint = 1 << 1   ///< `facetint` DDS exists
+    };
+
+    /**
+     * Provider of data-relative asset paths.
+     *
+     * Implementations report every file they contain; the index filters out
+     * anything that is not a FaceGen asset.
+     */
+    class IAssetSource
+    {
+    public:
+        virtual ~IAssetSource() = default;
+
+        /**
+         * Visit every file path in the source.
+         *
+         * @param visit Called once per path, relative to the Data directory.
+         *              The view is only valid for the duration of the call.
+         * @return `false` if the source could not be read.
+         */
+        virtual bool Enumerate(const std::function<void(std::string_view)>& visit) const = 0;
+    };
+
+    /**
+     * Loose files below a Data directory.
+     *
+     * Only the two FaceGen subtrees are walked, not the whole Data folder.
+     */
+    class LooseFileSource final : public IAssetSource
+    {
+    public:
+        explicit LooseFileSource(std::filesystem::path dataRoot);
+        bool Enumerate(const std::function<void(std::string_view)>& visit) const override;
+
+    private:
+        std::filesystem::path m_root;
+    };
+
+    /**
+     * Directory listing of a Bethesda archive (BSA v103/104/105).
+     *
+     * Reads only the header, folder names and file name table; file data is
+     * never touched.
+     */
+    class BsaArchiveSource final : public IAssetSource
+    {
+    public:
+        explicit BsaArchiveSource(std::filesystem::path archivePath);
+        bool Enumerate(const std::function<void(std::string_view)>& visit) const override;
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    /**
+     * Find the archives in a Data directory that the game mounts.
+     *
+     * @param dataRoot Data directory.
+     * @param activePlugins Filenames of the active plugins (e.g. "Skyrim.esm").
+     * @param iniArchiveLists Values of the `sResourceArchiveList*` INI settings,
+     *                        comma-separated archive filenames.
+     * @return Paths of the mounted archives that exist, each once.
+     */
+    std::vector<std::filesystem::path> MountedArchives(const std::filesystem::path& dataRoot,
+                                                       const std::vector<std::string>& activePlugins,
+                                                       const std::vector<std::string>& iniArchiveLists);
+
+    /**
+     * Format the FaceGen mesh path for a plugin and FaceGen ID.
+     *
+     * @param plugin Plugin filename (e.g. "Skyrim.esm").
+     * @param faceID FaceGen file ID (already masked for light plugins).
+     * @return `meshes\...\facegeom\<plugin>\<ID>.nif` with an 8-digit uppercase ID.
+     */
+    std::string FormatMeshPath(std::string_view plugin, std::uint32_t faceID);
+
+    /**
+     * Format the FaceGen tint path for a plugin and FaceGen ID.
+     *
+     * @param plugin Plugin filename (e.g. "Skyrim.esm").
+     * @param faceID FaceGen file ID (already masked for light plugins).
+     * @return `textures\...\facetint\<plugin>\<ID>.dds` with an 8-digit uppercase ID.
+     */
+    std::string FormatTintPath(std::string_view plugin, std::uint32_t faceID);
+
+    /**
+     * `(plugin, FaceGen ID)` to presence map.
+     *
+     * `Find()` may be called from any thread; it returns `kNone` until a
+     * build has completed.
+     */
+    class Index
+    {
+    public:
+        Index() = default;
+        ~Index();
+        Index(const Index&) = delete;
+        Index& operator=(const Index&) = delete;
+
+        /**
+         * Build the index synchronously from the given sources.
+         *
+         * @param sources Sources to enumerate; unreadable ones are skipped.
+         * @return Number of FaceGen assets indexed.
+         */
+        std::size_t Build(const std::vector<const IAssetSource*>& sources);
+
+        /**
+         * Build the index on a worker thread.
+         *
+         * The index takes ownership of the sources. A build already in
+         * progress is joined first.
+         *
+         * @param sources Sources to enumerate.
+         */
+        void BuildAsync(std::vector<std::unique_ptr<IAssetSource>> sources);
+
+        /// Whether a build has completed and lookups are authoritative.
+        bool IsReady() const { return m_ready.load(std::memory_order_acquire); }
+
+        /**
+         * Look up FaceGen presence for a plugin.
+         *
+         * @param plugin Plugin filename, any case.
+         * @param faceID FaceGen file ID.
+         * @return Combination of `Presence` flags.
+         */
+        std::uint8_t Find(std::string_view plugin, std::uint32_t faceID) const;
+
+        /// Number of `(plugin, ID)` entries.
+        std::size_t Size() const;
+
+    private:
+        struct Table
+        {
+            std::unordered_map<std::string, std::uint32_t> plugins;  // Lowercase name -> slot
+            std::unordered_map<std::uint64_t, std::uint8_t> entries;  // (slot << 32 | ID) -> flags
+
+            bool Add(std::string_view path);
+            std::uint8_t Find(std::string_view plugin, std::uint32_t faceID) const;
+        };
+
+        mutable std::mutex m_lock;
+        Table m_table;
+        std::atomic<bool> m_ready{false};
+        std::thread m_worker;
+    };
+}
@@ -0,0 +1,96 @@
+#include "FontAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace FontAtlas
+{
+    int BytesPerPixel(Format format)
+    {
+        return format == Format::RGBA32 ? 4 : 1;
+    }
+
+    int MipCount(int width, int height)
+    {
+        int levels = 1;
+        int maxDim = (std::max)(width, height);
+        while (maxDim > 1)
+        {
+            maxDim >>= 1;
+            ++levels;
+        }
+        return levels;
+    }
+
+    Format ChooseFormat(bool hasColorPixels, bool alphaShaderReady)
+    {
+        return (hasColorPixels || !alphaShaderReady) ? Format::RGBA32 : Format::Alpha8;
+    }
+
+    std::uint8_t Image::Coverage(std::size_t level, int x, int y) const
+    {
+        const MipLevel& l = levels[level];
+        const int bpp = BytesPerPixel(format);
+        const std::size_t texel = static_cast<std::size_t>(y) * l.width + x;
+        return pixels[l.offset + texel * bpp + (bpp - 1)];
+    }
+
+    // 2x2 box filter of one level into the next, every channel independently
+    static void Downsample(const std::uint8_t* src, const MipLevel& from,
+                           std::uint8_t* dst, const MipLevel& to, int bpp)
+    {
+        for (int y = 0; y < to.height; ++y)
+        {
+            const int y0 = (std::min)(y * 2, from.height - 1);
+            const int y1 = (std::min)(y * 2 + 1, from.height - 1);
+            const std::uint8_t* row0 = src + static_cast<std::size_t>(y0) * from.width * bpp;
+            const std::uint8_t* row1 = src + static_cast<std::size_t>(y1) * from.width * bpp;
+            std::uint8_t* out = dst + static_cast<std::size_t>(y) * to.width * bpp;
+
+            for (int x = 0; x < to.width; ++x)
+            {
+                const int x0 = (std::min)(x * 2, from.width - 1) * bpp;
+                const int x1 = (std::min)(x * 2 + 1, from.width - 1) * bpp;
+                for (int c = 0; c < bpp; ++c)
+                {
+                    const unsigned sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                    out[x * bpp + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    Image Build(const std::uint8_t* pixels, int width, int height, Format format)
+    {
+        Image image;
+        image.format = format;
+        if (!pixels || width <= 0 || height <= 0)
+            return image;
+
+        const int bpp = BytesPerPixel(format);
+        const int count = MipCount(width, height);
+        image.levels.reserve(count);
+
+        // Lay out every level first so the pixel buffer is allocated once
+        std::size_t total = 0;
+        int w = width, h = height;
+        for (int i = 0; i < count; ++i)
+        {
+            image.levels.push_back({w, h, total});
+            total += static_cast<std::size_t>(w) * h * bpp;
+            w = (std::max)(w / 2, 1);
+            h = (std::max)(h / 2, 1);
+        }
+
+        image.pixels.resize(total);
+        std::memcpy(image.pixels.data(), pixels, static_cast<std::size_t>(width) * height * bpp);
+
+        for (int i = 1; i < count; ++i)
+        {
+            const MipLevel& from = image.levels[i - 1];
+            const MipLevel& to = image.levels[i];
+            Downsample(image.pixels.data() + from.offset, from, image.pixels.data() + to.offset, to, bpp);
+        }
+        return image;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace FontAtlas
+ * @brief CPU-side font atlas texture data with a prebuilt mip chain.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * The four nameplate fonts are rasterized at 178/106/84/96 px with 4x
+ * oversampling, so the atlas is large. Glyphs only carry coverage, yet the
+ * atlas used to be expanded to RGBA32 (white plus alpha) and mipmapped on
+ * the GPU, which needs a render-target texture. The alpha-only path keeps
+ * one byte per texel in an `R8_UNORM` texture that a small pixel shader
+ * reads coverage from, and builds every mip level here at load time so the
+ * texture is uploaded once, immutable, with no `GenerateMips` call.
+ *
+ * ## :material-image-size-select-small: Formats
+ *
+ * | Format   | Bytes/texel | Source                       | Used when                      |
+ * |----------|:-----------:|------------------------------|--------------------------------|
+ * | `Alpha8` | 1           | `GetTexDataAsAlpha8`         | Glyph coverage only            |
+ * | `RGBA32` | 4           | `GetTexDataAsRGBA32`         | Color pixels share the atlas   |
+ *
+ * Color pixels are colored glyphs (FreeType `LoadColor`) or images packed
+ * into the atlas as custom rects. An alpha-only texture cannot hold them, so
+ * the atlas falls back to RGBA32 and the stock ImGui shader.
+ *
+ * ## :material-layers-triple-outline: Mip Chain
+ *
+ * Each level halves both sizes (at least 1) and averages the 2x2 block of
+ * the level above, clamping at odd edges:
+ *
+ * $$m_{k+1}(x, y) = \left\lfloor \frac{1}{4}\sum_{i,j \in \{0,1\}} m_k(\min(2x+i, w_k-1), \min(2y+j, h_k-1)) + \frac{1}{2} \right\rfloor$$
+ *
+ * Channels are filtered independently, so the alpha of an RGBA32 chain is
+ * byte-identical to an Alpha8 chain built from the same coverage.
+ *
+ * @see Hooks::RenderOverlayNow
+ */
+namespace FontAtlas
+{
+    enum class Format : std::uint8_t
+    {
+        Alpha8,  ///< One coverage byte per texel, `DXGI_FORMAT_R8_UNORM`
+        RGBA32,  ///< Straight RGBA, `DXGI_FORMAT_R8G8B8A8_UNORM`
+    };
+
+    /// Bytes per texel of `format`.
+    int BytesPerPixel(Format format);
+
+    /// Number of levels in a full mip chain down to 1x1.
+    int MipCount(int width, int height);
+
+    /**
+     * Atlas format for this build.
+     *
+     * @param hasColorPixels   Colored glyphs or images share the atlas
+     * @param alphaShaderReady The coverage pixel shader compiled
+     */
+    Format ChooseFormat(bool hasColorPixels, bool alphaShaderReady);
+
+    /// One level of an `Image`, stored tightly packed in `Image::pixels`.
+    struct MipLevel
+    {
+        int width{0};
+        int height{0};
+        std::size_t offset{0};  ///< Byte offset into `Image::pixels`
+
+        int RowPitch(Format format) const { return width * BytesPerPixel(format); }
+    };
+
+    /// Atlas texels with every mip level, ready for `CreateTexture2D` initial data.
+    struct Image
+    {
+        Format format{Format::Alpha8};
+        std::vector<MipLevel> levels;
+        std::vector<std::uint8_t> pixels;
+
+        const std::uint8_t* Data(std::size_t level) const { return pixels.data() + levels[level].offset; }
+        std::size_t ByteSize() const { return pixels.size(); }
+        bool Empty() const { return levels.empty(); }
+
+        /// Glyph coverage at a texel: red for Alpha8, alpha for RGBA32.
+        std::uint8_t Coverage(std::size_t level, int x, int y) const;
+    };
+
+    /**
+     * Copy level 0 from `pixels` and build the full mip chain.
+     *
+     * @param pixels Tightly packed texels in `format`, as returned by ImGui
+     * @return Empty image if the input is null or has no area
+     */
+    Image Build(const std::uint8_t* pixels, int width, int height, Format format);
+}
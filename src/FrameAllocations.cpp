@@ -0,0 +1,76 @@
+#include "FrameAllocations.h"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace FrameAllocations
+{
+    static std::atomic<std::uint64_t> s_allocations{0};
+    static std::atomic<std::uint64_t> s_frees{0};
+    static std::atomic<std::uint64_t> s_bytes{0};
+
+    void* Alloc(std::size_t size, void*)
+    {
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+        s_bytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size);
+    }
+
+    void Free(void* ptr, void*)
+    {
+        // ImGui frees null pointers freely; only count real blocks
+        if (!ptr)
+            return;
+        s_frees.fetch_add(1, std::memory_order_relaxed);
+        std::free(ptr);
+    }
+
+    Counters Totals()
+    {
+        Counters c;
+        c.allocations = s_allocations.load(std::memory_order_relaxed);
+        c.frees = s_frees.load(std::memory_order_relaxed);
+        c.bytes = s_bytes.load(std::memory_order_relaxed);
+        return c;
+    }
+
+    Meter::Meter(std::uint32_t warmupFrames) :
+        m_warmupFrames(warmupFrames)
+    {
+    }
+
+    void Meter::BeginFrame(std::uint64_t allocations)
+    {
+        m_frameStart = allocations;
+    }
+
+    std::uint64_t Meter::EndFrame(std::uint64_t allocations)
+    {
+        m_lastFrame = allocations - m_frameStart;
+        if (m_framesSinceArm <= m_warmupFrames)
+            ++m_framesSinceArm;
+
+        if (Warm())
+        {
+            ++m_steadyFrames;
+            m_steadyAllocations += m_lastFrame;
+            if (m_lastFrame > 0)
+                ++m_allocatingFrames;
+        }
+        return m_lastFrame;
+    }
+
+    void Meter::Rearm()
+    {
+        m_framesSinceArm = 0;
+        m_steadyFrames = 0;
+        m_allocatingFrames = 0;
+        m_steadyAllocations = 0;
+    }
+
+    Meter& OverlayMeter()
+    {
+        static Meter meter;
+        return meter;
+    }
+}
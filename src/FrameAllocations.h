@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace FrameAllocations
+ * @brief Heap allocation counting for the overlay frame.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * The overlay runs inside the game's Present path. An allocation there can
+ * wait on the heap lock while the game's own allocator is under pressure,
+ * which shows up as a hitch even though the frame's work is small. After a
+ * short warm-up every buffer the frame touches has reached its high-water
+ * mark, so a frame with the same actor set should not allocate at all.
+ *
+ * ImGui is routed through `Alloc` and `Free` with `SetAllocatorFunctions`,
+ * which covers draw list growth, window state and the draw data. Plugin
+ * containers keep their capacity (scratch buffers, `clear()` instead of
+ * rebuilding) and are checked by the allocation-counting test harness.
+ *
+ * ## :material-counter: Meter
+ *
+ * `Meter` compares the allocation count at the start and end of each frame.
+ * The first `kWarmupFrames` frames after `Rearm` are not judged, so caches,
+ * draw lists and glyph tables can grow to their working size:
+ *
+ * | State     | Frames                           | Allocations                    |
+ * |-----------|----------------------------------|--------------------------------|
+ * | Warm-up   | First `kWarmupFrames` after arm  | Expected, not counted          |
+ * | Steady    | Every later frame                | Expected zero, counted if not  |
+ *
+ * The renderer rearms the meter when the actor set or the settings change,
+ * since both legitimately grow buffers.
+ *
+ * @see Hooks::RenderOverlayNow, DebugOverlay::Render
+ */
+namespace FrameAllocations
+{
+    /// Frames after `Meter::Rearm` in which allocations are expected.
+    inline constexpr std::uint32_t kWarmupFrames = 120;
+
+    /// ImGui allocator hook (`ImGuiMemAllocFunc`), counts and forwards to `malloc`.
+    void* Alloc(std::size_t size, void* userData);
+
+    /// ImGui free hook (`ImGuiMemFreeFunc`), counts and forwards to `free`.
+    void Free(void* ptr, void* userData);
+
+    /// Running totals of `Alloc` and `Free`.
+    struct Counters
+    {
+        std::uint64_t allocations{0};
+        std::uint64_t frees{0};
+        std::uint64_t bytes{0};  ///< Bytes requested, never decreases
+    };
+
+    /// Totals since the plugin loaded; safe from any thread.
+    Counters Totals();
+
+    /**
+     * Per-frame allocation judge.
+     *
+     * Feed it a monotonically increasing allocation count at the start and
+     * end of every frame.
+     */
+    class Meter
+    {
+    public:
+        explicit Meter(std::uint32_t warmupFrames = kWarmupFrames);
+
+        void BeginFrame(std::uint64_t allocations);
+
+        /// End the frame; returns the allocations made during it.
+        std::uint64_t EndFrame(std::uint64_t allocations);
+
+        /// Restart the warm-up, e.g. after the actor set changed.
+        void Rearm();
+
+        /// True once the warm-up is over and frames are judged.
+        bool Warm() const { return m_framesSinceArm > m_warmupFrames; }
+
+        std::uint64_t LastFrame() const { return m_lastFrame; }        ///< Allocations in the last frame
+        std::uint32_t SteadyFrames() const { return m_steadyFrames; }  ///< Judged frames since the last arm
+        std::uint32_t AllocatingFrames() const { return m_allocatingFrames; }  ///< Judged frames that allocated
+        std::uint64_t SteadyAllocations() const { return m_steadyAllocations; }  ///< Allocations in judged frames
+
+    private:
+        std::uint32_t m_warmupFrames;
+        std::uint32_t m_framesSinceArm{0};
+        std::uint64_t m_frameStart{0};
+        std::uint64_t m_lastFrame{0};
+        std::uint32_t m_steadyFrames{0};
+        std::uint32_t m_allocatingFrames{0};
+        std::uint64_t m_steadyAllocations{0};
+    };
+
+    /// Meter of the overlay frame, bracketed by `Hooks::RenderOverlayNow`.
+    Meter& OverlayMeter();
+}
@@ -0,0 +1,271 @@
+#include "FramePipeline.h"
+
+namespace FramePipeline
+{
+    Mode ModeFromInt(int value)
+    {
+        switch (value)
+        {
+        case 1:
+            return Mode::Latency;
+        case 2:
+            return Mode::Throughput;
+        default:
+            return Mode::Serial;
+        }
+    }
+
+    bool Camera::Project(const float world[3], float& x, float& y, float& z) const
+    {
+        const float (&m)[4][4] = worldToCam;
+        const float wx = world[0], wy = world[1], wz = world[2];
+
+        // Same near-plane epsilon as the serial path
+        const float w = m[3][0] * wx + m[3][1] * wy + m[3][2] * wz + m[3][3];
+        if (w <= 1e-5f)
+            return false;
+
+        const float inv = 1.0f / w;
+        const float nx = (m[0][0] * wx + m[0][1] * wy + m[0][2] * wz + m[0][3]) * inv;
+        const float ny = (m[1][0] * wx + m[1][1] * wy + m[1][2] * wz + m[1][3]) * inv;
+        const float nz = (m[2][0] * wx + m[2][1] * wy + m[2][2] * wz + m[2][3]) * inv;
+
+        // Clip space to the normalized viewport, then to pixels with Y down
+        const float sx = left + (nx + 1.0f) * 0.5f * (right - left);
+        const float sy = bottom + (ny + 1.0f) * 0.5f * (top - bottom);
+        x = sx * width;
+        y = (1.0f - sy) * height;
+        z = nz;
+        return true;
+    }
+
+    void Frame::Clear()
+    {
+        vertices.clear();
+        indices.clear();
+        commands.clear();
+        anchors.clear();
+        serial = 0;
+    }
+
+    void Reproject(Frame& frame, const Camera& camera)
+    {
+        for (const auto& a : frame.anchors)
+        {
+            const std::uint32_t end = a.vtxEnd < frame.vertices.size()
+                                          ? a.vtxEnd
+                                          : static_cast<std::uint32_t>(frame.vertices.size());
+
+            float x, y, z;
+            if (!camera.Project(a.world, x, y, z))
+            {
+                // Anchor went behind the camera: hide instead of smearing
+                for (std::uint32_t i = a.vtxBegin; i < end; ++i)
+                    frame.vertices[i].col &= 0x00FFFFFFu;
+                continue;
+            }
+
+            const float dx = x - a.screen[0];
+            const float dy = y - a.screen[1];
+            if (dx == 0.0f && dy == 0.0f)
+                continue;
+
+            for (std::uint32_t i = a.vtxBegin; i < end; ++i)
+            {
+                frame.vertices[i].x += dx;
+                frame.vertices[i].y += dy;
+            }
+        }
+
+        // Clip rectangles stay in screen space; only the labels move
+        frame.camera = camera;
+    }
+
+    Pipeline::Pipeline(IFrameBuilder& builder)
+        : m_builder(builder)
+    {
+    }
+
+    Pipeline::~Pipeline()
+    {
+        StopWorker();
+    }
+
+    void Pipeline::SetMode(Mode mode)
+    {
+        if (mode == m_mode)
+            return;
+
+        if (mode == Mode::Serial)
+            StopWorker();
+        else
+            Wait();
+
+        // Frames from the old mode are stale either way
+        m_mode = mode;
+        m_hasFront = false;
+        m_lastKickTime = -1.0;
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_readyNew = false;
+    }
+
+    const Frame* Pipeline::Submit(const FrameInput& input)
+    {
+        if (m_mode == Mode::Serial)
+        {
+            m_builder.Capture(input);
+            m_front.Clear();
+            m_front.camera = input.camera;
+            m_front.serial = input.serial;
+            m_builder.Build(input, m_front);
+            ++m_stats.built;
+            ++m_stats.submitted;
+            return &m_front;
+        }
+
+        StartWorker();
+
+        if (m_mode == Mode::Latency)
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            if (m_busy)
+            {
+                ++m_stats.waits;
+                m_done.wait(lock, [this] { return !m_busy; });
+            }
+        }
+
+        const bool fresh = TakeReady();
+
+        // In throughput mode a busy worker keeps its build; the new input is skipped
+        Kick(input);
+
+        if (!m_hasFront)
+            return nullptr;
+
+        if (!fresh)
+            ++m_stats.repeated;
+        ++m_stats.submitted;
+
+        // Reproject a copy so a repeated frame starts from its build camera again
+        m_submit.vertices.assign(m_front.vertices.begin(), m_front.vertices.end());
+        m_submit.indices.assign(m_front.indices.begin(), m_front.indices.end());
+        m_submit.commands.assign(m_front.commands.begin(), m_front.commands.end());
+        m_submit.anchors.assign(m_front.anchors.begin(), m_front.anchors.end());
+        m_submit.camera = m_front.camera;
+        m_submit.serial = m_front.serial;
+        Reproject(m_submit, input.camera);
+        return &m_submit;
+    }
+
+    void Pipeline::Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_done.wait(lock, [this] { return !m_busy; });
+    }
+
+    void Pipeline::Reset()
+    {
+        Wait();
+        m_hasFront = false;
+        m_lastKickTime = -1.0;
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_readyNew = false;
+    }
+
+    Stats Pipeline::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_stats;
+    }
+
+    void Pipeline::StartWorker()
+    {
+        if (m_worker.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stop = false;
+        }
+        m_worker = std::thread([this]() { WorkerLoop(); });
+    }
+
+    void Pipeline::StopWorker()
+    {
+        if (!m_worker.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_worker.join();
+    }
+
+    void Pipeline::WorkerLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (;;)
+        {
+            m_wake.wait(lock, [this] { return m_stop || m_busy; });
+            if (m_busy)
+            {
+                const FrameInput input = m_pending;
+                lock.unlock();
+
+                m_back.Clear();
+                m_back.camera = input.camera;
+                m_back.serial = input.serial;
+                m_builder.Build(input, m_back);
+
+                lock.lock();
+                std::swap(m_back, m_ready);
+                m_readyNew = true;
+                m_busy = false;
+                ++m_stats.built;
+                m_done.notify_all();
+            }
+            if (m_stop)
+                return;
+        }
+    }
+
+    bool Pipeline::Kick(const FrameInput& input)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_busy)
+                return false;
+        }
+
+        // The worker is idle, so the builder may copy render-thread state
+        m_builder.Capture(input);
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_pending = input;
+            m_busy = true;
+
+            // Skipped inputs are folded into the next build's step so smoothing keeps real time
+            if (m_lastKickTime >= 0.0 && input.time > m_lastKickTime)
+                m_pending.deltaTime = static_cast<float>(input.time - m_lastKickTime);
+        }
+        m_lastKickTime = input.time;
+        m_wake.notify_one();
+        return true;
+    }
+
+    bool Pipeline::TakeReady()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_readyNew)
+            return false;
+
+        std::swap(m_ready, m_front);
+        m_readyNew = false;
+        m_hasFront = true;
+        return true;
+    }
+}
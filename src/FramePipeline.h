@@ -0,0 +1,246 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace FramePipeline
+ * @brief Optional off-thread build of the nameplate vertex buffers.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * In the serial path the render thread builds every label into the ImGui draw
+ * list while the frame is presented. A pipelined build moves that work to a
+ * worker: the worker turns the newest snapshot and camera into a
+ * self-contained `Frame` of vertex, index and command buffers, and the render
+ * thread only copies the last finished frame into the overlay draw list.
+ *
+ * ## :material-swap-horizontal: Modes
+ *
+ * | Mode         | Build thread | Render thread at submit                      | Added latency |
+ * |--------------|--------------|----------------------------------------------|---------------|
+ * | `Serial`     | Render       | Builds and submits the current frame         | None          |
+ * | `Latency`    | Worker       | Waits for the frame kicked last submit       | 1 frame       |
+ * | `Throughput` | Worker       | Never waits; repeats the last finished frame | 1+ frames     |
+ *
+ * ```mermaid
+ * %%{init: {'theme':'dark', 'look':'handDrawn'}}%%
+ * sequenceDiagram
+ *     participant RT as Render Thread
+ *     participant W as Worker
+ *     RT->>W: Capture(N) + kick build N
+ *     Note over RT: present frame N-1 (reprojected)
+ *     W-->>RT: frame N ready
+ *     RT->>W: Capture(N+1) + kick build N+1
+ *     Note over RT: present frame N (reprojected)
+ * ```
+ *
+ * ## :material-crosshairs-gps: Reprojection
+ *
+ * A pipelined frame was built with an older camera. Each label records its
+ * world anchor, the screen position that anchor had at build time and the
+ * vertex range it emitted. At submit the anchor is projected with the newest
+ * camera and the label's vertices are translated by the difference, so
+ * labels stay attached to heads while the camera turns. Labels whose anchor
+ * falls behind the newest camera are made transparent.
+ *
+ * ## :material-test-tube: Testing
+ *
+ * The pipeline only sees `IFrameBuilder`, so a deterministic builder can
+ * drive every mode headlessly and compare the buffers against the serial path.
+ *
+ * @see Renderer::Draw
+ */
+namespace FramePipeline
+{
+    /// Where labels are built, see the mode table above.
+    enum class Mode : std::uint8_t
+    {
+        Serial,     ///< Build on the render thread (default)
+        Latency,    ///< Build on the worker, wait for it at submit
+        Throughput  ///< Build on the worker, never wait
+    };
+
+    /// Convert the `FrameBuildMode` setting to a mode; out of range is `Serial`.
+    Mode ModeFromInt(int value);
+
+    /**
+     * Copy of the engine camera taken on the render thread.
+     *
+     * `Project()` matches `NiCamera::WorldPtToScreenPt3` followed by the
+     * overlay's conversion to pixels with Y pointing down.
+     */
+    struct Camera
+    {
+        float worldToCam[4][4]{};  ///< Row-major world to clip matrix
+        float left{0.0f};          ///< Viewport left
+        float right{1.0f};         ///< Viewport right
+        float top{1.0f};           ///< Viewport top
+        float bottom{0.0f};        ///< Viewport bottom
+        float width{0.0f};         ///< Screen width in pixels
+        float height{0.0f};        ///< Screen height in pixels
+        float position[3]{};       ///< Camera world position
+
+        /**
+         * Project a world point to pixels.
+         *
+         * @return `false` if the point is behind the near plane.
+         */
+        bool Project(const float world[3], float& x, float& y, float& z) const;
+    };
+
+    /// Vertex laid out like `ImDrawVert` (pos, uv, packed ABGR color).
+    struct Vertex
+    {
+        float x, y;
+        float u, v;
+        std::uint32_t col;
+    };
+
+    /// Contiguous run of triangles sharing one texture and clip rectangle.
+    struct DrawCmd
+    {
+        void* texture{nullptr};    ///< Backend texture handle
+        float clip[4]{};           ///< Clip rectangle (x1, y1, x2, y2)
+        std::uint32_t idxOffset{0};  ///< First index in `Frame::indices`
+        std::uint32_t idxCount{0};   ///< Number of indices
+        std::uint32_t vtxBegin{0};   ///< Lowest vertex referenced
+        std::uint32_t vtxEnd{0};     ///< One past the highest vertex referenced
+    };
+
+    /// One label's anchor and the vertices it emitted.
+    struct Anchor
+    {
+        float world[3]{};          ///< World anchor (above the actor's head)
+        float screen[2]{};         ///< Anchor in pixels under the build camera
+        std::uint32_t vtxBegin{0};   ///< First vertex of the label
+        std::uint32_t vtxEnd{0};     ///< One past the last vertex of the label
+    };
+
+    /**
+     * Self-contained geometry for one overlay frame.
+     *
+     * Indices are absolute into `vertices`. Buffers keep their capacity when
+     * cleared so a steady-state build does not allocate.
+     */
+    struct Frame
+    {
+        std::vector<Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+        std::vector<DrawCmd> commands;
+        std::vector<Anchor> anchors;
+        Camera camera;               ///< Camera the frame was built with
+        std::uint64_t serial{0};     ///< Serial of the input it was built from
+
+        void Clear();
+        bool Empty() const { return commands.empty(); }
+    };
+
+    /// Everything a build may read besides the builder's own capture.
+    struct FrameInput
+    {
+        Camera camera;
+        double time{0.0};            ///< Animation clock in seconds
+        float deltaTime{0.0f};       ///< Seconds since the previous frame, or since the previous build when pipelined
+        std::uint64_t serial{0};     ///< Increasing frame number
+    };
+
+    /**
+     * Producer of frame geometry.
+     *
+     * `Capture()` runs on the render thread and is never called while a
+     * `Build()` is in progress, so it can copy the snapshot and any other
+     * render-thread state the next build needs.
+     */
+    class IFrameBuilder
+    {
+    public:
+        virtual ~IFrameBuilder() = default;
+        virtual void Capture(const FrameInput& input) = 0;
+        virtual void Build(const FrameInput& input, Frame& out) = 0;
+    };
+
+    /**
+     * Translate each label of `frame` from the camera it was built with to
+     * `camera`. Labels whose anchor is behind `camera` get zero alpha.
+     */
+    void Reproject(Frame& frame, const Camera& camera);
+
+    /// Counters for the debug overlay.
+    struct Stats
+    {
+        std::uint64_t built{0};      ///< Frames built
+        std::uint64_t submitted{0};  ///< Frames returned by `Submit()`
+        std::uint64_t repeated{0};   ///< Submits that reused an already shown frame
+        std::uint64_t waits{0};      ///< Submits that blocked on the worker
+    };
+
+    /**
+     * Runs an `IFrameBuilder` in the selected mode.
+     *
+     * All members except the worker loop are called from the render thread.
+     */
+    class Pipeline
+    {
+    public:
+        explicit Pipeline(IFrameBuilder& builder);
+        ~Pipeline();
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        /// Switch modes. Leaving a pipelined mode waits for the worker.
+        void SetMode(Mode mode);
+        Mode GetMode() const { return m_mode; }
+
+        /**
+         * Produce the frame to draw for `input`.
+         *
+         * Serial builds `input` in place. The pipelined modes return the most
+         * recent finished frame reprojected to `input.camera` and kick a build
+         * of `input`, or return `nullptr` while no frame has finished yet.
+         * The result stays valid until the next call.
+         */
+        const Frame* Submit(const FrameInput& input);
+
+        /// Block until the worker is idle, e.g. before settings change.
+        void Wait();
+
+        /// Wait and drop finished frames, e.g. after a load screen.
+        void Reset();
+
+        /// Snapshot of the counters.
+        Stats GetStats() const;
+
+    private:
+        void StartWorker();
+        void StopWorker();
+        void WorkerLoop();
+        bool Kick(const FrameInput& input);  // false if the worker is busy
+        bool TakeReady();                    // moves a finished frame to m_front
+
+        IFrameBuilder& m_builder;
+        Mode m_mode{Mode::Serial};
+        Stats m_stats;
+
+        // m_back: worker only. m_ready: guarded by m_lock. m_front, m_submit: render thread only.
+        Frame m_back;
+        Frame m_ready;
+        Frame m_front;
+        Frame m_submit;
+        bool m_hasFront{false};
+        double m_lastKickTime{-1.0};
+
+        mutable std::mutex m_lock;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        FrameInput m_pending;
+        bool m_busy{false};
+        bool m_readyNew{false};
+        bool m_stop{false};
+        std::thread m_worker;
+    };
+}
@@ -1,14 +1,21 @@
 #include "Hooks.h"
+#include "AppearanceTemplate.h"
+#include "FontAtlas.h"
+#include "FrameAllocations.h"
 #include "ParticleTextures.h"
 #include "Renderer.h"
 #include "Settings.h"
+#include "SettingsWatch.h"
 
 #include <d3d11.h>
+#include <d3dcompiler.h>
 #include <dxgi.h>
 #include <imgui_impl_dx11.h>
 #include <imgui_impl_win32.h>
+#include <vector>
 
 #pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "d3dcompiler.lib")
 #pragma comment(lib, "dxgi.lib")
 
 namespace Hooks
@@ -37,6 +44,173 @@ namespace Hooks
     /// Stored swap chain for Present hook
     IDXGISwapChain* g_swapChain = nullptr;
 
+    /// Pixel shader reading glyph coverage from the red channel of the alpha-only atlas
+    ID3D11PixelShader* g_atlasCoveragePS = nullptr;
+
+    /// ImGui's own pixel shader, captured the first time the coverage shader is bound
+    ID3D11PixelShader* g_stockPS = nullptr;
+
+    /// Trilinear sampler so the prebuilt atlas mips are used when text is scaled down
+    ID3D11SamplerState* g_atlasSampler = nullptr;
+
+    /// Alpha-only atlas view; draw commands sampling it need the coverage shader
+    ImTextureID g_alphaAtlasTex{};
+
+    /// Same inputs as the ImGui DX11 backend shader, but alpha comes from the red channel
+    static constexpr char kAtlasCoverageShader[] = R"(
+        struct PS_INPUT
+        {
+            float4 pos : SV_POSITION;
+            float4 col : COLOR0;
+            float2 uv  : TEXCOORD0;
+        };
+        sampler sampler0;
+        Texture2D texture0;
+        float4 main(PS_INPUT input) : SV_Target
+        {
+            return input.col * float4(1.0, 1.0, 1.0, texture0.Sample(sampler0, input.uv).r);
+        }
+    )";
+
+    /// Compile the coverage shader and its sampler. On failure the atlas stays RGBA32.
+    static void CreateAtlasCoverageShader(ID3D11Device* device)
+    {
+        ID3DBlob* blob = nullptr;
+        ID3DBlob* errors = nullptr;
+        if (FAILED(D3DCompile(kAtlasCoverageShader, sizeof(kAtlasCoverageShader) - 1, nullptr, nullptr, nullptr,
+                              "main", "ps_4_0", 0, 0, &blob, &errors))) {
+            SKSE::log::warn("Hooks: Atlas coverage shader failed to compile: {}",
+                            errors ? static_cast<const char*>(errors->GetBufferPointer()) : "unknown error");
+            if (errors) errors->Release();
+            return;
+        }
+        if (errors) errors->Release();
+
+        if (FAILED(device->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &g_atlasCoveragePS))) {
+            g_atlasCoveragePS = nullptr;
+        }
+        blob->Release();
+
+        D3D11_SAMPLER_DESC samplerDesc = {};
+        samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;  // Same addressing as the ImGui sampler
+        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+        samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+        samplerDesc.MinLOD = 0.0f;
+        samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+        if (FAILED(device->CreateSamplerState(&samplerDesc, &g_atlasSampler))) {
+            g_atlasSampler = nullptr;
+        }
+    }
+
+    /// Draw callback switching between the coverage shader (data set) and ImGui's shader (data null)
+    static void SetAtlasShaderCallback(const ImDrawList*, const ImDrawCmd* cmd)
+    {
+        if (!g_context) return;
+
+        if (cmd && cmd->UserCallbackData) {
+            // The first switch always follows the backend's render state setup
+            if (!g_stockPS) {
+                g_context->PSGetShader(&g_stockPS, nullptr, nullptr);
+            }
+            g_context->PSSetShader(g_atlasCoveragePS, nullptr, 0);
+            if (g_atlasSampler) {
+                g_context->PSSetSamplers(0, 1, &g_atlasSampler);
+            }
+        } else if (g_stockPS) {
+            // Leave the sampler alone; particle sprites set their own before this
+            g_context->PSSetShader(g_stockPS, nullptr, 0);
+        }
+    }
+
+    /// Add the name, level, title and ornament fonts at indices 0-3.
+    static void AddFonts(ImFontAtlas* fonts)
+    {
+        // Load custom fonts for different text elements
+        // Character range: Basic Latin + Latin-1 Supplement
+        static const ImWchar ranges[] = { 0x0020, 0x00FF, 0, };
+
+        // Font config: High oversampling for quality when scaling down
+        // Fonts can render at 25%
+        ImFontConfig config;
+        config.OversampleH = 4;     // High horizontal oversampling for scaled text
+        config.OversampleV = 4;     // High vertical oversampling for scaled text
+        config.PixelSnapH = false;  // Disable pixel snapping for smooth subpixel rendering
+
+        // Font Index 0: Name font
+        ImFont* nameFont = fonts->AddFontFromFileTTF(Settings::NameFontPath.c_str(), Settings::NameFontSize, &config, ranges);
+        if (!nameFont) {
+            // Fallback to default font if custom font fails to load
+            fonts->AddFontDefault();
+        }
+
+        // Font Index 1: Level font
+        ImFont* levelFont = fonts->AddFontFromFileTTF(Settings::LevelFontPath.c_str(), Settings::LevelFontSize, &config, ranges);
+        if (!levelFont) {
+            fonts->AddFontDefault();
+        }
+
+        // Font Index 2: Title font
+        ImFont* titleFont = fonts->AddFontFromFileTTF(Settings::TitleFontPath.c_str(), Settings::TitleFontSize, &config, ranges);
+        if (!titleFont) {
+            fonts->AddFontDefault();
+        }
+
+        // Font Index 3: Ornament font
+        if (!Settings::OrnamentFontPath.empty()) {
+            ImFont* ornamentFont = fonts->AddFontFromFileTTF(Settings::OrnamentFontPath.c_str(), Settings::OrnamentFontSize, &config, ranges);
+            if (!ornamentFont) {
+                fonts->AddFontDefault();
+            }
+        } else {
+            // Add placeholder so font indices stay consistent
+            fonts->AddFontDefault();
+        }
+    }
+
+    /// True if colored glyphs or images packed as custom rects share the font atlas
+    static bool AtlasHasColorPixels(const ImFontAtlas* atlas)
+    {
+        if (atlas->TexPixelsUseColors) return true;
+        for (int i = 0; i < atlas->CustomRects.Size; ++i) {
+            // ImGui's own cursor and line rects are white, coverage only
+            if (i != atlas->PackIdMouseCursors && i != atlas->PackIdLines) return true;
+        }
+        return false;
+    }
+
+    /// Insert shader switches so commands sampling the alpha-only atlas use the
+    /// coverage shader and every other texture keeps ImGui's shader.
+    static void RouteAtlasShader(ImDrawData* drawData)
+    {
+        if (!drawData || !g_atlasCoveragePS || !g_alphaAtlasTex) return;
+
+        // Render state setup binds ImGui's shader once for the whole draw data
+        bool coverageBound = false;
+        for (int n = 0; n < drawData->CmdListsCount; ++n) {
+            ImVector<ImDrawCmd>& cmds = drawData->CmdLists[n]->CmdBuffer;
+            for (int i = 0; i < cmds.Size; ++i) {
+                const ImDrawCmd& cmd = cmds[i];
+                if (cmd.UserCallback) {
+                    if (cmd.UserCallback == ImDrawCallback_ResetRenderState) coverageBound = false;
+                    continue;
+                }
+
+                const bool wantCoverage = cmd.GetTexID() == g_alphaAtlasTex;
+                if (wantCoverage == coverageBound) continue;
+
+                ImDrawCmd toggle = cmd;
+                toggle.UserCallback = SetAtlasShaderCallback;
+                toggle.UserCallbackData = wantCoverage ? g_atlasCoveragePS : nullptr;
+                toggle.ElemCount = 0;
+                cmds.insert(cmds.Data + i, toggle);
+                ++i;
+                coverageBound = wantCoverage;
+            }
+        }
+    }
+
     /// Original Present function pointer
     using PresentFn = HRESULT(WINAPI*)(IDXGISwapChain*, UINT, UINT);
     PresentFn g_originalPresent = nullptr;
@@ -96,7 +270,8 @@ namespace Hooks
             g_device = device;
             g_context = context;
 
-            // Create ImGui context for our overlay
+            // Create ImGui context for our overlay, counting its allocations
+            ImGui::SetAllocatorFunctions(FrameAllocations::Alloc, FrameAllocations::Free);
             ImGui::CreateContext();
 
             // Configure ImGui I/O settings
@@ -104,47 +279,9 @@ namespace Hooks
             io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;  // Enable keyboard navigation
             io.MouseDrawCursor = false;                            // Do not draw ImGui cursor
             io.IniFilename = nullptr;                              // Disable imgui.ini file
+            io.ConfigMemoryCompactTimer = -1.0f;                   // Keep buffers of hidden windows
 
-            // Load custom fonts for different text elements
-            // Character range: Basic Latin + Latin-1 Supplement
-            static const ImWchar ranges[] = { 0x0020, 0x00FF, 0, };
-            
-            // Font config: High oversampling for quality when scaling down
-            // Fonts can render at 25%
-            ImFontConfig config;
-            config.OversampleH = 4;     // High horizontal oversampling for scaled text
-            config.OversampleV = 4;     // High vertical oversampling for scaled text
-            config.PixelSnapH = false;  // Disable pixel snapping for smooth subpixel rendering
-
-            // Font Index 0: Name font
-            ImFont* nameFont = io.Fonts->AddFontFromFileTTF(Settings::NameFontPath.c_str(), Settings::NameFontSize, &config, ranges);
-            if (!nameFont) {
-                // Fallback to default font if custom font fails to load
-                io.Fonts->AddFontDefault();
-            }
-
-            // Font Index 1: Level font
-            ImFont* levelFont = io.Fonts->AddFontFromFileTTF(Settings::LevelFontPath.c_str(), Settings::LevelFontSize, &config, ranges); 
-            if (!levelFont) {
-                io.Fonts->AddFontDefault();
-            }
-
-            // Font Index 2: Title font
-            ImFont* titleFont = io.Fonts->AddFontFromFileTTF(Settings::TitleFontPath.c_str(), Settings::TitleFontSize, &config, ranges);
-            if (!titleFont) {
-                io.Fonts->AddFontDefault();
-            }
-
-            // Font Index 3: Ornament font
-            if (!Settings::OrnamentFontPath.empty()) {
-                ImFont* ornamentFont = io.Fonts->AddFontFromFileTTF(Settings::OrnamentFontPath.c_str(), Settings::OrnamentFontSize, &config, ranges);
-                if (!ornamentFont) {
-                    io.Fonts->AddFontDefault();
-                }
-            } else {
-                // Add placeholder so font indices stay consistent
-                io.Fonts->AddFontDefault();
-            }
+            AddFonts(io.Fonts);
 
             // Initialize ImGui backends for Win32 and DirectX 11
             if (!ImGui_ImplWin32_Init(desc.OutputWindow)) {
@@ -153,6 +290,7 @@ namespace Hooks
             if (!ImGui_ImplDX11_Init(device, context)) {
                 return;
             }
+            CreateAtlasCoverageShader(device);
 
             // Store swap chain and hook Present for post-upscaler rendering
             g_swapChain = swapChain;
@@ -180,50 +318,83 @@ namespace Hooks
     {
         if (!initialized.load(std::memory_order_acquire)) return;
 
+        auto& meter = FrameAllocations::OverlayMeter();
+        meter.BeginFrame(FrameAllocations::Totals().allocations);
+
         try {
             // Start new ImGui frame
             ImGui_ImplDX11_NewFrame();
             ImGui_ImplWin32_NewFrame();
 
-            // Generate mipmapped font atlas on first frame
+            // Settings reload between frames; the atlas can only change outside one
+            const auto changes = Renderer::ReloadSettings();
+            if (changes & SettingsWatch::kFonts) {
+                auto& io = ImGui::GetIO();
+                io.Fonts->Clear();
+                AddFonts(io.Fonts);
+                mipmapsGenerated.store(false);  // Upload below
+            }
+            if (changes & SettingsWatch::kParticleTextures) {
+                particleTexturesLoaded.store(false);  // Load below if now enabled
+            }
+
+            // Upload the font atlas with a prebuilt mip chain on first frame.
+            // Coverage-only atlases use one byte per texel; see FontAtlas.
             if (!mipmapsGenerated.exchange(true) && g_device && g_context) {
                 auto& io = ImGui::GetIO();
+                const auto format = FontAtlas::ChooseFormat(AtlasHasColorPixels(io.Fonts), g_atlasCoveragePS != nullptr);
+                const bool alphaOnly = format == FontAtlas::Format::Alpha8;
+
                 unsigned char* pixels = nullptr;
                 int width = 0, height = 0;
-                io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+                if (alphaOnly) {
+                    io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+                } else {
+                    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+                }
 
-                if (pixels && width > 0 && height > 0) {
-                    int mipLevels = 1;
-                    int maxDim = (width > height) ? width : height;
-                    while (maxDim > 1) { maxDim >>= 1; mipLevels++; }
+                const auto image = FontAtlas::Build(pixels, width, height, format);
+                if (!image.Empty()) {
+                    const auto mipLevels = static_cast<UINT>(image.levels.size());
+                    const DXGI_FORMAT dxgiFormat = alphaOnly ? DXGI_FORMAT_R8_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
 
                     D3D11_TEXTURE2D_DESC texDesc = {};
                     texDesc.Width = width;
                     texDesc.Height = height;
                     texDesc.MipLevels = mipLevels;
                     texDesc.ArraySize = 1;
-                    texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+                    texDesc.Format = dxgiFormat;
                     texDesc.SampleDesc.Count = 1;
-                    texDesc.Usage = D3D11_USAGE_DEFAULT;
-                    texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
-                    texDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+                    texDesc.Usage = D3D11_USAGE_IMMUTABLE;
+                    texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
-                    ID3D11Texture2D* fontTexture = nullptr;
-                    if (SUCCEEDED(g_device->CreateTexture2D(&texDesc, nullptr, &fontTexture))) {
-                        g_context->UpdateSubresource(fontTexture, 0, nullptr, pixels, width * 4, 0);
+                    std::vector<D3D11_SUBRESOURCE_DATA> initData(mipLevels);
+                    for (UINT i = 0; i < mipLevels; ++i) {
+                        initData[i].pSysMem = image.Data(i);
+                        initData[i].SysMemPitch = image.levels[i].RowPitch(format);
+                    }
 
+                    ID3D11Texture2D* fontTexture = nullptr;
+                    if (SUCCEEDED(g_device->CreateTexture2D(&texDesc, initData.data(), &fontTexture))) {
                         D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-                        srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+                        srvDesc.Format = dxgiFormat;
                         srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
                         srvDesc.Texture2D.MipLevels = mipLevels;
 
                         ID3D11ShaderResourceView* fontSRV = nullptr;
                         if (SUCCEEDED(g_device->CreateShaderResourceView(fontTexture, &srvDesc, &fontSRV))) {
-                            g_context->GenerateMips(fontSRV);
                             if (io.Fonts->TexID) {
                                 ((ID3D11ShaderResourceView*)io.Fonts->TexID)->Release();
                             }
                             io.Fonts->SetTexID((ImTextureID)fontSRV);
+                            g_alphaAtlasTex = alphaOnly ? (ImTextureID)fontSRV : ImTextureID{};
+
+                            // The texture is immutable, the CPU copies are no longer needed
+                            io.Fonts->ClearTexData();
+
+                            SKSE::log::info("Hooks: Font atlas {}x{} {}, {} mips, {} KB",
+                                            width, height, alphaOnly ? "R8" : "RGBA8",
+                                            mipLevels, image.ByteSize() / 1024);
                         }
                         fontTexture->Release();
                     }
@@ -256,6 +427,7 @@ namespace Hooks
             // Finalize and render
             ImGui::EndFrame();
             ImGui::Render();
+            RouteAtlasShader(ImGui::GetDrawData());
             ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 
             // Mark that overlay was rendered this frame
@@ -263,6 +435,12 @@ namespace Hooks
         } catch (...) {
             // Silently handle errors to maintain game stability
         }
+
+        // A steady frame should reuse every buffer; report the first one that does not
+        const auto allocations = meter.EndFrame(FrameAllocations::Totals().allocations);
+        if (meter.Warm() && allocations > 0 && meter.AllocatingFrames() == 1) {
+            SKSE::log::warn("Hooks: Steady overlay frame made {} ImGui allocations", allocations);
+        }
     }
 
     /// Present hook, safety net for overlay rendering.
@@ -292,8 +470,8 @@ namespace Hooks
             shouldRenderOverlay.store(false, std::memory_order_release);
             overlayRenderedThisFrame.store(false, std::memory_order_release);
 
-            // Early exit checks
-            if (!initialized.load(std::memory_order_acquire) || !CanDrawOverlay()) {
+            // Early exit checks; one atomic load while a menu is open
+            if (!initialized.load(std::memory_order_acquire) || Renderer::IsMenuBlockingRT()) {
                 func(a_menu);
                 return;
             }
@@ -304,13 +482,10 @@ namespace Hooks
                 return;
             }
 
-            // Update render thread state to queue actor data updates
+            // Update render thread state to queue actor data updates;
+            // the game thread also refreshes the loading, cell and combat state
             Renderer::TickRT();
 
-            // Check if we need to apply appearance template
-            extern void Renderer_CheckAppearanceTemplate();
-            Renderer_CheckAppearanceTemplate();
-
             // Check if overlay should be rendered
             bool shouldRender = Renderer::IsOverlayAllowedRT();
             shouldRenderOverlay.store(shouldRender, std::memory_order_release);
@@ -329,6 +504,21 @@ namespace Hooks
         static inline std::size_t idx = 0x6;
     };
 
+    // Hook for the main loop update, scans actors at a fixed point of the
+    // game frame instead of wherever SKSE drains its task queue
+    struct MainUpdate
+    {
+        static void thunk(RE::Main* a_this, float a_delta)
+        {
+            func(a_this, a_delta);
+            Renderer::UpdateMainLoop();
+            AppearanceTemplate::PollTemplatePipeline();
+        }
+
+        /// Original function pointer
+        static inline REL::Relocation<decltype(thunk)> func;
+    };
+
     void Install()
     {
         // Hook D3D11 device creation for ImGui initialization
@@ -338,6 +528,10 @@ namespace Hooks
         // Hook HUD post-display, renders overlay after game HUD is complete
         stl::write_vfunc<RE::HUDMenu, PostDisplay>();
 
+        // Hook the main loop update, runs the actor scan on the game thread
+        REL::Relocation<std::uintptr_t> mainUpdate{ RELOCATION_ID(35565, 36564), OFFSET(0x748, 0xC26) };
+        stl::write_thunk_call<MainUpdate>(mainUpdate.address());
+
         SKSE::log::info("Hooks: Installed");
     }
 }
@@ -10,7 +10,8 @@
  *
  * Provides low-level integration with Skyrim's rendering pipeline using
  * SKSE's trampoline system for safe function hooking. Intercepts D3D11
- * initialization and HUD rendering to inject ImGui overlay drawing.
+ * initialization and HUD rendering to inject ImGui overlay drawing, and
+ * the main loop update to collect actor data on the game thread.
  *
  * ## :material-hook: Hook Architecture
  *
@@ -30,6 +31,7 @@
  *         Hook[Hooks::Install]:::hook
  *         D3D[CreateD3DAndSwapChain]:::hook
  *         HUD[HUDMenu::PostDisplay]:::hook
+ *         MAIN[Main::Update]:::hook
  *     end
  *     subgraph R[Rendering]
  *         direction TB
@@ -38,6 +40,7 @@
  *     Game -->|SKSEPlugin_Load| Hook
  *     Hook -->|Install thunk call hook| D3D
  *     Hook -->|Install vtable hook| HUD
+ *     Hook -->|Install thunk call hook| MAIN
  *     N[Runtime Execution]:::note
  *     Hook --- N --- Renderer
  *     Game -->|Create swap chain| D3D
@@ -48,6 +51,8 @@
  *         Game2[Game]:::core -->|PostDisplay| HUD2[HUDMenu::PostDisplay]:::hook
  *         HUD2 -->|Call original function| HUD2
  *         HUD2 -->|Draw overlays| Renderer2[Renderer::Draw]:::render
+ *         Game3[Game]:::core -->|Update| MAIN2[Main::Update]:::hook
+ *         MAIN2 -->|Scan actors| Scan[Renderer::UpdateMainLoop]:::render
  *     end
  * ```
  *
@@ -57,6 +62,7 @@
  * |-----------------------------------------------|------------|----------------------|-----------------------------|
  * | `BSGraphics::Renderer::CreateD3DAndSwapChain` | Thunk call | REL_ID(75595, 77226) | D3D11 device/swapchain init |
  * |                        `HUDMenu::PostDisplay` |   VTable   |      vtable[6]       | Per-frame overlay rendering |
+ * |                                `Main::Update` | Thunk call | REL_ID(35565, 36564) | Per-frame actor scan        |
  *
  * ## :material-hook: Hook Flow
  *
@@ -97,9 +103,13 @@
  *
  * ## :material-lock-outline: Thread Safety
  *
- * All hooks execute on the **render thread**. The HUDMenu hook triggers
+ * The D3D and HUD hooks execute on the **render thread**; `Main::Update`
+ * runs on the **game thread** and only touches the atomics of
+ * `SnapshotSchedule` unless a scan is due. The HUDMenu hook triggers
  * after the game's HUD rendering, ensuring proper draw order and avoiding
- * race conditions with game state.
+ * race conditions with game state. While a tracked menu is open the
+ * PostDisplay hook returns after one atomic load (see `OverlayState`),
+ * before any ImGui or snapshot work.
  *
  * @note Trampoline must be allocated before calling `Install()`.
  * @note Hook failures are logged but don't prevent plugin loading.
@@ -111,20 +121,22 @@ namespace Hooks
     /**
      * Install all required game hooks.
      *
-     * Installs hooks for D3D11 initialization and HUD rendering. Must be called
-     * once during plugin initialization in `SKSEPlugin_Load`.
+     * Installs hooks for D3D11 initialization, HUD rendering and the main
+     * loop update. Must be called once during plugin initialization in
+     * `SKSEPlugin_Load`.
      *
      * **Installation Sequence:**
-     * 1. Allocate trampoline memory (14 bytes minimum)
+     * 1. Allocate trampoline memory (28 bytes minimum, 14 per thunk call)
      * 2. Hook `BSGraphics::Renderer::CreateD3DAndSwapChain`
      * 3. Hook `HUDMenu::PostDisplay` virtual function
+     * 4. Hook the update call in `Main::Update`
      *
      * If hooks fail to install, errors are logged via SKSE's logger.
      * The plugin will continue loading but overlay will not function.
      *
      * ```cpp
      * // In SKSEPlugin_Load:
-     * SKSE::AllocTrampoline(14);
+     * SKSE::AllocTrampoline(28);
      * Hooks::Install();
      * ```
      *
@@ -133,6 +145,7 @@ namespace Hooks
      *
      * @post D3D11 initialization will trigger ImGui setup.
      * @post HUD rendering will include overlay drawing.
+     * @post Each game frame gives the renderer a chance to scan actors.
      *
      * @see Renderer::Draw, Renderer::TickRT
      */
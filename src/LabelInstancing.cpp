@@ -0,0 +1,124 @@
+#include "LabelInstancing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LabelInstancing
+{
+    int ScaleBucket(float scale)
+    {
+        return static_cast<int>(std::lround(std::log2((std::max)(scale, 1e-3f)) * kScaleBucketsPerOctave));
+    }
+
+    float PhaseSeed(std::uint32_t formID, bool quantized)
+    {
+        if (!quantized)
+            return static_cast<float>(formID & 1023) / 1023.0f;
+
+        // Hash first so sequential form IDs spread over the buckets
+        const std::uint32_t h = formID * 0x9E3779B1u;
+        const auto bucket = static_cast<std::uint32_t>((static_cast<std::uint64_t>(h) * kPhaseBuckets) >> 32);
+        return static_cast<float>(bucket) / static_cast<float>(kPhaseBuckets);
+    }
+
+    void KeyBuilder::Mix(const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            m_hash ^= bytes[i];
+            m_hash *= 0x100000001B3ull;
+        }
+    }
+
+    KeyBuilder& KeyBuilder::Add(std::string_view text)
+    {
+        // Length first, so ("ab", "c") and ("a", "bc") differ
+        const auto size = static_cast<std::uint32_t>(text.size());
+        Mix(&size, sizeof(size));
+        Mix(text.data(), text.size());
+        return *this;
+    }
+
+    KeyBuilder& KeyBuilder::Add(std::uint32_t value)
+    {
+        Mix(&value, sizeof(value));
+        return *this;
+    }
+
+    bool CanInstance(const Template& tpl, float alpha)
+    {
+        return tpl.alpha > 0.0f && alpha <= tpl.alpha * kMaxAlphaGain;
+    }
+
+    Transform MakeTransform(const Template& tpl, float anchorX, float anchorY, float scale, float alpha)
+    {
+        Transform t;
+        t.fromX = tpl.anchorX;
+        t.fromY = tpl.anchorY;
+        t.toX = anchorX;
+        t.toY = anchorY;
+        t.scale = tpl.scale > 0.0f ? scale / tpl.scale : 1.0f;
+        t.alphaMul = tpl.alpha > 0.0f
+            ? static_cast<std::uint32_t>(std::lround(alpha / tpl.alpha * 256.0f))
+            : 256u;
+        return t;
+    }
+
+    void Registry::BeginFrame()
+    {
+        m_size = 0;
+        if (++m_frame == 0)
+        {
+            // Stamps wrapped; old slots could read as current
+            for (Slot& slot : m_slots)
+                slot.frame = 0;
+            m_frame = 1;
+        }
+    }
+
+    // Slot holding `key`, or the empty slot where it would go
+    std::size_t Registry::Probe(std::uint64_t key) const
+    {
+        const std::size_t mask = m_slots.size() - 1;
+        std::size_t i = static_cast<std::size_t>((key ^ (key >> 29)) * 0xBF58476D1CE4E5B9ull) & mask;
+        while (m_slots[i].frame == m_frame && m_slots[i].key != key)
+            i = (i + 1) & mask;
+        return i;
+    }
+
+    const Template* Registry::Find(std::uint64_t key) const
+    {
+        if (m_slots.empty())
+            return nullptr;
+        const Slot& slot = m_slots[Probe(key)];
+        return slot.frame == m_frame ? &slot.tpl : nullptr;
+    }
+
+    void Registry::Add(std::uint64_t key, const Template& tpl)
+    {
+        if ((m_size + 1) * 2 > m_slots.size())
+            Grow();
+
+        Slot& slot = m_slots[Probe(key)];
+        if (slot.frame == m_frame)
+            return;
+
+        slot.key = key;
+        slot.frame = m_frame;
+        slot.tpl = tpl;
+        ++m_size;
+        ++m_stats.built;
+    }
+
+    void Registry::Grow()
+    {
+        std::vector<Slot> old(std::max<std::size_t>(m_slots.size() * 2, 64));
+        old.swap(m_slots);
+        for (const Slot& slot : old)
+        {
+            if (slot.frame == m_frame)
+                m_slots[Probe(slot.key)] = slot;
+        }
+    }
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace LabelInstancing
+ * @brief Shared text geometry for identical nameplates.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * Crowds are full of identical plates: twenty "Whiterun Guard" labels at
+ * level 20 with the same tier and effect. Building each one runs glyph
+ * layout for every pass (glow, shadow, outline, effect), yet the resulting
+ * vertex streams differ only by translation, scale and alpha. With
+ * instancing the first label of a group builds its text block as usual and
+ * registers it as the group's template; every other member copies the
+ * template's vertices and indices through one transform.
+ *
+ * ## :material-content-copy: Groups
+ *
+ * A group key hashes everything that shapes the text block:
+ *
+ * | Part           | Why                                                   |
+ * |----------------|-------------------------------------------------------|
+ * | Segment texts  | Name and level as formatted                           |
+ * | Title text     | Tier or special title                                 |
+ * | Tier, dispo    | Effect and colors                                     |
+ * | Scale bucket   | Keeps the copy within a rounding step of a real build |
+ * | Title shown    | Title hidden by LOD at far distance                   |
+ * | Outline bucket | Distance outline scaling, when enabled                |
+ * | Phase seed     | Only for effects that use the per-actor phase         |
+ *
+ * The player's label and labels still in their typewriter reveal are never
+ * grouped. A template is only registered if its text lies inside the clip
+ * rect, because ImGui drops glyphs that are clipped entirely.
+ *
+ * ## :material-vector-polyline: Transform
+ *
+ * With template anchor $a_0$, scale $s_0$ and alpha $\alpha_0$, member $i$
+ * gets
+ *
+ * $$p' = a_i + (p - a_0)\,\frac{s_i}{s_0}, \qquad A' = \min\left(255, A\,\frac{\alpha_i}{\alpha_0}\right)$$
+ *
+ * Text layout and outline widths are linear in the font size, and every
+ * label color carries the label alpha linearly, so a copy matches a fresh
+ * build up to pixel truncation. Alpha gains above `kMaxAlphaGain` would
+ * magnify rounding of faint templates, so such members build their own text.
+ *
+ * ## :material-sine-wave: Phase Seeds
+ *
+ * Shimmer-style effects offset their animation by a per-actor phase seed so
+ * neighbours do not pulse in sync. Seeds are drawn from `kPhaseBuckets`
+ * values while instancing is on, which still desynchronizes a crowd but lets
+ * members with the same seed share colors exactly instead of recoloring
+ * every copy.
+ *
+ * @see Renderer::Draw, Settings::EnableInstancing
+ */
+namespace LabelInstancing
+{
+    /// Scale buckets per doubling of the text scale (about 2% apart).
+    inline constexpr float kScaleBucketsPerOctave = 32.0f;
+
+    /// Distinct animation phase seeds while instancing.
+    inline constexpr std::uint32_t kPhaseBuckets = 8;
+
+    /// Largest alpha gain a copy may apply to its template.
+    inline constexpr float kMaxAlphaGain = 2.0f;
+
+    /// Group bucket of a text scale.
+    int ScaleBucket(float scale);
+
+    /// Animation phase seed in [0, 1) of an actor, quantized to `kPhaseBuckets` if `quantized`.
+    float PhaseSeed(std::uint32_t formID, bool quantized);
+
+    /// Incremental FNV-1a hash of the parts of a group key.
+    class KeyBuilder
+    {
+    public:
+        KeyBuilder& Add(std::string_view text);
+        KeyBuilder& Add(std::uint32_t value);
+        KeyBuilder& Add(int value) { return Add(static_cast<std::uint32_t>(value)); }
+        KeyBuilder& Add(bool value) { return Add(static_cast<std::uint32_t>(value)); }
+
+        std::uint64_t Value() const { return m_hash; }
+
+    private:
+        void Mix(const void* data, std::size_t size);
+
+        std::uint64_t m_hash{0xCBF29CE484222325ull};
+    };
+
+    /// Text block of a group's first member, as ranges of the draw list being built.
+    struct Template
+    {
+        std::uint32_t vtxStart{0};
+        std::uint32_t vtxCount{0};
+        std::uint32_t idxStart{0};
+        std::uint32_t idxCount{0};
+        std::uint32_t idxBase{0};  ///< Index value that refers to the first template vertex
+        float anchorX{0.0f};
+        float anchorY{0.0f};
+        float scale{1.0f};
+        float alpha{1.0f};
+    };
+
+    /// Template-to-member mapping for `CopyVertices`.
+    struct Transform
+    {
+        float fromX{0.0f};
+        float fromY{0.0f};
+        float toX{0.0f};
+        float toY{0.0f};
+        float scale{1.0f};
+        std::uint32_t alphaMul{256};  ///< Alpha gain in 8.8 fixed point
+    };
+
+    /// True if a member at `alpha` may copy `tpl`.
+    bool CanInstance(const Template& tpl, float alpha);
+
+    Transform MakeTransform(const Template& tpl, float anchorX, float anchorY, float scale, float alpha);
+
+    /**
+     * Copy template vertices to a member.
+     *
+     * `Vtx` needs `pos`, `uv` and a packed `col` with alpha in the top byte
+     * (`ImDrawVert`). `src` and `dst` must not overlap.
+     */
+    template <class Vtx>
+    void CopyVertices(const Vtx* src, Vtx* dst, std::size_t count, const Transform& t)
+    {
+        const float ox = t.toX - t.fromX * t.scale;
+        const float oy = t.toY - t.fromY * t.scale;
+        const float s = t.scale;
+
+        if (t.alphaMul == 256)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i].pos.x = src[i].pos.x * s + ox;
+                dst[i].pos.y = src[i].pos.y * s + oy;
+                dst[i].uv = src[i].uv;
+                dst[i].col = src[i].col;
+            }
+            return;
+        }
+
+        const std::uint32_t mul = t.alphaMul;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint32_t c = src[i].col;
+            std::uint32_t a = ((c >> 24) * mul + 128) >> 8;
+            a = a > 255 ? 255 : a;
+            dst[i].pos.x = src[i].pos.x * s + ox;
+            dst[i].pos.y = src[i].pos.y * s + oy;
+            dst[i].uv = src[i].uv;
+            dst[i].col = (c & 0x00FFFFFFu) | (a << 24);
+        }
+    }
+
+    /// Copy template indices, rebasing them from `fromBase` to `toBase`.
+    template <class Idx>
+    void CopyIndices(const Idx* src, Idx* dst, std::size_t count, std::uint32_t fromBase, std::uint32_t toBase)
+    {
+        const std::uint32_t delta = toBase - fromBase;  // wraps for toBase < fromBase
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<Idx>(static_cast<std::uint32_t>(src[i]) + delta);
+    }
+
+    /// Template counters of a registry since it was created.
+    struct Stats
+    {
+        std::uint64_t built{0};      ///< Text blocks built and registered
+        std::uint64_t instanced{0};  ///< Text blocks copied from a template
+    };
+
+    /**
+     * Templates of the frame being built.
+     *
+     * Not synchronized; one per thread building labels. Template ranges refer
+     * to a single draw list, so call `BeginFrame` whenever a new frame starts
+     * building. Slots live in one open-addressed array stamped with the frame
+     * they were written in, so starting a frame empties the table without
+     * touching it and a steady scene does not allocate.
+     */
+    class Registry
+    {
+    public:
+        void BeginFrame();
+
+        const Template* Find(std::uint64_t key) const;
+
+        /// Register `tpl` for `key` unless the group already has a template.
+        void Add(std::uint64_t key, const Template& tpl);
+
+        void CountInstance() { ++m_stats.instanced; }
+
+        std::size_t Size() const { return m_size; }
+        std::size_t Capacity() const { return m_slots.size(); }
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        struct Slot
+        {
+            std::uint64_t key{0};
+            std::uint32_t frame{0};  ///< Frame the slot was written in; other frames read as empty
+            Template tpl;
+        };
+
+        std::size_t Probe(std::uint64_t key) const;
+        void Grow();
+
+        std::vector<Slot> m_slots;  // power-of-two size, at most half full
+        std::size_t m_size{0};
+        std::uint32_t m_frame{1};
+        Stats m_stats;
+    };
+}
@@ -0,0 +1,60 @@
+#include "LabelText.h"
+
+#include <charconv>
+
+namespace LabelText
+{
+    void Format(std::string& out, std::string_view fmt, std::string_view name, int level, const char* title)
+    {
+        out.clear();
+        for (std::size_t i = 0; i < fmt.size(); ++i)
+        {
+            if (fmt[i] == '%' && i + 1 < fmt.size())
+            {
+                const char key = fmt[i + 1];
+                if (key == 'n')
+                {
+                    out.append(name);
+                    ++i;
+                    continue;
+                }
+                if (key == 'l')
+                {
+                    char digits[12];
+                    const auto result = std::to_chars(digits, digits + sizeof(digits), level);
+                    out.append(digits, result.ptr);
+                    ++i;
+                    continue;
+                }
+                if (key == 't' && title)
+                {
+                    out.append(title);
+                    ++i;
+                    continue;
+                }
+            }
+            out.push_back(fmt[i]);
+        }
+    }
+
+    static char Lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool ContainsNoCase(std::string_view haystack, std::string_view needle)
+    {
+        if (needle.size() > haystack.size())
+            return false;
+
+        for (std::size_t start = 0; start + needle.size() <= haystack.size(); ++start)
+        {
+            std::size_t i = 0;
+            while (i < needle.size() && Lower(haystack[start + i]) == Lower(needle[i]))
+                ++i;
+            if (i == needle.size())
+                return true;
+        }
+        return false;
+    }
+}
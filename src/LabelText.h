@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace LabelText
+ * @brief Allocation-free text helpers for building nameplate strings.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * Every label formats its segments and title each frame and matches its name
+ * against the special title keywords. These helpers write into caller-owned
+ * strings, which keep their capacity from frame to frame, and compare without
+ * building lowercase copies.
+ *
+ * ## :material-format-text: Placeholders
+ *
+ * | Placeholder | Replaced with              |
+ * |-------------|----------------------------|
+ * | `%n`        | Actor display name         |
+ * | `%l`        | Actor level                |
+ * | `%t`        | Tier or special title      |
+ *
+ * Placeholders are replaced in a single pass, so text substituted for one
+ * placeholder is never scanned for another. Without a title, `%t` is kept
+ * as written.
+ *
+ * @see Renderer::Draw, Settings::DisplayFormat, Settings::TitleFormat
+ */
+namespace LabelText
+{
+    /**
+     * Replace the placeholders of `fmt` into `out`.
+     *
+     * `out` is overwritten; its capacity is reused.
+     *
+     * @param title Title for `%t`, or null to keep `%t`
+     */
+    void Format(std::string& out, std::string_view fmt, std::string_view name, int level,
+                const char* title = nullptr);
+
+    /// True if `haystack` contains `needle`, comparing ASCII letters case-insensitively.
+    bool ContainsNoCase(std::string_view haystack, std::string_view needle);
+}
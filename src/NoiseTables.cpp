@@ -0,0 +1,162 @@
+#include "NoiseTables.h"
+
+#include <bit>
+#include <cstddef>
+
+namespace NoiseTables
+{
+    namespace
+    {
+        constexpr float kTwoPi = 6.28318530718f;
+
+        // Cell offsets of the star, sparkle, dust and flare layers
+        constexpr std::int32_t kSparkleOffsets[kSparkleLayers] = {0, 50, 100, 200};
+
+        inline std::int32_t Wrap(std::int32_t i, int period)
+        {
+            if (period <= 0)
+                return i;
+            const std::int32_t m = i % period;
+            return m < 0 ? m + period : m;
+        }
+
+        Tables& Storage()
+        {
+            static Tables tables;
+            return tables;
+        }
+    }
+
+    float Lattice(std::int32_t x, std::int32_t y)
+    {
+        std::uint32_t h = static_cast<std::uint32_t>(x) * 0x8DA6B343u ^ static_cast<std::uint32_t>(y) * 0xD8163841u;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float CellHash(std::int32_t x, std::int32_t y)
+    {
+        std::size_t hash = static_cast<std::size_t>(x);
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6b;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35;
+        hash ^= hash >> 16;
+        hash ^= static_cast<std::size_t>(y) * 2654435761;
+        return static_cast<float>(hash & 0xFFFFFF) / 16777216.0f;
+    }
+
+    float ValueNoise(float x, float y, int period)
+    {
+        const float fx0 = std::floor(x);
+        const float fy0 = std::floor(y);
+        const auto ix = static_cast<std::int32_t>(fx0);
+        const auto iy = static_cast<std::int32_t>(fy0);
+        float fx = x - fx0;
+        float fy = y - fy0;
+        fx = fx * fx * fx * (fx * (fx * 6.0f - 15.0f) + 10.0f);
+        fy = fy * fy * fy * (fy * (fy * 6.0f - 15.0f) + 10.0f);
+
+        const auto x0 = Wrap(ix, period), x1 = Wrap(ix + 1, period);
+        const auto y0 = Wrap(iy, period), y1 = Wrap(iy + 1, period);
+        const float a = Lattice(x0, y0);
+        const float b = Lattice(x1, y0);
+        const float c = Lattice(x0, y1);
+        const float d = Lattice(x1, y1);
+        const float ab = a + (b - a) * fx;
+        const float cd = c + (d - c) * fx;
+        return ab + (cd - ab) * fy;
+    }
+
+    float Fbm(float x, float y, int period)
+    {
+        float total = 0.0f;
+        float amplitude = 1.0f;
+        float frequency = 1.0f;
+        float maxValue = 0.0f;
+        for (int i = 0; i < kFbmOctaves; ++i)
+        {
+            total += ValueNoise(x * frequency, y * frequency, period) * amplitude;
+            maxValue += amplitude;
+            amplitude *= 0.5f;
+            frequency *= 2.0f;
+        }
+        return total / maxValue;
+    }
+
+    float SparkleSeed(int layer, std::int32_t cx, std::int32_t cy)
+    {
+        const std::int32_t offset = kSparkleOffsets[layer];
+        return CellHash(cx + offset, cy + offset);
+    }
+
+    int NormalizeSize(int size)
+    {
+        if (size <= 0)
+            return 0;
+        if (size < kMinSize)
+            return kMinSize;
+        if (size > kMaxSize)
+            return kMaxSize;
+        return static_cast<int>(std::bit_floor(static_cast<unsigned>(size)));
+    }
+
+    void Tables::Build(int size)
+    {
+        *this = Tables{};
+        m_size = NormalizeSize(size);
+        if (m_size == 0)
+            return;
+
+        const auto n = static_cast<std::size_t>(m_size);
+        m_mask = static_cast<std::uint32_t>(m_size - 1);
+        m_sinScale = static_cast<float>(m_size) / kTwoPi;
+        m_texelsPerCell = static_cast<float>(m_size) / static_cast<float>(kPeriod);
+
+        m_sin.resize(n + 1);
+        for (std::size_t i = 0; i <= n; ++i)
+            m_sin[i] = std::sin(static_cast<float>(i) / m_sinScale);
+
+        // Sampled on texel corners; row and column N repeat 0 since the field tiles
+        m_noise.resize((n + 1) * (n + 1));
+        m_fbm.resize((n + 1) * (n + 1));
+        for (std::size_t y = 0; y <= n; ++y)
+        {
+            for (std::size_t x = 0; x <= n; ++x)
+            {
+                const float u = static_cast<float>(x % n) / m_texelsPerCell;
+                const float v = static_cast<float>(y % n) / m_texelsPerCell;
+                m_noise[y * (n + 1) + x] = ValueNoise(u, v, kPeriod);
+                m_fbm[y * (n + 1) + x] = NoiseTables::Fbm(u, v, kPeriod);
+            }
+        }
+
+        m_sparkle.resize(kSparkleLayers * n * n);
+        for (int layer = 0; layer < kSparkleLayers; ++layer)
+        {
+            for (std::size_t y = 0; y < n; ++y)
+            {
+                for (std::size_t x = 0; x < n; ++x)
+                {
+                    m_sparkle[(layer * n + y) * n + x] =
+                        NoiseTables::SparkleSeed(layer, static_cast<std::int32_t>(x), static_cast<std::int32_t>(y));
+                }
+            }
+        }
+    }
+
+    const Tables& Active()
+    {
+        return Storage();
+    }
+
+    void Configure(int size)
+    {
+        if (NormalizeSize(size) != Storage().Size())
+            Storage().Build(size);
+    }
+}
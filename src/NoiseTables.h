@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace NoiseTables
+ * @brief Periodic wave and noise tables sampled by the animated text effects.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * Aurora and Plasma evaluate several sines per vertex, Sparkle hashes four
+ * cell layers per vertex and custom effects evaluate value noise per vertex.
+ * These tables are built once when the settings are loaded; the kernels then
+ * sample them with one lookup and a linear or bilinear blend. Time scrolls
+ * the lookup coordinates, so the tables never change while animating.
+ *
+ * ## :material-grid: Tables
+ *
+ * | Table     | Contents                                        | Sampled by               |
+ * |-----------|-------------------------------------------------|--------------------------|
+ * | `Sin`     | One period of sine, linear lookup               | Aurora, Plasma, Sparkle  |
+ * | `Noise`   | Value noise over `kPeriod` x `kPeriod` cells    | `noise(x, y)` programs   |
+ * | `Fbm`     | `kFbmOctaves` octaves of that noise             | `fbm(x, y)` programs     |
+ * | `Sparkle` | Cell seeds of the four sparkle layers           | Sparkle                  |
+ *
+ * ## :material-tune: Quality
+ *
+ * `Settings::NoiseTableSize` sets $N$, the texels per table side, rounded
+ * down to a power of two in [`kMinSize`, `kMaxSize`]. The noise tables hold
+ * $N / \text{kPeriod}$ texels per lattice cell, and bilinear error falls
+ * with the square of that. The tables take about $24 N^2$ bytes (1.5 MiB at
+ * 256). Size 0 evaluates everything analytically as before.
+ *
+ * | Size | Max noise error | Max FBM error |
+ * |------|-----------------|---------------|
+ * | 128  | 0.063           | 0.097         |
+ * | 256  | 0.019           | 0.037         |
+ * | 512  | 0.004           | 0.019         |
+ *
+ * The noise fields are tileable: the lattice wraps every `kPeriod` cells and
+ * sparkle cells every $N$ cells, far more than one label spans.
+ *
+ * ## :material-lock-outline: Threading
+ *
+ * Sampling is read-only. Configure() rebuilds in place, so it runs only while
+ * no label is being built: at plugin load and in a reload after the frame
+ * pipeline was reset.
+ *
+ * @see TextEffects::AddTextAurora, TextEffects::AddTextPlasma,
+ *      TextEffects::AddTextSparkle, EffectProgram
+ */
+namespace NoiseTables
+{
+    inline constexpr int kPeriod = 32;         ///< Lattice cells per noise tile
+    inline constexpr int kFbmOctaves = 4;      ///< Octaves of `Fbm`, persistence 0.5
+    inline constexpr int kSparkleLayers = 4;   ///< Star, sparkle, dust and flare cells
+    inline constexpr int kMinSize = 64;        ///< Two texels per lattice cell
+    inline constexpr int kMaxSize = 2048;
+    inline constexpr int kDefaultSize = 256;
+
+    // ========== Analytic References ==========
+
+    /// Lattice hash of value noise, [0, 1).
+    float Lattice(std::int32_t x, std::int32_t y);
+
+    /// Cell hash of the sparkle layers, [0, 1).
+    float CellHash(std::int32_t x, std::int32_t y);
+
+    /**
+     * 2D value noise with quintic interpolation, [0, 1).
+     *
+     * @param period Lattice period in cells, 0 for none.
+     */
+    float ValueNoise(float x, float y, int period = 0);
+
+    /**
+     * Fractal Brownian motion of ValueNoise, normalized to [0, 1).
+     *
+     * Each octave doubles the frequency and halves the amplitude. With a
+     * period the sum tiles with that period too.
+     */
+    float Fbm(float x, float y, int period = 0);
+
+    /// Seed of sparkle cell (`cx`, `cy`) in `layer`, [0, 1).
+    float SparkleSeed(int layer, std::int32_t cx, std::int32_t cy);
+
+    /// Texels per side used for `size`: 0, or a power of two in [kMinSize, kMaxSize].
+    int NormalizeSize(int size);
+
+    // ========== Tables ==========
+
+    /**
+     * One set of tables. Every sampler falls back to the analytic version
+     * while the set is empty.
+     */
+    class Tables
+    {
+    public:
+        /// Build for `size` texels per side (see NormalizeSize); 0 frees the tables.
+        void Build(int size);
+
+        /// Texels per side, 0 when analytic.
+        int Size() const { return m_size; }
+
+        float Sin(float x) const
+        {
+            if (m_sin.empty())
+                return std::sin(x);
+            const float f = x * m_sinScale;
+            const float f0 = std::floor(f);
+            const auto i = static_cast<std::uint32_t>(static_cast<std::int32_t>(f0)) & m_mask;
+            return m_sin[i] + (m_sin[i + 1] - m_sin[i]) * (f - f0);
+        }
+
+        float Noise(float x, float y) const
+        {
+            return m_noise.empty() ? ValueNoise(x, y) : Bilinear(m_noise, x, y);
+        }
+
+        float Fbm(float x, float y) const
+        {
+            return m_fbm.empty() ? NoiseTables::Fbm(x, y) : Bilinear(m_fbm, x, y);
+        }
+
+        float SparkleSeed(int layer, std::int32_t cx, std::int32_t cy) const
+        {
+            if (m_sparkle.empty())
+                return NoiseTables::SparkleSeed(layer, cx, cy);
+            const auto x = static_cast<std::uint32_t>(cx) & m_mask;
+            const auto y = static_cast<std::uint32_t>(cy) & m_mask;
+            return m_sparkle[(static_cast<std::size_t>(layer) * m_size + y) * m_size + x];
+        }
+
+    private:
+        // Tables are (N + 1)^2 with the first row and column repeated, so the
+        // four taps need no wrap of their own
+        float Bilinear(const std::vector<float>& table, float x, float y) const
+        {
+            const float fx = x * m_texelsPerCell;
+            const float fy = y * m_texelsPerCell;
+            const float fx0 = std::floor(fx);
+            const float fy0 = std::floor(fy);
+            const auto ix = static_cast<std::uint32_t>(static_cast<std::int32_t>(fx0)) & m_mask;
+            const auto iy = static_cast<std::uint32_t>(static_cast<std::int32_t>(fy0)) & m_mask;
+            const float* row = table.data() + static_cast<std::size_t>(iy) * (m_size + 1) + ix;
+            const float wx = fx - fx0;
+            const float ab = row[0] + (row[1] - row[0]) * wx;
+            const float cd = row[m_size + 1] + (row[m_size + 2] - row[m_size + 1]) * wx;
+            return ab + (cd - ab) * (fy - fy0);
+        }
+
+        int m_size{0};
+        std::uint32_t m_mask{0};
+        float m_sinScale{0.0f};       ///< Table entries per radian
+        float m_texelsPerCell{0.0f};  ///< Noise texels per lattice cell
+
+        std::vector<float> m_sin;      ///< N + 1 entries over one period
+        std::vector<float> m_noise;    ///< (N + 1)^2
+        std::vector<float> m_fbm;      ///< (N + 1)^2
+        std::vector<float> m_sparkle;  ///< kSparkleLayers x N^2
+    };
+
+    /// Tables the effects sample; analytic until Configure() builds them.
+    const Tables& Active();
+
+    /**
+     * Rebuild the active tables if `size` changed.
+     *
+     * Only while no effect is being evaluated (see Threading).
+     */
+    void Configure(int size);
+}
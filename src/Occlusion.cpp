@@ -1,12 +1,218 @@
 #include "Occlusion.h"
+#include "OcclusionBVH.h"
 #include "Settings.h"
 
 #include <RE/A/Actor.h>
 #include <RE/P/PlayerCamera.h>
 #include <RE/P/PlayerCharacter.h>
+#include <RE/G/GridCellArray.h>
+#include <RE/S/ScriptEventSourceHolder.h>
+#include <RE/T/TESCellFullyLoadedEvent.h>
+#include <RE/T/TES.h>
+#include <RE/T/TESObjectCELL.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <unordered_map>
+#include <vector>
 
 namespace Occlusion
 {
+    namespace {
+        // Game check bookkeeping of one actor on the BVH backend
+        struct ActorCorrection {
+            OcclusionBVH::Correction correction;
+            std::uint32_t lastGameScan = 0;
+            std::uint32_t lastSeenScan = 0;
+        };
+
+        // Game thread only
+        struct StaticState {
+            std::vector<OcclusionBVH::Segment> segments;
+            std::unordered_map<RE::FormID, ActorCorrection> actors;
+            std::uint32_t scan = 1;
+            bool cellsCollected = false;  // Loaded cells handed to the worker since the backend was selected
+        };
+
+        // What the distance and behind-camera tests decide without a raycast
+        enum class Quick {
+            Visible,
+            Occluded,
+            NeedsRay
+        };
+    }
+
+    static OcclusionBVH::Worker& GetWorker() {
+        // Never destroyed: joining the BVH thread during DLL unload could deadlock
+        static auto *worker = new OcclusionBVH::Worker();
+        return *worker;
+    }
+
+    static StaticState& GetStaticState() {
+        static StaticState state;
+        return state;
+    }
+
+    static bool IsStaticBackend()
+    {
+        return Settings::EnableOcclusionCulling &&
+               static_cast<Backend>(Settings::OcclusionBackend) == Backend::Static;
+    }
+
+    /// World bounds of a reference that hides what is behind it, if it does.
+    static bool GetOccluderBox(RE::TESObjectREFR& ref, OcclusionBVH::Box& box)
+    {
+        if (ref.IsDisabled() || ref.IsDeleted())
+        {
+            return false;
+        }
+
+        // Buildings, walls, rocks and large clutter. Doors open, trees and
+        // actors move or can be seen through.
+        auto* base = ref.GetBaseObject();
+        if (!base)
+        {
+            return false;
+        }
+        switch (base->GetFormType())
+        {
+        case RE::FormType::Static:
+        case RE::FormType::Furniture:
+        case RE::FormType::Container:
+        case RE::FormType::Activator:
+            break;
+        default:
+            return false;
+        }
+
+        auto* root = ref.Get3D();
+        if (!root)
+        {
+            return false;
+        }
+
+        // Bounds are in model space, before the reference's scale
+        const RE::NiTransform& world = root->world;
+        const RE::NiPoint3 lo = ref.GetBoundMin();
+        const RE::NiPoint3 hi = ref.GetBoundMax();
+        const RE::NiPoint3 size = (hi - lo) * world.scale;
+        const int largeAxes = (size.x >= Constants::kMinOccluderExtent) + (size.y >= Constants::kMinOccluderExtent) +
+                              (size.z >= Constants::kMinOccluderExtent);
+        if (largeAxes < 2)
+        {
+            return false;
+        }
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            box.min[axis] = FLT_MAX;
+            box.max[axis] = -FLT_MAX;
+        }
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const RE::NiPoint3 local((corner & 1) ? hi.x : lo.x, (corner & 2) ? hi.y : lo.y, (corner & 4) ? hi.z : lo.z);
+            const RE::NiPoint3 p = world.rotate * (local * world.scale) + world.translate;
+            const float coords[3] = {p.x, p.y, p.z};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                box.min[axis] = std::min(box.min[axis], coords[axis]);
+                box.max[axis] = std::max(box.max[axis], coords[axis]);
+            }
+        }
+        return true;
+    }
+
+    static void CollectCell(RE::TESObjectCELL* cell)
+    {
+        auto& worker = GetWorker();
+
+        // Cells that left the loaded area take their occluders along
+        for (const auto cellID : worker.Cells())
+        {
+            auto* other = RE::TESForm::LookupByID<RE::TESObjectCELL>(cellID);
+            if (!other || !other->IsAttached())
+            {
+                worker.RemoveCell(cellID);
+            }
+        }
+
+        std::vector<OcclusionBVH::Box> boxes;
+        cell->ForEachReference([&](RE::TESObjectREFR& ref) {
+            OcclusionBVH::Box box;
+            if (GetOccluderBox(ref, box))
+            {
+                boxes.push_back(box);
+            }
+            return RE::BSContainer::ForEachResult::kContinue;
+        });
+
+        SKSE::log::debug("Occlusion: {} occluders in cell {:08X}", boxes.size(), cell->GetFormID());
+        worker.SetCell(cell->GetFormID(), std::move(boxes));
+    }
+
+    /// Collect the cells that were loaded before the BVH backend was selected.
+    static void CollectLoadedCells()
+    {
+        auto* tes = RE::TES::GetSingleton();
+        if (!tes)
+        {
+            return;
+        }
+
+        if (tes->interiorCell)
+        {
+            CollectCell(tes->interiorCell);
+            return;
+        }
+
+        auto* grid = tes->gridCells;
+        if (!grid || !grid->cells)
+        {
+            return;
+        }
+        for (std::uint32_t i = 0; i < grid->length * grid->length; ++i)
+        {
+            auto* cell = grid->cells[i];
+            if (cell && cell->IsAttached())
+            {
+                CollectCell(cell);
+            }
+        }
+    }
+
+    namespace {
+        class CellLoadSink final : public RE::BSTEventSink<RE::TESCellFullyLoadedEvent>
+        {
+        public:
+            static CellLoadSink* GetSingleton()
+            {
+                static CellLoadSink singleton;
+                return std::addressof(singleton);
+            }
+
+            RE::BSEventNotifyControl ProcessEvent(const RE::TESCellFullyLoadedEvent* a_event,
+                                                  RE::BSTEventSource<RE::TESCellFullyLoadedEvent>*) override
+            {
+                if (a_event && a_event->cell && IsStaticBackend()) {
+                    CollectCell(a_event->cell);
+                }
+                return RE::BSEventNotifyControl::kContinue;
+            }
+        };
+    }
+
+    void RegisterEventSinks()
+    {
+        auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+        if (!holder) {
+            SKSE::log::warn("Occlusion: Event source holder not available, static occluders disabled");
+            return;
+        }
+
+        holder->AddEventSink<RE::TESCellFullyLoadedEvent>(CellLoadSink::GetSingleton());
+        SKSE::log::info("Occlusion: Registered cell load event sink");
+    }
+
     bool GetCameraInfo(RE::NiPoint3& outPos, RE::NiPoint3& outForward)
     {
         auto* camera = RE::PlayerCamera::GetSingleton();
@@ -67,19 +273,13 @@ namespace Occlusion
         return true;  // If check failed, assume visible
     }
 
-    bool IsActorOccluded(RE::Actor* actor, RE::Actor* player, const RE::NiPoint3& actorWorldPos)
+    static Quick QuickCheck(const RE::NiPoint3& actorWorldPos, RE::NiPoint3& cameraPos)
     {
-        // Early out if occlusion is disabled
-        if (!Settings::EnableOcclusionCulling || !actor || !player)
-        {
-            return false;
-        }
-
         // Get camera info
-        RE::NiPoint3 cameraPos, cameraForward;
+        RE::NiPoint3 cameraForward;
         if (!GetCameraInfo(cameraPos, cameraForward))
         {
-            return false;  // No camera, don't occlude
+            return Quick::Visible;  // No camera, don't occlude
         }
 
         // Calculate distance to actor
@@ -89,17 +289,105 @@ namespace Occlusion
         // Very close actors are always visible
         if (distance < Constants::kCloseDistanceThreshold)
         {
-            return false;
+            return Quick::Visible;
         }
 
         // Check if actor is behind camera
         if (IsBehindCamera(actorWorldPos, cameraPos, cameraForward))
         {
-            return true;
+            return Quick::Occluded;
+        }
+
+        return Quick::NeedsRay;
+    }
+
+    bool IsActorOccluded(RE::Actor* actor, RE::Actor* player, const RE::NiPoint3& actorWorldPos)
+    {
+        // Early out if occlusion is disabled
+        if (!Settings::EnableOcclusionCulling || !actor || !player)
+        {
+            return false;
+        }
+
+        RE::NiPoint3 cameraPos;
+        const Quick quick = QuickCheck(actorWorldPos, cameraPos);
+        if (quick != Quick::NeedsRay)
+        {
+            return quick == Quick::Occluded;
         }
 
         // Use game's built-in line of sight check
         return !HasLineOfSightToActor(actor);
     }
 
+    bool IsActorOccludedStatic(RE::Actor* actor, RE::Actor* player, const RE::NiPoint3& actorWorldPos)
+    {
+        if (!Settings::EnableOcclusionCulling || !actor || !player)
+        {
+            return false;
+        }
+
+        RE::NiPoint3 cameraPos;
+        const Quick quick = QuickCheck(actorWorldPos, cameraPos);
+        if (quick != Quick::NeedsRay)
+        {
+            return quick == Quick::Occluded;
+        }
+
+        auto& state = GetStaticState();
+        const RE::FormID id = actor->GetFormID();
+
+        // The cell load sink only sees cells that load after the switch
+        if (!state.cellsCollected)
+        {
+            CollectLoadedCells();
+            state.cellsCollected = true;
+        }
+
+        // Answered in the batch the next scan reads
+        RE::NiPoint3 head = actor->GetPosition();
+        head.z += actor->GetHeight() * Constants::kHeadHeightMultiplier;
+        state.segments.push_back({id, {cameraPos.x, cameraPos.y, cameraPos.z}, {head.x, head.y, head.z}});
+
+        bool treeOccluded = false;
+        const bool treeKnown = GetWorker().Find(id, treeOccluded);
+
+        auto& entry = state.actors[id];
+        entry.lastSeenScan = state.scan;
+
+        // Terrain and anything the boxes miss only show up in the game's check
+        const int interval = treeKnown ? Settings::OcclusionCorrectionInterval : Settings::OcclusionCheckInterval;
+        if (!entry.correction.valid ||
+            state.scan - entry.lastGameScan >= static_cast<std::uint32_t>(std::max(interval, 1)))
+        {
+            entry.correction = {true, !HasLineOfSightToActor(actor), treeKnown, treeOccluded};
+            entry.lastGameScan = state.scan;
+        }
+
+        return treeKnown ? OcclusionBVH::Resolve(entry.correction, treeOccluded) : entry.correction.gameOccluded;
+    }
+
+    void EndScan()
+    {
+        auto& state = GetStaticState();
+        if (!IsStaticBackend())
+        {
+            state.cellsCollected = false;
+        }
+        if (state.segments.empty() && state.actors.empty())
+        {
+            return;
+        }
+
+        if (!state.segments.empty())
+        {
+            GetWorker().Submit(state.segments);
+            state.segments.clear();
+        }
+
+        // Actors that left or came too close start over with a game check
+        std::erase_if(state.actors, [&](const auto& entry) { return entry.second.lastSeenScan != state.scan; });
+        ++state.scan;
+    }
+
 }
@@ -83,6 +83,20 @@
  * |   `kCloseDistanceThreshold` | 100.0  | Always visible when $\\|p_{actor} - p_{cam}\\| < 100$ units       |
  * | `kBehindCameraDotThreshold` | -0.2   | Behind camera when $\hat{f} \cdot \hat{d} < -0.2$ ($\approx 101$) |
  * |     `kHeadHeightMultiplier` | 0.9    | Head position: $y_{head} = y_{base} + 0.9h$                       |
+ * |     `kMinOccluderExtent`    | 96.0   | Static references smaller than this on two axes never occlude    |
+ *
+ * ## :material-swap-horizontal: Backends
+ *
+ * | `OcclusionBackend` | Line of sight                                                        |
+ * |--------------------|----------------------------------------------------------------------|
+ * | 0                  | `HasLineOfSight` on the game thread, every `OcclusionCheckInterval` frames |
+ * | 1                  | Static occluder BVH on a worker, `HasLineOfSight` every `OcclusionCorrectionInterval` scans |
+ *
+ * With the BVH backend each scan queues the camera-to-head segment of every
+ * actor that passed the distance and behind-camera tests, and reads the
+ * worker's answers to the previous scan's segments.
+ *
+ * @see OcclusionBVH
  */
 namespace Occlusion
 {
@@ -94,8 +108,27 @@ namespace Occlusion
         constexpr float kCloseDistanceThreshold = 100.0f;    ///< Visible when $\|p_{actor} - p_{cam}\| < 100$ game units
         constexpr float kBehindCameraDotThreshold = -0.2f;   ///< Behind camera when $\hat{f} \cdot \hat{d} < -0.2$ ($\approx 101$)
         constexpr float kHeadHeightMultiplier = 0.9f;        ///< Head position: $y_{head} = y_{base} + 0.9h$
+        constexpr float kMinOccluderExtent = 96.0f;          ///< Smallest wall or crate worth an occluder box
     }
 
+    /**
+     * Line of sight implementations, see `Settings::OcclusionBackend`.
+     */
+    enum class Backend
+    {
+        Game = 0,    ///< `HasLineOfSight` for every check
+        Static = 1,  ///< Static occluder BVH, corrected by `HasLineOfSight`
+    };
+
+    /**
+     * Register the cell load sink that collects static occluders.
+     *
+     * Call once after data is loaded. Cells only contribute occluders while
+     * the BVH backend is selected; the cells already loaded when it is
+     * selected are collected by the first `IsActorOccludedStatic()` call.
+     */
+    void RegisterEventSinks();
+
     /**
      * Check if player has line of sight to the specified actor.
      *
@@ -125,6 +158,36 @@ namespace Occlusion
      */
     bool IsActorOccluded(RE::Actor* actor, RE::Actor* player, const RE::NiPoint3& actorWorldPos);
 
+    /**
+     * Check if an actor should be considered occluded, using the static
+     * occluder BVH for line of sight.
+     *
+     * Same distance and behind-camera tests as `IsActorOccluded()`. The
+     * camera-to-head segment is queued for `EndScan()` and the answer comes
+     * from the worker's last batch. `HasLineOfSight` still runs once every
+     * `OcclusionCorrectionInterval` calls for the actor, or every
+     * `OcclusionCheckInterval` while the worker has no answer for it.
+     *
+     * Game thread only.
+     *
+     * @param actor The actor to check.
+     * @param player The player actor.
+     * @param actorWorldPos The world position to check from.
+     *
+     * @return `true` if the actor is occluded and nameplate should be hidden.
+     */
+    bool IsActorOccludedStatic(RE::Actor* actor, RE::Actor* player, const RE::NiPoint3& actorWorldPos);
+
+    /**
+     * Hand the segments queued since the last call to the worker.
+     *
+     * Also notes when the BVH backend is deselected, so the loaded cells are
+     * collected again once it comes back.
+     *
+     * Call once at the end of every actor scan, game thread only.
+     */
+    void EndScan();
+
     /**
      * Get camera position and forward direction.
      *
@@ -0,0 +1,304 @@
+#include "OcclusionBVH.h"
+
+#include <algorithm>
+
+namespace OcclusionBVH
+{
+    namespace
+    {
+        bool Contains(const float min[3], const float max[3], const float p[3])
+        {
+            return p[0] >= min[0] && p[0] <= max[0] && p[1] >= min[1] && p[1] <= max[1] && p[2] >= min[2] &&
+                   p[2] <= max[2];
+        }
+
+        // Slab test of from + t * dir for t in [0, 1]
+        bool Overlaps(const float min[3], const float max[3], const float from[3], const float dir[3], const float inv[3])
+        {
+            float t0 = 0.0f;
+            float t1 = 1.0f;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (dir[axis] == 0.0f)
+                {
+                    if (from[axis] < min[axis] || from[axis] > max[axis])
+                        return false;
+                    continue;
+                }
+
+                float ta = (min[axis] - from[axis]) * inv[axis];
+                float tb = (max[axis] - from[axis]) * inv[axis];
+                if (ta > tb)
+                    std::swap(ta, tb);
+                t0 = std::max(t0, ta);
+                t1 = std::min(t1, tb);
+                if (t0 > t1)
+                    return false;
+            }
+            return true;
+        }
+
+        float Centroid(const Box& box, int axis) { return box.min[axis] + box.max[axis]; }
+    }
+
+    void Tree::Build(std::vector<Box> boxes)
+    {
+        boxes.erase(std::remove_if(boxes.begin(), boxes.end(),
+                                   [](const Box& b) {
+                                       return b.min[0] > b.max[0] || b.min[1] > b.max[1] || b.min[2] > b.max[2];
+                                   }),
+                    boxes.end());
+
+        m_boxes = std::move(boxes);
+        m_nodes.clear();
+        if (m_boxes.empty())
+            return;
+
+        // A binary tree over n boxes has fewer than 2n nodes, so Split may
+        // hold node indices across push_back
+        m_nodes.reserve(m_boxes.size() * 2);
+        m_nodes.emplace_back();
+        Split(0, 0, static_cast<std::uint32_t>(m_boxes.size()));
+    }
+
+    void Tree::Split(std::uint32_t nodeIndex, std::uint32_t first, std::uint32_t count)
+    {
+        Node node;
+        float cmin[3], cmax[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            node.min[axis] = cmin[axis] = 3.4e38f;
+            node.max[axis] = cmax[axis] = -3.4e38f;
+        }
+        for (std::uint32_t i = first; i < first + count; ++i)
+        {
+            const Box& box = m_boxes[i];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                node.min[axis] = std::min(node.min[axis], box.min[axis]);
+                node.max[axis] = std::max(node.max[axis], box.max[axis]);
+                cmin[axis] = std::min(cmin[axis], Centroid(box, axis));
+                cmax[axis] = std::max(cmax[axis], Centroid(box, axis));
+            }
+        }
+
+        if (count <= kLeafBoxes)
+        {
+            node.first = first;
+            node.count = count;
+            m_nodes[nodeIndex] = node;
+            return;
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+        {
+            if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis])
+                axis = a;
+        }
+
+        const std::uint32_t half = count / 2;
+        std::nth_element(m_boxes.begin() + first, m_boxes.begin() + first + half, m_boxes.begin() + first + count,
+                         [axis](const Box& a, const Box& b) { return Centroid(a, axis) < Centroid(b, axis); });
+
+        const std::uint32_t child = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes.emplace_back();
+        node.first = child;
+        node.count = 0;
+        m_nodes[nodeIndex] = node;
+
+        Split(child, first, half);
+        Split(child + 1, first + half, count - half);
+    }
+
+    bool Tree::Blocks(const float from[3], const float to[3]) const
+    {
+        if (m_nodes.empty())
+            return false;
+
+        float dir[3], inv[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            dir[axis] = to[axis] - from[axis];
+            inv[axis] = dir[axis] != 0.0f ? 1.0f / dir[axis] : 0.0f;
+        }
+
+        // Median splits keep the depth near log2(n / kLeafBoxes)
+        std::uint32_t stack[64];
+        std::uint32_t top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node& node = m_nodes[stack[--top]];
+            if (!Overlaps(node.min, node.max, from, dir, inv))
+                continue;
+
+            if (node.count == 0)
+            {
+                if (top + 2 > std::size(stack))
+                    return false;
+                stack[top++] = node.first + 1;
+                stack[top++] = node.first;
+                continue;
+            }
+
+            for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const Box& box = m_boxes[i];
+                if (Contains(box.min, box.max, from) || Contains(box.min, box.max, to))
+                    continue;
+                if (Overlaps(box.min, box.max, from, dir, inv))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool Resolve(const Correction& correction, bool treeOccluded)
+    {
+        if (!correction.valid)
+            return treeOccluded;
+        if (!correction.treeKnown || treeOccluded == correction.treeAtCheck)
+            return correction.gameOccluded;
+        return treeOccluded;
+    }
+
+    Worker::~Worker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    void Worker::Start()
+    {
+        if (!m_thread.joinable())
+            m_thread = std::thread([this]() { Run(); });
+    }
+
+    void Worker::SetCell(std::uint32_t cellID, std::vector<Box> boxes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (boxes.empty())
+                m_cells.erase(cellID);
+            else
+                m_cells[cellID] = std::move(boxes);
+            m_cellsChanged = true;
+            Start();
+        }
+        m_wake.notify_one();
+    }
+
+    void Worker::RemoveCell(std::uint32_t cellID) { SetCell(cellID, {}); }
+
+    std::vector<std::uint32_t> Worker::Cells() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        std::vector<std::uint32_t> cells;
+        cells.reserve(m_cells.size());
+        for (const auto& [id, boxes] : m_cells)
+            cells.push_back(id);
+        return cells;
+    }
+
+    void Worker::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_cells.clear();
+        m_tree.reset();
+        m_pending.clear();
+        m_results.clear();
+        m_hasBatch = false;
+        m_cellsChanged = false;
+    }
+
+    void Worker::Submit(const std::vector<Segment>& segments)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_pending.assign(segments.begin(), segments.end());
+            m_hasBatch = true;
+            Start();
+        }
+        m_wake.notify_one();
+    }
+
+    bool Worker::Find(std::uint32_t id, bool& occluded) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto it = std::lower_bound(m_results.begin(), m_results.end(), id,
+                                   [](const Result& r, std::uint32_t value) { return r.id < value; });
+        if (it == m_results.end() || it->id != id)
+            return false;
+        occluded = it->occluded;
+        return true;
+    }
+
+    void Worker::Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_idle.wait(lock, [this]() { return !m_cellsChanged && !m_hasBatch && !m_busy; });
+    }
+
+    std::uint64_t Worker::Batches() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_batches;
+    }
+
+    void Worker::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (;;)
+        {
+            m_wake.wait(lock, [this]() { return m_stop || m_cellsChanged || m_hasBatch; });
+            if (m_stop)
+                return;
+
+            m_busy = true;
+            if (m_cellsChanged)
+            {
+                // Copy the boxes so cells can change during the build
+                m_cellsChanged = false;
+                std::vector<Box> boxes;
+                for (const auto& [id, cell] : m_cells)
+                    boxes.insert(boxes.end(), cell.begin(), cell.end());
+                lock.unlock();
+
+                auto tree = std::make_shared<Tree>();
+                tree->Build(std::move(boxes));
+
+                lock.lock();
+                m_tree = tree->BoxCount() > 0 ? std::move(tree) : nullptr;
+            }
+            else
+            {
+                m_running.swap(m_pending);
+                m_hasBatch = false;
+                std::shared_ptr<const Tree> tree = m_tree;
+                lock.unlock();
+
+                m_back.clear();
+                if (tree)
+                {
+                    for (const Segment& segment : m_running)
+                        m_back.push_back({segment.id, tree->Blocks(segment.from, segment.to)});
+                    std::sort(m_back.begin(), m_back.end(),
+                              [](const Result& a, const Result& b) { return a.id < b.id; });
+                }
+
+                lock.lock();
+                m_results.swap(m_back);
+                ++m_batches;
+            }
+            m_busy = false;
+            m_idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @namespace OcclusionBVH
+ * @brief Line of sight against cached static occluders, off the game thread.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * `PlayerCharacter::HasLineOfSight` has to run on the game thread, once per
+ * actor, which makes it the most expensive step of an actor scan. When a cell
+ * loads, the world bounds of its large static references are collected into
+ * a bounding volume hierarchy. A worker thread then tests the camera-to-head
+ * segment of every tracked actor against it and publishes the results for
+ * the next scan to read.
+ *
+ * ## :material-cube-outline: Occluders
+ *
+ * An occluder is an axis-aligned box. A box blocks a segment that passes
+ * through it, unless either end lies inside the box: the box of a building
+ * also covers the rooms and yard the camera or actor may stand in, so it
+ * cannot tell what is behind its walls.
+ *
+ * ## :material-file-tree-outline: Tree Layout
+ *
+ * | Field           | Inner node        | Leaf                    |
+ * |-----------------|-------------------|-------------------------|
+ * | `min`, `max`    | Bounds of both children | Bounds of its boxes |
+ * | `first`         | Left child, right is `first + 1` | First box |
+ * | `count`         | 0                 | Boxes, at most `kLeafBoxes` |
+ *
+ * Nodes are 32 bytes in one array, boxes are reordered so every leaf's boxes
+ * are contiguous. Builds split at the median centroid along the longest axis.
+ *
+ * ## :material-scale-balance: Correction
+ *
+ * Boxes are coarser than collision meshes and terrain is not collected, so
+ * the game's line of sight still runs every few scans per actor. `Resolve()`
+ * keeps the game's answer while the tree's answer stays what it was at that
+ * check, and follows the tree once it changes.
+ *
+ * ## :material-test-tube: Testing
+ *
+ * Only the standard library is used, so the tree and the worker can be built
+ * and benchmarked on synthetic scenes on any platform.
+ *
+ * @see Occlusion::IsActorOccludedStatic
+ */
+namespace OcclusionBVH
+{
+    inline constexpr std::uint32_t kLeafBoxes = 4;  ///< Boxes per leaf at most
+
+    /// World-space axis-aligned box.
+    struct Box
+    {
+        float min[3];
+        float max[3];
+    };
+
+    /// Camera-to-head segment of one actor.
+    struct Segment
+    {
+        std::uint32_t id;  ///< Actor form ID
+        float from[3];
+        float to[3];
+    };
+
+    /// Whether an actor's segment was blocked.
+    struct Result
+    {
+        std::uint32_t id;
+        bool occluded;
+    };
+
+    /**
+     * Bounding volume hierarchy over occluder boxes.
+     *
+     * Immutable once built, so any number of threads may query it.
+     */
+    class Tree
+    {
+    public:
+        /**
+         * Build the tree, replacing any previous one.
+         *
+         * @param boxes Occluders; empty boxes (min > max) are dropped.
+         */
+        void Build(std::vector<Box> boxes);
+
+        /**
+         * Test a segment against the occluders.
+         *
+         * @param from Segment start, usually the camera.
+         * @param to Segment end, usually the actor's head.
+         * @return `true` if some box the segment crosses contains neither end.
+         */
+        bool Blocks(const float from[3], const float to[3]) const;
+
+        std::size_t BoxCount() const { return m_boxes.size(); }
+        std::size_t NodeCount() const { return m_nodes.size(); }
+        std::size_t Bytes() const { return m_nodes.size() * sizeof(Node) + m_boxes.size() * sizeof(Box); }
+
+    private:
+        struct Node
+        {
+            float min[3];
+            float max[3];
+            std::uint32_t first;
+            std::uint32_t count;
+        };
+
+        void Split(std::uint32_t nodeIndex, std::uint32_t first, std::uint32_t count);
+
+        std::vector<Node> m_nodes;
+        std::vector<Box> m_boxes;
+    };
+
+    /// Game check state of one actor, see Correction above.
+    struct Correction
+    {
+        bool valid = false;         ///< A game check ran
+        bool gameOccluded = false;  ///< Its answer
+        bool treeKnown = false;     ///< The tree had an answer at that check
+        bool treeAtCheck = false;   ///< That answer
+    };
+
+    /**
+     * Combine the last game check with the tree's current answer.
+     *
+     * @param correction State of the actor's last game check.
+     * @param treeOccluded The tree's current answer.
+     * @return The game's answer until the tree's answer changes, then the tree's.
+     */
+    bool Resolve(const Correction& correction, bool treeOccluded);
+
+    /**
+     * Occluders by cell, and a worker thread that rebuilds the tree and runs
+     * segment batches against it.
+     *
+     * All calls return without waiting for the worker except `Flush()`.
+     * Results are published per batch; a batch submitted before the worker
+     * took the previous one replaces it.
+     */
+    class Worker
+    {
+    public:
+        Worker() = default;
+        ~Worker();
+        Worker(const Worker&) = delete;
+        Worker& operator=(const Worker&) = delete;
+
+        /// Replace the occluders of a cell and rebuild the tree.
+        void SetCell(std::uint32_t cellID, std::vector<Box> boxes);
+
+        /// Drop the occluders of a cell and rebuild the tree.
+        void RemoveCell(std::uint32_t cellID);
+
+        /// Cells with occluders.
+        std::vector<std::uint32_t> Cells() const;
+
+        /// Drop every cell and result.
+        void Clear();
+
+        /// Queue segments for the worker.
+        void Submit(const std::vector<Segment>& segments);
+
+        /**
+         * Look up an actor in the last published batch.
+         *
+         * @param id Actor form ID.
+         * @param[out] occluded The tree's answer.
+         * @return `false` if there is no tree or the actor was not in the batch.
+         */
+        bool Find(std::uint32_t id, bool& occluded) const;
+
+        /// Block until queued builds and batches are done.
+        void Flush();
+
+        /// Batches published so far.
+        std::uint64_t Batches() const;
+
+    private:
+        void Start();
+        void Run();
+
+        mutable std::mutex m_lock;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        std::unordered_map<std::uint32_t, std::vector<Box>> m_cells;
+        std::shared_ptr<const Tree> m_tree;
+        std::vector<Segment> m_pending;
+        std::vector<Segment> m_running;
+        std::vector<Result> m_results;  // Sorted by id
+        std::vector<Result> m_back;
+        std::uint64_t m_batches = 0;
+        bool m_cellsChanged = false;
+        bool m_hasBatch = false;
+        bool m_busy = false;
+        bool m_stop = false;
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,105 @@
+#include "OrnamentRuns.h"
+
+#include <cstring>
+
+namespace OrnamentRuns
+{
+    static constexpr std::uint32_t kInvalid = 0xFFFD;
+
+    // Decode one character starting at `i`; returns its length in bytes.
+    // Malformed sequences decode as U+FFFD and consume one byte.
+    static std::size_t DecodeUtf8(std::string_view s, std::size_t i, std::uint32_t& cp)
+    {
+        const auto c = static_cast<unsigned char>(s[i]);
+        std::size_t length;
+        if (c < 0x80)
+        {
+            cp = c;
+            return 1;
+        }
+        else if (c >= 0xC0 && c < 0xE0)
+        {
+            length = 2;
+            cp = c & 0x1F;
+        }
+        else if (c >= 0xE0 && c < 0xF0)
+        {
+            length = 3;
+            cp = c & 0x0F;
+        }
+        else if (c >= 0xF0 && c < 0xF8)
+        {
+            length = 4;
+            cp = c & 0x07;
+        }
+        else
+        {
+            cp = kInvalid;  // Continuation byte or invalid lead byte
+            return 1;
+        }
+
+        if (i + length > s.size())
+        {
+            cp = kInvalid;  // Truncated
+            return 1;
+        }
+        for (std::size_t k = 1; k < length; ++k)
+        {
+            const auto cont = static_cast<unsigned char>(s[i + k]);
+            if ((cont & 0xC0) != 0x80)
+            {
+                cp = kInvalid;
+                return 1;
+            }
+            cp = (cp << 6) | (cont & 0x3F);
+        }
+        return length;
+    }
+
+    Run Compile(std::string_view utf8, const GlyphLookup& lookup)
+    {
+        Run run;
+        for (std::size_t i = 0; i < utf8.size();)
+        {
+            std::uint32_t cp = 0;
+            const auto length = DecodeUtf8(utf8, i, cp);
+
+            float advance = 0.0f;
+            if (cp != kInvalid && cp >= 0x20 && lookup(cp, advance))
+            {
+                Glyph glyph;
+                std::memcpy(glyph.utf8.data(), utf8.data() + i, length);
+                glyph.advance = advance;
+                run.advance += advance;
+                run.glyphs.push_back(glyph);
+            }
+            i += length;
+        }
+        return run;
+    }
+
+    void Table::Invalidate()
+    {
+        m_tiers.clear();
+        m_specials.clear();
+        m_valid = false;
+    }
+
+    void Table::Reset()
+    {
+        Invalidate();
+        m_valid = true;
+    }
+
+    void Table::AddTier(std::string_view left, std::string_view right, const GlyphLookup& lookup)
+    {
+        m_tiers.push_back({Compile(left, lookup), Compile(right, lookup)});
+        m_valid = true;
+    }
+
+    void Table::AddSpecial(std::string_view left, std::string_view right, const GlyphLookup& lookup)
+    {
+        m_specials.push_back({Compile(left, lookup), Compile(right, lookup)});
+        m_valid = true;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace OrnamentRuns
+ * @brief Side ornament strings resolved to glyph runs once per settings load.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * Ornaments are configured as UTF-8 strings per tier and per special title.
+ * Decoding them, dropping characters the ornament font lacks and measuring
+ * each glyph only depends on the settings and the font, so it is done once
+ * after the fonts are built instead of for every decorated label each frame.
+ * The draw path then only scales the cached advances and places the glyphs.
+ *
+ * ## :material-format-letter-spacing: Runs
+ *
+ * A `Run` keeps the drawable characters of one side in configured order.
+ * Each glyph carries its NUL-terminated UTF-8 bytes (for the text passes)
+ * and its advance at the font's own size. At draw size $s$ with font size
+ * $f$ the glyph is $a \cdot s / f$ wide and $s$ tall, which is what
+ * `ImFont::CalcTextSizeA` returns for the single character.
+ *
+ * A character is dropped when it:
+ *
+ * | Check                    | Reason                                      |
+ * |--------------------------|---------------------------------------------|
+ * | Is malformed UTF-8       | Would draw as a replacement block           |
+ * | Is a control character   | Has no visible glyph                        |
+ * | Is missing from the font | Would draw the font's fallback glyph        |
+ *
+ * ## :material-refresh: Invalidation
+ *
+ * The table is rebuilt on the render thread when a reload changed ornament
+ * or font keys, before any label is built, so the pipeline worker only ever
+ * reads a finished table.
+ *
+ * @see Renderer::Draw, Settings::TierDefinition, SettingsWatch::kOrnaments
+ */
+namespace OrnamentRuns
+{
+    /// One drawable ornament character.
+    struct Glyph
+    {
+        std::array<char, 8> utf8{};  ///< NUL-terminated UTF-8 bytes of the character
+        float advance{0.0f};         ///< Advance at the font's own size
+    };
+
+    /// Drawable characters of one side, in configured order.
+    struct Run
+    {
+        std::vector<Glyph> glyphs;
+        float advance{0.0f};  ///< Sum of the glyph advances, without gaps
+
+        bool Empty() const { return glyphs.empty(); }
+    };
+
+    /// Left and right runs of one tier or special title.
+    struct Sides
+    {
+        Run left;
+        Run right;
+
+        bool Empty() const { return left.Empty() && right.Empty(); }
+    };
+
+    /**
+     * Font query used while compiling.
+     *
+     * Sets `advance` to the glyph's advance at the font's own size; returns
+     * `false` if the font has no glyph for the codepoint.
+     */
+    using GlyphLookup = std::function<bool(std::uint32_t codepoint, float& advance)>;
+
+    /// Decode `utf8` and keep the characters the font can draw.
+    Run Compile(std::string_view utf8, const GlyphLookup& lookup);
+
+    /// Runs of every tier and special title, indexed like `Settings`.
+    class Table
+    {
+    public:
+        /// Drop all runs and mark the table for a rebuild.
+        void Invalidate();
+
+        /// Drop all runs and mark the table built, e.g. when no ornament font is loaded.
+        void Reset();
+
+        /// Compile and append the next tier, then the next special title.
+        void AddTier(std::string_view left, std::string_view right, const GlyphLookup& lookup);
+        void AddSpecial(std::string_view left, std::string_view right, const GlyphLookup& lookup);
+
+        bool Valid() const { return m_valid; }
+
+        /// Runs of tier `i`; empty if it was added after the last build.
+        const Sides& Tier(std::size_t i) const { return i < m_tiers.size() ? m_tiers[i] : m_empty; }
+
+        /// Runs of special title `i`; empty if it was added after the last build.
+        const Sides& Special(std::size_t i) const { return i < m_specials.size() ? m_specials[i] : m_empty; }
+
+    private:
+        std::vector<Sides> m_tiers;
+        std::vector<Sides> m_specials;
+        Sides m_empty;
+        bool m_valid{false};
+    };
+}
@@ -0,0 +1,66 @@
+#include "OutfitDiff.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace OutfitDiff
+{
+    OutfitPlan ComputePlan(const std::vector<InventoryEntry>& source,
+                           const std::vector<InventoryEntry>& player)
+    {
+        OutfitPlan plan;
+
+        // Index the player's armor once instead of rescanning per source item
+        std::unordered_map<FormID, std::size_t> playerIndex;
+        playerIndex.reserve(player.size());
+        for (std::size_t i = 0; i < player.size(); ++i)
+            playerIndex.emplace(player[i].formID, i);
+
+        std::unordered_set<FormID> seen;
+        std::unordered_set<FormID> kept;  // Forms the player ends up wearing
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            const auto& item = source[i];
+            if (!item.worn)
+                continue;
+
+            if (!seen.insert(item.formID).second)
+            {
+                plan.skipped.push_back({i, SkipReason::Duplicate});
+                continue;
+            }
+
+            // First worn piece wins a slot, matching how the engine resolves overlaps
+            if ((item.slots & plan.equipSlots) != 0)
+            {
+                plan.skipped.push_back({i, SkipReason::SlotConflict});
+                continue;
+            }
+
+            auto it = playerIndex.find(item.formID);
+            if (it != playerIndex.end() && player[it->second].worn)
+            {
+                plan.equipSlots |= item.slots;
+                kept.insert(item.formID);
+                plan.skipped.push_back({i, SkipReason::AlreadyWorn});
+                continue;
+            }
+
+            if (it == playerIndex.end())
+                plan.add.push_back(i);
+            plan.equip.push_back(i);
+            plan.equipSlots |= item.slots;
+            kept.insert(item.formID);
+        }
+
+        // Anything the player wears in a slot we are about to fill gets replaced
+        for (std::size_t i = 0; i < player.size(); ++i)
+        {
+            const auto& item = player[i];
+            if (item.worn && (item.slots & plan.equipSlots) != 0 && !kept.count(item.formID))
+                plan.displaced.push_back(i);
+        }
+
+        return plan;
+    }
+}
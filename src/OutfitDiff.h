@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace OutfitDiff
+ * @brief Worn-armor diff between a source actor and the player.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Core
+ *
+ * Computes, in a single pass over two inventory snapshots, which armor pieces
+ * must be added to the player and which must be equipped to reproduce the
+ * source actor's worn outfit. The game side snapshots each inventory once and
+ * applies the resulting plan as a batch.
+ *
+ * ## :material-swap-horizontal: Diff Rules
+ *
+ * | Source item                               | Result                 |
+ * |-------------------------------------------|------------------------|
+ * | Not in player inventory                   | Add + equip            |
+ * | In player inventory, not worn             | Equip                  |
+ * | Already worn by the player                | Skipped (`AlreadyWorn`) |
+ * | Biped slots overlap an earlier pick       | Skipped (`SlotConflict`) |
+ * | Same form listed twice                    | Skipped (`Duplicate`)  |
+ *
+ * Player-worn pieces whose slots overlap the equip set are reported in
+ * `OutfitPlan::displaced`; the equip manager unequips them implicitly.
+ *
+ * @see AppearanceTemplate::ApplyIfConfigured
+ */
+namespace OutfitDiff
+{
+    using FormID = std::uint32_t;
+
+    /// One armor entry from an inventory snapshot.
+    struct InventoryEntry
+    {
+        FormID formID{0};        ///< Armor FormID
+        std::uint32_t slots{0};  ///< Biped slot mask
+        bool worn{false};        ///< Whether the owner currently wears it
+    };
+
+    /// Why a worn source item was not transferred.
+    enum class SkipReason : std::uint8_t
+    {
+        AlreadyWorn,   ///< Player already wears this form
+        SlotConflict,  ///< Overlaps the slots of an earlier source item
+        Duplicate      ///< Form appears more than once in the source
+    };
+
+    /// A source item that was left alone.
+    struct SkippedItem
+    {
+        std::size_t sourceIndex{0};  ///< Index into the source snapshot
+        SkipReason reason{SkipReason::AlreadyWorn};
+    };
+
+    /**
+     * Batched outfit transfer plan.
+     *
+     * Indices refer to the snapshots passed to `ComputePlan()` so callers can
+     * keep a parallel array of form pointers and avoid any lookups.
+     */
+    struct OutfitPlan
+    {
+        std::vector<std::size_t> add;        ///< Source indices to add to the player
+        std::vector<std::size_t> equip;      ///< Source indices to equip (superset of `add`)
+        std::vector<SkippedItem> skipped;    ///< Worn source items not transferred
+        std::vector<std::size_t> displaced;  ///< Player indices unequipped by slot overlap
+        std::uint32_t equipSlots{0};         ///< Union of slots covered by `equip`
+    };
+
+    /// Outcome of applying a plan, for logging and callers.
+    struct OutfitCopyResult
+    {
+        int added{0};     ///< Items added to the player's inventory
+        int equipped{0};  ///< Items equipped on the player
+        int skipped{0};   ///< Worn source items not transferred
+    };
+
+    /**
+     * Diff the source actor's worn armor against the player's inventory.
+     *
+     * Unworn source entries are ignored. Runs in $O(S + P)$ expected time.
+     *
+     * @param source Armor snapshot of the source actor.
+     * @param player Armor snapshot of the player.
+     * @return Plan describing additions, equips and skipped items.
+     */
+    OutfitPlan ComputePlan(const std::vector<InventoryEntry>& source,
+                           const std::vector<InventoryEntry>& player);
+}
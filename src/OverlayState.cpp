@@ -0,0 +1,43 @@
+#include "OverlayState.h"
+
+namespace OverlayState
+{
+    std::uint32_t MenuBit(std::string_view menuName)
+    {
+        for (std::size_t i = 0; i < kTrackedMenuCount; ++i)
+        {
+            if (kTrackedMenus[i] == menuName)
+                return 1u << i;
+        }
+        return 0;
+    }
+
+    void Tracker::OnMenu(std::string_view menuName, bool opening)
+    {
+        const std::uint32_t bit = MenuBit(menuName);
+        if (bit == 0)
+            return;
+        if (opening)
+            m_mask.fetch_or(bit, std::memory_order_acq_rel);
+        else
+            m_mask.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+
+    void Tracker::SeedMenus(std::uint32_t menuBits)
+    {
+        std::uint32_t cur = m_mask.load(std::memory_order_relaxed);
+        while (!m_mask.compare_exchange_weak(cur, (cur & ~kMenuMask) | (menuBits & kMenuMask),
+                                             std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void Tracker::SetWorld(std::uint32_t bits)
+    {
+        std::uint32_t cur = m_mask.load(std::memory_order_relaxed);
+        while (!m_mask.compare_exchange_weak(cur, (cur & ~kWorldMask) | (bits & kWorldMask),
+                                             std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+    }
+}
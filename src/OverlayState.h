@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @namespace OverlayState
+ * @brief Event-driven visibility state of the overlay.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * The overlay is hidden while a full-screen or input-capturing menu is open,
+ * while the game is loading and while the player is in combat. Menus used to
+ * be checked by sweeping `UI::IsMenuOpen` over every blocking menu name each
+ * frame, which takes the menu map lock and hashes a string per name. Instead
+ * a `MenuOpenCloseEvent` sink flips one bit per tracked menu as menus open and
+ * close, and the game thread folds the remaining world checks into the same
+ * word when it takes its snapshot.
+ *
+ * ## :material-toggle-switch-outline: Hidden Mask
+ *
+ * | Bits     | Meaning                                   | Written by          |
+ * |----------|-------------------------------------------|---------------------|
+ * | 0 - 17   | Tracked menu open, see `kTrackedMenus`    | Menu event sink     |
+ * | 24       | Loading, frozen or resetting              | Game thread         |
+ * | 25       | Player cell not attached                  | Game thread         |
+ * | 26       | Player in combat                          | Game thread         |
+ *
+ * The overlay may draw when the mask is zero, so the render thread decides
+ * with a single atomic load. Menu bits are independent, so nested menus
+ * (Tween menu, then Inventory) and overlapping ones (Fader over the map)
+ * keep the overlay hidden until the last of them closes. Repeated open or
+ * close events for the same menu are harmless.
+ *
+ * The mask starts with the loading bit set, so nothing draws before the
+ * game thread has checked the world once.
+ *
+ * @see Renderer::IsOverlayAllowedRT, Hooks::PostDisplay
+ */
+namespace OverlayState
+{
+    /// Menus that hide the overlay while open, one mask bit each in this order.
+    inline constexpr std::string_view kTrackedMenus[] = {
+        "Loading Menu",  "Main Menu",        "MapMenu",         "Fader Menu",    "Menu",
+        "Console",       "TweenMenu",        "Journal Menu",    "InventoryMenu", "MagicMenu",
+        "ContainerMenu", "BarterMenu",       "GiftMenu",        "Crafting Menu", "FavoritesMenu",
+        "Lockpicking Menu", "Sleep/Wait Menu", "StatsMenu",
+    };
+
+    inline constexpr std::size_t kTrackedMenuCount = sizeof(kTrackedMenus) / sizeof(kTrackedMenus[0]);
+    static_assert(kTrackedMenuCount <= 24, "menu bits would overlap the world bits");
+
+    inline constexpr std::uint32_t kMenuMask = (1u << kTrackedMenuCount) - 1;
+    inline constexpr std::uint32_t kGameInactive = 1u << 24;  ///< Loading, frozen or resetting
+    inline constexpr std::uint32_t kNoAttachedCell = 1u << 25;
+    inline constexpr std::uint32_t kInCombat = 1u << 26;
+    inline constexpr std::uint32_t kWorldMask = kGameInactive | kNoAttachedCell | kInCombat;
+
+    /// Bit of a tracked menu, or 0 if the menu does not hide the overlay.
+    std::uint32_t MenuBit(std::string_view menuName);
+
+    /**
+     * Hidden mask shared by the event sink, the game thread and the render thread.
+     *
+     * All writers use atomic read-modify-write on a single word, so menu events
+     * and world updates from different threads never lose each other's bits.
+     */
+    class Tracker
+    {
+    public:
+        /// Apply a menu open or close event; untracked menus are ignored.
+        void OnMenu(std::string_view menuName, bool opening);
+
+        /// Replace the menu bits, e.g. from one `IsMenuOpen` sweep at startup.
+        void SeedMenus(std::uint32_t menuBits);
+
+        /// Replace the world bits (`kWorldMask` part of `bits`).
+        void SetWorld(std::uint32_t bits);
+
+        /// Current hidden mask; 0 means the overlay may draw.
+        std::uint32_t Mask() const { return m_mask.load(std::memory_order_acquire); }
+
+        bool Allowed() const { return Mask() == 0; }
+
+    private:
+        std::atomic<std::uint32_t> m_mask{kGameInactive};
+    };
+}
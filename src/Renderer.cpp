@@ -5,11 +5,24 @@
 #include "RenderConstants.h"
 #include "DebugOverlay.h"
 #include "AppearanceTemplate.h"
+#include "FramePipeline.h"
+#include "SnapshotDelta.h"
+#include "TypewriterMask.h"
+#include "OverlayState.h"
+#include "LabelInstancing.h"
+#include "LabelText.h"
+#include "OrnamentRuns.h"
+#include "NoiseTables.h"
+#include "FrameAllocations.h"
+#include "SettingsWatch.h"
+#include "SnapshotSchedule.h"
 
 #include <SKSE/SKSE.h>
 #include <algorithm>
 #include <atomic>
 #include <cctype>
+#include <chrono>
+#include <cstring>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -48,40 +61,6 @@ namespace Renderer
         return count;
     }
 
-    // Truncate UTF-8 string to maxChars codepoints
-    static std::string Utf8Truncate(const char *s, size_t maxChars)
-    {
-        if (!s || maxChars == 0)
-            return "";
-
-        const char *start = s;
-        size_t count = 0;
-
-        while (*s && count < maxChars)
-        {
-            unsigned char c = (unsigned char)*s;
-            if (c < 0x80)
-            {
-                s++;
-            }  // 1-byte (ASCII)
-            else if (c < 0xE0)
-            {
-                s += 2;
-            }  // 2-byte
-            else if (c < 0xF0)
-            {
-                s += 3;
-            }  // 3-byte
-            else
-            {
-                s += 4;
-            }  // 4-byte
-            count++;
-        }
-
-        return std::string(start, s - start);
-    }
-
     // Parse next UTF-8 codepoint, returns pointer to next char
     static const char *Utf8Next(const char *s, unsigned int &out)
     {
@@ -255,10 +234,10 @@ namespace Renderer
         bool initialized = false;              ///< True after first frame of data
         uint32_t lastSeenFrame = 0;            ///< Frame counter when actor was last in snapshot
 
-        uint32_t lastOcclusionCheckFrame = 0;  ///< Frame when LOS was last checked
-        bool cachedOccluded = false;           ///< Cached LOS result
         bool wasOccluded = false;              ///< Previous frame's occlusion state
 
+        float overlapOffsetY = 0.0f;           ///< Downward push from overlap prevention this frame
+
         static constexpr int kHistorySize = RenderConstants::kPositionHistorySize;
         ImVec2 posHistory[kHistorySize]{};
         int historyIndex = 0;
@@ -310,23 +289,21 @@ namespace Renderer
         bool isOccluded{false};                   ///< Whether actor is occluded from view
     };
 
-    /// Cache for smooth actor transitions, keyed by form ID
+    /// Cache for smooth actor transitions, keyed by form ID. Only the thread building
+    /// labels touches it: the render thread in Serial mode, the pipeline worker otherwise.
     static std::unordered_map<uint32_t, ActorCache> s_cache;
     /// Current frame counter for cache management
-    static uint32_t s_frame = 0;
-    /// Per-frame overlap Y offsets, keyed by form ID
-    static std::unordered_map<uint32_t, float>& OverlapOffsets() {
-        static std::unordered_map<uint32_t, float> offsets;
-        return offsets;
-    }
+    static std::atomic<uint32_t> s_frame{0};
 
-    /// Snapshot of actor data for rendering (thread-safe)
-    static std::vector<ActorDrawData> s_snapshot;
-    /// Mutex protecting the snapshot data
-    static std::mutex s_snapshotLock;
+    /// Actor deltas from the game thread to the render thread
+    static SnapshotDelta::Channel s_snapshotChannel;
+    /// Render thread's mirror of the game thread's snapshot
+    static SnapshotDelta::Table s_snapshotMirror;
+    /// Drawable view of the mirror, rebuilt when deltas arrive (render thread)
+    static std::vector<ActorDrawData> s_snapshotView;
 
-    /// Flag indicating if an update is currently queued
-    static std::atomic<bool> s_updateQueued{false};
+    /// Decides when the game thread scans actors: main loop hook or queued task
+    static SnapshotSchedule::Scheduler s_schedule;
     /// Frame counter for throttling updates
     static uint32_t s_updateTicker = 0;
 
@@ -340,19 +317,108 @@ namespace Renderer
     static int s_updateCounter = 0;
     static int s_lastUpdateCount = 0;
 
-    // Hot reload state
+    // Settings reload state
     static bool s_reloadKeyWasDown = false;
     static float s_lastReloadTime = -10.0f;  // Time of last reload (for notification)
     static constexpr float kReloadNotificationDuration = RenderConstants::kReloadNotificationDuration;
 
-    /// Atomic flag for whether overlay is allowed (checked by render thread)
-    static std::atomic<bool> s_allowOverlay{false};
+    /// Why the overlay is hidden: menu bits from events, world bits from the game thread
+    static OverlayState::Tracker s_overlayState;
     /// Manual toggle flag (can disable rendering via console command)
     static std::atomic<bool> s_manualEnabled{true};
 
+    /// Text block templates of the frame being built, per building thread
+    static thread_local LabelInstancing::Registry s_instances;
+
+    /// Ornament glyph runs per tier and special title; built on the render thread, read by builders
+    static OrnamentRuns::Table s_ornamentRuns;
+
+    /// Cache size for the debug overlay; the cache itself may be on the pipeline worker
+    static std::atomic<size_t> s_cacheSize{0};
+
+    /// Frame being built on the pipeline worker, null on the render thread
+    static thread_local const FramePipeline::FrameInput* s_buildInput = nullptr;
+
+    /// Animation time of the frame being built
+    static float FrameTime()
+    {
+        return s_buildInput ? static_cast<float>(s_buildInput->time) : static_cast<float>(ImGui::GetTime());
+    }
+
+    /// Delta time of the frame being built
+    static float FrameDeltaTime()
+    {
+        return s_buildInput ? s_buildInput->deltaTime : ImGui::GetIO().DeltaTime;
+    }
+
     bool IsOverlayAllowedRT() {
-        return s_manualEnabled.load(std::memory_order_acquire) &&
-               s_allowOverlay.load(std::memory_order_acquire);
+        return s_manualEnabled.load(std::memory_order_acquire) && s_overlayState.Allowed();
+    }
+
+    bool IsMenuBlockingRT() {
+        return (s_overlayState.Mask() & OverlayState::kMenuMask) != 0;
+    }
+
+    namespace
+    {
+        /// Flips the tracked menu bits as menus open and close (UI thread)
+        class MenuEventSink : public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+        {
+        public:
+            static MenuEventSink* GetSingleton()
+            {
+                static MenuEventSink singleton;
+                return std::addressof(singleton);
+            }
+
+            RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event,
+                                                  RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override
+            {
+                if (a_event) {
+                    s_overlayState.OnMenu(a_event->menuName.c_str(), a_event->opening);
+                }
+                return RE::BSEventNotifyControl::kContinue;
+            }
+        };
+    }
+
+    void RegisterEventSinks() {
+        auto* ui = RE::UI::GetSingleton();
+        if (!ui) {
+            SKSE::log::warn("Renderer: UI not available, overlay stays hidden");
+            return;
+        }
+
+        ui->AddEventSink<RE::MenuOpenCloseEvent>(MenuEventSink::GetSingleton());
+
+        // Menus already open (Main Menu, Fader) sent their events before we listened
+        std::uint32_t open = 0;
+        for (const auto name : OverlayState::kTrackedMenus) {
+            if (ui->IsMenuOpen(name)) {
+                open |= OverlayState::MenuBit(name);
+            }
+        }
+        s_overlayState.SeedMenus(open);
+        SKSE::log::info("Renderer: Registered menu event sink");
+    }
+
+    // World checks that have no event; game thread only
+    static std::uint32_t PollWorldBlockers()
+    {
+        auto* main = RE::Main::GetSingleton();
+        // "Loading is basically still happening" window
+        if (!main || !main->gameActive || main->freezeTime || main->freezeNextFrame || main->fullReset ||
+            main->resetGame || main->reloadContent) {
+            return OverlayState::kGameInactive;
+        }
+
+        auto* player = RE::PlayerCharacter::GetSingleton();
+        auto* cell = player ? player->GetParentCell() : nullptr;
+        if (!cell || !cell->IsAttached()) {
+            return OverlayState::kNoAttachedCell;
+        }
+
+        return player->IsInCombat() ? OverlayState::kInCombat : 0u;
     }
 
     bool ToggleEnabled() {
@@ -367,37 +433,6 @@ namespace Renderer
         return RE::PlayerCharacter::GetSingleton();
     }
 
-    // Capitalize text and trim whitespace
-    static std::string Capitalize(const char *text)
-    {
-        if (!text || !*text)
-            return "";
-        std::string s = text;
-
-        // Trim leading/trailing whitespace
-        size_t first = s.find_first_not_of(" \t\r\n");
-        if (std::string::npos == first)
-            return "";
-        size_t last = s.find_last_not_of(" \t\r\n");
-        s = s.substr(first, (last - first + 1));
-
-        // Title Case
-        bool newWord = true;
-        for (auto &c : s)
-        {
-            if (isspace(static_cast<unsigned char>(c)))
-            {
-                newWord = true;
-            }
-            else if (newWord)
-            {
-                c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
-                newWord = false;
-            }
-        }
-        return s;
-    }
-
     // Get actor's fight reaction towards player
     static RE::FIGHT_REACTION GetReactionToPlayer(RE::Actor *a_actor, RE::Actor *a_player)
     {
@@ -470,6 +505,18 @@ namespace Renderer
     // Project world position to screen coordinates
     bool WorldToScreen(const RE::NiPoint3 &worldPos, RE::NiPoint3 &screenPos, RE::NiPoint3 *cameraPosOut = nullptr)
     {
+        // Pipelined builds use the camera captured for their frame, not the live one
+        if (s_buildInput)
+        {
+            const auto &camera = s_buildInput->camera;
+            if (cameraPosOut)
+            {
+                *cameraPosOut = RE::NiPoint3(camera.position[0], camera.position[1], camera.position[2]);
+            }
+            const float world[3] = {worldPos.x, worldPos.y, worldPos.z};
+            return camera.Project(world, screenPos.x, screenPos.y, screenPos.z);
+        }
+
         // Get the main world camera
         auto *cam = RE::Main::WorldRootCamera();
         if (!cam)
@@ -515,45 +562,87 @@ namespace Renderer
     }
 
     /// Check occlusion for an actor, using cached results when available.
-    static void UpdateOcclusionForActor(ActorDrawData& d, RE::Actor* a, RE::Actor* player)
+    static void SetOccluded(SnapshotDelta::ActorState& d, bool occluded)
+    {
+        if (occluded)
+            d.flags |= SnapshotDelta::kOccluded;
+        else
+            d.flags &= ~SnapshotDelta::kOccluded;
+    }
+
+    static void SetAnchor(SnapshotDelta::ActorState& d, RE::Actor* a)
+    {
+        const auto pos = a->GetPosition();
+        d.pos[0] = pos.x;
+        d.pos[1] = pos.y;
+        d.pos[2] = pos.z + a->GetHeight() + Settings::VerticalOffset;
+    }
+
+    /// Last line of sight check of one actor
+    struct OcclusionCheck
+    {
+        uint32_t frame = 0;     ///< Frame when LOS was last checked
+        bool occluded = false;  ///< Its result
+    };
+
+    /// LOS results by form ID. Game thread only: s_cache belongs to the label build,
+    /// which may run on the pipeline worker at the same time.
+    static std::unordered_map<uint32_t, OcclusionCheck> s_occlusionChecks;
+    /// Set by a settings reload; the next scan drops s_occlusionChecks
+    static std::atomic<bool> s_occlusionChecksStale{false};
+
+    static void UpdateOcclusionForActor(SnapshotDelta::ActorState& d, RE::Actor* a, RE::Actor* player)
     {
-        auto cacheIt = s_cache.find(d.formID);
+        // The BVH backend answers every scan and paces its own game checks
+        if (static_cast<Occlusion::Backend>(Settings::OcclusionBackend) == Occlusion::Backend::Static) {
+            SetOccluded(d, Occlusion::IsActorOccludedStatic(a, player, RE::NiPoint3(d.pos[0], d.pos[1], d.pos[2])));
+            return;
+        }
+
+        auto [checkIt, inserted] = s_occlusionChecks.try_emplace(d.formID);
+        auto &check = checkIt->second;
 
         // Use cached result if fresh enough
-        if (cacheIt != s_cache.end() && cacheIt->second.initialized) {
-            uint32_t framesSince = s_frame - cacheIt->second.lastOcclusionCheckFrame;
+        if (!inserted) {
+            uint32_t framesSince = s_frame - check.frame;
             if (framesSince < static_cast<uint32_t>(Settings::OcclusionCheckInterval)) {
-                d.isOccluded = cacheIt->second.cachedOccluded;
+                SetOccluded(d, check.occluded);
                 return;
             }
         }
 
         // Perform fresh occlusion check using nameplate world position
-        d.isOccluded = Occlusion::IsActorOccluded(a, player, d.worldPos);
+        check.occluded = Occlusion::IsActorOccluded(a, player, RE::NiPoint3(d.pos[0], d.pos[1], d.pos[2]));
+        check.frame = s_frame;
+        SetOccluded(d, check.occluded);
+    }
+
+    /// Drop the checks of actors that have not been checked for a while (game thread).
+    static void PruneOcclusionChecks()
+    {
+        if (s_occlusionChecksStale.exchange(false, std::memory_order_acquire)) {
+            s_occlusionChecks.clear();
+            return;
+        }
 
-        // Update cache with the fresh result
-        if (cacheIt != s_cache.end()) {
-            cacheIt->second.lastOcclusionCheckFrame = s_frame;
-            cacheIt->second.cachedOccluded = d.isOccluded;
+        const uint32_t maxAge = static_cast<uint32_t>(Settings::OcclusionCheckInterval) + RenderConstants::kCacheGraceFrames;
+        for (auto it = s_occlusionChecks.begin(); it != s_occlusionChecks.end();) {
+            if (s_frame - it->second.frame > maxAge)
+                it = s_occlusionChecks.erase(it);
+            else
+                ++it;
         }
     }
 
     static void UpdateSnapshot_GameThread()
     {
-        // RAII struct to ensure the update flag is cleared when function exits
-        struct ClearFlag
-        {
-            ~ClearFlag() { s_updateQueued.store(false); }
-        } _;
-
-        // Check if we're allowed to draw the overlay (not in menus, loading, etc.)
-        const bool allow = CanDrawOverlay();
-        s_allowOverlay.store(allow, std::memory_order_release);
+        // Refresh the world bits; menu bits are kept current by MenuEventSink
+        s_overlayState.SetWorld(PollWorldBlockers());
+        const bool allow = s_overlayState.Allowed();
 
         if (!allow)
         {
-            std::lock_guard<std::mutex> lock(s_snapshotLock);
-            s_snapshot.clear();
+            s_snapshotChannel.Publish(nullptr, 0);
             return;
         }
 
@@ -561,8 +650,7 @@ namespace Renderer
         auto *pl = RE::ProcessLists::GetSingleton();
         if (!player || !pl)
         {
-            std::lock_guard<std::mutex> lock(s_snapshotLock);
-            s_snapshot.clear();
+            s_snapshotChannel.Publish(nullptr, 0);
             return;
         }
 
@@ -570,25 +658,26 @@ namespace Renderer
         constexpr int kMaxScan = RenderConstants::kMaxScan;
         const float kMaxDistSq = Settings::MaxScanDistance * Settings::MaxScanDistance;
 
-        static std::vector<ActorDrawData> tempBuf;
+        static std::vector<SnapshotDelta::ActorState> tempBuf;
         tempBuf.clear();
         tempBuf.reserve(kMaxActors);
 
+        PruneOcclusionChecks();
+
         const auto playerPos = player->GetPosition();
 
         // Include the player character first
         if (!Settings::HidePlayer)
         {
-            ActorDrawData d;
+            SnapshotDelta::ActorState d;
             d.formID = player->GetFormID();
             d.level = player->GetLevel();
             const char *rawName = player->GetDisplayFullName();
-            d.name = rawName ? Capitalize(rawName) : "Player";
-            d.worldPos = playerPos;
-            d.worldPos.z += player->GetHeight() + Settings::VerticalOffset;
+            d.SetName(rawName ? rawName : "Player");
+            SetAnchor(d, player);
             d.distToPlayer = 0.0f;
-            d.isPlayer = true;
-            tempBuf.push_back(std::move(d));
+            d.flags = SnapshotDelta::kPlayer;
+            tempBuf.push_back(d);
         }
 
         int added = 1;
@@ -640,50 +729,88 @@ namespace Renderer
             if (distSq > kMaxDistSq)
                 continue;
 
-            ActorDrawData d;
+            SnapshotDelta::ActorState d;
             d.formID = a->GetFormID();
             d.level = a->GetLevel();
-            const char *rawName = a->GetDisplayFullName();
-            d.name = rawName ? Capitalize(rawName) : "";
-            d.worldPos = a->GetPosition();
-            d.worldPos.z += a->GetHeight() + Settings::VerticalOffset;
+            d.SetName(a->GetDisplayFullName());
+            SetAnchor(d, a);
             d.distToPlayer = std::sqrt(distSq);
-            d.dispo = GetDisposition(a, player);
-            d.isPlayer = false;
+            d.disposition = static_cast<uint8_t>(GetDisposition(a, player));
 
             if (Settings::EnableOcclusionCulling)
                 UpdateOcclusionForActor(d, a, player);
 
-            tempBuf.push_back(std::move(d));
+            tempBuf.push_back(d);
             ++added;
         }
 
-        {
-            std::lock_guard<std::mutex> lock(s_snapshotLock);
-            s_snapshot = tempBuf;
-        }
+        Occlusion::EndScan();
+
+        // Only what changed since the last update reaches the render thread
+        s_snapshotChannel.Publish(tempBuf.data(), tempBuf.size());
+    }
+
+    // Rebuild the drawable view after the mirror changed (render thread)
+    static void RefreshSnapshotView()
+    {
+        const auto &actors = s_snapshotMirror.Actors();
+        bool actorSetChanged = s_snapshotView.size() != actors.size();
+        s_snapshotView.resize(actors.size());
+        for (size_t i = 0; i < actors.size(); ++i)
+        {
+            const auto &s = actors[i];
+            auto &d = s_snapshotView[i];
+            actorSetChanged |= d.formID != s.formID;
+            d.formID = s.formID;
+            d.worldPos = RE::NiPoint3(s.pos[0], s.pos[1], s.pos[2]);
+            d.name.assign(s.name, s.nameLength);
+            d.level = s.level;
+            d.distToPlayer = s.distToPlayer;
+            d.dispo = static_cast<Disposition>(s.disposition);
+            d.isPlayer = (s.flags & SnapshotDelta::kPlayer) != 0;
+            d.isOccluded = (s.flags & SnapshotDelta::kOccluded) != 0;
+        }
+
+        // New actors grow caches and buffers; only an unchanged set must not allocate
+        if (actorSetChanged)
+            FrameAllocations::OverlayMeter().Rearm();
+    }
+
+    /// Steady clock in seconds, shared by both threads for the scan lag
+    static double NowSeconds()
+    {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void RunSnapshotScan_GameThread()
+    {
+        const double scanTime = NowSeconds();
+        UpdateSnapshot_GameThread();
+        s_schedule.Scanned(scanTime);
     }
 
     static void QueueSnapshotUpdate_RenderThread()
     {
-        // Check if an update is already queued
-        // If exchange returns true, an update is already pending, so skip
-        if (s_updateQueued.exchange(true))
-        {
-            return;  // Already queued, don't queue again
-        }
+        s_schedule.SetMode(SnapshotSchedule::ModeFromInt(Settings::SnapshotUpdateMode));
+
+        // Arms the main loop hook, or asks for a task if it is off or silent
+        if (!s_schedule.BeginRenderFrame(NowSeconds()))
+            return;
 
-        // Schedule the update task on the game thread
         // We can't iterate actors safely from the render thread, so we
         // use SKSE's task interface to run on the game thread instead
         if (auto *task = SKSE::GetTaskInterface())
         {
-            task->AddTask([](){ UpdateSnapshot_GameThread(); });
+            task->AddTask([]() {
+                if (s_schedule.TaskStarted())
+                    RunSnapshotScan_GameThread();
+                s_schedule.TaskFinished();
+            });
         }
         else
         {
-            // Task interface not available, clear the flag
-            s_updateQueued.store(false);
+            s_schedule.TaskNotQueued();
         }
     }
 
@@ -717,6 +844,8 @@ namespace Renderer
             }
             ++it;
         }
+
+        s_cacheSize.store(s_cache.size(), std::memory_order_relaxed);
     }
 
     // Compute blend factor for frame-rate independent exponential smoothing.
@@ -741,6 +870,7 @@ namespace Renderer
         ImU32 outlineColor,
         float outlineWidth,
         float phase01,
+        float tier01,
         float strength,
         float textSizeScale,
         float alpha)
@@ -787,7 +917,7 @@ namespace Renderer
 
         case Settings::EffectType::PulseGradient:
         {
-            float time = (float)ImGui::GetTime();
+            float time = FrameTime();
             TextEffects::AddTextOutline4PulseGradient(drawList, font, fontSize, pos, text,
                                                       colL, colR, time, effect.param1, effect.param2 * strength, outlineColor, outlineWidth);
         }
@@ -845,7 +975,83 @@ namespace Renderer
                                                  effect.param2 > 0.0f ? effect.param2 : 0.15f,
                                                  effect.param3 > 0.0f ? effect.param3 * strength : strength);
             break;
+
+        case Settings::EffectType::Custom:
+        {
+            // [CustomEffects] program: param1-5 are p1-p5, resolved at load
+            const float params[5] = {effect.param1, effect.param2, effect.param3, effect.param4, effect.param5};
+            const int index = effect.customEffect;
+            if (index >= 0 && index < static_cast<int>(Settings::CustomEffects.size()))
+            {
+                TextEffects::AddTextOutline4Program(drawList, font, fontSize, pos, text,
+                                                    Settings::CustomEffects[index].program,
+                                                    colL, colR, highlight, outlineColor, outlineWidth,
+                                                    phase01, tier01, params);
+            }
+            else
+            {
+                TextEffects::AddTextOutline4Gradient(drawList, font, fontSize, pos, text,
+                                                     colL, colR, outlineColor, outlineWidth);
+            }
+        }
+        break;
+        }
+    }
+
+    // Fade in the glyphs of one piece of label text for the typewriter reveal.
+    // Everything drawn since vtxStart (glow, shadow, outline, effect) is masked.
+    static void ApplyTypewriterMask(ImDrawList *drawList, int vtxStart, ImFont *font, float fontSize,
+                                    const ImVec2 &pos, const char *text, int firstChar,
+                                    float progress, float softness)
+    {
+        static thread_local TypewriterMask::GlyphMap glyphs;
+        glyphs.Clear();
+
+        const float scale = fontSize / font->FontSize;
+        for (const char *p = text; *p;)
+        {
+            unsigned int cp = 0;
+            p = Utf8Next(p, cp);
+            const ImFontGlyph *glyph = font->FindGlyph(static_cast<ImWchar>(cp));
+            if (glyph)
+                glyphs.AddChar(glyph->AdvanceX * scale, glyph->Visible, glyph->U0, glyph->V0);
+            else
+                glyphs.AddChar(0.0f, false);
         }
+
+        // ImGui starts a run at the truncated x position
+        TypewriterMask::Apply(drawList->VtxBuffer.Data + vtxStart,
+                              static_cast<size_t>(drawList->VtxBuffer.Size - vtxStart),
+                              std::floor(pos.x), glyphs, firstChar, progress, softness);
+    }
+
+    // True if an effect's colors depend on the per-actor phase seed
+    static bool IsPhaseDependent(Settings::EffectType type)
+    {
+        return type == Settings::EffectType::Shimmer ||
+               type == Settings::EffectType::ChromaticShimmer ||
+               type == Settings::EffectType::Custom;
+    }
+
+    // Copy a group's template text block to another anchor, scale and alpha
+    static void DrawInstance(const LabelInstancing::Template &tpl, ImDrawList *drawList, ImTextureID fontTexture,
+                             const ImVec2 &anchor, float scale, float alpha)
+    {
+        // Particles drawn before the text may have left a sprite texture current
+        drawList->PushTextureID(fontTexture);
+        drawList->PrimReserve(static_cast<int>(tpl.idxCount), static_cast<int>(tpl.vtxCount));
+
+        // Read the template after PrimReserve, which may grow the buffers
+        const auto transform = LabelInstancing::MakeTransform(tpl, anchor.x, anchor.y, scale, alpha);
+        LabelInstancing::CopyVertices(drawList->VtxBuffer.Data + tpl.vtxStart, drawList->_VtxWritePtr,
+                                      tpl.vtxCount, transform);
+        LabelInstancing::CopyIndices(drawList->IdxBuffer.Data + tpl.idxStart, drawList->_IdxWritePtr,
+                                     tpl.idxCount, tpl.idxBase, drawList->_VtxCurrentIdx);
+
+        drawList->_VtxWritePtr += tpl.vtxCount;
+        drawList->_IdxWritePtr += tpl.idxCount;
+        drawList->_VtxCurrentIdx += tpl.vtxCount;
+        drawList->PopTextureID();
     }
 
     static void DrawLabel(const ActorDrawData &d, ImDrawList *drawList)
@@ -862,6 +1068,9 @@ namespace Renderer
         auto &entry = it->second;
         entry.lastSeenFrame = s_frame;  // Always update last seen
 
+        // Animated effect colors are evaluated at capped, per-label staggered rates
+        TextEffects::BeginEffectLabel(d.formID);
+
         // Detect name changes (e.g., after showracemenu) and reset typewriter
         if (entry.cachedName != d.name)
         {
@@ -889,14 +1098,20 @@ namespace Renderer
         // Get camera position for camera-relative scaling
         RE::NiPoint3 cameraPos{};
         bool hasCameraPos = false;
-        if (auto pc = RE::PlayerCamera::GetSingleton(); pc && pc->cameraRoot)
+        if (s_buildInput)
+        {
+            const auto &camera = s_buildInput->camera;
+            cameraPos = RE::NiPoint3(camera.position[0], camera.position[1], camera.position[2]);
+            hasCameraPos = true;
+        }
+        else if (auto pc = RE::PlayerCamera::GetSingleton(); pc && pc->cameraRoot)
         {
             cameraPos = pc->cameraRoot->world.translate;
             hasCameraPos = true;
         }
 
         const float dist = d.distToPlayer;          // Player-to-actor distance in game units
-        const float dt = ImGui::GetIO().DeltaTime;  // Time since last frame
+        const float dt = FrameDeltaTime();  // Time since last frame
 
         // Calculate alpha target based on distance
         // Uses smooth interpolation to avoid harsh transitions
@@ -1071,7 +1286,7 @@ namespace Renderer
             return;  // Off-screen, skip
         }
 
-        const float time = (float)ImGui::GetTime();  // For animations
+        const float time = FrameTime();  // For animations
 
         // Helper lambda, "Wash" colors toward white for a softer appearance
         // Higher wash value = more white, less saturated
@@ -1116,33 +1331,14 @@ namespace Renderer
         bool tierAllowsOrnaments = !Settings::Visual().EnableTierEffectGating || tierIdx >= Settings::Visual().OrnamentMinTier;
 
         // Check for special title match
-        // Special titles override normal tier styling for MMORPG-style nameplates
+        // Special titles override normal tier styling for MMORPG-style nameplates.
+        // The highest priority match wins; ties go to the first defined.
         const Settings::SpecialTitleDefinition* specialTitle = nullptr;
-        {
-            // Convert name to lowercase for case-insensitive matching
-            std::string nameLower = d.name;
-            std::transform(nameLower.begin(), nameLower.end(), nameLower.begin(),
-                           [](unsigned char c) { return std::tolower(c); });
-
-            // Sort by priority and check each special title
-            std::vector<const Settings::SpecialTitleDefinition*> sortedSpecials;
-            for (const auto& st : Settings::SpecialTitles) {
-                if (!st.keyword.empty()) {
-                    sortedSpecials.push_back(&st);
-                }
-            }
-            std::sort(sortedSpecials.begin(), sortedSpecials.end(),
-                      [](const auto* a, const auto* b) { return a->priority > b->priority; });
-
-            for (const auto* st : sortedSpecials) {
-                std::string keywordLower = st->keyword;
-                std::transform(keywordLower.begin(), keywordLower.end(), keywordLower.begin(),
-                               [](unsigned char c) { return std::tolower(c); });
-                if (nameLower.find(keywordLower) != std::string::npos) {
-                    specialTitle = st;
-                    break;
-                }
-            }
+        for (const auto& st : Settings::SpecialTitles) {
+            if (st.keyword.empty() || (specialTitle && st.priority <= specialTitle->priority))
+                continue;
+            if (LabelText::ContainsNoCase(d.name, st.keyword))
+                specialTitle = &st;
         }
 
         // Calculate position within tier [0, 1]
@@ -1305,71 +1501,34 @@ namespace Renderer
 
         // Calculate animation phase [0, 1] for this actor
         // Each actor gets a unique seed based on form ID to prevent synchronization
-        const float phaseSeed = (d.formID & 1023) / 1023.0f;           // Unique seed per actor
+        const float phaseSeed = LabelInstancing::PhaseSeed(d.formID, Settings::EnableInstancing);  // Seed per actor
         const float phase01 = frac(time * tierAnimSpeed + phaseSeed);  // Animated phase
-
-        // Format string replacement
-        // Replaces placeholders: %n = name, %l = level, %t = title
-        auto FormatString = [&](const std::string &fmt, const char *nameVal, int levelVal, const char *titleVal = nullptr)
-        {
-            std::string s = fmt;
-
-            // Replace %n with actor name
-            size_t pos = 0;
-            while ((pos = s.find("%n", pos)) != std::string::npos)
-            {
-                s.replace(pos, 2, nameVal);
-                pos += strlen(nameVal);  // Move past replacement to avoid infinite loop
-            }
-
-            // Replace %l with actor level
-            pos = 0;
-            std::string lStr = std::to_string(levelVal);
-            while ((pos = s.find("%l", pos)) != std::string::npos)
-            {
-                s.replace(pos, 2, lStr);
-                pos += lStr.length();
-            }
-
-            // Replace %t with tier title
-            if (titleVal)
-            {
-                pos = 0;
-                while ((pos = s.find("%t", pos)) != std::string::npos)
-                {
-                    s.replace(pos, 2, titleVal);
-                    pos += strlen(titleVal);
-                }
-            }
-            return s;
-        };
+        const float tier01 = Settings::Tiers.size() > 1
+                                 ? static_cast<float>(tierIdx) / static_cast<float>(Settings::Tiers.size() - 1)
+                                 : 0.0f;  // Tier position for custom effects
 
         // Render segment
         struct RenderSeg
         {
             std::string text;         ///< Formatted text to display
-            std::string displayText;  ///< Text after typewriter truncation
             bool isLevel;             ///< Whether to use level font
             ImFont *font;             ///< Font to use for rendering
             float fontSize;           ///< Scaled font size
             ImVec2 size;              ///< Measured size of this segment
-            ImVec2 displaySize;       ///< Measured size of displayText
+            int firstChar;            ///< Index of the first character for the typewriter
         };
 
-        // Calculate how many characters should be visible based on time elapsed
-        int typewriterCharsToShow = -1;  // -1 = show all (disabled or complete)
-        if (Settings::EnableTypewriter && !entry.typewriterComplete)
-        {
-            float effectiveTime = entry.typewriterTime - Settings::TypewriterDelay;
-            if (effectiveTime > 0.0f)
-            {
-                typewriterCharsToShow = static_cast<int>(effectiveTime * Settings::TypewriterSpeed);
-            }
-            else
-            {
-                typewriterCharsToShow = 0;  // Still in delay period
-            }
-        }
+        // Characters revealed so far; text is always built in full and masked
+        const bool typewriterActive = Settings::EnableTypewriter && !entry.typewriterComplete;
+        const float typewriterProgress = typewriterActive
+            ? TypewriterMask::Progress(entry.typewriterTime, Settings::TypewriterDelay, Settings::TypewriterSpeed)
+            : 0.0f;
+        const float typewriterSoftness = Settings::TypewriterSoftness;
+
+        // True if any character of a piece starting at firstChar is visible
+        auto typewriterShows = [&](int firstChar) {
+            return !typewriterActive || TypewriterMask::CharAlpha(typewriterProgress, firstChar, typewriterSoftness) > 0.0f;
+        };
 
         // Get fonts loaded in Hooks.cpp (Index 0 = name, 1 = level, 2 = title)
         ImFont *fontName = ImGui::GetIO().Fonts->Fonts[0];
@@ -1392,23 +1551,27 @@ namespace Renderer
         // Use space if name is empty
         const char *safeName = d.name.empty() ? " " : d.name.c_str();
 
-        // Build segments for the main line
-        std::vector<RenderSeg> segments;
+        // Build segments for the main line. Segments and their strings are
+        // reused across labels and frames, so a steady scene does not allocate.
+        static thread_local std::vector<RenderSeg> segments;
         float mainLineWidth = 0.0f;   // Total width of all segments
         float mainLineHeight = 0.0f;  // Height of tallest segment
 
         // Use default format if settings not loaded or empty
         // Default: "%n Lv.%l" (e.g., "Lydia Lv.42")
-        const auto &fmtList = Settings::DisplayFormat.empty() ? std::vector<Settings::Segment>{{"%n", false}, {" Lv.%l", true}} : Settings::DisplayFormat;
+        static const std::vector<Settings::Segment> kDefaultFormat{{"%n", false}, {" Lv.%l", true}};
+        const auto &fmtList = Settings::DisplayFormat.empty() ? kDefaultFormat : Settings::DisplayFormat;
+        segments.resize(fmtList.size());
 
         // Track total characters for typewriter effect
-        int totalCharsProcessed = 0;
+        int totalChars = 0;
 
         // Process each segment in the format list
-        for (const auto &fmt : fmtList)
+        for (size_t i = 0; i < fmtList.size(); ++i)
         {
-            RenderSeg seg;
-            seg.text = FormatString(fmt.format, safeName, d.level);  // Replace placeholders
+            const auto &fmt = fmtList[i];
+            RenderSeg &seg = segments[i];
+            LabelText::Format(seg.text, fmt.format, safeName, d.level);  // Replace placeholders
             seg.isLevel = fmt.useLevelFont;                          // Choose font
             seg.font = seg.isLevel ? fontLevel : fontName;
             seg.fontSize = seg.isLevel ? levelFontSize : nameFontSize;
@@ -1416,34 +1579,9 @@ namespace Renderer
             // Measure the rendered size of this segment
             seg.size = seg.font->CalcTextSizeA(seg.fontSize, FLT_MAX, 0.0f, seg.text.c_str());
 
-            // Apply typewriter truncation if active
-            if (typewriterCharsToShow >= 0)
-            {
-                size_t segCharCount = Utf8CharCount(seg.text.c_str());
-                int charsRemaining = typewriterCharsToShow - totalCharsProcessed;
-                if (charsRemaining <= 0)
-                {
-                    seg.displayText = "";  // No characters visible yet
-                }
-                else if (static_cast<size_t>(charsRemaining) >= segCharCount)
-                {
-                    seg.displayText = seg.text;  // Show full segment
-                }
-                else
-                {
-                    seg.displayText = Utf8Truncate(seg.text.c_str(), charsRemaining);
-                }
-                totalCharsProcessed += static_cast<int>(segCharCount);
-            }
-            else
-            {
-                seg.displayText = seg.text;  // Typewriter disabled, show full text
-            }
+            seg.firstChar = totalChars;
+            totalChars += static_cast<int>(Utf8CharCount(seg.text.c_str()));
 
-            // Measure display text size
-            seg.displaySize = seg.font->CalcTextSizeA(seg.fontSize, FLT_MAX, 0.0f, seg.displayText.c_str());
-
-            segments.push_back(seg);
             mainLineWidth += seg.size.x;  // Use full width for layout
             if (seg.size.y > mainLineHeight)
                 mainLineHeight = seg.size.y;  // Track tallest
@@ -1460,37 +1598,20 @@ namespace Renderer
         // Format the title text, displayed above main line
         // Special titles override the tier title with their custom display title
         const char* titleToUse = specialTitle ? specialTitle->displayTitle.c_str() : tier.title.c_str();
-        std::string titleStr = FormatString(Settings::TitleFormat, safeName, d.level, titleToUse);
-        std::string titleDisplayStr = titleStr;
+        static thread_local std::string titleStr;
+        LabelText::Format(titleStr, Settings::TitleFormat, safeName, d.level, titleToUse);
 
-        // Apply typewriter truncation to title
-        if (typewriterCharsToShow >= 0)
-        {
-            size_t titleCharCount = Utf8CharCount(titleStr.c_str());
-            int charsRemainingForTitle = typewriterCharsToShow - totalCharsProcessed;
-            if (charsRemainingForTitle <= 0)
-            {
-                titleDisplayStr = "";
-            }
-            else if (static_cast<size_t>(charsRemainingForTitle) >= titleCharCount)
-            {
-                titleDisplayStr = titleStr;
-            }
-            else
-            {
-                titleDisplayStr = Utf8Truncate(titleStr.c_str(), charsRemainingForTitle);
-            }
-            totalCharsProcessed += static_cast<int>(titleCharCount);
+        // Title characters follow the main line's
+        const int titleFirstChar = totalChars;
+        totalChars += static_cast<int>(Utf8CharCount(titleStr.c_str()));
 
-            // Check if typewriter is complete (all text revealed)
-            if (!entry.typewriterComplete && typewriterCharsToShow >= totalCharsProcessed)
-            {
-                entry.typewriterComplete = true;
-            }
+        // Check if typewriter is complete (every character fully opaque)
+        if (typewriterActive && typewriterProgress >= static_cast<float>(totalChars))
+        {
+            entry.typewriterComplete = true;
         }
 
         const char *titleText = titleStr.c_str();
-        const char *titleDisplayText = titleDisplayStr.c_str();
 
         // Calculate tight vertical bounds for precise positioning
         // Title bounds, relative to baseline
@@ -1551,9 +1672,7 @@ namespace Renderer
         // Apply overlap prevention offset
         if (Settings::Visual().EnableOverlapPrevention)
         {
-            auto oIt = OverlapOffsets().find(d.formID);
-            if (oIt != OverlapOffsets().end())
-                startPos.y += oIt->second;
+            startPos.y += entry.overlapOffsetY;
         }
 
         // Total width is the larger of main line or title
@@ -1695,42 +1814,14 @@ namespace Renderer
         ImFont* ornamentFont = (ornIo.Fonts->Fonts.Size >= 4) ? ornIo.Fonts->Fonts[3] : nullptr;
         if (showOrnaments && !Settings::OrnamentFontPath.empty() && ornamentFont)
         {
-            // Keep only valid UTF-8 ornaments with an actual glyph in the ornament font.
-            auto collectDrawableOrnaments = [&](const std::string& raw) {
-                std::vector<std::string> out;
-                const char* p = raw.c_str();
-                while (*p) {
-                    unsigned int cp = 0;
-                    const char* next = Utf8Next(p, cp);
-                    if (!next || next <= p) {
-                        ++p;
-                        continue;
-                    }
-
-                    // Skip invalid and control codepoints to avoid tofu blocks.
-                    if (cp == 0xFFFD || cp < 0x20) {
-                        p = next;
-                        continue;
-                    }
-
-                    const ImFontGlyph* glyph = nullptr;
-#if defined(IMGUI_VERSION_NUM) && IMGUI_VERSION_NUM >= 18804
-                    glyph = ornamentFont->FindGlyphNoFallback(static_cast<ImWchar>(cp));
-#else
-                    glyph = ornamentFont->FindGlyph(static_cast<ImWchar>(cp));
-#endif
-                    if (glyph) {
-                        out.emplace_back(p, static_cast<size_t>(next - p));
-                    }
-
-                    p = next;
-                }
-                return out;
-            };
-
-            const auto leftChars = collectDrawableOrnaments(leftOrns);
-            const auto rightChars = collectDrawableOrnaments(rightOrns);
-            if (leftChars.empty() && rightChars.empty()) {
+            // Drawable glyphs and advances were resolved at settings load (see OrnamentRuns)
+            const auto &tierRuns = s_ornamentRuns.Tier(static_cast<size_t>(tierIdx));
+            const auto &specialRuns = specialTitle
+                ? s_ornamentRuns.Special(static_cast<size_t>(specialTitle - Settings::SpecialTitles.data()))
+                : tierRuns;
+            const auto &leftRun = (specialTitle && !specialTitle->leftOrnaments.empty()) ? specialRuns.left : tierRuns.left;
+            const auto &rightRun = (specialTitle && !specialTitle->rightOrnaments.empty()) ? specialRuns.right : tierRuns.right;
+            if (leftRun.Empty() && rightRun.Empty()) {
                 // All configured ornaments were invalid or missing from font.
                 // Skip drawing instead of rendering fallback block glyphs.
             } else {
@@ -1770,38 +1861,37 @@ namespace Renderer
                 }
                 ApplyTextEffect(drawList, ornamentFont, ornamentSize, charPos, ch,
                                 tier.nameEffect, ornColL, ornColR, ornHighlight, ornOutline, ornOutlineWidth,
-                                phase01, strength, textSizeScale, alpha);
+                                phase01, tier01, strength, textSizeScale, alpha);
             };
 
-            // Use UTF-8 aware iteration for multi-byte characters
-            if (!leftChars.empty())
+            // A single glyph is its scaled advance wide and one font size tall
+            const float glyphScale = ornamentSize / ornamentFont->FontSize;
+            const float charTop = nameplateCenter.y - ornamentSize * 0.5f;
+
+            if (!leftRun.Empty())
             {
                 float cursorX = nameplateCenter.x - nameplateWidth * 0.5f - totalSpacing;
                 // Draw characters in reverse order
-                for (int i = static_cast<int>(leftChars.size()) - 1; i >= 0; --i)
+                for (int i = static_cast<int>(leftRun.glyphs.size()) - 1; i >= 0; --i)
                 {
-                    const std::string& ch = leftChars[i];
-                    ImVec2 charSize = ornamentFont->CalcTextSizeA(ornamentSize, FLT_MAX, 0.0f, ch.c_str());
-                    cursorX -= charSize.x;
-                    ImVec2 charPos(cursorX, nameplateCenter.y - charSize.y * 0.5f);
-                    drawOrnChar(charPos, ch.c_str());
+                    const auto &glyph = leftRun.glyphs[i];
+                    cursorX -= glyph.advance * glyphScale;
+                    drawOrnChar(ImVec2(cursorX, charTop), glyph.utf8.data());
                     if (i > 0) {
                         cursorX -= ornamentCharGap;
                     }
                 }
             }
 
-            if (!rightChars.empty())
+            if (!rightRun.Empty())
             {
                 float cursorX = nameplateCenter.x + nameplateWidth * 0.5f + totalSpacing;
-                for (size_t i = 0; i < rightChars.size(); ++i)
+                for (size_t i = 0; i < rightRun.glyphs.size(); ++i)
                 {
-                    const std::string& ch = rightChars[i];
-                    ImVec2 charSize = ornamentFont->CalcTextSizeA(ornamentSize, FLT_MAX, 0.0f, ch.c_str());
-                    ImVec2 charPos(cursorX, nameplateCenter.y - charSize.y * 0.5f);
-                    drawOrnChar(charPos, ch.c_str());
-                    cursorX += charSize.x;
-                    if (i + 1 < rightChars.size()) {
+                    const auto &glyph = rightRun.glyphs[i];
+                    drawOrnChar(ImVec2(cursorX, charTop), glyph.utf8.data());
+                    cursorX += glyph.advance * glyphScale;
+                    if (i + 1 < rightRun.glyphs.size()) {
                         cursorX += ornamentCharGap;
                     }
                 }
@@ -1809,8 +1899,48 @@ namespace Renderer
             }
         }
 
+        // Identical NPC plates build their text block once per frame; the
+        // other members of a group copy it (see LabelInstancing)
+        const bool instanceable = Settings::EnableInstancing && !d.isPlayer && !typewriterActive &&
+                                  (lodTitleFactor >= 0.99f || lodTitleFactor <= 0.01f);
+        std::uint64_t instanceKey = 0;
+        if (instanceable)
+        {
+            LabelInstancing::KeyBuilder key;
+            for (const auto &seg : segments)
+                key.Add(seg.text).Add(seg.isLevel);
+            key.Add(titleStr)
+                .Add(tierIdx)
+                .Add(static_cast<int>(d.dispo))
+                .Add(LabelInstancing::ScaleBucket(textSizeScale))
+                .Add(lodTitleFactor > 0.01f);
+            if (Settings::Visual().EnableDistanceOutlineScale)
+            {
+                const float distT = TextEffects::Saturate(
+                    (d.distToPlayer - Settings::FadeStartDistance) /
+                    (Settings::FadeEndDistance - Settings::FadeStartDistance));
+                key.Add(static_cast<int>(distT * 32.0f));
+            }
+            if (IsPhaseDependent(tier.levelEffect.type))
+                key.Add(static_cast<int>(phaseSeed * LabelInstancing::kPhaseBuckets));
+            instanceKey = key.Value();
+
+            const auto *tpl = s_instances.Find(instanceKey);
+            if (tpl && LabelInstancing::CanInstance(*tpl, alpha))
+            {
+                DrawInstance(*tpl, drawList, fontName->ContainerAtlas->TexID, startPos, textSizeScale, alpha);
+                s_instances.CountInstance();
+                return;
+            }
+        }
+
+        const int blockVtxStart = drawList->VtxBuffer.Size;
+        const int blockIdxStart = drawList->IdxBuffer.Size;
+        const unsigned int blockVtxOffset = drawList->_CmdHeader.VtxOffset;
+        const unsigned int blockIdxBase = drawList->_VtxCurrentIdx;
+
         // Render Title, if present and has visible characters (LOD: hidden at far distance)
-        if (titleDisplayText && *titleDisplayText && lodTitleFactor > 0.01f)
+        if (titleText && *titleText && lodTitleFactor > 0.01f && typewriterShows(titleFirstChar))
         {
             // Center title horizontally within totalWidth
             float titleOffsetX = (totalWidth - titleSize.x) * 0.5f;
@@ -1821,6 +1951,7 @@ namespace Renderer
             float lodTitleAlpha = alpha * lodTitleFactor;
             ImU32 titleColor = ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, lodTitleAlpha));
             ImU32 titleShadow = ImGui::ColorConvertFloat4ToU32(ImVec4(0, 0, 0, lodTitleAlpha * 0.5f));
+            const int titleVtxStart = drawList->VtxBuffer.Size;
 
             // Draw glow behind title
             if (Settings::EnableGlow && Settings::GlowIntensity > 0.0f && tierAllowsGlow)
@@ -1834,7 +1965,7 @@ namespace Renderer
                 float glowIntensity = specialTitle ? Settings::GlowIntensity * 1.15f : Settings::GlowIntensity;
                 float glowRadius = specialTitle ? Settings::GlowRadius * 1.1f : Settings::GlowRadius;
                 TextEffects::AddTextGlow(drawList, fontTitle, titleFontSize, titlePos,
-                                         titleDisplayText, glowColor, glowRadius,
+                                         titleText, glowColor, glowRadius,
                                          glowIntensity, Settings::GlowSamples);
             }
 
@@ -1842,15 +1973,15 @@ namespace Renderer
             drawList->AddText(fontTitle, titleFontSize,
                               ImVec2(titlePos.x + Settings::TitleShadowOffsetX,
                                      titlePos.y + Settings::TitleShadowOffsetY),
-                              titleShadow, titleDisplayText);
+                              titleShadow, titleText);
 
             float lodTitleAlphaFinal = titleAlpha * lodTitleFactor;
             if (d.isPlayer)
             {
                 // Apply tier-defined visual effect
-                ApplyTextEffect(drawList, fontTitle, titleFontSize, titlePos, titleDisplayText,
+                ApplyTextEffect(drawList, fontTitle, titleFontSize, titlePos, titleText,
                                 tier.titleEffect, colLTitle, colRTitle, highlight, outlineColor, titleOutlineWidth,
-                                phase01, strength, textSizeScale, lodTitleAlphaFinal);
+                                phase01, tier01, strength, textSizeScale, lodTitleAlphaFinal);
             }
             else
             {
@@ -1859,8 +1990,12 @@ namespace Renderer
                 dColV.w = lodTitleAlphaFinal;
                 ImU32 dCol = ImGui::ColorConvertFloat4ToU32(dColV);
                 ImU32 npcOutline = ImGui::ColorConvertFloat4ToU32(ImVec4(0, 0, 0, lodTitleAlphaFinal));
-                TextEffects::AddTextOutline4(drawList, fontTitle, titleFontSize, titlePos, titleDisplayText, dCol, npcOutline, titleOutlineWidth);
+                TextEffects::AddTextOutline4(drawList, fontTitle, titleFontSize, titlePos, titleText, dCol, npcOutline, titleOutlineWidth);
             }
+
+            if (typewriterActive)
+                ApplyTypewriterMask(drawList, titleVtxStart, fontTitle, titleFontSize, titlePos, titleText,
+                                    titleFirstChar, typewriterProgress, typewriterSoftness);
         }
 
         // Render Main Line
@@ -1873,7 +2008,7 @@ namespace Renderer
         for (const auto &seg : segments)
         {
             // Skip segments with no visible text, typewriter hasn't reached them yet
-            if (seg.displayText.empty())
+            if (!typewriterShows(seg.firstChar))
             {
                 // Still advance position to maintain layout
                 currentPos.x += seg.size.x + segmentPadding;
@@ -1885,6 +2020,7 @@ namespace Renderer
             float vOffset = (mainLineHeight - seg.size.y) * 0.5f;
 
             ImVec2 pos = ImVec2(currentPos.x, currentPos.y + vOffset);
+            const int segVtxStart = drawList->VtxBuffer.Size;
 
             // Draw glow behind segment
             if (Settings::EnableGlow && Settings::GlowIntensity > 0.0f && tierAllowsGlow)
@@ -1899,7 +2035,7 @@ namespace Renderer
                 float glowIntensity = specialTitle ? Settings::GlowIntensity * 1.15f : Settings::GlowIntensity;
                 float glowRadius = specialTitle ? Settings::GlowRadius * 1.1f : Settings::GlowRadius;
                 TextEffects::AddTextGlow(drawList, seg.font, seg.fontSize, pos,
-                                         seg.displayText.c_str(), glowColor, glowRadius,
+                                         seg.text.c_str(), glowColor, glowRadius,
                                          glowIntensity, Settings::GlowSamples);
             }
 
@@ -1907,7 +2043,7 @@ namespace Renderer
             drawList->AddText(seg.font, seg.fontSize,
                               ImVec2(pos.x + Settings::MainShadowOffsetX,
                                      pos.y + Settings::MainShadowOffsetY),
-                              shadowColor, seg.displayText.c_str());
+                              shadowColor, seg.text.c_str());
 
             // Draw main text with appropriate styling
             // Use font-appropriate outline width
@@ -1917,9 +2053,9 @@ namespace Renderer
             {
                 // Level segment, apply tier-defined level effect
                 // All actors use tier effects for level
-                ApplyTextEffect(drawList, seg.font, seg.fontSize, pos, seg.displayText.c_str(),
+                ApplyTextEffect(drawList, seg.font, seg.fontSize, pos, seg.text.c_str(),
                                 tier.levelEffect, colLLevel, colRLevel, highlight, outlineColor, segOutlineWidth,
-                                phase01, strength, textSizeScale, levelAlpha);
+                                phase01, tier01, strength, textSizeScale, levelAlpha);
             }
             else
             {
@@ -1927,9 +2063,9 @@ namespace Renderer
                 if (d.isPlayer)
                 {
                     // Apply tier-defined name effect
-                    ApplyTextEffect(drawList, seg.font, seg.fontSize, pos, seg.displayText.c_str(),
+                    ApplyTextEffect(drawList, seg.font, seg.fontSize, pos, seg.text.c_str(),
                                     tier.nameEffect, colL, colR, highlight, outlineColor, segOutlineWidth,
-                                    phase01, strength, textSizeScale, alpha);
+                                    phase01, tier01, strength, textSizeScale, alpha);
                 }
                 else
                 {
@@ -1938,13 +2074,45 @@ namespace Renderer
                     dColV.w = alpha;
                     ImU32 dCol = ImGui::ColorConvertFloat4ToU32(dColV);
                     ImU32 npcOutline = ImGui::ColorConvertFloat4ToU32(ImVec4(0, 0, 0, alpha));
-                    TextEffects::AddTextOutline4(drawList, seg.font, seg.fontSize, pos, seg.displayText.c_str(), dCol, npcOutline, segOutlineWidth);
+                    TextEffects::AddTextOutline4(drawList, seg.font, seg.fontSize, pos, seg.text.c_str(), dCol, npcOutline, segOutlineWidth);
                 }
             }
 
+            if (typewriterActive)
+                ApplyTypewriterMask(drawList, segVtxStart, seg.font, seg.fontSize, pos, seg.text.c_str(),
+                                    seg.firstChar, typewriterProgress, typewriterSoftness);
+
             // Move to next segment position
             currentPos.x += seg.size.x + segmentPadding;
         }
+
+        // Register the block as its group's template. ImGui drops glyphs that
+        // are clipped entirely, so only blocks well inside the clip rect qualify,
+        // and only if they stayed within one vertex offset.
+        if (instanceable && drawList->VtxBuffer.Size > blockVtxStart &&
+            drawList->_CmdHeader.VtxOffset == blockVtxOffset)
+        {
+            const float margin = Settings::GlowRadius * 1.65f + outlineWidth * 2.0f +
+                                 std::max(std::abs(Settings::MainShadowOffsetX), std::abs(Settings::TitleShadowOffsetX)) +
+                                 std::max(std::abs(Settings::MainShadowOffsetY), std::abs(Settings::TitleShadowOffsetY)) + 8.0f;
+            const ImVec2 clipMin = drawList->GetClipRectMin();
+            const ImVec2 clipMax = drawList->GetClipRectMax();
+            if (nameplateLeft - margin >= clipMin.x && nameplateRight + margin <= clipMax.x &&
+                nameplateTop - margin >= clipMin.y && nameplateBottom + margin <= clipMax.y)
+            {
+                LabelInstancing::Template tpl;
+                tpl.vtxStart = static_cast<std::uint32_t>(blockVtxStart);
+                tpl.vtxCount = static_cast<std::uint32_t>(drawList->VtxBuffer.Size - blockVtxStart);
+                tpl.idxStart = static_cast<std::uint32_t>(blockIdxStart);
+                tpl.idxCount = static_cast<std::uint32_t>(drawList->IdxBuffer.Size - blockIdxStart);
+                tpl.idxBase = blockIdxBase;
+                tpl.anchorX = startPos.x;
+                tpl.anchorY = startPos.y;
+                tpl.scale = textSizeScale;
+                tpl.alpha = alpha;
+                s_instances.Add(instanceKey, tpl);
+            }
+        }
     }
 
     // Draw debug overlay with performance stats
@@ -1963,7 +2131,7 @@ namespace Renderer
         );
 
         // Update cache stats
-        s_debugStats.cacheSize = s_cache.size();
+        s_debugStats.cacheSize = s_cacheSize.load(std::memory_order_relaxed);
 
         // Build context and render
         DebugOverlay::Context ctx;
@@ -1974,32 +2142,146 @@ namespace Renderer
         ctx.actorCacheEntrySize = sizeof(ActorCache);
         ctx.actorDrawDataSize = sizeof(ActorDrawData);
 
+        const auto lag = s_schedule.Lag();
+        ctx.updateSource = s_schedule.GetMode() == SnapshotSchedule::Mode::Task ? "SKSE task"
+                           : s_schedule.FallingBack()                           ? "SKSE task (no main loop)"
+                                                                                : "Main loop";
+        ctx.updateLagMs = lag.meanMs;
+        ctx.updateJitterMs = lag.jitterMs;
+
         DebugOverlay::Render(ctx);
     }
 
-    /// Handle hot reload key press (Settings::ReloadKey).
-    static void HandleHotReload()
+    static FramePipeline::Pipeline& LabelPipeline();
+
+    /// Resolve every configured ornament string against the ornament font.
+    /// Render thread only, after the font atlas is built.
+    static void BuildOrnamentRuns()
     {
-        if (Settings::ReloadKey <= 0)
+        s_ornamentRuns.Reset();
+
+        auto &io = ImGui::GetIO();
+        ImFont *font = (io.Fonts->Fonts.Size >= 4) ? io.Fonts->Fonts[3] : nullptr;
+        if (!font || Settings::OrnamentFontPath.empty())
             return;
 
-        bool keyDown = (GetAsyncKeyState(Settings::ReloadKey) & 0x8000) != 0;
+        const OrnamentRuns::GlyphLookup lookup = [font](std::uint32_t cp, float &advance) {
+            if (cp > IM_UNICODE_CODEPOINT_MAX)
+                return false;
+#if defined(IMGUI_VERSION_NUM) && IMGUI_VERSION_NUM >= 18804
+            const ImFontGlyph *glyph = font->FindGlyphNoFallback(static_cast<ImWchar>(cp));
+#else
+            const ImFontGlyph *glyph = font->FindGlyph(static_cast<ImWchar>(cp));
+#endif
+            if (!glyph)
+                return false;
+            advance = glyph->AdvanceX;
+            return true;
+        };
 
-        if (keyDown && !s_reloadKeyWasDown)
+        for (const auto &tier : Settings::Tiers)
+            s_ornamentRuns.AddTier(tier.leftOrnaments, tier.rightOrnaments, lookup);
+        for (const auto &special : Settings::SpecialTitles)
+            s_ornamentRuns.AddSpecial(special.leftOrnaments, special.rightOrnaments, lookup);
+    }
+
+    /// Watcher of whois.ini; started and stopped to follow WatchSettingsFile
+    static SettingsWatch::Watcher& SettingsWatcher()
+    {
+        // Never destroyed: joining the watch thread during DLL unload could deadlock
+        static auto *watcher = new SettingsWatch::Watcher(Settings::FilePath);
+        return *watcher;
+    }
+
+    static void UpdateSettingsWatcher()
+    {
+        static bool s_watchFailed = false;
+
+        auto &watcher = SettingsWatcher();
+        if (!Settings::WatchSettingsFile)
         {
-            Settings::Load();
-            s_lastReloadTime = static_cast<float>(ImGui::GetTime());
-            s_cache.clear();
+            watcher.Stop();
+            return;
+        }
+        if (watcher.Running() || s_watchFailed)
+            return;
+
+        s_watchFailed = !watcher.Start();
+        if (s_watchFailed)
+            SKSE::log::warn("Renderer: Cannot watch {}, use the reload key instead", Settings::FilePath);
+    }
+
+    std::uint32_t ReloadSettings()
+    {
+        UpdateSettingsWatcher();
+
+        SettingsWatch::Diff diff;
+        const bool fileChanged = SettingsWatcher().Poll(diff);
+
+        bool keyPressed = false;
+        if (Settings::ReloadKey > 0)
+        {
+            const bool keyDown = (GetAsyncKeyState(Settings::ReloadKey) & 0x8000) != 0;
+            keyPressed = keyDown && !s_reloadKeyWasDown;
+            s_reloadKeyWasDown = keyDown;
+        }
+
+        if (!fileChanged && !keyPressed)
+            return SettingsWatch::kNone;
+
+        // The reload key rebuilds everything, a saved file only what its keys feed
+        const std::uint32_t changes = keyPressed ? SettingsWatch::kAll : diff.changes;
+
+        // The worker reads settings and the cache while it builds
+        LabelPipeline().Reset();
+        Settings::Load();
+        for (const auto &effect : Settings::CustomEffects)
+        {
+            if (!effect.error.empty())
+                SKSE::log::warn("CustomEffects: {} does not compile ({}), using Gradient", effect.name, effect.error);
+        }
+        for (const auto &ref : Settings::UnknownEffects)
+            SKSE::log::warn("{}: unknown effect {}, using Gradient", ref.label, ref.name);
+        if (fileChanged)
+            SKSE::log::info("Renderer: Settings file saved, {} keys changed", diff.keys);
+
+        s_lastReloadTime = static_cast<float>(ImGui::GetTime());
+        FrameAllocations::OverlayMeter().Rearm();
 
-            if (Settings::TemplateReapplyOnReload && Settings::UseTemplateAppearance)
+        // Next snapshot checks line of sight again
+        if (keyPressed || (changes & SettingsWatch::kOcclusion))
+            s_occlusionChecksStale.store(true, std::memory_order_release);
+
+        if (keyPressed)
+        {
+            s_cache.clear();
+        }
+        else if (changes & SettingsWatch::kLabelText)
+        {
+            // Reveal the new text like a renamed actor's
+            for (auto &[formID, entry] : s_cache)
             {
-                AppearanceTemplate::ResetAppliedFlag();
-                SKSE::GetTaskInterface()->AddTask([]() {
-                    AppearanceTemplate::ApplyIfConfigured();
-                });
+                entry.typewriterTime = 0.0f;
+                entry.typewriterComplete = false;
             }
         }
-        s_reloadKeyWasDown = keyDown;
+
+        // Rebuilt by the next Draw, after the caller rebuilt the fonts
+        if (changes & (SettingsWatch::kOrnaments | SettingsWatch::kFonts))
+            s_ornamentRuns.Invalidate();
+
+        // In place; safe while the pipeline is reset
+        if (changes & SettingsWatch::kNoiseTables)
+            NoiseTables::Configure(Settings::NoiseTableSize);
+
+        if ((changes & SettingsWatch::kAppearance) && Settings::TemplateReapplyOnReload && Settings::UseTemplateAppearance)
+        {
+            AppearanceTemplate::ResetAppliedFlag();
+            SKSE::GetTaskInterface()->AddTask([]() {
+                AppearanceTemplate::ApplyIfConfigured();
+            });
+        }
+        return changes;
     }
 
     /// Update debug stats from the current snapshot.
@@ -2026,25 +2308,31 @@ namespace Renderer
     static void ResolveOverlaps(const std::vector<ActorDrawData>& localSnap)
     {
         struct LabelRect {
-            int idx;
+            ActorCache* entry;
             float cy, halfH, dist, yOffset;
             bool isPlayer;
         };
-        std::vector<LabelRect> labelRects;
 
-        for (int i = 0; i < static_cast<int>(localSnap.size()); ++i)
+        // Reused across frames, so a steady scene does not allocate
+        static thread_local std::vector<LabelRect> labelRects;
+        labelRects.clear();
+
+        for (const auto& d : localSnap)
         {
-            const auto& d = localSnap[i];
             auto cIt = s_cache.find(d.formID);
-            if (cIt == s_cache.end() || !cIt->second.initialized)
+            if (cIt == s_cache.end())
+                continue;
+
+            auto& entry = cIt->second;
+            entry.overlapOffsetY = 0.0f;
+            if (!entry.initialized)
                 continue;
 
-            const auto& entry = cIt->second;
             if (entry.alphaSmooth * entry.occlusionSmooth <= 0.02f)
                 continue;
 
             float approxHeight = Settings::NameFontSize * entry.textSizeScale * 1.5f;
-            labelRects.push_back({i, entry.smooth.y, approxHeight * 0.5f,
+            labelRects.push_back({&entry, entry.smooth.y, approxHeight * 0.5f,
                                   d.distToPlayer, 0.0f, d.isPlayer});
         }
 
@@ -2074,15 +2362,179 @@ namespace Renderer
         for (const auto& lr : labelRects)
         {
             if (std::abs(lr.yOffset) > 0.01f)
-                OverlapOffsets()[localSnap[lr.idx].formID] = lr.yOffset;
+                lr.entry->overlapOffsetY = lr.yOffset;
         }
     }
 
-    void Draw()
+    // Builds the labels of a captured snapshot into a standalone draw list.
+    // Runs on the pipeline worker in the pipelined modes, so everything it
+    // reads from the render thread is copied in Capture().
+    class LabelFrameBuilder final : public FramePipeline::IFrameBuilder
     {
-        HandleHotReload();
+    public:
+        void Capture(const FramePipeline::FrameInput &) override
+        {
+            m_snapshot = s_snapshotView;
+            m_sharedData = *ImGui::GetDrawListSharedData();
+            m_fontTexture = ImGui::GetIO().Fonts->TexID;
+        }
 
-        if (!CanDrawOverlay())
+        void Build(const FramePipeline::FrameInput &input, FramePipeline::Frame &out) override
+        {
+            s_buildInput = &input;
+            TextEffects::SetAnimationTime(&input.time);
+
+            m_drawList._ResetForNewFrame();
+            m_drawList.PushClipRect(ImVec2(0.0f, 0.0f), ImVec2(input.camera.width, input.camera.height));
+            m_drawList.PushTextureID(m_fontTexture);
+
+            if (Settings::Visual().EnableOverlapPrevention)
+                ResolveOverlaps(m_snapshot);
+
+            s_instances.BeginFrame();
+            for (auto &d : m_snapshot)
+            {
+                FramePipeline::Anchor anchor;
+                anchor.vtxBegin = static_cast<uint32_t>(m_drawList.VtxBuffer.Size);
+                DrawLabel(d, &m_drawList);
+                anchor.vtxEnd = static_cast<uint32_t>(m_drawList.VtxBuffer.Size);
+                if (anchor.vtxEnd == anchor.vtxBegin)
+                    continue;
+
+                // Same anchor DrawLabel projects, so reprojection moves the whole label
+                anchor.world[0] = d.worldPos.x;
+                anchor.world[1] = d.worldPos.y;
+                anchor.world[2] = d.worldPos.z;
+                float z;
+                if (input.camera.Project(anchor.world, anchor.screen[0], anchor.screen[1], z))
+                    out.anchors.push_back(anchor);
+            }
+
+            m_drawList.PopTextureID();
+            m_drawList.PopClipRect();
+            TextEffects::EndEffectFrame();
+            PruneCacheToSnapshot(m_snapshot);
+
+            CopyDrawList(m_drawList, out);
+
+            TextEffects::SetAnimationTime(nullptr);
+            s_buildInput = nullptr;
+        }
+
+    private:
+        // Flatten the draw list into absolute indices
+        static void CopyDrawList(const ImDrawList &list, FramePipeline::Frame &out)
+        {
+            static_assert(sizeof(ImDrawVert) == sizeof(FramePipeline::Vertex), "vertex layout must match ImDrawVert");
+
+            out.vertices.resize(static_cast<size_t>(list.VtxBuffer.Size));
+            if (list.VtxBuffer.Size > 0)
+                std::memcpy(out.vertices.data(), list.VtxBuffer.Data, out.vertices.size() * sizeof(ImDrawVert));
+
+            out.indices.resize(static_cast<size_t>(list.IdxBuffer.Size));
+            for (const ImDrawCmd &cmd : list.CmdBuffer)
+            {
+                if (cmd.UserCallback || cmd.ElemCount == 0)
+                    continue;
+
+                FramePipeline::DrawCmd dc;
+                dc.texture = reinterpret_cast<void *>(cmd.GetTexID());
+                dc.clip[0] = cmd.ClipRect.x;
+                dc.clip[1] = cmd.ClipRect.y;
+                dc.clip[2] = cmd.ClipRect.z;
+                dc.clip[3] = cmd.ClipRect.w;
+                dc.idxOffset = cmd.IdxOffset;
+                dc.idxCount = cmd.ElemCount;
+
+                uint32_t lo = UINT32_MAX, hi = 0;
+                for (uint32_t i = 0; i < cmd.ElemCount; ++i)
+                {
+                    const uint32_t v = cmd.VtxOffset + list.IdxBuffer[static_cast<int>(cmd.IdxOffset + i)];
+                    out.indices[cmd.IdxOffset + i] = v;
+                    lo = (std::min)(lo, v);
+                    hi = (std::max)(hi, v);
+                }
+                dc.vtxBegin = lo;
+                dc.vtxEnd = hi + 1;
+                out.commands.push_back(dc);
+            }
+        }
+
+        std::vector<ActorDrawData> m_snapshot;
+        ImDrawListSharedData m_sharedData;
+        ImDrawList m_drawList{&m_sharedData};
+        ImTextureID m_fontTexture{};
+    };
+
+    static FramePipeline::Pipeline& LabelPipeline()
+    {
+        // Never destroyed: joining the worker during DLL unload could deadlock
+        static LabelFrameBuilder builder;
+        static auto *pipeline = new FramePipeline::Pipeline(builder);
+        return *pipeline;
+    }
+
+    // Copy a finished frame into the overlay window's draw list
+    static void SubmitFrame(const FramePipeline::Frame &frame, ImDrawList *drawList)
+    {
+        for (const auto &cmd : frame.commands)
+        {
+            const uint32_t vtxCount = cmd.vtxEnd - cmd.vtxBegin;
+
+            drawList->PushClipRect(ImVec2(cmd.clip[0], cmd.clip[1]), ImVec2(cmd.clip[2], cmd.clip[3]));
+            drawList->PushTextureID(reinterpret_cast<ImTextureID>(cmd.texture));
+            drawList->PrimReserve(static_cast<int>(cmd.idxCount), static_cast<int>(vtxCount));
+
+            const uint32_t base = drawList->_VtxCurrentIdx;
+            std::memcpy(drawList->_VtxWritePtr, frame.vertices.data() + cmd.vtxBegin, vtxCount * sizeof(ImDrawVert));
+            drawList->_VtxWritePtr += vtxCount;
+            drawList->_VtxCurrentIdx += vtxCount;
+
+            for (uint32_t i = 0; i < cmd.idxCount; ++i)
+                *drawList->_IdxWritePtr++ = static_cast<ImDrawIdx>(base + frame.indices[cmd.idxOffset + i] - cmd.vtxBegin);
+
+            drawList->PopTextureID();
+            drawList->PopClipRect();
+        }
+    }
+
+    // Engine camera and frame clock for a pipelined build
+    static bool CaptureFrameInput(FramePipeline::FrameInput &input)
+    {
+        auto *cam = RE::Main::WorldRootCamera();
+        auto *renderer = RE::BSGraphics::Renderer::GetSingleton();
+        if (!cam || !renderer)
+            return false;
+
+        const auto &rt = cam->GetRuntimeData();
+        const auto &rt2 = cam->GetRuntimeData2();
+        std::memcpy(input.camera.worldToCam, rt.worldToCam, sizeof(input.camera.worldToCam));
+        input.camera.left = rt2.port.left;
+        input.camera.right = rt2.port.right;
+        input.camera.top = rt2.port.top;
+        input.camera.bottom = rt2.port.bottom;
+
+        const auto ss = renderer->GetScreenSize();
+        input.camera.width = static_cast<float>(ss.width);
+        input.camera.height = static_cast<float>(ss.height);
+
+        // DrawLabel scales by distance from the player camera root
+        RE::NiPoint3 camPos = cam->world.translate;
+        if (auto pc = RE::PlayerCamera::GetSingleton(); pc && pc->cameraRoot)
+            camPos = pc->cameraRoot->world.translate;
+        input.camera.position[0] = camPos.x;
+        input.camera.position[1] = camPos.y;
+        input.camera.position[2] = camPos.z;
+
+        input.time = ImGui::GetTime();
+        input.deltaTime = ImGui::GetIO().DeltaTime;
+        input.serial = s_frame.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    void Draw()
+    {
+        if (!s_overlayState.Allowed())
         {
             s_wasInInvalidState = true;
             return;
@@ -2092,6 +2544,7 @@ namespace Renderer
         {
             s_wasInInvalidState = false;
             s_postLoadCooldown = 300;
+            LabelPipeline().Reset();  // Drop frames built before the menu or load screen
         }
 
         if (s_postLoadCooldown > 0)
@@ -2100,8 +2553,6 @@ namespace Renderer
             return;
         }
 
-        QueueSnapshotUpdate_RenderThread();
-
         auto *bsRenderer = RE::BSGraphics::Renderer::GetSingleton();
         if (!bsRenderer)
             return;
@@ -2109,15 +2560,20 @@ namespace Renderer
         const auto viewSize = bsRenderer->GetScreenSize();
         ++s_frame;
 
-        static std::vector<ActorDrawData> localSnap;
-        {
-            std::lock_guard<std::mutex> lock(s_snapshotLock);
-            localSnap = s_snapshot;
-        }
+        if (s_snapshotChannel.Consume(s_snapshotMirror) > 0)
+            RefreshSnapshotView();
 
+        const auto &localSnap = s_snapshotView;
         if (localSnap.empty())
             return;
 
+        // Before any build, so the pipeline worker only reads a finished table
+        if (!s_ornamentRuns.Valid())
+            BuildOrnamentRuns();
+
+        const auto mode = FramePipeline::ModeFromInt(Settings::FrameBuildMode);
+        LabelPipeline().SetMode(mode);
+
         ImGui::SetNextWindowPos(ImVec2(0, 0));
         ImGui::SetNextWindowSize(ImVec2((float)viewSize.width, (float)viewSize.height));
         ImGui::Begin("whoisOverlay", nullptr,
@@ -2133,32 +2589,45 @@ namespace Renderer
         if (Settings::EnableDebugOverlay)
             UpdateDebugStats(localSnap);
 
-        OverlapOffsets().clear();
-        if (Settings::Visual().EnableOverlapPrevention)
-            ResolveOverlaps(localSnap);
+        if (mode == FramePipeline::Mode::Serial)
+        {
+            if (Settings::Visual().EnableOverlapPrevention)
+                ResolveOverlaps(localSnap);
 
-        for (auto &d : localSnap)
-            DrawLabel(d, drawList);
+            s_instances.BeginFrame();
+            for (auto &d : localSnap)
+                DrawLabel(d, drawList);
+            TextEffects::EndEffectFrame();
+        }
+        else
+        {
+            // Submit the last finished frame, re-anchored to this frame's camera
+            FramePipeline::FrameInput input;
+            if (CaptureFrameInput(input))
+            {
+                if (const auto *frame = LabelPipeline().Submit(input))
+                    SubmitFrame(*frame, drawList);
+            }
+        }
 
         ImGui::End();
 
         DrawDebugOverlay();
-        PruneCacheToSnapshot(localSnap);
+        if (mode == FramePipeline::Mode::Serial)
+            PruneCacheToSnapshot(localSnap);
     }
 
     void TickRT()
     {
         // Called every frame from render thread
-        // Queues updates but keeps the actual work lightweight/throttled
+        // Schedules updates but keeps the actual work lightweight/throttled
         QueueSnapshotUpdate_RenderThread();
     }
-}
-
-// Forward declaration for appearance template check (defined in main.cpp)
-extern void CheckPendingAppearanceTemplate();
 
-// Called from Hooks.cpp after rendering
-void Renderer_CheckAppearanceTemplate()
-{
-    CheckPendingAppearanceTemplate();
+    void UpdateMainLoop()
+    {
+        // Called every game frame; one atomic exchange unless a scan is due
+        if (s_schedule.MainLoopUpdate())
+            RunSnapshotScan_GameThread();
+    }
 }
@@ -16,8 +16,11 @@
  *
  * Uses a producer-consumer pattern for thread safety:
  *
- * - **Game Thread**: Collects actor data via `SKSE::GetTaskInterface()->AddTask()`
+ * - **Game Thread**: Collects actor data from the main loop hook, or via
+ *   `SKSE::GetTaskInterface()->AddTask()`, see `SnapshotSchedule`
  * - **Render Thread**: Draws nameplates using cached data
+ * - **Pipeline Worker** (optional): Builds the next frame's label geometry
+ *   while the current one renders, see `FramePipeline` and `FrameBuildMode`
  *
  * ```mermaid
  * %%{init: {'theme':'dark', 'look':'handDrawn'}}%%
@@ -27,8 +30,8 @@
  *     classDef render fill:#2e1f5e,stroke:#8b5cf6,color:#e2e8f0
  *
  *     RT[Render Thread]:::thread -->|Schedule update| GT[Game Thread]:::thread
- *     GT -->|Collect actors| Cache[Actor Cache]:::data
- *     RT -->|Copy snapshot| Cache
+ *     GT -->|Publish deltas| Cache[Actor Deltas]:::data
+ *     RT -->|Apply to mirror| Cache
  *     RT -->|Draw nameplates| ImGui[ImGui]:::render
  * ```
  *
@@ -42,7 +45,7 @@
  *     classDef render fill:#1a3a2a,stroke:#10b981,color:#e2e8f0
  *
  *     A[Overlay Allowed?]:::check --> B[Queue Actor Update]:::process
- *     B --> C[Copy Snapshot]:::process
+ *     B --> C[Apply Snapshot Deltas]:::process
  *     C --> D[Project / Smooth]:::process
  *     D --> E[Apply Effects]:::render
  *     E --> F[Render]:::render
@@ -96,8 +99,8 @@ namespace Renderer
      * Renders all floating nameplates using ImGui. This is the primary
      * entry point called from the render hook.
      *
-     * Must be called from the render thread. Actor data is accessed
-     * through a mutex-protected snapshot.
+     * Must be called from the render thread. Actor data arrives as
+     * delta records applied to a render-thread mirror (see SnapshotDelta).
      *
      * ```cpp
      * // Called from HUDMenu::PostDisplay hook
@@ -118,18 +121,50 @@ namespace Renderer
      */
     void Draw();
 
+    /**
+     * Apply a saved settings file or a reload key press.
+     *
+     * Reloads `whois.ini` when the settings watcher reported changed keys
+     * or `Settings::ReloadKey` was pressed. Caches owned by the renderer are
+     * invalidated according to the changed keys; the rest is left to the
+     * caller through the returned mask.
+     *
+     * @pre Must be called from the render thread, outside an ImGui frame,
+     *      so the caller can rebuild the font atlas.
+     *
+     * @return `SettingsWatch::Change` flags of the reload, `kAll` for the
+     *         reload key, `kNone` if nothing was reloaded.
+     *
+     * @see SettingsWatch, Settings::Load
+     */
+    std::uint32_t ReloadSettings();
+
     /**
      * Render thread tick function.
      *
      * Called every frame to schedule actor data updates. The actual
-     * data collection runs on the game thread via SKSE's task interface.
+     * data collection runs on the game thread, in UpdateMainLoop() or in a
+     * task queued through SKSE's task interface (`SnapshotUpdateMode`).
      *
      * @pre Must be called from the render thread.
      *
-     * @see Draw, IsOverlayAllowedRT
+     * @see Draw, IsOverlayAllowedRT, SnapshotSchedule
      */
     void TickRT();
 
+    /**
+     * Game thread main loop tick.
+     *
+     * Called every game frame from the `Main::Update` hook, after actors
+     * moved. Collects actor data if the render thread scheduled an update;
+     * otherwise it costs one atomic exchange.
+     *
+     * @pre Must be called from the game thread.
+     *
+     * @see TickRT, SnapshotSchedule, Hooks::Install
+     */
+    void UpdateMainLoop();
+
     /**
      * Check if overlay rendering is allowed.
      *
@@ -147,10 +182,28 @@ namespace Renderer
      * - Player is in combat (if configured)
      * - Manually disabled via ToggleEnabled()
      *
-     * @see Draw, TickRT
+     * Menu state comes from menu open/close events and the rest from the
+     * game thread's last snapshot, so this is two atomic loads.
+     *
+     * @see Draw, TickRT, OverlayState
      */
     bool IsOverlayAllowedRT();
 
+    /**
+     * Check if a tracked menu is open.
+     *
+     * Unlike IsOverlayAllowedRT this does not depend on the game thread
+     * having run, so the PostDisplay hook can skip all work while a menu
+     * is up without queueing snapshot updates.
+     */
+    bool IsMenuBlockingRT();
+
+    /**
+     * Register the menu open/close event sink and seed it with the menus
+     * already open. Call once at `kDataLoaded`.
+     */
+    void RegisterEventSinks();
+
     /**
      * Toggle the rendering on/off.
      *
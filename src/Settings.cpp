@@ -4,6 +4,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
+#include <utility>
 
 namespace Settings
 {
@@ -15,6 +16,8 @@ namespace Settings
 
     // Special Titles
     std::vector<SpecialTitleDefinition> SpecialTitles;
+    std::vector<CustomEffectDefinition> CustomEffects;
+    std::vector<UnknownEffectReference> UnknownEffects;
 
     // Distance & Visibility
     float FadeStartDistance;
@@ -28,6 +31,8 @@ namespace Settings
     bool  EnableOcclusionCulling = true;
     float OcclusionSettleTime = 0.58f;
     int   OcclusionCheckInterval = 3;
+    int   OcclusionBackend = 0;
+    int   OcclusionCorrectionInterval = 30;
 
     // Visual Effects
     float TitleShadowOffsetX;
@@ -51,10 +56,29 @@ namespace Settings
     bool  EnableTypewriter = false;
     float TypewriterSpeed = 30.0f;
     float TypewriterDelay = 0.0f;
+    float TypewriterSoftness = 1.0f;
 
     // Debug Settings
     bool  EnableDebugOverlay = false;
 
+    // Frame Pipeline
+    int   FrameBuildMode = 0;
+
+    // Snapshot Updates
+    int   SnapshotUpdateMode = 1;
+
+    // Label Instancing
+    bool  EnableInstancing = true;
+
+    // Effect Evaluation Rates
+    float EffectRateRainbow = 30.0f;
+    float EffectRateShimmer = 60.0f;
+    float EffectRateNoise = 45.0f;
+    float EffectRateSparkle = 60.0f;
+
+    // Noise Tables
+    int   NoiseTableSize = 256;
+
     // Side Ornaments
     bool  EnableOrnaments = true;
     float OrnamentScale = 1.0f;
@@ -80,6 +104,7 @@ namespace Settings
     bool  HidePlayer = false;
     bool  HideCreatures = false;
     int   ReloadKey = 0;  // 0 = disabled, 207 = End key
+    bool  WatchSettingsFile = true;
 
     // Animation
     float AnimSpeedLowTier;
@@ -192,16 +217,58 @@ namespace Settings
         if (s == "Sparkle") return EffectType::Sparkle;
         if (s == "Plasma") return EffectType::Plasma;
         if (s == "Scanline") return EffectType::Scanline;
-        // Default to simple gradient if unknown
+        // Anything else may name a [CustomEffects] entry, resolved after loading
+        if (!s.empty()) return EffectType::Custom;
         return EffectType::Gradient;
     }
 
+    // Helper function: Compile one [CustomEffects] entry, replacing an earlier one of the same name
+    static void AddCustomEffect(const std::string& name, const std::string& source) {
+        CustomEffectDefinition def;
+        def.name = name;
+        def.source = source;
+        EffectProgram::Compile(source, def.program, &def.error);
+
+        for (auto& existing : CustomEffects) {
+            if (existing.name == name) {
+                existing = std::move(def);
+                return;
+            }
+        }
+        CustomEffects.push_back(std::move(def));
+    }
+
+    // Helper function: Point Custom effects at their compiled program, or fall back to Gradient
+    static void ResolveCustomEffect(EffectParams& effect, const std::string& label) {
+        if (effect.type != EffectType::Custom) return;
+
+        effect.customEffect = -1;
+        bool defined = false;
+        for (size_t i = 0; i < CustomEffects.size(); ++i) {
+            if (CustomEffects[i].name != effect.customName) continue;
+            if (CustomEffects[i].program.Valid()) {
+                effect.customEffect = static_cast<int>(i);
+                return;
+            }
+            defined = true;
+            break;
+        }
+        // Unknown name or compile error, same as an unknown built-in; compile
+        // errors are reported with their definition
+        if (!defined) UnknownEffects.push_back({effect.customName, label});
+        effect.type = EffectType::Gradient;
+    }
+
     void Load()
     {
         // File is located in Skyrim's Data folder under SKSE plugins directory
-        std::ifstream file("Data/SKSE/Plugins/whois.ini");
+        std::ifstream file(FilePath);
         if (!file.is_open()) return;  // Silently use defaults if file not found
 
+        // Custom effects are rebuilt on every load so removed entries disappear
+        CustomEffects.clear();
+        UnknownEffects.clear();
+
         std::string line;
         std::string currentSection;    // Tracks current [Section] header for multi-section parsing
         int currentTier = -1;          // Tracks which tier we're parsing (-1 = global settings)
@@ -285,6 +352,12 @@ namespace Settings
 
             bool handled = false;
 
+            // [CustomEffects]: every key is an effect name, every value an expression
+            if (currentSection == "CustomEffects") {
+                AddCustomEffect(key, val);
+                continue;
+            }
+
             // If we're inside a [TierN] section, all kv pairs apply to that tier
             // This allows each tier to have its own level range, colors, and effects
             if (currentTier >= 0 && currentTier < static_cast<int>(Tiers.size())) {
@@ -326,6 +399,7 @@ namespace Settings
                                           Tiers[currentTier].levelEffect;
 
                     effect.type = ParseEffectType(effectTypeName);
+                    effect.customName = effect.type == EffectType::Custom ? effectTypeName : std::string();
 
                     // Get the rest of the line
                     std::string paramsStr;
@@ -506,6 +580,8 @@ namespace Settings
             else if (key == "EnableOcclusionCulling") EnableOcclusionCulling = (ParseInt(val, 1) != 0);
             else if (key == "OcclusionSettleTime") OcclusionSettleTime = ParseFloat(val, 0.58f);
             else if (key == "OcclusionCheckInterval") OcclusionCheckInterval = ParseInt(val, 3);
+            else if (key == "OcclusionBackend") OcclusionBackend = ParseInt(val, 0);
+            else if (key == "OcclusionCorrectionInterval") OcclusionCorrectionInterval = ParseInt(val, 30);
             else if (key == "TitleShadowOffsetX") TitleShadowOffsetX = ParseFloat(val, 0.0f);
             else if (key == "TitleShadowOffsetY") TitleShadowOffsetY = ParseFloat(val, 0.0f);
             else if (key == "MainShadowOffsetX") MainShadowOffsetX = ParseFloat(val, 0.0f);
@@ -523,8 +599,22 @@ namespace Settings
             else if (key == "EnableTypewriter") EnableTypewriter = (ParseInt(val, 0) != 0);
             else if (key == "TypewriterSpeed") TypewriterSpeed = ParseFloat(val, 30.0f);
             else if (key == "TypewriterDelay") TypewriterDelay = ParseFloat(val, 0.0f);
+            else if (key == "TypewriterSoftness") TypewriterSoftness = ParseFloat(val, 1.0f);
             // Debug Settings
             else if (key == "EnableDebugOverlay") EnableDebugOverlay = (ParseInt(val, 0) != 0);
+            // Frame Pipeline
+            else if (key == "FrameBuildMode") FrameBuildMode = ParseInt(val, 0);
+            // Snapshot Updates
+            else if (key == "SnapshotUpdateMode") SnapshotUpdateMode = ParseInt(val, 1);
+            // Label Instancing
+            else if (key == "EnableInstancing") EnableInstancing = (ParseInt(val, 1) != 0);
+            // Effect Evaluation Rates
+            else if (key == "EffectRateRainbow") EffectRateRainbow = ParseFloat(val, 30.0f);
+            else if (key == "EffectRateShimmer") EffectRateShimmer = ParseFloat(val, 60.0f);
+            else if (key == "EffectRateNoise") EffectRateNoise = ParseFloat(val, 45.0f);
+            else if (key == "EffectRateSparkle") EffectRateSparkle = ParseFloat(val, 60.0f);
+            // Noise Tables
+            else if (key == "NoiseTableSize") NoiseTableSize = ParseInt(val, 256);
             // Side Ornaments
             else if (key == "EnableOrnaments" || key == "EnableFlourishes") EnableOrnaments = (ParseInt(val, 1) != 0);
             else if (key == "OrnamentScale" || key == "FlourishScale") OrnamentScale = ParseFloat(val, 1.0f);
@@ -548,6 +638,7 @@ namespace Settings
             else if (key == "HidePlayer") HidePlayer = (ParseInt(val, 0) != 0);
             else if (key == "HideCreatures") HideCreatures = (ParseInt(val, 0) != 0);
             else if (key == "ReloadKey") ReloadKey = ParseInt(val, 0);
+            else if (key == "WatchSettingsFile") WatchSettingsFile = (ParseInt(val, 1) != 0);
             else if (key == "AnimSpeedLowTier") AnimSpeedLowTier = ParseFloat(val, 0.0f);
             else if (key == "AnimSpeedMidTier") AnimSpeedMidTier = ParseFloat(val, 0.0f);
             else if (key == "AnimSpeedHighTier") AnimSpeedHighTier = ParseFloat(val, 0.0f);
@@ -610,5 +701,13 @@ namespace Settings
             else if (key == "TemplateReapplyOnReload") TemplateReapplyOnReload = ParseBool(val);
             else if (key == "TemplateFaceGenPlugin") TemplateFaceGenPlugin = val;
         }
+
+        // Tiers may name custom effects defined further down the file
+        for (size_t i = 0; i < Tiers.size(); ++i) {
+            const std::string section = "Tier" + std::to_string(i);
+            ResolveCustomEffect(Tiers[i].titleEffect, section + " TitleEffect");
+            ResolveCustomEffect(Tiers[i].nameEffect, section + " NameEffect");
+            ResolveCustomEffect(Tiers[i].levelEffect, section + " LevelEffect");
+        }
     }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "EffectProgram.h"
+
 #include <string>
 #include <vector>
 
@@ -22,12 +24,19 @@
  * | `[General]`        | Core settings, fonts, distances          |
  * | `[TierN]`          | Per-tier colors, effects, ornaments      |
  * | `[SpecialTitleN]`  | Keyword-based title overrides            |
+ * | `[CustomEffects]`  | Expression effects, `Name = expr`        |
  * | `[Appearance]`     | NPC appearance template settings         |
  *
  * ## :material-refresh: Hot Reload
  *
- * Settings can be reloaded at runtime by pressing the configured `ReloadKey`
- * (default: F7). This calls `Load()` and clears the actor cache.
+ * Saving `whois.ini` while the game runs reloads it. A background watcher
+ * (see SettingsWatch) diffs the saved file against the previous version key
+ * by key, and only the caches fed by changed keys are invalidated: a color
+ * edit applies on the next frame with nothing rebuilt, a font size edit
+ * rebuilds only the font atlas. Set `WatchSettingsFile = 0` to turn this off.
+ *
+ * The configured `ReloadKey` forces a full reload, which clears the actor
+ * cache and rebuilds the fonts.
  *
  * ## :material-blur-linear: Distance Fading
  *
@@ -103,6 +112,7 @@ namespace Settings
      * - Static: None, Gradient, VerticalGradient, DiagonalGradient, RadialGradient
      * - Animated: Shimmer, ChromaticShimmer, PulseGradient, RainbowWave, ConicRainbow, Aurora
      * - Complex: Sparkle, Plasma, Scanline
+     * - User: Custom, any effect defined in `[CustomEffects]`
      *
      * @see EffectParams, TextEffects::ApplyVertexEffect
      */
@@ -120,7 +130,8 @@ namespace Settings
         Aurora,                  ///< Northern lights effect (param1 = speed, param2 = waves, param3 = intensity, param4 = sway)
         Sparkle,                 ///< Glittering stars (param1 = density, param2 = speed, param3 = intensity)
         Plasma,                  ///< Demoscene plasma pattern (param1 = freq1, param2 = freq2, param3 = speed)
-        Scanline                 ///< Horizontal scanning bar (param1 = speed, param2 = width, param3 = intensity)
+        Scanline,                ///< Horizontal scanning bar (param1 = speed, param2 = width, param3 = intensity)
+        Custom                   ///< Expression from `[CustomEffects]` (param1-5 = p1-p5)
     };
 
     /**
@@ -152,6 +163,9 @@ namespace Settings
         float param5 = 0.0f;  ///< Effect parameter 5
 
         bool useWhiteBase = false;  ///< Draw white base layer under rainbow effects for brightness
+
+        std::string customName;     ///< Effect name as written in the tier (EffectType::Custom)
+        int customEffect = -1;      ///< Index into CustomEffects, resolved after loading
     };
 
     /**
@@ -237,6 +251,42 @@ namespace Settings
     // Special Titles (Admin, Moderator, VIP, etc.)
     extern std::vector<SpecialTitleDefinition> SpecialTitles;  ///< Special title overrides
 
+    /**
+     * User-defined effect from the `[CustomEffects]` section.
+     *
+     * The expression is compiled when settings load. A definition that fails
+     * to compile keeps its error and tiers that use it fall back to Gradient.
+     *
+     * ```ini
+     * [CustomEffects]
+     * Frost = n = noise(u * 9, v * 3 - t * p1); mix(left, highlight, clamp(n * 1.6 - 0.5))
+     * ```
+     *
+     * @see EffectProgram, EffectType::Custom
+     */
+    struct CustomEffectDefinition {
+        std::string name;                ///< Name used by TitleEffect, NameEffect, LevelEffect
+        std::string source;              ///< Expression text
+        EffectProgram::Program program;  ///< Compiled program, invalid if `error` is set
+        std::string error;               ///< Compile error, empty on success
+    };
+
+    /**
+     * Tier effect naming a custom effect that is not defined.
+     *
+     * `Load()` draws it as Gradient and records it here, to be logged once
+     * the logger exists. Effects that are defined but do not compile are
+     * reported through `CustomEffectDefinition::error` instead.
+     */
+    struct UnknownEffectReference {
+        std::string name;   ///< Effect name as written
+        std::string label;  ///< Where it was written, e.g. "Tier3 NameEffect"
+    };
+
+    // Custom Effects
+    extern std::vector<CustomEffectDefinition> CustomEffects;  ///< Expression effects by definition order
+    extern std::vector<UnknownEffectReference> UnknownEffects;  ///< Unknown names found by the last `Load()`
+
     // Distance & Visibility
     extern float FadeStartDistance;      ///< Distance where fade begins (default: 200.0)
     extern float FadeEndDistance;        ///< Distance where fully transparent (default: 2500.0)
@@ -249,6 +299,8 @@ namespace Settings
     extern bool  EnableOcclusionCulling;   ///< Enable LOS-based occlusion (default: true)
     extern float OcclusionSettleTime;      ///< Fade settle time in seconds (default: 0.58)
     extern int   OcclusionCheckInterval;   ///< Frames between LOS checks (default: 3)
+    extern int   OcclusionBackend;         ///< 0 = game LOS, 1 = static BVH off the game thread (default: 0)
+    extern int   OcclusionCorrectionInterval;  ///< Scans between game LOS checks per actor on the BVH backend (default: 30)
 
     // Shadow & Visual Effects
     extern float TitleShadowOffsetX;     ///< Title shadow X offset in pixels (default: 2.0)
@@ -272,10 +324,29 @@ namespace Settings
     extern bool  EnableTypewriter;       ///< Enable typewriter reveal (default: false)
     extern float TypewriterSpeed;        ///< Characters per second (default: 30.0)
     extern float TypewriterDelay;        ///< Delay before reveal starts (default: 0.0)
+    extern float TypewriterSoftness;     ///< Characters the leading edge fades over, 0 = hard (default: 1.0)
 
     // Debug Settings
     extern bool  EnableDebugOverlay;     ///< Show performance/cache overlay (default: false)
 
+    // Frame Pipeline
+    extern int   FrameBuildMode;         ///< 0 = serial, 1 = pipelined/latency, 2 = pipelined/throughput (default: 0)
+
+    // Snapshot Updates
+    extern int   SnapshotUpdateMode;     ///< 0 = SKSE task per frame, 1 = main loop hook (default: 1)
+
+    // Label Instancing
+    extern bool  EnableInstancing;       ///< Build identical NPC labels once per frame and copy them (default: true)
+
+    // Effect Evaluation Rates (Hz per label, 0 = every frame)
+    extern float EffectRateRainbow;      ///< Rainbow wave, conic rainbow (default: 30.0)
+    extern float EffectRateShimmer;      ///< Shimmer variants, pulse, scanline (default: 60.0)
+    extern float EffectRateNoise;        ///< Aurora, plasma (default: 45.0)
+    extern float EffectRateSparkle;      ///< Sparkle (default: 60.0)
+
+    // Noise Tables
+    extern int   NoiseTableSize;         ///< Texels per effect table side, 0 = analytic (default: 256)
+
     // Side Ornaments
     extern bool  EnableOrnaments;        ///< Enable side ornaments (default: true)
     extern float OrnamentScale;          ///< Size multiplier (default: 1.0)
@@ -314,7 +385,8 @@ namespace Settings
     extern float VerticalOffset;         ///< Height above actor's head in units (default: 8.0)
     extern bool  HidePlayer;             ///< Hide player's own nameplate (default: false)
     extern bool  HideCreatures;          ///< Hide nameplates for non-NPC actors (default: false)
-    extern int   ReloadKey;              ///< Virtual key code for hot reload (default: 0 = disabled)
+    extern int   ReloadKey;              ///< Virtual key code for a full reload (default: 0 = disabled)
+    extern bool  WatchSettingsFile;      ///< Reload changed keys when whois.ini is saved (default: true)
 
     // Animation Speed
     extern float AnimSpeedLowTier;       ///< Speed for tiers 0-7 (default: 0.35)
@@ -391,11 +463,14 @@ namespace Settings
     extern bool TemplateReapplyOnReload;   ///< Whether to re-apply appearance on hot reload (default: false)
     extern std::string TemplateFaceGenPlugin;  ///< Optional override for FaceGen plugin path (empty = auto-detect)
 
+    /// Settings file, relative to the game folder.
+    inline constexpr char FilePath[] = "Data/SKSE/Plugins/whois.ini";
+
     /**
      * Load all settings from whois.ini.
      *
      * Parses the configuration file and populates all settings variables.
-     * Called once during plugin initialization and on hot reload.
+     * Called once during plugin initialization and on every reload.
      *
      * File Location: Data/SKSE/Plugins/whois.ini
      *
@@ -0,0 +1,386 @@
+#include "SettingsWatch.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace SettingsWatch
+{
+    namespace
+    {
+        std::string_view Trim(std::string_view s)
+        {
+            const auto first = s.find_first_not_of(" \t\r\n");
+            if (first == std::string_view::npos)
+                return {};
+            const auto last = s.find_last_not_of(" \t\r\n");
+            return s.substr(first, last - first + 1);
+        }
+
+        bool StartsWith(std::string_view s, std::string_view prefix)
+        {
+            return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+        }
+
+        bool EndsWith(std::string_view s, std::string_view suffix)
+        {
+            return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        bool Less(const Entry& a, const Entry& b)
+        {
+            if (a.section != b.section)
+                return a.section < b.section;
+            return a.key < b.key;
+        }
+
+        bool ReadFile(const std::filesystem::path& path, std::string& out)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open())
+                return false;
+            out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            return true;
+        }
+    }
+
+    Entries Parse(std::string_view text)
+    {
+        Entries entries;
+        std::string_view section;
+
+        std::size_t pos = 0;
+        while (pos < text.size())
+        {
+            auto end = text.find('\n', pos);
+            if (end == std::string_view::npos)
+                end = text.size();
+            const auto line = Trim(text.substr(pos, end - pos));
+            pos = end + 1;
+
+            if (line.empty() || line[0] == ';' || line[0] == '#')
+                continue;
+
+            if (line.size() >= 2 && line.front() == '[' && line.back() == ']')
+            {
+                section = line.substr(1, line.size() - 2);
+                continue;
+            }
+
+            const auto eq = line.find('=');
+            if (eq == std::string_view::npos)
+                continue;
+
+            entries.push_back({std::string(section), std::string(Trim(line.substr(0, eq))),
+                               std::string(Trim(line.substr(eq + 1)))});
+        }
+
+        // Stable, so the last of a repeated key is the last of its run
+        std::stable_sort(entries.begin(), entries.end(), Less);
+
+        Entries unique;
+        unique.reserve(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            const bool repeated = i + 1 < entries.size() && !Less(entries[i], entries[i + 1]);
+            if (!repeated)
+                unique.push_back(std::move(entries[i]));
+        }
+        return unique;
+    }
+
+    std::uint32_t Classify(std::string_view section, std::string_view key)
+    {
+        // [CustomEffects] programs are recompiled by every load and read per frame
+        if (section == "CustomEffects")
+            return kNone;
+
+        // Section keys; anything else in these sections is parsed as a general key
+        if (StartsWith(section, "Tier"))
+        {
+            if (key == "Name" || key == "MinLevel" || key == "MaxLevel")
+                return kLabelText;
+            if (key == "LeftColor" || key == "RightColor" || key == "HighlightColor" ||
+                key == "TitleEffect" || key == "NameEffect" || key == "LevelEffect" ||
+                key == "ParticleTypes" || key == "ParticleCount")
+                return kNone;
+            if (key == "Ornaments")
+                return kOrnaments;
+        }
+        else if (StartsWith(section, "SpecialTitle"))
+        {
+            if (key == "Keyword" || key == "DisplayTitle" || key == "Priority")
+                return kLabelText;
+            if (key == "Color" || key == "GlowColor" || key == "ForceOrnaments" ||
+                key == "ForceFlourishes" || key == "ForceParticles")
+                return kNone;
+            if (key == "Ornaments")
+                return kOrnaments;
+        }
+
+        if (key == "Format")
+            return kLabelText;
+        if (EndsWith(key, "FontPath") || EndsWith(key, "FontSize"))
+            return kFonts;
+        if (key == "UseParticleTextures")
+            return kParticleTextures;
+        if (key == "EnableOcclusionCulling" || key == "OcclusionCheckInterval" || key == "OcclusionBackend" ||
+            key == "OcclusionCorrectionInterval")
+            return kOcclusion;
+        if (key == "UseTemplateAppearance" || StartsWith(key, "Template"))
+            return kAppearance;
+        if (key == "NoiseTableSize")
+            return kNoiseTables;
+        return kNone;
+    }
+
+    Diff Compare(const Entries& before, const Entries& after)
+    {
+        Diff diff;
+        auto changed = [&diff](const Entry& e) {
+            diff.changes |= Classify(e.section, e.key);
+            ++diff.keys;
+        };
+
+        std::size_t i = 0, j = 0;
+        while (i < before.size() || j < after.size())
+        {
+            if (j == after.size() || (i < before.size() && Less(before[i], after[j])))
+            {
+                changed(before[i++]);  // Removed
+            }
+            else if (i == before.size() || Less(after[j], before[i]))
+            {
+                changed(after[j++]);  // Added
+            }
+            else
+            {
+                if (before[i].value != after[j].value)
+                    changed(after[j]);
+                ++i;
+                ++j;
+            }
+        }
+        return diff;
+    }
+
+    // ------------------------------------------------------------------------
+    // Watcher
+    // ------------------------------------------------------------------------
+
+    Watcher::Watcher(std::filesystem::path file)
+        : m_file(std::move(file))
+    {
+    }
+
+    Watcher::~Watcher()
+    {
+        Stop();
+    }
+
+    bool Watcher::Start()
+    {
+        if (Running())
+            return true;
+
+        std::string text;
+        m_entries = ReadFile(m_file, text) ? Parse(text) : Entries{};
+
+        if (!OpenNotification())
+            return false;
+
+        m_thread = std::thread(&Watcher::WatchLoop, this);
+        return true;
+    }
+
+    void Watcher::Stop()
+    {
+        if (!m_thread.joinable())
+            return;
+
+        WakeWorker();
+        m_thread.join();
+        CloseNotification();
+    }
+
+    bool Watcher::Poll(Diff& out)
+    {
+        if (!m_hasPending.load(std::memory_order_acquire))
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        out = m_pending;
+        m_pending = Diff{};
+        m_hasPending.store(false, std::memory_order_relaxed);
+        return out.keys > 0;
+    }
+
+    void Watcher::WatchLoop()
+    {
+        for (;;)
+        {
+            auto wait = WaitForChange(-1);
+            if (wait == Wait::Stopped)
+                return;
+            if (wait != Wait::Changed)
+                continue;
+
+            // Editors often save in several writes; read once they stop
+            while ((wait = WaitForChange(kSettleMs)) == Wait::Changed)
+            {
+            }
+            if (wait == Wait::Stopped)
+                return;
+
+            Rescan();
+        }
+    }
+
+    void Watcher::Rescan()
+    {
+        std::string text;
+        if (!ReadFile(m_file, text))
+            return;  // Removed or mid-replace; compare against the last version when it is back
+
+        auto entries = Parse(text);
+        const auto diff = Compare(m_entries, entries);
+        m_entries = std::move(entries);
+        if (diff.keys == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pending.changes |= diff.changes;
+        m_pending.keys += diff.keys;
+        m_hasPending.store(true, std::memory_order_release);
+    }
+
+    static std::filesystem::path WatchedFolder(const std::filesystem::path& file)
+    {
+        return file.has_parent_path() ? file.parent_path() : std::filesystem::path(".");
+    }
+
+#ifdef _WIN32
+    bool Watcher::OpenNotification()
+    {
+        // Reports changes to any file in the folder; Rescan filters by content
+        HANDLE change = FindFirstChangeNotificationW(WatchedFolder(m_file).c_str(), FALSE,
+                                                     FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME |
+                                                         FILE_NOTIFY_CHANGE_SIZE);
+        if (change == INVALID_HANDLE_VALUE)
+            return false;
+
+        HANDLE stop = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!stop)
+        {
+            FindCloseChangeNotification(change);
+            return false;
+        }
+
+        m_change = change;
+        m_stopEvent = stop;
+        return true;
+    }
+
+    void Watcher::CloseNotification()
+    {
+        if (m_change)
+            FindCloseChangeNotification(static_cast<HANDLE>(m_change));
+        if (m_stopEvent)
+            CloseHandle(static_cast<HANDLE>(m_stopEvent));
+        m_change = nullptr;
+        m_stopEvent = nullptr;
+    }
+
+    Watcher::Wait Watcher::WaitForChange(int timeoutMs)
+    {
+        const HANDLE handles[2] = {static_cast<HANDLE>(m_stopEvent), static_cast<HANDLE>(m_change)};
+        const DWORD result = WaitForMultipleObjects(2, handles, FALSE,
+                                                    timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+        if (result == WAIT_OBJECT_0 + 1)
+        {
+            FindNextChangeNotification(static_cast<HANDLE>(m_change));
+            return Wait::Changed;
+        }
+        if (result == WAIT_TIMEOUT)
+            return Wait::Timeout;
+        return Wait::Stopped;  // Stop requested or the handles failed
+    }
+
+    void Watcher::WakeWorker()
+    {
+        SetEvent(static_cast<HANDLE>(m_stopEvent));
+    }
+#else
+    bool Watcher::OpenNotification()
+    {
+        m_notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_notify < 0)
+            return false;
+
+        // Watch the folder so saves that replace the file are seen too
+        const auto mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+        if (inotify_add_watch(m_notify, WatchedFolder(m_file).c_str(), mask) < 0 || pipe2(m_wake, O_CLOEXEC) != 0)
+        {
+            CloseNotification();
+            return false;
+        }
+        return true;
+    }
+
+    void Watcher::CloseNotification()
+    {
+        for (int* fd : {&m_notify, &m_wake[0], &m_wake[1]})
+        {
+            if (*fd >= 0)
+                close(*fd);
+            *fd = -1;
+        }
+    }
+
+    Watcher::Wait Watcher::WaitForChange(int timeoutMs)
+    {
+        pollfd fds[2] = {{m_wake[0], POLLIN, 0}, {m_notify, POLLIN, 0}};
+        int ready;
+        while ((ready = poll(fds, 2, timeoutMs)) < 0 && errno == EINTR)
+        {
+        }
+        if (ready < 0 || fds[0].revents)
+            return Wait::Stopped;
+        if (ready == 0)
+            return Wait::Timeout;
+
+        // Drain every queued event; only the ones naming the file count
+        const auto name = m_file.filename().string();
+        bool named = false;
+        alignas(inotify_event) char buffer[4096];
+        ssize_t bytes;
+        while ((bytes = read(m_notify, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* p = buffer; p < buffer + bytes;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(p);
+                if (event->len > 0 && name == event->name)
+                    named = true;
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        return named ? Wait::Changed : Wait::Timeout;
+    }
+
+    void Watcher::WakeWorker()
+    {
+        const char byte = 1;
+        [[maybe_unused]] const auto written = write(m_wake[1], &byte, 1);
+    }
+#endif
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace SettingsWatch
+ * @brief Settings file watching and per-key change classification.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Configuration
+ *
+ * Edits to `whois.ini` are picked up without a key press. A background
+ * thread waits on the operating system's change notifications for the
+ * file's folder, re-reads the file once writes have settled, and compares
+ * its keys with the previous version. The render thread only polls an
+ * atomic flag and reloads when some key actually changed.
+ *
+ * | Platform | Notification                                         |
+ * |----------|------------------------------------------------------|
+ * | Windows  | `FindFirstChangeNotificationW` on the folder          |
+ * | Linux    | `inotify` on the folder, filtered by file name        |
+ *
+ * ## :material-file-compare: Per-Key Diff
+ *
+ * `Parse` flattens the file into sorted `(section, key, value)` entries and
+ * `Compare` walks two such lists in step, so a save that only reformats
+ * comments or whitespace produces no change at all. Each changed, added or
+ * removed key is mapped by `Classify` to the caches it feeds:
+ *
+ * | Keys                                              | Change              | Invalidates                  |
+ * |---------------------------------------------------|---------------------|------------------------------|
+ * | Colors, effects, distances, particles, ...        | `kNone`             | Nothing, read every frame    |
+ * | `Format`, tier names and level ranges             | `kLabelText`        | Typewriter reveals           |
+ * | Special title `Keyword`, `DisplayTitle`, `Priority` | `kLabelText`      | Typewriter reveals           |
+ * | `*FontPath`, `*FontSize`                          | `kFonts`            | Font atlas, ornament runs    |
+ * | Tier and special title `Ornaments`                | `kOrnaments`        | Ornament runs                |
+ * | `UseParticleTextures`                             | `kParticleTextures` | Particle sprite load         |
+ * | `EnableOcclusionCulling`, `OcclusionCheckInterval` | `kOcclusion`       | Cached line-of-sight results |
+ * | `OcclusionBackend`, `OcclusionCorrectionInterval` | `kOcclusion`        | Cached line-of-sight results |
+ * | `UseTemplateAppearance`, `Template*`              | `kAppearance`       | Applied appearance template  |
+ * | `NoiseTableSize`                                  | `kNoiseTables`      | Effect noise tables          |
+ *
+ * A color edit therefore reloads the values and leaves every cache alone,
+ * and a font size edit only rebuilds the atlas.
+ *
+ * @see Settings::Load, Renderer::ReloadSettings
+ */
+namespace SettingsWatch
+{
+    /// Caches a set of changed keys invalidates, see the table above.
+    enum Change : std::uint32_t
+    {
+        kNone             = 0,
+        kLabelText        = 1u << 0,  ///< Text a label shows
+        kFonts            = 1u << 1,  ///< Font files or sizes
+        kParticleTextures = 1u << 2,  ///< Particle sprite textures
+        kOcclusion        = 1u << 3,  ///< Line-of-sight checks
+        kAppearance       = 1u << 4,  ///< Player appearance template
+        kOrnaments        = 1u << 5,  ///< Ornament strings of tiers and special titles
+        kNoiseTables      = 1u << 6,  ///< Effect noise table size
+        kAll              = (1u << 7) - 1
+    };
+
+    /// One `key = value` line and the section it appeared in.
+    struct Entry
+    {
+        std::string section;  ///< Section name without brackets, empty before the first header
+        std::string key;
+        std::string value;
+    };
+
+    /// Entries sorted by section and key, one per pair.
+    using Entries = std::vector<Entry>;
+
+    /**
+     * Flatten INI text into sorted entries.
+     *
+     * Keys and values are trimmed, comments (`;`, `#`) and blank lines are
+     * skipped. A key repeated within a section keeps its last value, the one
+     * `Settings::Load` ends up with.
+     */
+    Entries Parse(std::string_view text);
+
+    /// Changes caused by one key of one section.
+    std::uint32_t Classify(std::string_view section, std::string_view key);
+
+    /// Result of comparing two versions of the file.
+    struct Diff
+    {
+        std::uint32_t changes{kNone};  ///< `Change` flags of the keys that differ
+        std::uint32_t keys{0};         ///< Keys added, removed or changed
+    };
+
+    /// Compare two parsed versions of the file key by key.
+    Diff Compare(const Entries& before, const Entries& after);
+
+    /**
+     * Background watcher of one settings file.
+     *
+     * ```cpp
+     * SettingsWatch::Watcher watcher("Data/SKSE/Plugins/whois.ini");
+     * watcher.Start();
+     *
+     * // Every frame
+     * SettingsWatch::Diff diff;
+     * if (watcher.Poll(diff))
+     *     ReloadAndInvalidate(diff.changes);
+     * ```
+     */
+    class Watcher
+    {
+    public:
+        /// Writes closer together than this are treated as one save.
+        static constexpr int kSettleMs = 100;
+
+        explicit Watcher(std::filesystem::path file);
+        ~Watcher();
+
+        Watcher(const Watcher&) = delete;
+        Watcher& operator=(const Watcher&) = delete;
+
+        /**
+         * Read the current file as the baseline and start watching.
+         *
+         * @return `false` if the folder cannot be watched.
+         */
+        bool Start();
+
+        /// Stop and join the watch thread. Safe to call when not running.
+        void Stop();
+
+        bool Running() const { return m_thread.joinable(); }
+
+        /**
+         * Take the changes found since the last call.
+         *
+         * Cheap when nothing changed: a single atomic load.
+         *
+         * @return `false` if no key changed.
+         */
+        bool Poll(Diff& out);
+
+    private:
+        enum class Wait { Changed, Timeout, Stopped };
+
+        bool OpenNotification();
+        void CloseNotification();
+        Wait WaitForChange(int timeoutMs);
+        void WakeWorker();
+        void WatchLoop();
+        void Rescan();
+
+        std::filesystem::path m_file;
+        Entries m_entries;  // Last version read, watch thread only
+
+        std::mutex m_lock;
+        Diff m_pending;     // Merged saves not yet polled, guarded by m_lock
+        std::atomic<bool> m_hasPending{false};
+        std::thread m_thread;
+
+#ifdef _WIN32
+        void* m_change{nullptr};     // Folder change notification handle
+        void* m_stopEvent{nullptr};  // Signalled by Stop()
+#else
+        int m_notify{-1};            // inotify descriptor
+        int m_wake[2]{-1, -1};       // Pipe written by Stop()
+#endif
+    };
+}
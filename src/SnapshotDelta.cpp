@@ -0,0 +1,330 @@
+#include "SnapshotDelta.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace SnapshotDelta
+{
+    namespace
+    {
+        bool IsSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        Record MakeAttributes(Op op, const ActorState& s)
+        {
+            Record r;
+            r.op = op;
+            r.flags = static_cast<std::uint8_t>(s.flags & ~kMotionFlags);
+            r.level = s.level;
+            r.formID = s.formID;
+            r.attributes.disposition = s.disposition;
+            r.attributes.nameLength = s.nameLength;
+            std::memcpy(r.attributes.name, s.name, s.nameLength);
+            return r;
+        }
+
+        Record MakePosition(const ActorState& s)
+        {
+            Record r;
+            r.op = Op::Position;
+            r.flags = static_cast<std::uint8_t>(s.flags & kMotionFlags);
+            r.formID = s.formID;
+            std::memcpy(r.motion.pos, s.pos, sizeof(s.pos));
+            r.motion.distToPlayer = s.distToPlayer;
+            return r;
+        }
+
+        Record MakeRemove(std::uint32_t formID)
+        {
+            Record r;
+            r.op = Op::Remove;
+            r.formID = formID;
+            return r;
+        }
+
+        void ApplyAttributes(ActorState& s, const Record& r)
+        {
+            s.flags = static_cast<std::uint8_t>((s.flags & kMotionFlags) | (r.flags & ~kMotionFlags));
+            s.level = r.level;
+            s.disposition = r.attributes.disposition;
+            s.nameLength = std::min<std::uint8_t>(r.attributes.nameLength, static_cast<std::uint8_t>(kMaxNameLength));
+            std::memcpy(s.name, r.attributes.name, s.nameLength);
+            s.name[s.nameLength] = '\0';
+        }
+
+        void ApplyMotion(ActorState& s, const Record& r)
+        {
+            s.flags = static_cast<std::uint8_t>((s.flags & ~kMotionFlags) | (r.flags & kMotionFlags));
+            std::memcpy(s.pos, r.motion.pos, sizeof(s.pos));
+            s.distToPlayer = r.motion.distToPlayer;
+        }
+    }
+
+    // ========== ActorState ==========
+
+    void ActorState::SetName(const char* text)
+    {
+        nameLength = 0;
+        name[0] = '\0';
+        if (!text)
+            return;
+
+        // Trim leading/trailing whitespace
+        const char* first = text;
+        while (*first && IsSpace(*first))
+            ++first;
+        const char* last = first + std::strlen(first);
+        while (last > first && IsSpace(last[-1]))
+            --last;
+
+        std::size_t length = static_cast<std::size_t>(last - first);
+        if (length > kMaxNameLength)
+        {
+            // Back off to the start of a UTF-8 sequence
+            length = kMaxNameLength;
+            while (length > 0 && (static_cast<unsigned char>(first[length]) & 0xC0) == 0x80)
+                --length;
+        }
+
+        // Title Case
+        bool newWord = true;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            char c = first[i];
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                newWord = true;
+            }
+            else if (newWord)
+            {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                newWord = false;
+            }
+            name[i] = c;
+        }
+
+        nameLength = static_cast<std::uint8_t>(length);
+        name[length] = '\0';
+    }
+
+    bool ActorState::SameMotion(const ActorState& rhs) const
+    {
+        // Bitwise, so an update is sent whenever the mirror would differ
+        return std::memcmp(pos, rhs.pos, sizeof(pos)) == 0 &&
+               std::memcmp(&distToPlayer, &rhs.distToPlayer, sizeof(distToPlayer)) == 0 &&
+               (flags & kMotionFlags) == (rhs.flags & kMotionFlags);
+    }
+
+    bool ActorState::SameAttributes(const ActorState& rhs) const
+    {
+        return formID == rhs.formID &&
+               level == rhs.level &&
+               disposition == rhs.disposition &&
+               (flags & ~kMotionFlags) == (rhs.flags & ~kMotionFlags) &&
+               nameLength == rhs.nameLength &&
+               std::memcmp(name, rhs.name, nameLength) == 0;
+    }
+
+    // ========== Table ==========
+
+    void Table::Reserve(std::size_t actors)
+    {
+        m_actors.reserve(actors);
+        m_keys.reserve(actors);
+    }
+
+    std::size_t Table::Find(std::uint32_t formID) const
+    {
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), formID,
+                                   [](const auto& key, std::uint32_t id) { return key.first < id; });
+        return (it != m_keys.end() && it->first == formID) ? it->second : npos;
+    }
+
+    void Table::Add(const ActorState& state)
+    {
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), state.formID,
+                                   [](const auto& key, std::uint32_t id) { return key.first < id; });
+        m_keys.insert(it, {state.formID, static_cast<std::uint32_t>(m_actors.size())});
+        m_actors.push_back(state);
+    }
+
+    bool Table::Remove(std::uint32_t formID)
+    {
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), formID,
+                                   [](const auto& key, std::uint32_t id) { return key.first < id; });
+        if (it == m_keys.end() || it->first != formID)
+            return false;
+
+        const std::uint32_t slot = it->second;
+        m_keys.erase(it);
+        m_actors.erase(m_actors.begin() + slot);
+
+        // Later actors moved down one slot
+        for (auto& key : m_keys)
+        {
+            if (key.second > slot)
+                --key.second;
+        }
+        return true;
+    }
+
+    void Table::Clear()
+    {
+        m_actors.clear();
+        m_keys.clear();
+    }
+
+    void Table::Apply(const Record& record)
+    {
+        switch (record.op)
+        {
+        case Op::Add:
+        {
+            const std::size_t slot = Find(record.formID);
+            if (slot != npos)
+            {
+                ApplyAttributes(m_actors[slot], record);
+                break;
+            }
+            ActorState state;
+            state.formID = record.formID;
+            ApplyAttributes(state, record);
+            Add(state);
+            break;
+        }
+
+        case Op::Remove:
+            Remove(record.formID);
+            break;
+
+        case Op::Position:
+            if (const std::size_t slot = Find(record.formID); slot != npos)
+                ApplyMotion(m_actors[slot], record);
+            break;
+
+        case Op::Attributes:
+            if (const std::size_t slot = Find(record.formID); slot != npos)
+                ApplyAttributes(m_actors[slot], record);
+            break;
+
+        case Op::Clear:
+            Clear();
+            break;
+        }
+    }
+
+    void Table::Apply(const Record* records, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            Apply(records[i]);
+    }
+
+    // ========== Encoder ==========
+
+    void Encoder::Reserve(std::size_t actors)
+    {
+        m_table.Reserve(actors);
+        m_seen.reserve(actors);
+    }
+
+    void Encoder::Encode(const ActorState* frame, std::size_t count, std::vector<Record>& out)
+    {
+        m_seen.assign(m_table.Size(), 0);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const ActorState& cur = frame[i];
+            const std::size_t slot = m_table.Find(cur.formID);
+            if (slot == Table::npos)
+            {
+                out.push_back(MakeAttributes(Op::Add, cur));
+                out.push_back(MakePosition(cur));
+                m_table.Add(cur);
+                m_seen.push_back(1);
+                continue;
+            }
+
+            ActorState& prev = m_table.At(slot);
+            if (!prev.SameAttributes(cur))
+                out.push_back(MakeAttributes(Op::Attributes, cur));
+            if (!prev.SameMotion(cur))
+                out.push_back(MakePosition(cur));
+            prev = cur;
+            m_seen[slot] = 1;
+        }
+
+        // Back to front, so earlier slots stay valid while removing
+        for (std::size_t slot = m_seen.size(); slot-- > 0;)
+        {
+            if (m_seen[slot])
+                continue;
+            const std::uint32_t formID = m_table.At(slot).formID;
+            out.push_back(MakeRemove(formID));
+            m_table.Remove(formID);
+        }
+    }
+
+    void Encoder::EncodeFull(std::vector<Record>& out) const
+    {
+        out.push_back(Record{});  // Op::Clear
+        for (const auto& s : m_table.Actors())
+        {
+            out.push_back(MakeAttributes(Op::Add, s));
+            out.push_back(MakePosition(s));
+        }
+    }
+
+    // ========== Channel ==========
+
+    Channel::Channel(std::size_t maxPending)
+        : m_maxPending(maxPending)
+    {
+    }
+
+    void Channel::Publish(const ActorState* frame, std::size_t count)
+    {
+        m_stage.clear();
+        m_encoder.Encode(frame, count, m_stage);
+        if (m_stage.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_pending.size() + m_stage.size() > m_maxPending)
+        {
+            // Nobody is consuming; replace the backlog with the current state
+            m_pending.clear();
+            m_encoder.EncodeFull(m_pending);
+            m_stats.published += m_pending.size();
+            ++m_stats.resyncs;
+            return;
+        }
+
+        m_pending.insert(m_pending.end(), m_stage.begin(), m_stage.end());
+        m_stats.published += m_stage.size();
+    }
+
+    std::size_t Channel::Consume(Table& mirror)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_pending.empty())
+                return 0;
+            m_taken.swap(m_pending);
+            m_stats.consumed += m_taken.size();
+        }
+
+        mirror.Apply(m_taken.data(), m_taken.size());
+        const std::size_t applied = m_taken.size();
+        m_taken.clear();
+        return applied;
+    }
+
+    Stats Channel::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_stats;
+    }
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace SnapshotDelta
+ * @brief Delta-encoded handoff of the actor snapshot from game to render thread.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * The game thread used to rebuild a vector of actors with heap-allocated
+ * names every update and the render thread copied it again under a lock.
+ * Names, levels and dispositions almost never change between updates, so
+ * the game thread now diffs each update against the previous one and sends
+ * only the changes as fixed-size records. The render thread applies them to
+ * a mirrored `Table`.
+ *
+ * ## :material-format-list-bulleted-type: Records
+ *
+ * | Op           | Sent when                                         | Payload                       |
+ * |--------------|---------------------------------------------------|-------------------------------|
+ * | `Add`        | Actor entered the snapshot                        | Attributes, then a `Position` |
+ * | `Remove`     | Actor left the snapshot                           | Form ID only                  |
+ * | `Position`   | Anchor, distance or occlusion changed             | `Motion`                      |
+ * | `Attributes` | Name, level, disposition or player flag changed   | `Attributes`                  |
+ * | `Clear`      | Consumer fell too far behind; full resync follows | None                          |
+ *
+ * Every record is `sizeof(Record)` bytes. Names are stored inline, truncated
+ * to `kMaxNameLength` bytes on a UTF-8 boundary.
+ *
+ * ```mermaid
+ * %%{init: {'theme':'dark', 'look':'handDrawn'}}%%
+ * flowchart LR
+ *     classDef thread fill:#1e3a5f,stroke:#3b82f6,color:#e2e8f0
+ *     classDef data fill:#4a3520,stroke:#f59e0b,color:#e2e8f0
+ *     GT[Game Thread]:::thread -->|Encode vs. last update| Q[Pending Records]:::data
+ *     Q -->|Consume| M[Mirrored Table]:::data
+ *     M --> RT[Render Thread]:::thread
+ * ```
+ *
+ * ## :material-sort: Ordering
+ *
+ * Actors keep the order in which they were added; a removal closes the gap
+ * without reordering the rest. The encoder tracks exactly what the mirror
+ * holds, so both sides always agree on order as well as content.
+ *
+ * ## :material-memory: Allocation
+ *
+ * Tables, staging and pending buffers keep their capacity. Once they have
+ * grown to the largest update seen, encoding and applying updates does not
+ * touch the heap.
+ *
+ * @see Renderer::Draw
+ */
+namespace SnapshotDelta
+{
+    constexpr std::size_t kMaxNameLength = 54;  ///< Name bytes stored per actor
+
+    /// Actor flag bits.
+    enum Flags : std::uint8_t
+    {
+        kPlayer = 1 << 0,    ///< Actor is the player
+        kOccluded = 1 << 1,  ///< Nameplate anchor is out of line of sight
+        kMotionFlags = kOccluded  ///< Flags carried by `Position` records
+    };
+
+    /// One actor as seen by the renderer.
+    struct ActorState
+    {
+        std::uint32_t formID{0};
+        float pos[3]{};                   ///< World anchor above the head
+        float distToPlayer{0.0f};
+        std::uint16_t level{0};
+        std::uint8_t disposition{0};      ///< `Renderer::Disposition` value
+        std::uint8_t flags{0};            ///< `Flags` bits
+        std::uint8_t nameLength{0};
+        char name[kMaxNameLength + 1]{};  ///< Null-terminated
+
+        /**
+         * Store a display name: trimmed, Title Cased, truncated to
+         * `kMaxNameLength` bytes without splitting a UTF-8 sequence.
+         */
+        void SetName(const char* text);
+
+        bool SameMotion(const ActorState& rhs) const;
+        bool SameAttributes(const ActorState& rhs) const;
+        bool operator==(const ActorState& rhs) const { return SameMotion(rhs) && SameAttributes(rhs); }
+    };
+
+    /// Record kind, see the table above.
+    enum class Op : std::uint8_t
+    {
+        Add,
+        Remove,
+        Position,
+        Attributes,
+        Clear
+    };
+
+    /// Fixed-size delta record.
+    struct Record
+    {
+        Op op{Op::Clear};
+        std::uint8_t flags{0};
+        std::uint16_t level{0};
+        std::uint32_t formID{0};
+
+        struct Motion
+        {
+            float pos[3];
+            float distToPlayer;
+        };
+
+        struct Attributes
+        {
+            std::uint8_t disposition;
+            std::uint8_t nameLength;
+            char name[kMaxNameLength];
+        };
+
+        union
+        {
+            Motion motion;
+            Attributes attributes;
+        };
+
+        Record() : attributes{} {}
+    };
+
+    static_assert(sizeof(Record) == 64, "records are one cache line");
+
+    /**
+     * Ordered actor table with lookup by form ID.
+     *
+     * Used as the render thread's mirror and as the encoder's model of it.
+     */
+    class Table
+    {
+    public:
+        void Reserve(std::size_t actors);
+
+        const std::vector<ActorState>& Actors() const { return m_actors; }
+        std::size_t Size() const { return m_actors.size(); }
+        bool Empty() const { return m_actors.empty(); }
+
+        /// Slot of `formID`, or `npos`.
+        std::size_t Find(std::uint32_t formID) const;
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        ActorState& At(std::size_t slot) { return m_actors[slot]; }
+
+        /// Append an actor. The form ID must not be present.
+        void Add(const ActorState& state);
+
+        /// Remove an actor, keeping the order of the rest.
+        bool Remove(std::uint32_t formID);
+
+        void Clear();
+
+        /// Apply one record; unknown form IDs in updates are ignored.
+        void Apply(const Record& record);
+        void Apply(const Record* records, std::size_t count);
+
+    private:
+        std::vector<ActorState> m_actors;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> m_keys;  // sorted (formID, slot)
+    };
+
+    /**
+     * Game-thread side: turns successive full snapshots into records.
+     */
+    class Encoder
+    {
+    public:
+        void Reserve(std::size_t actors);
+
+        /// Append the records that turn the previous snapshot into `frame`.
+        void Encode(const ActorState* frame, std::size_t count, std::vector<Record>& out);
+
+        /// Append a `Clear` followed by the whole current snapshot.
+        void EncodeFull(std::vector<Record>& out) const;
+
+        /// What a consumer holds after applying everything encoded so far.
+        const Table& State() const { return m_table; }
+
+    private:
+        Table m_table;
+        std::vector<std::uint8_t> m_seen;
+    };
+
+    /// Traffic counters.
+    struct Stats
+    {
+        std::uint64_t published{0};  ///< Records queued
+        std::uint64_t consumed{0};   ///< Records applied
+        std::uint64_t resyncs{0};    ///< Times the pending queue was replaced by a full snapshot
+    };
+
+    /**
+     * Queue between the game thread and the render thread.
+     *
+     * If the render thread stops consuming (menus, load screens) the queue is
+     * replaced by a full resync once it exceeds `maxPending` records, so it
+     * never grows without bound.
+     */
+    class Channel
+    {
+    public:
+        explicit Channel(std::size_t maxPending = 4096);
+
+        /// Game thread: publish the current snapshot (may be empty).
+        void Publish(const ActorState* frame, std::size_t count);
+
+        /// Render thread: apply all pending records to `mirror`. Returns the count applied.
+        std::size_t Consume(Table& mirror);
+
+        Stats GetStats() const;
+
+    private:
+        const std::size_t m_maxPending;
+
+        Encoder m_encoder;              // game thread
+        std::vector<Record> m_stage;    // game thread
+        std::vector<Record> m_taken;    // render thread
+
+        mutable std::mutex m_lock;
+        std::vector<Record> m_pending;
+        Stats m_stats;
+    };
+}
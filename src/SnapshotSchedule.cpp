@@ -0,0 +1,115 @@
+#include "SnapshotSchedule.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SnapshotSchedule
+{
+    Mode ModeFromInt(int value)
+    {
+        return value == 0 ? Mode::Task : Mode::MainLoop;
+    }
+
+    bool Scheduler::BeginRenderFrame(double now)
+    {
+        // Time from the newest scan reading positions to this frame drawing them
+        const auto seq = m_scanSeq.load(std::memory_order_acquire);
+        if (seq != m_seenScanSeq)
+        {
+            m_seenScanSeq = seq;
+            AddLagSample(static_cast<float>((now - m_scanTime.load(std::memory_order_relaxed)) * 1000.0));
+        }
+
+        bool useTask = GetMode() == Mode::Task;
+        if (!useTask)
+        {
+            const auto calls = m_mainLoopCalls.load(std::memory_order_relaxed);
+            if (calls != m_seenMainLoopCalls)
+            {
+                m_seenMainLoopCalls = calls;
+                m_framesWithoutMainLoop = 0;
+            }
+            else if (m_framesWithoutMainLoop < kFallbackFrames)
+            {
+                ++m_framesWithoutMainLoop;
+            }
+            useTask = m_framesWithoutMainLoop >= kFallbackFrames;
+        }
+        m_fallback.store(useTask && GetMode() == Mode::MainLoop, std::memory_order_relaxed);
+
+        if (!useTask)
+        {
+            // Taken by the next main loop update
+            m_scanArmed.store(true, std::memory_order_release);
+            return false;
+        }
+
+        // One task in flight at a time
+        if (m_taskPending.exchange(true, std::memory_order_acq_rel))
+            return false;
+        ++m_tasksQueued;
+        return true;
+    }
+
+    void Scheduler::TaskNotQueued()
+    {
+        m_taskPending.store(false, std::memory_order_release);
+    }
+
+    bool Scheduler::MainLoopUpdate()
+    {
+        m_mainLoopCalls.fetch_add(1, std::memory_order_relaxed);
+        if (GetMode() != Mode::MainLoop)
+            return false;
+        return m_scanArmed.exchange(false, std::memory_order_acq_rel);
+    }
+
+    bool Scheduler::TaskStarted()
+    {
+        // A task queued before the main loop took over has nothing left to do
+        return GetMode() == Mode::Task || FallingBack();
+    }
+
+    void Scheduler::TaskFinished()
+    {
+        m_taskPending.store(false, std::memory_order_release);
+    }
+
+    void Scheduler::Scanned(double scanTime)
+    {
+        m_scanTime.store(scanTime, std::memory_order_relaxed);
+        m_scanSeq.fetch_add(1, std::memory_order_release);
+    }
+
+    void Scheduler::AddLagSample(float ms)
+    {
+        m_lagMs[m_lagNext] = ms;
+        m_lagNext = (m_lagNext + 1) % kLagSamples;
+        m_lagCount = std::min(m_lagCount + 1, kLagSamples);
+    }
+
+    LagStats Scheduler::Lag() const
+    {
+        LagStats stats;
+        stats.samples = static_cast<std::uint32_t>(m_lagCount);
+        if (m_lagCount == 0)
+            return stats;
+
+        double sum = 0.0;
+        for (std::size_t i = 0; i < m_lagCount; ++i)
+        {
+            sum += m_lagMs[i];
+            stats.maxMs = std::max(stats.maxMs, m_lagMs[i]);
+        }
+        const double mean = sum / static_cast<double>(m_lagCount);
+
+        double variance = 0.0;
+        for (std::size_t i = 0; i < m_lagCount; ++i)
+            variance += (m_lagMs[i] - mean) * (m_lagMs[i] - mean);
+        variance /= static_cast<double>(m_lagCount);
+
+        stats.meanMs = static_cast<float>(mean);
+        stats.jitterMs = static_cast<float>(std::sqrt(variance));
+        return stats;
+    }
+}
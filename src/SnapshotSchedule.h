@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace SnapshotSchedule
+ * @brief When the game thread scans actors for the render thread.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * The actor scan has to run on the game thread. It can be reached two ways:
+ *
+ * | Mode       | Scan runs                                   | Per frame cost          | Position lag      |
+ * |------------|---------------------------------------------|-------------------------|-------------------|
+ * | `Task`     | Wherever SKSE drains its task queue         | One heap-allocated task | Varies, 0-1 frame |
+ * | `MainLoop` | Hooked call in `Main::Update`, after actors | One atomic exchange     | Fixed             |
+ *
+ * With `MainLoop` positions are read at the same point of every frame, so
+ * the time from scan to draw is constant and labels need less smoothing to
+ * hide it. The render thread still paces the scans: each rendered frame arms
+ * one scan, which the next main loop update takes.
+ *
+ * ## :material-shield-refresh: Fallback
+ *
+ * If no main loop update is seen for `kFallbackFrames` rendered frames, e.g.
+ * because the hook could not be installed on this game version, scans go
+ * back to queued tasks until the hook reports again.
+ *
+ * ## :material-chart-timeline: Lag Statistics
+ *
+ * Each rendered frame that sees a new scan records the time since the scan
+ * read positions. `Lag()` reports mean, maximum and jitter (standard
+ * deviation) over the last `kLagSamples` frames.
+ *
+ * ## :material-test-tube: Testing
+ *
+ * The scheduler takes timestamps as arguments and never calls the engine,
+ * so a simulated main loop can drive both modes headlessly.
+ *
+ * @see Renderer::TickRT, Renderer::UpdateMainLoop, Hooks::Install
+ */
+namespace SnapshotSchedule
+{
+    inline constexpr std::uint32_t kFallbackFrames = 30;  ///< Rendered frames without a main loop update
+    inline constexpr std::size_t kLagSamples = 120;       ///< Frames in the lag window
+
+    /// How scans reach the game thread, see the table above.
+    enum class Mode : std::uint8_t
+    {
+        Task,     ///< SKSE task queue
+        MainLoop  ///< Main loop hook (default)
+    };
+
+    /// Convert the `SnapshotUpdateMode` setting to a mode; out of range is `MainLoop`.
+    Mode ModeFromInt(int value);
+
+    /// Scan to draw delay over the lag window, in milliseconds.
+    struct LagStats
+    {
+        std::uint32_t samples{0};
+        float meanMs{0.0f};
+        float maxMs{0.0f};
+        float jitterMs{0.0f};  ///< Standard deviation
+    };
+
+    class Scheduler
+    {
+    public:
+        void SetMode(Mode mode) { m_mode.store(mode, std::memory_order_relaxed); }
+        Mode GetMode() const { return m_mode.load(std::memory_order_relaxed); }
+
+        // ---- Render thread ----
+
+        /**
+         * Start a rendered frame at `now` seconds.
+         *
+         * Records the lag of a scan that finished since the last frame and
+         * arms the next one.
+         *
+         * @return `true` if the caller must queue a task that calls
+         *         TaskStarted(); call TaskNotQueued() if that fails.
+         */
+        bool BeginRenderFrame(double now);
+
+        /// The task BeginRenderFrame() asked for could not be queued.
+        void TaskNotQueued();
+
+        /// Scans are going through tasks although the mode is `MainLoop`.
+        bool FallingBack() const { return m_fallback.load(std::memory_order_relaxed); }
+
+        LagStats Lag() const;
+
+        /// Tasks requested so far.
+        std::uint64_t TasksQueued() const { return m_tasksQueued; }
+
+        // ---- Game thread ----
+
+        /// From the main loop hook; `true` if the scan should run now.
+        bool MainLoopUpdate();
+
+        /// From a queued task; `true` if the scan should run in it.
+        bool TaskStarted();
+
+        /// End of the task, after the scan if it ran.
+        void TaskFinished();
+
+        /// A scan read positions at `scanTime` seconds.
+        void Scanned(double scanTime);
+
+    private:
+        void AddLagSample(float ms);
+
+        std::atomic<Mode> m_mode{Mode::MainLoop};
+
+        // Shared with the game thread
+        std::atomic<bool> m_taskPending{false};
+        std::atomic<bool> m_scanArmed{false};
+        std::atomic<bool> m_fallback{false};
+        std::atomic<std::uint32_t> m_mainLoopCalls{0};
+        std::atomic<std::uint32_t> m_scanSeq{0};
+        std::atomic<double> m_scanTime{0.0};
+
+        // Render thread only
+        std::uint32_t m_seenMainLoopCalls{0};
+        std::uint32_t m_framesWithoutMainLoop{0};
+        std::uint32_t m_seenScanSeq{0};
+        std::uint64_t m_tasksQueued{0};
+        std::array<float, kLagSamples> m_lagMs{};
+        std::size_t m_lagCount{0};
+        std::size_t m_lagNext{0};
+    };
+}
@@ -0,0 +1,210 @@
+#include "TemplatePipeline.h"
+
+namespace TemplatePipeline
+{
+    Pipeline::Pipeline(IHost& host, double frameBudgetMs, double waitBudgetMs)
+        : m_host(host), m_budgetMs(frameBudgetMs), m_waitBudgetMs(waitBudgetMs)
+    {
+    }
+
+    void Pipeline::Start()
+    {
+        m_spawnRefID.store(0, std::memory_order_relaxed);
+        m_deadlineMs.store(0.0, std::memory_order_relaxed);
+        SetStage(Stage::WaitPlayer);
+        RequestTick();  // Player may already be loaded, no event would follow
+    }
+
+    void Pipeline::StartRefresh()
+    {
+        m_deadlineMs.store(0.0, std::memory_order_relaxed);
+        SetStage(Stage::RefreshColors);
+        RequestTick();
+    }
+
+    void Pipeline::Cancel()
+    {
+        m_deadlineMs.store(0.0, std::memory_order_relaxed);
+        SetStage(Stage::Idle);
+    }
+
+    bool Pipeline::IsBusy() const
+    {
+        const Stage stage = GetStage();
+        return stage != Stage::Idle && stage != Stage::Done && stage != Stage::Failed;
+    }
+
+    void Pipeline::OnObjectLoaded(std::uint32_t refID)
+    {
+        switch (GetStage())
+        {
+        case Stage::WaitPlayer:
+            if (refID == kPlayerRefID)
+                RequestTick();
+            break;
+        case Stage::Update3DModel:
+        case Stage::UpdateNeck:
+            if (refID == kPlayerRefID)
+            {
+                m_playerLoaded.store(true, std::memory_order_release);
+                RequestTick();
+            }
+            break;
+        case Stage::WaitOutfitSource:
+            if (refID != 0 && refID == m_spawnRefID.load(std::memory_order_acquire))
+                RequestTick();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void Pipeline::RequestTick()
+    {
+        // Collapse repeated requests into a single scheduled tick
+        if (!m_tickPending.exchange(true, std::memory_order_acq_rel))
+            m_host.ScheduleTick();
+    }
+
+    void Pipeline::Tick()
+    {
+        m_tickPending.store(false, std::memory_order_release);
+
+        const double start = m_host.NowMs();
+        while (StepOnce())
+        {
+            if (!IsBusy())
+                return;
+            if (m_host.NowMs() - start >= m_budgetMs)
+            {
+                RequestTick();  // Out of budget, continue next frame
+                return;
+            }
+        }
+    }
+
+    void Pipeline::Poll()
+    {
+        if (m_deadlineMs.load(std::memory_order_acquire) > 0.0)
+            Tick();
+    }
+
+    // Arm the wait budget on the first blocked check, fail once it is spent.
+    // Returns whether the stage may run.
+    bool Pipeline::Waited(bool ready)
+    {
+        if (ready)
+        {
+            m_deadlineMs.store(0.0, std::memory_order_release);
+            return true;
+        }
+
+        const double now = m_host.NowMs();
+        const double deadline = m_deadlineMs.load(std::memory_order_acquire);
+        if (deadline <= 0.0)
+        {
+            m_deadlineMs.store(now + m_waitBudgetMs, std::memory_order_release);
+            return false;
+        }
+        if (now < deadline)
+            return false;
+
+        // Same cleanup as a copy would have done
+        m_deadlineMs.store(0.0, std::memory_order_release);
+        if (GetStage() == Stage::WaitOutfitSource)
+            m_host.ReleaseOutfit();
+        SetStage(Stage::Failed);
+        return false;
+    }
+
+    bool Pipeline::PlayerReloaded()
+    {
+        if (!m_playerLoaded.load(std::memory_order_acquire))
+        {
+            const void* root = m_host.Player3DRoot();
+            if (!root || root == m_rootBeforeReset)
+                return false;
+            m_playerLoaded.store(true, std::memory_order_release);
+        }
+        return m_host.IsPlayerReady();
+    }
+
+    // Execute the current stage. Returns false when blocked on a readiness condition.
+    bool Pipeline::StepOnce()
+    {
+        switch (GetStage())
+        {
+        case Stage::WaitPlayer:
+            if (!m_host.IsPlayerReady())
+                return false;
+            SetStage(Stage::Apply);
+            return true;
+
+        case Stage::Apply:
+        {
+            if (!m_host.ApplyRecords())
+            {
+                SetStage(Stage::Failed);
+                return true;
+            }
+
+            std::uint32_t spawnRefID = 0;
+            switch (m_host.PrepareOutfit(spawnRefID))
+            {
+            case OutfitSource::Ready:
+                SetStage(Stage::CopyOutfit);
+                break;
+            case OutfitSource::Spawned:
+                m_spawnRefID.store(spawnRefID, std::memory_order_release);
+                SetStage(Stage::WaitOutfitSource);
+                break;
+            default:
+                SetStage(Stage::RefreshColors);
+                break;
+            }
+            return true;
+        }
+
+        case Stage::WaitOutfitSource:
+            if (!Waited(m_host.IsOutfitSourceReady(m_spawnRefID.load(std::memory_order_acquire))))
+                return false;
+            SetStage(Stage::CopyOutfit);
+            return true;
+
+        case Stage::CopyOutfit:
+            m_host.CopyOutfit();
+            SetStage(Stage::RefreshColors);
+            return true;
+
+        case Stage::RefreshColors:
+        case Stage::RegenerateHead:
+        case Stage::Reset3D:
+        {
+            const Stage stage = GetStage();
+            if (stage == Stage::Reset3D)
+            {
+                m_rootBeforeReset = m_host.Player3DRoot();
+                m_playerLoaded.store(false, std::memory_order_release);
+            }
+            m_host.RunRefresh(stage);
+            SetStage(static_cast<Stage>(static_cast<std::uint8_t>(stage) + 1));
+            return true;
+        }
+
+        case Stage::Update3DModel:
+        case Stage::UpdateNeck:
+        {
+            // Both need the player's 3D reloaded by the reset
+            if (!Waited(PlayerReloaded()))
+                return false;
+            const Stage stage = GetStage();
+            m_host.RunRefresh(stage);
+            SetStage(stage == Stage::UpdateNeck ? Stage::Done : Stage::UpdateNeck);
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+}
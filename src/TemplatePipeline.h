@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @namespace TemplatePipeline
+ * @brief Event-driven, frame-budgeted sequencing of appearance template application.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Core
+ *
+ * Replaces render-thread polling and fixed frame delays with a state machine
+ * that advances only when something happens: a save finished loading, the
+ * player's or a spawned actor's 3D finished loading, or a previously
+ * scheduled game-thread tick runs. Expensive 3D refresh steps are executed
+ * one at a time and the pipeline yields to the next frame once the per-frame
+ * time budget is spent.
+ *
+ * ## :material-state-machine: Stages
+ *
+ * ```mermaid
+ * %%{init: {'theme':'dark', 'look':'handDrawn'}}%%
+ * flowchart LR
+ *     classDef wait fill:#4a3520,stroke:#f59e0b,color:#e2e8f0
+ *     classDef work fill:#1e3a5f,stroke:#3b82f6,color:#e2e8f0
+ *     WP[WaitPlayer]:::wait --> AP[Apply]:::work
+ *     AP -->|loaded actor| CO[CopyOutfit]:::work
+ *     AP -->|spawned actor| WO[WaitOutfitSource]:::wait --> CO
+ *     AP -->|no outfit| RC[RefreshColors]:::work
+ *     CO --> RC --> RH[RegenerateHead]:::work --> R3[Reset3D]:::work
+ *     R3 --> UM[Update3DModel]:::wait --> UN[UpdateNeck]:::wait --> D[Done]
+ * ```
+ *
+ * Waiting stages re-check their readiness condition through `IHost` and
+ * otherwise sleep until `OnObjectLoaded()` reports the reference they need.
+ * `Update3DModel` and `UpdateNeck` wait for the player's 3D to be reloaded
+ * after `Reset3D`: a load event for the player, or a 3D root other than the
+ * one before the reset. `Is3DLoaded()` alone is no signal, it stays true
+ * until the reset is processed.
+ *
+ * ## :material-timer-sand: Wait Budget
+ *
+ * `WaitOutfitSource`, `Update3DModel` and `UpdateNeck` wait on things that
+ * may never happen: the spawned actor's cell unloads, the spawn is deleted.
+ * They are bounded by a wait budget. While one of them is waiting, `Poll()`
+ * re-checks it every frame, and once the budget is spent the pipeline fails
+ * and releases the spawned outfit source like a successful copy would. A
+ * failed pipeline is not busy, so later refresh requests run again.
+ *
+ * ## :material-test-tube: Testing
+ *
+ * All game access goes through `IHost`, so stage sequencing can be driven
+ * by a fake event source and clock in unit tests.
+ *
+ * @see AppearanceTemplate::ApplyIfConfigured
+ */
+namespace TemplatePipeline
+{
+    constexpr std::uint32_t kPlayerRefID = 0x14;  ///< FormID of the player reference
+
+    /// Pipeline stage, in execution order.
+    enum class Stage : std::uint8_t
+    {
+        Idle,              ///< Nothing requested
+        WaitPlayer,        ///< Waiting for player, base and 3D
+        Apply,             ///< Copy record data and FaceGen
+        WaitOutfitSource,  ///< Waiting for a spawned outfit source actor's 3D
+        CopyOutfit,        ///< Transfer worn armor to the player
+        RefreshColors,     ///< Hair and skin color update
+        RegenerateHead,    ///< Reload baked FaceGen head
+        Reset3D,           ///< Reset player 3D
+        Update3DModel,     ///< Refresh equipment 3D once the player is reloaded
+        UpdateNeck,        ///< Fix neck seam once the player is reloaded
+        Done,              ///< Finished successfully
+        Failed             ///< Apply step reported failure
+    };
+
+    /// Where the outfit to copy comes from, reported by `IHost::PrepareOutfit`.
+    enum class OutfitSource : std::uint8_t
+    {
+        None,     ///< Outfit copy disabled or unavailable
+        Ready,    ///< A loaded actor can be copied immediately
+        Spawned   ///< A temporary actor was spawned; wait for its 3D
+    };
+
+    /// Game operations and readiness queries used by the pipeline.
+    class IHost
+    {
+    public:
+        virtual ~IHost() = default;
+
+        /// Whether the player reference, its base and its 3D are available.
+        virtual bool IsPlayerReady() const = 0;
+
+        /**
+         * Copy template record data and FaceGen onto the player.
+         *
+         * @return `false` to abort the pipeline.
+         */
+        virtual bool ApplyRecords() = 0;
+
+        /**
+         * Locate or spawn the actor to copy the outfit from.
+         *
+         * @param[out] spawnRefID FormID of the spawned reference for `Spawned`.
+         */
+        virtual OutfitSource PrepareOutfit(std::uint32_t& spawnRefID) = 0;
+
+        /**
+         * Whether a spawned outfit source can be copied now.
+         *
+         * Should also return `true` if the reference is gone, so the
+         * pipeline moves on instead of waiting forever.
+         */
+        virtual bool IsOutfitSourceReady(std::uint32_t spawnRefID) const = 0;
+
+        /// Copy the outfit and release any spawned source actor.
+        virtual void CopyOutfit() = 0;
+
+        /// Release a spawned source actor without copying, after a timeout.
+        virtual void ReleaseOutfit() = 0;
+
+        /// Identity of the player's current 3D root, null if none.
+        virtual const void* Player3DRoot() const = 0;
+
+        /**
+         * Execute one player refresh step.
+         *
+         * @param stage One of `RefreshColors` through `UpdateNeck`.
+         */
+        virtual void RunRefresh(Stage stage) = 0;
+
+        /// Request a call to `Pipeline::Tick()` on the next game frame.
+        virtual void ScheduleTick() = 0;
+
+        /// Monotonic clock in milliseconds.
+        virtual double NowMs() const = 0;
+    };
+
+    /**
+     * Appearance template state machine.
+     *
+     * `Start()`, `StartRefresh()` and `Tick()` must run on the game thread.
+     * `OnObjectLoaded()` may be called from any thread; it only schedules
+     * a tick.
+     */
+    class Pipeline
+    {
+    public:
+        /**
+         * @param host Game interface.
+         * @param frameBudgetMs Work allowed per tick before yielding a frame.
+         * @param waitBudgetMs Longest a bounded wait may take before failing.
+         */
+        explicit Pipeline(IHost& host, double frameBudgetMs = 2.0, double waitBudgetMs = 10000.0);
+
+        /// Begin (or restart) the full apply sequence.
+        void Start();
+
+        /// Run only the player refresh steps.
+        void StartRefresh();
+
+        /// Abandon any work in progress.
+        void Cancel();
+
+        /**
+         * Notify that a reference's 3D finished loading.
+         *
+         * @param refID FormID of the loaded reference.
+         */
+        void OnObjectLoaded(std::uint32_t refID);
+
+        /// Advance as many stages as readiness and the frame budget allow.
+        void Tick();
+
+        /**
+         * Re-check a bounded wait. Call once per game frame.
+         *
+         * Does nothing unless a bounded stage is waiting.
+         */
+        void Poll();
+
+        /// Current stage.
+        Stage GetStage() const { return m_stage.load(std::memory_order_acquire); }
+
+        /// Whether the pipeline has work in progress.
+        bool IsBusy() const;
+
+    private:
+        bool StepOnce();
+        bool Waited(bool ready);
+        bool PlayerReloaded();
+        void RequestTick();
+        void SetStage(Stage stage) { m_stage.store(stage, std::memory_order_release); }
+
+        IHost& m_host;
+        double m_budgetMs;
+        double m_waitBudgetMs;
+        std::atomic<Stage> m_stage{Stage::Idle};
+        std::atomic<std::uint32_t> m_spawnRefID{0};
+        std::atomic<bool> m_tickPending{false};
+        std::atomic<bool> m_playerLoaded{false};  // Load event for the player since Reset3D
+        std::atomic<double> m_deadlineMs{0.0};    // 0 unless a bounded stage is waiting
+        const void* m_rootBeforeReset = nullptr;
+    };
+}
@@ -1,4 +1,7 @@
 #include "TextEffects.h"
+#include "EffectDecimation.h"
+#include "EffectProgram.h"
+#include "NoiseTables.h"
 #include "ParticleTextures.h"
 #include "Settings.h"
 
@@ -57,6 +60,37 @@ namespace TextEffects
         return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
     }
 
+    // Frame time installed by the pipeline worker, null on the render thread
+    static thread_local const double* s_animationTime = nullptr;
+
+    float AnimationTime()
+    {
+        return s_animationTime ? static_cast<float>(*s_animationTime) : static_cast<float>(ImGui::GetTime());
+    }
+
+    void SetAnimationTime(const double* time)
+    {
+        s_animationTime = time;
+    }
+
+    // Colors of decimated effects. Per thread, so the render thread and the
+    // pipeline worker each keep their own and never share one.
+    static thread_local EffectDecimation::ColorCache s_colorCache;
+    static thread_local std::uint32_t s_effectLabel = 0;
+    static thread_local std::uint32_t s_effectSlot = 0;
+
+    void BeginEffectLabel(std::uint32_t labelKey)
+    {
+        s_effectLabel = labelKey;
+        s_effectSlot = 0;
+    }
+
+    void EndEffectFrame()
+    {
+        s_effectLabel = 0;
+        s_colorCache.EndFrame();
+    }
+
     ImU32 LerpColorU32(ImU32 a, ImU32 b, float t)
     {
         // Linear interpolation between two packed RGBA colors
@@ -241,6 +275,88 @@ namespace TextEffects
         }
     };
 
+    // Extract alpha channel [0-255] from packed color
+    static inline int GetA(ImU32 c) { return (c >> IM_COL32_A_SHIFT) & 0xFF; }
+
+    static float EffectRate(EffectDecimation::EffectClass cls)
+    {
+        switch (cls)
+        {
+        case EffectDecimation::EffectClass::Rainbow: return Settings::EffectRateRainbow;
+        case EffectDecimation::EffectClass::Shimmer: return Settings::EffectRateShimmer;
+        case EffectDecimation::EffectClass::Noise:   return Settings::EffectRateNoise;
+        case EffectDecimation::EffectClass::Sparkle: return Settings::EffectRateSparkle;
+        default:                                     return 0.0f;
+        }
+    }
+
+    // Reuses the colors an animated effect wrote for this label until its
+    // decimation bucket changes. Usage, after TextVertexSetup::Begin():
+    //     DecimatedColors cached(s, cls, alpha);
+    //     if (cached.Restore()) return;
+    //     ... color loop ...
+    //     cached.Store();
+    class DecimatedColors
+    {
+    public:
+        DecimatedColors(const TextVertexSetup &s, EffectDecimation::EffectClass cls, int alpha)
+            : m_setup(s), m_alpha(static_cast<std::uint8_t>(std::clamp(alpha, 0, 255)))
+        {
+            if (s_effectLabel == 0)
+                return;
+
+            // Slots advance even at full rate so keys stay stable when rates change
+            const std::uint32_t slot = s_effectSlot++;
+            const float rate = EffectRate(cls);
+            if (rate <= 0.0f)
+                return;
+
+            m_active = true;
+            m_key = EffectDecimation::MakeKey(s_effectLabel, slot, cls);
+            m_bucket = EffectDecimation::Bucket(AnimationTime(), rate, EffectDecimation::LabelPhase(s_effectLabel));
+            m_shape.count = static_cast<std::uint32_t>(s.vtxEnd - s.vtxStart);
+            m_shape.width = s.width();
+            m_shape.height = s.height();
+        }
+
+        // Copy the cached colors into the new vertices; false if the effect must run
+        bool Restore() const
+        {
+            if (!m_active)
+                return false;
+
+            std::uint8_t cachedAlpha = m_alpha;
+            const std::uint32_t *colors = s_colorCache.Find(m_key, m_bucket, m_shape, cachedAlpha);
+            if (!colors)
+                return false;
+
+            ImDrawVert *vtx = m_setup.list->VtxBuffer.Data + m_setup.vtxStart;
+            for (std::uint32_t i = 0; i < m_shape.count; ++i)
+                vtx[i].col = EffectDecimation::RescaleAlpha(colors[i], cachedAlpha, m_alpha);
+            return true;
+        }
+
+        // Remember the colors just written by the effect
+        void Store() const
+        {
+            if (!m_active)
+                return;
+
+            std::uint32_t *colors = s_colorCache.Store(m_key, m_bucket, m_shape, m_alpha);
+            const ImDrawVert *vtx = m_setup.list->VtxBuffer.Data + m_setup.vtxStart;
+            for (std::uint32_t i = 0; i < m_shape.count; ++i)
+                colors[i] = vtx[i].col;
+        }
+
+    private:
+        const TextVertexSetup &m_setup;
+        std::uint8_t m_alpha;
+        bool m_active{false};
+        std::uint64_t m_key{0};
+        std::int64_t m_bucket{0};
+        EffectDecimation::Shape m_shape;
+    };
+
     // Calculate AABB of vertex buffer range [vtxStart, vtxEnd)
     static inline void GetVtxBounds(ImDrawList *list, int vtxStart, int vtxEnd, ImVec2 &outMin, ImVec2 &outMax)
     {
@@ -262,6 +378,9 @@ namespace TextEffects
     // Get fractional part of float
     static inline float Frac(float x) { return x - std::floor(x); }
 
+    // Integer cell of a grid coordinate
+    static inline std::int32_t Cell(float x) { return static_cast<std::int32_t>(std::floor(x)); }
+
     static inline ImVec4 HSVtoRGB(float h, float s, float v, float a)
     {
         // Convert HSV (Hue, Saturation, Value) to RGB
@@ -327,7 +446,11 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
-        const float time = (float)ImGui::GetTime();
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Rainbow, (int)(alpha * 255.0f + 0.5f));
+        if (cached.Restore())
+            return;
+
+        const float time = AnimationTime();
 
         for (int i = s.vtxStart; i < s.vtxEnd; ++i)
         {
@@ -355,6 +478,8 @@ namespace TextEffects
             const ImVec4 rgb = HSVtoRGB(hue, satVar, finalValue, alpha);
             list->VtxBuffer[i].col = ImGui::ColorConvertFloat4ToU32(rgb);
         }
+
+        cached.Store();
     }
 
     void AddTextShimmer(ImDrawList *list, ImFont *font, float size,
@@ -366,6 +491,10 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Shimmer, GetA(baseL));
+        if (cached.Restore())
+            return;
+
         const float bandHalf = (std::max)(bandWidth01 * 0.5f, 0.01f);
 
         for (int i = s.vtxStart; i < s.vtxEnd; ++i)
@@ -397,6 +526,8 @@ namespace TextEffects
 
             list->VtxBuffer[i].col = LerpColorU32(base, highlight, h);
         }
+
+        cached.Store();
     }
 
     void AddTextOutline4Shimmer(ImDrawList *list, ImFont *font, float size,
@@ -450,9 +581,6 @@ namespace TextEffects
         AddTextRadialGradient(list, font, size, pos, text, colCenter, colEdge, gamma);
     }
 
-    // Extract alpha channel [0-255] from packed color
-    static inline int GetA(ImU32 c) { return (c >> IM_COL32_A_SHIFT) & 0xFF; }
-
     // Create new color with scaled alpha (preserves RGB)
     static inline ImU32 WithAlpha(ImU32 c, float mul)
     {
@@ -478,6 +606,10 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Shimmer, GetA(baseL));
+        if (cached.Restore())
+            return;
+
         const float sigma = (std::max)(bandWidth01, 1e-3f);
         const float inv2s2 = 1.0f / (2.0f * sigma * sigma);
 
@@ -491,6 +623,8 @@ namespace TextEffects
 
             list->VtxBuffer[i].col = LerpColorU32(base, highlight, h);
         }
+
+        cached.Store();
     }
 
     void AddTextSolidShimmer(ImDrawList *list, ImFont *font, float size,
@@ -502,6 +636,10 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Shimmer, GetA(base));
+        if (cached.Restore())
+            return;
+
         const float sigma = (std::max)(bandWidth01, 1e-3f);
         const float inv2s2 = 1.0f / (2.0f * sigma * sigma);
 
@@ -512,6 +650,8 @@ namespace TextEffects
             float h = Saturate(std::exp(-(d * d) * inv2s2) * strength01);
             list->VtxBuffer[i].col = LerpColorU32(base, highlight, h);
         }
+
+        cached.Store();
     }
 
     void AddTextOutline4ChromaticShimmer(ImDrawList *list, ImFont *font, float size,
@@ -643,6 +783,10 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Shimmer, GetA(a));
+        if (cached.Restore())
+            return;
+
         const float pulse = 1.0f + amp * std::sin(time * TWO_PI * freqHz);
 
         for (int i = s.vtxStart; i < s.vtxEnd; ++i)
@@ -651,6 +795,8 @@ namespace TextEffects
             ImU32 base = LerpColorU32(a, b, t);
             list->VtxBuffer[i].col = ScaleRGB(base, pulse);
         }
+
+        cached.Store();
     }
 
     void TextEffects::AddTextOutline4PulseGradient(ImDrawList *list, ImFont *font, float size,
@@ -668,8 +814,12 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Rainbow, (int)(alpha * 255.0f + 0.5f));
+        if (cached.Restore())
+            return;
+
         const ImVec2 c = s.center();
-        const float time = (float)ImGui::GetTime();
+        const float time = AnimationTime();
 
         for (int i = s.vtxStart; i < s.vtxEnd; ++i)
         {
@@ -680,6 +830,8 @@ namespace TextEffects
             const float hue = baseHue + u + time * speed * 0.3f;
             list->VtxBuffer[i].col = ImGui::ColorConvertFloat4ToU32(HSVtoRGB(hue, saturation, value, alpha));
         }
+
+        cached.Store();
     }
 
     void TextEffects::AddTextOutline4RainbowWave(ImDrawList *list, ImFont *font, float size,
@@ -732,63 +884,6 @@ namespace TextEffects
         }
     }
 
-    // Integer hash for pseudo-random noise [0, 1)
-    static inline float Hash(float x, float y)
-    {
-        size_t hash = static_cast<size_t>(static_cast<int>(x));
-        hash ^= hash >> 16;
-        hash *= 0x85ebca6b;
-        hash ^= hash >> 13;
-        hash *= 0xc2b2ae35;
-        hash ^= hash >> 16;
-        hash ^= static_cast<size_t>(static_cast<int>(y)) * 2654435761;
-        return static_cast<float>(hash & 0xFFFFFF) / 16777216.0f; // [0, 1)
-    }
-
-    // 2D value noise with quintic interpolation
-    static inline float ValueNoise(float x, float y)
-    {
-        // Get integer and fractional parts
-        float ix = std::floor(x);
-        float iy = std::floor(y);
-        float fx = x - ix;
-        float fy = y - iy;
-
-        // Quintic interpolation curve for smoother results
-        fx = fx * fx * fx * (fx * (fx * 6.0f - 15.0f) + 10.0f);
-        fy = fy * fy * fy * (fy * (fy * 6.0f - 15.0f) + 10.0f);
-
-        // Sample four corners and interpolate
-        float a = Hash(ix, iy);
-        float b = Hash(ix + 1.0f, iy);
-        float c = Hash(ix, iy + 1.0f);
-        float d = Hash(ix + 1.0f, iy + 1.0f);
-
-        // Bilinear interpolation
-        float ab = a + (b - a) * fx;
-        float cd = c + (d - c) * fx;
-        return ab + (cd - ab) * fy;
-    }
-
-    // Fractal Brownian Motion
-    static inline float FBMNoise(float x, float y, int octaves, float persistence = 0.5f)
-    {
-        float total = 0.0f;
-        float amplitude = 1.0f;
-        float frequency = 1.0f;
-        float maxValue = 0.0f;
-
-        for (int i = 0; i < octaves; i++)
-        {
-            total += ValueNoise(x * frequency, y * frequency) * amplitude;
-            maxValue += amplitude;
-            amplitude *= persistence;
-            frequency *= 2.0f;
-        }
-
-        return total / maxValue;
-    }
-
     void TextEffects::AddTextAurora(ImDrawList *list, ImFont *font, float size,
                                     const ImVec2 &pos, const char *text,
                                     ImU32 colA, ImU32 colB,
@@ -798,7 +893,12 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
-        const float time = (float)ImGui::GetTime() * speed;
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Noise, GetA(colA));
+        if (cached.Restore())
+            return;
+
+        const float time = AnimationTime() * speed;
+        const auto &tables = NoiseTables::Active();
 
         // Create intermediate colors for richer aurora palette
         ImU32 colMid = LerpColorU32(colA, colB, 0.5f);
@@ -812,12 +912,12 @@ namespace TextEffects
             const float ny = s.normalizedY(p.y);
 
             // Multiple flowing wave layers for organic aurora movement
-            float wave1 = std::sin(nx * waves * TWO_PI + time * 1.2f + ny * 2.0f);
-            float wave2 = std::sin(nx * waves * 0.7f * TWO_PI - time * 0.8f + ny * 1.5f) * 0.6f;
-            float wave3 = std::sin(nx * waves * 1.3f * TWO_PI + time * 0.5f - ny * 1.0f) * 0.4f;
+            float wave1 = tables.Sin(nx * waves * TWO_PI + time * 1.2f + ny * 2.0f);
+            float wave2 = tables.Sin(nx * waves * 0.7f * TWO_PI - time * 0.8f + ny * 1.5f) * 0.6f;
+            float wave3 = tables.Sin(nx * waves * 1.3f * TWO_PI + time * 0.5f - ny * 1.0f) * 0.4f;
 
             // Vertical curtain effect
-            float curtain = std::sin(ny * TWO_PI * 2.0f + time * 0.7f + nx * sway * 3.0f);
+            float curtain = tables.Sin(ny * TWO_PI * 2.0f + time * 0.7f + nx * sway * 3.0f);
             curtain = curtain * 0.5f + 0.5f;  // Normalize to [0, 1]
 
             // Combine waves
@@ -825,13 +925,13 @@ namespace TextEffects
             combined = combined * 0.5f + 0.5f;                // Normalize to [0, 1]
 
             // Add subtle shimmer
-            float shimmer = std::sin(time * 4.0f + nx * 12.0f + ny * 8.0f) * 0.5f + 0.5f;
+            float shimmer = tables.Sin(time * 4.0f + nx * 12.0f + ny * 8.0f) * 0.5f + 0.5f;
             shimmer = shimmer * shimmer * 0.15f; // Subtle sparkle
 
             // Horizontal sway effect
-            float swayOffset = std::sin(ny * 3.0f + time * 1.5f) * sway;
+            float swayOffset = tables.Sin(ny * 3.0f + time * 1.5f) * sway;
             float swayedX = nx + swayOffset;
-            float swayFactor = std::sin(swayedX * TWO_PI * waves + time) * 0.5f + 0.5f;
+            float swayFactor = tables.Sin(swayedX * TWO_PI * waves + time) * 0.5f + 0.5f;
 
             // Blend all factors
             float t = Saturate((combined * 0.6f + curtain * 0.25f + swayFactor * 0.15f) * intensity + shimmer);
@@ -853,6 +953,8 @@ namespace TextEffects
 
             list->VtxBuffer[i].col = finalColor;
         }
+
+        cached.Store();
     }
 
     void TextEffects::AddTextOutline4Aurora(ImDrawList *list, ImFont *font, float size,
@@ -874,7 +976,12 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
-        const float time = (float)ImGui::GetTime();
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Sparkle, GetA(baseL));
+        if (cached.Restore())
+            return;
+
+        const float time = AnimationTime();
+        const auto &tables = NoiseTables::Active();
 
         // Create color variations for richer sparkle
         ImU32 sparkleWhite = IM_COL32(255, 255, 255, 255);
@@ -891,12 +998,12 @@ namespace TextEffects
             float colorShift = 0.0f;  // For varying sparkle color
 
             // Layer 1: Large slow-twinkling stars
-            float seed1 = Hash(std::floor(p.x * 0.06f), std::floor(p.y * 0.06f));
+            float seed1 = tables.SparkleSeed(0, Cell(p.x * 0.06f), Cell(p.y * 0.06f));
             if (seed1 > (1.0f - density * 0.4f))
             {
                 float phase1 = seed1 * TWO_PI;
                 float sparkleTime1 = time * speed * (0.6f + seed1 * 0.4f);
-                float sparkle1 = std::sin(sparkleTime1 + phase1);
+                float sparkle1 = tables.Sin(sparkleTime1 + phase1);
                 sparkle1 = std::max(0.0f, sparkle1);
                 sparkle1 = std::pow(sparkle1, 3.0f);
 
@@ -911,34 +1018,34 @@ namespace TextEffects
             }
 
             // Layer 2: Medium fast-twinkling sparkles
-            float seed2 = Hash(std::floor(p.x * 0.12f) + 50.0f, std::floor(p.y * 0.12f) + 50.0f);
+            float seed2 = tables.SparkleSeed(1, Cell(p.x * 0.12f), Cell(p.y * 0.12f));
             if (seed2 > (1.0f - density * 0.7f))
             {
                 float phase2 = seed2 * TWO_PI;
                 float sparkleTime2 = time * speed * 1.8f * (0.8f + seed2 * 0.4f);
-                float sparkle2 = std::sin(sparkleTime2 + phase2);
+                float sparkle2 = tables.Sin(sparkleTime2 + phase2);
                 sparkle2 = std::max(0.0f, sparkle2);
                 sparkle2 = std::pow(sparkle2, 5.0f);
                 totalSparkle += sparkle2 * 0.6f;
             }
 
             // Layer 3: Fine shimmer dust
-            float seed3 = Hash(std::floor(p.x * 0.2f) + 100.0f, std::floor(p.y * 0.2f) + 100.0f);
+            float seed3 = tables.SparkleSeed(2, Cell(p.x * 0.2f), Cell(p.y * 0.2f));
             if (seed3 > (1.0f - density * 0.9f))
             {
                 float phase3 = seed3 * TWO_PI;
-                float sparkle3 = std::sin(time * speed * 2.5f + phase3);
+                float sparkle3 = tables.Sin(time * speed * 2.5f + phase3);
                 sparkle3 = std::max(0.0f, sparkle3);
                 sparkle3 = std::pow(sparkle3, 8.0f);
                 totalSparkle += sparkle3 * 0.35f;
             }
 
             // Layer 4: Rare brilliant flares
-            float seed4 = Hash(std::floor(p.x * 0.04f) + 200.0f, std::floor(p.y * 0.04f) + 200.0f);
+            float seed4 = tables.SparkleSeed(3, Cell(p.x * 0.04f), Cell(p.y * 0.04f));
             if (seed4 > 0.93f)
             {
                 float phase4 = seed4 * TWO_PI;
-                float flare = std::sin(time * speed * 0.4f + phase4);
+                float flare = tables.Sin(time * speed * 0.4f + phase4);
                 flare = std::max(0.0f, flare);
                 flare = std::pow(flare, 2.0f);
                 totalSparkle += flare * 1.5f;
@@ -952,6 +1059,8 @@ namespace TextEffects
             ImU32 finalSparkle = LerpColorU32(sparkleColor, sparkleTint, colorShift);
             list->VtxBuffer[i].col = LerpColorU32(base, finalSparkle, totalSparkle);
         }
+
+        cached.Store();
     }
 
     void TextEffects::AddTextOutline4Sparkle(ImDrawList *list, ImFont *font, float size,
@@ -973,9 +1082,20 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
-        const float time = (float)ImGui::GetTime() * speed;
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Noise, GetA(colA));
+        if (cached.Restore())
+            return;
+
+        const float time = AnimationTime() * speed;
+        const auto &tables = NoiseTables::Active();
         ImU32 colMid = LerpColorU32(colA, colB, 0.5f);
 
+        // Radial wave centers drift with time only
+        const float center1x = 0.3f + std::sin(time * 0.3f) * 0.2f;
+        const float center1y = 0.5f + std::cos(time * 0.4f) * 0.15f;
+        const float center2x = 0.7f - std::cos(time * 0.35f) * 0.15f;
+        const float center2y = 0.5f - std::sin(time * 0.45f) * 0.2f;
+
         for (int i = s.vtxStart; i < s.vtxEnd; ++i)
         {
             const ImVec2 p = list->VtxBuffer[i].pos;
@@ -986,23 +1106,23 @@ namespace TextEffects
             float plasma = 0.0f;
 
             // Primary waves with varied phases
-            plasma += std::sin(nx * freq1 * TWO_PI + time);
-            plasma += std::sin(ny * freq2 * TWO_PI + time * 0.7f);
+            plasma += tables.Sin(nx * freq1 * TWO_PI + time);
+            plasma += tables.Sin(ny * freq2 * TWO_PI + time * 0.7f);
 
             // Diagonal waves
-            plasma += std::sin((nx + ny) * (freq1 + freq2) * 0.5f * TWO_PI + time * 1.3f);
-            plasma += std::sin((nx - ny) * freq1 * TWO_PI + time * 0.9f) * 0.5f;
+            plasma += tables.Sin((nx + ny) * (freq1 + freq2) * 0.5f * TWO_PI + time * 1.3f);
+            plasma += tables.Sin((nx - ny) * freq1 * TWO_PI + time * 0.9f) * 0.5f;
 
             // Radial waves from offset centers for more organic look
-            float cx1 = nx - 0.3f - std::sin(time * 0.3f) * 0.2f;
-            float cy1 = ny - 0.5f - std::cos(time * 0.4f) * 0.15f;
+            float cx1 = nx - center1x;
+            float cy1 = ny - center1y;
             float dist1 = std::sqrt(cx1 * cx1 + cy1 * cy1);
-            plasma += std::sin(dist1 * freq1 * TWO_PI * 2.0f - time * 1.2f);
+            plasma += tables.Sin(dist1 * freq1 * TWO_PI * 2.0f - time * 1.2f);
 
-            float cx2 = nx - 0.7f + std::cos(time * 0.35f) * 0.15f;
-            float cy2 = ny - 0.5f + std::sin(time * 0.45f) * 0.2f;
+            float cx2 = nx - center2x;
+            float cy2 = ny - center2y;
             float dist2 = std::sqrt(cx2 * cx2 + cy2 * cy2);
-            plasma += std::sin(dist2 * freq2 * TWO_PI * 1.5f + time * 0.8f) * 0.7f;
+            plasma += tables.Sin(dist2 * freq2 * TWO_PI * 1.5f + time * 0.8f) * 0.7f;
 
             // Normalize to [0, 1] with smoother transition
             plasma = (plasma + 5.2f) / 10.4f;
@@ -1021,6 +1141,8 @@ namespace TextEffects
 
             list->VtxBuffer[i].col = finalColor;
         }
+
+        cached.Store();
     }
 
     void TextEffects::AddTextOutline4Plasma(ImDrawList *list, ImFont *font, float size,
@@ -1042,7 +1164,11 @@ namespace TextEffects
         if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
             return;
 
-        const float time = (float)ImGui::GetTime();
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Shimmer, GetA(baseL));
+        if (cached.Restore())
+            return;
+
+        const float time = AnimationTime();
         float phase1 = std::sin(time * speed * PI) * 0.5f + 0.5f;
         float phase2 = std::sin(time * speed * PI + 2.0f) * 0.5f + 0.5f;
 
@@ -1087,6 +1213,8 @@ namespace TextEffects
 
             list->VtxBuffer[i].col = LerpColorU32(base, scanColor, totalScan);
         }
+
+        cached.Store();
     }
 
     void TextEffects::AddTextOutline4Scanline(ImDrawList *list, ImFont *font, float size,
@@ -1099,6 +1227,80 @@ namespace TextEffects
         AddTextScanline(list, font, size, pos, text, baseL, baseR, scanColor, speed, width, intensity);
     }
 
+    // Unpack an ImU32 color to RGB floats [0, 1]
+    static inline void UnpackRGB(ImU32 c, float out[3])
+    {
+        out[0] = static_cast<float>((c >> IM_COL32_R_SHIFT) & 0xFF) / 255.0f;
+        out[1] = static_cast<float>((c >> IM_COL32_G_SHIFT) & 0xFF) / 255.0f;
+        out[2] = static_cast<float>((c >> IM_COL32_B_SHIFT) & 0xFF) / 255.0f;
+    }
+
+    void TextEffects::AddTextProgram(ImDrawList *list, ImFont *font, float size,
+                                     const ImVec2 &pos, const char *text,
+                                     const EffectProgram::Program &program,
+                                     ImU32 colL, ImU32 colR, ImU32 highlight,
+                                     float phase, float tier, const float params[5])
+    {
+        if (!program.Valid())
+        {
+            AddTextHorizontalGradient(list, font, size, pos, text, colL, colR);
+            return;
+        }
+
+        TextVertexSetup s;
+        if (!TextVertexSetup::Begin(s, list, font, size, pos, text))
+            return;
+
+        const int alpha = GetA(colL);
+        DecimatedColors cached(s, EffectDecimation::EffectClass::Noise, alpha);
+        if (cached.Restore())
+            return;
+
+        EffectProgram::Uniforms in;
+        in.time = AnimationTime();
+        in.phase = phase;
+        in.tier = tier;
+        std::copy(params, params + 5, in.params);
+        UnpackRGB(colL, in.left);
+        UnpackRGB(colR, in.right);
+        UnpackRGB(highlight, in.highlight);
+
+        // Positions to structure-of-arrays, so the program runs over whole batches.
+        // Per thread and reused, the buffers stop growing after the first labels.
+        static thread_local std::vector<float> u, v;
+        static thread_local std::vector<ImU32> colors;
+        const int count = s.vtxEnd - s.vtxStart;
+        u.resize(count);
+        v.resize(count);
+        colors.resize(count);
+
+        ImDrawVert *vtx = list->VtxBuffer.Data + s.vtxStart;
+        for (int i = 0; i < count; ++i)
+        {
+            u[i] = s.normalizedX(vtx[i].pos.x);
+            v[i] = s.normalizedY(vtx[i].pos.y);
+        }
+
+        EffectProgram::Run(program, in, u.data(), v.data(), static_cast<std::size_t>(count), colors.data(),
+                           static_cast<std::uint8_t>(std::clamp(alpha, 0, 255)));
+
+        for (int i = 0; i < count; ++i)
+            vtx[i].col = colors[i];
+
+        cached.Store();
+    }
+
+    void TextEffects::AddTextOutline4Program(ImDrawList *list, ImFont *font, float size,
+                                             const ImVec2 &pos, const char *text,
+                                             const EffectProgram::Program &program,
+                                             ImU32 colL, ImU32 colR, ImU32 highlight, ImU32 outline, float w,
+                                             float phase, float tier, const float params[5])
+    {
+        DrawOutlineInternal(list, font, size, pos, text, outline, w);
+
+        AddTextProgram(list, font, size, pos, text, program, colL, colR, highlight, phase, tier, params);
+    }
+
     void TextEffects::AddTextGlow(ImDrawList *list, ImFont *font, float size,
                                   const ImVec2 &pos, const char *text, ImU32 glowColor,
                                   float radius, float intensity, int samples)
@@ -74,6 +74,46 @@ namespace TextEffects
      */
     ImU32 LerpColorU32(ImU32 a, ImU32 b, float t);
 
+    /**
+     * Animation clock shared by all time-driven effects.
+     *
+     * Returns `ImGui::GetTime()` unless the calling thread installed a frame
+     * time with SetAnimationTime(). A frame built on the pipeline worker uses
+     * the time captured on the render thread for that frame.
+     *
+     * @return Time in seconds.
+     *
+     * @see FramePipeline::FrameInput
+     */
+    float AnimationTime();
+
+    /**
+     * Install the animation clock for the calling thread.
+     *
+     * @param time Captured frame time, or `nullptr` to use `ImGui::GetTime()`.
+     *            Must outlive the effects drawn with it.
+     */
+    void SetAnimationTime(const double* time);
+
+    /**
+     * Start the animated effects of one label.
+     *
+     * Animated color passes drawn until the next call are evaluated at the
+     * per-class rates in Settings and reused in between, staggered by
+     * `labelKey`. Key 0 evaluates every frame.
+     *
+     * @param labelKey Stable per-label key, e.g. the actor's form ID.
+     *
+     * @see EffectDecimation
+     */
+    void BeginEffectLabel(std::uint32_t labelKey);
+
+    /**
+     * End the labels of a frame and drop cached colors of labels that were
+     * not drawn. Call once per frame on the thread that built the labels.
+     */
+    void EndEffectFrame();
+
     // ========== Basic Effects ==========
 
     /**
@@ -812,6 +852,67 @@ namespace TextEffects
         ImU32 baseL, ImU32 baseR, ImU32 scanColor, ImU32 outline, float w,
         float speed, float width, float intensity);
 
+    /**
+     * Draw text colored by a compiled `[CustomEffects]` program.
+     *
+     * Vertex positions are normalized to the text bounds and gathered into
+     * batches of EffectProgram::kBatch, so the program runs once per batch
+     * instead of once per vertex. `t` is the animation time and the tier
+     * colors are passed as `left`, `right` and `highlight`.
+     *
+     * @paramlist ImGui draw list to render to.
+     * @paramfont Font to use for rendering.
+     * @paramsize Font size in pixels.
+     * @parampos Top-left position for text.
+     * @paramtext Null-terminated UTF-8 string to render.
+     * @paramprogram Compiled effect program.
+     * @paramcolL Left tier color, its alpha is the text alpha.
+     * @paramcolR Right tier color.
+     * @paramhighlight Highlight tier color.
+     * @paramphase Per-label animation phase [0, 1).
+     * @paramtier Tier position [0, 1].
+     * @paramparams The five effect parameters (`p1`-`p5`).
+     *
+     * @pre list != nullptr
+     * @pre font != nullptr
+     * @pre text != nullptr
+     *
+     * @see AddTextOutline4Program, EffectProgram
+     */
+    void AddTextProgram(ImDrawList* list, ImFont* font, float size,
+        const ImVec2& pos, const char* text,
+        const EffectProgram::Program& program,
+        ImU32 colL, ImU32 colR, ImU32 highlight,
+        float phase, float tier, const float params[5]);
+
+    /**
+     * Draw text with a custom effect program and outline.
+     *
+     * @paramlist ImGui draw list to render to.
+     * @paramfont Font to use for rendering.
+     * @paramsize Font size in pixels.
+     * @parampos Top-left position for text.
+     * @paramtext Null-terminated UTF-8 string to render.
+     * @paramprogram Compiled effect program.
+     * @paramcolL Left tier color, its alpha is the text alpha.
+     * @paramcolR Right tier color.
+     * @paramhighlight Highlight tier color.
+     * @paramoutline Outline color.
+     * @paramw Outline width in pixels.
+     * @paramphase Per-label animation phase [0, 1).
+     * @paramtier Tier position [0, 1].
+     * @paramparams The five effect parameters (`p1`-`p5`).
+     *
+     * @pre list != nullptr
+     * @pre font != nullptr
+     * @pre text != nullptr
+     */
+    void AddTextOutline4Program(ImDrawList* list, ImFont* font, float size,
+        const ImVec2& pos, const char* text,
+        const EffectProgram::Program& program,
+        ImU32 colL, ImU32 colR, ImU32 highlight, ImU32 outline, float w,
+        float phase, float tier, const float params[5]);
+
     // ========== Glow Effect ==========
 
     /**
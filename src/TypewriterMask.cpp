@@ -0,0 +1,63 @@
+#include "TypewriterMask.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TypewriterMask
+{
+    float Progress(float elapsed, float delay, float speed)
+    {
+        const float t = elapsed - delay;
+        return t > 0.0f ? t * speed : 0.0f;
+    }
+
+    int TruncatedCount(float progress)
+    {
+        return progress > 0.0f ? static_cast<int>(progress) : 0;
+    }
+
+    float CharAlpha(float progress, int index, float softness)
+    {
+        // Opaque once the truncating reveal would show it (progress >= index + 1)
+        const float full = static_cast<float>(index + 1);
+        if (softness <= 0.0f)
+            return progress >= full ? 1.0f : 0.0f;
+        return std::clamp((progress - (full - softness)) / softness, 0.0f, 1.0f);
+    }
+
+    void GlyphMap::Clear()
+    {
+        m_cells.clear();
+        m_visible.clear();
+        m_uv.clear();
+        m_width = 0.0f;
+    }
+
+    void GlyphMap::AddChar(float advance, bool visible, float u0, float v0)
+    {
+        if (visible)
+        {
+            m_visible.push_back(static_cast<std::uint32_t>(m_cells.size()));
+            m_uv.push_back(u0);
+            m_uv.push_back(v0);
+        }
+        m_cells.push_back(m_width);
+        m_width += advance;
+    }
+
+    int GlyphMap::CharForQuad(std::size_t quad) const
+    {
+        return static_cast<int>(m_visible[quad % m_visible.size()]);
+    }
+
+    int GlyphMap::CharAtX(float x) const
+    {
+        if (m_cells.empty())
+            return 0;
+        // Last cell whose left edge is at or before x
+        auto it = std::upper_bound(m_cells.begin(), m_cells.end(), x);
+        if (it == m_cells.begin())
+            return 0;
+        return static_cast<int>(it - m_cells.begin()) - 1;
+    }
+}
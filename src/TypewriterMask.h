@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace TypewriterMask
+ * @brief Typewriter reveal as a per-glyph alpha mask over fully built text.
+ * @author Alex (https://github.com/lextpf)
+ * @ingroup Rendering
+ *
+ * The reveal used to truncate every segment to the visible characters each
+ * frame, re-measure the partial strings and re-emit all passes for text whose
+ * length kept changing. Now the whole label is built once per frame at its
+ * final layout and the reveal only scales vertex alpha per glyph, so layout,
+ * centering and vertex counts stay fixed for the whole animation.
+ *
+ * ## :material-format-text-variant: Reveal
+ *
+ * Progress counts revealed characters as a real number. Character $k$ (0 based,
+ * across all segments, then the title) has alpha
+ *
+ * $$\alpha_k = \mathrm{saturate}\left(\frac{p - (k + 1 - s)}{s}\right)$$
+ *
+ * where $p$ is the progress and $s$ the edge softness in characters. A
+ * character is fully opaque exactly when the truncating reveal would have
+ * shown it; with $s > 0$ it fades in over the preceding $s$ characters of
+ * progress instead of popping. $s = 0$ is the hard edge.
+ *
+ * ## :material-vector-square: Glyph Ranges
+ *
+ * Every text pass (glow, shadow, outline, effect) emits one quad per visible
+ * glyph in text order, so quad $q$ of a piece belongs to visible glyph
+ * $q \bmod n$. If clipping at a screen edge dropped quads the count no longer
+ * divides. Each pass is then matched by atlas UVs against the leading or
+ * trailing glyphs it kept, and any quad that still cannot be placed is
+ * assigned by its center against the glyph advance cells.
+ *
+ * @see Renderer::Draw, Settings::TypewriterSoftness
+ */
+namespace TypewriterMask
+{
+    /// Revealed characters after `elapsed` seconds, 0 during the delay.
+    float Progress(float elapsed, float delay, float speed);
+
+    /// Characters the truncating reveal showed at `progress`.
+    int TruncatedCount(float progress);
+
+    /// Alpha of character `index` at `progress`, see the formula above.
+    float CharAlpha(float progress, int index, float softness);
+
+    /**
+     * Glyph layout of one piece of text: advance cells of every character
+     * and the characters that emit a quad.
+     */
+    class GlyphMap
+    {
+    public:
+        void Clear();
+
+        /// Append the next character of the text; `u0`, `v0` is its glyph's atlas corner.
+        void AddChar(float advance, bool visible, float u0 = 0.0f, float v0 = 0.0f);
+
+        std::size_t CharCount() const { return m_cells.size(); }
+        std::size_t VisibleCount() const { return m_visible.size(); }
+        float Width() const { return m_width; }
+
+        /// Character of quad `quad` when every pass emitted every visible glyph.
+        int CharForQuad(std::size_t quad) const;
+
+        /// Character whose advance cell contains `x` (relative to the text origin).
+        int CharAtX(float x) const;
+
+        /// Atlas corner of visible glyph `i`.
+        bool SameGlyph(std::size_t i, float u0, float v0) const
+        {
+            return m_uv[i * 2] == u0 && m_uv[i * 2 + 1] == v0;
+        }
+
+    private:
+        std::vector<float> m_cells;            // left edge of each character
+        std::vector<std::uint32_t> m_visible;  // characters that emit a quad
+        std::vector<float> m_uv;               // atlas corner per visible glyph
+        float m_width{0.0f};
+    };
+
+    namespace detail
+    {
+        template <class Vtx>
+        void Fade(Vtx* v, float a)
+        {
+            if (a >= 1.0f)
+                return;
+            for (int i = 0; i < 4; ++i)
+            {
+                const std::uint32_t alpha = static_cast<std::uint32_t>(static_cast<float>(v[i].col >> 24) * a + 0.5f);
+                v[i].col = (v[i].col & 0x00FFFFFFu) | (alpha << 24);
+            }
+        }
+
+        // True if quads [0, m) show visible glyphs [first, first + m)
+        template <class Vtx>
+        bool RunMatches(const Vtx* v, std::size_t m, const GlyphMap& map, std::size_t first)
+        {
+            for (std::size_t q = 0; q < m; ++q)
+            {
+                if (!map.SameGlyph(first + q, v[q * 4].uv.x, v[q * 4].uv.y))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    /**
+     * Scale the alpha of glyph quads in `[vtx, vtx + count)`.
+     *
+     * @param originX   Text origin of the piece in pixels.
+     * @param firstChar Index of the piece's first character in the label.
+     *
+     * `Vtx` needs `pos.x`, `uv` and a packed `col` with alpha in the top
+     * byte (`ImDrawVert`).
+     */
+    template <class Vtx>
+    void Apply(Vtx* vtx, std::size_t count, float originX, const GlyphMap& map,
+               int firstChar, float progress, float softness)
+    {
+        const std::size_t quads = count / 4;
+        const std::size_t n = map.VisibleCount();
+        if (quads == 0 || n == 0)
+            return;
+
+        // Common case: every pass emitted every glyph
+        bool whole = (count % 4 == 0) && (quads % n == 0);
+        for (std::size_t q = 0; whole && q < quads; q += n)
+            whole = detail::RunMatches(vtx + q * 4, n, map, 0);
+        if (whole)
+        {
+            for (std::size_t q = 0; q < quads; ++q)
+                detail::Fade(vtx + q * 4, CharAlpha(progress, firstChar + map.CharForQuad(q), softness));
+            return;
+        }
+
+        // Clipped: split into passes (x restarts to the left) and place each
+        std::size_t run = 0;
+        while (run < quads)
+        {
+            std::size_t end = run + 1;
+            while (end < quads && vtx[end * 4].pos.x > vtx[(end - 1) * 4].pos.x)
+                ++end;
+
+            Vtx* v = vtx + run * 4;
+            const std::size_t m = end - run;
+            std::size_t first = n;
+            if (m <= n && detail::RunMatches(v, m, map, 0))
+                first = 0;          // trailing glyphs clipped
+            else if (m <= n && detail::RunMatches(v, m, map, n - m))
+                first = n - m;      // leading glyphs clipped
+
+            for (std::size_t q = 0; q < m; ++q)
+            {
+                int ch;
+                if (first < n)
+                {
+                    ch = map.CharForQuad(first + q);
+                }
+                else
+                {
+                    const Vtx* g = v + q * 4;
+                    const float cx = (g[0].pos.x + g[1].pos.x + g[2].pos.x + g[3].pos.x) * 0.25f;
+                    ch = map.CharAtX(cx - originX);
+                }
+                detail::Fade(v + q * 4, CharAlpha(progress, firstChar + ch, softness));
+            }
+            run = end;
+        }
+    }
+}
@@ -27,11 +27,12 @@
  */
 #include "PCH.h"
 
-#include <atomic>
 #include <string>
 
 #include "AppearanceTemplate.h"
 #include "Hooks.h"
+#include "NoiseTables.h"
+#include "Occlusion.h"
 #include "Renderer.h"
 #include "Settings.h"
 
@@ -102,45 +103,6 @@ namespace ConsoleCommands
     }
 }
 
-// Flag to indicate we're waiting to apply appearance template
-static std::atomic<bool> s_pendingAppearanceApply{false};
-static std::atomic<int> s_checkCount{0};
-
-void CheckPendingAppearanceTemplate()
-{
-    // Log once to confirm function is being called
-    static bool loggedOnce = false;
-    if (!loggedOnce) {
-        logger::info("CheckPendingAppearanceTemplate called for first time");
-        loggedOnce = true;
-    }
-
-    if (!s_pendingAppearanceApply.load()) {
-        return;
-    }
-
-    // Log every 60 frames to avoid spam
-    int count = s_checkCount.fetch_add(1);
-    bool shouldLog = (count % 60 == 0);
-
-    auto player = RE::PlayerCharacter::GetSingleton();
-    auto playerBase = player ? player->GetActorBase() : nullptr;
-    bool is3DLoaded = player ? player->Is3DLoaded() : false;
-
-    if (shouldLog) {
-        logger::debug("Appearance check #{}: player={}, base={}, 3D={}",
-            count, player != nullptr, playerBase != nullptr, is3DLoaded);
-    }
-
-    // Check if player is fully initialized and in game world
-    if (player && playerBase && is3DLoaded) {
-        logger::info("Player ready after {} checks, applying appearance template", count);
-        s_pendingAppearanceApply.store(false);
-        s_checkCount.store(0);
-        AppearanceTemplate::ApplyIfConfigured();
-    }
-}
-
 void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 {
     switch (a_msg->type) {
@@ -156,6 +118,10 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
         case SKSE::MessagingInterface::kDataLoaded:
             logger::debug("Data loaded event received");
             ConsoleCommands::Register();
+            AppearanceTemplate::RegisterEventSinks();
+            Renderer::RegisterEventSinks();
+            Occlusion::RegisterEventSinks();
+            AppearanceTemplate::StartFaceGenIndex();
             // Retry getting NiOverride interface, SKEE should be fully loaded by now
             AppearanceTemplate::RetryNiOverrideInterface();
             break;
@@ -163,9 +129,9 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
         case SKSE::MessagingInterface::kPostLoadGame:
             // Loading a save, player should be available soon
             logger::debug("Post load game event received");
-            if (Settings::UseTemplateAppearance) {
-                s_pendingAppearanceApply.store(true);
-            }
+            AppearanceTemplate::ResetActorIndex();
+            // Pipeline waits for the player's 3D before applying
+            AppearanceTemplate::ApplyIfConfigured();
             // Test overlay interface after game load
             AppearanceTemplate::TestOverlayOnPlayer();
             break;
@@ -173,13 +139,14 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
         case SKSE::MessagingInterface::kNewGame:
             // New game, player won't exist until after character creation
             logger::debug("New game event received - will apply after character creation");
+            AppearanceTemplate::ResetActorIndex();
             logger::info("UseTemplateAppearance={}, FormID={}, Plugin={}",
                 Settings::UseTemplateAppearance, Settings::TemplateFormID, Settings::TemplatePlugin);
             if (Settings::UseTemplateAppearance) {
-                s_pendingAppearanceApply.store(true);
-                logger::info("Pending appearance flag set to TRUE");
+                AppearanceTemplate::ApplyIfConfigured();
+                logger::info("Appearance template pipeline armed");
             } else {
-                logger::warn("UseTemplateAppearance is FALSE, not setting pending flag");
+                logger::warn("UseTemplateAppearance is FALSE, not arming template pipeline");
             }
             break;
     }
@@ -201,6 +168,7 @@ extern "C" __declspec(dllexport) bool __cdecl SKSEPlugin_Load(const SKSE::LoadIn
     SKSE::AllocTrampoline(1 << 8);
 
     Settings::Load();
+    NoiseTables::Configure(Settings::NoiseTableSize);
 
     // Setup logging
     auto path = logger::log_directory();
@@ -220,6 +188,16 @@ extern "C" __declspec(dllexport) bool __cdecl SKSEPlugin_Load(const SKSE::LoadIn
 
     logger::debug("whois loaded");
 
+    // Settings load before the logger exists, report custom effect errors now
+    for (const auto& effect : Settings::CustomEffects) {
+        if (!effect.error.empty()) {
+            logger::warn("CustomEffects: {} does not compile ({}), using Gradient", effect.name, effect.error);
+        }
+    }
+    for (const auto& ref : Settings::UnknownEffects) {
+        logger::warn("{}: unknown effect {}, using Gradient", ref.label, ref.name);
+    }
+
     // Register for SKSE messages
     auto messaging = SKSE::GetMessagingInterface();
     if (messaging) {
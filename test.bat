@@ -38,7 +38,7 @@ REM STEP 2: Build Tests
 REM ============================================================================
 echo [2/3] Building test executables...
 echo ----------------------------------------------------------------------------
-cmake --build build --config Release --target whois_test_utils whois_test_settings
+cmake --build build --config Release --target whois_tests
 if errorlevel 1 (
     echo ERROR: Build failed!
     pause
@@ -55,33 +55,35 @@ echo.
 
 set ALL_PASSED=1
 
-REM Run utils tests
-echo === whois_test_utils ===
-if exist "build\Release\whois_test_utils.exe" (
-    build\Release\whois_test_utils.exe --gtest_color=yes
-    if errorlevel 1 set ALL_PASSED=0
-) else if exist "build\whois_test_utils.exe" (
-    build\whois_test_utils.exe --gtest_color=yes
-    if errorlevel 1 set ALL_PASSED=0
-) else (
-    echo ERROR: whois_test_utils.exe not found!
-    set ALL_PASSED=0
-)
-echo.
-
-REM Run settings tests
-echo === whois_test_settings ===
-if exist "build\Release\whois_test_settings.exe" (
-    build\Release\whois_test_settings.exe --gtest_color=yes
-    if errorlevel 1 set ALL_PASSED=0
-) else if exist "build\whois_test_settings.exe" (
-    build\whois_test_settings.exe --gtest_color=yes
-    if errorlevel 1 set ALL_PASSED=0
-) else (
-    echo ERROR: whois_test_settings.exe not found!
-    set ALL_PASSED=0
-)
-echo.
+for %%T in (
+    whois_test_utils
+    whois_test_settings
+    whois_test_actor_index
+    whois_test_outfit_diff
+    whois_test_facegen_index
+    whois_test_template_pipeline
+    whois_test_interned_string_table
+    whois_test_buffered_serialization
+    whois_test_flat_override_storage
+    whois_test_frame_pipeline
+    whois_test_snapshot_delta
+    whois_test_effect_decimation
+    whois_test_typewriter_mask
+    whois_test_effect_program
+    whois_test_overlay_state
+    whois_test_font_atlas
+    whois_test_label_instancing
+    whois_test_frame_allocations
+    whois_test_settings_watch
+    whois_test_ornament_runs
+    whois_test_noise_tables
+    whois_test_snapshot_schedule
+    whois_test_overlay_install_plan
+    whois_test_override_apply_plan
+    whois_test_sharded_registration_map
+    whois_test_incremental_save
+    whois_test_occlusion_bvh
+) do call :run_test %%T
 
 REM ============================================================================
 REM SUMMARY
@@ -100,3 +102,21 @@ if %ALL_PASSED%==1 (
 ) else (
     exit /b 1
 )
+
+REM ============================================================================
+REM :run_test <name> - Run one test executable, clearing ALL_PASSED on failure
+REM ============================================================================
+:run_test
+echo === %1 ===
+if exist "build\Release\%1.exe" (
+    build\Release\%1.exe --gtest_color=yes
+    if errorlevel 1 set ALL_PASSED=0
+) else if exist "build\%1.exe" (
+    build\%1.exe --gtest_color=yes
+    if errorlevel 1 set ALL_PASSED=0
+) else (
+    echo ERROR: %1.exe not found!
+    set ALL_PASSED=0
+)
+echo.
+goto :eof
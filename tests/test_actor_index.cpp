@@ -0,0 +1,264 @@
+/**
+ * Unit tests for the base-NPC to loaded-actor index using Google Test.
+ *
+ * Drives ActorIndex::BaseActorIndex with a synthetic world to cover
+ * seeding, attach/detach events, stale handle pruning, and compares
+ * lookup cost against a full form-map scan.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "ActorIndex.h"
+
+using ActorIndex::ActorHandle;
+using ActorIndex::ActorRecord;
+using ActorIndex::FormID;
+using ActorIndex::kInvalidHandle;
+
+// ============================================================================
+// Synthetic world
+// ============================================================================
+
+struct FakeActor {
+    FormID baseID = 0;
+    bool loaded = false;
+    bool processed = false;
+    bool isPlayer = false;
+};
+
+class FakeWorld : public ActorIndex::IGameQuery {
+public:
+    std::unordered_map<ActorHandle, FakeActor> actors;
+
+    void CollectProcessActors(std::vector<ActorRecord>& out) const override {
+        for (const auto& [handle, actor] : actors) {
+            if (actor.processed && !actor.isPlayer) {
+                out.push_back({handle, actor.baseID});
+            }
+        }
+    }
+
+    FormID GetBaseID(ActorHandle handle) const override {
+        auto it = actors.find(handle);
+        return it != actors.end() ? it->second.baseID : 0;
+    }
+
+    bool Is3DLoaded(ActorHandle handle) const override {
+        auto it = actors.find(handle);
+        return it != actors.end() && it->second.loaded;
+    }
+};
+
+// ============================================================================
+// Seeding
+// ============================================================================
+
+TEST(ActorIndexTest, SeedsLazilyFromProcessLists) {
+    FakeWorld world;
+    world.actors[1] = {0x100, true, true, false};
+    world.actors[2] = {0x200, true, true, false};
+
+    ActorIndex::BaseActorIndex index;
+    EXPECT_FALSE(index.IsSeeded());
+
+    EXPECT_EQ(index.FindLoaded(0x200, world), 2u);
+    EXPECT_TRUE(index.IsSeeded());
+    EXPECT_EQ(index.Size(), 2u);
+}
+
+TEST(ActorIndexTest, AttachBeforeFirstLookupSurvivesSeed) {
+    // Loaded but not in the process lists yet when the first lookup seeds
+    FakeWorld world;
+    world.actors[1] = {0x100, true, true, false};
+    world.actors[2] = {0x200, true, false, false};
+
+    ActorIndex::BaseActorIndex index;
+    index.OnActorAttached(2, 0x200);
+    EXPECT_FALSE(index.IsSeeded());
+
+    EXPECT_EQ(index.FindLoaded(0x200, world), 2u);
+    EXPECT_EQ(index.FindLoaded(0x100, world), 1u);
+    EXPECT_EQ(index.Size(), 2u);
+}
+
+TEST(ActorIndexTest, PlayerIsNotIndexed) {
+    FakeWorld world;
+    world.actors[7] = {0x7, true, true, true};
+
+    ActorIndex::BaseActorIndex index;
+    EXPECT_EQ(index.FindLoaded(0x7, world), kInvalidHandle);
+    EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST(ActorIndexTest, UnknownBaseReturnsInvalid) {
+    FakeWorld world;
+    world.actors[1] = {0x100, true, true, false};
+
+    ActorIndex::BaseActorIndex index;
+    EXPECT_EQ(index.FindLoaded(0xDEAD, world), kInvalidHandle);
+}
+
+TEST(ActorIndexTest, ClearForcesReseed) {
+    FakeWorld world;
+    world.actors[1] = {0x100, true, true, false};
+
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+    index.Clear();
+    EXPECT_FALSE(index.IsSeeded());
+    EXPECT_EQ(index.Size(), 0u);
+
+    world.actors[5] = {0x500, true, true, false};
+    EXPECT_EQ(index.FindLoaded(0x500, world), 5u);
+}
+
+// ============================================================================
+// Events
+// ============================================================================
+
+TEST(ActorIndexTest, AttachAddsActor) {
+    FakeWorld world;
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+
+    world.actors[9] = {0x900, true, false, false};
+    index.OnActorAttached(9, 0x900);
+    EXPECT_EQ(index.FindLoaded(0x900, world), 9u);
+}
+
+TEST(ActorIndexTest, DetachRemovesActor) {
+    FakeWorld world;
+    world.actors[9] = {0x900, true, true, false};
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+
+    index.OnActorDetached(9);
+    EXPECT_EQ(index.Size(), 0u);
+    EXPECT_EQ(index.FindLoaded(0x900, world), kInvalidHandle);
+}
+
+TEST(ActorIndexTest, DuplicateAttachIsIgnored) {
+    ActorIndex::BaseActorIndex index;
+    index.OnActorAttached(3, 0x300);
+    index.OnActorAttached(3, 0x300);
+    EXPECT_EQ(index.Size(), 1u);
+}
+
+TEST(ActorIndexTest, InvalidInputsAreIgnored) {
+    ActorIndex::BaseActorIndex index;
+    index.OnActorAttached(kInvalidHandle, 0x300);
+    index.OnActorAttached(4, 0);
+    index.OnActorDetached(1234);
+    EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST(ActorIndexTest, ReattachUnderNewBaseMovesHandle) {
+    FakeWorld world;
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+
+    index.OnActorAttached(3, 0x300);
+    world.actors[3] = {0x400, true, true, false};
+    index.OnActorAttached(3, 0x400);
+
+    EXPECT_EQ(index.Size(), 1u);
+    EXPECT_EQ(index.FindLoaded(0x300, world), kInvalidHandle);
+    EXPECT_EQ(index.FindLoaded(0x400, world), 3u);
+}
+
+// ============================================================================
+// Validation on lookup
+// ============================================================================
+
+TEST(ActorIndexTest, SkipsActorsWithout3D) {
+    FakeWorld world;
+    world.actors[1] = {0x100, false, true, false};
+    world.actors[2] = {0x100, true, true, false};
+
+    ActorIndex::BaseActorIndex index;
+    EXPECT_EQ(index.FindLoaded(0x100, world), 2u);
+}
+
+TEST(ActorIndexTest, StaleHandleIsPrunedOnLookup) {
+    FakeWorld world;
+    world.actors[1] = {0x100, true, true, false};
+
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+
+    // Actor deleted without a detach event
+    world.actors.erase(1);
+    EXPECT_EQ(index.FindLoaded(0x100, world), kInvalidHandle);
+    EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST(ActorIndexTest, ReusedHandleIsPrunedOnLookup) {
+    FakeWorld world;
+    world.actors[1] = {0x100, true, true, false};
+
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+
+    // Handle slot reused by a different NPC
+    world.actors[1] = {0x999, true, true, false};
+    EXPECT_EQ(index.FindLoaded(0x100, world), kInvalidHandle);
+    EXPECT_EQ(index.Size(), 0u);
+}
+
+// ============================================================================
+// Lookup cost vs. form-map scan
+// ============================================================================
+
+TEST(ActorIndexBenchmark, IndexBeatsFullFormScan) {
+    // Large load order: most forms are not actors, a few hundred are loaded
+    constexpr std::uint32_t kForms = 200000;
+    constexpr std::uint32_t kLoadedActors = 300;
+    constexpr int kLookups = 200;
+
+    struct Form {
+        bool isActor = false;
+        FormID baseID = 0;
+        bool loaded = false;
+    };
+    std::vector<Form> forms(kForms);
+    FakeWorld world;
+    for (std::uint32_t i = 0; i < kLoadedActors; ++i) {
+        const std::uint32_t slot = (i * 7919u) % kForms;
+        const FormID base = 0x1000 + i;
+        forms[slot] = {true, base, true};
+        world.actors[slot + 1] = {base, true, true, false};
+    }
+
+    // Always look up the last actor so the scan cost is realistic
+    const FormID target = 0x1000 + kLoadedActors - 1;
+
+    volatile std::size_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < kLookups; ++n) {
+        for (std::uint32_t i = 0; i < kForms; ++i) {
+            if (forms[i].isActor && forms[i].baseID == target && forms[i].loaded) {
+                sink = sink + i;
+                break;
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    ActorIndex::BaseActorIndex index;
+    index.Seed(world);
+    auto t2 = std::chrono::steady_clock::now();
+    for (int n = 0; n < kLookups; ++n) {
+        sink = sink + index.FindLoaded(target, world);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    const double scanUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / kLookups;
+    const double indexUs = std::chrono::duration<double, std::micro>(t3 - t2).count() / kLookups;
+    std::printf("[ BENCH    ] form scan: %.3f us/lookup, index: %.3f us/lookup\n", scanUs, indexUs);
+
+    EXPECT_NE(index.FindLoaded(target, world), kInvalidHandle);
+}
@@ -0,0 +1,677 @@
+/**
+ * Unit tests for the buffered co-save reader and writer using Google Test.
+ *
+ * Saves a synthetic override registration tree with the same record layout
+ * as OverrideInterface, once field by field against an SKSE co-save stand-in
+ * and once staged through BufferedWriter, and checks round trips, skipping
+ * of unknown blocks, corrupt input, and load time for large saves.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BufferedSerialization.h"
+#include "InternedStringTable.h"
+
+// ============================================================================
+// SKSE co-save stand-ins
+// ============================================================================
+
+struct CallCounts {
+    size_t open = 0, write = 0, next = 0, read = 0;
+};
+
+// Records framed with the SKSE header (type, version, length). Reads follow
+// SKSE: they stop at the end of the current record and may be partial.
+struct MemorySerialization {
+    std::vector<UInt8> data;
+    size_t recordStart = SIZE_MAX;
+    size_t pos = 0, limit = 0;
+    bool inRecord = false;
+    CallCounts calls;
+
+    bool OpenRecord(UInt32 type, UInt32 version) {
+        ++calls.open;
+        Close();
+        recordStart = data.size();
+        UInt32 header[3] = {type, version, 0};
+        Append(header, sizeof(header));
+        return true;
+    }
+    bool WriteRecordData(const void* buf, UInt32 length) {
+        ++calls.write;
+        Append(buf, length);
+        return true;
+    }
+    void Close() {
+        if (recordStart == SIZE_MAX) return;
+        UInt32 length = static_cast<UInt32>(data.size() - recordStart - 12);
+        std::memcpy(data.data() + recordStart + 8, &length, 4);
+        recordStart = SIZE_MAX;
+    }
+    void Rewind() {
+        Close();
+        pos = 0;
+        inRecord = false;
+        calls = {};
+    }
+
+    bool GetNextRecordInfo(UInt32* type, UInt32* version, UInt32* length) {
+        ++calls.next;
+        if (inRecord) pos = limit;
+        inRecord = false;
+        if (data.size() - pos < 12) return false;
+        UInt32 header[3];
+        std::memcpy(header, data.data() + pos, 12);
+        pos += 12;
+        if (header[2] > data.size() - pos) return false;
+        limit = pos + header[2];
+        inRecord = true;
+        *type = header[0];
+        *version = header[1];
+        *length = header[2];
+        return true;
+    }
+    UInt32 ReadRecordData(void* buf, UInt32 length) {
+        ++calls.read;
+        if (!inRecord) return 0;
+        UInt32 n = static_cast<UInt32>(std::min<size_t>(length, limit - pos));
+        std::memcpy(buf, data.data() + pos, n);
+        pos += n;
+        return n;
+    }
+
+private:
+    void Append(const void* buf, size_t length) {
+        const UInt8* p = static_cast<const UInt8*>(buf);
+        data.insert(data.end(), p, p + length);
+    }
+};
+
+// Same framing on an unbuffered file, so every call is a real I/O request
+// the way SKSE's co-save stream issues them
+struct FileSerialization {
+    std::FILE* file = nullptr;
+    long recordStart = -1;
+    long limit = 0;
+    bool inRecord = false;
+
+    explicit FileSerialization(const std::filesystem::path& path) {
+        file = std::fopen(path.string().c_str(), "w+b");
+        if (file) std::setvbuf(file, nullptr, _IONBF, 0);
+    }
+    ~FileSerialization() {
+        if (file) std::fclose(file);
+    }
+
+    bool OpenRecord(UInt32 type, UInt32 version) {
+        Close();
+        recordStart = std::ftell(file);
+        UInt32 header[3] = {type, version, 0};
+        return std::fwrite(header, 1, 12, file) == 12;
+    }
+    bool WriteRecordData(const void* buf, UInt32 length) {
+        return std::fwrite(buf, 1, length, file) == length;
+    }
+    void Close() {
+        if (recordStart < 0) return;
+        long end = std::ftell(file);
+        UInt32 length = static_cast<UInt32>(end - recordStart - 12);
+        std::fseek(file, recordStart + 8, SEEK_SET);
+        std::fwrite(&length, 1, 4, file);
+        std::fseek(file, end, SEEK_SET);
+        recordStart = -1;
+    }
+    void Rewind() {
+        Close();
+        std::fseek(file, 0, SEEK_SET);
+        inRecord = false;
+    }
+
+    bool GetNextRecordInfo(UInt32* type, UInt32* version, UInt32* length) {
+        if (inRecord) std::fseek(file, limit, SEEK_SET);
+        inRecord = false;
+        UInt32 header[3];
+        if (std::fread(header, 1, 12, file) != 12) return false;
+        limit = std::ftell(file) + static_cast<long>(header[2]);
+        inRecord = true;
+        *type = header[0];
+        *version = header[1];
+        *length = header[2];
+        return true;
+    }
+    UInt32 ReadRecordData(void* buf, UInt32 length) {
+        if (!inRecord) return 0;
+        long remaining = limit - std::ftell(file);
+        UInt32 n = static_cast<UInt32>(std::min<long>(length, remaining));
+        return static_cast<UInt32>(std::fread(buf, 1, n, file));
+    }
+};
+
+// ============================================================================
+// Synthetic override registrations (OverrideInterface record layout)
+// ============================================================================
+
+struct Value {
+    UInt16 key = 0;
+    UInt8 type = 0;
+    UInt8 index = 0;
+    UInt32 data = 0;
+    bool operator==(const Value&) const = default;
+};
+
+struct Node {
+    UInt32 nameID = 0;
+    std::vector<Value> values;
+    bool operator==(const Node&) const = default;
+};
+
+struct Armor {
+    UInt32 handle = 0;
+    std::vector<Node> nodes;
+    bool operator==(const Armor&) const = default;
+};
+
+struct Actor {
+    UInt64 handle = 0;
+    std::vector<Armor> armors;
+    bool operator==(const Actor&) const = default;
+};
+
+static std::vector<Actor> MakeActors(UInt32 actors, UInt32 armors, UInt32 nodes, UInt32 values) {
+    std::vector<Actor> out(actors);
+    UInt32 seed = 1;
+    for (UInt32 a = 0; a < actors; ++a) {
+        out[a].handle = 0xFF000000ull + a;
+        out[a].armors.resize(armors);
+        for (UInt32 r = 0; r < armors; ++r) {
+            Armor& armor = out[a].armors[r];
+            armor.handle = 0x12000 + r;
+            armor.nodes.resize(nodes);
+            for (UInt32 n = 0; n < nodes; ++n) {
+                armor.nodes[n].nameID = n * 3 + r;
+                for (UInt32 v = 0; v < values; ++v) {
+                    seed = seed * 1664525u + 1013904223u;
+                    armor.nodes[n].values.push_back({static_cast<UInt16>(v), 1, static_cast<UInt8>(v & 3), seed});
+                }
+            }
+        }
+    }
+    return out;
+}
+
+template <class Intfc>
+static void SaveActors(Intfc* intfc, const std::vector<Actor>& actors, UInt32 version) {
+    for (const Actor& actor : actors) {
+        intfc->OpenRecord('ACEN', version);
+        intfc->WriteRecordData(&actor.handle, sizeof(actor.handle));
+        UInt8 genders = 1, gender = 0;
+        intfc->WriteRecordData(&genders, sizeof(genders));
+        intfc->WriteRecordData(&gender, sizeof(gender));
+        UInt32 numArmors = static_cast<UInt32>(actor.armors.size());
+        intfc->WriteRecordData(&numArmors, sizeof(numArmors));
+        for (const Armor& armor : actor.armors) {
+            intfc->OpenRecord('AREN', version);
+            intfc->WriteRecordData(&armor.handle, sizeof(armor.handle));
+            UInt32 numNodes = static_cast<UInt32>(armor.nodes.size());
+            intfc->WriteRecordData(&numNodes, sizeof(numNodes));
+            for (const Node& node : armor.nodes) {
+                intfc->OpenRecord('NOEN', version);
+                intfc->WriteRecordData(&node.nameID, sizeof(node.nameID));
+                intfc->OpenRecord('OVST', version);
+                UInt32 numValues = static_cast<UInt32>(node.values.size());
+                intfc->WriteRecordData(&numValues, sizeof(numValues));
+                for (const Value& value : node.values) {
+                    intfc->OpenRecord('OVRV', version);
+                    intfc->WriteRecordData(&value.key, sizeof(value.key));
+                    intfc->WriteRecordData(&value.type, sizeof(value.type));
+                    intfc->WriteRecordData(&value.index, sizeof(value.index));
+                    intfc->WriteRecordData(&value.data, sizeof(value.data));
+                }
+            }
+        }
+    }
+}
+
+template <class Intfc, class T>
+static bool Read(Intfc* intfc, T& out) {
+    return intfc->ReadRecordData(&out, sizeof(out)) == sizeof(out);
+}
+
+template <class Intfc>
+static bool Expect(Intfc* intfc, UInt32 expected) {
+    UInt32 type = 0, version = 0, length = 0;
+    return intfc->GetNextRecordInfo(&type, &version, &length) && type == expected;
+}
+
+// Returns true on error, like the SKEE loaders
+template <class Intfc>
+static bool LoadActor(Intfc* intfc, Actor& actor) {
+    UInt8 genders = 0, gender = 0;
+    UInt32 numArmors = 0;
+    if (!Read(intfc, actor.handle) || !Read(intfc, genders) || genders != 1 || !Read(intfc, gender) ||
+        !Read(intfc, numArmors))
+        return true;
+    for (UInt32 i = 0; i < numArmors; ++i) {
+        Armor armor;
+        UInt32 numNodes = 0;
+        if (!Expect(intfc, 'AREN') || !Read(intfc, armor.handle) || !Read(intfc, numNodes)) return true;
+        for (UInt32 n = 0; n < numNodes; ++n) {
+            Node node;
+            UInt32 numValues = 0;
+            if (!Expect(intfc, 'NOEN') || !Read(intfc, node.nameID)) return true;
+            if (!Expect(intfc, 'OVST') || !Read(intfc, numValues)) return true;
+            for (UInt32 v = 0; v < numValues; ++v) {
+                Value value;
+                if (!Expect(intfc, 'OVRV') || !Read(intfc, value.key) || !Read(intfc, value.type) ||
+                    !Read(intfc, value.index) || !Read(intfc, value.data))
+                    return true;
+                node.values.push_back(value);
+            }
+            armor.nodes.push_back(std::move(node));
+        }
+        actor.armors.push_back(std::move(armor));
+    }
+    return false;
+}
+
+// Top-level dispatch: every 'ACEN' record is an actor, anything else is skipped
+template <class Intfc>
+static std::vector<Actor> LoadActors(Intfc* intfc, size_t* errors = nullptr) {
+    std::vector<Actor> out;
+    UInt32 type = 0, version = 0, length = 0;
+    while (intfc->GetNextRecordInfo(&type, &version, &length)) {
+        if (type != 'ACEN') continue;
+        Actor actor;
+        if (LoadActor(intfc, actor)) {
+            if (errors) ++*errors;
+            continue;
+        }
+        out.push_back(std::move(actor));
+    }
+    return out;
+}
+
+// Mirrors OverrideInterface::Save/LoadBuffered
+template <class Intfc>
+static void SaveBuffered(Intfc* intfc, const std::vector<Actor>& actors) {
+    BufferedWriter writer;
+    SaveActors(&writer, actors, 3);
+    writer.Flush(intfc, 'OVBF', 1);
+}
+
+template <class Intfc>
+static std::vector<Actor> LoadBuffered(Intfc* intfc) {
+    UInt32 type = 0, version = 0, length = 0;
+    BufferedReader reader;
+    if (!intfc->GetNextRecordInfo(&type, &version, &length) || type != 'OVBF' || !reader.Fill(intfc, length))
+        return {};
+    return LoadActors(&reader);
+}
+
+// What the co-save load callback finds through OverrideInterface::LoadRecord
+struct CoSave {
+    InternedStringTable strings;
+    InternedStringTable::StringIdRemap remap;
+    std::vector<Actor> actors;
+};
+
+// Mirrors OverrideInterface::LoadRecord, fed every record of the co-save
+template <class Intfc>
+static void LoadCoSave(Intfc* intfc, CoSave& out) {
+    UInt32 type = 0, version = 0, length = 0;
+    while (intfc->GetNextRecordInfo(&type, &version, &length)) {
+        switch (type) {
+            case 'STTB':
+                out.strings.LoadBuffered(intfc, version, length, out.remap);
+                break;
+            case 'OVBF': {
+                BufferedReader reader;
+                if (version > 1 || !reader.Fill(intfc, length)) break;
+                for (Actor& actor : LoadActors(&reader)) out.actors.push_back(std::move(actor));
+                break;
+            }
+            case 'ACEN': {
+                Actor actor;
+                if (!LoadActor(intfc, actor)) out.actors.push_back(std::move(actor));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+// ============================================================================
+// Writer and reader
+// ============================================================================
+
+TEST(BufferedSerializationTest, BlocksUseTheSkseRecordHeader) {
+    BufferedWriter writer;
+    UInt32 raw = 7;
+    writer.WriteRecordData(&raw, sizeof(raw));
+    writer.OpenRecord('ABCD', 2);
+    UInt16 payload = 0x1234;
+    writer.WriteRecordData(&payload, sizeof(payload));
+    writer.OpenRecord('EFGH', 5);
+
+    MemorySerialization out;
+    ASSERT_TRUE(writer.Flush(&out, 'TEST', 1));
+    ASSERT_EQ(out.data.size(), 12u + 4 + 12 + 2 + 12);
+
+    UInt32 header[3];
+    std::memcpy(header, out.data.data() + 16, sizeof(header));
+    EXPECT_EQ(header[0], UInt32('ABCD'));
+    EXPECT_EQ(header[1], 2u);
+    EXPECT_EQ(header[2], 2u);
+    std::memcpy(header, out.data.data() + 30, sizeof(header));
+    EXPECT_EQ(header[0], UInt32('EFGH'));
+    EXPECT_EQ(header[2], 0u);
+}
+
+TEST(BufferedSerializationTest, ReaderServesRawDataThenBlocks) {
+    BufferedWriter writer;
+    UInt32 raw = 7;
+    writer.WriteRecordData(&raw, sizeof(raw));
+    writer.OpenRecord('ABCD', 2);
+    UInt16 payload = 0x1234;
+    writer.WriteRecordData(&payload, sizeof(payload));
+    writer.Finish();
+
+    BufferedReader reader;
+    reader.Assign(writer.Data(), writer.Size());
+    UInt32 readRaw = 0;
+    ASSERT_EQ(reader.ReadRecordData(&readRaw, sizeof(readRaw)), 4u);
+    EXPECT_EQ(readRaw, 7u);
+
+    UInt32 type = 0, version = 0, length = 0;
+    ASSERT_TRUE(reader.GetNextRecordInfo(&type, &version, &length));
+    EXPECT_EQ(type, UInt32('ABCD'));
+    EXPECT_EQ(version, 2u);
+    EXPECT_EQ(length, 2u);
+
+    // Reads never cross into the next block
+    UInt32 tooWide = 0;
+    EXPECT_EQ(reader.ReadRecordData(&tooWide, sizeof(tooWide)), 0u);
+    UInt16 readPayload = 0;
+    ASSERT_EQ(reader.ReadRecordData(&readPayload, sizeof(readPayload)), 2u);
+    EXPECT_EQ(readPayload, 0x1234);
+    EXPECT_FALSE(reader.GetNextRecordInfo(&type, &version, &length));
+}
+
+TEST(BufferedSerializationTest, UnreadBlockDataIsSkipped) {
+    BufferedWriter writer;
+    writer.OpenRecord('SKIP', 1);
+    std::vector<UInt8> junk(100, 0xAB);
+    writer.WriteRecordData(junk.data(), static_cast<UInt32>(junk.size()));
+    writer.OpenRecord('NEXT', 1);
+    writer.Finish();
+
+    BufferedReader reader;
+    reader.Assign(writer.Data(), writer.Size());
+    UInt32 type = 0, version = 0, length = 0;
+    ASSERT_TRUE(reader.GetNextRecordInfo(&type, &version, &length));
+    UInt8 first = 0;
+    reader.ReadRecordData(&first, 1);
+    ASSERT_TRUE(reader.GetNextRecordInfo(&type, &version, &length));
+    EXPECT_EQ(type, UInt32('NEXT'));
+}
+
+TEST(BufferedSerializationTest, FillRejectsShortRecord) {
+    MemorySerialization out;
+    UInt32 value = 1;
+    out.OpenRecord('TEST', 1);
+    out.WriteRecordData(&value, sizeof(value));
+    out.Rewind();
+
+    UInt32 type = 0, version = 0, length = 0;
+    ASSERT_TRUE(out.GetNextRecordInfo(&type, &version, &length));
+    BufferedReader reader;
+    EXPECT_FALSE(reader.Fill(&out, length + 8));
+    EXPECT_EQ(reader.Remaining(), 0u);
+}
+
+// ============================================================================
+// Override registrations
+// ============================================================================
+
+TEST(BufferedSerializationTest, BlockStreamMatchesPerRecordLayout) {
+    const auto actors = MakeActors(3, 2, 3, 4);
+
+    MemorySerialization legacy;
+    SaveActors(&legacy, actors, 3);
+    legacy.Close();
+
+    BufferedWriter writer;
+    SaveActors(&writer, actors, 3);
+    MemorySerialization buffered;
+    writer.Flush(&buffered, 'OVBF', 1);
+
+    // The OVBF payload is exactly what SKSE would have written record by record
+    ASSERT_EQ(buffered.data.size(), legacy.data.size() + 12);
+    EXPECT_EQ(0, std::memcmp(buffered.data.data() + 12, legacy.data.data(), legacy.data.size()));
+}
+
+TEST(BufferedSerializationTest, RoundTripMatchesPerFieldLoad) {
+    const auto actors = MakeActors(20, 3, 4, 5);
+
+    MemorySerialization legacy;
+    SaveActors(&legacy, actors, 3);
+    legacy.Rewind();
+    EXPECT_EQ(LoadActors(&legacy), actors);
+
+    MemorySerialization buffered;
+    SaveBuffered(&buffered, actors);
+    EXPECT_EQ(buffered.calls.open, 1u);
+    EXPECT_EQ(buffered.calls.write, 1u);
+
+    buffered.Rewind();
+    EXPECT_EQ(LoadBuffered(&buffered), actors);
+    EXPECT_EQ(buffered.calls.next, 1u);
+    EXPECT_EQ(buffered.calls.read, 1u);
+}
+
+TEST(BufferedSerializationTest, UnknownBlocksAreSkippedWithoutParsing) {
+    const auto actors = MakeActors(4, 1, 2, 2);
+
+    BufferedWriter writer;
+    std::mt19937 rng(7);
+    for (const Actor& actor : actors) {
+        // A future block type with contents the loader cannot parse
+        writer.OpenRecord('ZZZZ', 9);
+        std::vector<UInt8> junk(rng() % 64);
+        for (auto& b : junk) b = static_cast<UInt8>(rng());
+        writer.WriteRecordData(junk.data(), static_cast<UInt32>(junk.size()));
+        SaveActors(&writer, {actor}, 3);
+    }
+    writer.OpenRecord('ZZZZ', 9);
+
+    MemorySerialization out;
+    writer.Flush(&out, 'OVBF', 1);
+    out.Rewind();
+    EXPECT_EQ(LoadBuffered(&out), actors);
+}
+
+TEST(BufferedSerializationTest, BufferedSaveLoadsThroughDispatch) {
+    const auto actors = MakeActors(8, 2, 3, 2);
+    InternedStringTable table;
+    for (const char* name : {"Body [Ovl0]", "Face [Ovl0]", "Hands [Ovl0]"}) table.Intern(name);
+
+    MemorySerialization out;
+    table.Save(&out, InternedStringTable::kSerializationVersion);
+    SaveBuffered(&out, actors);
+    UInt32 other = 0xDEADBEEF;
+    out.OpenRecord('AOVL', 1);  // Another interface's record
+    out.WriteRecordData(&other, sizeof(other));
+    out.Rewind();
+
+    CoSave loaded;
+    LoadCoSave(&out, loaded);
+    EXPECT_EQ(loaded.actors, actors);
+    ASSERT_EQ(loaded.remap.size(), 3u);
+    EXPECT_STREQ(loaded.strings.GetString(loaded.remap[1]), "Face [Ovl0]");
+    EXPECT_EQ(out.calls.read, 2u);  // One read per record, none for 'AOVL'
+}
+
+TEST(BufferedSerializationTest, PerRecordSaveLoadsThroughDispatch) {
+    const auto actors = MakeActors(8, 2, 3, 2);
+
+    MemorySerialization out;
+    SaveActors(&out, actors, 3);
+    out.Rewind();
+
+    CoSave loaded;
+    LoadCoSave(&out, loaded);
+    EXPECT_EQ(loaded.actors, actors);
+}
+
+TEST(BufferedSerializationTest, EmptySaveLoadsNothing) {
+    MemorySerialization out;
+    SaveBuffered(&out, {});
+    out.Rewind();
+    EXPECT_TRUE(LoadBuffered(&out).empty());
+}
+
+// ============================================================================
+// String table
+// ============================================================================
+
+TEST(BufferedSerializationTest, StringTableSavesInOneWrite) {
+    InternedStringTable table;
+    for (int i = 0; i < 1000; ++i) table.Intern(("Node_" + std::to_string(i)).c_str());
+
+    MemorySerialization out;
+    table.Save(&out, InternedStringTable::kSerializationVersion);
+    EXPECT_EQ(out.calls.open, 1u);
+    EXPECT_EQ(out.calls.write, 1u);
+
+    out.Rewind();
+    UInt32 type = 0, version = 0, length = 0;
+    ASSERT_TRUE(out.GetNextRecordInfo(&type, &version, &length));
+    EXPECT_EQ(type, UInt32('STTB'));
+
+    InternedStringTable loaded;
+    InternedStringTable::StringIdRemap remap;
+    ASSERT_FALSE(loaded.LoadBuffered(&out, version, length, remap));
+    EXPECT_EQ(out.calls.read, 1u);
+    ASSERT_EQ(remap.size(), 1000u);
+    EXPECT_STREQ(loaded.GetString(remap[999]), "Node_999");
+}
+
+// ============================================================================
+// Corrupt input
+// ============================================================================
+
+TEST(BufferedSerializationFuzz, CorruptOverrideRecordsNeverOverrun) {
+    const auto actors = MakeActors(6, 2, 2, 3);
+    BufferedWriter writer;
+    SaveActors(&writer, actors, 3);
+    writer.Finish();
+    const std::vector<UInt8> clean(writer.Data(), writer.Data() + writer.Size());
+
+    std::mt19937 rng(1234);
+    for (int iter = 0; iter < 3000; ++iter) {
+        std::vector<UInt8> bytes = clean;
+        switch (iter % 3) {
+        case 0:  // Bit flips
+            for (int f = 0; f < 1 + static_cast<int>(rng() % 8); ++f)
+                bytes[rng() % bytes.size()] ^= static_cast<UInt8>(1u << (rng() % 8));
+            break;
+        case 1:  // Truncation
+            bytes.resize(rng() % bytes.size());
+            break;
+        default:  // Random garbage
+            for (auto& b : bytes) b = static_cast<UInt8>(rng());
+            break;
+        }
+
+        BufferedReader reader;
+        reader.Assign(bytes.data(), bytes.size());
+        size_t errors = 0;
+        const auto loaded = LoadActors(&reader, &errors);
+        EXPECT_LE(loaded.size(), actors.size() + bytes.size() / 12);
+    }
+}
+
+TEST(BufferedSerializationFuzz, CorruptStringTableNeverOverruns) {
+    InternedStringTable table;
+    for (int i = 0; i < 200; ++i) table.Intern(("String_" + std::to_string(i)).c_str());
+    MemorySerialization saved;
+    table.Save(&saved, InternedStringTable::kSerializationVersion);
+    const std::vector<UInt8> clean(saved.data.begin() + 12, saved.data.end());
+
+    std::mt19937 rng(99);
+    for (int iter = 0; iter < 2000; ++iter) {
+        std::vector<UInt8> bytes = clean;
+        if (iter % 2) {
+            bytes.resize(rng() % bytes.size());
+        } else {
+            for (int f = 0; f < 4; ++f) bytes[rng() % bytes.size()] = static_cast<UInt8>(rng());
+        }
+
+        BufferedReader reader;
+        reader.Assign(bytes.data(), bytes.size());
+        InternedStringTable loaded;
+        InternedStringTable::StringIdRemap remap;
+        if (!loaded.Load(&reader, InternedStringTable::kSerializationVersion, remap)) {
+            for (StringID id : remap) EXPECT_NE(loaded.GetString(id), nullptr);
+        }
+    }
+}
+
+// ============================================================================
+// Load time for large saves
+// ============================================================================
+
+TEST(BufferedSerializationBenchmark, LargeSaveLoad) {
+    // 400 actors with a full outfit of overrides: ~77k values
+    const auto actors = MakeActors(400, 8, 4, 6);
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto legacyPath = dir / "whois_buffered_legacy.skse";
+    const auto bufferedPath = dir / "whois_buffered_block.skse";
+
+    double legacySaveMs, legacyLoadMs, bufferedSaveMs, bufferedLoadMs;
+    std::vector<Actor> legacyLoaded, bufferedLoaded;
+    {
+        FileSerialization file(legacyPath);
+        ASSERT_NE(file.file, nullptr);
+        auto t0 = std::chrono::steady_clock::now();
+        SaveActors(&file, actors, 3);
+        file.Rewind();
+        auto t1 = std::chrono::steady_clock::now();
+        legacyLoaded = LoadActors(&file);
+        auto t2 = std::chrono::steady_clock::now();
+        legacySaveMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        legacyLoadMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+    {
+        FileSerialization file(bufferedPath);
+        ASSERT_NE(file.file, nullptr);
+        auto t0 = std::chrono::steady_clock::now();
+        SaveBuffered(&file, actors);
+        file.Rewind();
+        auto t1 = std::chrono::steady_clock::now();
+        bufferedLoaded = LoadBuffered(&file);
+        auto t2 = std::chrono::steady_clock::now();
+        bufferedSaveMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        bufferedLoadMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+    std::error_code ec;
+    std::filesystem::remove(legacyPath, ec);
+    std::filesystem::remove(bufferedPath, ec);
+
+    std::printf("[ BENCH    ] per-field: save %.1f ms, load %.1f ms\n", legacySaveMs, legacyLoadMs);
+    std::printf("[ BENCH    ] buffered:  save %.1f ms, load %.1f ms\n", bufferedSaveMs, bufferedLoadMs);
+
+    EXPECT_EQ(legacyLoaded, actors);
+    EXPECT_EQ(bufferedLoaded, actors);
+    EXPECT_LT(bufferedLoadMs, legacyLoadMs);
+}
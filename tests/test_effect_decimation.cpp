@@ -0,0 +1,404 @@
+/**
+ * Unit tests for temporal decimation of animated text effects using Google Test.
+ *
+ * Drives EffectDecimation::ColorCache the way TextEffects does, with
+ * headless stand-ins for the rainbow and aurora color fields, and bounds
+ * the color error against evaluating every frame at high refresh rates.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "EffectDecimation.h"
+
+using EffectDecimation::Bucket;
+using EffectDecimation::ColorCache;
+using EffectDecimation::EffectClass;
+using EffectDecimation::LabelPhase;
+using EffectDecimation::MakeKey;
+using EffectDecimation::RescaleAlpha;
+using EffectDecimation::Shape;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static constexpr float kTwoPi = 6.28318530718f;
+
+static std::uint32_t Pack(float r, float g, float b, std::uint8_t a)
+{
+    auto ch = [](float v) { return static_cast<std::uint32_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return ch(r) | (ch(g) << 8) | (ch(b) << 16) | (static_cast<std::uint32_t>(a) << 24);
+}
+
+static int Channel(std::uint32_t c, int i)
+{
+    return static_cast<int>((c >> (i * 8)) & 0xFF);
+}
+
+// Largest per-channel difference, alpha included
+static int ColorError(std::uint32_t a, std::uint32_t b)
+{
+    int err = 0;
+    for (int i = 0; i < 4; ++i)
+        err = (std::max)(err, std::abs(Channel(a, i) - Channel(b, i)));
+    return err;
+}
+
+// Rainbow wave stand-in: hue drifts with time across the text
+static std::uint32_t Rainbow(float nx, float, double time, std::uint8_t alpha)
+{
+    const float hue = nx * 0.6f + static_cast<float>(time) * 0.5f * 0.4f;
+    const float h = (hue - std::floor(hue)) * 6.0f;
+    const float x = 1.0f - std::abs(std::fmod(h, 2.0f) - 1.0f);
+    float r = 0, g = 0, b = 0;
+    switch (static_cast<int>(h))
+    {
+    case 0: r = 1; g = x; break;
+    case 1: r = x; g = 1; break;
+    case 2: g = 1; b = x; break;
+    case 3: g = x; b = 1; break;
+    case 4: r = x; b = 1; break;
+    default: r = 1; b = x; break;
+    }
+    return Pack(0.1f + 0.9f * r, 0.1f + 0.9f * g, 0.1f + 0.9f * b, alpha);
+}
+
+// Aurora stand-in: layered sine waves blending two colors
+static std::uint32_t Aurora(float nx, float ny, double time, std::uint8_t alpha)
+{
+    const float t = static_cast<float>(time) * 0.5f;
+    float w = std::sin(nx * 3.0f * kTwoPi + t * 1.2f + ny * 2.0f);
+    w += std::sin(nx * 2.1f * kTwoPi - t * 0.8f + ny * 1.5f) * 0.6f;
+    w += std::sin(ny * kTwoPi * 2.0f + t * 0.7f) * 0.4f;
+    const float k = std::clamp(w / 4.0f + 0.5f, 0.0f, 1.0f);
+    return Pack(0.2f + 0.6f * k, 0.9f - 0.5f * k, 0.6f + 0.3f * k, alpha);
+}
+
+using ColorField = std::uint32_t (*)(float, float, double, std::uint8_t);
+
+struct Label
+{
+    std::uint32_t key;
+    std::vector<float> nx, ny;  // normalized vertex positions
+};
+
+static std::vector<Label> MakeLabels(int count, int vertices)
+{
+    std::vector<Label> labels(count);
+    for (int l = 0; l < count; ++l)
+    {
+        labels[l].key = 0x1000u + static_cast<std::uint32_t>(l) * 7u;
+        for (int v = 0; v < vertices; ++v)
+        {
+            labels[l].nx.push_back(static_cast<float>(v) / static_cast<float>(vertices - 1));
+            labels[l].ny.push_back((v & 1) ? 1.0f : 0.0f);
+        }
+    }
+    return labels;
+}
+
+// Same sequence as TextEffects' DecimatedColors: Find, else evaluate + Store.
+// Returns true if the field was evaluated.
+static bool DrawEffect(ColorCache& cache, const Label& label, ColorField field, double time, float rateHz,
+                       std::uint8_t alpha, std::vector<std::uint32_t>& out)
+{
+    const std::size_t n = label.nx.size();
+    out.resize(n);
+
+    if (rateHz <= 0.0f)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = field(label.nx[i], label.ny[i], time, alpha);
+        return true;
+    }
+
+    const std::uint64_t key = MakeKey(label.key, 0, EffectClass::Noise);
+    const std::int64_t bucket = Bucket(time, rateHz, LabelPhase(label.key));
+    const Shape shape{static_cast<std::uint32_t>(n), 120.0f, 18.0f};
+
+    std::uint8_t cachedAlpha = alpha;
+    if (const std::uint32_t* colors = cache.Find(key, bucket, shape, cachedAlpha))
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = RescaleAlpha(colors[i], cachedAlpha, alpha);
+        return false;
+    }
+
+    std::uint32_t* colors = cache.Store(key, bucket, shape, alpha);
+    for (std::size_t i = 0; i < n; ++i)
+        colors[i] = out[i] = field(label.nx[i], label.ny[i], time, alpha);
+    return true;
+}
+
+// Steepest per-channel change of `field` in color steps per second
+static double MaxSlope(ColorField field, const Label& label)
+{
+    constexpr double kDt = 1.0 / 100.0;  // long enough that rounding steps don't dominate
+    double slope = 0.0;
+    for (double t = 0.0; t < 5.0; t += 0.01)
+    {
+        for (std::size_t i = 0; i < label.nx.size(); ++i)
+        {
+            const int d = ColorError(field(label.nx[i], label.ny[i], t, 255),
+                                     field(label.nx[i], label.ny[i], t + kDt, 255));
+            slope = (std::max)(slope, d / kDt);
+        }
+    }
+    return slope;
+}
+
+// ============================================================================
+// Buckets and keys
+// ============================================================================
+
+TEST(EffectDecimationBucket, PhasesAreInUnitRangeAndSpread)
+{
+    int bins[8] = {};
+    for (std::uint32_t key = 1; key <= 256; ++key)
+    {
+        const float phase = LabelPhase(key);
+        ASSERT_GE(phase, 0.0f);
+        ASSERT_LT(phase, 1.0f);
+        ++bins[static_cast<int>(phase * 8.0f)];
+    }
+    for (int count : bins)
+        EXPECT_GT(count, 16);  // 32 expected per bin
+}
+
+TEST(EffectDecimationBucket, AdvancesOncePerPeriod)
+{
+    const float phase = LabelPhase(42);
+    std::int64_t last = Bucket(0.0, 30.0f, phase);
+    int changes = 0;
+    for (int frame = 1; frame <= 240; ++frame)
+    {
+        const std::int64_t b = Bucket(frame / 240.0, 30.0f, phase);
+        EXPECT_GE(b, last);
+        changes += (b != last);
+        last = b;
+    }
+    EXPECT_EQ(changes, 30);
+}
+
+TEST(EffectDecimationBucket, KeysSeparateLabelsSlotsAndClasses)
+{
+    EXPECT_NE(MakeKey(1, 0, EffectClass::Rainbow), MakeKey(2, 0, EffectClass::Rainbow));
+    EXPECT_NE(MakeKey(1, 0, EffectClass::Rainbow), MakeKey(1, 1, EffectClass::Rainbow));
+    EXPECT_NE(MakeKey(1, 0, EffectClass::Rainbow), MakeKey(1, 0, EffectClass::Noise));
+}
+
+// ============================================================================
+// Cache
+// ============================================================================
+
+TEST(EffectDecimationCache, ReusesOnlyWithinBucketAndShape)
+{
+    ColorCache cache;
+    const Shape shape{4, 100.0f, 20.0f};
+    std::uint8_t alpha = 255;
+
+    EXPECT_EQ(cache.Find(1, 10, shape, alpha), nullptr);
+    std::uint32_t* colors = cache.Store(1, 10, shape, 255);
+    for (int i = 0; i < 4; ++i)
+        colors[i] = 0xFF000000u | static_cast<std::uint32_t>(i);
+
+    const std::uint32_t* hit = cache.Find(1, 10, shape, alpha);
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit[3], 0xFF000003u);
+
+    // Sub-pixel jitter in bounds still matches
+    EXPECT_NE(cache.Find(1, 10, Shape{4, 100.3f, 19.8f}, alpha), nullptr);
+
+    EXPECT_EQ(cache.Find(1, 11, shape, alpha), nullptr);                    // next bucket
+    EXPECT_EQ(cache.Find(1, 10, Shape{6, 100.0f, 20.0f}, alpha), nullptr);  // text changed
+    EXPECT_EQ(cache.Find(1, 10, Shape{4, 104.0f, 20.0f}, alpha), nullptr);  // rescaled
+    EXPECT_EQ(cache.Find(2, 10, shape, alpha), nullptr);                    // other label
+
+    EXPECT_EQ(cache.GetStats().evaluated, 1u);
+    EXPECT_EQ(cache.GetStats().reused, 2u);
+}
+
+TEST(EffectDecimationCache, EndFrameEvictsLabelsNotDrawn)
+{
+    ColorCache cache;
+    const Shape shape{1, 10.0f, 10.0f};
+    std::uint8_t alpha = 255;
+    cache.Store(1, 0, shape, 255);
+    cache.Store(2, 0, shape, 255);
+    cache.EndFrame();
+    EXPECT_EQ(cache.Size(), 2u);
+
+    // Only label 1 drawn this frame
+    ASSERT_NE(cache.Find(1, 0, shape, alpha), nullptr);
+    cache.EndFrame();
+    EXPECT_EQ(cache.Size(), 1u);
+    EXPECT_NE(cache.Find(1, 0, shape, alpha), nullptr);
+    EXPECT_EQ(cache.Find(2, 0, shape, alpha), nullptr);
+}
+
+TEST(EffectDecimationCache, RescalesAlphaOfHeldColors)
+{
+    EXPECT_EQ(RescaleAlpha(0xFF123456u, 255, 255), 0xFF123456u);
+    EXPECT_EQ(RescaleAlpha(0xFF123456u, 255, 128), 0x80123456u);
+    EXPECT_EQ(RescaleAlpha(0x40123456u, 128, 255), 0x80123456u);
+    EXPECT_EQ(RescaleAlpha(0xFF123456u, 128, 255), 0xFF123456u);  // clamped
+
+    // Colors evaluated fully transparent carry no color to scale up
+    ColorCache cache;
+    const Shape shape{1, 10.0f, 10.0f};
+    cache.Store(1, 0, shape, 0)[0] = 0;
+    std::uint8_t alpha = 200;
+    EXPECT_EQ(cache.Find(1, 0, shape, alpha), nullptr);
+    alpha = 0;
+    EXPECT_NE(cache.Find(1, 0, shape, alpha), nullptr);
+}
+
+// ============================================================================
+// Error against full-rate evaluation
+// ============================================================================
+
+static void ExpectBoundedError(ColorField field, const char* name)
+{
+    const auto labels = MakeLabels(16, 48);
+    const double slope = MaxSlope(field, labels[0]);
+
+    for (float fps : {144.0f, 240.0f})
+    {
+        for (float rate : {30.0f, 60.0f})
+        {
+            ColorCache cache;
+            std::vector<std::uint32_t> full, decimated;
+            int maxError = 0;
+            std::uint64_t evaluations = 0;
+            const int frames = static_cast<int>(fps * 10.0f);
+
+            for (int f = 0; f < frames; ++f)
+            {
+                const double time = f / static_cast<double>(fps);
+                for (const auto& label : labels)
+                {
+                    DrawEffect(cache, label, field, time, 0.0f, 255, full);
+                    evaluations += DrawEffect(cache, label, field, time, rate, 255, decimated) ? 1 : 0;
+                    for (std::size_t i = 0; i < full.size(); ++i)
+                        maxError = (std::max)(maxError, ColorError(full[i], decimated[i]));
+                }
+                cache.EndFrame();
+            }
+
+            // Held for at most one period, plus one step of rounding
+            const int bound = static_cast<int>(std::ceil(slope / rate)) + 1;
+            const double evalFraction = static_cast<double>(evaluations) / (static_cast<double>(frames) * static_cast<double>(labels.size()));
+
+            std::printf("[ BENCH    ] %s %3.0f Hz display, %2.0f Hz effect: max error %d/255 (bound %d), evaluated %.1f%% of passes\n",
+                        name, fps, rate, maxError, bound, evalFraction * 100.0);
+
+            EXPECT_LE(maxError, bound) << name << " at " << fps << " Hz display, " << rate << " Hz effect";
+            EXPECT_LE(maxError, 16) << "visible stepping";
+            EXPECT_NEAR(evalFraction, rate / fps, 0.02);
+        }
+    }
+}
+
+TEST(EffectDecimationError, RainbowWithinBoundOfFullRate)
+{
+    ExpectBoundedError(Rainbow, "rainbow");
+}
+
+TEST(EffectDecimationError, AuroraWithinBoundOfFullRate)
+{
+    ExpectBoundedError(Aurora, "aurora ");
+}
+
+TEST(EffectDecimationError, FadeIsTrackedEveryFrame)
+{
+    const auto labels = MakeLabels(4, 16);
+    ColorCache cache;
+    std::vector<std::uint32_t> full, decimated;
+    int maxAlphaError = 0;
+
+    // Fade in over half a second at 240 Hz while colors are held at 30 Hz
+    for (int f = 0; f <= 120; ++f)
+    {
+        const double time = f / 240.0;
+        const auto alpha = static_cast<std::uint8_t>(std::min(255, f * 255 / 120));
+        for (const auto& label : labels)
+        {
+            DrawEffect(cache, label, Rainbow, time, 0.0f, alpha, full);
+            DrawEffect(cache, label, Rainbow, time, 30.0f, alpha, decimated);
+            for (std::size_t i = 0; i < full.size(); ++i)
+                maxAlphaError = (std::max)(maxAlphaError, std::abs(Channel(full[i], 3) - Channel(decimated[i], 3)));
+        }
+        cache.EndFrame();
+    }
+
+    EXPECT_LE(maxAlphaError, 1);
+}
+
+// ============================================================================
+// Staggering
+// ============================================================================
+
+TEST(EffectDecimationStagger, SpreadsEvaluationsAcrossFrames)
+{
+    const auto labels = MakeLabels(64, 8);
+    ColorCache cache;
+    std::vector<std::uint32_t> out;
+    int peak = 0;
+
+    for (int f = 0; f < 480; ++f)
+    {
+        int evaluated = 0;
+        for (const auto& label : labels)
+            evaluated += DrawEffect(cache, label, Aurora, f / 240.0, 30.0f, 255, out) ? 1 : 0;
+        cache.EndFrame();
+        if (f > 0)  // first frame evaluates everything
+            peak = (std::max)(peak, evaluated);
+    }
+
+    // 64 labels * 30 Hz / 240 Hz = 8 per frame on average; unstaggered would be 64 every 8th frame
+    EXPECT_LE(peak, 20);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(EffectDecimationBench, ColorPassCostPerFrame)
+{
+    const auto labels = MakeLabels(64, 120);
+    constexpr int kFrames = 480;  // two seconds at 240 Hz
+
+    auto run = [&](float rate) {
+        ColorCache cache;
+        std::vector<std::uint32_t> out;
+        std::uint64_t sink = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int f = 0; f < kFrames; ++f)
+        {
+            for (const auto& label : labels)
+            {
+                DrawEffect(cache, label, Aurora, f / 240.0, rate, 255, out);
+                sink += out[0];
+            }
+            cache.EndFrame();
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        EXPECT_NE(sink, 0u);
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / kFrames;
+    };
+
+    const double fullUs = run(0.0f);
+    const double decimatedUs = run(30.0f);
+
+    std::printf("[ BENCH    ] 64 labels x 120 vertices at 240 Hz: full rate %.1f us/frame, 30 Hz %.1f us/frame (%.1fx)\n",
+                fullUs, decimatedUs, fullUs / decimatedUs);
+
+    EXPECT_LT(decimatedUs, fullUs);
+}
@@ -0,0 +1,602 @@
+/**
+ * Unit tests for INI-defined effect programs using Google Test.
+ *
+ * Compiles effect expressions, checks constant folding and uniform hoisting,
+ * compares batched evaluation against scalar references, and reproduces the
+ * built-in Aurora and Plasma kernels as expressions to check both the colors
+ * and the cost against headless ports of AddTextAurora and AddTextPlasma.
+ * Loads tier effects that name custom effects through Settings::Load.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "EffectProgram.h"
+#include "NoiseTables.h"
+#include "Settings.h"
+
+using EffectProgram::Compile;
+using EffectProgram::Op;
+using EffectProgram::Program;
+using EffectProgram::Uniforms;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static constexpr float kTwoPi = 6.28318530718f;
+
+static std::uint32_t Pack(float r, float g, float b, std::uint8_t a)
+{
+    auto ch = [](float v) { return static_cast<std::uint32_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return ch(r) | (ch(g) << 8) | (ch(b) << 16) | (static_cast<std::uint32_t>(a) << 24);
+}
+
+static int Channel(std::uint32_t c, int i)
+{
+    return static_cast<int>((c >> (i * 8)) & 0xFF);
+}
+
+static int ColorError(std::uint32_t a, std::uint32_t b)
+{
+    int err = 0;
+    for (int i = 0; i < 4; ++i)
+        err = (std::max)(err, std::abs(Channel(a, i) - Channel(b, i)));
+    return err;
+}
+
+static Program MustCompile(const std::string& source)
+{
+    Program p;
+    std::string error;
+    EXPECT_TRUE(Compile(source, p, &error)) << source << ": " << error;
+    return p;
+}
+
+// Text-like vertex layout: glyph quads spread over the box
+struct Vertices
+{
+    std::vector<float> u, v;
+};
+
+static Vertices MakeVertices(std::size_t count)
+{
+    Vertices out;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float quad = static_cast<float>(i / 4);
+        const float corner = static_cast<float>(i % 4);
+        out.u.push_back(std::fmod(quad * 0.0731f + (corner == 1 || corner == 2 ? 0.02f : 0.0f), 1.0f));
+        out.v.push_back(corner >= 2 ? 1.0f : 0.0f);
+    }
+    return out;
+}
+
+static std::vector<std::uint32_t> RunAll(const Program& p, const Uniforms& in, const Vertices& vtx, std::uint8_t alpha = 255)
+{
+    std::vector<std::uint32_t> out(vtx.u.size());
+    EffectProgram::Run(p, in, vtx.u.data(), vtx.v.data(), out.size(), out.data(), alpha);
+    return out;
+}
+
+static Uniforms TierColors()
+{
+    Uniforms in;
+    const float left[3] = {0.20f, 0.85f, 0.60f};
+    const float right[3] = {0.55f, 0.25f, 0.95f};
+    const float hl[3] = {1.00f, 0.95f, 0.70f};
+    std::copy(left, left + 3, in.left);
+    std::copy(right, right + 3, in.right);
+    std::copy(hl, hl + 3, in.highlight);
+    return in;
+}
+
+// ============================================================================
+// Built-in kernel ports (the color loops of TextEffects.cpp)
+// ============================================================================
+
+static std::uint32_t LerpColorU32(std::uint32_t a, std::uint32_t b, float t)
+{
+    t = std::clamp(t, 0.0f, 1.0f);
+    std::uint32_t out = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const int ca = Channel(a, i);
+        const int cb = Channel(b, i);
+        out |= static_cast<std::uint32_t>(static_cast<int>(ca + (cb - ca) * t + 0.5f)) << (i * 8);
+    }
+    return out;
+}
+
+static float SmoothStep5(float t)
+{
+    t = std::clamp(t, 0.0f, 1.0f);
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static void BuiltinAurora(const Vertices& vtx, float time, std::uint32_t colA, std::uint32_t colB,
+                          float speed, float waves, float intensity, float sway, std::uint32_t* out)
+{
+    time *= speed;
+    const std::uint32_t colMid = LerpColorU32(colA, colB, 0.5f);
+    const std::uint32_t colBright = LerpColorU32(colA, 0xFFFFFFFFu, 0.25f);
+
+    for (std::size_t i = 0; i < vtx.u.size(); ++i)
+    {
+        const float nx = vtx.u[i];
+        const float ny = vtx.v[i];
+        float wave1 = std::sin(nx * waves * kTwoPi + time * 1.2f + ny * 2.0f);
+        float wave2 = std::sin(nx * waves * 0.7f * kTwoPi - time * 0.8f + ny * 1.5f) * 0.6f;
+        float wave3 = std::sin(nx * waves * 1.3f * kTwoPi + time * 0.5f - ny * 1.0f) * 0.4f;
+        float curtain = std::sin(ny * kTwoPi * 2.0f + time * 0.7f + nx * sway * 3.0f);
+        curtain = curtain * 0.5f + 0.5f;
+        float combined = (wave1 + wave2 + wave3) / 2.0f;
+        combined = combined * 0.5f + 0.5f;
+        float shimmer = std::sin(time * 4.0f + nx * 12.0f + ny * 8.0f) * 0.5f + 0.5f;
+        shimmer = shimmer * shimmer * 0.15f;
+        float swayOffset = std::sin(ny * 3.0f + time * 1.5f) * sway;
+        float swayFactor = std::sin((nx + swayOffset) * kTwoPi * waves + time) * 0.5f + 0.5f;
+        float t = std::clamp((combined * 0.6f + curtain * 0.25f + swayFactor * 0.15f) * intensity + shimmer, 0.0f, 1.0f);
+
+        if (t < 0.4f)
+            out[i] = LerpColorU32(colA, colMid, t * 2.5f);
+        else if (t < 0.7f)
+            out[i] = LerpColorU32(colMid, colB, (t - 0.4f) * 3.33f);
+        else
+            out[i] = LerpColorU32(colB, colBright, (t - 0.7f) * 3.33f);
+    }
+}
+
+static void BuiltinPlasma(const Vertices& vtx, float time, std::uint32_t colA, std::uint32_t colB,
+                          float freq1, float freq2, float speed, std::uint32_t* out)
+{
+    time *= speed;
+    const std::uint32_t colMid = LerpColorU32(colA, colB, 0.5f);
+
+    for (std::size_t i = 0; i < vtx.u.size(); ++i)
+    {
+        const float nx = vtx.u[i];
+        const float ny = vtx.v[i];
+        float plasma = 0.0f;
+        plasma += std::sin(nx * freq1 * kTwoPi + time);
+        plasma += std::sin(ny * freq2 * kTwoPi + time * 0.7f);
+        plasma += std::sin((nx + ny) * (freq1 + freq2) * 0.5f * kTwoPi + time * 1.3f);
+        plasma += std::sin((nx - ny) * freq1 * kTwoPi + time * 0.9f) * 0.5f;
+        float cx1 = nx - 0.3f - std::sin(time * 0.3f) * 0.2f;
+        float cy1 = ny - 0.5f - std::cos(time * 0.4f) * 0.15f;
+        plasma += std::sin(std::sqrt(cx1 * cx1 + cy1 * cy1) * freq1 * kTwoPi * 2.0f - time * 1.2f);
+        float cx2 = nx - 0.7f + std::cos(time * 0.35f) * 0.15f;
+        float cy2 = ny - 0.5f + std::sin(time * 0.45f) * 0.2f;
+        plasma += std::sin(std::sqrt(cx2 * cx2 + cy2 * cy2) * freq2 * kTwoPi * 1.5f + time * 0.8f) * 0.7f;
+        plasma = SmoothStep5((plasma + 5.2f) / 10.4f);
+
+        out[i] = plasma < 0.5f ? LerpColorU32(colA, colMid, plasma * 2.0f)
+                               : LerpColorU32(colMid, colB, (plasma - 0.5f) * 2.0f);
+    }
+}
+
+// The same kernels written as INI effects (p1.. = the tier line parameters)
+static const char* kAuroraSource =
+    "T = t * p1; W = p2 * 2 * pi;"
+    "combined = (sin(u * W + (T * 1.2 + v * 2))"
+    "          + sin(u * (W * 0.7) - T * 0.8 + v * 1.5) * 0.6"
+    "          + sin(u * (W * 1.3) + T * 0.5 - v) * 0.4) * 0.25 + 0.5;"
+    "curtain = sin(v * (4 * pi) + T * 0.7 + u * (p4 * 3)) * 0.5 + 0.5;"
+    "s = sin(T * 4 + u * 12 + v * 8) * 0.5 + 0.5;"
+    "swayed = sin((u + sin(v * 3 + T * 1.5) * p4) * W + T) * 0.5 + 0.5;"
+    "k = clamp((combined * 0.6 + curtain * 0.25 + swayed * 0.15) * p3 + s * s * 0.15);"
+    "mid = mix(left, right, 0.5); bright = mix(left, rgb(1, 1, 1), 0.25);"
+    "mix(mix(mix(left, mid, clamp(k * 2.5)), right, clamp((k - 0.4) * 3.33)), bright, clamp((k - 0.7) * 3.33))";
+
+static const char* kPlasmaSource =
+    "T = t * p3; F1 = p1 * 2 * pi; F2 = p2 * 2 * pi;"
+    "x1 = u - (0.3 + sin(T * 0.3) * 0.2); y1 = v - (0.5 + cos(T * 0.4) * 0.15);"
+    "x2 = u - (0.7 - cos(T * 0.35) * 0.15); y2 = v - (0.5 - sin(T * 0.45) * 0.2);"
+    "pl = sin(u * F1 + T) + sin(v * F2 + T * 0.7)"
+    "   + sin((u + v) * ((F1 + F2) * 0.5) + T * 1.3) + sin((u - v) * F1 + T * 0.9) * 0.5"
+    "   + sin(sqrt(x1 * x1 + y1 * y1) * (F1 * 2) - T * 1.2)"
+    "   + sin(sqrt(x2 * x2 + y2 * y2) * (F2 * 1.5) + T * 0.8) * 0.7;"
+    "s = clamp((pl + 5.2) / 10.4); q = s * s * s * (s * (s * 6 - 15) + 10);"
+    "mid = mix(left, right, 0.5);"
+    "mix(mix(left, mid, clamp(q * 2)), right, clamp((q - 0.5) * 2))";
+
+static std::uint32_t ToU32(const float c[3])
+{
+    return Pack(c[0], c[1], c[2], 255);
+}
+
+// ============================================================================
+// Compilation
+// ============================================================================
+
+TEST(EffectProgramCompile, RejectsInvalidExpressions)
+{
+    const char* bad[] = {
+        "",                    // empty
+        "u +",                 // dangling operator
+        "sin(u",               // unclosed call
+        "wobble(u)",           // unknown function
+        "speed * u",           // unknown name
+        "mix(u, v)",           // wrong arity
+        "hsv(left, 1, 1)",     // color where a scalar is required
+        "u v",                 // trailing input
+        "t = u; t",            // rebinding an input
+        "1.2.3",               // malformed number
+    };
+    for (const char* source : bad)
+    {
+        Program p;
+        std::string error;
+        EXPECT_FALSE(Compile(source, p, &error)) << source;
+        EXPECT_FALSE(error.empty()) << source;
+        EXPECT_FALSE(p.Valid()) << source;
+    }
+}
+
+TEST(EffectProgramCompile, ErrorsReportColumn)
+{
+    Program p;
+    std::string error;
+    ASSERT_FALSE(Compile("mix(left, right, u * bogus)", p, &error));
+    EXPECT_NE(error.find("column 22"), std::string::npos) << error;
+    EXPECT_NE(error.find("bogus"), std::string::npos) << error;
+}
+
+TEST(EffectProgramCompile, ConstantsFoldCompletely)
+{
+    // Nothing depends on an input: no prologue, no body, just the result
+    const Program p = MustCompile("hsv(0.25 + 0.5 * 0.5, sin(pi / 2), 2 - 1)");
+    EXPECT_TRUE(p.prologue.empty());
+    EXPECT_TRUE(p.body.empty());
+    EXPECT_EQ(p.splats.size(), 3u);
+
+    const auto out = RunAll(p, Uniforms{}, MakeVertices(5));
+    for (std::uint32_t c : out)
+        EXPECT_EQ(c, Pack(0.0f, 1.0f, 1.0f, 255));  // hue 0.5 = cyan
+}
+
+TEST(EffectProgramCompile, UniformsHoistOutOfTheBatch)
+{
+    // sin(t * p1 * 3) is the same for every vertex
+    const Program p = MustCompile("mix(left, right, u * (sin(t * p1 * 3) * 0.5 + 0.5))");
+    EXPECT_EQ(p.prologue.size(), 5u);  // mul, mul, sin, mul, add
+    for (const auto& in : p.body)
+    {
+        EXPECT_NE(in.op, Op::Sin);
+        EXPECT_NE(in.op, Op::Splat);
+    }
+    // u * k, then one mix per channel
+    EXPECT_EQ(p.body.size(), 4u);
+}
+
+TEST(EffectProgramCompile, IdentitiesAndBindingsEmitNothing)
+{
+    const Program direct = MustCompile("clamp(u * 3 + v)");
+    const Program noisy = MustCompile("x = u * 1 + 0; y = x * 3; clamp(0 + y + v / 1)");
+    EXPECT_EQ(noisy.body.size(), direct.body.size());
+
+    // A binding used many times is evaluated once
+    const Program shared = MustCompile("n = noise(u * 8, v * 2); rgb(n, n * n, 1 - n)");
+    EXPECT_EQ(std::count_if(shared.body.begin(), shared.body.end(), [](const auto& in) { return in.op == Op::Noise; }), 1);
+}
+
+TEST(EffectProgramCompile, RegistersAreRecycled)
+{
+    // A long chain keeps only a handful of temporaries alive at once
+    std::string source = "u";
+    for (int i = 0; i < 200; ++i)
+        source = "sin(" + source + " * 1.01 + v)";
+    const Program p = MustCompile(source);
+    EXPECT_LE(p.registers, 8u);
+    EXPECT_GT(p.body.size(), 400u);
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+
+TEST(EffectProgramRun, ScalarResultFollowsTierGradient)
+{
+    const Program p = MustCompile("u");
+    Uniforms in = TierColors();
+    const Vertices vtx = MakeVertices(200);
+    const auto out = RunAll(p, in, vtx, 180);
+
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        float c[3];
+        for (int k = 0; k < 3; ++k)
+            c[k] = in.left[k] + (in.right[k] - in.left[k]) * vtx.u[i];
+        EXPECT_LE(ColorError(out[i], Pack(c[0], c[1], c[2], 180)), 1) << i;
+    }
+}
+
+TEST(EffectProgramRun, FunctionsMatchScalarReference)
+{
+    const Program p = MustCompile(
+        "a = noise(u * 7 + t, v * 3 - t);"
+        "b = smoothstep(0.2, 0.8, fract(u * 3 + phase));"
+        "rgb(a, b * step(0.5, v) + min(u, 0.3), max(pow(abs(u - 0.5), 2) * 4, sqrt(v) * tier))");
+
+    Uniforms in;
+    in.time = 12.75f;
+    in.phase = 0.4f;
+    in.tier = 0.6f;
+    const Vertices vtx = MakeVertices(333);
+    const auto out = RunAll(p, in, vtx);
+
+    float lo = 1.0f, hi = 0.0f;
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        const float u = vtx.u[i], v = vtx.v[i];
+        const float f = u * 3.0f + in.phase;
+        float b = std::clamp((f - std::floor(f) - 0.2f) / 0.6f, 0.0f, 1.0f);
+        b = b * b * (3.0f - 2.0f * b);
+        const float g = b * (v < 0.5f ? 0.0f : 1.0f) + std::min(u, 0.3f);
+        const float bl = std::max(std::pow(std::abs(u - 0.5f), 2.0f) * 4.0f, std::sqrt(v) * in.tier);
+        EXPECT_LE(std::abs(Channel(out[i], 1) - Channel(Pack(0, g, 0, 255), 1)), 1) << i;
+        EXPECT_LE(std::abs(Channel(out[i], 2) - Channel(Pack(0, 0, bl, 255), 2)), 1) << i;
+
+        const float a = static_cast<float>(Channel(out[i], 0)) / 255.0f;
+        lo = std::min(lo, a);
+        hi = std::max(hi, a);
+    }
+    // Value noise spans most of [0, 1)
+    EXPECT_LT(lo, 0.2f);
+    EXPECT_GT(hi, 0.8f);
+}
+
+TEST(EffectProgramRun, NoiseFunctionsSampleNoiseTables)
+{
+    const Program p = MustCompile("rgb(noise(u * 7 + t, v * 3), fbm(u * 4 - t, v * 2), 0)");
+    Uniforms in;
+    in.time = 3.5f;
+    const Vertices vtx = MakeVertices(333);
+
+    auto check = [&](int period, int tolerance) {
+        const auto out = RunAll(p, in, vtx);
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            const float u = vtx.u[i], v = vtx.v[i];
+            const float n = NoiseTables::ValueNoise(u * 7.0f + in.time, v * 3.0f, period);
+            const float f = NoiseTables::Fbm(u * 4.0f - in.time, v * 2.0f, period);
+            EXPECT_LE(std::abs(Channel(out[i], 0) - Channel(Pack(n, 0, 0, 255), 0)), tolerance) << i;
+            EXPECT_LE(std::abs(Channel(out[i], 1) - Channel(Pack(0, f, 0, 255), 1)), tolerance) << i;
+        }
+    };
+
+    // Analytic until tables are configured, then the tiled field within the table error
+    NoiseTables::Configure(0);
+    check(0, 1);
+    NoiseTables::Configure(512);
+    check(NoiseTables::kPeriod, 6);
+    NoiseTables::Configure(0);
+}
+
+TEST(EffectProgramRun, HsvMatchesHueWheel)
+{
+    const Program p = MustCompile("hsv(u, 1, 1)");
+    Vertices vtx;
+    vtx.u = {0.0f, 1.0f / 6.0f, 2.0f / 6.0f, 0.5f, 4.0f / 6.0f, 5.0f / 6.0f};
+    vtx.v.assign(vtx.u.size(), 0.0f);
+    const auto out = RunAll(p, Uniforms{}, vtx);
+
+    const std::uint32_t expected[] = {Pack(1, 0, 0, 255), Pack(1, 1, 0, 255), Pack(0, 1, 0, 255),
+                                      Pack(0, 1, 1, 255), Pack(0, 0, 1, 255), Pack(1, 0, 1, 255)};
+    for (std::size_t i = 0; i < out.size(); ++i)
+        EXPECT_LE(ColorError(out[i], expected[i]), 1) << i;
+}
+
+TEST(EffectProgramRun, BatchBoundariesDoNotMatter)
+{
+    const Program p = MustCompile(kAuroraSource);
+    Uniforms in = TierColors();
+    in.time = 3.5f;
+    in.params[0] = 0.5f;
+    in.params[1] = 3.0f;
+    in.params[2] = 1.0f;
+    in.params[3] = 0.3f;
+
+    const Vertices vtx = MakeVertices(EffectProgram::kBatch * 3 + 17);
+    const auto whole = RunAll(p, in, vtx);
+    for (std::size_t i = 0; i < vtx.u.size(); ++i)
+    {
+        std::uint32_t one = 0;
+        EffectProgram::Run(p, in, &vtx.u[i], &vtx.v[i], 1, &one, 255);
+        ASSERT_EQ(one, whole[i]) << i;
+    }
+}
+
+// ============================================================================
+// Settings
+// ============================================================================
+
+// Runs Settings::Load against an INI written to Settings::FilePath in a
+// scratch working directory
+class SettingsFile {
+public:
+    explicit SettingsFile(const std::string& text)
+    {
+        m_previous = std::filesystem::current_path();
+        m_root = std::filesystem::temp_directory_path() /
+                 ("whois_effects_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        std::filesystem::create_directories(m_root / std::filesystem::path(Settings::FilePath).parent_path());
+        std::ofstream(m_root / Settings::FilePath, std::ios::binary) << text;
+        std::filesystem::current_path(m_root);
+        Settings::Load();
+    }
+    ~SettingsFile()
+    {
+        std::error_code ec;
+        std::filesystem::current_path(m_previous, ec);
+        std::filesystem::remove_all(m_root, ec);
+    }
+
+private:
+    std::filesystem::path m_previous;
+    std::filesystem::path m_root;
+};
+
+TEST(EffectProgramSettings, TierResolvesDefinedCustomEffect)
+{
+    SettingsFile file("[Tier2]\nNameEffect = Frost\n[CustomEffects]\nFrost = mix(left, right, u)\n");
+
+    ASSERT_GT(Settings::Tiers.size(), 2u);
+    const auto& effect = Settings::Tiers[2].nameEffect;
+    EXPECT_EQ(effect.type, Settings::EffectType::Custom);
+    ASSERT_GE(effect.customEffect, 0);
+    EXPECT_EQ(Settings::CustomEffects[effect.customEffect].name, "Frost");
+    EXPECT_TRUE(Settings::UnknownEffects.empty());
+}
+
+TEST(EffectProgramSettings, UnknownCustomEffectFallsBackAndIsReported)
+{
+    SettingsFile file("[Tier3]\nTitleEffect = Frots\nLevelEffect = Broken\n"
+                      "[CustomEffects]\nFrost = mix(left, right, u)\nBroken = mix(left,\n");
+
+    ASSERT_GT(Settings::Tiers.size(), 3u);
+    EXPECT_EQ(Settings::Tiers[3].titleEffect.type, Settings::EffectType::Gradient);
+    EXPECT_EQ(Settings::Tiers[3].titleEffect.customEffect, -1);
+
+    // A typo is reported with where it was written
+    ASSERT_EQ(Settings::UnknownEffects.size(), 1u);
+    EXPECT_EQ(Settings::UnknownEffects[0].name, "Frots");
+    EXPECT_EQ(Settings::UnknownEffects[0].label, "Tier3 TitleEffect");
+
+    // A defined effect that does not compile falls back too, but is reported by its definition
+    EXPECT_EQ(Settings::Tiers[3].levelEffect.type, Settings::EffectType::Gradient);
+    bool brokenHasError = false;
+    for (const auto& def : Settings::CustomEffects)
+        brokenHasError |= def.name == "Broken" && !def.error.empty();
+    EXPECT_TRUE(brokenHasError);
+}
+
+// ============================================================================
+// Built-in kernels as expressions
+// ============================================================================
+
+TEST(EffectProgramKernels, AuroraExpressionMatchesBuiltin)
+{
+    const Program p = MustCompile(kAuroraSource);
+    Uniforms in = TierColors();
+    in.params[0] = 0.4f;
+    in.params[1] = 2.5f;
+    in.params[2] = 0.9f;
+    in.params[3] = 0.25f;
+
+    const Vertices vtx = MakeVertices(480);
+    std::vector<std::uint32_t> ref(vtx.u.size());
+    int worst = 0;
+    for (float time = 0.0f; time < 30.0f; time += 0.37f)
+    {
+        in.time = time;
+        const auto out = RunAll(p, in, vtx);
+        BuiltinAurora(vtx, time, ToU32(in.left), ToU32(in.right), 0.4f, 2.5f, 0.9f, 0.25f, ref.data());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            worst = std::max(worst, ColorError(out[i], ref[i]));
+    }
+    // The built-in lerps in 8 bits and the breakpoints differ by 0.001
+    EXPECT_LE(worst, 3);
+}
+
+TEST(EffectProgramKernels, PlasmaExpressionMatchesBuiltin)
+{
+    const Program p = MustCompile(kPlasmaSource);
+    Uniforms in = TierColors();
+    in.params[0] = 2.0f;
+    in.params[1] = 3.0f;
+    in.params[2] = 0.5f;
+
+    const Vertices vtx = MakeVertices(480);
+    std::vector<std::uint32_t> ref(vtx.u.size());
+    int worst = 0;
+    for (float time = 0.0f; time < 30.0f; time += 0.37f)
+    {
+        in.time = time;
+        const auto out = RunAll(p, in, vtx);
+        BuiltinPlasma(vtx, time, ToU32(in.left), ToU32(in.right), 2.0f, 3.0f, 0.5f, ref.data());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            worst = std::max(worst, ColorError(out[i], ref[i]));
+    }
+    EXPECT_LE(worst, 3);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+template <class F>
+static double MicrosPerFrame(int frames, F&& frame)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f)
+        frame(f);
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+}
+
+TEST(EffectProgramBench, AgainstBuiltinKernels)
+{
+    // 32 labels of ~30 glyphs, one effect pass each
+    constexpr int kLabels = 32;
+    constexpr int kFrames = 200;
+    const Vertices vtx = MakeVertices(30 * 4);
+    std::vector<std::uint32_t> out(vtx.u.size());
+    std::uint64_t sink = 0;
+
+    Uniforms in = TierColors();
+    const std::uint32_t colA = ToU32(in.left), colB = ToU32(in.right);
+
+    struct Case
+    {
+        const char* name;
+        const char* source;
+        float params[4];
+    };
+    const Case cases[] = {{"Aurora", kAuroraSource, {0.5f, 3.0f, 1.0f, 0.3f}},
+                          {"Plasma", kPlasmaSource, {2.0f, 3.0f, 0.5f, 0.0f}}};
+
+    for (const Case& c : cases)
+    {
+        const Program p = MustCompile(c.source);
+        std::copy(c.params, c.params + 4, in.params);
+        const bool aurora = c.source == kAuroraSource;
+
+        const double builtinUs = MicrosPerFrame(kFrames, [&](int f) {
+            for (int l = 0; l < kLabels; ++l)
+            {
+                const float time = static_cast<float>(f) / 144.0f + static_cast<float>(l);
+                if (aurora)
+                    BuiltinAurora(vtx, time, colA, colB, c.params[0], c.params[1], c.params[2], c.params[3], out.data());
+                else
+                    BuiltinPlasma(vtx, time, colA, colB, c.params[0], c.params[1], c.params[2], out.data());
+                sink += out[7];
+            }
+        });
+        const double programUs = MicrosPerFrame(kFrames, [&](int f) {
+            for (int l = 0; l < kLabels; ++l)
+            {
+                in.time = static_cast<float>(f) / 144.0f + static_cast<float>(l);
+                EffectProgram::Run(p, in, vtx.u.data(), vtx.v.data(), out.size(), out.data(), 255);
+                sink += out[7];
+            }
+        });
+
+        std::printf("[ BENCH    ] %s, %d labels x %zu vertices: built-in %.1f us/frame, program %.1f us/frame (%.2fx), "
+                    "%zu body ops\n",
+                    c.name, kLabels, vtx.u.size(), builtinUs, programUs, programUs / builtinUs, p.body.size());
+
+        // Within a small factor of the hand-written kernel
+        EXPECT_LT(programUs, builtinUs * 3.0);
+    }
+    EXPECT_NE(sink, 0u);
+}
@@ -0,0 +1,295 @@
+/**
+ * Unit tests for the FaceGen asset index using Google Test.
+ *
+ * Builds FaceGenIndex::Index against a generated Data directory tree and
+ * synthetic BSA archives, and checks path formatting and lookups.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FaceGenIndex.h"
+
+namespace fs = std::filesystem;
+using FaceGenIndex::Index;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+class TempDataDir {
+public:
+    TempDataDir() {
+        root = fs::temp_directory_path() /
+               ("whois_facegen_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        fs::create_directories(root);
+    }
+    ~TempDataDir() {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    void Touch(const std::string& rel) const {
+        fs::path p = root / rel;
+        fs::create_directories(p.parent_path());
+        std::ofstream(p) << "x";
+    }
+
+    fs::path root;
+};
+
+struct BsaFolder {
+    std::string name;
+    std::vector<std::string> files;
+};
+
+// Writes a minimal archive containing only the directory and name tables
+static void WriteBsa(const fs::path& path, std::uint32_t version, const std::vector<BsaFolder>& folders) {
+    std::uint32_t fileCount = 0, folderNameLen = 0, fileNameLen = 0;
+    for (const auto& f : folders) {
+        fileCount += static_cast<std::uint32_t>(f.files.size());
+        folderNameLen += static_cast<std::uint32_t>(f.name.size() + 1);
+        for (const auto& n : f.files) fileNameLen += static_cast<std::uint32_t>(n.size() + 1);
+    }
+
+    std::vector<char> out;
+    auto put = [&](const void* p, std::size_t n) {
+        const char* c = static_cast<const char*>(p);
+        out.insert(out.end(), c, c + n);
+    };
+    auto put32 = [&](std::uint32_t v) { put(&v, 4); };
+    auto put64 = [&](std::uint64_t v) { put(&v, 8); };
+
+    put("BSA\0", 4);
+    put32(version);
+    put32(36);
+    put32(0x3);  // directory + file names
+    put32(static_cast<std::uint32_t>(folders.size()));
+    put32(fileCount);
+    put32(folderNameLen);
+    put32(fileNameLen);
+    put32(0);  // file flags + padding
+
+    for (const auto& f : folders) {
+        put64(0x1234);
+        put32(static_cast<std::uint32_t>(f.files.size()));
+        if (version == 105) {
+            put32(0);
+            put64(0);
+        } else {
+            put32(0);
+        }
+    }
+    for (const auto& f : folders) {
+        const unsigned char len = static_cast<unsigned char>(f.name.size() + 1);
+        put(&len, 1);
+        put(f.name.c_str(), f.name.size() + 1);
+        for (std::size_t i = 0; i < f.files.size(); ++i) {
+            put64(0);
+            put32(0);
+            put32(0);
+        }
+    }
+    for (const auto& f : folders) {
+        for (const auto& n : f.files) put(n.c_str(), n.size() + 1);
+    }
+
+    std::ofstream(path, std::ios::binary).write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+static std::size_t BuildFrom(Index& index, const FaceGenIndex::IAssetSource& source) {
+    return index.Build({&source});
+}
+
+// ============================================================================
+// Path formatting
+// ============================================================================
+
+TEST(FaceGenIndexTest, FormatMeshPath) {
+    EXPECT_EQ(FaceGenIndex::FormatMeshPath("Skyrim.esm", 0x13BBF),
+              "meshes\\actors\\character\\facegendata\\facegeom\\Skyrim.esm\\00013BBF.nif");
+}
+
+TEST(FaceGenIndexTest, FormatTintPath) {
+    EXPECT_EQ(FaceGenIndex::FormatTintPath("My Follower.esp", 0xFEDCBA98),
+              "textures\\actors\\character\\facegendata\\facetint\\My Follower.esp\\FEDCBA98.dds");
+}
+
+// ============================================================================
+// Loose files
+// ============================================================================
+
+TEST(FaceGenIndexTest, LooseTreeIndexesMeshesAndTints) {
+    TempDataDir data;
+    data.Touch("meshes/actors/character/facegendata/facegeom/Skyrim.esm/00013BBF.nif");
+    data.Touch("textures/actors/character/facegendata/facetint/Skyrim.esm/00013BBF.dds");
+    data.Touch("meshes/actors/character/facegendata/facegeom/Follower.esp/00000D62.nif");
+    data.Touch("textures/actors/character/facegendata/facetint/TintOnly.esp/00000001.dds");
+
+    FaceGenIndex::LooseFileSource source(data.root);
+    Index index;
+    EXPECT_FALSE(index.IsReady());
+    EXPECT_EQ(BuildFrom(index, source), 4u);
+    EXPECT_TRUE(index.IsReady());
+
+    EXPECT_EQ(index.Find("Skyrim.esm", 0x13BBF), FaceGenIndex::kMesh | FaceGenIndex::kTint);
+    EXPECT_EQ(index.Find("Follower.esp", 0xD62), FaceGenIndex::kMesh);
+    EXPECT_EQ(index.Find("TintOnly.esp", 0x1), FaceGenIndex::kTint);
+    EXPECT_EQ(index.Find("Skyrim.esm", 0x13BC0), FaceGenIndex::kNone);
+    EXPECT_EQ(index.Find("Missing.esp", 0x13BBF), FaceGenIndex::kNone);
+}
+
+TEST(FaceGenIndexTest, LookupIsCaseInsensitive) {
+    TempDataDir data;
+    data.Touch("Meshes/Actors/Character/FaceGenData/FaceGeom/MyMod.ESP/0000abcd.NIF");
+
+    FaceGenIndex::LooseFileSource source(data.root);
+    Index index;
+    BuildFrom(index, source);
+    EXPECT_EQ(index.Find("mymod.esp", 0xABCD), FaceGenIndex::kMesh);
+    EXPECT_EQ(index.Find("MYMOD.ESP", 0xABCD), FaceGenIndex::kMesh);
+}
+
+TEST(FaceGenIndexTest, NonFaceGenFilesAreIgnored) {
+    TempDataDir data;
+    data.Touch("meshes/actors/character/facegendata/facegeom/Skyrim.esm/readme.txt");
+    data.Touch("meshes/actors/character/facegendata/facegeom/Skyrim.esm/123.nif");
+    data.Touch("meshes/actors/character/facegendata/facegeom/Skyrim.esm/0001234G.nif");
+    data.Touch("meshes/actors/character/facegendata/facegeom/Skyrim.esm/sub/00000001.nif");
+    data.Touch("meshes/actors/character/facegendata/facegeom/00000001.nif");
+    data.Touch("textures/actors/character/facegendata/facetint/Skyrim.esm/00000001.png");
+
+    FaceGenIndex::LooseFileSource source(data.root);
+    Index index;
+    EXPECT_EQ(BuildFrom(index, source), 0u);
+    EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST(FaceGenIndexTest, MissingDataRootFailsGracefully) {
+    FaceGenIndex::LooseFileSource source(fs::temp_directory_path() / "whois_facegen_does_not_exist");
+    Index index;
+    EXPECT_EQ(BuildFrom(index, source), 0u);
+    EXPECT_TRUE(index.IsReady());
+}
+
+// ============================================================================
+// Archives
+// ============================================================================
+
+class BsaVersionTest : public ::testing::TestWithParam<std::uint32_t> {};
+
+TEST_P(BsaVersionTest, ArchiveDirectoryIsIndexed) {
+    TempDataDir data;
+    const fs::path bsa = data.root / "Test.bsa";
+    WriteBsa(bsa, GetParam(), {
+        {"meshes\\actors\\character\\facegendata\\facegeom\\skyrim.esm", {"00013bbf.nif", "00013bc0.nif"}},
+        {"textures\\actors\\character\\facegendata\\facetint\\skyrim.esm", {"00013bbf.dds"}},
+        {"meshes\\armor\\iron", {"cuirass.nif"}},
+    });
+
+    FaceGenIndex::BsaArchiveSource source(bsa);
+    std::vector<std::string> seen;
+    ASSERT_TRUE(source.Enumerate([&](std::string_view p) { seen.emplace_back(p); }));
+    ASSERT_EQ(seen.size(), 4u);
+    EXPECT_EQ(seen[3], "meshes\\armor\\iron\\cuirass.nif");
+
+    Index index;
+    EXPECT_EQ(BuildFrom(index, source), 3u);
+    EXPECT_EQ(index.Find("Skyrim.esm", 0x13BBF), FaceGenIndex::kMesh | FaceGenIndex::kTint);
+    EXPECT_EQ(index.Find("Skyrim.esm", 0x13BC0), FaceGenIndex::kMesh);
+}
+
+INSTANTIATE_TEST_SUITE_P(Versions, BsaVersionTest, ::testing::Values(103u, 104u, 105u));
+
+TEST(FaceGenIndexTest, CorruptArchiveIsRejected) {
+    TempDataDir data;
+    const fs::path bsa = data.root / "Bad.bsa";
+    std::ofstream(bsa, std::ios::binary) << "BTDX not a bsa";
+
+    FaceGenIndex::BsaArchiveSource source(bsa);
+    EXPECT_FALSE(source.Enumerate([](std::string_view) {}));
+}
+
+TEST(FaceGenIndexTest, LooseAndArchiveSourcesMerge) {
+    TempDataDir data;
+    data.Touch("textures/actors/character/facegendata/facetint/Follower.esp/00000D62.dds");
+    const fs::path bsa = data.root / "Follower.bsa";
+    WriteBsa(bsa, 105, {{"meshes\\actors\\character\\facegendata\\facegeom\\follower.esp", {"00000d62.nif"}}});
+
+    FaceGenIndex::LooseFileSource loose(data.root);
+    FaceGenIndex::BsaArchiveSource archive(bsa);
+    Index index;
+    index.Build({&loose, &archive});
+    EXPECT_EQ(index.Find("Follower.esp", 0xD62), FaceGenIndex::kMesh | FaceGenIndex::kTint);
+}
+
+TEST(FaceGenIndexTest, OnlyMountedArchivesAreSelected) {
+    TempDataDir data;
+    const std::vector<BsaFolder> facegen = {
+        {"meshes\\actors\\character\\facegendata\\facegeom\\orphan.esp", {"00000d62.nif"}}};
+    WriteBsa(data.root / "Skyrim - Meshes0.bsa", 105, {});
+    WriteBsa(data.root / "Follower.bsa", 105, {});
+    WriteBsa(data.root / "follower - textures.bsa", 105, {});
+    WriteBsa(data.root / "Follower - Extra.bsa", 105, {});
+    WriteBsa(data.root / "Orphan.bsa", 105, facegen);
+
+    const auto mounted = FaceGenIndex::MountedArchives(data.root, {"Skyrim.esm", "Follower.esp"},
+                                                       {"Skyrim - Meshes0.bsa, Missing.bsa", "Skyrim - Meshes0.bsa"});
+    std::vector<std::string> names;
+    for (const auto& p : mounted) names.push_back(p.filename().string());
+    EXPECT_EQ(names, (std::vector<std::string>{"Skyrim - Meshes0.bsa", "Follower.bsa", "follower - textures.bsa"}));
+}
+
+TEST(FaceGenIndexTest, UnloadedArchiveIsNotIndexed) {
+    // Orphan.esp is installed but not active, so the game never opens its archive
+    TempDataDir data;
+    WriteBsa(data.root / "Orphan.bsa", 105,
+             {{"meshes\\actors\\character\\facegendata\\facegeom\\orphan.esp", {"00000d62.nif"}}});
+    WriteBsa(data.root / "Follower.bsa", 105,
+             {{"meshes\\actors\\character\\facegendata\\facegeom\\follower.esp", {"00000d62.nif"}}});
+
+    std::vector<std::unique_ptr<FaceGenIndex::BsaArchiveSource>> archives;
+    std::vector<const FaceGenIndex::IAssetSource*> sources;
+    for (const auto& path : FaceGenIndex::MountedArchives(data.root, {"Follower.esp"}, {})) {
+        archives.push_back(std::make_unique<FaceGenIndex::BsaArchiveSource>(path));
+        sources.push_back(archives.back().get());
+    }
+
+    Index index;
+    index.Build(sources);
+    EXPECT_EQ(index.Find("Follower.esp", 0xD62), FaceGenIndex::kMesh);
+    EXPECT_EQ(index.Find("Orphan.esp", 0xD62), FaceGenIndex::kNone);
+}
+
+// ============================================================================
+// Background build
+// ============================================================================
+
+TEST(FaceGenIndexTest, AsyncBuildBecomesReady) {
+    TempDataDir data;
+    for (int i = 0; i < 200; ++i) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "%08X.nif", i);
+        data.Touch(std::string("meshes/actors/character/facegendata/facegeom/Mod.esp/") + name);
+    }
+
+    Index index;
+    std::vector<std::unique_ptr<FaceGenIndex::IAssetSource>> sources;
+    sources.push_back(std::make_unique<FaceGenIndex::LooseFileSource>(data.root));
+    index.BuildAsync(std::move(sources));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!index.IsReady() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(index.IsReady());
+    EXPECT_EQ(index.Size(), 200u);
+    EXPECT_EQ(index.Find("mod.esp", 199), FaceGenIndex::kMesh);
+}
@@ -0,0 +1,404 @@
+/**
+ * Unit tests for the flat override registration storage using Google Test.
+ *
+ * Runs random edit sequences against FlatOverrideTable, FlatOverrideRegistry
+ * and FlatHandleSet side by side with the nested std containers they
+ * replace, and benchmarks applying every override of a loaded actor.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "FlatOverrideStorage.h"
+
+// ============================================================================
+// Reference model (OverrideRegistration / OverrideSet semantics)
+// ============================================================================
+
+struct RefVariant {
+    UInt16 key = 0;
+    UInt8 index = 0;
+    UInt32 data = 0;
+
+    // OverrideVariant orders and compares by key, then index
+    bool operator<(const RefVariant& rhs) const {
+        return key < rhs.key || (key == rhs.key && index < rhs.index);
+    }
+};
+
+typedef std::set<RefVariant> RefSet;
+typedef std::unordered_map<StringID, RefSet> RefNodes;
+typedef std::unordered_map<UInt64, RefNodes> RefTable;
+
+typedef std::tuple<UInt64, StringID, UInt16, UInt8, UInt32> Row;
+
+static void RefSetValue(RefTable& ref, UInt64 handle, StringID node, const RefVariant& v) {
+    RefSet& set = ref[handle][node];
+    set.erase(v);
+    set.insert(v);
+}
+
+static std::vector<Row> Flatten(const RefTable& ref) {
+    std::vector<Row> rows;
+    for (const auto& [handle, nodes] : ref)
+        for (const auto& [node, set] : nodes)
+            for (const auto& v : set) rows.emplace_back(handle, node, v.key, v.index, v.data);
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+static std::vector<Row> Flatten(FlatOverrideTable<FlatOverrideValue>& table) {
+    std::vector<Row> rows;
+    table.Visit([&](const FlatOverrideKey& k, FlatOverrideValue& v) {
+        rows.emplace_back(k.handle, k.GetNode(), k.GetKey(), k.GetIndex(), v.data.u);
+    });
+    return rows;
+}
+
+static FlatOverrideValue MakeValue(UInt32 u) {
+    FlatOverrideValue v{};
+    v.type = FlatOverrideValue::kType_Int;
+    v.data.u = u;
+    return v;
+}
+
+// ============================================================================
+// Table basics
+// ============================================================================
+
+TEST(FlatOverrideTableTest, SetFindReplace) {
+    FlatOverrideTable<FlatOverrideValue> table;
+    table.Set(1, 10, 5, 0, MakeValue(100));
+    table.Set(1, 10, 5, 0, MakeValue(200));
+    ASSERT_EQ(table.Size(), 1u);
+    ASSERT_NE(table.Find(1, 10, 5, 0), nullptr);
+    EXPECT_EQ(table.Find(1, 10, 5, 0)->data.u, 200u);
+    EXPECT_EQ(table.Find(1, 10, 5, 1), nullptr);
+    EXPECT_EQ(table.Find(2, 10, 5, 0), nullptr);
+}
+
+TEST(FlatOverrideTableTest, NodeOrderIsKeyThenIndex) {
+    FlatOverrideTable<FlatOverrideValue> table;
+    table.Set(1, 7, 9, 0, MakeValue(0));
+    table.Set(1, 7, 2, 3, MakeValue(0));
+    table.Set(1, 7, 2, 1, MakeValue(0));
+    table.Set(1, 8, 1, 0, MakeValue(0));
+
+    std::vector<std::pair<UInt16, UInt8>> order;
+    table.VisitNode(1, 7, [&](const FlatOverrideKey& k, FlatOverrideValue&) {
+        order.emplace_back(k.GetKey(), k.GetIndex());
+    });
+    const std::vector<std::pair<UInt16, UInt8>> expected = {{2, 1}, {2, 3}, {9, 0}};
+    EXPECT_EQ(order, expected);
+}
+
+TEST(FlatOverrideTableTest, KeyFieldsRoundTrip) {
+    FlatOverrideKey k = FlatOverrideKey::Make(0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFE, 0xFFFF, 0xFF);
+    EXPECT_EQ(k.GetNode(), 0xFFFFFFFEu);
+    EXPECT_EQ(k.GetKey(), 0xFFFF);
+    EXPECT_EQ(k.GetIndex(), 0xFF);
+}
+
+TEST(FlatOverrideTableTest, EraseNodeAndHandle) {
+    FlatOverrideTable<FlatOverrideValue> table;
+    for (UInt64 h = 1; h <= 3; ++h)
+        for (StringID n = 0; n < 4; ++n)
+            for (UInt16 key = 0; key < 5; ++key) table.Set(h, n, key, 0, MakeValue(key));
+
+    EXPECT_EQ(table.EraseNode(2, 1), 5u);
+    EXPECT_EQ(table.EraseNode(2, 1), 0u);
+    EXPECT_EQ(table.EraseHandle(3), 20u);
+    EXPECT_FALSE(table.HasHandle(3));
+    EXPECT_TRUE(table.HasHandle(2));
+    EXPECT_EQ(table.Size(), 20u + 15u);
+}
+
+TEST(FlatOverrideTableTest, EraseMatchingDropsAllAddonsOfArmor) {
+    FlatOverrideTable<FlatOverrideValue> table;
+    auto armorAddon = [](UInt32 armor, UInt32 addon) { return (static_cast<UInt64>(armor) << 32) | addon; };
+    table.Set(armorAddon(0xA, 1), 0, 0, 0, MakeValue(1));
+    table.Set(armorAddon(0xA, 2), 0, 0, 0, MakeValue(2));
+    table.Set(armorAddon(0xB, 1), 0, 0, 0, MakeValue(3));
+
+    EXPECT_EQ(table.EraseMatching(armorAddon(0xA, 0), 0xFFFFFFFF00000000ull), 2u);
+    ASSERT_EQ(table.Size(), 1u);
+    EXPECT_NE(table.Find(armorAddon(0xB, 1), 0, 0, 0), nullptr);
+}
+
+TEST(FlatOverrideTableTest, ClearKeepsBlock) {
+    FlatOverrideTable<FlatOverrideValue> table;
+    for (UInt16 key = 0; key < 100; ++key) table.Set(1, 0, key, 0, MakeValue(key));
+    const size_t capacity = table.Capacity();
+    table.Clear();
+    EXPECT_TRUE(table.Empty());
+    EXPECT_EQ(table.Capacity(), capacity);
+    EXPECT_EQ(table.Find(1, 0, 5, 0), nullptr);
+}
+
+// ============================================================================
+// Differential tests against the nested containers
+// ============================================================================
+
+TEST(FlatOverrideDifferential, RandomEditsMatchNestedContainers) {
+    std::mt19937 rng(2024);
+    for (int round = 0; round < 20; ++round) {
+        FlatOverrideTable<FlatOverrideValue> table;
+        RefTable ref;
+
+        for (int op = 0; op < 3000; ++op) {
+            const UInt64 handle = rng() % 6;
+            const StringID node = rng() % 8;
+            const UInt16 key = static_cast<UInt16>(rng() % 12);
+            const UInt8 index = static_cast<UInt8>(rng() % 3);
+            const UInt32 roll = rng() % 100;
+
+            if (roll < 60) {
+                const UInt32 data = rng();
+                table.Set(handle, node, key, index, MakeValue(data));
+                RefSetValue(ref, handle, node, {key, index, data});
+            } else if (roll < 80) {
+                const bool erased = table.Erase(handle, node, key, index);
+                size_t refErased = 0;
+                auto h = ref.find(handle);
+                if (h != ref.end()) {
+                    auto n = h->second.find(node);
+                    if (n != h->second.end()) refErased = n->second.erase({key, index, 0});
+                }
+                ASSERT_EQ(erased, refErased == 1);
+            } else if (roll < 90) {
+                const size_t erased = table.EraseNode(handle, node);
+                size_t refErased = 0;
+                auto h = ref.find(handle);
+                if (h != ref.end()) {
+                    auto n = h->second.find(node);
+                    if (n != h->second.end()) {
+                        refErased = n->second.size();
+                        h->second.erase(n);
+                    }
+                }
+                ASSERT_EQ(erased, refErased);
+            } else if (roll < 98) {
+                const size_t erased = table.EraseHandle(handle);
+                size_t refErased = 0;
+                auto h = ref.find(handle);
+                if (h != ref.end()) {
+                    for (const auto& [n, set] : h->second) refErased += set.size();
+                    ref.erase(h);
+                }
+                ASSERT_EQ(erased, refErased);
+            } else {
+                table.Clear();
+                ref.clear();
+            }
+
+            // Point lookups agree after every edit
+            for (int probe = 0; probe < 4; ++probe) {
+                const UInt64 ph = rng() % 6;
+                const StringID pn = rng() % 8;
+                const UInt16 pk = static_cast<UInt16>(rng() % 12);
+                const UInt8 pi = static_cast<UInt8>(rng() % 3);
+                const FlatOverrideValue* found = table.Find(ph, pn, pk, pi);
+                const RefVariant* expected = nullptr;
+                auto h = ref.find(ph);
+                if (h != ref.end()) {
+                    auto n = h->second.find(pn);
+                    if (n != h->second.end()) {
+                        auto v = n->second.find({pk, pi, 0});
+                        if (v != n->second.end()) expected = &*v;
+                    }
+                }
+                ASSERT_EQ(found != nullptr, expected != nullptr);
+                if (found) {
+                    ASSERT_EQ(found->data.u, expected->data);
+                }
+            }
+        }
+
+        ASSERT_EQ(Flatten(table), Flatten(ref));
+
+        // Per-node iteration order matches std::set order
+        for (const auto& [handle, nodes] : ref) {
+            for (const auto& [node, set] : nodes) {
+                std::vector<UInt32> flatOrder, refOrder;
+                table.VisitNode(handle, node, [&](const FlatOverrideKey&, FlatOverrideValue& v) {
+                    flatOrder.push_back(v.data.u);
+                });
+                for (const auto& v : set) refOrder.push_back(v.data);
+                ASSERT_EQ(flatOrder, refOrder);
+            }
+        }
+    }
+}
+
+TEST(FlatOverrideDifferential, RegistryReleaseMatchesMapErase) {
+    std::mt19937 rng(77);
+    FlatOverrideRegistry<FlatOverrideValue> registry;
+    std::unordered_map<UInt32, UInt32> ref;  // actor -> value count
+
+    for (int op = 0; op < 5000; ++op) {
+        const UInt32 actor = 0x14 + rng() % 40;
+        if (rng() % 3) {
+            FlatOverrideTable<FlatOverrideValue>& table = registry.Get(actor);
+            const UInt16 key = static_cast<UInt16>(table.Size());
+            table.Set(1, 0, key, 0, MakeValue(actor));
+            ref[actor]++;
+        } else {
+            ASSERT_EQ(registry.Release(actor), ref.erase(actor) == 1);
+        }
+    }
+
+    ASSERT_EQ(registry.Size(), ref.size());
+    registry.Visit([&](UInt32 actor, FlatOverrideTable<FlatOverrideValue>& table) {
+        ASSERT_EQ(table.Size(), ref[actor]);
+        table.Visit([&](const FlatOverrideKey&, FlatOverrideValue& v) { EXPECT_EQ(v.data.u, actor); });
+    });
+    for (UInt32 actor = 0; actor < 0x14 + 40; ++actor)
+        EXPECT_EQ(registry.Find(actor) != nullptr, ref.count(actor) == 1);
+}
+
+TEST(FlatOverrideDifferential, HandleSetMatchesUnorderedSet) {
+    std::mt19937 rng(5);
+    FlatHandleSet set;
+    std::unordered_set<UInt32> ref;
+
+    for (int op = 0; op < 20000; ++op) {
+        const UInt32 id = rng() % 500;
+        switch (rng() % 3) {
+        case 0:
+            ASSERT_EQ(set.insert(id).second, ref.insert(id).second);
+            break;
+        case 1:
+            ASSERT_EQ(set.erase(id), ref.erase(id));
+            break;
+        default:
+            ASSERT_EQ(set.find(id) != set.end(), ref.find(id) != ref.end());
+            break;
+        }
+    }
+
+    ASSERT_EQ(set.size(), ref.size());
+    std::vector<UInt32> a(set.begin(), set.end()), b(ref.begin(), ref.end());
+    std::sort(b.begin(), b.end());
+    EXPECT_EQ(a, b);
+    EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+}
+
+// ============================================================================
+// Apply-all-overrides benchmark
+// ============================================================================
+
+// Mirrors ArmorRegistration -> AddonRegistration -> OverrideRegistration<StringTableItem> -> OverrideSet
+struct LegacyVariant {
+    UInt16 key = 0;
+    UInt8 index = 0;
+    UInt8 type = 0;
+    UInt32 data = 0;
+    std::shared_ptr<std::string> str;
+    bool operator<(const LegacyVariant& rhs) const {
+        return key < rhs.key || (key == rhs.key && index < rhs.index);
+    }
+};
+
+struct NodeNameHash {
+    size_t operator()(const std::shared_ptr<std::string>& s) const { return std::hash<std::string>()(*s); }
+};
+struct NodeNameEq {
+    bool operator()(const std::shared_ptr<std::string>& a, const std::shared_ptr<std::string>& b) const {
+        return *a == *b;
+    }
+};
+
+typedef std::unordered_map<std::shared_ptr<std::string>, std::set<LegacyVariant>, NodeNameHash, NodeNameEq> LegacyNodes;
+typedef std::unordered_map<UInt32, LegacyNodes> LegacyAddons;
+typedef std::unordered_map<UInt32, LegacyAddons> LegacyArmors;
+
+TEST(FlatOverrideBenchmark, ApplyAllOverridesForActor) {
+    // A crowded cell of dressed NPCs with texture and shader overrides on
+    // each worn addon: 300 actors x 10 armors x 2 addons x 6 nodes x 6 values
+    constexpr UInt32 kActors = 300, kArmors = 10, kAddons = 2, kNodes = 6, kValues = 6;
+    constexpr int kPasses = 20;
+
+    std::vector<std::shared_ptr<std::string>> names;
+    for (UInt32 n = 0; n < kNodes * kArmors; ++n)
+        names.push_back(std::make_shared<std::string>("NPC Node [" + std::to_string(n) + "]"));
+
+    std::unordered_map<UInt32, LegacyArmors> legacy;
+    FlatOverrideRegistry<FlatOverrideValue> flat;
+    std::mt19937 rng(3);
+    for (UInt32 a = 0; a < kActors; ++a) {
+        const UInt32 actor = 0xFF000000 + a;
+        FlatOverrideTable<FlatOverrideValue>& table = flat.Get(actor);
+        for (UInt32 r = 0; r < kArmors; ++r) {
+            const UInt32 armor = 0x12000 + r * 17 + a % 5;
+            for (UInt32 d = 0; d < kAddons; ++d) {
+                const UInt32 addon = armor + 0x100000 + d;
+                for (UInt32 n = 0; n < kNodes; ++n) {
+                    const StringID node = r * kNodes + n;
+                    for (UInt32 v = 0; v < kValues; ++v) {
+                        const UInt32 data = rng();
+                        LegacyVariant lv;
+                        lv.key = static_cast<UInt16>(v);
+                        lv.type = FlatOverrideValue::kType_Int;
+                        lv.data = data;
+                        legacy[actor][armor][addon][names[node]].insert(lv);
+                        table.Set((static_cast<UInt64>(armor) << 32) | addon, node, static_cast<UInt16>(v), 0, MakeValue(data));
+                    }
+                }
+            }
+        }
+    }
+
+    // Worn list per actor, looked up the way ApplyOverrides is called per addon
+    std::vector<std::vector<std::pair<UInt32, UInt32>>> worn(kActors);
+    for (UInt32 a = 0; a < kActors; ++a)
+        for (UInt32 r = 0; r < kArmors; ++r)
+            for (UInt32 d = 0; d < kAddons; ++d) {
+                const UInt32 armor = 0x12000 + r * 17 + a % 5;
+                worn[a].emplace_back(armor, armor + 0x100000 + d);
+            }
+
+    UInt64 legacySum = 0, flatSum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        for (UInt32 a = 0; a < kActors; ++a) {
+            auto actorIt = legacy.find(0xFF000000 + a);
+            for (const auto& [armor, addon] : worn[a]) {
+                auto armorIt = actorIt->second.find(armor);
+                if (armorIt == actorIt->second.end()) continue;
+                auto addonIt = armorIt->second.find(addon);
+                if (addonIt == armorIt->second.end()) continue;
+                for (const auto& [node, set] : addonIt->second)
+                    for (const auto& v : set) legacySum += v.data;
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        for (UInt32 a = 0; a < kActors; ++a) {
+            FlatOverrideTable<FlatOverrideValue>* table = flat.Find(0xFF000000 + a);
+            for (const auto& [armor, addon] : worn[a]) {
+                table->VisitHandle((static_cast<UInt64>(armor) << 32) | addon,
+                                   [&](const FlatOverrideKey&, FlatOverrideValue& v) { flatSum += v.data.u; });
+            }
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    const double legacyUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / (kPasses * kActors);
+    const double flatUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / (kPasses * kActors);
+    std::printf("[ BENCH    ] %u values/actor: nested %.2f us/actor, flat %.2f us/actor\n",
+                kArmors * kAddons * kNodes * kValues, legacyUs, flatUs);
+
+    EXPECT_EQ(legacySum, flatSum);
+    EXPECT_LT(flatUs, legacyUs);
+}
@@ -0,0 +1,237 @@
+/**
+ * Unit tests for the alpha-only font atlas using Google Test.
+ *
+ * Builds a synthetic glyph coverage atlas both as Alpha8 and as the RGBA32
+ * expansion ImGui produces (white plus coverage), then checks that every
+ * mip level carries identical coverage at a quarter of the bytes.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "FontAtlas.h"
+
+using FontAtlas::BytesPerPixel;
+using FontAtlas::ChooseFormat;
+using FontAtlas::Format;
+using FontAtlas::Image;
+using FontAtlas::MipCount;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Anti-aliased rings and bars, roughly what rasterized glyphs look like
+static std::vector<std::uint8_t> GlyphCoverage(int width, int height, int cell)
+{
+    std::vector<std::uint8_t> alpha(static_cast<std::size_t>(width) * height, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const int cx = x / cell, cy = y / cell;
+            const float fx = (x % cell + 0.5f) / cell - 0.5f;
+            const float fy = (y % cell + 0.5f) / cell - 0.5f;
+
+            float d;
+            if ((cx + cy) % 3 == 0)
+                d = std::abs(std::sqrt(fx * fx + fy * fy) - 0.3f) - 0.08f;  // "o"
+            else if ((cx + cy) % 3 == 1)
+                d = std::abs(fx) - 0.07f;                                    // "l"
+            else
+                d = std::max(std::abs(fx + fy * 0.4f) - 0.06f, std::abs(fy) - 0.35f);  // "/"
+
+            const float c = std::clamp(0.5f - d * cell, 0.0f, 1.0f);
+            alpha[static_cast<std::size_t>(y) * width + x] = static_cast<std::uint8_t>(c * 255.0f + 0.5f);
+        }
+    }
+    return alpha;
+}
+
+// What ImFontAtlas::GetTexDataAsRGBA32 makes of an Alpha8 atlas
+static std::vector<std::uint8_t> ExpandToRGBA(const std::vector<std::uint8_t>& alpha)
+{
+    std::vector<std::uint8_t> rgba(alpha.size() * 4);
+    for (std::size_t i = 0; i < alpha.size(); ++i)
+    {
+        rgba[i * 4 + 0] = 255;
+        rgba[i * 4 + 1] = 255;
+        rgba[i * 4 + 2] = 255;
+        rgba[i * 4 + 3] = alpha[i];
+    }
+    return rgba;
+}
+
+// Number of texels whose coverage differs between two images at any level
+static std::size_t CoverageMismatches(const Image& a, const Image& b)
+{
+    std::size_t mismatches = 0;
+    for (std::size_t l = 0; l < a.levels.size(); ++l)
+    {
+        for (int y = 0; y < a.levels[l].height; ++y)
+            for (int x = 0; x < a.levels[l].width; ++x)
+                if (a.Coverage(l, x, y) != b.Coverage(l, x, y))
+                    ++mismatches;
+    }
+    return mismatches;
+}
+
+// ============================================================================
+// Format selection
+// ============================================================================
+
+TEST(FontAtlasFormat, BytesPerPixel)
+{
+    EXPECT_EQ(BytesPerPixel(Format::Alpha8), 1);
+    EXPECT_EQ(BytesPerPixel(Format::RGBA32), 4);
+}
+
+TEST(FontAtlasFormat, CoverageOnlyUsesAlpha8)
+{
+    EXPECT_EQ(ChooseFormat(false, true), Format::Alpha8);
+}
+
+TEST(FontAtlasFormat, ColorPixelsFallBackToRGBA)
+{
+    EXPECT_EQ(ChooseFormat(true, true), Format::RGBA32);
+}
+
+TEST(FontAtlasFormat, MissingShaderFallsBackToRGBA)
+{
+    EXPECT_EQ(ChooseFormat(false, false), Format::RGBA32);
+    EXPECT_EQ(ChooseFormat(true, false), Format::RGBA32);
+}
+
+// ============================================================================
+// Mip chain
+// ============================================================================
+
+TEST(FontAtlasMips, MipCount)
+{
+    EXPECT_EQ(MipCount(1, 1), 1);
+    EXPECT_EQ(MipCount(2, 1), 2);
+    EXPECT_EQ(MipCount(4096, 4096), 13);
+    EXPECT_EQ(MipCount(4096, 2048), 13);
+    EXPECT_EQ(MipCount(1000, 37), 10);
+}
+
+TEST(FontAtlasMips, EmptyInputBuildsNothing)
+{
+    const std::uint8_t texel = 0;
+    EXPECT_TRUE(FontAtlas::Build(nullptr, 16, 16, Format::Alpha8).Empty());
+    EXPECT_TRUE(FontAtlas::Build(&texel, 0, 16, Format::Alpha8).Empty());
+    EXPECT_TRUE(FontAtlas::Build(&texel, 16, -1, Format::RGBA32).Empty());
+}
+
+TEST(FontAtlasMips, LevelsArePackedAndHalved)
+{
+    const auto alpha = GlyphCoverage(1000, 37, 16);
+    const Image image = FontAtlas::Build(alpha.data(), 1000, 37, Format::Alpha8);
+
+    ASSERT_EQ(image.levels.size(), 10u);
+    std::size_t offset = 0;
+    int w = 1000, h = 37;
+    for (const auto& level : image.levels)
+    {
+        EXPECT_EQ(level.width, w);
+        EXPECT_EQ(level.height, h);
+        EXPECT_EQ(level.offset, offset);
+        EXPECT_EQ(level.RowPitch(Format::Alpha8), w);
+        offset += static_cast<std::size_t>(w) * h;
+        w = std::max(w / 2, 1);
+        h = std::max(h / 2, 1);
+    }
+    EXPECT_EQ(image.ByteSize(), offset);
+    EXPECT_EQ(image.levels.back().width, 1);
+    EXPECT_EQ(image.levels.back().height, 1);
+}
+
+TEST(FontAtlasMips, LevelZeroIsTheSource)
+{
+    const auto alpha = GlyphCoverage(256, 128, 32);
+    const Image image = FontAtlas::Build(alpha.data(), 256, 128, Format::Alpha8);
+    EXPECT_TRUE(std::equal(alpha.begin(), alpha.end(), image.Data(0)));
+}
+
+TEST(FontAtlasMips, BoxFilterRoundsToNearest)
+{
+    const std::uint8_t texels[] = {0, 255, 255, 255, 1, 2};
+    const Image image = FontAtlas::Build(texels, 2, 3, Format::Alpha8);
+
+    // 2x3 -> 1x1: only rows 0 and 1 feed the single texel
+    ASSERT_EQ(image.levels.size(), 2u);
+    EXPECT_EQ(image.levels[1].width, 1);
+    EXPECT_EQ(image.levels[1].height, 1);
+    EXPECT_EQ(image.Coverage(1, 0, 0), 191);  // (765 + 2) / 4
+}
+
+TEST(FontAtlasMips, OddEdgesClamp)
+{
+    // 3x1 -> 1x1 averages texels 0 and 1 of both (clamped) rows
+    const std::uint8_t texels[] = {100, 200, 7};
+    const Image image = FontAtlas::Build(texels, 3, 1, Format::Alpha8);
+    ASSERT_EQ(image.levels.size(), 2u);
+    EXPECT_EQ(image.Coverage(1, 0, 0), 150);
+}
+
+TEST(FontAtlasMips, UniformCoverageStaysUniform)
+{
+    const std::vector<std::uint8_t> alpha(300 * 200, 173);
+    const Image image = FontAtlas::Build(alpha.data(), 300, 200, Format::Alpha8);
+    for (std::size_t l = 0; l < image.levels.size(); ++l)
+        for (int y = 0; y < image.levels[l].height; ++y)
+            for (int x = 0; x < image.levels[l].width; ++x)
+                ASSERT_EQ(image.Coverage(l, x, y), 173) << "level " << l;
+}
+
+// ============================================================================
+// Alpha8 against RGBA32
+// ============================================================================
+
+class FontAtlasBothWays : public ::testing::TestWithParam<std::pair<int, int>>
+{
+};
+
+TEST_P(FontAtlasBothWays, IdenticalCoverageAtQuarterBytes)
+{
+    const auto [width, height] = GetParam();
+    const auto alpha = GlyphCoverage(width, height, 48);
+    const auto rgba = ExpandToRGBA(alpha);
+
+    const Image a8 = FontAtlas::Build(alpha.data(), width, height, Format::Alpha8);
+    const Image rgba32 = FontAtlas::Build(rgba.data(), width, height, Format::RGBA32);
+
+    ASSERT_EQ(a8.levels.size(), rgba32.levels.size());
+    for (std::size_t l = 0; l < a8.levels.size(); ++l)
+    {
+        EXPECT_EQ(a8.levels[l].width, rgba32.levels[l].width);
+        EXPECT_EQ(a8.levels[l].height, rgba32.levels[l].height);
+        EXPECT_EQ(a8.levels[l].RowPitch(Format::Alpha8) * 4, rgba32.levels[l].RowPitch(Format::RGBA32));
+    }
+
+    EXPECT_EQ(CoverageMismatches(a8, rgba32), 0u);
+    EXPECT_EQ(a8.ByteSize() * 4, rgba32.ByteSize());
+
+    // The expanded color stays white all the way down the chain
+    for (std::size_t l = 0; l < rgba32.levels.size(); ++l)
+    {
+        const std::uint8_t* p = rgba32.Data(l);
+        const std::size_t texels = static_cast<std::size_t>(rgba32.levels[l].width) * rgba32.levels[l].height;
+        for (std::size_t i = 0; i < texels; ++i)
+            ASSERT_TRUE(p[i * 4] == 255 && p[i * 4 + 1] == 255 && p[i * 4 + 2] == 255) << "level " << l;
+    }
+
+    std::printf("  [atlas %dx%d] Alpha8 %zu KB, RGBA32 %zu KB, %zu mips\n",
+                width, height, a8.ByteSize() / 1024, rgba32.ByteSize() / 1024, a8.levels.size());
+}
+
+// Shipped fonts at 4x oversampling land in 4096-wide atlases; odd sizes check the clamped edges
+INSTANTIATE_TEST_SUITE_P(Sizes, FontAtlasBothWays,
+                         ::testing::Values(std::make_pair(4096, 2048),
+                                           std::make_pair(2048, 2048),
+                                           std::make_pair(1021, 333),
+                                           std::make_pair(1, 1)));
@@ -0,0 +1,515 @@
+/**
+ * Allocation-counting tests for the overlay frame using Google Test.
+ *
+ * Replaces the global allocator of this test binary with a counting one and
+ * drives the headless pieces of a label frame (snapshot deltas, label text,
+ * instancing, decimated colors, typewriter mask, pipelined frame buffers)
+ * the way Renderer does. After warm-up a frame with the same actor set must
+ * not allocate.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "EffectDecimation.h"
+#include "FrameAllocations.h"
+#include "FramePipeline.h"
+#include "LabelInstancing.h"
+#include "LabelText.h"
+#include "SnapshotDelta.h"
+#include "TypewriterMask.h"
+
+// ============================================================================
+// Counting allocator
+// ============================================================================
+
+static std::atomic<std::uint64_t> g_allocations{0};
+
+// Every form of new and delete below goes through this pair, so any delete
+// may free what any new returned
+static void* Allocate(std::size_t size, std::size_t alignment) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    alignment = std::max<std::size_t>(alignment, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    size = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    return std::aligned_alloc(alignment, size);
+#endif
+}
+
+static void Release(void* p) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+static void* AllocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    if (void* p = Allocate(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) { return AllocateOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return AllocateOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { Release(p); }
+void operator delete[](void* p) noexcept { Release(p); }
+void operator delete(void* p, std::size_t) noexcept { Release(p); }
+void operator delete[](void* p, std::size_t) noexcept { Release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { Release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { Release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { Release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { Release(p); }
+
+static std::uint64_t Allocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Headless label frame
+// ============================================================================
+
+struct Vec2
+{
+    float x, y;
+};
+
+// Same layout as ImDrawVert
+struct Vertex
+{
+    Vec2 pos;
+    Vec2 uv;
+    std::uint32_t col;
+};
+
+struct Segment
+{
+    const char* format;
+    bool isLevel;
+};
+
+// Render-thread view of one actor, as Renderer's ActorDrawData
+struct ViewActor
+{
+    std::uint32_t formID{0};
+    std::string name;
+    std::uint16_t level{0};
+    float x{0.0f}, y{0.0f};
+};
+
+static const char* const kNames[] = {
+    "Whiterun Guard", "Whiterun Guard", "Whiterun Guard", "Lydia", "Farengar Secret-Fire",
+    "Bandit Marauder", "Bandit Marauder", "Nazeem", "Adrianne Avenicci", "Ysolda",
+    "Heimskr", "Brenuin", "Jarl Balgruuf the Greater", "Irileth", "Proventus Avenicci",
+    "Whiterun Guard", "Belethor", "Carlotta Valentia", "Mikael", "Uthgerd the Unbroken",
+};
+
+static const char* const kKeywords[] = {"balgruuf", "marauder", "secret"};
+
+class LabelFrameHarness
+{
+public:
+    explicit LabelFrameHarness(std::size_t actors)
+    {
+        for (std::size_t i = 0; i < actors; ++i)
+            AddActor(kNames[i % std::size(kNames)]);
+    }
+
+    void AddActor(const char* name)
+    {
+        SnapshotDelta::ActorState a;
+        a.formID = 0x00013B00u + static_cast<std::uint32_t>(m_game.size());
+        a.SetName(name);
+        a.level = static_cast<std::uint16_t>(5 + std::strlen(name) * 3);  // same name, same level
+        a.pos[0] = static_cast<float>(m_game.size()) * 160.0f;
+        a.pos[1] = 400.0f;
+        a.distToPlayer = 500.0f + static_cast<float>(m_game.size()) * 40.0f;
+        m_game.push_back(a);
+    }
+
+    /// One game update plus one render frame; returns the allocations it made.
+    std::uint64_t Frame(FrameAllocations::Meter& meter)
+    {
+        meter.BeginFrame(Allocations());
+        RunFrame();
+        return meter.EndFrame(Allocations());
+    }
+
+    std::size_t Vertices() const { return m_frame.vertices.size(); }
+    const LabelInstancing::Registry& Instances() const { return m_instances; }
+
+private:
+    void RunFrame()
+    {
+        ++m_serial;
+        const double time = static_cast<double>(m_serial) / 144.0;
+
+        // Game thread: actors drift, distances change
+        for (auto& a : m_game)
+        {
+            a.pos[0] += 0.75f;
+            a.distToPlayer += 0.5f;
+        }
+        m_channel.Publish(m_game.data(), m_game.size());
+
+        // Render thread: apply deltas and refresh the view in place
+        if (m_channel.Consume(m_mirror) > 0)
+        {
+            const auto& actors = m_mirror.Actors();
+            m_view.resize(actors.size());
+            for (std::size_t i = 0; i < actors.size(); ++i)
+            {
+                m_view[i].formID = actors[i].formID;
+                m_view[i].name.assign(actors[i].name, actors[i].nameLength);
+                m_view[i].level = actors[i].level;
+                m_view[i].x = actors[i].pos[0];
+                m_view[i].y = actors[i].pos[1];
+            }
+        }
+
+        m_vtx.clear();
+        m_idx.clear();
+        m_instances.BeginFrame();
+        for (const auto& d : m_view)
+            DrawLabel(d, time);
+        m_colors.EndFrame();
+
+        CopyFrame();
+    }
+
+    void DrawLabel(const ViewActor& d, double time)
+    {
+        // Special title: highest priority keyword match
+        int special = -1;
+        for (int i = 0; i < static_cast<int>(std::size(kKeywords)); ++i)
+        {
+            if (special < 0 && LabelText::ContainsNoCase(d.name, kKeywords[i]))
+                special = i;
+        }
+
+        static const Segment kFormat[] = {{"%n", false}, {" Lv.%l", true}};
+        m_segments.resize(std::size(kFormat));
+        LabelInstancing::KeyBuilder key;
+        for (std::size_t i = 0; i < std::size(kFormat); ++i)
+        {
+            LabelText::Format(m_segments[i], kFormat[i].format, d.name, d.level);
+            key.Add(std::string_view(m_segments[i])).Add(kFormat[i].isLevel);
+        }
+        LabelText::Format(m_title, "%t of %n", d.name, d.level, special >= 0 ? "the Legend" : "Adept");
+        key.Add(std::string_view(m_title));
+
+        const float scale = 0.8f;
+        const float alpha = 0.9f;
+        const std::uint64_t k = key.Value();
+        if (const auto* tpl = m_instances.Find(k); tpl && LabelInstancing::CanInstance(*tpl, alpha))
+        {
+            const std::size_t v0 = m_vtx.size(), i0 = m_idx.size();
+            m_vtx.resize(v0 + tpl->vtxCount);
+            m_idx.resize(i0 + tpl->idxCount);
+            LabelInstancing::CopyVertices(m_vtx.data() + tpl->vtxStart, m_vtx.data() + v0, tpl->vtxCount,
+                                          LabelInstancing::MakeTransform(*tpl, d.x, d.y, scale, alpha));
+            LabelInstancing::CopyIndices(m_idx.data() + tpl->idxStart, m_idx.data() + i0, tpl->idxCount,
+                                         tpl->idxBase, static_cast<std::uint32_t>(v0));
+            m_instances.CountInstance();
+            return;
+        }
+
+        LabelInstancing::Template tpl;
+        tpl.vtxStart = tpl.idxBase = static_cast<std::uint32_t>(m_vtx.size());
+        tpl.idxStart = static_cast<std::uint32_t>(m_idx.size());
+
+        std::uint32_t slot = 0;
+        float y = d.y;
+        for (const std::string* text : {&m_title, &m_segments[0], &m_segments[1]})
+        {
+            AddText(*text, d.x, y, scale, alpha, d.formID, slot++, time);
+            y += 40.0f * scale;
+        }
+
+        tpl.vtxCount = static_cast<std::uint32_t>(m_vtx.size()) - tpl.vtxStart;
+        tpl.idxCount = static_cast<std::uint32_t>(m_idx.size()) - tpl.idxStart;
+        tpl.anchorX = d.x;
+        tpl.anchorY = d.y;
+        tpl.scale = scale;
+        tpl.alpha = alpha;
+        m_instances.Add(k, tpl);
+    }
+
+    // Outline and fill passes, then decimated effect colors and the typewriter mask
+    void AddText(const std::string& text, float x, float y, float scale, float alpha,
+                 std::uint32_t label, std::uint32_t slot, double time)
+    {
+        const std::size_t start = m_vtx.size();
+        m_glyphs.Clear();
+        for (int pass = 0; pass < 5; ++pass)
+        {
+            const float ox = (pass == 1) - (pass == 2) * 1.0f;
+            const float oy = (pass == 3) - (pass == 4) * 1.0f;
+            float cx = x + ox;
+            for (unsigned char c : text)
+            {
+                const float adv = (20.0f + static_cast<float>(c % 7)) * scale;
+                if (pass == 0)
+                    m_glyphs.AddChar(adv, c != ' ', static_cast<float>(c) / 256.0f, 0.0f);
+                if (c != ' ')
+                {
+                    const auto base = static_cast<std::uint16_t>(m_vtx.size());
+                    const float u = static_cast<float>(c) / 256.0f;
+                    m_vtx.push_back({{cx, y + oy}, {u, 0.0f}, 0xFF000000u});
+                    m_vtx.push_back({{cx + adv, y + oy}, {u, 0.0f}, 0xFF000000u});
+                    m_vtx.push_back({{cx + adv, y + oy + 30.0f}, {u, 0.0f}, 0xFF000000u});
+                    m_vtx.push_back({{cx, y + oy + 30.0f}, {u, 0.0f}, 0xFF000000u});
+                    for (int i : {0, 1, 2, 0, 2, 3})
+                        m_idx.push_back(static_cast<std::uint16_t>(base + i));
+                }
+                cx += adv;
+            }
+        }
+
+        // Shimmer colors at a capped rate, as TextEffects' DecimatedColors
+        const std::uint32_t count = static_cast<std::uint32_t>(m_vtx.size() - start);
+        const EffectDecimation::Shape shape{count, 200.0f, 30.0f};
+        const auto key = EffectDecimation::MakeKey(label, slot, EffectDecimation::EffectClass::Shimmer);
+        const auto bucket = EffectDecimation::Bucket(time, 60.0f, EffectDecimation::LabelPhase(label));
+        std::uint8_t cachedAlpha = static_cast<std::uint8_t>(alpha * 255.0f);
+        const std::uint32_t* colors = m_colors.Find(key, bucket, shape, cachedAlpha);
+        if (!colors)
+        {
+            std::uint32_t* out = m_colors.Store(key, bucket, shape, cachedAlpha);
+            for (std::uint32_t i = 0; i < count; ++i)
+                out[i] = 0xE6000000u | (static_cast<std::uint32_t>(bucket + i) & 0xFFFFFFu);
+            colors = out;
+        }
+        for (std::uint32_t i = 0; i < count; ++i)
+            m_vtx[start + i].col = colors[i];
+
+        TypewriterMask::Apply(m_vtx.data() + start, count, x, m_glyphs, 0, 1e6f, 0.5f);
+    }
+
+    // Flatten into the pipelined frame, as LabelFrameBuilder::CopyDrawList
+    void CopyFrame()
+    {
+        m_frame.Clear();
+        m_frame.vertices.resize(m_vtx.size());
+        if (!m_vtx.empty())
+            std::memcpy(m_frame.vertices.data(), m_vtx.data(), m_vtx.size() * sizeof(Vertex));
+        m_frame.indices.assign(m_idx.begin(), m_idx.end());
+
+        FramePipeline::DrawCmd cmd;
+        cmd.idxCount = static_cast<std::uint32_t>(m_idx.size());
+        cmd.vtxEnd = static_cast<std::uint32_t>(m_vtx.size());
+        m_frame.commands.push_back(cmd);
+        for (const auto& d : m_view)
+        {
+            FramePipeline::Anchor anchor;
+            anchor.screen[0] = d.x;
+            anchor.screen[1] = d.y;
+            m_frame.anchors.push_back(anchor);
+        }
+    }
+
+    std::vector<SnapshotDelta::ActorState> m_game;
+    SnapshotDelta::Channel m_channel;
+    SnapshotDelta::Table m_mirror;
+    std::vector<ViewActor> m_view;
+
+    std::vector<std::string> m_segments;
+    std::string m_title;
+    std::vector<Vertex> m_vtx;
+    std::vector<std::uint16_t> m_idx;
+    LabelInstancing::Registry m_instances;
+    EffectDecimation::ColorCache m_colors;
+    TypewriterMask::GlyphMap m_glyphs;
+    FramePipeline::Frame m_frame;
+    std::uint64_t m_serial{0};
+};
+
+static_assert(sizeof(Vertex) == sizeof(FramePipeline::Vertex), "vertex layout must match ImDrawVert");
+
+// ============================================================================
+// Steady-state frames
+// ============================================================================
+
+TEST(FrameAllocationsHarness, SteadyFramesDoNotAllocate)
+{
+    FrameAllocations::Meter meter(16);
+    LabelFrameHarness harness(40);
+
+    for (int f = 0; f < 16; ++f)
+        harness.Frame(meter);
+    ASSERT_FALSE(meter.Warm());
+
+    for (int f = 0; f < 600; ++f)
+        harness.Frame(meter);
+
+    EXPECT_TRUE(meter.Warm());
+    EXPECT_EQ(meter.SteadyFrames(), 600u);
+    EXPECT_EQ(meter.AllocatingFrames(), 0u);
+    EXPECT_EQ(meter.SteadyAllocations(), 0u);
+
+    // The frame did real work: labels were built and copied
+    EXPECT_GT(harness.Vertices(), 0u);
+    EXPECT_GT(harness.Instances().GetStats().instanced, 0u);
+}
+
+TEST(FrameAllocationsHarness, NewActorGrowsThenSettles)
+{
+    FrameAllocations::Meter meter(16);
+    LabelFrameHarness harness(12);
+    for (int f = 0; f < 64; ++f)
+        harness.Frame(meter);
+    ASSERT_EQ(meter.SteadyAllocations(), 0u);
+
+    // A longer name than any so far must grow the view and the text buffers
+    harness.AddActor("Vittoria Vici of the East Empire Company");
+    EXPECT_GT(harness.Frame(meter), 0u);
+    EXPECT_EQ(meter.AllocatingFrames(), 1u);
+
+    // The renderer rearms on an actor set change; the grown set settles again
+    meter.Rearm();
+    for (int f = 0; f < 200; ++f)
+        harness.Frame(meter);
+    EXPECT_EQ(meter.SteadyAllocations(), 0u);
+}
+
+TEST(FrameAllocationsHarness, DetectsPerFrameAllocation)
+{
+    FrameAllocations::Meter meter(4);
+    for (int f = 0; f < 20; ++f)
+    {
+        meter.BeginFrame(Allocations());
+        std::string copy(64, 'x');  // a label string built from scratch every frame
+        ASSERT_EQ(copy.size(), 64u);
+        meter.EndFrame(Allocations());
+    }
+    EXPECT_EQ(meter.SteadyFrames(), 16u);
+    EXPECT_EQ(meter.AllocatingFrames(), 16u);
+}
+
+// ============================================================================
+// Meter and ImGui hooks
+// ============================================================================
+
+TEST(FrameAllocationsMeter, WarmupFramesAreNotJudged)
+{
+    FrameAllocations::Meter meter(3);
+    std::uint64_t count = 0;
+    for (int f = 0; f < 3; ++f)
+    {
+        meter.BeginFrame(count);
+        count += 5;
+        EXPECT_EQ(meter.EndFrame(count), 5u);
+        EXPECT_FALSE(meter.Warm());
+    }
+    EXPECT_EQ(meter.SteadyAllocations(), 0u);
+
+    meter.BeginFrame(count);
+    EXPECT_EQ(meter.EndFrame(count + 2), 2u);
+    EXPECT_TRUE(meter.Warm());
+    EXPECT_EQ(meter.SteadyAllocations(), 2u);
+    EXPECT_EQ(meter.AllocatingFrames(), 1u);
+
+    meter.Rearm();
+    EXPECT_FALSE(meter.Warm());
+    EXPECT_EQ(meter.SteadyFrames(), 0u);
+    EXPECT_EQ(meter.AllocatingFrames(), 0u);
+}
+
+TEST(FrameAllocationsMeter, ImGuiHooksCount)
+{
+    const auto before = FrameAllocations::Totals();
+    void* a = FrameAllocations::Alloc(100, nullptr);
+    void* b = FrameAllocations::Alloc(28, nullptr);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    FrameAllocations::Free(a, nullptr);
+    FrameAllocations::Free(nullptr, nullptr);
+
+    const auto after = FrameAllocations::Totals();
+    EXPECT_EQ(after.allocations - before.allocations, 2u);
+    EXPECT_EQ(after.bytes - before.bytes, 128u);
+    EXPECT_EQ(after.frees - before.frees, 1u);
+    FrameAllocations::Free(b, nullptr);
+}
+
+// ============================================================================
+// Label text
+// ============================================================================
+
+TEST(LabelTextFormat, ReplacesPlaceholders)
+{
+    std::string out;
+    LabelText::Format(out, "%n Lv.%l", "Lydia", 42);
+    EXPECT_EQ(out, "Lydia Lv.42");
+
+    LabelText::Format(out, "%t - %n", "Lydia", 42, "Housecarl");
+    EXPECT_EQ(out, "Housecarl - Lydia");
+
+    LabelText::Format(out, "%n%n", "ab", 0);
+    EXPECT_EQ(out, "abab");
+}
+
+TEST(LabelTextFormat, KeepsUnknownAndTitlelessPlaceholders)
+{
+    std::string out;
+    LabelText::Format(out, "%t %x 100% %", "Lydia", 1);
+    EXPECT_EQ(out, "%t %x 100% %");
+}
+
+TEST(LabelTextFormat, SubstitutedTextIsNotRescanned)
+{
+    std::string out;
+    LabelText::Format(out, "%n Lv.%l", "Odd %l Name", 7);
+    EXPECT_EQ(out, "Odd %l Name Lv.7");
+}
+
+TEST(LabelTextFormat, ReusesCapacity)
+{
+    std::string out;
+    LabelText::Format(out, "%t of %n, Lv.%l", "Jarl Balgruuf the Greater", 9999, "Jarl");
+
+    const auto before = Allocations();
+    for (int level = 1; level < 500; ++level)
+        LabelText::Format(out, "%t of %n, Lv.%l", "Jarl Balgruuf the Greater", level, "Jarl");
+    EXPECT_EQ(Allocations(), before);
+}
+
+TEST(LabelTextContains, CaseInsensitive)
+{
+    EXPECT_TRUE(LabelText::ContainsNoCase("Jarl Balgruuf the Greater", "balgruuf"));
+    EXPECT_TRUE(LabelText::ContainsNoCase("Jarl Balgruuf the Greater", "GREATER"));
+    EXPECT_TRUE(LabelText::ContainsNoCase("Lydia", "Lydia"));
+    EXPECT_FALSE(LabelText::ContainsNoCase("Lydia", "Lydian"));
+    EXPECT_FALSE(LabelText::ContainsNoCase("Whiterun Guard", "guards"));
+    EXPECT_TRUE(LabelText::ContainsNoCase("Guard", ""));
+}
@@ -0,0 +1,614 @@
+/**
+ * Unit tests for the pipelined frame build using Google Test.
+ *
+ * Drives FramePipeline::Pipeline headlessly with a deterministic builder
+ * that emits one textured quad per label, and checks that every pipelined
+ * mode submits exactly what the serial path builds for the same input,
+ * translated by the camera change since the build.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "FramePipeline.h"
+
+using FramePipeline::Camera;
+using FramePipeline::Frame;
+using FramePipeline::FrameInput;
+using FramePipeline::Mode;
+using FramePipeline::Pipeline;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Simple perspective camera at `eye` looking down +Y, with Z up.
+static Camera MakeCamera(float eyeX, float eyeY, float eyeZ, float width = 1920.0f, float height = 1080.0f)
+{
+    Camera cam;
+    const float f = 1.5f;
+    // clip.x = f * (x - eye.x), clip.y = f * aspect * (z - eye.z), w = y - eye.y
+    const float aspect = width / height;
+    cam.worldToCam[0][0] = f;
+    cam.worldToCam[0][3] = -f * eyeX;
+    cam.worldToCam[1][2] = f * aspect;
+    cam.worldToCam[1][3] = -f * aspect * eyeZ;
+    cam.worldToCam[2][1] = 0.01f;
+    cam.worldToCam[2][3] = -0.01f * eyeY;
+    cam.worldToCam[3][1] = 1.0f;
+    cam.worldToCam[3][3] = -eyeY;
+    cam.left = 0.0f;
+    cam.right = 1.0f;
+    cam.top = 1.0f;
+    cam.bottom = 0.0f;
+    cam.width = width;
+    cam.height = height;
+    cam.position[0] = eyeX;
+    cam.position[1] = eyeY;
+    cam.position[2] = eyeZ;
+    return cam;
+}
+
+static FrameInput MakeInput(std::uint64_t serial, const Camera& cam)
+{
+    FrameInput in;
+    in.camera = cam;
+    in.serial = serial;
+    in.time = 0.016 * static_cast<double>(serial);
+    in.deltaTime = 0.016f;
+    return in;
+}
+
+struct Actor
+{
+    float world[3];
+    std::uint32_t rgb;
+};
+
+static std::vector<Actor> MakeScene(int count)
+{
+    std::vector<Actor> scene;
+    for (int i = 0; i < count; ++i)
+    {
+        Actor a;
+        a.world[0] = static_cast<float>((i * 37) % 400) - 200.0f;
+        a.world[1] = 300.0f + static_cast<float>((i * 53) % 900);
+        a.world[2] = 120.0f + static_cast<float>((i * 11) % 40);
+        a.rgb = 0x00102030u + static_cast<std::uint32_t>(i) * 0x00010203u;
+        scene.push_back(a);
+    }
+    return scene;
+}
+
+// Deterministic stand-in for the renderer's label builder. Output depends
+// only on the captured scene and the input, like the real builder depends
+// only on the captured snapshot, settings and frame clock.
+class QuadBuilder : public FramePipeline::IFrameBuilder {
+public:
+    const std::vector<Actor>* scene = nullptr;
+    std::chrono::microseconds cost{0};
+    int captures = 0;
+    int builds = 0;
+    double stepSum = 0.0;
+    std::uint64_t lastSerial = 0;
+
+    void Capture(const FrameInput&) override
+    {
+        m_captured = *scene;
+        ++captures;
+    }
+
+    void Build(const FrameInput& input, Frame& out) override
+    {
+        ++builds;
+        stepSum += input.deltaTime;
+        lastSerial = input.serial;
+        if (cost.count() > 0)
+            std::this_thread::sleep_for(cost);
+
+        for (std::size_t i = 0; i < m_captured.size(); ++i)
+        {
+            const Actor& a = m_captured[i];
+            float sx, sy, sz;
+            if (!input.camera.Project(a.world, sx, sy, sz))
+                continue;
+
+            // Size from distance, alpha pulses with the frame clock
+            const float half = 4.0f + 2000.0f / (1.0f + a.world[1]);
+            const auto alpha = static_cast<std::uint32_t>(128.0 + 127.0 * std::sin(input.time * 3.0 + static_cast<double>(i)));
+            const std::uint32_t col = (alpha << 24) | a.rgb;
+
+            // Two textures alternate so commands split per label
+            void* tex = reinterpret_cast<void*>(static_cast<std::uintptr_t>(0x1000 + (i & 1)));
+            if (out.commands.empty() || out.commands.back().texture != tex)
+            {
+                FramePipeline::DrawCmd cmd;
+                cmd.texture = tex;
+                cmd.clip[2] = input.camera.width;
+                cmd.clip[3] = input.camera.height;
+                cmd.idxOffset = static_cast<std::uint32_t>(out.indices.size());
+                cmd.vtxBegin = static_cast<std::uint32_t>(out.vertices.size());
+                cmd.vtxEnd = cmd.vtxBegin;
+                out.commands.push_back(cmd);
+            }
+
+            FramePipeline::Anchor anchor;
+            std::memcpy(anchor.world, a.world, sizeof(anchor.world));
+            anchor.screen[0] = sx;
+            anchor.screen[1] = sy;
+            anchor.vtxBegin = static_cast<std::uint32_t>(out.vertices.size());
+
+            const std::uint32_t base = anchor.vtxBegin;
+            out.vertices.push_back({sx - half, sy - half, 0.0f, 0.0f, col});
+            out.vertices.push_back({sx + half, sy - half, 1.0f, 0.0f, col});
+            out.vertices.push_back({sx + half, sy + half, 1.0f, 1.0f, col});
+            out.vertices.push_back({sx - half, sy + half, 0.0f, 1.0f, col});
+            for (std::uint32_t k : {0u, 1u, 2u, 0u, 2u, 3u})
+                out.indices.push_back(base + k);
+
+            anchor.vtxEnd = static_cast<std::uint32_t>(out.vertices.size());
+            out.anchors.push_back(anchor);
+
+            auto& cmd = out.commands.back();
+            cmd.idxCount += 6;
+            cmd.vtxEnd = anchor.vtxEnd;
+        }
+    }
+
+private:
+    std::vector<Actor> m_captured;
+};
+
+// Reference: what the serial path draws for `input` with `scene`.
+static Frame BuildSerial(const std::vector<Actor>& scene, const FrameInput& input)
+{
+    QuadBuilder builder;
+    builder.scene = &scene;
+    Pipeline pipeline(builder);
+    const Frame* f = pipeline.Submit(input);
+    return *f;
+}
+
+static bool SameVertices(const Frame& a, const Frame& b, float tolerance)
+{
+    if (a.vertices.size() != b.vertices.size())
+        return false;
+    for (std::size_t i = 0; i < a.vertices.size(); ++i)
+    {
+        const auto& va = a.vertices[i];
+        const auto& vb = b.vertices[i];
+        if (tolerance == 0.0f)
+        {
+            if (std::memcmp(&va, &vb, sizeof(va)) != 0)
+                return false;
+        }
+        else if (std::fabs(va.x - vb.x) > tolerance || std::fabs(va.y - vb.y) > tolerance ||
+                 va.u != vb.u || va.v != vb.v || va.col != vb.col)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool SameTopology(const Frame& a, const Frame& b)
+{
+    if (a.indices != b.indices || a.commands.size() != b.commands.size() ||
+        a.anchors.size() != b.anchors.size())
+        return false;
+    for (std::size_t i = 0; i < a.commands.size(); ++i)
+    {
+        const auto& ca = a.commands[i];
+        const auto& cb = b.commands[i];
+        if (ca.texture != cb.texture || ca.idxOffset != cb.idxOffset || ca.idxCount != cb.idxCount ||
+            ca.vtxBegin != cb.vtxBegin || ca.vtxEnd != cb.vtxEnd ||
+            std::memcmp(ca.clip, cb.clip, sizeof(ca.clip)) != 0)
+            return false;
+    }
+    for (std::size_t i = 0; i < a.anchors.size(); ++i)
+    {
+        if (a.anchors[i].vtxBegin != b.anchors[i].vtxBegin || a.anchors[i].vtxEnd != b.anchors[i].vtxEnd)
+            return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Camera
+// ============================================================================
+
+TEST(FramePipelineCamera, ProjectsCenterAndFlipsY)
+{
+    const Camera cam = MakeCamera(0.0f, 0.0f, 0.0f);
+
+    float ahead[3] = {0.0f, 500.0f, 0.0f};
+    float x, y, z;
+    ASSERT_TRUE(cam.Project(ahead, x, y, z));
+    EXPECT_NEAR(x, 960.0f, 1e-3f);
+    EXPECT_NEAR(y, 540.0f, 1e-3f);
+
+    // Higher in the world is higher on screen, i.e. smaller Y
+    float above[3] = {0.0f, 500.0f, 50.0f};
+    ASSERT_TRUE(cam.Project(above, x, y, z));
+    EXPECT_LT(y, 540.0f);
+
+    // To the right in the world is to the right on screen
+    float right[3] = {50.0f, 500.0f, 0.0f};
+    ASSERT_TRUE(cam.Project(right, x, y, z));
+    EXPECT_GT(x, 960.0f);
+}
+
+TEST(FramePipelineCamera, RejectsPointsBehindNearPlane)
+{
+    const Camera cam = MakeCamera(0.0f, 0.0f, 0.0f);
+    float behind[3] = {0.0f, -10.0f, 0.0f};
+    float onPlane[3] = {0.0f, 0.0f, 0.0f};
+    float x, y, z;
+    EXPECT_FALSE(cam.Project(behind, x, y, z));
+    EXPECT_FALSE(cam.Project(onPlane, x, y, z));
+}
+
+TEST(FramePipelineCamera, ModeFromIntDefaultsToSerial)
+{
+    EXPECT_EQ(FramePipeline::ModeFromInt(0), Mode::Serial);
+    EXPECT_EQ(FramePipeline::ModeFromInt(1), Mode::Latency);
+    EXPECT_EQ(FramePipeline::ModeFromInt(2), Mode::Throughput);
+    EXPECT_EQ(FramePipeline::ModeFromInt(-1), Mode::Serial);
+    EXPECT_EQ(FramePipeline::ModeFromInt(7), Mode::Serial);
+}
+
+// ============================================================================
+// Reprojection
+// ============================================================================
+
+TEST(FramePipelineReproject, SameCameraIsBitIdentical)
+{
+    const auto scene = MakeScene(24);
+    const FrameInput in = MakeInput(5, MakeCamera(0.0f, 0.0f, 100.0f));
+    const Frame built = BuildSerial(scene, in);
+    ASSERT_FALSE(built.Empty());
+
+    Frame copy = built;
+    FramePipeline::Reproject(copy, in.camera);
+    EXPECT_TRUE(SameVertices(copy, built, 0.0f));
+    EXPECT_TRUE(SameTopology(copy, built));
+}
+
+TEST(FramePipelineReproject, MatchesRebuildWithNewCamera)
+{
+    const auto scene = MakeScene(24);
+    const FrameInput oldIn = MakeInput(5, MakeCamera(0.0f, 0.0f, 100.0f));
+    FrameInput newIn = oldIn;
+    newIn.camera = MakeCamera(12.0f, 0.0f, 104.0f);
+
+    Frame moved = BuildSerial(scene, oldIn);
+    FramePipeline::Reproject(moved, newIn.camera);
+
+    // Label size does not depend on the camera in the fake builder, so a pure
+    // translation must match a rebuild up to float rounding
+    const Frame rebuilt = BuildSerial(scene, newIn);
+    EXPECT_TRUE(SameTopology(moved, rebuilt));
+    EXPECT_TRUE(SameVertices(moved, rebuilt, 1e-2f));
+}
+
+TEST(FramePipelineReproject, HidesLabelsBehindNewCamera)
+{
+    std::vector<Actor> scene = {{{0.0f, 50.0f, 100.0f}, 0x00FFFFFFu}, {{0.0f, 900.0f, 100.0f}, 0x00FFFFFFu}};
+    const FrameInput in = MakeInput(1, MakeCamera(0.0f, 0.0f, 100.0f));
+    Frame f = BuildSerial(scene, in);
+    ASSERT_EQ(f.anchors.size(), 2u);
+
+    // Step forward past the first actor
+    FramePipeline::Reproject(f, MakeCamera(0.0f, 200.0f, 100.0f));
+    for (std::uint32_t i = f.anchors[0].vtxBegin; i < f.anchors[0].vtxEnd; ++i)
+        EXPECT_EQ(f.vertices[i].col >> 24, 0u);
+    for (std::uint32_t i = f.anchors[1].vtxBegin; i < f.anchors[1].vtxEnd; ++i)
+        EXPECT_NE(f.vertices[i].col >> 24, 0u);
+}
+
+// ============================================================================
+// Pipeline modes
+// ============================================================================
+
+TEST(FramePipelineModes, SerialBuildsEveryInputInPlace)
+{
+    const auto scene = MakeScene(16);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    Pipeline pipeline(builder);
+
+    for (std::uint64_t n = 1; n <= 5; ++n)
+    {
+        const FrameInput in = MakeInput(n, MakeCamera(0.0f, 0.0f, 100.0f));
+        const Frame* f = pipeline.Submit(in);
+        ASSERT_NE(f, nullptr);
+        EXPECT_EQ(f->serial, n);
+    }
+    EXPECT_EQ(builder.builds, 5);
+    EXPECT_EQ(pipeline.GetStats().repeated, 0u);
+}
+
+TEST(FramePipelineModes, LatencyIsSerialOutputOneFrameLate)
+{
+    const auto scene = MakeScene(32);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    Pipeline pipeline(builder);
+    pipeline.SetMode(Mode::Latency);
+
+    // Static camera: the submitted frame is byte-for-byte the serial frame
+    const Camera cam = MakeCamera(0.0f, 0.0f, 100.0f);
+    EXPECT_EQ(pipeline.Submit(MakeInput(1, cam)), nullptr);
+    for (std::uint64_t n = 2; n <= 20; ++n)
+    {
+        const Frame* f = pipeline.Submit(MakeInput(n, cam));
+        ASSERT_NE(f, nullptr);
+        ASSERT_EQ(f->serial, n - 1);
+
+        const Frame expected = BuildSerial(scene, MakeInput(n - 1, cam));
+        EXPECT_TRUE(SameTopology(*f, expected));
+        EXPECT_TRUE(SameVertices(*f, expected, 0.0f)) << "frame " << n;
+    }
+
+    const auto stats = pipeline.GetStats();
+    EXPECT_EQ(stats.repeated, 0u);
+    EXPECT_EQ(stats.submitted, 19u);
+}
+
+TEST(FramePipelineModes, LatencyReprojectsToNewestCamera)
+{
+    const auto scene = MakeScene(32);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    Pipeline pipeline(builder);
+    pipeline.SetMode(Mode::Latency);
+
+    auto camAt = [](std::uint64_t n) {
+        const float t = static_cast<float>(n);
+        return MakeCamera(3.0f * t, 0.5f * t, 100.0f + std::sin(t) * 4.0f);
+    };
+
+    pipeline.Submit(MakeInput(1, camAt(1)));
+    for (std::uint64_t n = 2; n <= 30; ++n)
+    {
+        const Frame* f = pipeline.Submit(MakeInput(n, camAt(n)));
+        ASSERT_NE(f, nullptr);
+
+        // Serial output for the same snapshot and clock, drawn with the camera
+        // current at submit
+        FrameInput reference = MakeInput(n - 1, camAt(n));
+        const Frame expected = BuildSerial(scene, reference);
+        ASSERT_TRUE(SameTopology(*f, expected)) << "frame " << n;
+        EXPECT_TRUE(SameVertices(*f, expected, 1e-2f)) << "frame " << n;
+    }
+}
+
+TEST(FramePipelineModes, CaptureIsolatesBuildFromLaterSceneChanges)
+{
+    auto scene = MakeScene(8);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    builder.cost = std::chrono::milliseconds(2);
+    Pipeline pipeline(builder);
+    pipeline.SetMode(Mode::Latency);
+
+    const Camera cam = MakeCamera(0.0f, 0.0f, 100.0f);
+    const auto before = scene;
+    pipeline.Submit(MakeInput(1, cam));
+
+    // The game thread replaces the snapshot while frame 1 is being built
+    scene = MakeScene(3);
+
+    const Frame* f = pipeline.Submit(MakeInput(2, cam));
+    ASSERT_NE(f, nullptr);
+    const Frame expected = BuildSerial(before, MakeInput(1, cam));
+    EXPECT_TRUE(SameTopology(*f, expected));
+    EXPECT_TRUE(SameVertices(*f, expected, 0.0f));
+}
+
+TEST(FramePipelineModes, ThroughputNeverWaitsAndRepeatsLastFrame)
+{
+    const auto scene = MakeScene(16);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    builder.cost = std::chrono::milliseconds(8);
+    Pipeline pipeline(builder);
+    pipeline.SetMode(Mode::Throughput);
+
+    const Camera cam = MakeCamera(0.0f, 0.0f, 100.0f);
+    std::uint64_t lastSerial = 0;
+    int frames = 0;
+    for (std::uint64_t n = 1; n <= 60; ++n)
+    {
+        const Frame* f = pipeline.Submit(MakeInput(n, cam));
+        if (f)
+        {
+            ++frames;
+            EXPECT_GE(f->serial, lastSerial);
+            lastSerial = f->serial;
+
+            // Whatever frame is shown is exactly what serial built for its input
+            const Frame expected = BuildSerial(scene, MakeInput(f->serial, cam));
+            EXPECT_TRUE(SameVertices(*f, expected, 0.0f));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pipeline.Wait();
+
+    const auto stats = pipeline.GetStats();
+    EXPECT_EQ(stats.waits, 0u);
+    EXPECT_GT(stats.repeated, 0u);
+    EXPECT_GT(frames, 0);
+    EXPECT_LT(stats.built, 60u);  // skipped inputs while the worker was busy
+
+    // Skipped inputs still advance the build clock: the steps cover the whole
+    // span from the first input to the last one that was built
+    const double span = MakeInput(builder.lastSerial, cam).time - MakeInput(1, cam).time;
+    EXPECT_NEAR(builder.stepSum - 0.016, span, 1e-3);
+}
+
+TEST(FramePipelineModes, ModeSwitchAndResetDropStaleFrames)
+{
+    const auto scene = MakeScene(8);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    Pipeline pipeline(builder);
+    const Camera cam = MakeCamera(0.0f, 0.0f, 100.0f);
+
+    pipeline.SetMode(Mode::Latency);
+    pipeline.Submit(MakeInput(1, cam));
+    ASSERT_NE(pipeline.Submit(MakeInput(2, cam)), nullptr);
+
+    // After a load screen nothing from before may be shown
+    pipeline.Reset();
+    EXPECT_EQ(pipeline.Submit(MakeInput(3, cam)), nullptr);
+    const Frame* f = pipeline.Submit(MakeInput(4, cam));
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(f->serial, 3u);
+
+    // Back to serial joins the worker and builds in place again
+    pipeline.SetMode(Mode::Serial);
+    f = pipeline.Submit(MakeInput(5, cam));
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(f->serial, 5u);
+
+    // And pipelining can be turned on again
+    pipeline.SetMode(Mode::Throughput);
+    EXPECT_EQ(pipeline.Submit(MakeInput(6, cam)), nullptr);
+    pipeline.Wait();
+    f = pipeline.Submit(MakeInput(7, cam));
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(f->serial, 6u);
+}
+
+// Keeps per-label state across builds the way the renderer's s_cache does.
+// Every touch counts itself in `users`, so two threads at once are seen.
+class CachingBuilder : public QuadBuilder {
+public:
+    std::unordered_map<std::uint32_t, int> cache;
+    std::atomic<int> users{0};
+    std::atomic<int> overlaps{0};
+
+    void Build(const FrameInput& input, Frame& out) override
+    {
+        Touch([&] {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            for (std::size_t i = 0; i < scene->size(); ++i) ++cache[static_cast<std::uint32_t>(i)];
+            cache.erase(static_cast<std::uint32_t>(input.serial % 16) + 100);
+            cache[static_cast<std::uint32_t>(input.serial % 16) + 100] = 1;
+        });
+        QuadBuilder::Build(input, out);
+    }
+
+    template <class Fn>
+    void Touch(Fn&& fn)
+    {
+        if (users.fetch_add(1) != 0) ++overlaps;
+        fn();
+        users.fetch_sub(1);
+    }
+};
+
+TEST(FramePipelineModes, BuilderStateHasOneOwnerAtATime)
+{
+    const auto scene = MakeScene(16);
+    CachingBuilder builder;
+    builder.scene = &scene;
+    Pipeline pipeline(builder);
+    const Camera cam = MakeCamera(0.0f, 0.0f, 100.0f);
+
+    // The scan thread keeps its own results, it never reaches the builder's
+    std::atomic<bool> stop{false};
+    std::thread scan([&] {
+        std::unordered_map<std::uint32_t, bool> checks;
+        for (std::uint32_t n = 0; !stop.load(); ++n) checks[n % 32] = (n & 1) != 0;
+    });
+
+    const Mode modes[] = {Mode::Latency, Mode::Throughput, Mode::Serial};
+    for (std::uint64_t serial = 1; serial <= 300; ++serial)
+    {
+        pipeline.SetMode(modes[(serial / 20) % 3]);
+        pipeline.Submit(MakeInput(serial, cam));
+
+        // Settings reload: reset the pipeline, then edit the cache on this thread
+        if (serial % 5 == 0)
+        {
+            pipeline.Reset();
+            builder.Touch([&] {
+                builder.cache.clear();
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            });
+        }
+    }
+    stop = true;
+    scan.join();
+    pipeline.SetMode(Mode::Serial);
+
+    EXPECT_EQ(builder.overlaps.load(), 0);
+    EXPECT_GT(builder.builds, 100);
+}
+
+TEST(FramePipelineModes, DestroyWhileBuilding)
+{
+    const auto scene = MakeScene(8);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    builder.cost = std::chrono::milliseconds(5);
+    {
+        Pipeline pipeline(builder);
+        pipeline.SetMode(Mode::Throughput);
+        pipeline.Submit(MakeInput(1, MakeCamera(0.0f, 0.0f, 100.0f)));
+    }
+    EXPECT_EQ(builder.builds, 1);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(FramePipelineBench, RenderThreadCostPerFrame)
+{
+    const auto scene = MakeScene(64);
+    QuadBuilder builder;
+    builder.scene = &scene;
+    builder.cost = std::chrono::microseconds(1500);  // stands in for label building
+    const Camera cam = MakeCamera(0.0f, 0.0f, 100.0f);
+    constexpr int kFrames = 60;
+
+    auto run = [&](Mode mode) {
+        Pipeline pipeline(builder);
+        pipeline.SetMode(mode);
+        double renderMs = 0.0;
+        for (int n = 1; n <= kFrames; ++n)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            pipeline.Submit(MakeInput(static_cast<std::uint64_t>(n), cam));
+            const auto t1 = std::chrono::steady_clock::now();
+            renderMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+            // The rest of the game frame
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        pipeline.Wait();
+        return renderMs / kFrames;
+    };
+
+    const double serialMs = run(Mode::Serial);
+    const double latencyMs = run(Mode::Latency);
+    const double throughputMs = run(Mode::Throughput);
+
+    std::printf("[ BENCH    ] render thread per frame: serial %.3f ms, latency %.3f ms, throughput %.3f ms\n",
+                serialMs, latencyMs, throughputMs);
+
+    // The build overlaps the rest of the frame, so submit is cheaper than building
+    EXPECT_LT(throughputMs, serialMs);
+    EXPECT_LT(latencyMs, serialMs);
+}
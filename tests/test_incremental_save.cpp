@@ -0,0 +1,340 @@
+/**
+ * Unit tests for incremental saves of the override registrations using
+ * Google Test.
+ *
+ * Saves a synthetic registration tree with the same record layout as
+ * OverrideInterface, once field by field against an SKSE co-save stand-in
+ * and once through the cached blocks of ShardedRegistrationMap, checks the
+ * two are byte for byte the same across changes, erasures and clears, that
+ * only changed actors are encoded again, and benchmarks a save after a few
+ * actors changed against a full one.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "BufferedSerialization.h"
+#include "ShardedRegistrationMap.h"
+
+// ============================================================================
+// SKSE co-save stand-in
+// ============================================================================
+
+// Records framed with the SKSE header (type, version, length), one write per
+// field like the co-save file
+struct MemorySerialization {
+    std::vector<UInt8> data;
+    size_t recordStart = SIZE_MAX;
+    size_t writes = 0;
+
+    bool OpenRecord(UInt32 type, UInt32 version) {
+        Close();
+        recordStart = data.size();
+        UInt32 header[3] = {type, version, 0};
+        Append(header, sizeof(header));
+        return true;
+    }
+    bool WriteRecordData(const void* buf, UInt32 length) {
+        ++writes;
+        Append(buf, length);
+        return true;
+    }
+    void Close() {
+        if (recordStart == SIZE_MAX) return;
+        UInt32 length = static_cast<UInt32>(data.size() - recordStart - 12);
+        std::memcpy(data.data() + recordStart + 8, &length, 4);
+        recordStart = SIZE_MAX;
+    }
+    void Append(const void* buf, size_t length) {
+        const UInt8* bytes = static_cast<const UInt8*>(buf);
+        data.insert(data.end(), bytes, bytes + length);
+    }
+};
+
+// ============================================================================
+// Synthetic registrations
+// ============================================================================
+
+struct TestValue {
+    UInt16 key;
+    UInt8 type;
+    float value;
+};
+
+// Node string id -> values, like OverrideRegistration<StringTableItem>
+struct TestActor {
+    std::map<UInt32, std::vector<TestValue>> nodes;
+};
+
+using TestMap = ShardedRegistrationMap<TestActor>;
+
+constexpr UInt32 kVersion = 1;
+
+// The record layout of ActorRegistrationMapHolder::SaveEntry: the actor
+// block, then a block per node and per value
+template <class Intfc>
+static void SaveEntry(Intfc* intfc, UInt32 formId, const TestActor& actor) {
+    intfc->OpenRecord('ACEN', kVersion);
+    UInt64 handle = formId;
+    intfc->WriteRecordData(&handle, sizeof(handle));
+    UInt32 numNodes = static_cast<UInt32>(actor.nodes.size());
+    intfc->WriteRecordData(&numNodes, sizeof(numNodes));
+
+    for (auto& node : actor.nodes) {
+        intfc->OpenRecord('NOEN', kVersion);
+        intfc->WriteRecordData(&node.first, sizeof(node.first));
+        UInt32 numValues = static_cast<UInt32>(node.second.size());
+        intfc->WriteRecordData(&numValues, sizeof(numValues));
+        for (auto& value : node.second) {
+            intfc->OpenRecord('OVRV', kVersion);
+            intfc->WriteRecordData(&value.key, sizeof(value.key));
+            intfc->WriteRecordData(&value.type, sizeof(value.type));
+            intfc->WriteRecordData(&value.value, sizeof(value.value));
+        }
+    }
+}
+
+static std::vector<UInt8> FullSave(const TestMap& map) {
+    MemorySerialization out;
+    map.ForEach([&](UInt32 formId, const TestActor& actor) { SaveEntry(&out, formId, actor); });
+    out.Close();
+    return out.data;
+}
+
+static std::vector<UInt8> CachedSave(const TestMap& map, UInt64 stamp, UInt32* encoded = nullptr) {
+    BufferedWriter writer;
+    UInt32 count = map.SaveCached(writer, stamp, [](UInt32 formId, const TestActor& actor, BufferedWriter& blocks) {
+        SaveEntry(&blocks, formId, actor);
+    });
+    writer.Finish();
+    if (encoded) *encoded = count;
+    return std::vector<UInt8>(writer.Data(), writer.Data() + writer.Size());
+}
+
+static void SetValue(TestMap& map, UInt32 formId, UInt32 node, UInt16 key, float value) {
+    auto writer = map.Write(formId);
+    auto& values = writer.Get().nodes[node];
+    for (auto& existing : values) {
+        if (existing.key == key) {
+            existing.value = value;
+            return;
+        }
+    }
+    values.push_back({key, 1, value});
+}
+
+static void Populate(TestMap& map, UInt32 actors, UInt32 nodes, UInt16 values) {
+    for (UInt32 a = 0; a < actors; ++a)
+        for (UInt32 n = 0; n < nodes; ++n)
+            for (UInt16 k = 0; k < values; ++k) SetValue(map, 0x0A000800 + a, n, k, static_cast<float>(a + n + k));
+}
+
+// ============================================================================
+// Byte identity
+// ============================================================================
+
+TEST(IncrementalSaveTest, FirstSaveEncodesEveryActor) {
+    TestMap map;
+    Populate(map, 64, 3, 2);
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 64u);
+}
+
+TEST(IncrementalSaveTest, UnchangedSaveEncodesNothing) {
+    TestMap map;
+    Populate(map, 64, 3, 2);
+    CachedSave(map, 1);
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 0u);
+}
+
+TEST(IncrementalSaveTest, OnlyChangedActorsEncodedAgain) {
+    TestMap map;
+    Populate(map, 64, 3, 2);
+    CachedSave(map, 1);
+
+    SetValue(map, 0x0A000800, 0, 0, 42.0f);
+    SetValue(map, 0x0A000810, 7, 3, 1.5f);
+    SetValue(map, 0x0A000820, 1, 1, -3.0f);
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 3u);
+}
+
+TEST(IncrementalSaveTest, WriterWithoutChangeKeepsBlocks) {
+    // A removal that found nothing to remove
+    TestMap map;
+    Populate(map, 8, 1, 1);
+    CachedSave(map, 1);
+
+    {
+        auto writer = map.Write(0x0A000801);
+        ASSERT_NE(writer.Find(), nullptr);
+    }
+    map.Write(0x0B000001).Erase();
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 0u);
+}
+
+TEST(IncrementalSaveTest, ChangedThroughFindEncodesAgain) {
+    TestMap map;
+    Populate(map, 8, 2, 1);
+    CachedSave(map, 1);
+
+    {
+        auto writer = map.Write(0x0A000801);
+        auto entry = writer.Find();
+        ASSERT_NE(entry, nullptr);
+        entry->second.nodes.erase(1);
+        writer.Changed();
+    }
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 1u);
+}
+
+TEST(IncrementalSaveTest, ErasedAndAddedActors) {
+    TestMap map;
+    Populate(map, 64, 2, 2);
+    CachedSave(map, 1);
+
+    map.Write(0x0A000805).Erase();
+    map.Write(0x0A000806).Erase();
+    SetValue(map, 0x0B000001, 0, 0, 1.0f);
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 1u);
+}
+
+TEST(IncrementalSaveTest, ClearDropsSavedBlocks) {
+    TestMap map;
+    Populate(map, 16, 2, 2);
+    CachedSave(map, 1);
+
+    map.Clear();
+    EXPECT_TRUE(CachedSave(map, 1).empty());
+
+    Populate(map, 4, 1, 1);
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 1, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 4u);
+}
+
+TEST(IncrementalSaveTest, NewStampEncodesEverything) {
+    // A reverted string table hands out new ids for the same strings
+    TestMap map;
+    Populate(map, 32, 2, 2);
+    CachedSave(map, 1);
+
+    UInt32 encoded = 0;
+    EXPECT_EQ(CachedSave(map, 2, &encoded), FullSave(map));
+    EXPECT_EQ(encoded, 32u);
+}
+
+TEST(IncrementalSaveTest, RandomEditsStayByteIdentical) {
+    TestMap map;
+    Populate(map, 128, 2, 2);
+    CachedSave(map, 1);
+
+    std::mt19937 rng(73);
+    for (int round = 0; round < 100; ++round) {
+        const int edits = static_cast<int>(rng() % 12);
+        for (int e = 0; e < edits; ++e) {
+            const UInt32 formId = 0x0A000800 + rng() % 160;
+            switch (rng() % 4) {
+            case 0:
+                map.Write(formId).Erase();
+                break;
+            case 1:
+                if (auto writer = map.Write(formId); auto entry = writer.Find()) {
+                    if (entry->second.nodes.erase(rng() % 3)) writer.Changed();
+                }
+                break;
+            default:
+                SetValue(map, formId, rng() % 3, static_cast<UInt16>(rng() % 4), static_cast<float>(rng() % 100));
+                break;
+            }
+        }
+
+        UInt32 encoded = 0;
+        ASSERT_EQ(CachedSave(map, 1, &encoded), FullSave(map)) << "round " << round;
+        EXPECT_LE(encoded, static_cast<UInt32>(edits));
+    }
+}
+
+TEST(IncrementalSaveTest, WriteBlocksClosesOpenBlock) {
+    BufferedWriter blocks;
+    blocks.OpenRecord('BBBB', 1);
+    UInt32 value = 7;
+    blocks.WriteRecordData(&value, sizeof(value));
+    blocks.Finish();
+
+    BufferedWriter direct, appended;
+    direct.OpenRecord('AAAA', 1);
+    direct.WriteRecordData(&value, sizeof(value));
+    direct.OpenRecord('BBBB', 1);
+    direct.WriteRecordData(&value, sizeof(value));
+    direct.Finish();
+
+    appended.OpenRecord('AAAA', 1);
+    appended.WriteRecordData(&value, sizeof(value));
+    appended.WriteBlocks(blocks.Data(), blocks.Size());
+    appended.Finish();
+
+    ASSERT_EQ(appended.Size(), direct.Size());
+    EXPECT_EQ(std::memcmp(appended.Data(), direct.Data(), direct.Size()), 0);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(IncrementalSaveBenchmark, FewChangedActors) {
+    TestMap map;
+    constexpr UInt32 kActors = 2000;
+    Populate(map, kActors, 8, 4);
+    CachedSave(map, 1);
+
+    constexpr int kSaves = 20;
+    std::mt19937 rng(74);
+    double fullUs = 0, cachedUs = 0;
+    UInt32 encoded = 0;
+    size_t bytes = 0;
+    for (int i = 0; i < kSaves; ++i) {
+        // About 1% of the actors change between saves
+        for (UInt32 e = 0; e < kActors / 100; ++e)
+            SetValue(map, 0x0A000800 + rng() % kActors, rng() % 8, static_cast<UInt16>(rng() % 4), static_cast<float>(i));
+
+        auto t0 = std::chrono::steady_clock::now();
+        auto full = FullSave(map);
+        auto t1 = std::chrono::steady_clock::now();
+        UInt32 count = 0;
+        auto cached = CachedSave(map, 1, &count);
+        auto t2 = std::chrono::steady_clock::now();
+
+        ASSERT_EQ(cached, full);
+        encoded += count;
+        bytes = full.size();
+        fullUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        cachedUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+    }
+
+    EXPECT_LE(encoded, kSaves * (kActors / 100));
+    std::printf("[ BENCH    ] %u actors, %zu bytes, ~1%% changed: full %.0f us/save, incremental %.0f us/save (%.1f actors encoded)\n",
+                kActors, bytes, fullUs / kSaves, cachedUs / kSaves, static_cast<double>(encoded) / kSaves);
+}
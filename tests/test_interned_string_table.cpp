@@ -0,0 +1,379 @@
+/**
+ * Unit tests for the arena-backed interned string table using Google Test.
+ *
+ * Covers case-insensitive interning, id stability, co-save compatibility
+ * with the legacy StringTable record layout, and benchmarks insert, lookup
+ * and save/load at 100k strings against a shared_ptr-per-string baseline.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "InternedStringTable.h"
+
+// ============================================================================
+// In-memory co-save record stand-in
+// ============================================================================
+
+struct MemorySerialization {
+    mutable std::vector<char> data;
+    mutable size_t readPos = 0;
+    mutable UInt32 recordType = 0;
+    mutable UInt32 recordVersion = 0;
+
+    bool OpenRecord(UInt32 type, UInt32 version) const {
+        recordType = type;
+        recordVersion = version;
+        return true;
+    }
+    bool WriteRecordData(const void* buf, UInt32 length) const {
+        const char* p = static_cast<const char*>(buf);
+        data.insert(data.end(), p, p + length);
+        return true;
+    }
+    UInt32 ReadRecordData(void* buf, UInt32 length) const {
+        if (readPos + length > data.size()) return 0;
+        std::memcpy(buf, data.data() + readPos, length);
+        readPos += length;
+        return length;
+    }
+};
+
+// Legacy StringTable writers (same layout as external/StringTable.cpp)
+static void WriteLegacyV3(MemorySerialization& out, const std::vector<std::string>& strings) {
+    UInt32 count = static_cast<UInt32>(strings.size());
+    out.WriteRecordData(&count, sizeof(count));
+    for (const auto& s : strings) {
+        UInt16 len = static_cast<UInt16>(s.size());
+        out.WriteRecordData(&len, sizeof(len));
+        if (len) out.WriteRecordData(s.data(), len);
+    }
+}
+
+static void WriteLegacyV1(MemorySerialization& out, const std::vector<std::pair<std::string, UInt32>>& strings) {
+    UInt32 count = static_cast<UInt32>(strings.size());
+    out.WriteRecordData(&count, sizeof(count));
+    for (const auto& [s, id] : strings) {
+        UInt16 len = static_cast<UInt16>(s.size());
+        out.WriteRecordData(&len, sizeof(len));
+        if (len) out.WriteRecordData(s.data(), len);
+        out.WriteRecordData(&id, sizeof(id));
+    }
+}
+
+static std::vector<std::string> ReadLegacyV3(const MemorySerialization& in) {
+    std::vector<std::string> out;
+    UInt32 count = 0;
+    in.ReadRecordData(&count, sizeof(count));
+    for (UInt32 i = 0; i < count; ++i) {
+        UInt16 len = 0;
+        in.ReadRecordData(&len, sizeof(len));
+        std::string s(len, '\0');
+        if (len) in.ReadRecordData(s.data(), len);
+        out.push_back(s);
+    }
+    return out;
+}
+
+// Legacy SKEEFixedString hash (tolower-based FNV-1a)
+static UInt64 LegacyHashLower(const char* str, size_t count) {
+    UInt64 val = 14695981039346656037ULL;
+    for (size_t i = 0; i < count; ++i) {
+        val ^= static_cast<UInt64>(std::tolower(str[i]));
+        val *= 1099511628211ULL;
+    }
+    return val;
+}
+
+static std::vector<std::string> MakeStrings(size_t n) {
+    std::vector<std::string> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "Actor\\Node_%zu_NiOverride.Texture%zu", i, i % 7);
+        out.emplace_back(buf);
+    }
+    return out;
+}
+
+// ============================================================================
+// Interning
+// ============================================================================
+
+TEST(InternedStringTableTest, SameStringSameId) {
+    InternedStringTable table;
+    StringID a = table.Intern("NPC Head [Head]");
+    StringID b = table.Intern("NPC Head [Head]");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(table.Size(), 1u);
+}
+
+TEST(InternedStringTableTest, CaseInsensitive) {
+    InternedStringTable table;
+    StringID a = table.Intern("Body [Ovl0]");
+    EXPECT_EQ(table.Intern("BODY [OVL0]"), a);
+    EXPECT_EQ(table.Find("body [ovl0]"), a);
+    // First spelling wins
+    EXPECT_STREQ(table.GetString(a), "Body [Ovl0]");
+}
+
+TEST(InternedStringTableTest, IdsAreDenseAndOrdered) {
+    InternedStringTable table;
+    EXPECT_EQ(table.Intern("a"), 0u);
+    EXPECT_EQ(table.Intern("b"), 1u);
+    EXPECT_EQ(table.Intern("c"), 2u);
+    EXPECT_EQ(table.Intern("A"), 0u);
+}
+
+TEST(InternedStringTableTest, EmptyString) {
+    InternedStringTable table;
+    StringID id = table.Intern("");
+    EXPECT_NE(id, InternedStringTable::kInvalidID);
+    EXPECT_EQ(table.GetLength(id), 0u);
+    EXPECT_STREQ(table.GetString(id), "");
+}
+
+TEST(InternedStringTableTest, EmbeddedLengthIsRespected) {
+    InternedStringTable table;
+    StringID a = table.Intern("abcdef", 3);
+    EXPECT_EQ(table.Find("abc"), a);
+    EXPECT_EQ(table.Find("abcdef"), InternedStringTable::kInvalidID);
+}
+
+TEST(InternedStringTableTest, FindMissingReturnsInvalid) {
+    InternedStringTable table;
+    table.Intern("present");
+    EXPECT_EQ(table.Find("absent"), InternedStringTable::kInvalidID);
+    EXPECT_EQ(table.GetString(42), nullptr);
+}
+
+TEST(InternedStringTableTest, HashMatchesLegacyFold) {
+    const char* samples[] = {"", "abc", "ABC", "Mixed Case [Ovl12]", "textures\\actors\\Character\\Skin.dds"};
+    for (const char* s : samples) {
+        EXPECT_EQ(InternedStringTable::HashLower(s, std::strlen(s)), LegacyHashLower(s, std::strlen(s))) << s;
+    }
+    InternedStringTable table;
+    StringID id = table.Intern("Hello");
+    EXPECT_EQ(table.GetHash(id), LegacyHashLower("hello", 5));
+}
+
+TEST(InternedStringTableTest, PointersStayValidAcrossGrowth) {
+    InternedStringTable table;
+    StringID first = table.Intern("first");
+    const char* p = table.GetString(first);
+    for (const auto& s : MakeStrings(20000)) table.Intern(s.c_str());
+    EXPECT_EQ(table.GetString(first), p);
+    EXPECT_STREQ(p, "first");
+}
+
+TEST(InternedStringTableTest, OverlongStringRejected) {
+    InternedStringTable table;
+    std::string big(40000, 'x');
+    EXPECT_EQ(table.Intern(big.c_str(), big.size()), InternedStringTable::kInvalidID);
+}
+
+TEST(InternedStringTableTest, RevertClears) {
+    InternedStringTable table;
+    table.Intern("x");
+    table.Revert();
+    EXPECT_EQ(table.Size(), 0u);
+    EXPECT_EQ(table.ArenaBytes(), 0u);
+    EXPECT_EQ(table.Find("x"), InternedStringTable::kInvalidID);
+    EXPECT_EQ(table.Intern("y"), 0u);
+}
+
+// ============================================================================
+// Co-save compatibility
+// ============================================================================
+
+TEST(InternedStringTableTest, SaveMatchesLegacyLayout) {
+    InternedStringTable table;
+    std::vector<std::string> strings = {"alpha", "", "Beta", "gamma delta"};
+    for (const auto& s : strings) table.Intern(s.c_str(), s.size());
+
+    MemorySerialization mem;
+    table.Save(&mem, InternedStringTable::kSerializationVersion);
+    EXPECT_EQ(mem.recordType, static_cast<UInt32>('STTB'));
+    EXPECT_EQ(mem.recordVersion, 3u);
+
+    MemorySerialization legacy;
+    WriteLegacyV3(legacy, strings);
+    EXPECT_EQ(mem.data, legacy.data);
+    EXPECT_EQ(ReadLegacyV3(mem), strings);
+}
+
+TEST(InternedStringTableTest, LoadsLegacyV3) {
+    MemorySerialization mem;
+    WriteLegacyV3(mem, {"one", "TWO", "two", "three"});
+
+    InternedStringTable table;
+    InternedStringTable::StringIdRemap remap;
+    EXPECT_FALSE(table.Load(&mem, 3, remap));
+    ASSERT_EQ(remap.size(), 4u);
+    EXPECT_STREQ(table.GetString(remap[0]), "one");
+    EXPECT_EQ(remap[1], remap[2]);  // Case-folded duplicates share an id
+    EXPECT_STREQ(table.GetString(remap[3]), "three");
+}
+
+TEST(InternedStringTableTest, LoadsLegacyV1WithExplicitIds) {
+    MemorySerialization mem;
+    WriteLegacyV1(mem, {{"zero", 2}, {"one", 0}, {"two", 1}});
+
+    InternedStringTable table;
+    InternedStringTable::StringIdRemap remap;
+    EXPECT_FALSE(table.Load(&mem, 1, remap));
+    ASSERT_EQ(remap.size(), 3u);
+    EXPECT_STREQ(table.GetString(remap[2]), "zero");
+    EXPECT_STREQ(table.GetString(remap[0]), "one");
+    EXPECT_STREQ(table.GetString(remap[1]), "two");
+}
+
+TEST(InternedStringTableTest, LegacyIdPastStringCountIsRejected) {
+    MemorySerialization mem;
+    WriteLegacyV1(mem, {{"zero", 0}, {"huge", 0xFFFFFFF0u}});
+
+    InternedStringTable table;
+    InternedStringTable::StringIdRemap remap;
+    EXPECT_TRUE(table.Load(&mem, 1, remap));
+    EXPECT_LT(remap.size(), 2u);
+}
+
+TEST(InternedStringTableTest, HugeStringCountIsNotPreallocated) {
+    // Claims four billion strings, holds one
+    MemorySerialization mem;
+    WriteLegacyV3(mem, {"only"});
+    UInt32 total = 0xFFFFFFFFu;
+    std::memcpy(mem.data.data(), &total, sizeof(total));
+
+    InternedStringTable table;
+    InternedStringTable::StringIdRemap remap;
+    EXPECT_TRUE(table.Load(&mem, 3, remap));
+    EXPECT_LE(remap.capacity(), 16u);
+}
+
+TEST(InternedStringTableTest, ReadWriteStringIds) {
+    InternedStringTable table;
+    StringID id = table.Intern("node");
+    MemorySerialization mem;
+    InternedStringTable::WriteString(&mem, id);
+
+    InternedStringTable::StringIdRemap remap = {7};
+    EXPECT_EQ(InternedStringTable::ReadString(&mem, remap), 7u);
+    EXPECT_EQ(InternedStringTable::ReadString(&mem, remap), InternedStringTable::kInvalidID);  // Out of data
+}
+
+TEST(InternedStringTableTest, TruncatedRecordReportsError) {
+    MemorySerialization mem;
+    WriteLegacyV3(mem, {"complete", "truncated"});
+    mem.data.resize(mem.data.size() - 3);
+
+    InternedStringTable table;
+    InternedStringTable::StringIdRemap remap;
+    EXPECT_TRUE(table.Load(&mem, 3, remap));
+}
+
+TEST(InternedStringTableTest, RoundTrip) {
+    InternedStringTable table;
+    auto strings = MakeStrings(5000);
+    for (const auto& s : strings) table.Intern(s.c_str());
+
+    MemorySerialization mem;
+    table.Save(&mem, 3);
+
+    InternedStringTable loaded;
+    InternedStringTable::StringIdRemap remap;
+    ASSERT_FALSE(loaded.Load(&mem, 3, remap));
+    ASSERT_EQ(remap.size(), strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        EXPECT_STREQ(loaded.GetString(remap[i]), strings[i].c_str());
+    }
+}
+
+// ============================================================================
+// Benchmark: 100k strings vs. shared_ptr-per-string baseline
+// ============================================================================
+
+namespace {
+    // Mirrors the legacy StringTable: shared_ptr<string> items, tolower hash, stricmp-style equality
+    struct LegacyKey {
+        std::string str;
+        UInt64 hash;
+        explicit LegacyKey(const std::string& s) : str(s), hash(LegacyHashLower(s.c_str(), s.size())) {}
+        bool operator==(const LegacyKey& o) const {
+            if (str.size() != o.str.size()) return false;
+            for (size_t i = 0; i < str.size(); ++i)
+                if (std::tolower(str[i]) != std::tolower(o.str[i])) return false;
+            return true;
+        }
+    };
+    struct LegacyHash {
+        size_t operator()(const LegacyKey& k) const { return static_cast<size_t>(k.hash); }
+    };
+    struct LegacyTable {
+        std::unordered_map<LegacyKey, std::weak_ptr<LegacyKey>, LegacyHash> table;
+        std::vector<std::shared_ptr<LegacyKey>> items;
+        std::shared_ptr<LegacyKey> Get(const std::string& s) {
+            LegacyKey key(s);
+            auto it = table.find(key);
+            if (it != table.end()) return it->second.lock();
+            auto item = std::make_shared<LegacyKey>(key);
+            table.emplace(key, item);
+            items.push_back(item);
+            return item;
+        }
+    };
+
+    double Ms(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+}
+
+TEST(InternedStringTableBenchmark, HundredThousandStrings) {
+    constexpr size_t kStrings = 100000;
+    auto strings = MakeStrings(kStrings);
+    using clock = std::chrono::steady_clock;
+
+    // Legacy
+    LegacyTable legacy;
+    auto t0 = clock::now();
+    for (const auto& s : strings) legacy.Get(s);
+    auto t1 = clock::now();
+    size_t legacyHits = 0;
+    for (const auto& s : strings) legacyHits += legacy.Get(s) != nullptr;
+    auto t2 = clock::now();
+
+    // Interned
+    InternedStringTable table;
+    auto t3 = clock::now();
+    for (const auto& s : strings) table.Intern(s.c_str(), s.size());
+    auto t4 = clock::now();
+    size_t hits = 0;
+    for (const auto& s : strings) hits += table.Find(s.c_str(), s.size()) != InternedStringTable::kInvalidID;
+    auto t5 = clock::now();
+
+    MemorySerialization mem;
+    table.Save(&mem, 3);
+    auto t6 = clock::now();
+    InternedStringTable loaded;
+    InternedStringTable::StringIdRemap remap;
+    ASSERT_FALSE(loaded.Load(&mem, 3, remap));
+    auto t7 = clock::now();
+
+    std::printf("[ BENCH    ] legacy   insert %.2f ms, lookup %.2f ms\n", Ms(t0, t1), Ms(t1, t2));
+    std::printf("[ BENCH    ] interned insert %.2f ms, lookup %.2f ms, save %.2f ms, load %.2f ms\n",
+                Ms(t3, t4), Ms(t4, t5), Ms(t5, t6), Ms(t6, t7));
+    std::printf("[ BENCH    ] interned arena %zu KB for %zu strings, co-save %zu KB\n",
+                table.ArenaBytes() / 1024, table.Size(), mem.data.size() / 1024);
+
+    EXPECT_EQ(legacyHits, kStrings);
+    EXPECT_EQ(hits, kStrings);
+    EXPECT_EQ(loaded.Size(), kStrings);
+}
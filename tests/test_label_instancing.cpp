@@ -0,0 +1,460 @@
+/**
+ * Unit tests for nameplate instancing using Google Test.
+ *
+ * Builds labels with a headless stand-in for the text passes DrawLabel emits
+ * (glow, shadow, outline, gradient fill) and checks that copying a group's
+ * template to another anchor, scale and alpha matches building the label
+ * from scratch. A benchmark compares 64 identical against 64 distinct labels.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "LabelInstancing.h"
+
+using LabelInstancing::CanInstance;
+using LabelInstancing::CopyIndices;
+using LabelInstancing::CopyVertices;
+using LabelInstancing::KeyBuilder;
+using LabelInstancing::MakeTransform;
+using LabelInstancing::PhaseSeed;
+using LabelInstancing::Registry;
+using LabelInstancing::ScaleBucket;
+using LabelInstancing::Template;
+
+// ============================================================================
+// Headless label builder
+// ============================================================================
+
+struct Vec2
+{
+    float x, y;
+};
+
+// Same layout as ImDrawVert
+struct Vertex
+{
+    Vec2 pos;
+    Vec2 uv;
+    std::uint32_t col;
+};
+
+struct DrawList
+{
+    std::vector<Vertex> vtx;
+    std::vector<std::uint16_t> idx;
+};
+
+static constexpr float kBaseSize = 64.0f;
+
+static std::uint32_t Col(int r, int g, int b, float a)
+{
+    const auto ch = [](int v) { return static_cast<std::uint32_t>(std::clamp(v, 0, 255)); };
+    const int alpha = static_cast<int>(std::clamp(a, 0.0f, 1.0f) * 255.0f + 0.5f);
+    return ch(r) | (ch(g) << 8) | (ch(b) << 16) | (ch(alpha) << 24);
+}
+
+// Fixed pseudo-font: glyph box and advance derived from the character
+static void GlyphMetrics(unsigned char c, float& x0, float& y0, float& x1, float& y1, float& advance)
+{
+    advance = 24.0f + static_cast<float>(c % 7) * 3.0f;
+    x0 = 1.5f;
+    x1 = advance - 2.0f;
+    y0 = 8.0f + static_cast<float>(c % 5);
+    y1 = 56.0f - static_cast<float>(c % 3);
+}
+
+// ImGui-style text run: origin truncated to whole pixels, one quad per glyph
+static void AddText(DrawList& l, float size, Vec2 pos, std::uint32_t col, const std::string& text)
+{
+    const float s = size / kBaseSize;
+    float x = std::trunc(pos.x);
+    const float y = std::trunc(pos.y);
+    for (unsigned char c : text)
+    {
+        float gx0, gy0, gx1, gy1, adv;
+        GlyphMetrics(c, gx0, gy0, gx1, gy1, adv);
+        if (c != ' ')
+        {
+            const auto base = static_cast<std::uint16_t>(l.vtx.size());
+            const float u0 = static_cast<float>(c % 16) / 16.0f, v0 = static_cast<float>(c / 16) / 16.0f;
+            const float u1 = u0 + 1.0f / 16.0f, v1 = v0 + 1.0f / 16.0f;
+            l.vtx.push_back({{x + gx0 * s, y + gy0 * s}, {u0, v0}, col});
+            l.vtx.push_back({{x + gx1 * s, y + gy0 * s}, {u1, v0}, col});
+            l.vtx.push_back({{x + gx1 * s, y + gy1 * s}, {u1, v1}, col});
+            l.vtx.push_back({{x + gx0 * s, y + gy1 * s}, {u0, v1}, col});
+            for (int i : {0, 1, 2, 0, 2, 3})
+                l.idx.push_back(static_cast<std::uint16_t>(base + i));
+        }
+        x += adv * s;
+    }
+}
+
+static float TextWidth(float size, const std::string& text)
+{
+    float w = 0.0f;
+    for (unsigned char c : text)
+    {
+        float gx0, gy0, gx1, gy1, adv;
+        GlyphMetrics(c, gx0, gy0, gx1, gy1, adv);
+        w += adv;
+    }
+    return w * size / kBaseSize;
+}
+
+// One piece of text with every pass DrawLabel emits for an NPC
+static void AddPiece(DrawList& l, float size, Vec2 pos, const std::string& text, float alpha, float scale)
+{
+    // Glow: three layers of eight samples, constant pixel radius
+    static constexpr float kLayers[3][2] = {{1.5f, 0.15f}, {1.0f, 0.25f}, {0.6f, 0.35f}};
+    for (const auto& layer : kLayers)
+    {
+        const float r = 4.0f * layer[0];
+        const std::uint32_t glow = Col(200, 220, 255, alpha * 0.6f * layer[1]);
+        const float d = r * 0.707f;
+        const Vec2 offsets[8] = {{r, 0}, {-r, 0}, {0, r}, {0, -r}, {d, d}, {-d, d}, {d, -d}, {-d, -d}};
+        for (const Vec2& o : offsets)
+            AddText(l, size, {pos.x + o.x, pos.y + o.y}, glow, text);
+    }
+
+    // Shadow
+    AddText(l, size, {pos.x + 2.0f, pos.y + 2.0f}, Col(0, 0, 0, alpha * 0.75f), text);
+
+    // Outline scales with the font
+    const float w = 1.5f * scale;
+    const std::uint32_t outline = Col(0, 0, 0, alpha);
+    AddText(l, size, {pos.x - w, pos.y}, outline, text);
+    AddText(l, size, {pos.x + w, pos.y}, outline, text);
+    AddText(l, size, {pos.x, pos.y - w}, outline, text);
+    AddText(l, size, {pos.x, pos.y + w}, outline, text);
+
+    // Gradient fill over the piece's bounds
+    const std::size_t start = l.vtx.size();
+    AddText(l, size, pos, Col(255, 255, 255, alpha), text);
+    float lo = 1e9f, hi = -1e9f;
+    for (std::size_t i = start; i < l.vtx.size(); ++i)
+    {
+        lo = std::min(lo, l.vtx[i].pos.x);
+        hi = std::max(hi, l.vtx[i].pos.x);
+    }
+    for (std::size_t i = start; i < l.vtx.size(); ++i)
+    {
+        const float t = (l.vtx[i].pos.x - lo) / std::max(hi - lo, 1e-3f);
+        l.vtx[i].col = Col(static_cast<int>(230 - 90 * t), static_cast<int>(190 + 40 * t), 120, alpha);
+    }
+}
+
+// Title above the name line, both centered on the anchor
+static void BuildLabel(DrawList& l, const std::string& title, const std::string& name,
+                       Vec2 anchor, float scale, float alpha)
+{
+    const float titleSize = 84.0f * scale, nameSize = 178.0f * scale;
+    AddPiece(l, titleSize, {anchor.x - TextWidth(titleSize, title) * 0.5f, anchor.y - 260.0f * scale}, title, alpha, scale);
+    AddPiece(l, nameSize, {anchor.x - TextWidth(nameSize, name) * 0.5f, anchor.y - 180.0f * scale}, name, alpha, scale);
+}
+
+// Build a label as the template of its group
+static Template BuildTemplate(DrawList& l, const std::string& title, const std::string& name,
+                              Vec2 anchor, float scale, float alpha)
+{
+    Template tpl;
+    tpl.vtxStart = static_cast<std::uint32_t>(l.vtx.size());
+    tpl.idxStart = static_cast<std::uint32_t>(l.idx.size());
+    tpl.idxBase = tpl.vtxStart;
+    BuildLabel(l, title, name, anchor, scale, alpha);
+    tpl.vtxCount = static_cast<std::uint32_t>(l.vtx.size()) - tpl.vtxStart;
+    tpl.idxCount = static_cast<std::uint32_t>(l.idx.size()) - tpl.idxStart;
+    tpl.anchorX = anchor.x;
+    tpl.anchorY = anchor.y;
+    tpl.scale = scale;
+    tpl.alpha = alpha;
+    return tpl;
+}
+
+// Append a copy of a template, the way Renderer's DrawInstance does
+static void AppendInstance(DrawList& l, const Template& tpl, Vec2 anchor, float scale, float alpha)
+{
+    const std::size_t v0 = l.vtx.size(), i0 = l.idx.size();
+    l.vtx.resize(v0 + tpl.vtxCount);
+    l.idx.resize(i0 + tpl.idxCount);
+    CopyVertices(l.vtx.data() + tpl.vtxStart, l.vtx.data() + v0, tpl.vtxCount,
+                 MakeTransform(tpl, anchor.x, anchor.y, scale, alpha));
+    CopyIndices(l.idx.data() + tpl.idxStart, l.idx.data() + i0, tpl.idxCount, tpl.idxBase,
+                static_cast<std::uint32_t>(v0));
+}
+
+struct Deviation
+{
+    float pos{0.0f};
+    int alpha{0};
+    int rgb{0};
+    bool uv{true};
+};
+
+static Deviation Compare(const Vertex* a, const Vertex* b, std::size_t n)
+{
+    Deviation d;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        d.pos = std::max({d.pos, std::abs(a[i].pos.x - b[i].pos.x), std::abs(a[i].pos.y - b[i].pos.y)});
+        d.uv = d.uv && a[i].uv.x == b[i].uv.x && a[i].uv.y == b[i].uv.y;
+        d.alpha = std::max(d.alpha, std::abs(static_cast<int>(a[i].col >> 24) - static_cast<int>(b[i].col >> 24)));
+        for (int c = 0; c < 3; ++c)
+        {
+            const int ca = static_cast<int>((a[i].col >> (c * 8)) & 0xFF);
+            const int cb = static_cast<int>((b[i].col >> (c * 8)) & 0xFF);
+            d.rgb = std::max(d.rgb, std::abs(ca - cb));
+        }
+    }
+    return d;
+}
+
+// Copy a template to a member and build the member fresh, then compare
+static Deviation CopyAgainstFresh(float tplScale, float tplAlpha, Vec2 at, float scale, float alpha)
+{
+    const std::string title = "Guard", name = "Whiterun Guard Lv.20";
+
+    DrawList copied;
+    const Template tpl = BuildTemplate(copied, title, name, {960.3f, 540.7f}, tplScale, tplAlpha);
+    AppendInstance(copied, tpl, at, scale, alpha);
+
+    DrawList fresh;
+    BuildLabel(fresh, title, name, at, scale, alpha);
+
+    EXPECT_EQ(fresh.vtx.size(), tpl.vtxCount);
+    EXPECT_EQ(fresh.idx.size(), tpl.idxCount);
+    if (fresh.vtx.size() != tpl.vtxCount)
+        return {};
+
+    // Copied indices must address the copied vertices exactly as fresh ones do
+    for (std::size_t i = 0; i < tpl.idxCount; ++i)
+        EXPECT_EQ(copied.idx[tpl.idxCount + i] - tpl.vtxCount, fresh.idx[i]) << "index " << i;
+
+    return Compare(copied.vtx.data() + tpl.vtxCount, fresh.vtx.data(), fresh.vtx.size());
+}
+
+// ============================================================================
+// Copy against fresh builds
+// ============================================================================
+
+TEST(LabelInstancingCopy, TranslationOnly)
+{
+    const Deviation d = CopyAgainstFresh(0.8f, 0.9f, {1312.6f, 388.2f}, 0.8f, 0.9f);
+    EXPECT_LE(d.pos, 1.0f);  // pixel truncation of the run origin
+    EXPECT_TRUE(d.uv);
+    EXPECT_EQ(d.alpha, 0);
+    EXPECT_EQ(d.rgb, 0);
+}
+
+TEST(LabelInstancingCopy, ScaleWithinBucket)
+{
+    const float tplScale = 0.62f, scale = 0.625f;
+    ASSERT_EQ(ScaleBucket(tplScale), ScaleBucket(scale));
+
+    const Deviation d = CopyAgainstFresh(tplScale, 1.0f, {820.0f, 900.5f}, scale, 1.0f);
+    EXPECT_LE(d.pos, 1.1f);
+    EXPECT_TRUE(d.uv);
+    EXPECT_LE(d.rgb, 1);  // gradient sampled at near-identical normalized x
+}
+
+TEST(LabelInstancingCopy, FadedMember)
+{
+    const Deviation d = CopyAgainstFresh(1.0f, 0.95f, {500.0f, 500.0f}, 1.0f, 0.35f);
+    EXPECT_LE(d.pos, 1.0f);
+    EXPECT_LE(d.alpha, 1);
+    EXPECT_EQ(d.rgb, 0);
+}
+
+TEST(LabelInstancingCopy, BrighterMemberWithinGain)
+{
+    const Deviation d = CopyAgainstFresh(1.0f, 0.5f, {500.0f, 500.0f}, 1.0f, 0.98f);
+    EXPECT_LE(d.alpha, 2);
+    EXPECT_EQ(d.rgb, 0);
+}
+
+TEST(LabelInstancingCopy, AlphaSaturates)
+{
+    Vertex src{{0, 0}, {0, 0}, Col(10, 20, 30, 0.9f)};
+    Vertex dst{};
+    LabelInstancing::Transform t;
+    t.alphaMul = 512;
+    CopyVertices(&src, &dst, 1, t);
+    EXPECT_EQ(dst.col >> 24, 255u);
+    EXPECT_EQ(dst.col & 0x00FFFFFFu, src.col & 0x00FFFFFFu);
+}
+
+TEST(LabelInstancingCopy, IndicesRebaseBothWays)
+{
+    const std::uint16_t src[] = {100, 101, 102, 100, 102, 103};
+    std::uint16_t dst[6];
+
+    CopyIndices(src, dst, 6, 100, 4000);
+    EXPECT_EQ(dst[0], 4000);
+    EXPECT_EQ(dst[5], 4003);
+
+    // After a vertex offset change the member's base can be below the template's
+    CopyIndices(src, dst, 6, 100, 0);
+    EXPECT_EQ(dst[0], 0);
+    EXPECT_EQ(dst[3], 0);
+    EXPECT_EQ(dst[5], 3);
+}
+
+// ============================================================================
+// Keys, buckets and seeds
+// ============================================================================
+
+TEST(LabelInstancingKey, DistinguishesPartsAndBoundaries)
+{
+    const auto key = [](std::initializer_list<const char*> parts, int tier) {
+        KeyBuilder k;
+        for (const char* p : parts)
+            k.Add(std::string_view(p));
+        return k.Add(tier).Value();
+    };
+
+    EXPECT_EQ(key({"Whiterun Guard", " Lv.20"}, 3), key({"Whiterun Guard", " Lv.20"}, 3));
+    EXPECT_NE(key({"Whiterun Guard", " Lv.20"}, 3), key({"Whiterun Guard", " Lv.21"}, 3));
+    EXPECT_NE(key({"Whiterun Guard", " Lv.20"}, 3), key({"Whiterun Guard", " Lv.20"}, 4));
+    EXPECT_NE(key({"ab", "c"}, 0), key({"a", "bc"}, 0));
+    EXPECT_NE(KeyBuilder().Add(true).Value(), KeyBuilder().Add(false).Value());
+}
+
+TEST(LabelInstancingKey, ScaleBucketsAreNarrowAndMonotonic)
+{
+    int prev = ScaleBucket(0.25f);
+    for (float s = 0.25f; s <= 1.5f; s += 0.001f)
+    {
+        const int b = ScaleBucket(s);
+        EXPECT_GE(b, prev);
+        prev = b;
+    }
+    EXPECT_EQ(ScaleBucket(1.0f), 0);
+    EXPECT_NE(ScaleBucket(1.0f), ScaleBucket(1.03f));
+    EXPECT_EQ(ScaleBucket(1.0f), ScaleBucket(1.005f));
+}
+
+TEST(LabelInstancingKey, PhaseSeeds)
+{
+    // Unquantized seeds keep the original per-actor formula
+    EXPECT_FLOAT_EQ(PhaseSeed(0x00012345u, false), static_cast<float>(0x00012345u & 1023) / 1023.0f);
+
+    std::set<float> seen;
+    for (std::uint32_t id = 0x00013B00u; id < 0x00013B00u + 256; ++id)
+    {
+        const float seed = PhaseSeed(id, true);
+        EXPECT_GE(seed, 0.0f);
+        EXPECT_LT(seed, 1.0f);
+        const float scaled = seed * LabelInstancing::kPhaseBuckets;
+        EXPECT_FLOAT_EQ(scaled, std::round(scaled));
+        seen.insert(seed);
+    }
+    // Sequential form IDs still cover every bucket
+    EXPECT_EQ(seen.size(), LabelInstancing::kPhaseBuckets);
+}
+
+TEST(LabelInstancingKey, AlphaGainBound)
+{
+    Template tpl;
+    tpl.alpha = 0.4f;
+    EXPECT_TRUE(CanInstance(tpl, 0.05f));
+    EXPECT_TRUE(CanInstance(tpl, 0.8f));
+    EXPECT_FALSE(CanInstance(tpl, 0.81f));
+    tpl.alpha = 0.0f;
+    EXPECT_FALSE(CanInstance(tpl, 0.1f));
+}
+
+TEST(LabelInstancingRegistry, FirstTemplateWinsUntilNextFrame)
+{
+    Registry r;
+    Template a, b;
+    a.vtxStart = 10;
+    b.vtxStart = 20;
+
+    EXPECT_EQ(r.Find(7), nullptr);
+    r.Add(7, a);
+    r.Add(7, b);
+    ASSERT_NE(r.Find(7), nullptr);
+    EXPECT_EQ(r.Find(7)->vtxStart, 10u);
+    EXPECT_EQ(r.GetStats().built, 1u);
+
+    r.BeginFrame();
+    EXPECT_EQ(r.Find(7), nullptr);
+    EXPECT_EQ(r.Size(), 0u);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+// One frame of labels through the same find-or-build flow as DrawLabel
+static void BuildFrame(DrawList& l, Registry& r, const std::vector<std::string>& names, bool instancing)
+{
+    l.vtx.clear();
+    l.idx.clear();
+    r.BeginFrame();
+
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        const Vec2 anchor{100.0f + static_cast<float>(i % 8) * 220.0f, 300.0f + static_cast<float>(i / 8) * 90.0f};
+        const float scale = 0.6f + 0.0004f * static_cast<float>(i);
+        const float alpha = 0.9f - 0.002f * static_cast<float>(i);
+
+        const std::uint64_t key = KeyBuilder().Add(std::string_view(names[i])).Add(ScaleBucket(scale)).Value();
+        if (instancing)
+        {
+            if (const Template* tpl = r.Find(key); tpl && CanInstance(*tpl, alpha))
+            {
+                AppendInstance(l, *tpl, anchor, scale, alpha);
+                r.CountInstance();
+                continue;
+            }
+        }
+        r.Add(key, BuildTemplate(l, "Guard", names[i], anchor, scale, alpha));
+    }
+}
+
+static double MicrosPerFrame(const std::vector<std::string>& names, bool instancing, std::size_t& vertices)
+{
+    static constexpr int kFrames = 200;
+    DrawList l;
+    Registry r;
+    BuildFrame(l, r, names, instancing);  // warm up buffers
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f)
+        BuildFrame(l, r, names, instancing);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    vertices = l.vtx.size();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / kFrames;
+}
+
+TEST(LabelInstancingBench, IdenticalAgainstDistinct)
+{
+    static constexpr int kLabels = 64;
+    const std::vector<std::string> identical(kLabels, "Whiterun Guard Lv.20");
+    std::vector<std::string> distinct;
+    for (int i = 0; i < kLabels; ++i)
+        distinct.push_back("Whiterun Guard " + std::to_string(10 + i) + " Lv.2" + std::to_string(i % 10));
+
+    std::size_t vIdentical = 0, vDistinct = 0, vBaseline = 0;
+    const double baselineUs = MicrosPerFrame(identical, false, vBaseline);
+    const double identicalUs = MicrosPerFrame(identical, true, vIdentical);
+    const double distinctUs = MicrosPerFrame(distinct, true, vDistinct);
+
+    std::printf("[ BENCH    ] %d labels: identical built %.1f us/frame, identical instanced %.1f us/frame (%.1fx), "
+                "distinct instanced %.1f us/frame\n",
+                kLabels, baselineUs, identicalUs, baselineUs / identicalUs, distinctUs);
+
+    // Instancing must not change what is drawn, only how it is produced
+    EXPECT_EQ(vIdentical, vBaseline);
+    EXPECT_LT(identicalUs, baselineUs);
+    EXPECT_LT(identicalUs, distinctUs);
+}
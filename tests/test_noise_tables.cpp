@@ -0,0 +1,297 @@
+/**
+ * Unit tests for precomputed effect noise tables using Google Test.
+ *
+ * Bounds the error of every table against its analytic version at several
+ * table sizes, checks that the noise fields tile without seams and that the
+ * empty set falls back to the exact math, and benchmarks the per-vertex cost
+ * of the Aurora, Plasma and Sparkle kernels and of FBM with and without
+ * tables.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "NoiseTables.h"
+
+using NoiseTables::kPeriod;
+using NoiseTables::Tables;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static constexpr float kTwoPi = 6.28318530718f;
+
+struct Point
+{
+    float x, y;
+};
+
+static std::vector<Point> RandomPoints(std::size_t count, float lo, float hi)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<Point> out(count);
+    for (auto& p : out)
+        p = {dist(rng), dist(rng)};
+    return out;
+}
+
+static Tables Built(int size)
+{
+    Tables t;
+    t.Build(size);
+    return t;
+}
+
+// Largest difference between a table sampler and its reference
+template <class Sample, class Reference>
+static float MaxError(const std::vector<Point>& points, Sample sample, Reference reference)
+{
+    float err = 0.0f;
+    for (const auto& p : points)
+        err = std::max(err, std::abs(sample(p.x, p.y) - reference(p.x, p.y)));
+    return err;
+}
+
+// ============================================================================
+// Analytic
+// ============================================================================
+
+TEST(NoiseTablesAnalytic, PeriodOnlyChangesTheWrappedCells) {
+    // Inside one tile (but its last column) the periodic field is the plain one
+    for (const auto& p : RandomPoints(2000, 0.0f, kPeriod - 1.0f))
+        EXPECT_FLOAT_EQ(NoiseTables::ValueNoise(p.x, p.y, kPeriod), NoiseTables::ValueNoise(p.x, p.y)) << p.x << ", " << p.y;
+}
+
+TEST(NoiseTablesAnalytic, PeriodicFieldsTile) {
+    for (const auto& p : RandomPoints(2000, -50.0f, 50.0f)) {
+        const float x = std::floor(p.x) + 0.25f;  // Exact after adding the period
+        EXPECT_FLOAT_EQ(NoiseTables::ValueNoise(x + kPeriod, p.y, kPeriod), NoiseTables::ValueNoise(x, p.y, kPeriod));
+        EXPECT_NEAR(NoiseTables::Fbm(x, p.y - kPeriod, kPeriod), NoiseTables::Fbm(x, p.y, kPeriod), 1e-5f);
+    }
+}
+
+TEST(NoiseTablesAnalytic, RangesAreUnit) {
+    float lo = 1.0f, hi = 0.0f;
+    for (const auto& p : RandomPoints(20000, -100.0f, 100.0f)) {
+        const float n = NoiseTables::ValueNoise(p.x, p.y);
+        const float f = NoiseTables::Fbm(p.x, p.y);
+        EXPECT_GE(n, 0.0f);
+        EXPECT_LT(n, 1.0f);
+        EXPECT_GE(f, 0.0f);
+        EXPECT_LT(f, 1.0f);
+        lo = std::min(lo, n);
+        hi = std::max(hi, n);
+    }
+    EXPECT_LT(lo, 0.05f);
+    EXPECT_GT(hi, 0.95f);
+}
+
+TEST(NoiseTablesAnalytic, SparkleLayersAreOffsetCells) {
+    EXPECT_EQ(NoiseTables::SparkleSeed(0, 3, -7), NoiseTables::CellHash(3, -7));
+    EXPECT_EQ(NoiseTables::SparkleSeed(1, 3, -7), NoiseTables::CellHash(53, 43));
+    EXPECT_EQ(NoiseTables::SparkleSeed(2, 3, -7), NoiseTables::CellHash(103, 93));
+    EXPECT_EQ(NoiseTables::SparkleSeed(3, 3, -7), NoiseTables::CellHash(203, 193));
+}
+
+// ============================================================================
+// Tables
+// ============================================================================
+
+TEST(NoiseTablesBuild, SizeIsNormalized) {
+    EXPECT_EQ(NoiseTables::NormalizeSize(0), 0);
+    EXPECT_EQ(NoiseTables::NormalizeSize(-5), 0);
+    EXPECT_EQ(NoiseTables::NormalizeSize(1), NoiseTables::kMinSize);
+    EXPECT_EQ(NoiseTables::NormalizeSize(300), 256);
+    EXPECT_EQ(NoiseTables::NormalizeSize(512), 512);
+    EXPECT_EQ(NoiseTables::NormalizeSize(1 << 20), NoiseTables::kMaxSize);
+    EXPECT_EQ(Built(300).Size(), 256);
+}
+
+TEST(NoiseTablesBuild, EmptyTablesAreExact) {
+    const Tables t;
+    EXPECT_EQ(t.Size(), 0);
+    for (const auto& p : RandomPoints(500, -100.0f, 100.0f)) {
+        EXPECT_EQ(t.Sin(p.x), std::sin(p.x));
+        EXPECT_EQ(t.Noise(p.x, p.y), NoiseTables::ValueNoise(p.x, p.y));
+        EXPECT_EQ(t.Fbm(p.x, p.y), NoiseTables::Fbm(p.x, p.y));
+        const auto cx = static_cast<std::int32_t>(p.x), cy = static_cast<std::int32_t>(p.y);
+        EXPECT_EQ(t.SparkleSeed(2, cx, cy), NoiseTables::SparkleSeed(2, cx, cy));
+    }
+}
+
+TEST(NoiseTablesBuild, SinErrorIsBounded) {
+    const auto points = RandomPoints(20000, -500.0f, 500.0f);
+    auto reference = [](float x, float) { return std::sin(x); };
+    EXPECT_LT(MaxError(points, [t = Built(64)](float x, float) { return t.Sin(x); }, reference), 2e-3f);
+    EXPECT_LT(MaxError(points, [t = Built(256)](float x, float) { return t.Sin(x); }, reference), 1.5e-4f);
+}
+
+TEST(NoiseTablesBuild, NoiseErrorIsBoundedAndFallsWithSize) {
+    const auto points = RandomPoints(20000, -100.0f, 100.0f);
+    auto reference = [](float x, float y) { return NoiseTables::ValueNoise(x, y, kPeriod); };
+
+    float previous = 1.0f;
+    for (const auto& [size, bound] : {std::pair{128, 0.08f}, std::pair{256, 0.025f}, std::pair{512, 0.006f}}) {
+        const Tables t = Built(size);
+        const float err = MaxError(points, [&t](float x, float y) { return t.Noise(x, y); }, reference);
+        std::printf("[ BENCH    ] noise table %4d: max error %.5f\n", size, err);
+        EXPECT_LT(err, bound) << size;
+        EXPECT_LT(err, previous * 0.5f) << size;
+        previous = err;
+    }
+}
+
+TEST(NoiseTablesBuild, FbmErrorIsBoundedAndFallsWithSize) {
+    const auto points = RandomPoints(20000, -100.0f, 100.0f);
+    auto reference = [](float x, float y) { return NoiseTables::Fbm(x, y, kPeriod); };
+
+    float previous = 1.0f;
+    for (const auto& [size, bound] : {std::pair{128, 0.12f}, std::pair{256, 0.05f}, std::pair{512, 0.025f}}) {
+        const Tables t = Built(size);
+        const float err = MaxError(points, [&t](float x, float y) { return t.Fbm(x, y); }, reference);
+        std::printf("[ BENCH    ] fbm table   %4d: max error %.5f\n", size, err);
+        EXPECT_LT(err, bound) << size;
+        EXPECT_LT(err, previous * 0.75f) << size;  // The finest octave has the fewest texels per cell
+        previous = err;
+    }
+}
+
+TEST(NoiseTablesBuild, NoiseHasNoSeamAtTheTileEdge) {
+    const Tables t = Built(256);
+    for (float y = 0.0f; y < kPeriod; y += 0.37f) {
+        const float eps = 1e-3f;
+        EXPECT_NEAR(t.Noise(kPeriod - eps, y), t.Noise(kPeriod + eps, y), 0.01f) << y;
+        EXPECT_NEAR(t.Fbm(y, -eps), t.Fbm(y, eps), 0.02f) << y;
+    }
+}
+
+TEST(NoiseTablesBuild, SparkleSeedsAreExactInsideOneTile) {
+    const Tables t = Built(128);
+    for (std::int32_t y = 0; y < 128; y += 3) {
+        for (std::int32_t x = 0; x < 128; x += 5) {
+            for (int layer = 0; layer < NoiseTables::kSparkleLayers; ++layer) {
+                ASSERT_EQ(t.SparkleSeed(layer, x, y), NoiseTables::SparkleSeed(layer, x, y));
+                ASSERT_EQ(t.SparkleSeed(layer, x - 128, y + 256), t.SparkleSeed(layer, x, y));
+            }
+        }
+    }
+}
+
+TEST(NoiseTablesConfigure, RebuildsOnlyOnSizeChange) {
+    NoiseTables::Configure(0);
+    EXPECT_EQ(NoiseTables::Active().Size(), 0);
+
+    NoiseTables::Configure(200);
+    EXPECT_EQ(NoiseTables::Active().Size(), 128);
+
+    NoiseTables::Configure(255);  // Same normalized size, kept
+    EXPECT_EQ(NoiseTables::Active().Size(), 128);
+
+    NoiseTables::Configure(0);
+    EXPECT_EQ(NoiseTables::Active().Size(), 0);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+// Headless per-vertex parts of the kernels, templated on the sine and noise
+template <class T>
+static float AuroraVertex(const T& t, float nx, float ny, float time)
+{
+    const float waves = 2.0f, sway = 0.3f;
+    float combined = t.Sin(nx * waves * kTwoPi + time * 1.2f + ny * 2.0f) +
+                     t.Sin(nx * waves * 0.7f * kTwoPi - time * 0.8f + ny * 1.5f) * 0.6f +
+                     t.Sin(nx * waves * 1.3f * kTwoPi + time * 0.5f - ny * 1.0f) * 0.4f;
+    const float curtain = t.Sin(ny * kTwoPi * 2.0f + time * 0.7f + nx * sway * 3.0f);
+    const float shimmer = t.Sin(time * 4.0f + nx * 12.0f + ny * 8.0f);
+    const float swayOffset = t.Sin(ny * 3.0f + time * 1.5f) * sway;
+    const float swayFactor = t.Sin((nx + swayOffset) * kTwoPi * waves + time);
+    return combined + curtain + shimmer + swayFactor;
+}
+
+template <class T>
+static float PlasmaVertex(const T& t, float nx, float ny, float time)
+{
+    const float f1 = 2.0f, f2 = 3.0f;
+    float plasma = t.Sin(nx * f1 * kTwoPi + time) + t.Sin(ny * f2 * kTwoPi + time * 0.7f) +
+                   t.Sin((nx + ny) * (f1 + f2) * 0.5f * kTwoPi + time * 1.3f) +
+                   t.Sin((nx - ny) * f1 * kTwoPi + time * 0.9f) * 0.5f;
+    const float cx1 = nx - 0.35f, cy1 = ny - 0.55f, cx2 = nx - 0.62f, cy2 = ny - 0.41f;
+    plasma += t.Sin(std::sqrt(cx1 * cx1 + cy1 * cy1) * f1 * kTwoPi * 2.0f - time * 1.2f);
+    plasma += t.Sin(std::sqrt(cx2 * cx2 + cy2 * cy2) * f2 * kTwoPi * 1.5f + time * 0.8f) * 0.7f;
+    return plasma;
+}
+
+template <class T>
+static float SparkleVertex(const T& t, float px, float py, float)
+{
+    auto cell = [](float v) { return static_cast<std::int32_t>(std::floor(v)); };
+    return t.SparkleSeed(0, cell(px * 0.06f), cell(py * 0.06f)) + t.SparkleSeed(1, cell(px * 0.12f), cell(py * 0.12f)) +
+           t.SparkleSeed(2, cell(px * 0.2f), cell(py * 0.2f)) + t.SparkleSeed(3, cell(px * 0.04f), cell(py * 0.04f));
+}
+
+template <class T>
+static float FbmVertex(const T& t, float nx, float ny, float time)
+{
+    return t.Fbm(nx * 6.0f - time, ny * 3.0f);
+}
+
+template <class Kernel>
+static double NsPerVertex(const std::vector<Point>& vertices, Kernel kernel)
+{
+    constexpr int kFrames = 200;
+    volatile float sink = 0.0f;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        float sum = 0.0f;
+        const float time = frame * (1.0f / 60.0f);
+        for (const auto& v : vertices)
+            sum += kernel(v.x, v.y, time);
+        sink = sink + sum;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(kFrames) * vertices.size());
+}
+
+TEST(NoiseTablesBenchmark, PerVertexCost) {
+    const Tables exact;
+    const Tables table = Built(NoiseTables::kDefaultSize);
+
+    // 64 labels x 120 vertices in normalized and in screen coordinates
+    const auto normalized = RandomPoints(64 * 120, 0.0f, 1.0f);
+    auto screen = RandomPoints(64 * 120, 0.0f, 1.0f);
+    for (auto& p : screen)
+        p = {p.x * 1920.0f, p.y * 1080.0f};
+
+    struct Row
+    {
+        const char* name;
+        double exactNs, tableNs;
+    };
+    const Row rows[] = {
+        {"aurora ", NsPerVertex(normalized, [&](float x, float y, float t) { return AuroraVertex(exact, x, y, t); }),
+         NsPerVertex(normalized, [&](float x, float y, float t) { return AuroraVertex(table, x, y, t); })},
+        {"plasma ", NsPerVertex(normalized, [&](float x, float y, float t) { return PlasmaVertex(exact, x, y, t); }),
+         NsPerVertex(normalized, [&](float x, float y, float t) { return PlasmaVertex(table, x, y, t); })},
+        {"sparkle", NsPerVertex(screen, [&](float x, float y, float t) { return SparkleVertex(exact, x, y, t); }),
+         NsPerVertex(screen, [&](float x, float y, float t) { return SparkleVertex(table, x, y, t); })},
+        {"fbm    ", NsPerVertex(normalized, [&](float x, float y, float t) { return FbmVertex(exact, x, y, t); }),
+         NsPerVertex(normalized, [&](float x, float y, float t) { return FbmVertex(table, x, y, t); })},
+    };
+    for (const auto& row : rows) {
+        std::printf("[ BENCH    ] %s analytic %6.2f ns/vertex, tables %6.2f ns/vertex (%.1fx)\n", row.name, row.exactNs,
+                    row.tableNs, row.exactNs / row.tableNs);
+    }
+
+    // One bilinear lookup against four octaves of hashed noise
+    EXPECT_LT(rows[3].tableNs, rows[3].exactNs);
+}
@@ -0,0 +1,332 @@
+/**
+ * Unit tests for the static occluder BVH using Google Test.
+ *
+ * Checks the tree against a brute force pass over every box on random
+ * scenes, the rule that boxes holding either end of a segment do not block
+ * it, the worker's cell and batch handling, and how the game's line of sight
+ * corrects the tree. Benchmarks builds and queries on a synthetic city.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "OcclusionBVH.h"
+
+using OcclusionBVH::Box;
+using OcclusionBVH::Correction;
+using OcclusionBVH::Segment;
+using OcclusionBVH::Tree;
+using OcclusionBVH::Worker;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static Box MakeBox(float x0, float y0, float z0, float x1, float y1, float z1) {
+    return Box{{x0, y0, z0}, {x1, y1, z1}};
+}
+
+static bool Inside(const Box& b, const float p[3]) {
+    for (int a = 0; a < 3; ++a)
+        if (p[a] < b.min[a] || p[a] > b.max[a]) return false;
+    return true;
+}
+
+// Reference: every box, in doubles
+static bool BruteForceBlocks(const std::vector<Box>& boxes, const float from[3], const float to[3]) {
+    for (const Box& box : boxes) {
+        if (Inside(box, from) || Inside(box, to)) continue;
+
+        double t0 = 0.0, t1 = 1.0;
+        bool hit = true;
+        for (int a = 0; a < 3 && hit; ++a) {
+            const double d = static_cast<double>(to[a]) - from[a];
+            if (d == 0.0) {
+                hit = from[a] >= box.min[a] && from[a] <= box.max[a];
+                continue;
+            }
+            double ta = (box.min[a] - from[a]) / d, tb = (box.max[a] - from[a]) / d;
+            if (ta > tb) std::swap(ta, tb);
+            t0 = std::max(t0, ta);
+            t1 = std::min(t1, tb);
+            hit = t0 <= t1;
+        }
+        if (hit) return true;
+    }
+    return false;
+}
+
+// Buildings on a street grid, with clutter between them. Units are
+// Skyrim's: a cell is 4096 wide, an actor about 128 tall.
+static std::vector<Box> MakeCity(int blocks, int clutterPerBlock, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float spacing = 1024.0f;
+    std::vector<Box> boxes;
+    boxes.reserve(static_cast<size_t>(blocks) * blocks * (1 + clutterPerBlock));
+    for (int x = 0; x < blocks; ++x) {
+        for (int y = 0; y < blocks; ++y) {
+            const float x0 = x * spacing + 128.0f, y0 = y * spacing + 128.0f;
+            const float w = 400.0f + 300.0f * unit(rng), d = 400.0f + 300.0f * unit(rng);
+            const float h = 300.0f + 900.0f * unit(rng);
+            boxes.push_back(MakeBox(x0, y0, 0.0f, x0 + w, y0 + d, h));
+            for (int c = 0; c < clutterPerBlock; ++c) {
+                const float cx = x * spacing + spacing * unit(rng), cy = y * spacing + spacing * unit(rng);
+                const float s = 48.0f + 96.0f * unit(rng);
+                boxes.push_back(MakeBox(cx, cy, 0.0f, cx + s, cy + s, s));
+            }
+        }
+    }
+    return boxes;
+}
+
+// Camera and head of an actor near the street level somewhere in the city
+static Segment MakeSegment(std::uint32_t id, float extent, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, extent);
+    Segment s{id, {pos(rng), pos(rng), 150.0f}, {0.0f, 0.0f, 115.0f}};
+    std::uniform_real_distribution<float> offset(-3000.0f, 3000.0f);
+    s.to[0] = s.from[0] + offset(rng);
+    s.to[1] = s.from[1] + offset(rng);
+    return s;
+}
+
+// ============================================================================
+// Tree
+// ============================================================================
+
+TEST(OcclusionBVHTest, EmptyTreeBlocksNothing) {
+    Tree tree;
+    tree.Build({});
+    const float from[3] = {0, 0, 0}, to[3] = {100, 100, 100};
+    EXPECT_FALSE(tree.Blocks(from, to));
+    EXPECT_EQ(tree.NodeCount(), 0u);
+}
+
+TEST(OcclusionBVHTest, WallBetweenEndsBlocks) {
+    Tree tree;
+    tree.Build({MakeBox(40, -100, -100, 60, 100, 100)});
+    const float from[3] = {0, 0, 0}, to[3] = {100, 0, 0};
+    EXPECT_TRUE(tree.Blocks(from, to));
+    EXPECT_TRUE(tree.Blocks(to, from));
+}
+
+TEST(OcclusionBVHTest, WallBesideOrBeyondDoesNotBlock) {
+    Tree tree;
+    tree.Build({MakeBox(40, 10, -100, 60, 100, 100), MakeBox(140, -100, -100, 160, 100, 100)});
+    const float from[3] = {0, 0, 0}, to[3] = {100, 0, 0};
+    EXPECT_FALSE(tree.Blocks(from, to));
+}
+
+TEST(OcclusionBVHTest, BoxHoldingAnEndDoesNotBlock) {
+    // The camera stands in a building's yard, the actor inside another
+    Tree tree;
+    tree.Build({MakeBox(-50, -50, -50, 50, 50, 50), MakeBox(150, -50, -50, 250, 50, 50)});
+    const float from[3] = {0, 0, 0}, to[3] = {200, 0, 0};
+    EXPECT_FALSE(tree.Blocks(from, to));
+
+    // From outside, the first building is in the way again
+    const float outside[3] = {-100, 0, 0};
+    EXPECT_TRUE(tree.Blocks(outside, to));
+    const float between[3] = {100, 0, 0};
+    EXPECT_FALSE(tree.Blocks(between, to));
+}
+
+TEST(OcclusionBVHTest, AxisAlignedSegmentsAndEmptyBoxes) {
+    Tree tree;
+    tree.Build({MakeBox(10, -1, -1, 20, 1, 1), MakeBox(5, 5, 5, -5, -5, -5)});
+    EXPECT_EQ(tree.BoxCount(), 1u);
+
+    const float from[3] = {0, 0, 0}, along[3] = {30, 0, 0}, above[3] = {30, 0, 2}, up[3] = {0, 0, 30};
+    EXPECT_TRUE(tree.Blocks(from, along));
+    EXPECT_FALSE(tree.Blocks(from, up));
+    const float high[3] = {0, 0, 2};
+    EXPECT_FALSE(tree.Blocks(high, above));
+}
+
+TEST(OcclusionBVHTest, MatchesBruteForceOnRandomScenes) {
+    std::mt19937 rng(75);
+    std::uniform_real_distribution<float> pos(0.0f, 5000.0f), size(10.0f, 600.0f);
+    for (int scene = 0; scene < 20; ++scene) {
+        std::vector<Box> boxes;
+        const int count = 1 + static_cast<int>(rng() % 400);
+        for (int i = 0; i < count; ++i) {
+            const float x = pos(rng), y = pos(rng), z = pos(rng) * 0.2f;
+            boxes.push_back(MakeBox(x, y, z, x + size(rng), y + size(rng), z + size(rng)));
+        }
+        Tree tree;
+        tree.Build(boxes);
+        EXPECT_LT(tree.NodeCount(), boxes.size() * 2);
+
+        for (int q = 0; q < 500; ++q) {
+            const float from[3] = {pos(rng), pos(rng), pos(rng) * 0.2f};
+            const float to[3] = {pos(rng), pos(rng), pos(rng) * 0.2f};
+            ASSERT_EQ(tree.Blocks(from, to), BruteForceBlocks(boxes, from, to)) << "scene " << scene << " query " << q;
+        }
+    }
+}
+
+TEST(OcclusionBVHTest, IdenticalBoxesStillSplit) {
+    // Every centroid equal: the median split still has to terminate
+    std::vector<Box> boxes(1000, MakeBox(0, 0, 0, 10, 10, 10));
+    Tree tree;
+    tree.Build(boxes);
+    EXPECT_EQ(tree.BoxCount(), 1000u);
+    const float from[3] = {-10, 5, 5}, to[3] = {20, 5, 5};
+    EXPECT_TRUE(tree.Blocks(from, to));
+}
+
+// ============================================================================
+// Correction
+// ============================================================================
+
+TEST(OcclusionBVHTest, ResolveWithoutGameCheckFollowsTree) {
+    Correction c;
+    EXPECT_TRUE(OcclusionBVH::Resolve(c, true));
+    EXPECT_FALSE(OcclusionBVH::Resolve(c, false));
+}
+
+TEST(OcclusionBVHTest, ResolveKeepsGameAnswerUntilTreeChanges) {
+    // Terrain hides the actor, which the tree cannot see
+    Correction c{true, true, true, false};
+    EXPECT_TRUE(OcclusionBVH::Resolve(c, false));
+
+    // The actor walked behind a building after the check
+    c = Correction{true, false, true, false};
+    EXPECT_TRUE(OcclusionBVH::Resolve(c, true));
+    EXPECT_FALSE(OcclusionBVH::Resolve(c, false));
+}
+
+TEST(OcclusionBVHTest, ResolveWithoutTreeAtCheckKeepsGameAnswer) {
+    Correction c{true, true, false, false};
+    EXPECT_TRUE(OcclusionBVH::Resolve(c, false));
+    EXPECT_TRUE(OcclusionBVH::Resolve(c, true));
+}
+
+// ============================================================================
+// Worker
+// ============================================================================
+
+TEST(OcclusionBVHTest, WorkerWithoutCellsHasNoAnswers) {
+    Worker worker;
+    worker.Submit({Segment{1, {0, 0, 0}, {100, 0, 0}}});
+    worker.Flush();
+    bool occluded = false;
+    EXPECT_FALSE(worker.Find(1, occluded));
+    EXPECT_EQ(worker.Batches(), 1u);
+}
+
+TEST(OcclusionBVHTest, WorkerPublishesBatchResults) {
+    Worker worker;
+    worker.SetCell(0x3C, {MakeBox(40, -100, -100, 60, 100, 100)});
+    worker.Submit({Segment{7, {0, 0, 0}, {100, 0, 0}}, Segment{3, {0, 200, 0}, {100, 200, 0}}});
+    worker.Flush();
+
+    bool occluded = false;
+    ASSERT_TRUE(worker.Find(7, occluded));
+    EXPECT_TRUE(occluded);
+    ASSERT_TRUE(worker.Find(3, occluded));
+    EXPECT_FALSE(occluded);
+    EXPECT_FALSE(worker.Find(5, occluded));
+}
+
+TEST(OcclusionBVHTest, WorkerRebuildsWhenCellsChange) {
+    Worker worker;
+    const Segment segment{1, {0, 0, 0}, {100, 0, 0}};
+    worker.SetCell(1, {MakeBox(40, -100, -100, 60, 100, 100)});
+    worker.SetCell(2, {MakeBox(500, 500, 500, 600, 600, 600)});
+    worker.Submit({segment});
+    worker.Flush();
+
+    bool occluded = false;
+    ASSERT_TRUE(worker.Find(1, occluded));
+    EXPECT_TRUE(occluded);
+
+    auto cells = worker.Cells();
+    std::sort(cells.begin(), cells.end());
+    EXPECT_EQ(cells, (std::vector<std::uint32_t>{1, 2}));
+
+    worker.RemoveCell(1);
+    worker.Submit({segment});
+    worker.Flush();
+    ASSERT_TRUE(worker.Find(1, occluded));
+    EXPECT_FALSE(occluded);
+
+    worker.RemoveCell(2);
+    worker.Submit({segment});
+    worker.Flush();
+    EXPECT_FALSE(worker.Find(1, occluded));
+    EXPECT_TRUE(worker.Cells().empty());
+}
+
+TEST(OcclusionBVHTest, WorkerClearDropsEverything) {
+    Worker worker;
+    worker.SetCell(1, {MakeBox(40, -100, -100, 60, 100, 100)});
+    worker.Submit({Segment{1, {0, 0, 0}, {100, 0, 0}}});
+    worker.Flush();
+
+    worker.Clear();
+    bool occluded = false;
+    EXPECT_FALSE(worker.Find(1, occluded));
+    EXPECT_TRUE(worker.Cells().empty());
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(OcclusionBVHBenchmark, SyntheticCity) {
+    // 160 x 160 blocks is about 40 x 40 cells, far beyond the loaded area
+    std::mt19937 rng(2026);
+    const int kBlocks = 160;
+    const std::vector<Box> boxes = MakeCity(kBlocks, 2, rng);
+    const float extent = kBlocks * 1024.0f;
+
+    auto t0 = std::chrono::steady_clock::now();
+    Tree tree;
+    tree.Build(boxes);
+    auto t1 = std::chrono::steady_clock::now();
+
+    constexpr int kQueries = 20000;
+    std::vector<Segment> segments;
+    for (int i = 0; i < kQueries; ++i) segments.push_back(MakeSegment(static_cast<std::uint32_t>(i), extent, rng));
+
+    int blocked = 0;
+    auto t2 = std::chrono::steady_clock::now();
+    for (const Segment& s : segments) blocked += tree.Blocks(s.from, s.to) ? 1 : 0;
+    auto t3 = std::chrono::steady_clock::now();
+
+    // Brute force on a sample only, it is hundreds of times slower
+    constexpr int kBruteQueries = 200;
+    int bruteBlocked = 0, treeSample = 0;
+    auto t4 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kBruteQueries; ++i)
+        bruteBlocked += BruteForceBlocks(boxes, segments[i].from, segments[i].to) ? 1 : 0;
+    auto t5 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kBruteQueries; ++i) treeSample += tree.Blocks(segments[i].from, segments[i].to) ? 1 : 0;
+    EXPECT_EQ(treeSample, bruteBlocked);
+    EXPECT_GT(blocked, 0);
+    EXPECT_LT(blocked, kQueries);
+
+    // A scan's worth of actors through the worker
+    Worker worker;
+    worker.SetCell(1, boxes);
+    worker.Flush();
+    std::vector<Segment> scan(segments.begin(), segments.begin() + 64);
+    auto t6 = std::chrono::steady_clock::now();
+    worker.Submit(scan);
+    worker.Flush();
+    auto t7 = std::chrono::steady_clock::now();
+
+    const double buildMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    const double treeNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / kQueries;
+    const double bruteNs = std::chrono::duration<double, std::nano>(t5 - t4).count() / kBruteQueries;
+    const double scanUs = std::chrono::duration<double, std::micro>(t7 - t6).count();
+    std::printf("[ BENCH    ] %zu boxes, %zu nodes, %.1f KiB: build %.1f ms, %.0f ns/ray BVH vs %.0f ns/ray brute force, "
+                "%.1f%% blocked\n",
+                tree.BoxCount(), tree.NodeCount(), tree.Bytes() / 1024.0, buildMs, treeNs, bruteNs,
+                100.0 * blocked / kQueries);
+    std::printf("[ BENCH    ] 64 actor scan on the worker: %.0f us submit to publish\n", scanUs);
+}
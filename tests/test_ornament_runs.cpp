@@ -0,0 +1,202 @@
+/**
+ * Unit tests for ornament glyph runs using Google Test.
+ *
+ * Compiles ornament strings against a fake font and checks that only
+ * drawable characters survive (valid UTF-8, not control, present in the
+ * font), that advances are cached in order, and that the table answers for
+ * tiers and special titles added after the last build.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "OrnamentRuns.h"
+
+using OrnamentRuns::Compile;
+using OrnamentRuns::GlyphLookup;
+using OrnamentRuns::Run;
+using OrnamentRuns::Table;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Font with a fixed set of glyphs; counts lookups
+struct FakeFont
+{
+    std::map<std::uint32_t, float> advances{
+        {'A', 10.0f}, {'B', 12.0f}, {'C', 8.0f}, {'D', 9.0f},
+        {0x2726, 20.0f},   // Four pointed star, 3 bytes
+        {0x1F451, 24.0f},  // Crown, 4 bytes
+    };
+    int lookups = 0;
+
+    GlyphLookup Lookup()
+    {
+        return [this](std::uint32_t cp, float& advance) {
+            ++lookups;
+            const auto it = advances.find(cp);
+            if (it == advances.end())
+                return false;
+            advance = it->second;
+            return true;
+        };
+    }
+};
+
+static std::vector<std::string> Chars(const Run& run)
+{
+    std::vector<std::string> out;
+    for (const auto& g : run.glyphs)
+        out.emplace_back(g.utf8.data());
+    return out;
+}
+
+// ============================================================================
+// Compile
+// ============================================================================
+
+TEST(OrnamentRunsCompile, KeepsOrderAndAdvances) {
+    FakeFont font;
+    const auto run = Compile("ABC", font.Lookup());
+    ASSERT_EQ(run.glyphs.size(), 3u);
+    EXPECT_EQ(Chars(run), (std::vector<std::string>{"A", "B", "C"}));
+    EXPECT_FLOAT_EQ(run.glyphs[1].advance, 12.0f);
+    EXPECT_FLOAT_EQ(run.advance, 30.0f);
+}
+
+TEST(OrnamentRunsCompile, MultiByteCharactersAreCopiedWhole) {
+    FakeFont font;
+    const auto run = Compile("\xE2\x9C\xA6" "A" "\xF0\x9F\x91\x91", font.Lookup());
+    ASSERT_EQ(run.glyphs.size(), 3u);
+    EXPECT_STREQ(run.glyphs[0].utf8.data(), "\xE2\x9C\xA6");
+    EXPECT_STREQ(run.glyphs[1].utf8.data(), "A");
+    EXPECT_STREQ(run.glyphs[2].utf8.data(), "\xF0\x9F\x91\x91");
+    EXPECT_FLOAT_EQ(run.advance, 54.0f);
+}
+
+TEST(OrnamentRunsCompile, DropsMissingGlyphs) {
+    FakeFont font;
+    const auto run = Compile("AxB?", font.Lookup());
+    EXPECT_EQ(Chars(run), (std::vector<std::string>{"A", "B"}));
+}
+
+TEST(OrnamentRunsCompile, DropsControlCharacters) {
+    FakeFont font;
+    font.advances['\t'] = 4.0f;  // Even if the font had one
+    const auto run = Compile("A\tB\n", font.Lookup());
+    EXPECT_EQ(Chars(run), (std::vector<std::string>{"A", "B"}));
+}
+
+TEST(OrnamentRunsCompile, DropsMalformedUtf8) {
+    FakeFont font;
+    font.advances[0xFFFD] = 7.0f;  // A replacement glyph is never drawn
+
+    // Lone continuation, lead byte without continuation, truncated 3-byte tail
+    const std::string text = std::string("A") + "\x9C" + "B" + "\xE2" + "C" + "\xE2\x9C";
+    const auto run = Compile(text, font.Lookup());
+    EXPECT_EQ(Chars(run), (std::vector<std::string>{"A", "B", "C"}));
+}
+
+TEST(OrnamentRunsCompile, EmptyStringIsEmptyRun) {
+    FakeFont font;
+    const auto run = Compile("", font.Lookup());
+    EXPECT_TRUE(run.Empty());
+    EXPECT_FLOAT_EQ(run.advance, 0.0f);
+    EXPECT_EQ(font.lookups, 0);
+}
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+TEST(OrnamentRunsLayout, CachedAdvancesMatchPerFrameMeasurement) {
+    // The draw path scales cached advances instead of measuring each character
+    FakeFont font;
+    const float fontSize = 64.0f;
+    const float drawSize = 37.5f;
+    const float gap = 6.0f;
+    const std::string text = "\xE2\x9C\xA6" "AB\xF0\x9F\x91\x91";
+    const auto run = Compile(text, font.Lookup());
+
+    std::vector<float> cached;
+    float x = 100.0f;
+    for (const auto& g : run.glyphs) {
+        cached.push_back(x);
+        x += g.advance * (drawSize / fontSize) + gap;
+    }
+
+    // Measured per frame: look every character up again at draw size
+    std::vector<float> measured;
+    x = 100.0f;
+    for (const auto& g : run.glyphs) {
+        std::uint32_t cp = 0;
+        const auto* p = reinterpret_cast<const unsigned char*>(g.utf8.data());
+        const auto len = std::strlen(g.utf8.data());
+        cp = len == 1 ? p[0] : len == 3 ? ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F)
+                                        : ((p[0] & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        measured.push_back(x);
+        x += font.advances.at(cp) * drawSize / fontSize + gap;
+    }
+
+    ASSERT_EQ(cached.size(), measured.size());
+    for (size_t i = 0; i < cached.size(); ++i)
+        EXPECT_NEAR(cached[i], measured[i], 1e-4f) << i;
+}
+
+// ============================================================================
+// Table
+// ============================================================================
+
+TEST(OrnamentRunsTable, StartsInvalidAndBuildsOnce) {
+    FakeFont font;
+    Table table;
+    EXPECT_FALSE(table.Valid());
+
+    table.Reset();
+    table.AddTier("A", "B", font.Lookup());
+    table.AddTier("", "C", font.Lookup());
+    table.AddSpecial("\xE2\x9C\xA6", "", font.Lookup());
+    EXPECT_TRUE(table.Valid());
+
+    const int lookupsAfterBuild = font.lookups;
+    for (int frame = 0; frame < 100; ++frame) {
+        EXPECT_EQ(table.Tier(0).left.glyphs.size(), 1u);
+        EXPECT_TRUE(table.Tier(1).left.Empty());
+        EXPECT_EQ(table.Special(0).left.glyphs.size(), 1u);
+    }
+    EXPECT_EQ(font.lookups, lookupsAfterBuild);
+}
+
+TEST(OrnamentRunsTable, ResetWithoutEntriesIsValid) {
+    // No ornament font: nothing to draw, and no rebuild every frame
+    Table table;
+    table.Reset();
+    EXPECT_TRUE(table.Valid());
+    EXPECT_TRUE(table.Tier(0).Empty());
+}
+
+TEST(OrnamentRunsTable, InvalidateDropsRuns) {
+    FakeFont font;
+    Table table;
+    table.Reset();
+    table.AddTier("AB", "CD", font.Lookup());
+
+    table.Invalidate();
+    EXPECT_FALSE(table.Valid());
+    EXPECT_TRUE(table.Tier(0).Empty());
+}
+
+TEST(OrnamentRunsTable, EntriesAddedAfterBuildAreEmpty) {
+    FakeFont font;
+    Table table;
+    table.Reset();
+    table.AddTier("A", "B", font.Lookup());
+
+    EXPECT_TRUE(table.Tier(5).Empty());
+    EXPECT_TRUE(table.Special(0).Empty());
+}
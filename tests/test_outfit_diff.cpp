@@ -0,0 +1,201 @@
+/**
+ * Unit tests for outfit copy diffing using Google Test.
+ *
+ * Exercises OutfitDiff::ComputePlan against small hand-built inventories
+ * and large synthetic ones, checking additions, equips, slot conflicts
+ * and skipped items without a running game.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+#include "OutfitDiff.h"
+
+using OutfitDiff::ComputePlan;
+using OutfitDiff::InventoryEntry;
+using OutfitDiff::SkipReason;
+
+// Biped slot bits used in the tests (matching BipedObjectSlot layout)
+constexpr std::uint32_t kHead = 1u << 0;
+constexpr std::uint32_t kHair = 1u << 1;
+constexpr std::uint32_t kBody = 1u << 2;
+constexpr std::uint32_t kHands = 1u << 3;
+constexpr std::uint32_t kFeet = 1u << 7;
+
+static bool Contains(const std::vector<std::size_t>& v, std::size_t x) {
+    return std::find(v.begin(), v.end(), x) != v.end();
+}
+
+// ============================================================================
+// Basic diff rules
+// ============================================================================
+
+TEST(OutfitDiffTest, EmptyInventories) {
+    auto plan = ComputePlan({}, {});
+    EXPECT_TRUE(plan.add.empty());
+    EXPECT_TRUE(plan.equip.empty());
+    EXPECT_TRUE(plan.skipped.empty());
+    EXPECT_EQ(plan.equipSlots, 0u);
+}
+
+TEST(OutfitDiffTest, MissingItemIsAddedAndEquipped) {
+    std::vector<InventoryEntry> source = {{0x10, kBody, true}};
+    auto plan = ComputePlan(source, {});
+    ASSERT_EQ(plan.add.size(), 1u);
+    ASSERT_EQ(plan.equip.size(), 1u);
+    EXPECT_EQ(plan.add[0], 0u);
+    EXPECT_EQ(plan.equipSlots, kBody);
+}
+
+TEST(OutfitDiffTest, OwnedUnwornItemIsOnlyEquipped) {
+    std::vector<InventoryEntry> source = {{0x10, kBody, true}};
+    std::vector<InventoryEntry> player = {{0x10, kBody, false}};
+    auto plan = ComputePlan(source, player);
+    EXPECT_TRUE(plan.add.empty());
+    ASSERT_EQ(plan.equip.size(), 1u);
+}
+
+TEST(OutfitDiffTest, AlreadyWornItemIsSkipped) {
+    std::vector<InventoryEntry> source = {{0x10, kBody, true}};
+    std::vector<InventoryEntry> player = {{0x10, kBody, true}};
+    auto plan = ComputePlan(source, player);
+    EXPECT_TRUE(plan.equip.empty());
+    ASSERT_EQ(plan.skipped.size(), 1u);
+    EXPECT_EQ(plan.skipped[0].reason, SkipReason::AlreadyWorn);
+    EXPECT_TRUE(plan.displaced.empty());
+}
+
+TEST(OutfitDiffTest, UnwornSourceItemsAreIgnored) {
+    std::vector<InventoryEntry> source = {{0x10, kBody, false}, {0x11, kFeet, false}};
+    auto plan = ComputePlan(source, {});
+    EXPECT_TRUE(plan.equip.empty());
+    EXPECT_TRUE(plan.skipped.empty());
+}
+
+TEST(OutfitDiffTest, DuplicateSourceFormIsSkipped) {
+    std::vector<InventoryEntry> source = {{0x10, kBody, true}, {0x10, kBody, true}};
+    auto plan = ComputePlan(source, {});
+    EXPECT_EQ(plan.add.size(), 1u);
+    ASSERT_EQ(plan.skipped.size(), 1u);
+    EXPECT_EQ(plan.skipped[0].reason, SkipReason::Duplicate);
+}
+
+// ============================================================================
+// Biped slot conflicts
+// ============================================================================
+
+TEST(OutfitDiffTest, OverlappingSourceSlotsKeepFirst) {
+    std::vector<InventoryEntry> source = {
+        {0x10, kHead | kHair, true},
+        {0x11, kHair, true},
+        {0x12, kHands, true},
+    };
+    auto plan = ComputePlan(source, {});
+    EXPECT_TRUE(Contains(plan.equip, 0));
+    EXPECT_FALSE(Contains(plan.equip, 1));
+    EXPECT_TRUE(Contains(plan.equip, 2));
+    ASSERT_EQ(plan.skipped.size(), 1u);
+    EXPECT_EQ(plan.skipped[0].sourceIndex, 1u);
+    EXPECT_EQ(plan.skipped[0].reason, SkipReason::SlotConflict);
+}
+
+TEST(OutfitDiffTest, PlayerWornConflictsAreDisplaced) {
+    std::vector<InventoryEntry> source = {{0x10, kBody, true}};
+    std::vector<InventoryEntry> player = {
+        {0x20, kBody, true},   // replaced
+        {0x21, kFeet, true},   // untouched
+        {0x22, kBody, false},  // not worn
+    };
+    auto plan = ComputePlan(source, player);
+    ASSERT_EQ(plan.displaced.size(), 1u);
+    EXPECT_EQ(plan.displaced[0], 0u);
+}
+
+TEST(OutfitDiffTest, SlotlessItemsNeverConflict) {
+    std::vector<InventoryEntry> source = {{0x10, 0, true}, {0x11, 0, true}};
+    auto plan = ComputePlan(source, {});
+    EXPECT_EQ(plan.equip.size(), 2u);
+}
+
+// ============================================================================
+// Large synthetic inventories
+// ============================================================================
+
+TEST(OutfitDiffTest, ThousandsOfEntriesMatchReferenceDiff) {
+    constexpr std::uint32_t kPlayerItems = 5000;
+    constexpr std::uint32_t kSourceItems = 3000;
+
+    // Player owns forms 0..4999, wears every 97th piece on a rotating slot
+    std::vector<InventoryEntry> player;
+    for (std::uint32_t i = 0; i < kPlayerItems; ++i) {
+        player.push_back({0x1000 + i, 1u << (i % 32), i % 97 == 0});
+    }
+
+    // Source wears 32 single-slot pieces spread across owned and unowned forms
+    std::vector<InventoryEntry> source;
+    for (std::uint32_t i = 0; i < kSourceItems; ++i) {
+        const bool worn = i % 90 == 0 && i / 90 < 32;
+        const std::uint32_t slot = worn ? 1u << (i / 90) : 1u << (i % 32);
+        source.push_back({0x1000 + i * 2, slot, worn});
+    }
+
+    auto plan = ComputePlan(source, player);
+
+    // Reference: naive per-item scan of the player inventory
+    std::uint32_t usedSlots = 0;
+    std::size_t expectAdd = 0, expectEquip = 0, expectSkip = 0;
+    for (const auto& s : source) {
+        if (!s.worn) continue;
+        if (s.slots & usedSlots) { ++expectSkip; continue; }
+        const InventoryEntry* owned = nullptr;
+        for (const auto& p : player) {
+            if (p.formID == s.formID) { owned = &p; break; }
+        }
+        usedSlots |= s.slots;
+        if (owned && owned->worn) { ++expectSkip; continue; }
+        if (!owned) ++expectAdd;
+        ++expectEquip;
+    }
+
+    EXPECT_EQ(plan.add.size(), expectAdd);
+    EXPECT_EQ(plan.equip.size(), expectEquip);
+    EXPECT_EQ(plan.skipped.size(), expectSkip);
+    EXPECT_EQ(plan.equipSlots, usedSlots);
+    EXPECT_GT(plan.add.size(), 0u);
+
+    // Every add is also equipped, and no index is equipped twice
+    std::unordered_set<std::size_t> equipSet(plan.equip.begin(), plan.equip.end());
+    EXPECT_EQ(equipSet.size(), plan.equip.size());
+    for (std::size_t idx : plan.add) {
+        EXPECT_TRUE(equipSet.count(idx));
+    }
+}
+
+TEST(OutfitDiffBenchmark, LargeInventoryDiff) {
+    constexpr std::uint32_t kPlayerItems = 20000;
+    constexpr int kIterations = 20;
+
+    std::vector<InventoryEntry> player;
+    for (std::uint32_t i = 0; i < kPlayerItems; ++i) {
+        player.push_back({0x1000 + i, 1u << (i % 32), false});
+    }
+    std::vector<InventoryEntry> source;
+    for (std::uint32_t i = 0; i < 32; ++i) {
+        source.push_back({0x1000 + kPlayerItems - 1 - i, 1u << i, true});
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::size_t total = 0;
+    for (int n = 0; n < kIterations; ++n) {
+        total += ComputePlan(source, player).equip.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / kIterations;
+    std::printf("[ BENCH    ] diff 32 worn vs %u owned: %.1f us\n", kPlayerItems, us);
+    EXPECT_EQ(total, static_cast<std::size_t>(32 * kIterations));
+}
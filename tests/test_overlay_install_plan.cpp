@@ -0,0 +1,316 @@
+/**
+ * Unit tests for batched overlay installation using Google Test.
+ *
+ * Builds the overlay slot plan with the SKEE node name formats and walks
+ * synthetic skeletons with overlays installed, checking that one walk finds
+ * the same nodes as a GetObjectByName search per slot, and benchmarks the
+ * two against each other.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "OverlayInstallPlan.h"
+#include "InternedStringTable.h"
+
+// ============================================================================
+// Synthetic scene graph
+// ============================================================================
+
+struct TestNode {
+    std::string name;
+    std::vector<TestNode*> children;
+    bool leaf = false;  // Geometry; has no child array
+};
+
+struct TestAccess {
+    static int visits;
+
+    static const char* Name(TestNode* node) {
+        ++visits;
+        return node->name.empty() ? nullptr : node->name.c_str();
+    }
+    static UInt32 ChildCount(TestNode* node) { return node->leaf ? 0 : static_cast<UInt32>(node->children.size()); }
+    static TestNode* Child(TestNode* node, UInt32 i) { return node->children[i]; }
+};
+
+int TestAccess::visits = 0;
+
+class TestGraph {
+public:
+    TestNode* Add(TestNode* parent, const std::string& name, bool leaf = false) {
+        m_nodes.push_back(std::make_unique<TestNode>());
+        TestNode* node = m_nodes.back().get();
+        node->name = name;
+        node->leaf = leaf;
+        if (parent) parent->children.push_back(node);
+        return node;
+    }
+
+    size_t Size() const { return m_nodes.size(); }
+
+private:
+    std::vector<std::unique_ptr<TestNode>> m_nodes;
+};
+
+// SKEE's node name formats and default slot counts
+static const UInt32 kBody = 4, kHands = 8, kFeet = 0x80, kFace = 0;
+
+static std::vector<OverlaySlotGroup> DefaultGroups() {
+    return {
+        {kBody, "Body [Ovl%d]", "body_overlay.nif", 6},
+        {kBody, "Body [SOvl%d]", "body_magicoverlay.nif", 1},
+        {kHands, "Hands [Ovl%d]", "hands_overlay.nif", 3},
+        {kHands, "Hands [SOvl%d]", "hands_magicoverlay.nif", 1},
+        {kFeet, "Feet [Ovl%d]", "feet_overlay.nif", 3},
+        {kFeet, "Feet [SOvl%d]", "feet_magicoverlay.nif", 1},
+        {kFace, "Face [Ovl%d]", "face_overlay.nif", 3},
+        {kFace, "Face [SOvl%d]", "face_magicoverlay.nif", 1},
+    };
+}
+
+static OverlayInstallPlan MakePlan(const std::vector<OverlaySlotGroup>& groups) {
+    OverlayInstallPlan plan;
+    plan.Build(groups.data(), static_cast<UInt32>(groups.size()));
+    return plan;
+}
+
+// A humanoid skeleton: a spine with limbs and fingers, ~130 bones. Body,
+// hand and feet overlays hang off the skeleton root, face overlays off
+// "NPC Root [Root]", like AddOverlays installs them.
+static TestNode* BuildSkeleton(TestGraph& graph, const OverlayInstallPlan& plan, bool withOverlays) {
+    TestNode* root = graph.Add(nullptr, "skeleton.nif");
+    TestNode* npcRoot = graph.Add(root, "NPC Root [Root]");
+    TestNode* parent = graph.Add(npcRoot, "NPC COM [COM ]");
+    for (int s = 0; s < 4; ++s) parent = graph.Add(parent, "NPC Spine" + std::to_string(s) + " [Spn" + std::to_string(s) + "]");
+    for (const char* side : {"L", "R"}) {
+        TestNode* limb = graph.Add(parent, std::string("NPC ") + side + " Clavicle [" + side + "Clv]");
+        for (int b = 0; b < 4; ++b) limb = graph.Add(limb, std::string("NPC ") + side + " Arm" + std::to_string(b));
+        for (int f = 0; f < 5; ++f) {
+            TestNode* finger = limb;
+            for (int j = 0; j < 3; ++j)
+                finger = graph.Add(finger, std::string("NPC ") + side + " Finger" + std::to_string(f) + std::to_string(j));
+        }
+        TestNode* leg = graph.Add(npcRoot, std::string("NPC ") + side + " Thigh [" + side + "Thg]");
+        for (int b = 0; b < 6; ++b) leg = graph.Add(leg, std::string("NPC ") + side + " Leg" + std::to_string(b));
+    }
+    TestNode* head = graph.Add(parent, "NPC Head [Head]");
+    for (int b = 0; b < 40; ++b) graph.Add(head, "NPCEyeBone" + std::to_string(b));
+    for (int m = 0; m < 6; ++m) graph.Add(root, "Armor" + std::to_string(m), true);
+
+    if (withOverlays) {
+        for (UInt32 slot = 0; slot < plan.Size(); ++slot)
+            graph.Add(plan.Slot(slot).part == kFace ? npcRoot : root, plan.Slot(slot).name, true);
+    }
+    return root;
+}
+
+typedef std::tuple<UInt32, TestNode*, TestNode*> Match;
+
+static std::vector<Match> WalkMatches(const OverlayInstallPlan& plan, TestNode* root) {
+    std::vector<Match> found;
+    plan.Walk<TestAccess>(root, [&](TestNode* node, TestNode* parent, UInt32 slot) {
+        if (slot != OverlayInstallPlan::kNoSlot) found.emplace_back(slot, node, parent);
+    });
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+// NiNode::GetObjectByName: depth first, case-insensitive, first match
+static bool FindByName(TestNode* node, TestNode* parent, const std::string& name, Match& out, UInt32 slot) {
+    ++TestAccess::visits;
+    if (node->name.size() == name.size() && InternedStringTable::EqualsLower(node->name.c_str(), name.c_str(), name.size())) {
+        out = Match(slot, node, parent);
+        return true;
+    }
+    for (TestNode* child : node->children)
+        if (FindByName(child, node, name, out, slot)) return true;
+    return false;
+}
+
+static std::vector<Match> PerSlotMatches(const OverlayInstallPlan& plan, TestNode* root) {
+    std::vector<Match> found;
+    for (UInt32 slot = 0; slot < plan.Size(); ++slot) {
+        Match m;
+        if (FindByName(root, nullptr, plan.Slot(slot).name, m, slot)) found.push_back(m);
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+// ============================================================================
+// Plan
+// ============================================================================
+
+TEST(OverlayInstallPlanTest, FormatsNamesInGroupOrder) {
+    const auto plan = MakePlan(DefaultGroups());
+    ASSERT_EQ(plan.Size(), 19u);
+    EXPECT_EQ(plan.Slot(0).name, "Body [Ovl0]");
+    EXPECT_EQ(plan.Slot(5).name, "Body [Ovl5]");
+    EXPECT_EQ(plan.Slot(6).name, "Body [SOvl0]");
+    EXPECT_EQ(plan.Slot(7).name, "Hands [Ovl0]");
+    EXPECT_EQ(plan.Slot(18).name, "Face [SOvl0]");
+    EXPECT_STREQ(plan.Slot(6).mesh, "body_magicoverlay.nif");
+    EXPECT_EQ(plan.Slot(18).part, kFace);
+}
+
+TEST(OverlayInstallPlanTest, FindIsCaseInsensitiveAndExact) {
+    const auto plan = MakePlan(DefaultGroups());
+    for (UInt32 slot = 0; slot < plan.Size(); ++slot) EXPECT_EQ(plan.Find(plan.Slot(slot).name.c_str()), slot);
+
+    EXPECT_EQ(plan.Find("body [ovl3]"), 3u);
+    EXPECT_EQ(plan.Find("FACE [SOVL0]"), 18u);
+    EXPECT_EQ(plan.Find("Body [Ovl6]"), OverlayInstallPlan::kNoSlot);  // Past the configured count
+    EXPECT_EQ(plan.Find("Body [Ovl0] "), OverlayInstallPlan::kNoSlot);
+    EXPECT_EQ(plan.Find("Body [Ovl"), OverlayInstallPlan::kNoSlot);
+    EXPECT_EQ(plan.Find("NPC Root [Root]"), OverlayInstallPlan::kNoSlot);
+    EXPECT_EQ(plan.Find(""), OverlayInstallPlan::kNoSlot);
+}
+
+TEST(OverlayInstallPlanTest, VisitPartKeepsSlotOrder) {
+    const auto plan = MakePlan(DefaultGroups());
+    std::vector<std::string> hands;
+    plan.VisitPart(kHands, [&](UInt32, const OverlaySlot& slot) { hands.push_back(slot.name); });
+    const std::vector<std::string> expected = {"Hands [Ovl0]", "Hands [Ovl1]", "Hands [Ovl2]", "Hands [SOvl0]"};
+    EXPECT_EQ(hands, expected);
+}
+
+TEST(OverlayInstallPlanTest, MatchesDetectsCountChanges) {
+    auto groups = DefaultGroups();
+    const auto plan = MakePlan(groups);
+    EXPECT_TRUE(plan.Matches(groups.data(), static_cast<UInt32>(groups.size())));
+
+    groups[2].count = 4;
+    EXPECT_FALSE(plan.Matches(groups.data(), static_cast<UInt32>(groups.size())));
+    EXPECT_FALSE(plan.Matches(groups.data(), 3));
+}
+
+TEST(OverlayInstallPlanTest, EmptyPlanFindsNothing) {
+    OverlayInstallPlan plan;
+    EXPECT_EQ(plan.Size(), 0u);
+    EXPECT_EQ(plan.Find("Body [Ovl0]"), OverlayInstallPlan::kNoSlot);
+
+    auto groups = DefaultGroups();
+    for (auto& g : groups) g.count = 0;
+    plan.Build(groups.data(), static_cast<UInt32>(groups.size()));
+    EXPECT_EQ(plan.Size(), 0u);
+    EXPECT_EQ(plan.Find("Body [Ovl0]"), OverlayInstallPlan::kNoSlot);
+}
+
+// ============================================================================
+// Walk
+// ============================================================================
+
+TEST(OverlayInstallPlanWalk, VisitsEveryNodeOnce) {
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = BuildSkeleton(graph, plan, true);
+
+    std::set<TestNode*> seen;
+    size_t calls = 0;
+    plan.Walk<TestAccess>(root, [&](TestNode* node, TestNode*, UInt32) {
+        ++calls;
+        seen.insert(node);
+    });
+    EXPECT_EQ(calls, graph.Size());
+    EXPECT_EQ(seen.size(), graph.Size());
+}
+
+TEST(OverlayInstallPlanWalk, MatchesPerSlotSearch) {
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = BuildSkeleton(graph, plan, true);
+
+    const auto walked = WalkMatches(plan, root);
+    EXPECT_EQ(walked.size(), plan.Size());
+    EXPECT_EQ(walked, PerSlotMatches(plan, root));
+
+    // Face overlays report "NPC Root [Root]" as their parent
+    for (const auto& [slot, node, parent] : walked)
+        EXPECT_EQ(parent->name, plan.Slot(slot).part == kFace ? "NPC Root [Root]" : "skeleton.nif") << node->name;
+}
+
+TEST(OverlayInstallPlanWalk, FreshSkeletonHasNoOverlays) {
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = BuildSkeleton(graph, plan, false);
+    EXPECT_TRUE(WalkMatches(plan, root).empty());
+}
+
+TEST(OverlayInstallPlanWalk, FindsDuplicatesAndMixedCase) {
+    // UninstallOverlay removes every instance of a name, in any case
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = graph.Add(nullptr, "skeleton.nif");
+    TestNode* first = graph.Add(root, "Body [Ovl2]", true);
+    TestNode* nested = graph.Add(graph.Add(root, "NPC Root [Root]"), "BODY [OVL2]", true);
+    graph.Add(root, "Body [Ovl9]", true);
+
+    const auto walked = WalkMatches(plan, root);
+    ASSERT_EQ(walked.size(), 2u);
+    std::set<TestNode*> nodes = {std::get<1>(walked[0]), std::get<1>(walked[1])};
+    EXPECT_EQ(nodes, (std::set<TestNode*>{first, nested}));
+}
+
+TEST(OverlayInstallPlanWalk, DoesNotDescendIntoOverlays) {
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = graph.Add(nullptr, "skeleton.nif");
+    TestNode* overlay = graph.Add(root, "Feet [Ovl0]");
+    graph.Add(overlay, "Feet [Ovl1]", true);
+
+    const auto walked = WalkMatches(plan, root);
+    ASSERT_EQ(walked.size(), 1u);
+    EXPECT_EQ(std::get<1>(walked[0]), overlay);
+}
+
+TEST(OverlayInstallPlanWalk, SkipsNullChildrenAndNames) {
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = graph.Add(nullptr, "");
+    root->children.push_back(nullptr);
+    TestNode* overlay = graph.Add(root, "Hands [SOvl0]", true);
+
+    const auto walked = WalkMatches(plan, root);
+    ASSERT_EQ(walked.size(), 1u);
+    EXPECT_EQ(std::get<1>(walked[0]), overlay);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(OverlayInstallPlanBench, SingleWalkVersusPerSlotSearch) {
+    const auto plan = MakePlan(DefaultGroups());
+    TestGraph graph;
+    TestNode* root = BuildSkeleton(graph, plan, true);
+
+    constexpr int kActors = 2000;
+    TestAccess::visits = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    size_t walked = 0;
+    for (int i = 0; i < kActors; ++i) walked += WalkMatches(plan, root).size();
+    auto t1 = std::chrono::steady_clock::now();
+    const int walkVisits = TestAccess::visits;
+
+    TestAccess::visits = 0;
+    size_t searched = 0;
+    for (int i = 0; i < kActors; ++i) searched += PerSlotMatches(plan, root).size();
+    auto t2 = std::chrono::steady_clock::now();
+    const int searchVisits = TestAccess::visits;
+
+    EXPECT_EQ(walked, searched);
+    EXPECT_LT(walkVisits * 5, searchVisits);
+
+    const double walkUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / kActors;
+    const double searchUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / kActors;
+    std::printf("[ BENCH    ] %zu nodes, %u slots: walk %d visits %.2f us/actor, per-slot search %d visits %.2f us/actor\n",
+                graph.Size(), plan.Size(), walkVisits / kActors, walkUs, searchVisits / kActors, searchUs);
+}
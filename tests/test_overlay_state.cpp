@@ -0,0 +1,308 @@
+/**
+ * Unit tests for the event-driven overlay visibility state using Google Test.
+ *
+ * Feeds scripted MenuOpenCloseEvent streams (nested, overlapping, repeated
+ * and untracked menus) into the tracker and checks the result against the
+ * per-frame IsMenuOpen sweep it replaces, including under concurrent world
+ * updates from another thread.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "OverlayState.h"
+
+using OverlayState::kGameInactive;
+using OverlayState::kInCombat;
+using OverlayState::kMenuMask;
+using OverlayState::kNoAttachedCell;
+using OverlayState::kWorldMask;
+using OverlayState::MenuBit;
+using OverlayState::Tracker;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+struct MenuEvent
+{
+    const char* name;
+    bool opening;
+};
+
+// The menus CanDrawOverlay used to sweep with IsMenuOpen every frame
+static const char* const kLegacyMenus[] = {
+    "Loading Menu",  "Main Menu",     "MapMenu",       "Fader Menu",       "Menu",
+    "Console",       "TweenMenu",     "Journal Menu",  "InventoryMenu",    "MagicMenu",
+    "ContainerMenu", "BarterMenu",    "GiftMenu",      "Crafting Menu",    "FavoritesMenu",
+    "Lockpicking Menu", "Sleep/Wait Menu", "StatsMenu",
+};
+
+// Menus the UI opens that never hid the overlay
+static const char* const kUntrackedMenus[] = {
+    "HUD Menu", "Cursor Menu", "Dialogue Menu", "LevelUp Menu", "Book Menu", "Kinect Menu",
+};
+
+// Models the UI's menu stack as a set of open names
+struct LegacyUI
+{
+    std::set<std::string> open;
+
+    void Apply(const MenuEvent& e)
+    {
+        if (e.opening)
+            open.insert(e.name);
+        else
+            open.erase(e.name);
+    }
+
+    bool IsMenuOpen(const char* name) const { return open.count(name) != 0; }
+
+    // The old sweep, menus only
+    bool AnyBlocking() const
+    {
+        for (const char* name : kLegacyMenus)
+        {
+            if (IsMenuOpen(name))
+                return true;
+        }
+        return false;
+    }
+};
+
+// Tracker after the game thread found the world clear
+static void MakeReady(Tracker& t)
+{
+    t.SetWorld(0);
+}
+
+static void Play(Tracker& t, LegacyUI& ui, const std::vector<MenuEvent>& events)
+{
+    for (const auto& e : events)
+    {
+        t.OnMenu(e.name, e.opening);
+        ui.Apply(e);
+        EXPECT_EQ(t.Allowed(), !ui.AnyBlocking()) << e.name << (e.opening ? " open" : " close");
+    }
+}
+
+// ============================================================================
+// Menu table
+// ============================================================================
+
+TEST(OverlayStateMenus, EveryLegacyMenuHasItsOwnBit)
+{
+    std::uint32_t seen = 0;
+    for (const char* name : kLegacyMenus)
+    {
+        const std::uint32_t bit = MenuBit(name);
+        ASSERT_NE(bit, 0u) << name;
+        EXPECT_EQ(bit & (bit - 1), 0u) << name;
+        EXPECT_EQ(seen & bit, 0u) << name;
+        seen |= bit;
+    }
+    EXPECT_EQ(seen, kMenuMask);
+    EXPECT_EQ(kMenuMask & kWorldMask, 0u);
+
+    for (const char* name : kUntrackedMenus)
+        EXPECT_EQ(MenuBit(name), 0u) << name;
+    EXPECT_EQ(MenuBit("inventorymenu"), 0u);  // names are case sensitive, as in the UI
+    EXPECT_EQ(MenuBit(""), 0u);
+}
+
+// ============================================================================
+// Scripted event streams
+// ============================================================================
+
+TEST(OverlayStateEvents, HiddenUntilWorldChecked)
+{
+    Tracker t;
+    EXPECT_FALSE(t.Allowed());
+    EXPECT_EQ(t.Mask(), kGameInactive);
+    t.SetWorld(0);
+    EXPECT_TRUE(t.Allowed());
+}
+
+TEST(OverlayStateEvents, NestedMenusHideUntilOutermostCloses)
+{
+    Tracker t;
+    MakeReady(t);
+    LegacyUI ui;
+    // Tween menu, then Inventory and Magic from it, then back out
+    Play(t, ui, {{"TweenMenu", true}, {"InventoryMenu", true}, {"InventoryMenu", false},
+                 {"MagicMenu", true}, {"MagicMenu", false}});
+    EXPECT_FALSE(t.Allowed());
+    Play(t, ui, {{"TweenMenu", false}});
+    EXPECT_TRUE(t.Allowed());
+}
+
+TEST(OverlayStateEvents, OverlappingMenusCloseOutOfOrder)
+{
+    Tracker t;
+    MakeReady(t);
+    LegacyUI ui;
+    // Fast travel: map, fader over it, map closes first, loading, fader closes last
+    Play(t, ui, {{"MapMenu", true}, {"Fader Menu", true}, {"MapMenu", false}, {"Loading Menu", true},
+                 {"Loading Menu", false}});
+    EXPECT_FALSE(t.Allowed());
+    Play(t, ui, {{"Fader Menu", false}});
+    EXPECT_TRUE(t.Allowed());
+
+    // Console over the container menu, container closes while console is up
+    Play(t, ui, {{"ContainerMenu", true}, {"Console", true}, {"ContainerMenu", false}});
+    EXPECT_FALSE(t.Allowed());
+    Play(t, ui, {{"Console", false}});
+    EXPECT_TRUE(t.Allowed());
+}
+
+TEST(OverlayStateEvents, RepeatedAndStrayEventsAreHarmless)
+{
+    Tracker t;
+    MakeReady(t);
+    LegacyUI ui;
+    // Close with no open (the Fader Menu does this at startup), double open
+    Play(t, ui, {{"Fader Menu", false}, {"StatsMenu", true}, {"StatsMenu", true}, {"StatsMenu", false}});
+    EXPECT_TRUE(t.Allowed());
+    Play(t, ui, {{"StatsMenu", false}});
+    EXPECT_TRUE(t.Allowed());
+}
+
+TEST(OverlayStateEvents, UntrackedMenusNeverHide)
+{
+    Tracker t;
+    MakeReady(t);
+    LegacyUI ui;
+    Play(t, ui, {{"Dialogue Menu", true}, {"Cursor Menu", true}, {"HUD Menu", true}});
+    EXPECT_TRUE(t.Allowed());
+    Play(t, ui, {{"BarterMenu", true}, {"Dialogue Menu", false}});
+    EXPECT_FALSE(t.Allowed());
+    Play(t, ui, {{"BarterMenu", false}});
+    EXPECT_TRUE(t.Allowed());
+}
+
+TEST(OverlayStateEvents, WorldAndMenuBitsAreIndependent)
+{
+    Tracker t;
+    MakeReady(t);
+    t.OnMenu("Journal Menu", true);
+    t.SetWorld(kInCombat);
+    EXPECT_EQ(t.Mask(), MenuBit("Journal Menu") | kInCombat);
+
+    t.OnMenu("Journal Menu", false);
+    EXPECT_EQ(t.Mask(), kInCombat);  // closing the menu keeps the combat bit
+    t.OnMenu("Sleep/Wait Menu", true);
+    t.SetWorld(0);
+    EXPECT_EQ(t.Mask(), MenuBit("Sleep/Wait Menu"));  // world refresh keeps the menu bit
+    t.SetWorld(kMenuMask | kNoAttachedCell);          // menu bits outside the world mask are ignored
+    EXPECT_EQ(t.Mask(), MenuBit("Sleep/Wait Menu") | kNoAttachedCell);
+
+    t.SeedMenus(0);
+    EXPECT_EQ(t.Mask(), kNoAttachedCell);
+    t.SeedMenus(MenuBit("Main Menu") | kInCombat);
+    EXPECT_EQ(t.Mask(), MenuBit("Main Menu") | kNoAttachedCell);
+}
+
+TEST(OverlayStateEvents, RandomStreamMatchesSweep)
+{
+    std::mt19937 rng(1234);
+    std::vector<const char*> names(std::begin(kLegacyMenus), std::end(kLegacyMenus));
+    names.insert(names.end(), std::begin(kUntrackedMenus), std::end(kUntrackedMenus));
+
+    Tracker t;
+    MakeReady(t);
+    LegacyUI ui;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const MenuEvent e{names[rng() % names.size()], (rng() % 3) != 0};
+        t.OnMenu(e.name, e.opening);
+        ui.Apply(e);
+        ASSERT_EQ(t.Allowed(), !ui.AnyBlocking()) << "event " << i;
+
+        std::uint32_t expected = 0;
+        for (const auto& name : ui.open)
+            expected |= MenuBit(name);
+        ASSERT_EQ(t.Mask(), expected) << "event " << i;
+    }
+}
+
+// ============================================================================
+// Threads
+// ============================================================================
+
+TEST(OverlayStateThreads, WorldUpdatesNeverLoseMenuEvents)
+{
+    Tracker t;
+    MakeReady(t);
+    std::atomic<bool> stop{false};
+
+    // Game thread refreshing world bits while the UI thread plays events
+    std::thread game([&] {
+        std::uint32_t i = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            t.SetWorld((i & 1) ? kInCombat : 0);
+            ++i;
+        }
+        t.SetWorld(0);
+    });
+
+    std::mt19937 rng(99);
+    LegacyUI ui;
+    for (int i = 0; i < 200000; ++i)
+    {
+        const MenuEvent e{kLegacyMenus[rng() % OverlayState::kTrackedMenuCount], (rng() & 1) != 0};
+        t.OnMenu(e.name, e.opening);
+        ui.Apply(e);
+        if ((i & 1023) == 0)
+        {
+            std::uint32_t expected = 0;
+            for (const auto& name : ui.open)
+                expected |= MenuBit(name);
+            ASSERT_EQ(t.Mask() & kMenuMask, expected);
+        }
+    }
+    stop.store(true);
+    game.join();
+
+    std::uint32_t expected = 0;
+    for (const auto& name : ui.open)
+        expected |= MenuBit(name);
+    EXPECT_EQ(t.Mask(), expected);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(OverlayStateBench, MaskLoadVsNameSweep)
+{
+    LegacyUI ui;
+    ui.Apply({"HUD Menu", true});
+    ui.Apply({"Cursor Menu", true});
+    Tracker t;
+    MakeReady(t);
+
+    constexpr int kFrames = 200000;
+    volatile int sink = 0;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < kFrames; ++i)
+        sink = sink + (ui.AnyBlocking() ? 1 : 0);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < kFrames; ++i)
+        sink = sink + (t.Allowed() ? 0 : 1);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    const double sweepNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / kFrames;
+    const double loadNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kFrames;
+    std::printf("[ BENCH    ] name sweep %.1f ns/frame, mask load %.2f ns/frame\n", sweepNs, loadNs);
+    EXPECT_LT(loadNs, sweepNs);
+}
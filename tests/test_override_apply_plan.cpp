@@ -0,0 +1,475 @@
+/**
+ * Unit tests for recorded override application using Google Test.
+ *
+ * Compiles plans on synthetic armor models and checks them against the
+ * per-geometry lookup ApplyOverrides did before, replays them on copies of
+ * the model, checks that a changed model is rejected, and benchmarks a
+ * replay against the full visit and lookup on every attach.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "OverrideApplyPlan.h"
+
+// ============================================================================
+// Synthetic scene graph
+// ============================================================================
+
+// Stands in for an override set; the values are shader property keys
+struct TestSet {
+    std::vector<int> values;
+};
+
+struct TestNode {
+    const char* name = nullptr;
+    std::vector<TestNode*> children;
+    bool geometry = false;
+};
+
+struct TestAccess {
+    static int visits;
+
+    static UInt32 ChildCount(TestNode* node) {
+        ++visits;
+        return node->geometry ? 0 : static_cast<UInt32>(node->children.size());
+    }
+    static TestNode* Child(TestNode* node, UInt32 i) {
+        ++visits;
+        return node->children[i];
+    }
+    static bool IsGeometry(TestNode* node) {
+        ++visits;
+        return node->geometry;
+    }
+    static const char* Name(TestNode* node) { return node->name; }
+};
+
+int TestAccess::visits = 0;
+
+// Interned names, like BSFixedString: equal names share one pointer
+static const char* Intern(const std::string& name) {
+    static std::set<std::string> pool;
+    return pool.insert(name).first->c_str();
+}
+
+class TestModel {
+public:
+    TestNode* Add(TestNode* parent, const std::string& name, bool geometry = false) {
+        m_nodes.push_back(std::make_unique<TestNode>());
+        TestNode* node = m_nodes.back().get();
+        node->name = Intern(name);
+        node->geometry = geometry;
+        if (parent) parent->children.push_back(node);
+        return node;
+    }
+
+    TestNode* Root() const { return m_nodes.empty() ? nullptr : m_nodes.front().get(); }
+
+    // Same shape and names, new nodes, as on a second attach
+    TestModel Clone() const {
+        TestModel copy;
+        if (Root()) CloneNode(copy, nullptr, Root());
+        return copy;
+    }
+
+private:
+    void CloneNode(TestModel& copy, TestNode* parent, const TestNode* node) const {
+        TestNode* added = copy.Add(parent, node->name, node->geometry);
+        for (TestNode* child : node->children) {
+            if (child)
+                CloneNode(copy, added, child);
+            else
+                added->children.push_back(nullptr);
+        }
+    }
+
+    std::vector<std::unique_ptr<TestNode>> m_nodes;
+};
+
+// An armor addon: root, a few shape groups, geometries at mixed depths
+static TestModel BuildArmor(int groups, int shapesPerGroup) {
+    TestModel model;
+    TestNode* root = model.Add(nullptr, "ArmorAddon");
+    for (int g = 0; g < groups; ++g) {
+        TestNode* group = model.Add(root, "Group" + std::to_string(g));
+        for (int s = 0; s < shapesPerGroup; ++s) {
+            TestNode* parent = (s % 3 == 2) ? model.Add(group, "Bone" + std::to_string(g) + "_" + std::to_string(s)) : group;
+            model.Add(parent, "Shape" + std::to_string(g) + "_" + std::to_string(s), true);
+        }
+    }
+    return model;
+}
+
+typedef std::unordered_map<std::string, TestSet> TestRegistration;
+typedef std::vector<std::pair<TestNode*, TestSet*>> Applied;
+
+static TestSet* Lookup(TestRegistration& registration, const char* name) {
+    auto it = registration.find(name);
+    return it != registration.end() ? &it->second : nullptr;
+}
+
+// What OverrideApplicator does: collect geometries, then look each one up
+static void CollectGeometry(TestNode* node, std::vector<TestNode*>& out) {
+    if (TestAccess::IsGeometry(node)) {
+        out.push_back(node);
+        return;
+    }
+    const UInt32 count = TestAccess::ChildCount(node);
+    for (UInt32 i = 0; i < count; ++i) {
+        if (TestNode* child = TestAccess::Child(node, i)) CollectGeometry(child, out);
+    }
+}
+
+static Applied ReferenceApply(TestRegistration& registration, TestNode* root) {
+    std::vector<TestNode*> geometries;
+    CollectGeometry(root, geometries);
+    Applied applied;
+    for (TestNode* geometry : geometries) {
+        if (TestSet* set = Lookup(registration, geometries.size() == 1 ? "" : geometry->name))
+            applied.emplace_back(geometry, set);
+    }
+    return applied;
+}
+
+static OverrideApplyPlan<TestSet> Compile(TestRegistration& registration, TestNode* root, int* lookups = nullptr) {
+    OverrideApplyPlan<TestSet> plan;
+    plan.Compile<TestAccess>(root, [&](const char* name) {
+        if (lookups) ++*lookups;
+        return Lookup(registration, name);
+    });
+    return plan;
+}
+
+static bool Replay(const OverrideApplyPlan<TestSet>& plan, TestNode* root, Applied& applied) {
+    return plan.Replay<TestAccess>(root, [&](TestNode* node, TestSet* set) { applied.emplace_back(node, set); });
+}
+
+static TestRegistration RegisterEveryOther(int groups, int shapesPerGroup) {
+    TestRegistration registration;
+    for (int g = 0; g < groups; ++g) {
+        for (int s = 0; s < shapesPerGroup; s += 2)
+            registration["Shape" + std::to_string(g) + "_" + std::to_string(s)].values = {g, s};
+    }
+    return registration;
+}
+
+// ============================================================================
+// Compile
+// ============================================================================
+
+TEST(OverrideApplyPlanTest, CompileMatchesPerGeometryLookup) {
+    TestModel model = BuildArmor(4, 6);
+    TestRegistration registration = RegisterEveryOther(4, 6);
+
+    auto plan = Compile(registration, model.Root());
+    EXPECT_EQ(plan.GeometryCount(), 24u);
+    EXPECT_EQ(plan.Size(), 12u);
+
+    Applied applied;
+    ASSERT_TRUE(Replay(plan, model.Root(), applied));
+    EXPECT_EQ(applied, ReferenceApply(registration, model.Root()));
+}
+
+TEST(OverrideApplyPlanTest, RecordsChildIndexPaths) {
+    TestModel model = BuildArmor(2, 3);
+    TestRegistration registration;
+    registration["Shape1_2"].values = {7};
+
+    auto plan = Compile(registration, model.Root());
+    ASSERT_EQ(plan.Size(), 1u);
+    const auto& step = plan.GetStep(0);
+    ASSERT_EQ(step.pathLength, 3u);
+    const UInt16* path = plan.Path(step);
+    EXPECT_EQ(path[0], 1);  // Group1
+    EXPECT_EQ(path[1], 2);  // Bone1_2
+    EXPECT_EQ(path[2], 0);  // Shape1_2
+    EXPECT_EQ(step.name, Intern("Shape1_2"));
+}
+
+TEST(OverrideApplyPlanTest, SingleGeometryUsesEmptyName) {
+    TestModel model;
+    TestNode* root = model.Add(nullptr, "ArmorAddon");
+    TestNode* shape = model.Add(root, "Cuirass", true);
+    TestRegistration registration;
+    registration[""].values = {1};
+    registration["Cuirass"].values = {2};
+
+    auto plan = Compile(registration, root);
+    ASSERT_EQ(plan.Size(), 1u);
+    EXPECT_EQ(plan.GetStep(0).set, &registration[""]);
+
+    Applied applied;
+    ASSERT_TRUE(Replay(plan, root, applied));
+    EXPECT_EQ(applied, (Applied{{shape, &registration[""]}}));
+    EXPECT_EQ(applied, ReferenceApply(registration, root));
+}
+
+TEST(OverrideApplyPlanTest, RootCanBeTheGeometry) {
+    TestModel model;
+    TestNode* root = model.Add(nullptr, "Helmet", true);
+    TestRegistration registration;
+    registration[""].values = {3};
+
+    auto plan = Compile(registration, root);
+    ASSERT_EQ(plan.Size(), 1u);
+    EXPECT_EQ(plan.GetStep(0).pathLength, 0u);
+
+    Applied applied;
+    ASSERT_TRUE(Replay(plan, root, applied));
+    EXPECT_EQ(applied, ReferenceApply(registration, root));
+}
+
+TEST(OverrideApplyPlanTest, SkipsNullChildren) {
+    TestModel model = BuildArmor(2, 4);
+    model.Root()->children.insert(model.Root()->children.begin(), nullptr);
+    TestRegistration registration = RegisterEveryOther(2, 4);
+
+    auto plan = Compile(registration, model.Root());
+    EXPECT_EQ(plan.GeometryCount(), 8u);
+
+    Applied applied;
+    ASSERT_TRUE(Replay(plan, model.Root(), applied));
+    EXPECT_EQ(applied, ReferenceApply(registration, model.Root()));
+}
+
+TEST(OverrideApplyPlanTest, NoOverridesGivesEmptyPlan) {
+    TestModel model = BuildArmor(3, 3);
+    TestRegistration registration;
+    registration["SomethingElse"].values = {1};
+
+    auto plan = Compile(registration, model.Root());
+    EXPECT_EQ(plan.Size(), 0u);
+
+    Applied applied;
+    EXPECT_TRUE(Replay(plan, model.Root(), applied));
+    EXPECT_TRUE(applied.empty());
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+TEST(OverrideApplyPlanTest, ReplaysOnAnotherAttachWithoutLookups) {
+    TestModel model = BuildArmor(4, 6);
+    TestRegistration registration = RegisterEveryOther(4, 6);
+    int lookups = 0;
+    auto plan = Compile(registration, model.Root(), &lookups);
+    EXPECT_EQ(lookups, 24);
+
+    TestModel attached = model.Clone();
+    Applied applied;
+    ASSERT_TRUE(Replay(plan, attached.Root(), applied));
+    EXPECT_EQ(applied, ReferenceApply(registration, attached.Root()));
+    for (const auto& entry : applied) EXPECT_NE(entry.first, nullptr);
+}
+
+TEST(OverrideApplyPlanTest, RenamedGeometryRejectsPlan) {
+    TestModel model = BuildArmor(3, 3);
+    TestRegistration registration = RegisterEveryOther(3, 3);
+    auto plan = Compile(registration, model.Root());
+
+    TestModel attached = model.Clone();
+    attached.Root()->children[2]->children[0]->name = Intern("Replaced");
+
+    Applied applied;
+    EXPECT_FALSE(Replay(plan, attached.Root(), applied));
+    EXPECT_TRUE(applied.empty());
+}
+
+TEST(OverrideApplyPlanTest, ReshapedModelRejectsPlan) {
+    TestModel model = BuildArmor(3, 3);
+    TestRegistration registration = RegisterEveryOther(3, 3);
+    auto plan = Compile(registration, model.Root());
+
+    // Fewer groups: a path runs out of children
+    TestModel shorter = model.Clone();
+    shorter.Root()->children.pop_back();
+    Applied applied;
+    EXPECT_FALSE(Replay(plan, shorter.Root(), applied));
+    EXPECT_TRUE(applied.empty());
+
+    // A geometry where a node was: the path ends early
+    TestModel flattened = model.Clone();
+    flattened.Root()->children[1]->geometry = true;
+    EXPECT_FALSE(Replay(plan, flattened.Root(), applied));
+    EXPECT_TRUE(applied.empty());
+
+    // Null where a geometry was
+    TestModel removed = model.Clone();
+    removed.Root()->children[0]->children[0] = nullptr;
+    EXPECT_FALSE(Replay(plan, removed.Root(), applied));
+    EXPECT_TRUE(applied.empty());
+}
+
+TEST(OverrideApplyPlanTest, ReplayTouchesOnlyRecordedPaths) {
+    TestModel model = BuildArmor(3, 6);
+    TestRegistration registration;
+    registration["Shape1_2"].values = {7};
+    auto plan = Compile(registration, model.Root());
+    ASSERT_EQ(plan.Size(), 1u);
+
+    Applied applied;
+    TestAccess::visits = 0;
+    ASSERT_TRUE(Replay(plan, model.Root(), applied));
+    const int visits = TestAccess::visits;
+
+    // Group1, Bone1_2, Shape1_2: a count and a child per level, then the type
+    // check, once to validate and once to apply
+    EXPECT_EQ(visits, 2 * (2 * 3 + 1));
+
+    // Nodes off the path cost nothing
+    TestModel bigger = model.Clone();
+    for (int i = 0; i < 100; ++i) bigger.Add(bigger.Root()->children[0], "Extra" + std::to_string(i), true);
+    applied.clear();
+    TestAccess::visits = 0;
+    ASSERT_TRUE(Replay(plan, bigger.Root(), applied));
+    EXPECT_EQ(TestAccess::visits, visits);
+}
+
+// ============================================================================
+// Cache
+// ============================================================================
+
+static OverrideApplyPlanKey MakeKey(UInt32 actor, UInt32 addon) {
+    return {actor, 0x800, addon, 1, Intern("Armor\\Cuirass_1.nif"), Intern("ArmorAddon"), 3, false};
+}
+
+TEST(OverrideApplyPlanCacheTest, KeyEqualityAndHash) {
+    OverrideApplyPlanKeyHash hash;
+    EXPECT_EQ(MakeKey(0x14, 0x900), MakeKey(0x14, 0x900));
+    EXPECT_EQ(hash(MakeKey(0x14, 0x900)), hash(MakeKey(0x14, 0x900)));
+    EXPECT_FALSE(MakeKey(0x14, 0x900) == MakeKey(0x14, 0x901));
+    EXPECT_FALSE(MakeKey(0x14, 0x900) == MakeKey(0x15, 0x900));
+
+    OverrideApplyPlanKey other = MakeKey(0x14, 0x900);
+    other.rootName = Intern("ArmorAddon_1stPerson");
+    EXPECT_FALSE(MakeKey(0x14, 0x900) == other);
+    other = MakeKey(0x14, 0x900);
+    other.model = Intern("Armor\\Cuirass_0.nif");
+    EXPECT_FALSE(MakeKey(0x14, 0x900) == other);
+    other = MakeKey(0x14, 0x900);
+    other.gender = 0;
+    EXPECT_FALSE(MakeKey(0x14, 0x900) == other);
+    other = MakeKey(0x14, 0x900);
+    other.firstPerson = true;
+    EXPECT_FALSE(MakeKey(0x14, 0x900) == other);
+    EXPECT_NE(hash(MakeKey(0x14, 0x900)), hash(other));
+}
+
+TEST(OverrideApplyPlanCacheTest, FindsPlanOfSameGeneration) {
+    OverrideApplyPlanCache<TestSet> cache;
+    EXPECT_EQ(cache.Find(MakeKey(1, 2), 0), nullptr);
+
+    TestModel model = BuildArmor(2, 2);
+    TestRegistration registration = RegisterEveryOther(2, 2);
+    auto& plan = cache.Insert(MakeKey(1, 2), 0);
+    plan.Compile<TestAccess>(model.Root(), [&](const char* name) { return Lookup(registration, name); });
+
+    const auto* found = cache.Find(MakeKey(1, 2), 0);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->Size(), 2u);
+    EXPECT_EQ(cache.Find(MakeKey(1, 3), 0), nullptr);
+}
+
+TEST(OverrideApplyPlanCacheTest, NewGenerationDropsPlans) {
+    OverrideApplyPlanCache<TestSet> cache;
+    cache.Insert(MakeKey(1, 2), 5);
+    cache.Insert(MakeKey(1, 3), 5);
+    EXPECT_EQ(cache.Size(), 2u);
+
+    EXPECT_EQ(cache.Find(MakeKey(1, 2), 6), nullptr);
+    EXPECT_EQ(cache.Size(), 0u);
+
+    cache.Insert(MakeKey(1, 2), 6);
+    cache.Insert(MakeKey(1, 3), 7);
+    EXPECT_EQ(cache.Size(), 1u);
+    EXPECT_NE(cache.Find(MakeKey(1, 3), 7), nullptr);
+}
+
+TEST(OverrideApplyPlanCacheTest, OtherModelFileCompilesItsOwnPlan) {
+    // A lone geometry is looked up as "", a pair by their names
+    TestModel single;
+    single.Add(single.Add(nullptr, "ArmorAddon"), "Body", true);
+    TestModel pair = single.Clone();
+    pair.Add(pair.Root(), "Hands", true);
+    TestRegistration registration;
+    registration[""].values = {1};
+    registration["Body"].values = {2};
+    registration["Hands"].values = {3};
+
+    // Another model file of the addon, with the same root node
+    OverrideApplyPlanKey singleKey = MakeKey(1, 2);
+    OverrideApplyPlanKey pairKey = singleKey;
+    pairKey.model = Intern("Armor\\Cuirass_Gloves_1.nif");
+
+    OverrideApplyPlanCache<TestSet> cache;
+    cache.Insert(singleKey, 0).Compile<TestAccess>(single.Root(), [&](const char* name) { return Lookup(registration, name); });
+    EXPECT_EQ(cache.Find(pairKey, 0), nullptr);
+
+    auto& plan = cache.Insert(pairKey, 0);
+    plan.Compile<TestAccess>(pair.Root(), [&](const char* name) { return Lookup(registration, name); });
+    Applied applied;
+    ASSERT_TRUE(Replay(plan, pair.Root(), applied));
+    EXPECT_EQ(applied, ReferenceApply(registration, pair.Root()));
+    EXPECT_EQ(applied.size(), 2u);
+}
+
+TEST(OverrideApplyPlanCacheTest, ClearsWhenFull) {
+    OverrideApplyPlanCache<TestSet> cache;
+    for (UInt32 i = 0; i < OverrideApplyPlanCache<TestSet>::kMaxPlans; ++i) cache.Insert(MakeKey(1, i), 0);
+    EXPECT_EQ(cache.Size(), static_cast<size_t>(OverrideApplyPlanCache<TestSet>::kMaxPlans));
+
+    cache.Insert(MakeKey(2, 0), 0);
+    EXPECT_EQ(cache.Size(), 1u);
+    EXPECT_NE(cache.Find(MakeKey(2, 0), 0), nullptr);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TEST(OverrideApplyPlanBench, ReplayVersusVisitAndLookup) {
+    // A full outfit addon: many shapes, overrides on a few of them
+    constexpr int kGroups = 12, kShapes = 16;
+    TestModel model = BuildArmor(kGroups, kShapes);
+    TestRegistration registration;
+    for (int g = 0; g < kGroups; g += 3) registration["Shape" + std::to_string(g) + "_0"].values = {g};
+
+    auto plan = Compile(registration, model.Root());
+    TestModel attached = model.Clone();
+
+    constexpr int kAttaches = 5000;
+    TestAccess::visits = 0;
+    size_t referenceApplied = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kAttaches; ++i) referenceApplied += ReferenceApply(registration, attached.Root()).size();
+    auto t1 = std::chrono::steady_clock::now();
+    const int referenceVisits = TestAccess::visits;
+
+    TestAccess::visits = 0;
+    size_t replayed = 0;
+    Applied applied;
+    for (int i = 0; i < kAttaches; ++i) {
+        applied.clear();
+        ASSERT_TRUE(Replay(plan, attached.Root(), applied));
+        replayed += applied.size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    const int replayVisits = TestAccess::visits;
+
+    EXPECT_EQ(replayed, referenceApplied);
+    EXPECT_LT(replayVisits * 5, referenceVisits);
+
+    const double referenceUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / kAttaches;
+    const double replayUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / kAttaches;
+    std::printf("[ BENCH    ] %u geometries, %u with overrides: visit+lookup %d visits %.2f us/attach, replay %d visits %.2f us/attach\n",
+                plan.GeometryCount(), plan.Size(), referenceVisits / kAttaches, referenceUs, replayVisits / kAttaches, replayUs);
+}
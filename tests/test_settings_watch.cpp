@@ -0,0 +1,254 @@
+/**
+ * Unit tests for settings file watching and per-key diffing using Google Test.
+ *
+ * Checks that only key edits count as changes, that each key maps to the
+ * caches it feeds (a color to nothing, a font size to fonts only), and that
+ * the watcher reports a save of the real file once and ignores other files
+ * in the same folder.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "SettingsWatch.h"
+
+namespace fs = std::filesystem;
+using SettingsWatch::Compare;
+using SettingsWatch::Diff;
+using SettingsWatch::Parse;
+using SettingsWatch::Watcher;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static const char* kBaseIni =
+    "; whois settings\n"
+    "Format = \"%t\" \"%n\" \" Lv.%l\"\n"
+    "NameFontSize = 122.0\n"
+    "FadeStartDistance = 200\n"
+    "EnableOcclusionCulling = 1\n"
+    "UseParticleTextures = 1\n"
+    "\n"
+    "[Tier0]\n"
+    "Name = Novice\n"
+    "MinLevel = 1\n"
+    "LeftColor = 0.8, 0.8, 0.8\n"
+    "\n"
+    "[SpecialTitle0]\n"
+    "Keyword = Admin\n"
+    "Color = 1.0, 0.2, 0.2\n";
+
+// Base file with one line replaced
+static std::string Edit(const std::string& from, const std::string& to)
+{
+    std::string text = kBaseIni;
+    const auto pos = text.find(from);
+    EXPECT_NE(pos, std::string::npos) << from;
+    return text.replace(pos, from.size(), to);
+}
+
+static Diff DiffAgainstBase(const std::string& text)
+{
+    return Compare(Parse(kBaseIni), Parse(text));
+}
+
+class TempSettingsDir {
+public:
+    TempSettingsDir() {
+        root = fs::temp_directory_path() /
+               ("whois_settings_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        fs::create_directories(root);
+    }
+    ~TempSettingsDir() {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    void Write(const std::string& name, const std::string& text) const {
+        std::ofstream(root / name, std::ios::binary) << text;
+    }
+
+    fs::path root;
+};
+
+// Poll until the watcher reports a change or the timeout passes
+static bool WaitForPoll(Watcher& watcher, Diff& out, std::chrono::milliseconds timeout = std::chrono::seconds(5))
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (watcher.Poll(out))
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// ============================================================================
+// Parse
+// ============================================================================
+
+TEST(SettingsWatchParse, SkipsCommentsAndTrims) {
+    const auto entries = Parse("; comment\n# other\n\n  Key =  value  \r\n[Tier1]\r\nName=Adept\r\n");
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].section, "");
+    EXPECT_EQ(entries[0].key, "Key");
+    EXPECT_EQ(entries[0].value, "value");
+    EXPECT_EQ(entries[1].section, "Tier1");
+    EXPECT_EQ(entries[1].key, "Name");
+    EXPECT_EQ(entries[1].value, "Adept");
+}
+
+TEST(SettingsWatchParse, RepeatedKeyKeepsLastValue) {
+    const auto entries = Parse("ParticleCount = 4\nParticleSize = 2\nParticleCount = 9\n");
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].key, "ParticleCount");
+    EXPECT_EQ(entries[0].value, "9");
+}
+
+TEST(SettingsWatchParse, SameKeyInDifferentSectionsIsKept) {
+    const auto entries = Parse("[Tier0]\nName = A\n[Tier1]\nName = B\n");
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].value, "A");
+    EXPECT_EQ(entries[1].value, "B");
+}
+
+// ============================================================================
+// Compare and Classify
+// ============================================================================
+
+TEST(SettingsWatchDiff, CommentAndWhitespaceEditsAreNotChanges) {
+    const auto diff = DiffAgainstBase(Edit("; whois settings\n", "; edited header\n\n\n") +
+                                      "; trailing comment\n");
+    EXPECT_EQ(diff.keys, 0u);
+    EXPECT_EQ(diff.changes, SettingsWatch::kNone);
+}
+
+TEST(SettingsWatchDiff, ColorChangeInvalidatesNothing) {
+    const auto diff = DiffAgainstBase(Edit("LeftColor = 0.8, 0.8, 0.8", "LeftColor = 0.2, 0.6, 1.0"));
+    EXPECT_EQ(diff.keys, 1u);
+    EXPECT_EQ(diff.changes, SettingsWatch::kNone);
+}
+
+TEST(SettingsWatchDiff, FontSizeChangeRebuildsFontsOnly) {
+    const auto diff = DiffAgainstBase(Edit("NameFontSize = 122.0", "NameFontSize = 96.0"));
+    EXPECT_EQ(diff.keys, 1u);
+    EXPECT_EQ(diff.changes, SettingsWatch::kFonts);
+}
+
+TEST(SettingsWatchDiff, KeysMapToTheirCaches) {
+    EXPECT_EQ(DiffAgainstBase(Edit("Name = Novice", "Name = Beginner")).changes, SettingsWatch::kLabelText);
+    EXPECT_EQ(DiffAgainstBase(Edit("Keyword = Admin", "Keyword = Mod")).changes, SettingsWatch::kLabelText);
+    EXPECT_EQ(DiffAgainstBase(Edit("\" Lv.%l\"", "\" [%l]\"")).changes, SettingsWatch::kLabelText);
+    EXPECT_EQ(DiffAgainstBase(Edit("EnableOcclusionCulling = 1", "EnableOcclusionCulling = 0")).changes,
+              SettingsWatch::kOcclusion);
+    EXPECT_EQ(DiffAgainstBase(Edit("UseParticleTextures = 1", "UseParticleTextures = 0")).changes,
+              SettingsWatch::kParticleTextures);
+    EXPECT_EQ(DiffAgainstBase(Edit("FadeStartDistance = 200", "FadeStartDistance = 350")).changes,
+              SettingsWatch::kNone);
+    EXPECT_EQ(SettingsWatch::Classify("", "NoiseTableSize"), SettingsWatch::kNoiseTables);
+    EXPECT_EQ(SettingsWatch::Classify("", "OcclusionBackend"), SettingsWatch::kOcclusion);
+}
+
+TEST(SettingsWatchDiff, AddedAndRemovedKeysCount) {
+    const auto diff = DiffAgainstBase(Edit("MinLevel = 1\n", "") + "TemplateFormID = 0x12345\n");
+    EXPECT_EQ(diff.keys, 2u);
+    EXPECT_EQ(diff.changes, SettingsWatch::kLabelText | SettingsWatch::kAppearance);
+}
+
+TEST(SettingsWatchDiff, SectionKeysFallBackToGeneralKeys) {
+    // Settings::Load parses unknown keys of a tier section as general keys
+    EXPECT_EQ(SettingsWatch::Classify("Tier3", "TitleFontSize"), SettingsWatch::kFonts);
+    EXPECT_EQ(SettingsWatch::Classify("Tier3", "Name"), SettingsWatch::kLabelText);
+    EXPECT_EQ(SettingsWatch::Classify("Tier3", "Ornaments"), SettingsWatch::kOrnaments);
+    EXPECT_EQ(SettingsWatch::Classify("SpecialTitle1", "Ornaments"), SettingsWatch::kOrnaments);
+    EXPECT_EQ(SettingsWatch::Classify("General", "Name"), SettingsWatch::kNone);
+    EXPECT_EQ(SettingsWatch::Classify("CustomEffects", "TemplateGlow"), SettingsWatch::kNone);
+}
+
+// ============================================================================
+// Watcher
+// ============================================================================
+
+TEST(SettingsWatcher, ReportsSaveOfTheFile) {
+    TempSettingsDir dir;
+    dir.Write("whois.ini", kBaseIni);
+
+    Watcher watcher(dir.root / "whois.ini");
+    ASSERT_TRUE(watcher.Start());
+
+    Diff diff;
+    EXPECT_FALSE(watcher.Poll(diff));
+
+    dir.Write("whois.ini", Edit("NameFontSize = 122.0", "NameFontSize = 80.0"));
+    ASSERT_TRUE(WaitForPoll(watcher, diff));
+    EXPECT_EQ(diff.keys, 1u);
+    EXPECT_EQ(diff.changes, SettingsWatch::kFonts);
+
+    // Taken once
+    EXPECT_FALSE(watcher.Poll(diff));
+}
+
+TEST(SettingsWatcher, IgnoresOtherFilesAndUnchangedSaves) {
+    TempSettingsDir dir;
+    dir.Write("whois.ini", kBaseIni);
+
+    Watcher watcher(dir.root / "whois.ini");
+    ASSERT_TRUE(watcher.Start());
+
+    dir.Write("other.ini", "NameFontSize = 12\n");
+    dir.Write("whois.ini", std::string(kBaseIni) + "; comment only\n");
+
+    Diff diff;
+    EXPECT_FALSE(WaitForPoll(watcher, diff, std::chrono::milliseconds(Watcher::kSettleMs * 5)));
+
+    // Still watching after the ignored events
+    dir.Write("whois.ini", Edit("LeftColor = 0.8, 0.8, 0.8", "LeftColor = 0, 0, 0"));
+    ASSERT_TRUE(WaitForPoll(watcher, diff));
+    EXPECT_EQ(diff.keys, 1u);
+    EXPECT_EQ(diff.changes, SettingsWatch::kNone);
+}
+
+TEST(SettingsWatcher, BurstOfWritesIsMerged) {
+    TempSettingsDir dir;
+    dir.Write("whois.ini", kBaseIni);
+
+    Watcher watcher(dir.root / "whois.ini");
+    ASSERT_TRUE(watcher.Start());
+
+    // Partial writes of one save, closer together than the settle time
+    dir.Write("whois.ini", "");
+    dir.Write("whois.ini", Edit("Name = Novice", "Name = Apprentice"));
+
+    Diff diff;
+    ASSERT_TRUE(WaitForPoll(watcher, diff));
+    EXPECT_EQ(diff.changes, SettingsWatch::kLabelText);
+    EXPECT_EQ(diff.keys, 1u);
+}
+
+TEST(SettingsWatcher, StopIsPrompt) {
+    TempSettingsDir dir;
+    dir.Write("whois.ini", kBaseIni);
+
+    Watcher watcher(dir.root / "whois.ini");
+    ASSERT_TRUE(watcher.Start());
+    EXPECT_TRUE(watcher.Running());
+
+    const auto start = std::chrono::steady_clock::now();
+    watcher.Stop();
+    EXPECT_FALSE(watcher.Running());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    // Stopping twice is harmless
+    watcher.Stop();
+}
+
+TEST(SettingsWatcher, MissingFolderFailsToStart) {
+    Watcher watcher(fs::temp_directory_path() / "whois_settings_does_not_exist" / "whois.ini");
+    EXPECT_FALSE(watcher.Start());
+    EXPECT_FALSE(watcher.Running());
+}
@@ -0,0 +1,323 @@
+/**
+ * Unit tests for the sharded override registrations using Google Test.
+ *
+ * Checks that handles stay on their shard, that writers only advance their
+ * own shard's generation, that readers of a shard run together while a
+ * writer keeps them out, and stress tests mixed reads and writes from
+ * several threads against the single lock the registrations had before.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ShardedRegistrationMap.h"
+
+// Stands in for an actor's overrides: values read on every apply
+struct TestRegistration {
+    std::vector<UInt32> values = std::vector<UInt32>(16, 1);
+    UInt32 writes = 0;
+};
+
+using TestMap = ShardedRegistrationMap<TestRegistration>;
+
+// Two handles of the same plugin that land on different shards
+static std::pair<UInt32, UInt32> HandlesOnDifferentShards() {
+    const UInt32 first = 0x0A000800;
+    for (UInt32 h = first + 1; h < first + 1024; ++h) {
+        if (TestMap::ShardIndex(h) != TestMap::ShardIndex(first)) return {first, h};
+    }
+    return {first, first};
+}
+
+// Generation of the shard holding handle
+static UInt32 Generation(const TestMap& map, UInt32 handle) { return map.Read(handle).Generation(); }
+
+// ============================================================================
+// Sharding
+// ============================================================================
+
+TEST(ShardedRegistrationMapTest, HandleAlwaysMapsToTheSameShard) {
+    for (UInt32 h = 0; h < 1000; ++h) {
+        EXPECT_EQ(TestMap::ShardIndex(h), TestMap::ShardIndex(h));
+        EXPECT_LT(TestMap::ShardIndex(h), static_cast<UInt32>(TestMap::kShards));
+    }
+}
+
+TEST(ShardedRegistrationMapTest, OnePluginsFormsSpreadOverEveryShard) {
+    // Form ids of one plugin only differ in their low bits
+    std::set<UInt32> shards;
+    for (UInt32 h = 0x0A000800; h < 0x0A000800 + 256; ++h) shards.insert(TestMap::ShardIndex(h));
+    EXPECT_EQ(shards.size(), static_cast<size_t>(TestMap::kShards));
+}
+
+// ============================================================================
+// Readers and writers
+// ============================================================================
+
+TEST(ShardedRegistrationMapTest, ReadFindsWrittenRegistration) {
+    TestMap map;
+    EXPECT_EQ(map.Read(0x14).Find(), nullptr);
+
+    map.Write(0x14).Get().writes = 7;
+
+    auto reader = map.Read(0x14);
+    ASSERT_NE(reader.Find(), nullptr);
+    EXPECT_EQ(reader.Find()->first, 0x14u);
+    EXPECT_EQ(reader.Find()->second.writes, 7u);
+}
+
+TEST(ShardedRegistrationMapTest, WriterFindDoesNotAdd) {
+    TestMap map;
+    {
+        auto writer = map.Write(0x14);
+        EXPECT_EQ(writer.Find(), nullptr);
+    }
+    EXPECT_EQ(map.Size(), 0u);
+}
+
+TEST(ShardedRegistrationMapTest, WriterAdvancesOnlyItsShard) {
+    TestMap map;
+    auto [a, b] = HandlesOnDifferentShards();
+    ASSERT_NE(TestMap::ShardIndex(a), TestMap::ShardIndex(b));
+
+    const UInt32 genA = Generation(map, a);
+    const UInt32 genB = Generation(map, b);
+    map.Write(a).Get().writes++;
+
+    EXPECT_NE(Generation(map, a), genA);
+    EXPECT_EQ(Generation(map, b), genB);
+}
+
+TEST(ShardedRegistrationMapTest, ReaderDoesNotAdvanceGeneration) {
+    TestMap map;
+    map.Write(0x14).Get();
+    const UInt32 gen = Generation(map, 0x14);
+    for (int i = 0; i < 3; ++i) map.Read(0x14).Find();
+    EXPECT_EQ(Generation(map, 0x14), gen);
+}
+
+TEST(ShardedRegistrationMapTest, WriterThatOnlyLooksDoesNotAdvanceGeneration) {
+    TestMap map;
+    map.Write(0x14).Get();
+    const UInt32 gen = Generation(map, 0x14);
+
+    // A lookup, and an erase of a handle that has nothing
+    map.Write(0x14).Find();
+    map.Write(0x15).Erase();
+    EXPECT_EQ(Generation(map, 0x14), gen);
+
+    {
+        auto writer = map.Write(0x14);
+        writer.Find()->second.writes++;
+        writer.Changed();
+    }
+    EXPECT_NE(Generation(map, 0x14), gen);
+}
+
+TEST(ShardedRegistrationMapTest, EraseRemovesOnlyThatHandle) {
+    TestMap map;
+    map.Write(0x14).Get();
+    map.Write(0x15).Get();
+
+    map.Write(0x14).Erase();
+    EXPECT_EQ(map.Read(0x14).Find(), nullptr);
+    EXPECT_NE(map.Read(0x15).Find(), nullptr);
+    EXPECT_EQ(map.Size(), 1u);
+}
+
+TEST(ShardedRegistrationMapTest, ClearEmptiesAndAdvancesEveryShard) {
+    TestMap map;
+    std::vector<UInt32> generations;
+    for (UInt32 h = 0; h < 256; ++h) map.Write(h).Get();
+    for (UInt32 h = 0; h < 256; ++h) generations.push_back(Generation(map, h));
+
+    map.Clear();
+    EXPECT_EQ(map.Size(), 0u);
+    for (UInt32 h = 0; h < 256; ++h) EXPECT_NE(Generation(map, h), generations[h]);
+}
+
+TEST(ShardedRegistrationMapTest, ForEachVisitsEveryHandleOnce) {
+    TestMap map;
+    for (UInt32 h = 0x0A000800; h < 0x0A000900; ++h) map.Write(h).Get().writes = h;
+
+    std::set<UInt32> seen;
+    map.ForEach([&](UInt32 handle, const TestRegistration& reg) {
+        EXPECT_EQ(reg.writes, handle);
+        EXPECT_TRUE(seen.insert(handle).second);
+    });
+    EXPECT_EQ(seen.size(), 256u);
+    EXPECT_EQ(map.Size(), 256u);
+}
+
+// ============================================================================
+// Concurrency
+// ============================================================================
+
+TEST(ShardedRegistrationMapTest, ReadersShareAShard) {
+    TestMap map;
+    map.Write(0x14).Get();
+
+    auto reader = map.Read(0x14);
+    std::thread other([&] {
+        auto second = map.Read(0x14);
+        EXPECT_NE(second.Find(), nullptr);
+    });
+    other.join();
+    EXPECT_EQ(map.Contentions(), 0u);
+}
+
+TEST(ShardedRegistrationMapTest, WriterKeepsReadersOut) {
+    TestMap map;
+    map.Write(0x14).Get();
+
+    std::atomic<bool> read{false};
+    std::thread other;
+    {
+        auto writer = map.Write(0x14);
+        other = std::thread([&] {
+            auto reader = map.Read(0x14);
+            read = true;
+        });
+
+        // Wait for the reader to find the shard held
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (map.Contentions() == 0 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        EXPECT_EQ(map.Contentions(), 1u);
+        EXPECT_FALSE(read);
+    }
+    other.join();
+    EXPECT_TRUE(read);
+}
+
+TEST(ShardedRegistrationMapTest, WriterOnAnotherShardDoesNotBlock) {
+    TestMap map;
+    auto [a, b] = HandlesOnDifferentShards();
+    map.Write(b).Get();
+
+    auto writer = map.Write(a);
+    std::thread other([&] { EXPECT_NE(map.Read(b).Find(), nullptr); });
+    other.join();
+    EXPECT_EQ(map.Contentions(), 0u);
+}
+
+// ============================================================================
+// Stress
+// ============================================================================
+
+// The registrations before: one map behind one lock
+struct SingleLockMap {
+    std::mutex lock;
+    std::unordered_map<UInt32, TestRegistration> data;
+    std::atomic<UInt64> contended{0};
+
+    std::unique_lock<std::mutex> Lock() {
+        std::unique_lock<std::mutex> locker(lock, std::try_to_lock);
+        if (!locker.owns_lock()) {
+            contended++;
+            locker.lock();
+        }
+        return locker;
+    }
+};
+
+constexpr UInt32 kStressHandles = 512;
+constexpr int kStressOps = 200000;
+
+// Xorshift, so every thread draws its own repeatable handles
+static UInt32 Next(UInt32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+template <class Op>
+static double RunThreads(int threads, Op op) {
+    std::vector<std::thread> workers;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) workers.emplace_back(op, t);
+    for (auto& worker : workers) worker.join();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+TEST(ShardedRegistrationMapBenchmark, MixedReadWriteStress) {
+    // Oversubscribe small machines so the locks still get fought over
+    const int threads = static_cast<int>(std::clamp(std::thread::hardware_concurrency(), 4u, 8u));
+
+    TestMap sharded;
+    SingleLockMap single;
+    for (UInt32 h = 0; h < kStressHandles; ++h) {
+        sharded.Write(0x0A000800 + h).Get();
+        single.data[0x0A000800 + h];
+    }
+
+    // One in ten operations changes a registration, the rest apply one
+    std::atomic<UInt64> shardedWrites{0}, singleWrites{0}, checksum{0};
+    const double shardedSeconds = RunThreads(threads, [&](int t) {
+        UInt32 state = 0x9E3779B9u + t;
+        UInt64 sum = 0, writes = 0;
+        for (int i = 0; i < kStressOps; ++i) {
+            const UInt32 r = Next(state);
+            const UInt32 handle = 0x0A000800 + r % kStressHandles;
+            if (r % 10 == 0) {
+                auto writer = sharded.Write(handle);
+                TestRegistration& reg = writer.Get();
+                reg.values[r % reg.values.size()]++;
+                reg.writes++;
+                writes++;
+            } else {
+                auto reader = sharded.Read(handle);
+                if (auto entry = reader.Find())
+                    for (UInt32 value : entry->second.values) sum += value;
+            }
+        }
+        shardedWrites += writes;
+        checksum += sum;
+    });
+
+    const double singleSeconds = RunThreads(threads, [&](int t) {
+        UInt32 state = 0x9E3779B9u + t;
+        UInt64 sum = 0, writes = 0;
+        for (int i = 0; i < kStressOps; ++i) {
+            const UInt32 r = Next(state);
+            const UInt32 handle = 0x0A000800 + r % kStressHandles;
+            auto locker = single.Lock();
+            auto it = single.data.find(handle);
+            if (r % 10 == 0) {
+                it->second.values[r % it->second.values.size()]++;
+                it->second.writes++;
+                writes++;
+            } else {
+                for (UInt32 value : it->second.values) sum += value;
+            }
+        }
+        singleWrites += writes;
+        checksum += sum;
+    });
+
+    // No write was lost on either side
+    UInt64 shardedCounted = 0, singleCounted = 0;
+    sharded.ForEach([&](UInt32, const TestRegistration& reg) { shardedCounted += reg.writes; });
+    for (auto& entry : single.data) singleCounted += entry.second.writes;
+    EXPECT_EQ(shardedCounted, shardedWrites.load());
+    EXPECT_EQ(singleCounted, singleWrites.load());
+    EXPECT_EQ(shardedWrites.load(), singleWrites.load());
+    EXPECT_EQ(sharded.Size(), kStressHandles);
+    EXPECT_GT(checksum.load(), 0u);
+
+    const double ops = static_cast<double>(threads) * kStressOps;
+    std::printf("[ BENCH    ] %d threads, %u actors, 10%% writes: single lock %.2f Mops/s %llu contended, "
+                "%d shards %.2f Mops/s %llu contended\n",
+                threads, kStressHandles, ops / singleSeconds / 1e6,
+                static_cast<unsigned long long>(single.contended.load()), static_cast<int>(TestMap::kShards),
+                ops / shardedSeconds / 1e6, static_cast<unsigned long long>(sharded.Contentions()));
+}
@@ -0,0 +1,505 @@
+/**
+ * Unit tests for the delta-encoded actor snapshot using Google Test.
+ *
+ * Feeds SnapshotDelta::Encoder and Channel randomized snapshot sequences
+ * and checks that the mirrored table on the consuming side always matches
+ * the latest snapshot, including after a backlog resync. Global operator
+ * new is counted to verify that steady-state updates do not allocate.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SnapshotDelta.h"
+
+using SnapshotDelta::ActorState;
+using SnapshotDelta::Channel;
+using SnapshotDelta::Encoder;
+using SnapshotDelta::Op;
+using SnapshotDelta::Record;
+using SnapshotDelta::Table;
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+static std::atomic<std::uint64_t> g_allocations{0};
+
+// GCC pairs the inlined free() below with the library operator new
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static const char* const kNames[] = {
+    "whiterun guard", "Lydia", "  aela the huntress  ", "Companion Vilkas Of Jorrvaskr",
+    "Brynjolf", "Ulfric Stormcloak, Jarl Of Windhelm", "Bandit Marauder", "Draugr Deathlord",
+};
+
+static ActorState MakeActor(std::uint32_t formID, std::mt19937& rng)
+{
+    ActorState s;
+    s.formID = formID;
+    s.pos[0] = static_cast<float>(rng() % 4000) - 2000.0f;
+    s.pos[1] = static_cast<float>(rng() % 4000) - 2000.0f;
+    s.pos[2] = static_cast<float>(rng() % 400);
+    s.distToPlayer = static_cast<float>(rng() % 3000);
+    s.level = static_cast<std::uint16_t>(1 + rng() % 80);
+    s.disposition = static_cast<std::uint8_t>(rng() % 3);
+    s.flags = (rng() % 4 == 0) ? SnapshotDelta::kOccluded : 0;
+    s.SetName(kNames[rng() % (sizeof(kNames) / sizeof(kNames[0]))]);
+    return s;
+}
+
+// Mirror content must equal the snapshot, in the encoder's order
+static void ExpectMirrors(const Table& mirror, const std::vector<ActorState>& frame, const Encoder& encoder)
+{
+    ASSERT_EQ(mirror.Size(), frame.size());
+    for (const auto& s : frame)
+    {
+        const std::size_t slot = mirror.Find(s.formID);
+        ASSERT_NE(slot, Table::npos) << std::hex << s.formID;
+        EXPECT_TRUE(mirror.Actors()[slot] == s) << std::hex << s.formID;
+        EXPECT_STREQ(mirror.Actors()[slot].name, s.name);
+    }
+
+    const auto& expected = encoder.State().Actors();
+    ASSERT_EQ(mirror.Actors().size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        EXPECT_EQ(mirror.Actors()[i].formID, expected[i].formID) << "slot " << i;
+}
+
+// Random walk over snapshots: moves every frame, occasional attribute
+// changes, arrivals, departures and reordering
+class SceneSim {
+public:
+    explicit SceneSim(std::uint32_t seed, std::size_t target) : m_rng(seed), m_target(target)
+    {
+        for (std::size_t i = 0; i < target; ++i)
+            m_actors.push_back(MakeActor(m_nextID++, m_rng));
+    }
+
+    const std::vector<ActorState>& Step(int churnPercent)
+    {
+        for (auto& s : m_actors)
+        {
+            s.pos[0] += static_cast<float>(static_cast<int>(m_rng() % 21) - 10) * 0.5f;
+            s.pos[1] += static_cast<float>(static_cast<int>(m_rng() % 21) - 10) * 0.5f;
+            s.distToPlayer = std::max(0.0f, s.distToPlayer + static_cast<float>(static_cast<int>(m_rng() % 11) - 5));
+            if (m_rng() % 50 == 0)
+                s.flags ^= SnapshotDelta::kOccluded;
+            if (m_rng() % 200 == 0)
+                s.level++;
+            if (m_rng() % 500 == 0)
+                s.SetName(kNames[m_rng() % (sizeof(kNames) / sizeof(kNames[0]))]);
+        }
+
+        if (static_cast<int>(m_rng() % 100) < churnPercent && !m_actors.empty())
+            m_actors.erase(m_actors.begin() + static_cast<long>(m_rng() % m_actors.size()));
+        if (m_actors.size() < m_target && static_cast<int>(m_rng() % 100) < churnPercent)
+            m_actors.insert(m_actors.begin() + static_cast<long>(m_rng() % (m_actors.size() + 1)), MakeActor(m_nextID++, m_rng));
+        if (static_cast<int>(m_rng() % 100) < churnPercent && m_actors.size() > 1)
+            std::swap(m_actors[m_rng() % m_actors.size()], m_actors[m_rng() % m_actors.size()]);
+
+        return m_actors;
+    }
+
+private:
+    std::mt19937 m_rng;
+    std::size_t m_target;
+    std::uint32_t m_nextID = 0xFF000800;
+    std::vector<ActorState> m_actors;
+};
+
+// ============================================================================
+// Names
+// ============================================================================
+
+TEST(SnapshotDeltaName, TrimsAndTitleCases)
+{
+    ActorState s;
+    s.SetName("  whiterun   guard \t");
+    EXPECT_STREQ(s.name, "Whiterun   Guard");
+    EXPECT_EQ(s.nameLength, 16u);
+
+    s.SetName("");
+    EXPECT_STREQ(s.name, "");
+    s.SetName(" \t ");
+    EXPECT_STREQ(s.name, "");
+    s.SetName(nullptr);
+    EXPECT_EQ(s.nameLength, 0u);
+}
+
+TEST(SnapshotDeltaName, TruncatesOnUtf8Boundary)
+{
+    // 53 ASCII bytes then a 2-byte sequence straddling the limit
+    std::string text(53, 'a');
+    text += "\xC3\xA9";
+    text += "tail";
+
+    ActorState s;
+    s.SetName(text.c_str());
+    EXPECT_EQ(s.nameLength, 53u);
+    EXPECT_EQ(std::strlen(s.name), 53u);
+
+    std::string fits(SnapshotDelta::kMaxNameLength, 'b');
+    s.SetName(fits.c_str());
+    EXPECT_EQ(s.nameLength, SnapshotDelta::kMaxNameLength);
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+TEST(SnapshotDeltaEncode, EmitsOnlyWhatChanged)
+{
+    std::mt19937 rng(1);
+    std::vector<ActorState> frame = {MakeActor(1, rng), MakeActor(2, rng)};
+    Encoder encoder;
+    std::vector<Record> out;
+
+    encoder.Encode(frame.data(), frame.size(), out);
+    ASSERT_EQ(out.size(), 4u);
+    EXPECT_EQ(out[0].op, Op::Add);
+    EXPECT_EQ(out[1].op, Op::Position);
+
+    // Nothing changed: nothing sent
+    out.clear();
+    encoder.Encode(frame.data(), frame.size(), out);
+    EXPECT_TRUE(out.empty());
+
+    // Movement and occlusion are position-only
+    out.clear();
+    frame[0].pos[2] += 1.0f;
+    frame[1].flags ^= SnapshotDelta::kOccluded;
+    encoder.Encode(frame.data(), frame.size(), out);
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].op, Op::Position);
+    EXPECT_EQ(out[1].op, Op::Position);
+
+    // A level-up is attribute-only
+    out.clear();
+    frame[1].level++;
+    encoder.Encode(frame.data(), frame.size(), out);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].op, Op::Attributes);
+    EXPECT_EQ(out[0].formID, 2u);
+
+    // Leaving is a single remove
+    out.clear();
+    frame.erase(frame.begin());
+    encoder.Encode(frame.data(), frame.size(), out);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].op, Op::Remove);
+    EXPECT_EQ(out[0].formID, 1u);
+}
+
+TEST(SnapshotDeltaEncode, RemovalKeepsOrderOfRemainingActors)
+{
+    std::mt19937 rng(2);
+    std::vector<ActorState> frame;
+    for (std::uint32_t id = 10; id < 16; ++id)
+        frame.push_back(MakeActor(id, rng));
+
+    Encoder encoder;
+    Table mirror;
+    std::vector<Record> out;
+    encoder.Encode(frame.data(), frame.size(), out);
+
+    frame.erase(frame.begin() + 4);
+    frame.erase(frame.begin() + 1);
+    encoder.Encode(frame.data(), frame.size(), out);
+    mirror.Apply(out.data(), out.size());
+
+    std::vector<std::uint32_t> order;
+    for (const auto& s : mirror.Actors())
+        order.push_back(s.formID);
+    EXPECT_EQ(order, (std::vector<std::uint32_t>{10, 12, 13, 15}));
+    ExpectMirrors(mirror, frame, encoder);
+}
+
+TEST(SnapshotDeltaEncode, AnyStreamReconstructsSnapshot)
+{
+    for (std::uint32_t seed = 1; seed <= 8; ++seed)
+    {
+        SceneSim sim(seed, 48);
+        Encoder encoder;
+        Table mirror;
+        std::vector<Record> out;
+
+        for (int f = 0; f < 400; ++f)
+        {
+            const int churn = (f % 100 < 20) ? 60 : 5;
+            const auto& frame = sim.Step(churn);
+            out.clear();
+            encoder.Encode(frame.data(), frame.size(), out);
+            mirror.Apply(out.data(), out.size());
+            ExpectMirrors(mirror, frame, encoder);
+            if (HasFailure())
+                return;
+        }
+
+        // Going empty and coming back
+        out.clear();
+        encoder.Encode(nullptr, 0, out);
+        mirror.Apply(out.data(), out.size());
+        EXPECT_TRUE(mirror.Empty());
+    }
+}
+
+TEST(SnapshotDeltaEncode, BatchedRecordsReconstructSnapshot)
+{
+    // The consumer may skip frames and apply several updates at once
+    SceneSim sim(99, 64);
+    Encoder encoder;
+    Table mirror;
+    std::vector<Record> pending;
+    std::mt19937 rng(7);
+
+    for (int f = 0; f < 600; ++f)
+    {
+        const auto& frame = sim.Step(20);
+        encoder.Encode(frame.data(), frame.size(), pending);
+        if (rng() % 4 == 0)
+        {
+            mirror.Apply(pending.data(), pending.size());
+            pending.clear();
+            ExpectMirrors(mirror, frame, encoder);
+            if (HasFailure())
+                return;
+        }
+    }
+}
+
+TEST(SnapshotDeltaEncode, FullEncodingResyncsStaleMirror)
+{
+    SceneSim sim(5, 32);
+    Encoder encoder;
+    std::vector<Record> out;
+    for (int f = 0; f < 50; ++f)
+    {
+        const auto& frame = sim.Step(30);
+        out.clear();
+        encoder.Encode(frame.data(), frame.size(), out);
+    }
+
+    // A mirror holding stale content is replaced entirely
+    std::mt19937 rng(3);
+    Table mirror;
+    mirror.Add(MakeActor(0xDEAD, rng));
+    out.clear();
+    encoder.EncodeFull(out);
+    EXPECT_EQ(out.front().op, Op::Clear);
+    mirror.Apply(out.data(), out.size());
+    ExpectMirrors(mirror, encoder.State().Actors(), encoder);
+}
+
+// ============================================================================
+// Channel
+// ============================================================================
+
+TEST(SnapshotDeltaChannel, BacklogIsBoundedAndResyncs)
+{
+    SceneSim sim(11, 64);
+    Channel channel(1024);
+    Table mirror;
+
+    // Render thread stalled in a menu for a long time
+    std::vector<ActorState> last;
+    for (int f = 0; f < 500; ++f)
+    {
+        last = sim.Step(10);
+        channel.Publish(last.data(), last.size());
+    }
+
+    const auto stats = channel.GetStats();
+    EXPECT_GT(stats.resyncs, 0u);
+
+    const std::size_t applied = channel.Consume(mirror);
+    EXPECT_LE(applied, 1024u);
+    ASSERT_EQ(mirror.Size(), last.size());
+    for (const auto& s : last)
+    {
+        const std::size_t slot = mirror.Find(s.formID);
+        ASSERT_NE(slot, Table::npos);
+        EXPECT_TRUE(mirror.Actors()[slot] == s);
+    }
+    EXPECT_EQ(channel.Consume(mirror), 0u);
+}
+
+TEST(SnapshotDeltaChannel, ConcurrentPublishAndConsume)
+{
+    Channel channel;
+    Table mirror;
+    std::vector<ActorState> final;
+    std::atomic<bool> done{false};
+
+    std::thread game([&]() {
+        SceneSim sim(21, 96);
+        for (int f = 0; f < 3000; ++f)
+        {
+            const auto& frame = sim.Step(10);
+            channel.Publish(frame.data(), frame.size());
+            if (f == 2999)
+                final = frame;
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    while (!done.load(std::memory_order_acquire))
+        channel.Consume(mirror);
+    game.join();
+    channel.Consume(mirror);
+
+    ASSERT_EQ(mirror.Size(), final.size());
+    for (const auto& s : final)
+    {
+        const std::size_t slot = mirror.Find(s.formID);
+        ASSERT_NE(slot, Table::npos);
+        EXPECT_TRUE(mirror.Actors()[slot] == s);
+    }
+}
+
+TEST(SnapshotDeltaChannel, SteadyStateDoesNotAllocate)
+{
+    SceneSim sim(31, 256);
+    Channel channel;
+    Table mirror;
+
+    // Warm up: buffers grow to their high-water mark
+    for (int f = 0; f < 200; ++f)
+    {
+        const auto& frame = sim.Step(0);
+        channel.Publish(frame.data(), frame.size());
+        channel.Consume(mirror);
+    }
+
+    // Copy frames up front so the simulation itself is not counted
+    std::vector<std::vector<ActorState>> frames;
+    for (int f = 0; f < 100; ++f)
+        frames.push_back(sim.Step(0));
+
+    const std::uint64_t before = g_allocations.load();
+    for (const auto& frame : frames)
+    {
+        channel.Publish(frame.data(), frame.size());
+        channel.Consume(mirror);
+    }
+    EXPECT_EQ(g_allocations.load() - before, 0u);
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+// What the renderer used to hand over: a full vector of actors with
+// std::string names, copied into s_snapshot and again into the draw copy
+struct LegacyActor
+{
+    std::uint32_t formID;
+    float pos[3];
+    std::string name;
+    std::uint16_t level;
+    float distToPlayer;
+    std::uint8_t dispo;
+    bool isPlayer;
+    bool isOccluded;
+};
+
+TEST(SnapshotDeltaBench, BytesAndAllocationsPerFrame)
+{
+    constexpr int kFrames = 600;
+
+    for (std::size_t count : {16u, 64u, 256u})
+    {
+        // Legacy: build, copy to the shared snapshot, copy to the draw list
+        std::uint64_t legacyBytes = 0;
+        std::uint64_t legacyAllocs = 0;
+        {
+            SceneSim sim(static_cast<std::uint32_t>(count), count);
+            std::vector<LegacyActor> temp, shared, local;
+            for (int f = 0; f < kFrames; ++f)
+            {
+                const auto& frame = sim.Step(2);
+                const std::uint64_t a0 = g_allocations.load();
+                temp.clear();
+                for (const auto& s : frame)
+                {
+                    LegacyActor d;
+                    d.formID = s.formID;
+                    std::memcpy(d.pos, s.pos, sizeof(d.pos));
+                    d.name = std::string(s.name, s.nameLength);
+                    d.level = s.level;
+                    d.distToPlayer = s.distToPlayer;
+                    d.dispo = s.disposition;
+                    d.isPlayer = false;
+                    d.isOccluded = (s.flags & SnapshotDelta::kOccluded) != 0;
+                    temp.push_back(std::move(d));
+                }
+                shared = temp;
+                local = shared;
+                legacyAllocs += g_allocations.load() - a0;
+
+                std::uint64_t bytes = 0;
+                for (const auto& d : temp)
+                    bytes += sizeof(LegacyActor) + (d.name.size() > 15 ? d.name.size() + 1 : 0);
+                legacyBytes += 2 * bytes;  // two copies per frame
+            }
+        }
+
+        // Delta: encode, queue, apply to the mirror
+        std::uint64_t deltaBytes = 0;
+        std::uint64_t deltaAllocs = 0;
+        {
+            SceneSim sim(static_cast<std::uint32_t>(count), count);
+            Channel channel;
+            Table mirror;
+            std::uint64_t lastPublished = 0;
+            for (int f = 0; f < kFrames; ++f)
+            {
+                const auto& frame = sim.Step(2);
+                const std::uint64_t a0 = g_allocations.load();
+                channel.Publish(frame.data(), frame.size());
+                channel.Consume(mirror);
+                if (f >= 60)  // after warm-up
+                    deltaAllocs += g_allocations.load() - a0;
+
+                const std::uint64_t published = channel.GetStats().published;
+                deltaBytes += (published - lastPublished) * sizeof(Record);
+                lastPublished = published;
+            }
+        }
+
+        std::printf("[ BENCH    ] %3zu actors: legacy %7.0f B/frame %6.1f allocs/frame | delta %7.0f B/frame %6.2f allocs/frame\n",
+                    count,
+                    static_cast<double>(legacyBytes) / kFrames, static_cast<double>(legacyAllocs) / kFrames,
+                    static_cast<double>(deltaBytes) / kFrames, static_cast<double>(deltaAllocs) / (kFrames - 60));
+
+        EXPECT_LT(deltaAllocs, static_cast<std::uint64_t>(kFrames - 60));  // amortized growth only
+        EXPECT_GT(legacyAllocs, static_cast<std::uint64_t>(kFrames));
+    }
+}
@@ -0,0 +1,254 @@
+/**
+ * Unit tests for snapshot scan scheduling using Google Test.
+ *
+ * Drives the scheduler with a simulated 60 FPS main loop: the main loop hook
+ * fires early in each game frame, SKSE drains its task queue at a point that
+ * varies from frame to frame, and the render thread draws late in the frame.
+ * Checks that the hook gives a fixed scan to draw lag, that task mode keeps
+ * at most one task in flight, and that a missing hook falls back to tasks.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "SnapshotSchedule.h"
+
+using SnapshotSchedule::kFallbackFrames;
+using SnapshotSchedule::Mode;
+using SnapshotSchedule::Scheduler;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+    constexpr double kFrame = 1.0 / 60.0;
+    constexpr double kHookAt = 0.003;    // Main loop hook, after actors update
+    constexpr double kRenderAt = 0.012;  // Render thread draws
+
+    // One game frame per iteration; events ordered by their offset in the frame
+    struct Sim
+    {
+        Scheduler schedule;
+        bool hookInstalled = true;
+        std::mt19937 rng{1234};
+        std::uniform_real_distribution<double> drainAt{0.0, kFrame};
+
+        bool taskQueued = false;  // Sitting in the SKSE queue
+        int scans = 0;
+        int maxTasksInFlight = 0;
+
+        void Scan(double t)
+        {
+            ++scans;
+            schedule.Scanned(t);
+        }
+
+        void Drain(double t)
+        {
+            if (!taskQueued)
+                return;
+            taskQueued = false;
+            if (schedule.TaskStarted())
+                Scan(t);
+            schedule.TaskFinished();
+        }
+
+        void Render(double t)
+        {
+            if (schedule.BeginRenderFrame(t))
+            {
+                EXPECT_FALSE(taskQueued) << "Second task while one is pending";
+                taskQueued = true;
+            }
+            maxTasksInFlight = std::max(maxTasksInFlight, taskQueued ? 1 : 0);
+        }
+
+        void Frame(int index)
+        {
+            const double t = index * kFrame;
+            const double drain = drainAt(rng);
+
+            if (drain < kHookAt)
+                Drain(t + drain);
+            if (hookInstalled && schedule.MainLoopUpdate())
+                Scan(t + kHookAt);
+            if (drain >= kHookAt && drain < kRenderAt)
+                Drain(t + drain);
+            Render(t + kRenderAt);
+            if (drain >= kRenderAt)
+                Drain(t + drain);
+        }
+
+        void Run(int first, int count)
+        {
+            for (int i = first; i < first + count; ++i)
+                Frame(i);
+        }
+    };
+}
+
+// ============================================================================
+// Mode
+// ============================================================================
+
+TEST(SnapshotScheduleMode, FromInt) {
+    EXPECT_EQ(SnapshotSchedule::ModeFromInt(0), Mode::Task);
+    EXPECT_EQ(SnapshotSchedule::ModeFromInt(1), Mode::MainLoop);
+    EXPECT_EQ(SnapshotSchedule::ModeFromInt(7), Mode::MainLoop);
+    EXPECT_EQ(SnapshotSchedule::ModeFromInt(-1), Mode::MainLoop);
+}
+
+// ============================================================================
+// Main Loop
+// ============================================================================
+
+TEST(SnapshotScheduleMainLoop, OneScanPerFrameWithoutTasks) {
+    Sim sim;
+    sim.Run(0, 600);
+
+    EXPECT_EQ(sim.schedule.TasksQueued(), 0u);
+    EXPECT_FALSE(sim.schedule.FallingBack());
+    EXPECT_EQ(sim.scans, 599);  // The first frame only arms
+}
+
+TEST(SnapshotScheduleMainLoop, LagIsFixed) {
+    Sim sim;
+    sim.Run(0, 600);
+
+    const auto lag = sim.schedule.Lag();
+    EXPECT_EQ(lag.samples, SnapshotSchedule::kLagSamples);
+    EXPECT_NEAR(lag.meanMs, (kRenderAt - kHookAt) * 1000.0, 1e-3);
+    EXPECT_LT(lag.jitterMs, 1e-3f);
+}
+
+TEST(SnapshotScheduleMainLoop, HookScansOnlyWhenArmed) {
+    Scheduler schedule;
+    EXPECT_FALSE(schedule.MainLoopUpdate());
+
+    EXPECT_FALSE(schedule.BeginRenderFrame(0.0));
+    EXPECT_TRUE(schedule.MainLoopUpdate());
+    EXPECT_FALSE(schedule.MainLoopUpdate());  // Game ran ahead of the renderer
+}
+
+TEST(SnapshotScheduleMainLoop, HookIgnoredInTaskMode) {
+    Scheduler schedule;
+    schedule.SetMode(Mode::Task);
+    EXPECT_TRUE(schedule.BeginRenderFrame(0.0));
+    EXPECT_FALSE(schedule.MainLoopUpdate());
+}
+
+// ============================================================================
+// Task
+// ============================================================================
+
+TEST(SnapshotScheduleTask, OneTaskInFlight) {
+    Sim sim;
+    sim.schedule.SetMode(Mode::Task);
+    sim.hookInstalled = false;
+    sim.Run(0, 600);
+
+    EXPECT_EQ(sim.maxTasksInFlight, 1);
+    EXPECT_GT(sim.schedule.TasksQueued(), 0u);
+    EXPECT_EQ(static_cast<std::uint64_t>(sim.scans) + (sim.taskQueued ? 1 : 0), sim.schedule.TasksQueued());
+}
+
+TEST(SnapshotScheduleTask, PendingTaskBlocksAnother) {
+    Scheduler schedule;
+    schedule.SetMode(Mode::Task);
+    EXPECT_TRUE(schedule.BeginRenderFrame(0.0));
+    EXPECT_FALSE(schedule.BeginRenderFrame(kFrame));
+
+    EXPECT_TRUE(schedule.TaskStarted());
+    schedule.TaskFinished();
+    EXPECT_TRUE(schedule.BeginRenderFrame(2 * kFrame));
+}
+
+TEST(SnapshotScheduleTask, NotQueuedReleasesSlot) {
+    Scheduler schedule;
+    schedule.SetMode(Mode::Task);
+    EXPECT_TRUE(schedule.BeginRenderFrame(0.0));
+    schedule.TaskNotQueued();
+    EXPECT_TRUE(schedule.BeginRenderFrame(kFrame));
+}
+
+TEST(SnapshotScheduleTask, LagVariesWithDrainPoint) {
+    Sim sim;
+    sim.schedule.SetMode(Mode::Task);
+    sim.hookInstalled = false;
+    sim.Run(0, 600);
+
+    const auto lag = sim.schedule.Lag();
+    EXPECT_GT(lag.samples, 0u);
+    EXPECT_GT(lag.jitterMs, 2.0f);
+}
+
+// ============================================================================
+// Fallback
+// ============================================================================
+
+TEST(SnapshotScheduleFallback, MissingHookFallsBackToTasks) {
+    Sim sim;
+    sim.hookInstalled = false;
+
+    sim.Run(0, kFallbackFrames - 1);
+    EXPECT_FALSE(sim.schedule.FallingBack());
+    EXPECT_EQ(sim.scans, 0);
+
+    sim.Run(kFallbackFrames - 1, 300);
+    EXPECT_TRUE(sim.schedule.FallingBack());
+    EXPECT_GT(sim.scans, 200);
+    EXPECT_EQ(sim.maxTasksInFlight, 1);
+}
+
+TEST(SnapshotScheduleFallback, RecoversWhenHookReports) {
+    Sim sim;
+    sim.hookInstalled = false;
+    sim.Run(0, 100);
+    ASSERT_TRUE(sim.schedule.FallingBack());
+
+    sim.hookInstalled = true;
+    sim.Run(100, 2);
+    EXPECT_FALSE(sim.schedule.FallingBack());
+
+    const auto tasks = sim.schedule.TasksQueued();
+    sim.Run(102, 300);
+    EXPECT_EQ(sim.schedule.TasksQueued(), tasks);
+    EXPECT_NEAR(sim.schedule.Lag().meanMs, (kRenderAt - kHookAt) * 1000.0, 1e-3);
+}
+
+TEST(SnapshotScheduleFallback, StaleTaskSkipsScanAfterHookReturns) {
+    Scheduler schedule;
+    for (std::uint32_t i = 0; i < kFallbackFrames; ++i)
+        schedule.BeginRenderFrame(i * kFrame);
+    ASSERT_TRUE(schedule.FallingBack());
+    EXPECT_EQ(schedule.TasksQueued(), 1u);
+
+    // Hook reports before the queued task drains
+    schedule.MainLoopUpdate();
+    EXPECT_FALSE(schedule.BeginRenderFrame(kFallbackFrames * kFrame));
+    EXPECT_FALSE(schedule.TaskStarted());
+    schedule.TaskFinished();
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+TEST(SnapshotScheduleBench, LagByMode) {
+    for (const Mode mode : {Mode::Task, Mode::MainLoop}) {
+        Sim sim;
+        sim.schedule.SetMode(mode);
+        sim.hookInstalled = mode == Mode::MainLoop;
+        sim.Run(0, 3600);
+
+        const auto lag = sim.schedule.Lag();
+        std::printf("[ BENCH    ] %-8s lag mean %5.2f ms  max %5.2f ms  jitter %5.2f ms  tasks %llu\n",
+                    mode == Mode::Task ? "Task" : "MainLoop", lag.meanMs, lag.maxMs, lag.jitterMs,
+                    static_cast<unsigned long long>(sim.schedule.TasksQueued()));
+    }
+}
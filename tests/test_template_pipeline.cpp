@@ -0,0 +1,388 @@
+/**
+ * Unit tests for the appearance template pipeline using Google Test.
+ *
+ * Drives TemplatePipeline::Pipeline with a fake host that records game
+ * calls, simulates scheduled game-thread ticks and load events, and uses
+ * a manual clock to exercise the per-frame time budget and the wait budget.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "TemplatePipeline.h"
+
+using TemplatePipeline::OutfitSource;
+using TemplatePipeline::Pipeline;
+using TemplatePipeline::Stage;
+
+// ============================================================================
+// Fake host
+// ============================================================================
+
+class FakeHost : public TemplatePipeline::IHost {
+public:
+    // World state
+    bool playerReady = false;
+    bool applySucceeds = true;
+    OutfitSource outfit = OutfitSource::None;
+    std::uint32_t spawnID = 0xFF000801;
+    bool spawnReady = false;
+    bool unloadOnReset = true;  // Whether Is3DLoaded drops during a reset
+    int root = 0;               // Which of two 3D roots the player has
+    int roots[2] = {};
+
+    // Cost of each operation on the fake clock
+    double stepCostMs = 0.5;
+    double resetCostMs = 0.5;
+
+    // Observations
+    std::vector<std::string> calls;
+    int scheduledTicks = 0;
+    double now = 0.0;
+
+    bool IsPlayerReady() const override { return playerReady; }
+
+    bool ApplyRecords() override {
+        calls.push_back("Apply");
+        now += stepCostMs;
+        return applySucceeds;
+    }
+
+    OutfitSource PrepareOutfit(std::uint32_t& spawnRefID) override {
+        calls.push_back("PrepareOutfit");
+        if (outfit == OutfitSource::Spawned) spawnRefID = spawnID;
+        return outfit;
+    }
+
+    bool IsOutfitSourceReady(std::uint32_t refID) const override {
+        return refID == spawnID && spawnReady;
+    }
+
+    void CopyOutfit() override {
+        calls.push_back("CopyOutfit");
+        now += stepCostMs;
+    }
+
+    void ReleaseOutfit() override { calls.push_back("ReleaseOutfit"); }
+
+    const void* Player3DRoot() const override { return &roots[root]; }
+
+    void RunRefresh(Stage stage) override {
+        switch (stage) {
+            case Stage::RefreshColors: calls.push_back("RefreshColors"); break;
+            case Stage::RegenerateHead: calls.push_back("RegenerateHead"); break;
+            case Stage::Reset3D:
+                calls.push_back("Reset3D");
+                if (unloadOnReset) playerReady = false;  // 3D unloads until the game reports it back
+                now += resetCostMs;
+                return;
+            case Stage::Update3DModel: calls.push_back("Update3DModel"); break;
+            case Stage::UpdateNeck: calls.push_back("UpdateNeck"); break;
+            default: calls.push_back("?"); break;
+        }
+        now += stepCostMs;
+    }
+
+    void ScheduleTick() override { ++scheduledTicks; }
+
+    double NowMs() const override { return now; }
+};
+
+// Run scheduled ticks like the game's task queue would, one per frame
+static int RunFrames(FakeHost& host, Pipeline& pipeline, int maxFrames = 100) {
+    int frames = 0;
+    while (host.scheduledTicks > 0 && frames < maxFrames) {
+        host.scheduledTicks = 0;
+        pipeline.Tick();
+        ++frames;
+    }
+    return frames;
+}
+
+static const std::vector<std::string> kRefreshTail = {
+    "RefreshColors", "RegenerateHead", "Reset3D", "Update3DModel", "UpdateNeck"};
+
+static std::vector<std::string> Concat(std::vector<std::string> a, const std::vector<std::string>& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+// ============================================================================
+// Waiting on events
+// ============================================================================
+
+TEST(TemplatePipelineTest, IdleByDefault) {
+    FakeHost host;
+    Pipeline pipeline(host);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Idle);
+    EXPECT_FALSE(pipeline.IsBusy());
+}
+
+TEST(TemplatePipelineTest, WaitsForPlayerWithoutPolling) {
+    FakeHost host;
+    Pipeline pipeline(host, 100.0);
+    pipeline.Start();
+    EXPECT_EQ(host.scheduledTicks, 1);
+
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::WaitPlayer);
+    EXPECT_EQ(host.scheduledTicks, 0);  // Blocked stage does not reschedule itself
+    EXPECT_TRUE(host.calls.empty());
+
+    // Unrelated loads do not wake it
+    pipeline.OnObjectLoaded(0x12345);
+    EXPECT_EQ(host.scheduledTicks, 0);
+
+    host.playerReady = true;
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    EXPECT_EQ(host.scheduledTicks, 1);
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Update3DModel);  // Waiting for 3D after reset
+
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    host.playerReady = true;
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Done);
+    EXPECT_EQ(host.calls, Concat({"Apply", "PrepareOutfit"}, kRefreshTail));
+}
+
+TEST(TemplatePipelineTest, AlreadyLoadedPlayerStartsImmediately) {
+    FakeHost host;
+    host.playerReady = true;
+    Pipeline pipeline(host, 100.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    EXPECT_EQ(host.calls.front(), "Apply");
+}
+
+TEST(TemplatePipelineTest, SpawnedOutfitSourceWaitsForItsLoadEvent) {
+    FakeHost host;
+    host.playerReady = true;
+    host.outfit = OutfitSource::Spawned;
+    Pipeline pipeline(host, 100.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::WaitOutfitSource);
+
+    // Player events are irrelevant while waiting for the spawn
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    EXPECT_EQ(host.scheduledTicks, 0);
+
+    host.spawnReady = true;
+    pipeline.OnObjectLoaded(host.spawnID);
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Update3DModel);
+
+    host.playerReady = true;
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Done);
+    EXPECT_EQ(host.calls, Concat({"Apply", "PrepareOutfit", "CopyOutfit"}, kRefreshTail));
+}
+
+TEST(TemplatePipelineTest, LoadedOutfitSourceCopiesImmediately) {
+    FakeHost host;
+    host.playerReady = true;
+    host.outfit = OutfitSource::Ready;
+    Pipeline pipeline(host, 100.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    ASSERT_GE(host.calls.size(), 3u);
+    EXPECT_EQ(host.calls[2], "CopyOutfit");
+}
+
+TEST(TemplatePipelineTest, ApplyFailureStopsPipeline) {
+    FakeHost host;
+    host.playerReady = true;
+    host.applySucceeds = false;
+    Pipeline pipeline(host, 100.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Failed);
+    EXPECT_FALSE(pipeline.IsBusy());
+    EXPECT_EQ(host.calls, std::vector<std::string>{"Apply"});
+}
+
+TEST(TemplatePipelineTest, CancelIgnoresLaterEvents) {
+    FakeHost host;
+    Pipeline pipeline(host);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    pipeline.Cancel();
+    host.playerReady = true;
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    EXPECT_EQ(host.scheduledTicks, 0);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Idle);
+}
+
+TEST(TemplatePipelineTest, RefreshOnlyRunsRefreshStages) {
+    FakeHost host;
+    host.playerReady = true;
+    Pipeline pipeline(host, 100.0);
+    pipeline.StartRefresh();
+    RunFrames(host, pipeline);
+    host.playerReady = true;
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Done);
+    EXPECT_EQ(host.calls, kRefreshTail);
+}
+
+// ============================================================================
+// Frame budget
+// ============================================================================
+
+TEST(TemplatePipelineTest, ExpensiveStepsAreSpreadAcrossFrames) {
+    FakeHost host;
+    host.playerReady = true;
+    host.outfit = OutfitSource::Ready;
+    host.stepCostMs = 3.0;  // Every step exceeds the 2 ms budget
+    Pipeline pipeline(host, 2.0);
+
+    pipeline.Start();
+    std::vector<double> msPerFrame;
+    for (int frame = 0; frame < 20 && host.scheduledTicks > 0; ++frame) {
+        const double before = host.now;
+        host.scheduledTicks = 0;
+        pipeline.Tick();
+        msPerFrame.push_back(host.now - before);
+        if (pipeline.GetStage() == Stage::Update3DModel && !host.playerReady) {
+            host.playerReady = true;
+            pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+        }
+    }
+
+    EXPECT_EQ(pipeline.GetStage(), Stage::Done);
+    for (double ms : msPerFrame) {
+        EXPECT_LE(ms, host.stepCostMs);  // Never more than one expensive step per frame
+    }
+    EXPECT_EQ(host.calls.size(), 8u);
+}
+
+TEST(TemplatePipelineTest, CheapStepsShareAFrame) {
+    FakeHost host;
+    host.playerReady = true;
+    host.stepCostMs = 0.1;
+    Pipeline pipeline(host, 2.0);
+    pipeline.Start();
+    host.scheduledTicks = 0;
+    pipeline.Tick();
+    // Apply, prepare, colors, head and reset all fit in one budget
+    EXPECT_EQ(host.calls, (std::vector<std::string>{"Apply", "PrepareOutfit", "RefreshColors", "RegenerateHead", "Reset3D"}));
+    EXPECT_EQ(pipeline.GetStage(), Stage::Update3DModel);
+}
+
+// ============================================================================
+// Wait budget
+// ============================================================================
+
+TEST(TemplatePipelineTest, LoadedPlayerIsNoReloadSignal) {
+    // Right after DoReset3D the old 3D still counts as loaded
+    FakeHost host;
+    host.playerReady = true;
+    host.unloadOnReset = false;
+    Pipeline pipeline(host, 100.0);
+    pipeline.StartRefresh();
+    RunFrames(host, pipeline);
+    pipeline.Poll();
+    EXPECT_EQ(pipeline.GetStage(), Stage::Update3DModel);
+
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Done);
+    EXPECT_EQ(host.calls, kRefreshTail);
+}
+
+TEST(TemplatePipelineTest, NewPlayerRootIsReloadSignal) {
+    FakeHost host;
+    host.playerReady = true;
+    host.unloadOnReset = false;
+    Pipeline pipeline(host, 100.0);
+    pipeline.StartRefresh();
+    RunFrames(host, pipeline);
+    ASSERT_EQ(pipeline.GetStage(), Stage::Update3DModel);
+
+    // No load event, but the reset built a new root
+    host.root = 1;
+    pipeline.Poll();
+    EXPECT_EQ(pipeline.GetStage(), Stage::Done);
+    EXPECT_EQ(host.calls, kRefreshTail);
+}
+
+TEST(TemplatePipelineTest, OutfitSourceThatNeverLoadsTimesOut) {
+    FakeHost host;
+    host.playerReady = true;
+    host.outfit = OutfitSource::Spawned;
+    Pipeline pipeline(host, 100.0, 5000.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    ASSERT_EQ(pipeline.GetStage(), Stage::WaitOutfitSource);
+
+    host.now += 4000.0;
+    pipeline.Poll();
+    EXPECT_EQ(pipeline.GetStage(), Stage::WaitOutfitSource);
+
+    host.now += 2000.0;
+    pipeline.Poll();
+    EXPECT_EQ(pipeline.GetStage(), Stage::Failed);
+    EXPECT_FALSE(pipeline.IsBusy());
+    EXPECT_EQ(host.calls, (std::vector<std::string>{"Apply", "PrepareOutfit", "ReleaseOutfit"}));
+
+    // Later refresh requests are no longer blocked
+    pipeline.StartRefresh();
+    EXPECT_TRUE(pipeline.IsBusy());
+}
+
+TEST(TemplatePipelineTest, PlayerThatNeverReloadsTimesOut) {
+    FakeHost host;
+    host.playerReady = true;
+    host.unloadOnReset = false;
+    Pipeline pipeline(host, 100.0, 5000.0);
+    pipeline.StartRefresh();
+    RunFrames(host, pipeline);
+    ASSERT_EQ(pipeline.GetStage(), Stage::Update3DModel);
+
+    host.now += 6000.0;
+    pipeline.Poll();
+    EXPECT_EQ(pipeline.GetStage(), Stage::Failed);
+    EXPECT_EQ(host.calls, (std::vector<std::string>{"RefreshColors", "RegenerateHead", "Reset3D"}));
+}
+
+TEST(TemplatePipelineTest, PollWithoutBoundedWaitDoesNothing) {
+    FakeHost host;
+    Pipeline pipeline(host, 100.0, 5000.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    ASSERT_EQ(pipeline.GetStage(), Stage::WaitPlayer);
+
+    // Waiting for the player is not bounded, a load can take any time
+    host.now += 60000.0;
+    pipeline.Poll();
+    EXPECT_EQ(pipeline.GetStage(), Stage::WaitPlayer);
+    EXPECT_TRUE(host.calls.empty());
+}
+
+TEST(TemplatePipelineTest, DuplicateEventsScheduleOneTick) {
+    FakeHost host;
+    Pipeline pipeline(host);
+    pipeline.Start();
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    pipeline.OnObjectLoaded(TemplatePipeline::kPlayerRefID);
+    EXPECT_EQ(host.scheduledTicks, 1);
+}
+
+TEST(TemplatePipelineTest, RestartResetsSequence) {
+    FakeHost host;
+    host.playerReady = true;
+    host.outfit = OutfitSource::Spawned;
+    Pipeline pipeline(host, 100.0);
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    ASSERT_EQ(pipeline.GetStage(), Stage::WaitOutfitSource);
+
+    host.outfit = OutfitSource::None;
+    pipeline.Start();
+    RunFrames(host, pipeline);
+    EXPECT_EQ(pipeline.GetStage(), Stage::Update3DModel);
+}
@@ -0,0 +1,311 @@
+/**
+ * Unit tests for the typewriter alpha mask using Google Test.
+ *
+ * Emits label text the way ImGui does (one quad per visible glyph per pass)
+ * with a fixed-advance headless font, then checks that the mask reveals
+ * exactly the glyphs the old per-frame truncation showed, for the same
+ * progress, across segments, the title, UTF-8 text and clipped passes.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TypewriterMask.h"
+
+using TypewriterMask::CharAlpha;
+using TypewriterMask::GlyphMap;
+using TypewriterMask::Progress;
+using TypewriterMask::TruncatedCount;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+struct Vec2
+{
+    float x, y;
+};
+
+struct Vert
+{
+    Vec2 pos;
+    Vec2 uv;
+    std::uint32_t col;
+};
+
+// Decode UTF-8 into codepoints
+static std::vector<std::uint32_t> Decode(const std::string& s)
+{
+    std::vector<std::uint32_t> out;
+    for (std::size_t i = 0; i < s.size();)
+    {
+        const auto c = static_cast<unsigned char>(s[i]);
+        const std::size_t len = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        std::uint32_t cp = len == 1 ? c : (c & (0xFF >> (len + 1)));
+        for (std::size_t k = 1; k < len && i + k < s.size(); ++k)
+            cp = (cp << 6) | (static_cast<unsigned char>(s[i + k]) & 0x3F);
+        out.push_back(cp);
+        i += len;
+    }
+    return out;
+}
+
+// Headless font: spaces are invisible, wide glyphs above U+00FF
+static float Advance(std::uint32_t cp) { return cp == ' ' ? 4.0f : cp > 0xFF ? 12.0f : 8.0f; }
+static bool Visible(std::uint32_t cp) { return cp != ' '; }
+
+static GlyphMap MapOf(const std::string& text)
+{
+    GlyphMap map;
+    for (std::uint32_t cp : Decode(text))
+        map.AddChar(Advance(cp), Visible(cp), static_cast<float>(cp), 0.0f);
+    return map;
+}
+
+// One text pass like ImDrawList::AddText, optionally clipped at clipX
+static void EmitPass(std::vector<Vert>& out, const std::string& text, float x, float y, std::uint32_t col,
+                     float clipX = -1e9f)
+{
+    for (std::uint32_t cp : Decode(text))
+    {
+        const float w = Advance(cp);
+        if (Visible(cp) && x + w >= clipX)
+        {
+            // UVs stand in for the glyph's atlas rectangle
+            const float u = static_cast<float>(cp);
+            out.push_back({{x, y}, {u, 0}, col});
+            out.push_back({{x + w - 1.0f, y}, {u + 1, 0}, col});
+            out.push_back({{x + w - 1.0f, y + 14.0f}, {u + 1, 1}, col});
+            out.push_back({{x, y + 14.0f}, {u, 1}, col});
+        }
+        x += w;
+    }
+}
+
+// Glow, shadow, 4-way outline and fill, as DrawLabel draws a piece
+static std::vector<Vert> EmitPiece(const std::string& text, float x, float clipX = -1e9f)
+{
+    std::vector<Vert> v;
+    const float glow = 6.0f;
+    const float offs[8][2] = {{glow, 0}, {-glow, 0}, {0, glow}, {0, -glow},
+                              {4, 4}, {-4, 4}, {4, -4}, {-4, -4}};
+    for (const auto& o : offs)
+        EmitPass(v, text, x + o[0], o[1], 0x40FFFFFFu, clipX);
+    EmitPass(v, text, x + 1.0f, 1.0f, 0x80000000u, clipX);
+    for (int i = 0; i < 4; ++i)
+        EmitPass(v, text, x + (i == 0 ? 1.0f : i == 1 ? -1.0f : 0.0f), (i == 2 ? 1.0f : i == 3 ? -1.0f : 0.0f),
+                 0xFF000000u, clipX);
+    EmitPass(v, text, x, 0.0f, 0xFFFFFFFFu, clipX);
+    return v;
+}
+
+static int PassCount() { return 8 + 1 + 4 + 1; }
+
+// The reveal DrawLabel used to do: truncate each piece to the characters left
+static std::string LegacyTruncate(const std::string& text, int charsLeft)
+{
+    if (charsLeft <= 0)
+        return "";
+    std::size_t i = 0;
+    int n = 0;
+    while (i < text.size() && n < charsLeft)
+    {
+        const auto c = static_cast<unsigned char>(text[i]);
+        i += c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        ++n;
+    }
+    return text.substr(0, i);
+}
+
+static int VisibleGlyphs(const std::string& text)
+{
+    int n = 0;
+    for (std::uint32_t cp : Decode(text))
+        n += Visible(cp) ? 1 : 0;
+    return n;
+}
+
+// Quads with any alpha left after masking
+static int CountVisibleQuads(const std::vector<Vert>& v)
+{
+    int n = 0;
+    for (std::size_t q = 0; q + 3 < v.size(); q += 4)
+        n += (v[q].col >> 24) > 0 ? 1 : 0;
+    return n;
+}
+
+// A label: main line segments, then the title
+struct LabelText
+{
+    std::vector<std::string> pieces;
+};
+
+static const LabelText kLabels[] = {
+    {{"Lydia", " Lv.42", "Housecarl of Whiterun"}},
+    {{"J'zargo", " Lv.7", "Mage"}},
+    {{"Ulfric Stormcloak", " Lv.50", "Jarl of Windhelm"}},
+    {{"\xC3\x89lise", " Lv.3", "\xE5\xAE\x88\xE8\xAD\xB7\xE8\x80\x85"}},  // accented name, CJK title
+};
+
+// ============================================================================
+// Reveal timing
+// ============================================================================
+
+TEST(TypewriterMaskReveal, ProgressMatchesOldTimer)
+{
+    EXPECT_FLOAT_EQ(Progress(0.5f, 1.0f, 30.0f), 0.0f);  // delay
+    EXPECT_FLOAT_EQ(Progress(1.5f, 1.0f, 30.0f), 15.0f);
+    for (float t = 0.0f; t < 2.0f; t += 0.013f)
+    {
+        // Old: charsToShow = effectiveTime > 0 ? int(effectiveTime * speed) : 0
+        const float eff = t - 0.25f;
+        const int old = eff > 0.0f ? static_cast<int>(eff * 30.0f) : 0;
+        EXPECT_EQ(TruncatedCount(Progress(t, 0.25f, 30.0f)), old) << t;
+    }
+}
+
+TEST(TypewriterMaskReveal, OpaqueExactlyWhenTruncationShowedIt)
+{
+    for (float softness : {0.0f, 0.5f, 1.0f, 3.0f})
+    {
+        for (float p = 0.0f; p < 40.0f; p += 0.05f)
+        {
+            for (int k = 0; k < 40; ++k)
+            {
+                const bool shown = k < TruncatedCount(p);
+                EXPECT_EQ(CharAlpha(p, k, softness) >= 1.0f, shown) << p << " " << k << " " << softness;
+            }
+        }
+    }
+}
+
+TEST(TypewriterMaskReveal, SoftEdgeLeadsByAtMostSoftness)
+{
+    for (float p = 0.0f; p < 20.0f; p += 0.1f)
+    {
+        int partial = 0;
+        for (int k = 0; k < 30; ++k)
+        {
+            const float a = CharAlpha(p, k, 2.0f);
+            EXPECT_GE(a, 0.0f);
+            EXPECT_LE(a, 1.0f);
+            if (k > 0)
+            {
+                EXPECT_LE(a, CharAlpha(p, k - 1, 2.0f));  // monotonic along the text
+            }
+            partial += (a > 0.0f && a < 1.0f) ? 1 : 0;
+        }
+        EXPECT_LE(partial, 2);
+    }
+}
+
+// ============================================================================
+// Glyph mapping
+// ============================================================================
+
+TEST(TypewriterMaskGlyphs, QuadsMapToVisibleCharacters)
+{
+    const GlyphMap map = MapOf("Lv. 42");
+    EXPECT_EQ(map.CharCount(), 6u);
+    EXPECT_EQ(map.VisibleCount(), 5u);
+    EXPECT_EQ(map.CharForQuad(2), 2);  // '.'
+    EXPECT_EQ(map.CharForQuad(3), 4);  // '4' after the space
+    EXPECT_EQ(map.CharForQuad(5), 0);  // second pass wraps
+
+    EXPECT_EQ(map.CharAtX(-3.0f), 0);
+    EXPECT_EQ(map.CharAtX(9.0f), 1);
+    EXPECT_EQ(map.CharAtX(26.0f), 3);  // inside the space
+    EXPECT_EQ(map.CharAtX(500.0f), 5);
+}
+
+// ============================================================================
+// Revealed glyphs against the old truncation
+// ============================================================================
+
+static void ExpectMatchesLegacy(float softness, float clipX)
+{
+    for (const auto& label : kLabels)
+    {
+        for (float p = 0.0f; p < 60.0f; p += 0.25f)
+        {
+            int firstChar = 0;
+            for (const auto& text : label.pieces)
+            {
+                const GlyphMap map = MapOf(text);
+                const float x = 100.0f;
+                const std::vector<Vert> unmasked = EmitPiece(text, x, clipX);
+                std::vector<Vert> v = unmasked;
+                const std::size_t before = v.size();
+                TypewriterMask::Apply(v.data(), v.size(), x, map, firstChar, p, softness);
+                ASSERT_EQ(v.size(), before);
+
+                // What the old path drew for this piece
+                const std::string legacy = LegacyTruncate(text, TruncatedCount(p) - firstChar);
+                std::vector<Vert> old = EmitPiece(legacy, x, clipX);
+                const int oldQuads = static_cast<int>(old.size() / 4);
+
+                // Fully opaque glyphs are exactly the old ones, pass by pass
+                int opaque = 0;
+                for (std::size_t q = 0; q < v.size(); q += 4)
+                    opaque += (v[q].col >> 24) == (unmasked[q].col >> 24) ? 1 : 0;
+                EXPECT_EQ(opaque, oldQuads) << text << " at " << p;
+
+                if (softness == 0.0f)
+                {
+                    EXPECT_EQ(CountVisibleQuads(v), oldQuads) << text << " at " << p;
+                }
+
+                firstChar += static_cast<int>(map.CharCount());
+            }
+        }
+    }
+}
+
+TEST(TypewriterMaskLegacy, HardEdgeRevealsSameGlyphs)
+{
+    ExpectMatchesLegacy(0.0f, -1e9f);
+}
+
+TEST(TypewriterMaskLegacy, SoftEdgeFullyRevealsSameGlyphs)
+{
+    ExpectMatchesLegacy(1.0f, -1e9f);
+}
+
+TEST(TypewriterMaskLegacy, ClippedPassesFallBackToAdvanceCells)
+{
+    // Clip off the first glyphs of every pass so quad counts no longer divide
+    ExpectMatchesLegacy(0.0f, 112.0f);
+}
+
+TEST(TypewriterMaskLegacy, VertexCountStableDuringReveal)
+{
+    const auto& label = kLabels[0];
+    std::size_t maskedCount = 0;
+    int legacyCounts = 0;
+    std::size_t lastLegacy = static_cast<std::size_t>(-1);
+
+    for (float p = 0.0f; p < 40.0f; p += 0.5f)
+    {
+        std::size_t masked = 0, legacy = 0;
+        int firstChar = 0;
+        for (const auto& text : label.pieces)
+        {
+            masked += EmitPiece(text, 0.0f).size();
+            legacy += EmitPiece(LegacyTruncate(text, TruncatedCount(p) - firstChar), 0.0f).size();
+            firstChar += static_cast<int>(MapOf(text).CharCount());
+        }
+        if (maskedCount == 0)
+            maskedCount = masked;
+        EXPECT_EQ(masked, maskedCount);
+        legacyCounts += legacy != lastLegacy ? 1 : 0;
+        lastLegacy = legacy;
+    }
+
+    int visible = 0;
+    for (const auto& text : label.pieces)
+        visible += VisibleGlyphs(text);
+    EXPECT_EQ(maskedCount, static_cast<std::size_t>(visible * PassCount() * 4));
+    EXPECT_GT(legacyCounts, 10);  // the old path changed geometry through the reveal
+}